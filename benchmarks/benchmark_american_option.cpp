@@ -0,0 +1,93 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "trading/american_option.h"
+
+namespace {
+
+// At-the-money one-year put; reference from a 20001-step Leisen-Reimer tree
+constexpr double kReference = 6.090358;
+
+/**
+ * @brief Time per option against accuracy, by method and resolution
+ *
+ * Arguments are the method and the number of time steps (the PDE uses
+ * twice as many space steps). The "error" counter is the absolute error.
+ */
+void BM_AmericanPut(benchmark::State& state) {
+    AmericanSettings settings;
+    settings.method = static_cast<AmericanMethod>(state.range(0));
+    settings.time_steps = static_cast<int>(state.range(1));
+    settings.space_steps = 2 * settings.time_steps;
+    double price = 0.0;
+    for (auto _ : state) {
+        price = AmericanOption::calculate_option_price(100.0, 100.0, 1.0,
+                                                       0.05, 0.2, PUT,
+                                                       settings);
+        benchmark::DoNotOptimize(price);
+    }
+    state.counters["error"] = std::abs(price - kReference);
+}
+BENCHMARK(BM_AmericanPut)
+    ->ArgsProduct({{static_cast<int>(AmericanMethod::COX_ROSS_RUBINSTEIN),
+                    static_cast<int>(AmericanMethod::LEISEN_REIMER),
+                    static_cast<int>(AmericanMethod::CRANK_NICOLSON)},
+                   {51, 201, 801}})
+    ->Args({static_cast<int>(AmericanMethod::BARONE_ADESI_WHALEY), 201})
+    ->Args({static_cast<int>(AmericanMethod::JU_ZHONG), 201});
+
+/**
+ * @brief 32 put strikes of one expiry, priced as one batch
+ */
+void BM_AmericanChain(benchmark::State& state) {
+    const std::size_t n = 32;
+    std::vector<double> S(n, 100.0), K(n), T(n, 1.0), r(n, 0.05),
+        sigma(n, 0.2), prices(n);
+    std::vector<OptionType> type(n, PUT);
+    for (std::size_t i = 0; i < n; ++i) {
+        K[i] = 80.0 + 1.25 * i;
+    }
+    OptionBatch batch = {S.data(),     K.data(),    T.data(), r.data(),
+                         sigma.data(), type.data(), n};
+    AmericanSettings settings;
+    settings.method = static_cast<AmericanMethod>(state.range(0));
+    for (auto _ : state) {
+        AmericanOption::calculate_option_prices(batch, prices.data(),
+                                                settings);
+        benchmark::DoNotOptimize(prices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_AmericanChain)
+    ->Arg(static_cast<int>(AmericanMethod::COX_ROSS_RUBINSTEIN))
+    ->Arg(static_cast<int>(AmericanMethod::LEISEN_REIMER))
+    ->Arg(static_cast<int>(AmericanMethod::CRANK_NICOLSON))
+    ->Arg(static_cast<int>(AmericanMethod::BARONE_ADESI_WHALEY));
+
+}  // namespace
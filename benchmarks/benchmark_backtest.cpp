@@ -0,0 +1,192 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "data/tick_store.h"
+#include "trading/strategy.h"
+#include "utils/thread_pool.h"
+
+namespace {
+
+using thales::Backtester;
+using thales::BacktestData;
+using thales::ContractKey;
+using thales::EventBatch;
+
+constexpr std::int32_t kFirstDay = 19358;  // 2023-01-01
+constexpr int kDays = 60;
+constexpr int kMinutes = 390;
+constexpr int kStrikes = 20;
+constexpr std::int64_t kNanosPerMinute = 60'000'000'000;
+constexpr std::int64_t kNanosPerDay = 1440 * kNanosPerMinute;
+
+/**
+ * @brief Minute bars plus a minute-by-minute option chain for one symbol.
+ */
+class ReplayStore {
+   public:
+    ReplayStore()
+        : root(std::filesystem::temp_directory_path() /
+               ("thales_backtest_bench_" + std::to_string(::getpid()))),
+          store(root.string()) {
+        thales::SymbolId spy = thales::SymbolTable::intern("SPY");
+        thales::SymbolId contract = thales::SymbolTable::intern("O:SPY");
+        thales::BarColumns bars;
+        thales::OptionChainColumns chain;
+        for (int day = 0; day < kDays; ++day) {
+            bars.clear();
+            chain.clear();
+            std::int64_t open = (kFirstDay + day) * kNanosPerDay +
+                                570 * kNanosPerMinute;
+            for (int minute = 0; minute < kMinutes; ++minute) {
+                std::int64_t now = open + minute * kNanosPerMinute;
+                double spot = 400.0 + 5.0 * std::sin(0.01 * (day * kMinutes +
+                                                             minute));
+                std::size_t row = bars.append();
+                bars.symbol[row] = spy;
+                bars.timestamp_ns[row] = now;
+                bars.open[row] = bars.high[row] = bars.low[row] = spot;
+                bars.close[row] = bars.vwap[row] = spot;
+                bars.volume[row] = 1000.0;
+                for (int k = 0; k < kStrikes; ++k) {
+                    double strike = 390.0 + k;
+                    double value = std::max(spot - strike, 0.0) + 2.0;
+                    row = chain.append();
+                    chain.contract[row] = contract;
+                    chain.underlying[row] = spy;
+                    chain.type[row] = CALL;
+                    chain.strike[row] = strike;
+                    chain.expiration[row] = kFirstDay + kDays + 30;
+                    chain.bid[row] = value - 0.05;
+                    chain.ask[row] = value + 0.05;
+                    chain.bid_size[row] = chain.ask_size[row] = 50;
+                    chain.timestamp_ns[row] = now;
+                    chain.underlying_price[row] = spot;
+                }
+            }
+            store.write_bars(bars);
+            store.write_option_quotes(chain);
+        }
+        data = std::make_unique<BacktestData>(
+            store, std::vector<std::string>{"SPY"}, kFirstDay,
+            kFirstDay + kDays);
+    }
+
+    ~ReplayStore() { std::filesystem::remove_all(root); }
+
+    std::filesystem::path root;
+    thales::TickStore store;
+    std::unique_ptr<BacktestData> data;
+};
+
+const BacktestData& replay_data() {
+    static ReplayStore store;
+    return *store.data;
+}
+
+/**
+ * @brief Trades an at-the-money call on moving average crossovers.
+ */
+class Crossover : public thales::Strategy {
+   public:
+    explicit Crossover(int window) : window(window) {}
+
+    void on_events(const EventBatch& batch, Backtester& backtester) override {
+        for (const thales::BarEvent& bar : batch.bars) {
+            average += (bar.close - average) / window;
+            bool above = bar.close > average;
+            if (above == long_call) {
+                continue;
+            }
+            long_call = above;
+            ContractKey call{bar.symbol, kFirstDay + kDays + 30, CALL, 400.0};
+            backtester.submit({above ? thales::Side::BUY
+                                     : thales::Side::SELL,
+                               call, 1});
+        }
+    }
+
+   private:
+    int window;
+    double average = 400.0;
+    bool long_call = false;
+};
+
+/**
+ * @brief Replays every event through one strategy.
+ */
+void BM_BacktestReplay(benchmark::State& state) {
+    const BacktestData& data = replay_data();
+    Backtester backtester(data);
+    std::int64_t events = 0;
+    for (auto _ : state) {
+        Crossover strategy(30);
+        thales::BacktestResult result = backtester.run(strategy);
+        benchmark::DoNotOptimize(result.final_equity);
+        events += static_cast<std::int64_t>(result.events);
+    }
+    state.SetItemsProcessed(events);
+}
+BENCHMARK(BM_BacktestReplay)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Sweeps 16 averaging windows over the shared data set.
+ */
+void BM_BacktestSweep(benchmark::State& state) {
+    const BacktestData& data = replay_data();
+    thales::ThreadPool pool(static_cast<std::size_t>(state.range(0)));
+    const std::size_t configurations = 16;
+    std::int64_t events = 0;
+    for (auto _ : state) {
+        auto results = thales::run_parameter_sweep(
+            data, configurations,
+            [](std::size_t index) {
+                return std::make_unique<Crossover>(
+                    10 + 10 * static_cast<int>(index));
+            },
+            pool);
+        benchmark::DoNotOptimize(results.data());
+        for (const thales::BacktestResult& result : results) {
+            events += static_cast<std::int64_t>(result.events);
+        }
+    }
+    state.SetItemsProcessed(events);
+}
+BENCHMARK(BM_BacktestSweep)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
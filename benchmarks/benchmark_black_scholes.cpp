@@ -22,9 +22,52 @@
  * SOFTWARE.
  */
 
+#include <random>
+#include <vector>
+
 #include "benchmark/benchmark.h"
 #include "trading/black_scholes.h"
 
+namespace {
+
+/**
+ * @brief Synthetic option chain with strikes and expiries spread around ATM
+ */
+struct BenchmarkChain {
+    std::vector<double> S, K, T, r, sigma;
+    std::vector<OptionType> type;
+
+    explicit BenchmarkChain(std::size_t n)
+        : S(n), K(n), T(n), r(n), sigma(n), type(n) {
+        std::mt19937 gen(7);
+        std::uniform_real_distribution<double> moneyness(0.7, 1.3);
+        std::uniform_real_distribution<double> expiry(1.0 / 365.0, 2.0);
+        std::uniform_real_distribution<double> vol(0.1, 0.6);
+        for (std::size_t i = 0; i < n; ++i) {
+            S[i] = 100.0;
+            K[i] = 100.0 * moneyness(gen);
+            T[i] = expiry(gen);
+            r[i] = 0.05;
+            sigma[i] = vol(gen);
+            type[i] = (i & 1) != 0 ? OptionType::PUT : OptionType::CALL;
+        }
+    }
+
+    OptionBatch view() const {
+        return {S.data(), K.data(),     T.data(),
+                r.data(), sigma.data(), type.data(), S.size()};
+    }
+};
+
+void set_options_per_second(benchmark::State& state, std::size_t n) {
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(n));
+    state.counters["options/s"] = benchmark::Counter(
+        static_cast<double>(n), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+}  // namespace
+
 static void BM_BlackScholes_Call(benchmark::State& state) {
     for (auto _ : state) {
         benchmark::DoNotOptimize(BlackScholes::calculate_option_price(100.0, 100.0, 1.0, 0.05, 0.2, OptionType::CALL));
@@ -38,3 +81,186 @@ static void BM_BlackScholes_Put(benchmark::State& state) {
     }
 }
 BENCHMARK(BM_BlackScholes_Put);
+
+// Chain revaluation, one calculate_option_price call per option
+static void BM_BlackScholes_ChainScalarLoop(benchmark::State& state) {
+    const BenchmarkChain chain(static_cast<std::size_t>(state.range(0)));
+    std::vector<double> prices(chain.S.size());
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < prices.size(); ++i) {
+            prices[i] = BlackScholes::calculate_option_price(
+                chain.S[i], chain.K[i], chain.T[i], chain.r[i], chain.sigma[i],
+                chain.type[i]);
+        }
+        benchmark::DoNotOptimize(prices.data());
+        benchmark::ClobberMemory();
+    }
+    set_options_per_second(state, prices.size());
+}
+BENCHMARK(BM_BlackScholes_ChainScalarLoop)
+    ->RangeMultiplier(8)->Range(64, 1 << 20);
+
+// Chain revaluation through the batch API on a given SIMD backend
+static void BM_BlackScholes_ChainBatch(benchmark::State& state,
+                                       SimdBackend backend) {
+    if (!BlackScholes::is_simd_backend_supported(backend)) {
+        state.SkipWithError("SIMD backend not supported on this CPU");
+        return;
+    }
+    const BenchmarkChain chain(static_cast<std::size_t>(state.range(0)));
+    std::vector<double> prices(chain.S.size());
+
+    for (auto _ : state) {
+        BlackScholes::calculate_option_prices(chain.view(), prices.data(),
+                                              backend);
+        benchmark::DoNotOptimize(prices.data());
+        benchmark::ClobberMemory();
+    }
+    set_options_per_second(state, prices.size());
+}
+BENCHMARK_CAPTURE(BM_BlackScholes_ChainBatch, Scalar, SimdBackend::SCALAR)
+    ->RangeMultiplier(8)->Range(64, 1 << 20);
+BENCHMARK_CAPTURE(BM_BlackScholes_ChainBatch, NEON, SimdBackend::NEON)
+    ->RangeMultiplier(8)->Range(64, 1 << 20);
+BENCHMARK_CAPTURE(BM_BlackScholes_ChainBatch, AVX2, SimdBackend::AVX2)
+    ->RangeMultiplier(8)->Range(64, 1 << 20);
+BENCHMARK_CAPTURE(BM_BlackScholes_ChainBatch, AVX512, SimdBackend::AVX512)
+    ->RangeMultiplier(8)->Range(64, 1 << 20);
+
+// Independent chains priced on several threads at once, which shows when
+// the kernels stop scaling and become bound by memory bandwidth
+BENCHMARK_CAPTURE(BM_BlackScholes_ChainBatch, AVX2Threads, SimdBackend::AVX2)
+    ->Arg(1 << 16)->ThreadRange(1, 8)->UseRealTime();
+
+// Scalar chain revaluation under each math policy
+template <class Math>
+static void BM_BlackScholes_PolicyScalarLoop(benchmark::State& state) {
+    const BenchmarkChain chain(static_cast<std::size_t>(state.range(0)));
+    std::vector<double> prices(chain.S.size());
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < prices.size(); ++i) {
+            prices[i] = BlackScholes::calculate_option_price<Math>(
+                chain.S[i], chain.K[i], chain.T[i], chain.r[i], chain.sigma[i],
+                chain.type[i]);
+        }
+        benchmark::DoNotOptimize(prices.data());
+        benchmark::ClobberMemory();
+    }
+    set_options_per_second(state, prices.size());
+}
+BENCHMARK_TEMPLATE(BM_BlackScholes_PolicyScalarLoop, ExactMath)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_BlackScholes_PolicyScalarLoop, RiskMath)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_BlackScholes_PolicyScalarLoop, ScreeningMath)
+    ->Arg(4096);
+
+// Batch chain revaluation and Greeks under each math policy, best backend
+template <class Math>
+static void BM_BlackScholes_PolicyBatch(benchmark::State& state) {
+    const BenchmarkChain chain(static_cast<std::size_t>(state.range(0)));
+    const std::size_t n = chain.S.size();
+    std::vector<double> price(n), delta(n), gamma(n), vega(n);
+    GreeksBatch out = {};
+    out.price = price.data();
+    out.delta = delta.data();
+    out.gamma = gamma.data();
+    out.vega = vega.data();
+
+    for (auto _ : state) {
+        if (state.range(1) != 0) {
+            BlackScholes::calculate_greeks<Math>(chain.view(), out);
+        } else {
+            BlackScholes::calculate_option_prices<Math>(chain.view(),
+                                                        price.data());
+        }
+        benchmark::DoNotOptimize(price.data());
+        benchmark::ClobberMemory();
+    }
+    set_options_per_second(state, n);
+}
+BENCHMARK_TEMPLATE(BM_BlackScholes_PolicyBatch, ExactMath)
+    ->ArgsProduct({{4096}, {0, 1}});
+BENCHMARK_TEMPLATE(BM_BlackScholes_PolicyBatch, RiskMath)
+    ->ArgsProduct({{4096}, {0, 1}});
+BENCHMARK_TEMPLATE(BM_BlackScholes_PolicyBatch, ScreeningMath)
+    ->ArgsProduct({{4096}, {0, 1}});
+
+// Risk baseline: price plus five Greeks by bumping inputs and repricing
+static void BM_Greeks_BumpAndReprice(benchmark::State& state) {
+    const BenchmarkChain chain(static_cast<std::size_t>(state.range(0)));
+    const double h = 1e-4;
+    std::vector<Greeks> greeks(chain.S.size());
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < greeks.size(); ++i) {
+            auto price = [&](double dS, double dT, double dr, double dsigma) {
+                return BlackScholes::calculate_option_price(
+                    chain.S[i] + dS, chain.K[i], chain.T[i] + dT,
+                    chain.r[i] + dr, chain.sigma[i] + dsigma, chain.type[i]);
+            };
+            const double base = price(0, 0, 0, 0);
+            const double up = price(h, 0, 0, 0);
+            const double down = price(-h, 0, 0, 0);
+            Greeks& g = greeks[i];
+            g.price = base;
+            g.delta = (up - down) / (2 * h);
+            g.gamma = (up - 2 * base + down) / (h * h);
+            g.vega = (price(0, 0, 0, h) - price(0, 0, 0, -h)) / (2 * h);
+            g.theta = (base - price(0, h, 0, 0)) / h;
+            g.rho = (price(0, 0, h, 0) - price(0, 0, -h, 0)) / (2 * h);
+        }
+        benchmark::DoNotOptimize(greeks.data());
+        benchmark::ClobberMemory();
+    }
+    set_options_per_second(state, greeks.size());
+}
+BENCHMARK(BM_Greeks_BumpAndReprice)->Arg(4096)->Arg(65536);
+
+// Analytic price and Greeks, one calculate_greeks call per option
+static void BM_Greeks_Analytic(benchmark::State& state) {
+    const BenchmarkChain chain(static_cast<std::size_t>(state.range(0)));
+    std::vector<Greeks> greeks(chain.S.size());
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < greeks.size(); ++i) {
+            greeks[i] = BlackScholes::calculate_greeks(
+                chain.S[i], chain.K[i], chain.T[i], chain.r[i], chain.sigma[i],
+                chain.type[i]);
+        }
+        benchmark::DoNotOptimize(greeks.data());
+        benchmark::ClobberMemory();
+    }
+    set_options_per_second(state, greeks.size());
+}
+BENCHMARK(BM_Greeks_Analytic)->Arg(4096)->Arg(65536);
+
+// Analytic price and Greeks through the batch API
+static void BM_Greeks_Batch(benchmark::State& state, SimdBackend backend) {
+    if (!BlackScholes::is_simd_backend_supported(backend)) {
+        state.SkipWithError("SIMD backend not supported on this CPU");
+        return;
+    }
+    const BenchmarkChain chain(static_cast<std::size_t>(state.range(0)));
+    const std::size_t n = chain.S.size();
+    std::vector<double> price(n), delta(n), gamma(n), vega(n), theta(n),
+        rho(n), vanna(n), volga(n);
+    const GreeksBatch out = {price.data(), delta.data(), gamma.data(),
+                             vega.data(),  theta.data(), rho.data(),
+                             vanna.data(), volga.data()};
+
+    for (auto _ : state) {
+        BlackScholes::calculate_greeks(chain.view(), out, backend);
+        benchmark::DoNotOptimize(price.data());
+        benchmark::ClobberMemory();
+    }
+    set_options_per_second(state, n);
+}
+BENCHMARK_CAPTURE(BM_Greeks_Batch, Scalar, SimdBackend::SCALAR)
+    ->Arg(4096)->Arg(65536);
+BENCHMARK_CAPTURE(BM_Greeks_Batch, NEON, SimdBackend::NEON)
+    ->Arg(4096)->Arg(65536);
+BENCHMARK_CAPTURE(BM_Greeks_Batch, AVX2, SimdBackend::AVX2)
+    ->Arg(4096)->Arg(65536);
+BENCHMARK_CAPTURE(BM_Greeks_Batch, AVX512, SimdBackend::AVX512)
+    ->Arg(4096)->Arg(65536);
@@ -0,0 +1,63 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "config/config.h"
+#include "config/config_store.h"
+
+namespace {
+
+// Benchmarks run from the build directory, like the main executable
+const std::string DIRECTORY = "../config";
+
+/**
+ * @brief A typed read from the published snapshot
+ */
+void BM_ConfigSnapshotLookup(benchmark::State& state) {
+    thales::ConfigStore store(DIRECTORY);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(store.current().get_int(
+            "risk_management", "MAX_UNDERLYING_POSITION", 0));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ConfigSnapshotLookup);
+
+/**
+ * @brief The same read by reparsing the file, as every call used to
+ */
+void BM_ConfigFileReparse(benchmark::State& state) {
+    for (auto _ : state) {
+        auto values = thales::Config::load(DIRECTORY +
+                                           "/risk_management.cfg");
+        benchmark::DoNotOptimize(
+            std::stoi(values.at("MAX_UNDERLYING_POSITION")));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ConfigFileReparse);
+
+}  // namespace
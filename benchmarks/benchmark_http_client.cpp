@@ -0,0 +1,89 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string>
+#include <vector>
+
+#include "../tests/loopback_http_server.h"
+#include "benchmark/benchmark.h"
+#include "utils/http_client.h"
+
+namespace {
+
+void report_latency(benchmark::State& state,
+                    const thales::HttpClient& client) {
+    thales::HttpLatencyStats stats = client.latency_stats();
+    state.counters["p50_us"] = stats.p50_us;
+    state.counters["p90_us"] = stats.p90_us;
+    state.counters["p99_us"] = stats.p99_us;
+}
+
+/**
+ * @brief Baseline: a fresh client, hence a fresh connection, per request.
+ */
+void BM_HttpClientPerRequest(benchmark::State& state) {
+    thales::LoopbackHttpServer server;
+    std::string url = server.url() + "/v2/aggs/ticker/AAPL";
+    for (auto _ : state) {
+        thales::HttpClient client;
+        benchmark::DoNotOptimize(client.get(url));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["connections"] = server.connections();
+}
+BENCHMARK(BM_HttpClientPerRequest)->UseRealTime();
+
+void BM_HttpClientReused(benchmark::State& state) {
+    thales::LoopbackHttpServer server;
+    thales::HttpClient client;
+    std::string url = server.url() + "/v2/aggs/ticker/AAPL";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(client.get(url));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["connections"] = server.connections();
+    report_latency(state, client);
+}
+BENCHMARK(BM_HttpClientReused)->UseRealTime();
+
+/**
+ * @brief Aggregates for a 500-ticker universe fetched as one batch.
+ */
+void BM_HttpClientBatch(benchmark::State& state) {
+    thales::LoopbackHttpServer server;
+    thales::HttpClient client;
+    std::vector<std::string> urls;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        urls.push_back(server.url() + "/v2/aggs/ticker/T" + std::to_string(i));
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(client.get_all(urls));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["connections"] = server.connections();
+    report_latency(state, client);
+}
+BENCHMARK(BM_HttpClientBatch)->Arg(500)->UseRealTime();
+
+}  // namespace
@@ -0,0 +1,126 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cmath>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "trading/implied_volatility.h"
+
+namespace {
+
+/**
+ * @brief SPX-sized chain: 40 expiries x 250 strikes, calls and puts
+ *
+ * Volatilities follow a skewed smile so that wings, ATM and short-dated
+ * options all need different numbers of iterations.
+ */
+struct SpxChain {
+    std::vector<double> S, K, T, r, prices;
+    std::vector<OptionType> type;
+
+    SpxChain() {
+        const double spot = 4500.0;
+        for (int e = 0; e < 40; ++e) {
+            const double expiry = (1.0 + e * e * 0.5) / 365.0;
+            for (int k = 0; k < 250; ++k) {
+                const double strike = spot * (0.5 + k * 0.004);
+                const double log_moneyness = std::log(strike / spot);
+                const double vol = 0.16 - 0.25 * log_moneyness +
+                                   0.4 * log_moneyness * log_moneyness;
+                for (OptionType option_type : {CALL, PUT}) {
+                    S.push_back(spot);
+                    K.push_back(strike);
+                    T.push_back(expiry);
+                    r.push_back(0.045);
+                    type.push_back(option_type);
+                    prices.push_back(BlackScholes::calculate_option_price(
+                        spot, strike, expiry, 0.045, vol, option_type));
+                }
+            }
+        }
+    }
+
+    OptionBatch view() const {
+        return {S.data(), K.data(), T.data(), r.data(),
+                nullptr,  type.data(), S.size()};
+    }
+};
+
+const SpxChain& spx_chain() {
+    static const SpxChain chain;
+    return chain;
+}
+
+void set_ivs_per_second(benchmark::State& state, std::size_t n) {
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(n));
+    state.counters["IVs/s"] = benchmark::Counter(
+        static_cast<double>(n), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+}  // namespace
+
+// One calculate_implied_volatility call per option
+static void BM_ImpliedVolatility_SpxScalarLoop(benchmark::State& state) {
+    const SpxChain& chain = spx_chain();
+    std::vector<double> vols(chain.S.size());
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < vols.size(); ++i) {
+            vols[i] = ImpliedVolatility::calculate_implied_volatility(
+                chain.prices[i], chain.S[i], chain.K[i], chain.T[i],
+                chain.r[i], chain.type[i]);
+        }
+        benchmark::DoNotOptimize(vols.data());
+        benchmark::ClobberMemory();
+    }
+    set_ivs_per_second(state, vols.size());
+}
+BENCHMARK(BM_ImpliedVolatility_SpxScalarLoop);
+
+// The whole chain through the batch solver on a given SIMD backend
+static void BM_ImpliedVolatility_SpxBatch(benchmark::State& state,
+                                          SimdBackend backend) {
+    if (!BlackScholes::is_simd_backend_supported(backend)) {
+        state.SkipWithError("SIMD backend not supported on this CPU");
+        return;
+    }
+    const SpxChain& chain = spx_chain();
+    std::vector<double> vols(chain.S.size());
+    std::size_t solved = 0;
+
+    for (auto _ : state) {
+        solved = ImpliedVolatility::calculate_implied_volatilities(
+            chain.view(), chain.prices.data(), vols.data(), {}, backend);
+        benchmark::DoNotOptimize(vols.data());
+        benchmark::ClobberMemory();
+    }
+    set_ivs_per_second(state, vols.size());
+    state.counters["solved"] = static_cast<double>(solved);
+}
+BENCHMARK_CAPTURE(BM_ImpliedVolatility_SpxBatch, Scalar, SimdBackend::SCALAR);
+BENCHMARK_CAPTURE(BM_ImpliedVolatility_SpxBatch, NEON, SimdBackend::NEON);
+BENCHMARK_CAPTURE(BM_ImpliedVolatility_SpxBatch, AVX2, SimdBackend::AVX2);
+BENCHMARK_CAPTURE(BM_ImpliedVolatility_SpxBatch, AVX512, SimdBackend::AVX512);
@@ -0,0 +1,135 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "trading/live_portfolio.h"
+
+namespace {
+
+using thales::ContractKey;
+using thales::LivePortfolio;
+using thales::SymbolId;
+
+constexpr std::int32_t TODAY = 19888;  // 2024-06-15
+constexpr std::size_t UNDERLYINGS = 50;
+
+/** @brief The i-th contract of a book spread over 50 underlyings */
+ContractKey book_contract(const std::vector<SymbolId>& ids, std::size_t i) {
+    return {ids[i % UNDERLYINGS],
+            TODAY + 30 + static_cast<std::int32_t>((i * 37) % 700),
+            i % 2 ? PUT : CALL,
+            60.0 + static_cast<double>((i / UNDERLYINGS) % 81)};
+}
+
+/** @brief Live book of the given size, quoted on every underlying */
+std::vector<SymbolId> live_book(LivePortfolio& live, std::size_t size) {
+    std::vector<SymbolId> ids;
+    for (std::size_t u = 0; u < UNDERLYINGS; ++u) {
+        ids.push_back(thales::SymbolTable::intern("LIVE" + std::to_string(u)));
+        live.update_underlying(ids.back(), 100.0, 0.2 + 0.002 * u);
+    }
+    for (std::size_t i = 0; i < size; ++i) {
+        live.apply_fill(book_contract(ids, i), thales::Side::BUY,
+                        1 + static_cast<int>(i % 10), 2.5);
+    }
+    return ids;
+}
+
+/**
+ * @brief One fill: revalues a single position
+ */
+void BM_LivePortfolioFill(benchmark::State& state) {
+    LivePortfolio live(0.04, TODAY);
+    std::size_t size = static_cast<std::size_t>(state.range(0));
+    std::vector<SymbolId> ids = live_book(live, size);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        live.apply_fill(book_contract(ids, i % size),
+                        i % 2 ? thales::Side::SELL : thales::Side::BUY, 1,
+                        2.5);
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LivePortfolioFill)->Arg(1000)->Arg(10000);
+
+/**
+ * @brief One underlying quote: revalues that underlying's positions
+ */
+void BM_LivePortfolioQuote(benchmark::State& state) {
+    LivePortfolio live(0.04, TODAY);
+    std::vector<SymbolId> ids =
+        live_book(live, static_cast<std::size_t>(state.range(0)));
+    std::size_t i = 0;
+    for (auto _ : state) {
+        live.update_underlying(ids[i % UNDERLYINGS],
+                               100.0 + 0.01 * static_cast<double>(i % 100),
+                               0.2);
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LivePortfolioQuote)->Arg(1000)->Arg(10000);
+
+/**
+ * @brief What either update costs without the live book: full risk
+ */
+void BM_LivePortfolioFullRisk(benchmark::State& state) {
+    LivePortfolio live(0.04, TODAY);
+    live_book(live, static_cast<std::size_t>(state.range(0)));
+    thales::MarketData market;
+    market.spot.assign(thales::SymbolTable::size(), 100.0);
+    market.volatility.assign(market.spot.size(), 0.2);
+    market.rate = 0.04;
+    market.valuation_date = TODAY;
+    std::vector<thales::UnderlyingRisk> risk;
+    for (auto _ : state) {
+        live.positions().calculate_risk(market, risk);
+        benchmark::DoNotOptimize(risk.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LivePortfolioFullRisk)->Arg(1000)->Arg(10000);
+
+/**
+ * @brief A reader's consistent copy of every underlying's totals
+ */
+void BM_LivePortfolioSnapshot(benchmark::State& state) {
+    LivePortfolio live(0.04, TODAY);
+    live_book(live, 1000);
+    thales::UnderlyingBook totals;
+    std::vector<thales::UnderlyingBook> books;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(live.snapshot(totals, books));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LivePortfolioSnapshot);
+
+}  // namespace
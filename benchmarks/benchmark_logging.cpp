@@ -0,0 +1,79 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <fstream>
+
+#include "benchmark/benchmark.h"
+#include "utils/logging.h"
+
+namespace {
+
+/**
+ * @brief The former LOG macro: a flushing stream write on the caller.
+ */
+#define STREAM_LOG(out, message) out << message << std::endl
+
+void BM_LogStreamMacro(benchmark::State& state) {
+    std::ofstream out("/dev/null");
+    int i = 0;
+    for (auto _ : state) {
+        STREAM_LOG(out, "Priced " << ++i << " options at " << 0.25);
+    }
+}
+BENCHMARK(BM_LogStreamMacro);
+
+/**
+ * @brief Per-call cost of the asynchronous logger on the logging thread.
+ */
+void BM_LogAsync(benchmark::State& state) {
+    thales::LogSettings settings;
+    settings.path = "/dev/null";
+    settings.buffer_size = 1 << 24;
+    thales::Logger& logger = thales::Logger::instance();
+    logger.configure(settings);
+    std::uint64_t dropped = logger.dropped();
+    int i = 0;
+    for (auto _ : state) {
+        LOG_INFO("Priced {} options at {}", ++i, 0.25);
+    }
+    logger.flush();
+    state.counters["dropped"] =
+        static_cast<double>(logger.dropped() - dropped);
+    logger.configure(thales::LogSettings());
+}
+BENCHMARK(BM_LogAsync);
+
+/**
+ * @brief Cost of a call filtered out by the run-time level.
+ */
+void BM_LogFiltered(benchmark::State& state) {
+    int i = 0;
+    for (auto _ : state) {
+        LOG_DEBUG("Priced {} options at {}", ++i, 0.25);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_LogFiltered);
+
+}  // namespace
@@ -24,7 +24,31 @@
 
 #include <benchmark/benchmark.h>
 
-#include "benchmark_black_scholes.cpp"
-#include "benchmark_portfolio.cpp"
+#include <cstring>
+#include <iostream>
 
-BENCHMARK_MAIN();
+/**
+ * @brief Build configuration, recorded in every report as "thales_build".
+ */
+#ifndef THALES_BENCHMARK_BUILD
+#define THALES_BENCHMARK_BUILD "unknown"
+#endif
+
+// Each benchmark file is its own translation unit; this one only adds the
+// build to the report context, so the comparison script can refuse to
+// compare runs from different builds
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::AddCustomContext("thales_build", THALES_BENCHMARK_BUILD);
+    if (std::strcmp(THALES_BENCHMARK_BUILD, "sanitized") == 0) {
+        std::cerr << "warning: benchmarks built with -O0 and "
+                     "AddressSanitizer; use scripts/benchmark.sh for "
+                     "meaningful numbers\n";
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "data/data_loader.h"
+
+namespace {
+
+/**
+ * @brief A feed message batching the given number of option quotes.
+ */
+std::string quote_message(int quotes) {
+    std::string message = "[";
+    for (int i = 0; i < quotes; ++i) {
+        message += (i ? "," : "");
+        message += R"({"ev":"Q","sym":"O:SPY241220C00)" +
+                   std::to_string(400 + i % 200) +
+                   R"(000","bx":302,"ax":302,"bp":9.71,"ap":9.81,"bs":17,)"
+                   R"("as":24,"t":1644506128351,"q":844090872})";
+    }
+    return message + "]";
+}
+
+void BM_PolygonParseQuotes(benchmark::State& state) {
+    std::string message = quote_message(state.range(0));
+    thales::PolygonFeedParser parser;
+    std::vector<thales::Quote> quotes;
+    for (auto _ : state) {
+        quotes.clear();
+        benchmark::DoNotOptimize(parser.parse(message, quotes));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * message.size());
+}
+BENCHMARK(BM_PolygonParseQuotes)->Arg(1)->Arg(100);
+
+/**
+ * @brief Quote-to-consumer latency through the queue: a feed thread pushes
+ * one timestamped quote at a time and waits until the consumer has it.
+ */
+void BM_QuoteQueueHandoff(benchmark::State& state) {
+    thales::QuoteQueue queue(1024);
+    std::atomic<bool> done{false};
+    std::atomic<std::int64_t> consumed{0};
+    std::thread consumer([&] {
+        thales::Quote quote;
+        while (!done.load(std::memory_order_relaxed)) {
+            if (queue.try_pop(quote)) {
+                consumed.store(quote.timestamp_ns, std::memory_order_release);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::int64_t sequence = 0;
+    for (auto _ : state) {
+        thales::Quote quote = {++sequence, 9.71, 9.81, 17, 24, 0};
+        while (!queue.try_push(quote)) {
+            std::this_thread::yield();
+        }
+        while (consumed.load(std::memory_order_acquire) != sequence) {
+            std::this_thread::yield();
+        }
+    }
+    done = true;
+    consumer.join();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_QuoteQueueHandoff)->UseRealTime();
+
+}  // namespace
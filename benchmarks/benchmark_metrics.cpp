@@ -0,0 +1,102 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "utils/metrics.h"
+
+namespace {
+
+using thales::Counter;
+using thales::LatencyMetric;
+using thales::MetricsRegistry;
+using thales::ScopedTimer;
+
+/**
+ * @brief One counter increment on the calling thread's cell
+ */
+void BM_MetricsCounterAdd(benchmark::State& state) {
+    Counter& counter = MetricsRegistry::instance().counter(
+        "bench_counter_total", "Benchmark counter");
+    for (auto _ : state) {
+        counter.add();
+    }
+    benchmark::DoNotOptimize(counter.value());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MetricsCounterAdd)->ThreadRange(1, 4);
+
+/**
+ * @brief One timed scope: two TSC reads and a histogram record
+ */
+void BM_MetricsScopedTimer(benchmark::State& state) {
+    LatencyMetric& latency = MetricsRegistry::instance().latency(
+        "bench_timer_seconds", "Benchmark timer");
+    for (auto _ : state) {
+        ScopedTimer timer(latency);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MetricsScopedTimer)->ThreadRange(1, 4);
+
+/**
+ * @brief What the same scope costs on the steady clock instead
+ */
+void BM_MetricsSteadyClockTimer(benchmark::State& state) {
+    LatencyMetric& latency = MetricsRegistry::instance().latency(
+        "bench_steady_timer_seconds", "Benchmark timer");
+    for (auto _ : state) {
+        std::int64_t start = thales::steady_now_ns();
+        latency.record(thales::steady_now_ns() - start);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MetricsSteadyClockTimer);
+
+/**
+ * @brief Exporting a registry of a few dozen metrics
+ */
+void BM_MetricsPrometheusExport(benchmark::State& state) {
+    MetricsRegistry registry;
+    for (int i = 0; i < 24; ++i) {
+        registry.counter("bench_export_" + std::to_string(i) + "_total", "")
+            .add(static_cast<std::uint64_t>(i));
+    }
+    for (int i = 0; i < 8; ++i) {
+        registry.latency("bench_export_" + std::to_string(i) + "_seconds", "")
+            .record(1000 * i);
+    }
+    std::string text;
+    for (auto _ : state) {
+        text.clear();
+        registry.write_prometheus(text);
+        benchmark::DoNotOptimize(text.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MetricsPrometheusExport);
+
+}  // namespace
@@ -0,0 +1,106 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstddef>
+
+#include "benchmark/benchmark.h"
+#include "trading/monte_carlo.h"
+#include "utils/thread_pool.h"
+
+namespace {
+
+/** @brief One-year Asian call averaged over 252 daily fixings */
+PathOption daily_asian() {
+    PathOption option;
+    option.payoff = PathPayoff::ASIAN;
+    option.steps = 252;
+    option.r = 0.03;
+    option.sigma = 0.25;
+    return option;
+}
+
+/**
+ * @brief Paths per second on the calling thread, by random sequence
+ */
+void BM_MonteCarloAsian(benchmark::State& state) {
+    PathOption option = daily_asian();
+    MonteCarloSettings settings;
+    settings.paths = 1 << 14;
+    settings.sequence = static_cast<RandomSequence>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(MonteCarlo::price(option, settings));
+    }
+    state.SetItemsProcessed(state.iterations() * settings.paths);
+}
+BENCHMARK(BM_MonteCarloAsian)
+    ->Arg(static_cast<int>(RandomSequence::PHILOX))
+    ->Arg(static_cast<int>(RandomSequence::SOBOL))
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Scaling of the same simulation over 1 to 8 pool threads
+ */
+void BM_MonteCarloScaling(benchmark::State& state) {
+    PathOption option = daily_asian();
+    MonteCarloSettings settings;
+    settings.paths = 1 << 16;
+    thales::ThreadPool pool(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(MonteCarlo::price(option, settings, pool));
+    }
+    state.SetItemsProcessed(state.iterations() * settings.paths);
+}
+BENCHMARK(BM_MonteCarloScaling)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+/**
+ * @brief Normal quantiles per second on each supported backend
+ */
+void BM_InverseNormalCdf(benchmark::State& state) {
+    auto backend = static_cast<SimdBackend>(state.range(0));
+    if (!BlackScholes::is_simd_backend_supported(backend)) {
+        state.SkipWithError("Backend not supported on this CPU");
+        return;
+    }
+    constexpr std::size_t kSize = 4096;
+    double p[kSize];
+    double z[kSize];
+    for (std::size_t i = 0; i < kSize; ++i) {
+        p[i] = (i + 0.5) / kSize;
+    }
+    for (auto _ : state) {
+        MonteCarlo::inverse_normal_cdf(p, z, kSize, backend);
+        benchmark::DoNotOptimize(z);
+    }
+    state.SetItemsProcessed(state.iterations() * kSize);
+}
+BENCHMARK(BM_InverseNormalCdf)
+    ->Arg(static_cast<int>(SimdBackend::SCALAR))
+    ->Arg(static_cast<int>(SimdBackend::AVX2))
+    ->Arg(static_cast<int>(SimdBackend::AVX512));
+
+}  // namespace
@@ -0,0 +1,181 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "trading/option_chain.h"
+
+namespace {
+
+using thales::ChainQuery;
+using thales::ContractKey;
+using thales::OptionChainIndex;
+using thales::SymbolId;
+
+constexpr std::int32_t TODAY = 19888;  // 2024-06-15
+constexpr std::size_t UNDERLYINGS = 2000;
+constexpr std::size_t EXPIRIES = 25;
+constexpr std::size_t STRIKES = 10;
+
+/** @brief A listed universe of 2000 x 25 x 2 x 10 = 1M contracts */
+const std::vector<ContractKey>& universe() {
+    static const std::vector<ContractKey> contracts = [] {
+        std::vector<ContractKey> keys;
+        keys.reserve(UNDERLYINGS * EXPIRIES * 2 * STRIKES);
+        for (std::size_t u = 0; u < UNDERLYINGS; ++u) {
+            SymbolId id =
+                thales::SymbolTable::intern("CHAIN" + std::to_string(u));
+            for (std::size_t e = 0; e < EXPIRIES; ++e) {
+                for (OptionType type : {CALL, PUT}) {
+                    for (std::size_t s = 0; s < STRIKES; ++s) {
+                        keys.push_back(
+                            {id, TODAY + 7 * static_cast<std::int32_t>(e),
+                             type, 90.0 + 2.5 * static_cast<double>(s)});
+                    }
+                }
+            }
+        }
+        return keys;
+    }();
+    return contracts;
+}
+
+const OptionChainIndex& universe_index() {
+    static const OptionChainIndex index(universe());
+    return index;
+}
+
+/** @brief Contract lookups in a spread-out order */
+ContractKey probe(std::size_t i) {
+    const std::vector<ContractKey>& contracts = universe();
+    return contracts[(i * 7919) % contracts.size()];
+}
+
+/**
+ * @brief One contract lookup in the index
+ */
+void BM_OptionChainFind(benchmark::State& state) {
+    const OptionChainIndex& index = universe_index();
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.find(probe(i++)));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OptionChainFind);
+
+/**
+ * @brief The same lookup in a hash map of every contract
+ */
+void BM_OptionChainHashFind(benchmark::State& state) {
+    static const auto map = [] {
+        std::unordered_map<ContractKey, std::size_t, thales::ContractKeyHash>
+            rows;
+        rows.reserve(universe().size());
+        for (std::size_t row = 0; row < universe().size(); ++row) {
+            rows.emplace(universe()[row], row);
+        }
+        return rows;
+    }();
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(map.find(probe(i++)));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OptionChainHashFind);
+
+ChainQuery range_query(std::size_t i) {
+    ChainQuery query;
+    query.underlying = universe()[(i * 7919) % universe().size()].underlying;
+    query.first_expiration = TODAY + 7 * 4;
+    query.last_expiration = TODAY + 7 * 8;
+    query.puts = false;
+    query.min_strike = 95.0;
+    query.max_strike = 105.0;
+    return query;
+}
+
+/**
+ * @brief One underlying's calls over five expiries and five strikes
+ */
+void BM_OptionChainRange(benchmark::State& state) {
+    const OptionChainIndex& index = universe_index();
+    std::vector<std::size_t> rows;
+    std::size_t i = 0;
+    for (auto _ : state) {
+        rows.clear();
+        index.select(range_query(i++), rows);
+        benchmark::DoNotOptimize(rows.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OptionChainRange);
+
+/**
+ * @brief The same range found by scanning every contract
+ */
+void BM_OptionChainRangeScan(benchmark::State& state) {
+    const std::vector<ContractKey>& contracts = universe();
+    std::vector<std::size_t> rows;
+    std::size_t i = 0;
+    for (auto _ : state) {
+        ChainQuery query = range_query(i++);
+        rows.clear();
+        for (std::size_t row = 0; row < contracts.size(); ++row) {
+            const ContractKey& c = contracts[row];
+            if (c.underlying == query.underlying &&
+                c.expiration >= query.first_expiration &&
+                c.expiration <= query.last_expiration && c.type == CALL &&
+                c.strike >= query.min_strike &&
+                c.strike <= query.max_strike) {
+                rows.push_back(row);
+            }
+        }
+        benchmark::DoNotOptimize(rows.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OptionChainRangeScan);
+
+/**
+ * @brief Building the index over the whole universe
+ */
+void BM_OptionChainBuild(benchmark::State& state) {
+    const std::vector<ContractKey>& contracts = universe();
+    for (auto _ : state) {
+        OptionChainIndex index(contracts);
+        benchmark::DoNotOptimize(index.size());
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(contracts.size()));
+}
+BENCHMARK(BM_OptionChainBuild)->Unit(benchmark::kMillisecond);
+
+}  // namespace
@@ -0,0 +1,147 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "benchmark/benchmark.h"
+#include "trading/broker_interface.h"
+#include "trading/order_manager.h"
+#include "utils/latency_histogram.h"
+
+namespace {
+
+using thales::ContractKey;
+using thales::OrderManager;
+using thales::OrderRequest;
+using thales::RiskLimits;
+
+/** @brief Limits wide enough that no benchmark order is refused */
+RiskLimits open_limits() {
+    RiskLimits limits;
+    limits.max_order_quantity = 1000;
+    limits.max_order_notional = 1e12;
+    limits.max_position = 1 << 30;
+    limits.max_underlying_position = 1 << 30;
+    limits.max_working_notional = 1e15;
+    limits.max_orders_per_second = 1e12;
+    limits.order_burst = 1 << 30;
+    return limits;
+}
+
+/** @brief An order on one of 64 contracts of one underlying */
+OrderRequest bench_order(std::int64_t i) {
+    ContractKey contract{thales::SymbolTable::intern("OMS"), 20000, CALL,
+                         100.0 + static_cast<double>(i % 64)};
+    return {i % 2 ? thales::Side::SELL : thales::Side::BUY, contract, 1, 2.5};
+}
+
+/**
+ * @brief Check, accept and fill one order against the running exposure
+ */
+void BM_PreTradeRisk(benchmark::State& state) {
+    thales::PreTradeRisk risk(open_limits());
+    std::int64_t i = 0;
+    for (auto _ : state) {
+        OrderRequest order = bench_order(i++);
+        auto reason = risk.check(order, 2.5, i);
+        benchmark::DoNotOptimize(reason);
+        risk.accept(order, 2.5, i);
+        risk.fill(order, 1, 2.5);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PreTradeRisk);
+
+/**
+ * @brief One order at a time from submit() to the simulated fill
+ *
+ * Reports the manager's tick-to-order percentiles in nanoseconds.
+ */
+void BM_OrderRoundTrip(benchmark::State& state) {
+    thales::SimulatedBroker broker;
+    std::atomic<std::uint64_t> done{0};
+    OrderManager manager(open_limits(), broker,
+                         [&](const thales::OrderUpdate& update) {
+                             if (update.status ==
+                                 thales::OrderStatus::FILLED) {
+                                 done.fetch_add(1, std::memory_order_release);
+                             }
+                         });
+    broker.connect(manager);
+    manager.start();
+
+    std::uint64_t submitted = 0;
+    for (auto _ : state) {
+        manager.submit(bench_order(static_cast<std::int64_t>(submitted)),
+                       2.5, thales::steady_now_ns());
+        ++submitted;
+        while (done.load(std::memory_order_acquire) < submitted) {
+            std::this_thread::yield();
+        }
+    }
+    manager.stop();
+
+    const auto& latency = manager.tick_to_order();
+    state.counters["p50_ns"] = static_cast<double>(latency.percentile(50));
+    state.counters["p99_ns"] = static_cast<double>(latency.percentile(99));
+    state.counters["max_ns"] = static_cast<double>(latency.max());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OrderRoundTrip)->UseRealTime();
+
+/**
+ * @brief Four producers submitting as fast as the queue accepts
+ */
+void BM_OrderThroughput(benchmark::State& state) {
+    constexpr int PRODUCERS = 4;
+    constexpr int ORDERS = 4096;
+    for (auto _ : state) {
+        thales::SimulatedBroker broker;
+        OrderManager manager(open_limits(), broker);
+        broker.connect(manager);
+        manager.start();
+        std::thread producers[PRODUCERS];
+        for (auto& producer : producers) {
+            producer = std::thread([&] {
+                for (int i = 0; i < ORDERS; ++i) {
+                    while (manager.submit(bench_order(i), 2.5,
+                                          thales::steady_now_ns()) == 0) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        manager.stop();
+        benchmark::DoNotOptimize(manager.sent());
+    }
+    state.SetItemsProcessed(state.iterations() * PRODUCERS * ORDERS);
+}
+BENCHMARK(BM_OrderThroughput)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+}  // namespace
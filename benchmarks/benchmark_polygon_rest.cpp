@@ -0,0 +1,123 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "data/polygon_rest.h"
+
+namespace {
+
+/**
+ * @brief Minute-bar aggregates response in Polygon's layout.
+ */
+std::string aggregates_response(int bars) {
+    std::string body =
+        R"({"ticker":"AAPL","queryCount":)" + std::to_string(bars) +
+        R"(,"resultsCount":)" + std::to_string(bars) +
+        R"(,"adjusted":true,"results":[)";
+    for (int i = 0; i < bars; ++i) {
+        double open = 130.0 + (i % 500) * 0.01;
+        body += (i ? "," : "");
+        body += R"({"v":)" + std::to_string(10000 + i % 7919) +
+                R"(,"vw":)" + std::to_string(open + 0.0123) +
+                R"(,"o":)" + std::to_string(open) +
+                R"(,"c":)" + std::to_string(open + 0.02) +
+                R"(,"h":)" + std::to_string(open + 0.05) +
+                R"(,"l":)" + std::to_string(open - 0.04) +
+                R"(,"t":)" + std::to_string(1673240400000LL + i * 60000LL) +
+                R"(,"n":)" + std::to_string(100 + i % 97) + "}";
+    }
+    return body + R"(],"status":"OK","request_id":"6a7e466379af0a71039d)"
+                  R"(60cc78e72282","count":)" +
+           std::to_string(bars) + "}";
+}
+
+/**
+ * @brief Option chain snapshot response in Polygon's layout.
+ */
+std::string option_chain_response(int contracts) {
+    std::string body = R"({"request_id":"abc","results":[)";
+    for (int i = 0; i < contracts; ++i) {
+        std::string strike = std::to_string(100 + i % 200);
+        std::string ticker = "O:SPY2412" + std::to_string(10 + i % 20) +
+                             (i % 2 ? "P" : "C") + "00" + strike + "000";
+        body += (i ? "," : "");
+        body += R"({"break_even_price":171.075,"day":{"change":-0.05,)"
+                R"("change_percent":-0.78,"close":6.35,"high":7.01,)"
+                R"("last_updated":1702443600000000000,"low":5.98,)"
+                R"("open":6.9,"previous_close":6.4,"volume":2574,)"
+                R"("vwap":6.51},"details":{"contract_type":")" +
+                std::string(i % 2 ? "put" : "call") +
+                R"(","exercise_style":"american","expiration_date":)"
+                R"("2024-12-20","shares_per_contract":100,"strike_price":)" +
+                strike + R"(,"ticker":")" + ticker +
+                R"("},"greeks":{"delta":0.5334,"gamma":0.0312,)"
+                R"("theta":-0.0981,"vega":0.1953},"implied_volatility":)"
+                R"(0.2485,"last_quote":{"ask":6.4,"ask_size":10,"bid":6.15,)"
+                R"("bid_size":5,"last_updated":1702503760123456789,)"
+                R"("midpoint":6.275,"timeframe":"REAL-TIME"},)"
+                R"("open_interest":8921,"underlying_asset":{)"
+                R"("change_to_break_even":2.4,"last_updated":)"
+                R"(1702503760123456789,"price":168.7,"ticker":"SPY",)"
+                R"("timeframe":"REAL-TIME"}})";
+    }
+    return body + R"(],"status":"OK"})";
+}
+
+void BM_PolygonParseAggregates(benchmark::State& state) {
+    static const std::string body = aggregates_response(50000);
+    thales::PolygonRestParser parser(
+        static_cast<SimdBackend>(state.range(0)));
+    thales::BarColumns bars;
+    for (auto _ : state) {
+        bars.clear();
+        benchmark::DoNotOptimize(parser.parse_aggregates(body, bars));
+    }
+    state.SetBytesProcessed(state.iterations() * body.size());
+    state.SetItemsProcessed(state.iterations() * bars.size());
+}
+BENCHMARK(BM_PolygonParseAggregates)
+    ->Arg(static_cast<int>(SimdBackend::SCALAR))
+    ->Arg(static_cast<int>(SimdBackend::AUTO))
+    ->Unit(benchmark::kMillisecond);
+
+void BM_PolygonParseOptionChain(benchmark::State& state) {
+    static const std::string body = option_chain_response(5000);
+    thales::PolygonRestParser parser(
+        static_cast<SimdBackend>(state.range(0)));
+    thales::OptionChainColumns chain;
+    for (auto _ : state) {
+        chain.clear();
+        benchmark::DoNotOptimize(parser.parse_option_chain(body, chain));
+    }
+    state.SetBytesProcessed(state.iterations() * body.size());
+    state.SetItemsProcessed(state.iterations() * chain.size());
+}
+BENCHMARK(BM_PolygonParseOptionChain)
+    ->Arg(static_cast<int>(SimdBackend::SCALAR))
+    ->Arg(static_cast<int>(SimdBackend::AUTO))
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
@@ -1,7 +1,12 @@
 #include <benchmark/benchmark.h>
 
+#include <string>
+#include <vector>
+
 #include "trading/portfolio.h"
 #include "trading/position.h"
+#include "utils/thread_pool.h"
+#include "workloads.h"
 
 static void BM_PortfolioCreation(benchmark::State& state) {
     // Constants
@@ -45,3 +50,91 @@ static void BM_PortfolioNetLiquidityCalculation(benchmark::State& state) {
     }
 }
 BENCHMARK(BM_PortfolioNetLiquidityCalculation);
+
+/**
+ * @brief Randomized book over 500 underlyings; see workloads.h.
+ */
+static thales::Portfolio make_book(std::size_t size,
+                                   thales::MarketData& market) {
+    workloads::Universe universe = workloads::make_universe(500, "BOOK");
+    market = universe.market;
+    return workloads::make_book(universe, size);
+}
+
+static void BM_PortfolioMarketValue(benchmark::State& state) {
+    thales::MarketData market;
+    thales::Portfolio book = make_book(state.range(0), market);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book.calculate_market_value(market));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PortfolioMarketValue)
+    ->RangeMultiplier(10)
+    ->Range(1000, 1000000)
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_PortfolioRiskByUnderlying(benchmark::State& state) {
+    thales::MarketData market;
+    thales::Portfolio book = make_book(state.range(0), market);
+    std::vector<thales::UnderlyingRisk> risk;
+    for (auto _ : state) {
+        book.calculate_risk(market, risk);
+        benchmark::DoNotOptimize(risk.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PortfolioRiskByUnderlying)
+    ->RangeMultiplier(10)
+    ->Range(1000, 1000000)
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_PortfolioSpotMovePnl(benchmark::State& state) {
+    thales::MarketData market;
+    thales::Portfolio book = make_book(state.range(0), market);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book.calculate_spot_move_pnl(market, -0.05));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PortfolioSpotMovePnl)->Arg(500000)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Scaling curve: market value of a book on 1..32 workers.
+ */
+static void BM_PortfolioMarketValueParallel(benchmark::State& state) {
+    thales::MarketData market;
+    thales::Portfolio book = make_book(state.range(0), market);
+    thales::ThreadPool pool(state.range(1));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book.calculate_market_value(market, pool));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["threads"] = static_cast<double>(pool.size());
+}
+BENCHMARK(BM_PortfolioMarketValueParallel)
+    ->ArgsProduct({{10000, 500000}, {1, 2, 4, 8, 16, 32}})
+    ->ArgNames({"positions", "threads"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Scaling curve: per-underlying risk of a book on 1..32 workers.
+ */
+static void BM_PortfolioRiskParallel(benchmark::State& state) {
+    thales::MarketData market;
+    thales::Portfolio book = make_book(state.range(0), market);
+    thales::ThreadPool pool(state.range(1));
+    std::vector<thales::UnderlyingRisk> risk;
+    for (auto _ : state) {
+        book.calculate_risk(market, risk, pool);
+        benchmark::DoNotOptimize(risk.data());
+    }
+    state.SetItemsProcessed(state.iterations() * book.size());
+    state.counters["threads"] = static_cast<double>(pool.size());
+}
+BENCHMARK(BM_PortfolioRiskParallel)
+    ->ArgsProduct({{10000, 500000}, {1, 2, 4, 8, 16, 32}})
+    ->ArgNames({"positions", "threads"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,113 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "utils/response_cache.h"
+
+namespace {
+
+using thales::ResponseCache;
+
+/**
+ * @brief An aggregates page of minute bars, as Polygon returns it
+ */
+std::string make_page(std::size_t bars) {
+    std::mt19937_64 rng(42);
+    std::normal_distribution<double> step(0.0, 0.05);
+    std::string body = R"({"ticker":"SPY","status":"OK","results":[)";
+    double price = 500.0;
+    std::int64_t t = 1709280000000;
+    for (std::size_t i = 0; i < bars; ++i) {
+        double open = price;
+        price += step(rng);
+        body += i == 0 ? "{" : ",{";
+        body += "\"v\":" + std::to_string(1000 + rng() % 50000) +
+                ",\"vw\":" + std::to_string((open + price) / 2) +
+                ",\"o\":" + std::to_string(open) +
+                ",\"c\":" + std::to_string(price) +
+                ",\"h\":" + std::to_string(std::max(open, price) + 0.02) +
+                ",\"l\":" + std::to_string(std::min(open, price) - 0.02) +
+                ",\"t\":" + std::to_string(t + 60000 * i) +
+                ",\"n\":" + std::to_string(10 + rng() % 500) + "}";
+    }
+    return body + "]}";
+}
+
+std::string cache_directory() {
+    return (std::filesystem::temp_directory_path() /
+            ("thales_bench_cache_" + std::to_string(::getpid())))
+        .string();
+}
+
+/**
+ * @brief Reading a cached page back instead of fetching it
+ */
+void BM_ResponseCacheLoad(benchmark::State& state) {
+    std::string page = make_page(static_cast<std::size_t>(state.range(0)));
+    std::string directory = cache_directory();
+    {
+        ResponseCache cache(directory);
+        cache.store("/v2/aggs/ticker/SPY", page);
+        std::string body;
+        for (auto _ : state) {
+            cache.load("/v2/aggs/ticker/SPY", body);
+            benchmark::DoNotOptimize(body.data());
+        }
+        state.counters["compression"] =
+            static_cast<double>(page.size()) /
+            std::filesystem::file_size(cache.path("/v2/aggs/ticker/SPY"));
+    }
+    std::filesystem::remove_all(directory);
+    state.SetBytesProcessed(state.iterations() * page.size());
+}
+BENCHMARK(BM_ResponseCacheLoad)->Arg(390)->Arg(50000)
+    ->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Compressing and writing a fetched page
+ */
+void BM_ResponseCacheStore(benchmark::State& state) {
+    std::string page = make_page(static_cast<std::size_t>(state.range(0)));
+    std::string directory = cache_directory();
+    {
+        ResponseCache cache(directory);
+        for (auto _ : state) {
+            cache.store("/v2/aggs/ticker/SPY", page);
+        }
+    }
+    std::filesystem::remove_all(directory);
+    state.SetBytesProcessed(state.iterations() * page.size());
+}
+BENCHMARK(BM_ResponseCacheStore)->Arg(390)->Arg(50000)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
@@ -0,0 +1,119 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "trading/risk_aggregation.h"
+#include "workloads.h"
+
+namespace {
+
+/**
+ * @brief Shard totals over a workload universe, as a LivePortfolio would
+ *        publish them.
+ */
+std::vector<thales::UnderlyingBook> shard_totals(
+    const workloads::Universe& universe) {
+    thales::Portfolio book = workloads::make_book(universe, 20000);
+    std::vector<thales::UnderlyingRisk> risk;
+    book.calculate_risk(universe.market, risk);
+    std::vector<thales::UnderlyingBook> totals(risk.size());
+    for (std::size_t id = 0; id < risk.size(); ++id) {
+        totals[id].risk = risk[id];
+    }
+    return totals;
+}
+
+/**
+ * @brief Encoding one publish cycle in which a share of the underlyings
+ *        moved.
+ *
+ * Arguments: underlyings moved per 1000. The "bytes" counter is the frame
+ * size, against a full resend of every underlying at 1000.
+ */
+void BM_RiskDeltaEncode(benchmark::State& state) {
+    workloads::Universe universe = workloads::make_universe(2000, "AGG");
+    std::vector<thales::UnderlyingBook> totals = shard_totals(universe);
+    thales::RiskDeltaEncoder encoder(0, "ACCT");
+    std::string frame;
+    encoder.encode(totals, 0, frame);
+    std::size_t moved = totals.size() *
+                        static_cast<std::size_t>(state.range(0)) / 1000;
+    std::int64_t cycle = 0;
+    for (auto _ : state) {
+        ++cycle;
+        for (std::size_t i = 0; i < moved; ++i) {
+            totals[i * totals.size() / moved].risk.delta += 1.0;
+        }
+        encoder.encode(totals, cycle, frame);
+        benchmark::DoNotOptimize(frame.data());
+    }
+    state.counters["bytes"] = static_cast<double>(frame.size());
+}
+BENCHMARK(BM_RiskDeltaEncode)->Arg(0)->Arg(10)->Arg(100)->Arg(1000);
+
+/**
+ * @brief Applying one shard's delta frame at an aggregator of 8 shards.
+ */
+void BM_RiskAggregatorApply(benchmark::State& state) {
+    workloads::Universe universe = workloads::make_universe(2000, "AGG");
+    std::vector<thales::UnderlyingBook> totals = shard_totals(universe);
+    thales::RiskAggregator aggregator;
+    std::vector<thales::RiskDeltaEncoder> encoders;
+    std::string snapshot;
+    std::string frame;
+    for (std::uint32_t shard = 0; shard < 8; ++shard) {
+        encoders.emplace_back(shard, "ACCT");
+        encoders.back().encode(totals, 0, frame);
+        aggregator.apply(frame);
+        if (shard == 0) {
+            snapshot = frame;
+        }
+    }
+    std::vector<std::string> deltas;
+    for (int i = 0; i < 64; ++i) {
+        for (std::size_t id = 0; id < totals.size(); id += 100) {
+            totals[id].risk.delta += 1.0;
+        }
+        encoders[0].encode(totals, i + 1, frame);
+        deltas.push_back(frame);
+    }
+    // Replays the run of frames, restarting it from the shard's snapshot
+    // so the sequence numbers keep following
+    std::size_t next = 0;
+    for (auto _ : state) {
+        if (next == deltas.size()) {
+            state.PauseTiming();
+            aggregator.apply(snapshot);
+            next = 0;
+            state.ResumeTiming();
+        }
+        aggregator.apply(deltas[next++]);
+    }
+}
+BENCHMARK(BM_RiskAggregatorApply);
+
+}  // namespace
@@ -0,0 +1,163 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "trading/portfolio.h"
+#include "trading/scenario_engine.h"
+#include "utils/thread_pool.h"
+
+namespace {
+
+using thales::MarketData;
+using thales::Portfolio;
+using thales::ScenarioEngine;
+using thales::ScenarioGrid;
+
+/** @brief The risk team's 41 x 21 x 5 spot, volatility and time grid */
+ScenarioGrid risk_grid() {
+    return {ScenarioGrid::linear(-0.2, 0.2, 41),
+            ScenarioGrid::linear(-0.1, 0.1, 21),
+            {0, 1, 5, 10, 21}};
+}
+
+/**
+ * @brief Book of options on 50 underlyings with strikes around each spot
+ */
+Portfolio scenario_book(std::size_t size, MarketData& market) {
+    const std::size_t UNDERLYINGS = 50;
+    const std::int32_t TODAY = 19888;  // 2024-06-15
+
+    std::vector<thales::SymbolId> ids;
+    for (std::size_t u = 0; u < UNDERLYINGS; ++u) {
+        ids.push_back(
+            thales::SymbolTable::intern("GRID" + std::to_string(u)));
+    }
+    market.spot.assign(thales::SymbolTable::size(), 100.0);
+    market.volatility.assign(market.spot.size(), 0.3);
+    market.rate = 0.04;
+    market.valuation_date = TODAY;
+    for (std::size_t u = 0; u < UNDERLYINGS; ++u) {
+        market.spot[ids[u]] = 20.0 + 8.0 * u;
+        market.volatility[ids[u]] = 0.15 + 0.01 * u;
+    }
+
+    Portfolio portfolio(1e6);
+    portfolio.reserve(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        thales::SymbolId id = ids[i % UNDERLYINGS];
+        double strike = market.spot[id] * (0.7 + 0.6 * ((i / 7) % 61) / 60.0);
+        int quantity = static_cast<int>(i % 21) - 10;
+        portfolio.add_position(thales::Position(
+            id, i % 2 ? PUT : CALL, strike,
+            TODAY + 30 + static_cast<std::int32_t>((i * 37) % 700),
+            quantity == 0 ? 1 : quantity, 2.5));
+    }
+    return portfolio;
+}
+
+void report(benchmark::State& state, std::size_t scenarios,
+            std::size_t positions) {
+    state.counters["scenario_positions"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * scenarios * positions),
+        benchmark::Counter::kIsRate);
+}
+
+/**
+ * @brief Scenario-positions per second on the calling thread, per policy
+ */
+template <class Math>
+void BM_ScenarioGrid(benchmark::State& state) {
+    MarketData market;
+    Portfolio book = scenario_book(state.range(0), market);
+    ScenarioEngine engine(risk_grid());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(engine.run<Math>(book, market));
+    }
+    report(state, engine.grid().size(), book.size());
+}
+BENCHMARK_TEMPLATE(BM_ScenarioGrid, ExactMath)
+    ->Arg(2000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ScenarioGrid, RiskMath)
+    ->Arg(2000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ScenarioGrid, ScreeningMath)
+    ->Arg(2000)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Scaling of the same grid over 1 to 8 pool threads
+ */
+void BM_ScenarioGridParallel(benchmark::State& state) {
+    MarketData market;
+    Portfolio book = scenario_book(20000, market);
+    ScenarioEngine engine(risk_grid());
+    thales::ThreadPool pool(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(engine.run(book, market, pool));
+    }
+    report(state, engine.grid().size(), book.size());
+}
+BENCHMARK(BM_ScenarioGridParallel)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+/**
+ * @brief Baseline: one full portfolio revaluation per scenario
+ */
+void BM_ScenarioGridNaive(benchmark::State& state) {
+    MarketData market;
+    Portfolio book = scenario_book(state.range(0), market);
+    ScenarioGrid grid = risk_grid();
+    for (auto _ : state) {
+        double worst = 0.0;
+        double base = book.calculate_market_value(market);
+        for (int horizon : grid.horizons) {
+            for (double shift : grid.vol_shifts) {
+                for (double move : grid.spot_moves) {
+                    MarketData shocked = market;
+                    for (std::size_t id = 0; id < shocked.spot.size(); ++id) {
+                        shocked.spot[id] *= 1.0 + move;
+                        shocked.volatility[id] += shift;
+                    }
+                    shocked.valuation_date += horizon;
+                    double pnl = book.calculate_market_value(shocked) - base;
+                    worst = pnl < worst ? pnl : worst;
+                }
+            }
+        }
+        benchmark::DoNotOptimize(worst);
+    }
+    report(state, grid.size(), book.size());
+}
+BENCHMARK(BM_ScenarioGridNaive)->Arg(2000)->Unit(benchmark::kMillisecond);
+
+}  // namespace
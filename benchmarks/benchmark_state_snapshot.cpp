@@ -0,0 +1,112 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <unistd.h>
+
+#include <cmath>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "trading/state_snapshot.h"
+#include "workloads.h"
+
+namespace {
+
+using thales::StateSnapshot;
+using thales::TradingState;
+
+/**
+ * @brief A book of the given size with a fitted surface per underlying
+ */
+void make_state(TradingState& state, std::size_t positions) {
+    workloads::Universe universe = workloads::make_universe(200, "SNAP");
+    state.portfolio = workloads::make_book(universe, positions);
+    state.chain = thales::OptionChainIndex(state.portfolio);
+    state.surfaces.resize(thales::SymbolTable::size());
+    for (thales::SymbolId id : universe.ids) {
+        double spot = universe.market.spot[id];
+        thales::VolSurface& surface = state.surfaces[id].emplace(spot, 0.04);
+        for (int month = 1; month <= 12; ++month) {
+            std::vector<thales::SmileQuote> quotes;
+            for (double k = -0.4; k <= 0.401; k += 0.05) {
+                quotes.push_back({spot * std::exp(k),
+                                  universe.market.volatility[id] + 0.2 * k * k,
+                                  1.0});
+            }
+            surface.set_quotes(month / 12.0, quotes);
+        }
+        surface.refresh();
+    }
+    state.config.set("risk_management", "MAX_POSITION", "500");
+}
+
+std::string snapshot_path() {
+    return (std::filesystem::temp_directory_path() /
+            ("thales_bench_" + std::to_string(::getpid()) + ".snapshot"))
+        .string();
+}
+
+/**
+ * @brief Restoring a book and its surfaces at startup
+ */
+void BM_StateSnapshotRead(benchmark::State& state) {
+    std::string path = snapshot_path();
+    {
+        TradingState saved;
+        make_state(saved, static_cast<std::size_t>(state.range(0)));
+        StateSnapshot::write(path, saved);
+    }
+    TradingState loaded;
+    for (auto _ : state) {
+        StateSnapshot::read(path, loaded);
+        benchmark::DoNotOptimize(loaded.portfolio.size());
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            std::filesystem::file_size(path));
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_StateSnapshotRead)->Arg(10000)->Arg(1000000)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Writing a snapshot on the background thread, including fsync
+ */
+void BM_StateSnapshotWrite(benchmark::State& state) {
+    std::string path = snapshot_path();
+    TradingState saved;
+    make_state(saved, static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        StateSnapshot::write(path, saved);
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            std::filesystem::file_size(path));
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_StateSnapshotWrite)->Arg(10000)->Arg(1000000)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
@@ -0,0 +1,81 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <chrono>
+#include <memory_resource>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "utils/arena.h"
+#include "utils/thread_affinity.h"
+
+namespace {
+
+/**
+ * @brief How late each wait mode wakes for a deadline 200 us away.
+ *
+ * Arguments: WaitMode. The "late_ns" counter is the mean overshoot past
+ * the deadline, which is what a timed loop loses per cycle.
+ */
+void BM_IdleWaiterWakeUp(benchmark::State& state) {
+    using Clock = std::chrono::steady_clock;
+    thales::IdleWaiter waiter({static_cast<thales::WaitMode>(state.range(0)),
+                               1000, std::chrono::microseconds(50)});
+    double late_ns = 0.0;
+    for (auto _ : state) {
+        auto deadline = Clock::now() + std::chrono::microseconds(200);
+        waiter.wait_until(deadline, [] { return false; });
+        late_ns += std::chrono::duration<double, std::nano>(Clock::now() -
+                                                            deadline)
+                       .count();
+    }
+    state.counters["late_ns"] =
+        late_ns / static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_IdleWaiterWakeUp)
+    ->Arg(static_cast<int>(thales::WaitMode::SLEEP))
+    ->Arg(static_cast<int>(thales::WaitMode::BUSY_POLL))
+    ->Arg(static_cast<int>(thales::WaitMode::SPIN_THEN_PARK))
+    ->UseRealTime();
+
+/**
+ * @brief Filling a cycle's worth of arena memory backed by a NUMA node,
+ *        against the default heap.
+ *
+ * Arguments: node (-1 for the default resource).
+ */
+void BM_NumaArenaCycle(benchmark::State& state) {
+    thales::Arena arena(
+        64 * 1024,
+        thales::NumaMemoryResource::for_node(static_cast<int>(state.range(0))));
+    for (auto _ : state) {
+        std::pmr::vector<double> values(&arena);
+        values.assign(1 << 16, 1.0);
+        benchmark::DoNotOptimize(values.data());
+        arena.reset();
+    }
+}
+BENCHMARK(BM_NumaArenaCycle)->Arg(-1)->Arg(0);
+
+}  // namespace
@@ -0,0 +1,149 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "data/tick_store.h"
+
+namespace {
+
+using thales::BarColumns;
+using thales::BarFile;
+using thales::TickStore;
+
+constexpr std::int32_t kFirstDay = 19358;  // 2023-01-01
+constexpr int kDays = 504;                 // Two years of sessions
+constexpr int kBarsPerDay = 390;           // Minute bars, 09:30-16:00
+constexpr std::int64_t kNanosPerMinute = 60'000'000'000;
+constexpr std::int64_t kNanosPerDay = 1440 * kNanosPerMinute;
+
+/**
+ * @brief Store of minute bars shared by the scan benchmarks.
+ */
+class ScanStore {
+   public:
+    ScanStore()
+        : root(std::filesystem::temp_directory_path() /
+               ("thales_tick_store_bench_" + std::to_string(::getpid()))),
+          store(root.string()) {
+        BarColumns bars;
+        bars.reserve(kBarsPerDay);
+        thales::SymbolId symbol = thales::SymbolTable::intern("SPY");
+        for (int day = 0; day < kDays; ++day) {
+            bars.clear();
+            std::int64_t open = (kFirstDay + day) * kNanosPerDay +
+                                570 * kNanosPerMinute;
+            for (int i = 0; i < kBarsPerDay; ++i) {
+                std::size_t row = bars.append();
+                double price = 400.0 + (day % 50) + i * 0.01;
+                bars.symbol[row] = symbol;
+                bars.timestamp_ns[row] = open + i * kNanosPerMinute;
+                bars.open[row] = price;
+                bars.high[row] = price + 0.05;
+                bars.low[row] = price - 0.05;
+                bars.close[row] = price + 0.01;
+                bars.volume[row] = 10000.0 + i;
+                bars.vwap[row] = price;
+                bars.trades[row] = 100;
+            }
+            store.write_bars(bars);
+        }
+        days = store.bar_days("SPY");
+    }
+
+    ~ScanStore() { std::filesystem::remove_all(root); }
+
+    std::filesystem::path root;
+    TickStore store;
+    std::vector<std::int32_t> days;
+};
+
+ScanStore& scan_store() {
+    static ScanStore store;
+    return store;
+}
+
+/**
+ * @brief Volume-weighted close of one day, reading two columns.
+ */
+double weighted_close(const BarFile& bars) {
+    const double* close = bars.close();
+    const double* volume = bars.volume();
+    double sum = 0.0;
+    for (std::size_t i = 0; i < bars.size(); ++i) {
+        sum += close[i] * volume[i];
+    }
+    return sum;
+}
+
+/**
+ * @brief Opens and scans every day, as a backtest over the range would.
+ */
+void BM_TickStoreScanDays(benchmark::State& state) {
+    ScanStore& data = scan_store();
+    std::int64_t rows = 0;
+    for (auto _ : state) {
+        double total = 0.0;
+        for (std::int32_t day : data.days) {
+            BarFile bars = data.store.read_bars("SPY", day);
+            total += weighted_close(bars);
+            rows += static_cast<std::int64_t>(bars.size());
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(rows);
+    state.SetBytesProcessed(rows * 2 * sizeof(double));
+}
+BENCHMARK(BM_TickStoreScanDays)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Scans days that are already mapped, isolating column throughput.
+ */
+void BM_TickStoreScanMapped(benchmark::State& state) {
+    ScanStore& data = scan_store();
+    std::vector<BarFile> files;
+    for (std::int32_t day : data.days) {
+        files.push_back(data.store.read_bars("SPY", day));
+    }
+    std::int64_t rows = 0;
+    for (auto _ : state) {
+        double total = 0.0;
+        for (const BarFile& bars : files) {
+            total += weighted_close(bars);
+            rows += static_cast<std::int64_t>(bars.size());
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(rows);
+    state.SetBytesProcessed(rows * 2 * sizeof(double));
+}
+BENCHMARK(BM_TickStoreScanMapped)->Unit(benchmark::kMillisecond);
+
+}  // namespace
@@ -0,0 +1,110 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "trading/vol_surface.h"
+
+namespace {
+
+using thales::SmileQuote;
+using thales::SurfaceInterpolation;
+using thales::SviParameters;
+using thales::VolSurface;
+
+constexpr int kExpiries = 12;
+constexpr int kStrikesPerExpiry = 41;
+constexpr double kSpot = 100.0;
+constexpr double kRate = 0.03;
+
+double expiry_of(int i) { return (i + 1) / 12.0; }
+
+std::vector<SmileQuote> smile(double expiry, double shift) {
+    SviParameters svi = {0.01 * expiry + shift, 0.1, -0.4, 0.02, 0.2};
+    std::vector<SmileQuote> quotes;
+    for (int i = 0; i < kStrikesPerExpiry; ++i) {
+        double k = -0.5 + i * (1.0 / (kStrikesPerExpiry - 1));
+        double vol = std::sqrt(svi.total_variance(k) / expiry);
+        quotes.push_back({kSpot * std::exp(k + kRate * expiry), vol, 1.0});
+    }
+    return quotes;
+}
+
+VolSurface make_surface(SurfaceInterpolation interpolation) {
+    VolSurface surface(kSpot, kRate, interpolation);
+    for (int i = 0; i < kExpiries; ++i) {
+        surface.set_quotes(expiry_of(i), smile(expiry_of(i), 0.0));
+    }
+    surface.refresh();
+    return surface;
+}
+
+void BM_VolSurfaceLookup(benchmark::State& state) {
+    auto interpolation = static_cast<SurfaceInterpolation>(state.range(0));
+    VolSurface surface = make_surface(interpolation);
+    constexpr std::size_t kPoints = 4096;
+    std::vector<double> strikes(kPoints);
+    std::vector<double> expiries(kPoints);
+    std::vector<double> vols(kPoints);
+    for (std::size_t i = 0; i < kPoints; ++i) {
+        strikes[i] = 70.0 + 60.0 * ((i * 37) % kPoints) / kPoints;
+        expiries[i] = 0.05 + 1.0 * ((i * 91) % kPoints) / kPoints;
+    }
+    for (auto _ : state) {
+        surface.volatilities(strikes.data(), expiries.data(), vols.data(),
+                             kPoints);
+        benchmark::DoNotOptimize(vols.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kPoints);
+}
+BENCHMARK(BM_VolSurfaceLookup)
+    ->Arg(static_cast<int>(SurfaceInterpolation::BILINEAR))
+    ->Arg(static_cast<int>(SurfaceInterpolation::CUBIC));
+
+/** @brief One expiry's quotes change and only that slice is refitted. */
+void BM_VolSurfaceSliceRefit(benchmark::State& state) {
+    VolSurface surface = make_surface(SurfaceInterpolation::CUBIC);
+    std::vector<SmileQuote> quotes[2] = {smile(expiry_of(5), 0.001),
+                                         smile(expiry_of(5), 0.0)};
+    int flip = 0;
+    for (auto _ : state) {
+        surface.set_quotes(expiry_of(5), quotes[flip ^= 1]);
+        benchmark::DoNotOptimize(surface.refresh());
+    }
+}
+BENCHMARK(BM_VolSurfaceSliceRefit);
+
+/** @brief Baseline: rebuild every slice on each change. */
+void BM_VolSurfaceFullRebuild(benchmark::State& state) {
+    for (auto _ : state) {
+        VolSurface surface = make_surface(SurfaceInterpolation::CUBIC);
+        benchmark::DoNotOptimize(surface.volatility(kSpot, 0.5));
+    }
+}
+BENCHMARK(BM_VolSurfaceFullRebuild);
+
+}  // namespace
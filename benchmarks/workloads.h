@@ -0,0 +1,150 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "trading/portfolio.h"
+#include "trading/position.h"
+#include "trading/symbol_table.h"
+
+/**
+ * @brief Randomized, fixed-seed inputs shaped like a real options book.
+ *
+ * Spots are log-normal across underlyings, strikes sit on listed strike
+ * grids around each spot, expiries are weeklies then monthlies out to two
+ * years, and positions crowd into the most popular names the way real
+ * books do. The same seed always gives the same workload, so runs compare.
+ */
+namespace workloads {
+
+constexpr std::int32_t TODAY = 19888;  // 2024-06-15
+constexpr std::uint64_t SEED = 20240615;
+
+/** @brief Underlyings with their base market. */
+struct Universe {
+    std::vector<thales::SymbolId> ids;
+    thales::MarketData market;
+};
+
+/** @brief Listed strike spacing for an underlying price. */
+inline double strike_step(double spot) {
+    return spot < 25.0 ? 1.0 : spot < 200.0 ? 2.5 : spot < 1000.0 ? 5.0 : 10.0;
+}
+
+/**
+ * @brief Creates underlyings named PREFIX0, PREFIX1, ... and their market.
+ *
+ * Spots run from a few dollars to a few thousand with a median near 100;
+ * volatilities from 15% to 90%, higher for cheaper names.
+ */
+inline Universe make_universe(std::size_t count,
+                              const std::string& prefix = "WORK",
+                              std::uint64_t seed = SEED) {
+    std::mt19937_64 gen(seed);
+    std::lognormal_distribution<double> spot(std::log(100.0), 1.0);
+    std::normal_distribution<double> noise(0.0, 0.05);
+
+    Universe universe;
+    for (std::size_t u = 0; u < count; ++u) {
+        universe.ids.push_back(
+            thales::SymbolTable::intern(prefix + std::to_string(u)));
+    }
+    thales::MarketData& market = universe.market;
+    market.spot.assign(thales::SymbolTable::size(), 100.0);
+    market.volatility.assign(market.spot.size(), 0.3);
+    market.rate = 0.04;
+    market.valuation_date = TODAY;
+    for (thales::SymbolId id : universe.ids) {
+        double s = std::clamp(spot(gen), 3.0, 4000.0);
+        market.spot[id] = s;
+        market.volatility[id] =
+            std::clamp(0.55 - 0.06 * std::log(s) + noise(gen), 0.15, 0.9);
+    }
+    return universe;
+}
+
+/** @brief Days to a random listed expiry: weeklies, then monthlies. */
+inline std::int32_t random_expiry_days(std::mt19937_64& gen) {
+    std::uniform_int_distribution<int> weekly(0, 1);
+    if (weekly(gen)) {
+        return 7 * std::uniform_int_distribution<int>(0, 7)(gen) + 3;
+    }
+    return 30 * std::uniform_int_distribution<int>(1, 24)(gen) + 17;
+}
+
+/** @brief A random listed strike around a spot for an expiry. */
+inline double random_strike(std::mt19937_64& gen, double spot,
+                            double volatility, std::int32_t days) {
+    // Listed strikes spread with the expected move to expiry
+    double sd = volatility * std::sqrt(days / 365.0);
+    double moneyness =
+        std::exp(std::normal_distribution<double>(0.0, 0.6 * sd)(gen));
+    double step = strike_step(spot);
+    return std::max(step, std::round(spot * moneyness / step) * step);
+}
+
+/**
+ * @brief Book of random positions over a universe.
+ *
+ * Underlyings are drawn Zipf-like, so a few names hold most positions;
+ * quantities are signed and heavy-tailed.
+ */
+inline thales::Portfolio make_book(const Universe& universe,
+                                   std::size_t positions,
+                                   std::uint64_t seed = SEED) {
+    std::mt19937_64 gen(seed);
+    std::vector<double> weights;
+    for (std::size_t u = 0; u < universe.ids.size(); ++u) {
+        weights.push_back(1.0 / static_cast<double>(u + 1));
+    }
+    std::discrete_distribution<std::size_t> name(weights.begin(),
+                                                 weights.end());
+    std::geometric_distribution<int> size(0.25);
+    std::uniform_int_distribution<int> coin(0, 1);
+    std::uniform_real_distribution<double> premium(0.05, 20.0);
+
+    thales::Portfolio book(1e6);
+    book.reserve(positions);
+    for (std::size_t i = 0; i < positions; ++i) {
+        thales::SymbolId id = universe.ids[name(gen)];
+        std::int32_t days = random_expiry_days(gen);
+        double strike = random_strike(gen, universe.market.spot[id],
+                                      universe.market.volatility[id], days);
+        int quantity = (1 + size(gen)) * (coin(gen) ? 1 : -1);
+        book.add_position(thales::Position(id, coin(gen) ? PUT : CALL, strike,
+                                           TODAY + days, quantity,
+                                           premium(gen)));
+    }
+    return book;
+}
+
+}  // namespace workloads
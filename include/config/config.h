@@ -25,10 +25,50 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
 
 namespace thales {
+
+class ConfigStore;
+
 class Config {
    public:
+    /**
+     * @brief Gets the Polygon API key.
+     *
+     * Reads API_KEY from polygon_credentials.cfg in the store() directory.
+     *
+     * @throws std::runtime_error If the directory cannot be read or the key
+     *         is not set.
+     */
     static std::string get_api_key();
+
+    /**
+     * @brief Gets the process-wide configuration, reading it on first use.
+     *
+     * The directory is $THALES_CONFIG_DIR if set, else ../config, as the
+     * executables run from build/.
+     *
+     * A malformed file does not stop the others from loading; see
+     * ConfigStore::ConfigStore().
+     *
+     * @throws std::runtime_error If the directory cannot be read.
+     */
+    static ConfigStore& store();
+
+    /**
+     * @brief Reads a KEY=VALUE configuration file.
+     *
+     * Blank lines and lines starting with '#' are skipped; whitespace
+     * around keys and values is trimmed.
+     *
+     * @param path The file to read.
+     * @return The values, by key.
+     * @throws std::runtime_error If the file cannot be opened.
+     * @throws std::invalid_argument If a line is not KEY=VALUE or a key
+     *         repeats.
+     */
+    static std::unordered_map<std::string, std::string> load(
+        const std::string& path);
 };
 }  // namespace thales
@@ -0,0 +1,303 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace thales {
+
+/**
+ * @class ConfigValue
+ * @brief One configuration value, parsed once when it is read.
+ *
+ * Number and flag interpretations are worked out up front, so typed reads
+ * are a branch rather than a parse.
+ */
+class ConfigValue {
+   public:
+    explicit ConfigValue(std::string_view text);
+
+    /** @brief Gets the value as written. */
+    const std::string& text() const { return value; }
+
+    /** @brief Checks whether the value is a finite number. */
+    bool is_number() const { return numeric; }
+
+    /** @brief Checks whether the value is one of true/false, yes/no,
+     *         on/off or 1/0, in any case. */
+    bool is_bool() const { return flag >= 0; }
+
+    /**
+     * @brief Gets the value as a number.
+     * @throws std::invalid_argument If the value is not a number.
+     */
+    double as_double() const;
+
+    /**
+     * @brief Gets the value as an integer.
+     * @throws std::invalid_argument If the value is not a whole number
+     *         that fits.
+     */
+    std::int64_t as_int() const;
+
+    /**
+     * @brief Gets the value as a flag.
+     * @throws std::invalid_argument If the value is not a flag.
+     */
+    bool as_bool() const;
+
+   private:
+    std::string value;
+    double number = 0.0;
+    bool numeric = false;
+    signed char flag = -1; /**< 0 or 1, or -1 for not a flag */
+};
+
+/**
+ * @class ConfigSnapshot
+ * @brief Immutable view of every configuration file in a directory.
+ *
+ * Each KEY=VALUE file NAME.cfg becomes section NAME, so MAX_POSITION in
+ * risk_management.cfg is ("risk_management", "MAX_POSITION"). Lookups are
+ * two hash probes on string views and never allocate.
+ */
+class ConfigSnapshot {
+   public:
+    /** Values of one section, by key. */
+    using Section = std::unordered_map<std::string_view, ConfigValue>;
+
+    /** @brief Creates an empty snapshot. */
+    ConfigSnapshot() = default;
+
+    // Keys are views of strings owned by the snapshot
+    ConfigSnapshot(ConfigSnapshot&&) = default;
+    ConfigSnapshot& operator=(ConfigSnapshot&&) = default;
+    ConfigSnapshot(const ConfigSnapshot&) = delete;
+    ConfigSnapshot& operator=(const ConfigSnapshot&) = delete;
+
+    /**
+     * @brief Reads every .cfg file of a directory.
+     * @param directory The directory.
+     * @return The snapshot.
+     * @throws std::runtime_error If the directory or a file cannot be read.
+     * @throws std::invalid_argument If a file is malformed; see
+     *         Config::load().
+     */
+    static ConfigSnapshot read_directory(const std::string& directory);
+
+    /**
+     * @brief Reads every .cfg file of a directory that parses.
+     * @param directory The directory.
+     * @param skipped Receives why each file left out could not be read,
+     *        separated by "; ".
+     * @return The snapshot of the other files.
+     * @throws std::runtime_error If the directory cannot be read.
+     */
+    static ConfigSnapshot read_directory(const std::string& directory,
+                                         std::string& skipped);
+
+    /**
+     * @brief Sets a value, replacing any previous one.
+     *
+     * For building snapshots; a published snapshot is never modified.
+     */
+    void set(std::string_view section, std::string_view key,
+             std::string_view value);
+
+    /**
+     * @brief Gets the values of a section.
+     * @return The section, or null if there is none.
+     */
+    const Section* section(std::string_view name) const;
+
+    /**
+     * @brief Finds a value.
+     * @return The value, or null if it is not set.
+     */
+    const ConfigValue* find(std::string_view section,
+                            std::string_view key) const;
+
+    /**
+     * @brief Gets a value that must be set.
+     * @throws std::invalid_argument If the value is not set.
+     */
+    const ConfigValue& get(std::string_view section,
+                           std::string_view key) const;
+
+    /**
+     * @brief Gets a number, or a fallback when it is not set.
+     * @throws std::invalid_argument If the value is set but not a number.
+     */
+    double get_double(std::string_view section, std::string_view key,
+                      double fallback) const;
+
+    /**
+     * @brief Gets an integer, or a fallback when it is not set.
+     * @throws std::invalid_argument If the value is set but not an
+     *         integer.
+     */
+    std::int64_t get_int(std::string_view section, std::string_view key,
+                         std::int64_t fallback) const;
+
+    /**
+     * @brief Gets a flag, or a fallback when it is not set.
+     * @throws std::invalid_argument If the value is set but not a flag.
+     */
+    bool get_bool(std::string_view section, std::string_view key,
+                  bool fallback) const;
+
+    /** @brief Gets the number of values in every section. */
+    std::size_t size() const;
+
+    /**
+     * @brief Calls fn(section, key, value) for every value, in no
+     *        particular order.
+     */
+    template <typename Fn>
+    void for_each(Fn fn) const {
+        for (const auto& [name, values] : sections) {
+            for (const auto& [key, value] : values) {
+                fn(name, key, value);
+            }
+        }
+    }
+
+    /**
+     * @brief Copies the snapshot, e.g. to keep it past the store that
+     *        published it.
+     */
+    ConfigSnapshot clone() const;
+
+   private:
+    /** @brief Reads the directory; throws on a bad file if skipped is null. */
+    static ConfigSnapshot read_files(const std::string& directory,
+                                     std::string* skipped);
+
+    std::string_view own(std::string_view text);
+
+    std::unordered_map<std::string_view, Section> sections;
+    std::deque<std::string> names; /**< Stable storage for the keys */
+};
+
+/**
+ * @class ConfigStore
+ * @brief A configuration directory, read once and reloaded on change.
+ *
+ * current() is a single atomic load, so hot paths can read the
+ * configuration on every call without a lock or a file system access.
+ * reload() and the watch() thread build a new snapshot off to the side and
+ * publish it with one pointer swap; a file that fails to parse leaves the
+ * previous snapshot in place.
+ *
+ * Every snapshot published stays alive until the store is destroyed, so a
+ * reference from current() never dangles. Reloads follow edits to a few
+ * small files, so what is kept is small.
+ */
+class ConfigStore {
+   public:
+    /**
+     * @brief Reads a configuration directory.
+     *
+     * A file that cannot be read or parsed is left out of the first
+     * snapshot, and last_error() says why; the next successful reload()
+     * brings it in.
+     *
+     * @param directory The directory.
+     * @throws std::runtime_error If the directory cannot be read.
+     */
+    explicit ConfigStore(std::string directory);
+
+    ~ConfigStore();
+
+    ConfigStore(const ConfigStore&) = delete;
+    ConfigStore& operator=(const ConfigStore&) = delete;
+
+    /** @brief Gets the current snapshot; safe from any thread. */
+    const ConfigSnapshot& current() const {
+        return *snapshot.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Gets the number of snapshots published, starting at 1.
+     *
+     * Callers caching values derived from the configuration compare this
+     * to know when to rebuild them.
+     */
+    std::uint64_t version() const {
+        return versions.load(std::memory_order_acquire);
+    }
+
+    const std::string& get_directory() const { return directory; }
+
+    /**
+     * @brief Rereads the directory and publishes the result.
+     * @return False, keeping the current snapshot, if it could not be read;
+     *         last_error() says why.
+     */
+    bool reload();
+
+    /**
+     * @brief Gets why the last failed reload failed, or which files the
+     *        first read left out.
+     */
+    std::string last_error() const;
+
+    /**
+     * @brief Starts reloading whenever a .cfg file in the directory is
+     *        written, created, moved or deleted; does nothing if already
+     *        watching.
+     * @throws std::runtime_error If the directory cannot be watched.
+     */
+    void watch();
+
+    /** @brief Stops the watch() thread. */
+    void stop();
+
+   private:
+    void run();
+
+    std::string directory;
+    std::atomic<const ConfigSnapshot*> snapshot{nullptr};
+    std::atomic<std::uint64_t> versions{0};
+
+    mutable std::mutex reload_mutex; /**< Writers only */
+    std::vector<std::unique_ptr<const ConfigSnapshot>> published;
+    std::string error;
+
+    std::thread watcher;
+    int notify_fd = -1;
+    int wake_fd = -1;
+};
+
+}  // namespace thales
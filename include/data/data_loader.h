@@ -0,0 +1,178 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "trading/symbol_table.h"
+#include "utils/ring_buffer.h"
+#include "utils/thread_affinity.h"
+
+namespace thales {
+
+/**
+ * @brief Top-of-book quote for one instrument.
+ */
+struct Quote {
+    std::int64_t timestamp_ns; /**< Exchange timestamp (ns since epoch) */
+    double bid_price;          /**< Best bid */
+    double ask_price;          /**< Best ask */
+    std::uint32_t bid_size;    /**< Size at the best bid */
+    std::uint32_t ask_size;    /**< Size at the best ask */
+    SymbolId symbol;           /**< Interned instrument symbol */
+};
+
+static_assert(std::is_trivially_copyable<Quote>::value,
+              "Quote must stay trivially copyable");
+
+/**
+ * @brief Queue carrying quotes from feed threads to the pricing threads.
+ */
+using QuoteQueue = MpscRingBuffer<Quote>;
+
+/**
+ * @class PolygonFeedParser
+ * @brief Parses Polygon WebSocket messages into Quote records.
+ *
+ * A message is a JSON array of event objects. Quote events ("ev":"Q") are
+ * decoded in a single pass over the text without building a document;
+ * status events update status(); every other event is skipped.
+ */
+class PolygonFeedParser {
+   public:
+    /**
+     * @brief Parses one complete message.
+     * @param message The message text.
+     * @param quotes Receives the decoded quotes (appended).
+     * @return The number of quotes appended.
+     * @throws std::invalid_argument If the message is not valid JSON.
+     */
+    std::size_t parse(std::string_view message, std::vector<Quote>& quotes);
+
+    /**
+     * @brief Gets the most recent status reported by the server.
+     * @return The status, e.g. "connected" or "auth_success".
+     */
+    const std::string& status() const { return last_status; }
+
+   private:
+    std::string last_status;
+};
+
+/**
+ * @brief Connection settings of a MarketDataStream.
+ */
+struct MarketDataStreamSettings {
+    /** Feed cluster */
+    std::string url = "wss://socket.polygon.io/options";
+    /** Polygon API key */
+    std::string api_key;
+    /** Channels to subscribe to, e.g. "Q.O:SPY241220C00500000" */
+    std::vector<std::string> subscriptions;
+    /** Upper bound of the reconnect backoff */
+    int max_reconnect_delay_ms = 30000;
+    /**
+     * CPUs and idle strategy of the streaming thread. SLEEP blocks in
+     * poll(2) between messages; BUSY_POLL keeps reading the socket.
+     */
+    ThreadPlacement placement{{}, {WaitMode::SLEEP}};
+};
+
+/**
+ * @class MarketDataStream
+ * @brief Streams quotes from Polygon's WebSocket feed into a QuoteQueue.
+ *
+ * A background thread connects, authenticates, subscribes and then decodes
+ * every message straight into the queue, reconnecting with exponential
+ * backoff when the connection drops. The thread never blocks on the queue:
+ * quotes that do not fit are counted as dropped.
+ */
+class MarketDataStream {
+   public:
+    /**
+     * @brief Creates a stopped stream.
+     * @param settings Connection settings.
+     * @param queue Destination of decoded quotes; must outlive the stream.
+     */
+    MarketDataStream(MarketDataStreamSettings settings, QuoteQueue& queue);
+
+    /**
+     * @brief Stops the stream.
+     */
+    ~MarketDataStream();
+
+    MarketDataStream(const MarketDataStream&) = delete;
+    MarketDataStream& operator=(const MarketDataStream&) = delete;
+
+    /**
+     * @brief Starts the streaming thread; does nothing if already running.
+     */
+    void start();
+
+    /**
+     * @brief Closes the connection and joins the streaming thread.
+     */
+    void stop();
+
+    /**
+     * @brief Gets the number of quotes pushed into the queue.
+     */
+    std::uint64_t quotes_received() const { return received.load(); }
+
+    /**
+     * @brief Gets the number of quotes lost because the queue was full.
+     */
+    std::uint64_t quotes_dropped() const { return dropped.load(); }
+
+    /**
+     * @brief Gets the most recent connection or protocol error.
+     * @return The error message, empty if none occurred.
+     */
+    std::string last_error() const;
+
+   private:
+    void run();
+    bool stream_once();
+    void set_error(std::string error);
+
+    MarketDataStreamSettings settings;
+    QuoteQueue& queue;
+    std::thread thread;
+    std::atomic<bool> stopping{false};
+    std::atomic<std::uint64_t> received{0};
+    std::atomic<std::uint64_t> dropped{0};
+    mutable std::mutex error_mutex;
+    std::string error; /**< Guarded by error_mutex */
+};
+
+}  // namespace thales
@@ -0,0 +1,211 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "data/polygon_rest.h"
+#include "utils/http_client.h"
+#include "utils/response_cache.h"
+#include "utils/token_bucket.h"
+
+namespace thales {
+
+class ConfigSnapshot;
+class PolygonImporter;
+
+/**
+ * @brief Settings of a HistoryDownloader.
+ */
+struct HistoryDownloadSettings {
+    /** REST endpoint, without a trailing slash */
+    std::string base_url = "https://api.polygon.io";
+    /** Polygon API key, appended to every request */
+    std::string api_key;
+    /** Sustained request rate (Polygon's free tier allows 5 a minute) */
+    double requests_per_second = 5.0 / 60.0;
+    /** Requests that may be sent back to back before the rate applies */
+    double request_burst = 5.0;
+    /** Requests outstanding at once */
+    std::size_t max_in_flight = 8;
+    /** Tries per page before it is given up on */
+    int max_attempts = 4;
+    /** Wait before the first retry; doubled on every further one */
+    std::chrono::milliseconds retry_delay{1000};
+    /** Response cache directory; empty disables the cache */
+    std::string cache_directory;
+
+    /**
+     * @brief Configuration section the settings are read from.
+     */
+    static constexpr const char* CONFIG_SECTION = "data_sources";
+
+    /**
+     * @brief Reads settings from the CONFIG_SECTION of a configuration
+     *        snapshot.
+     *
+     * Recognised keys are HISTORY_BASE_URL, HISTORY_REQUESTS_PER_MINUTE,
+     * HISTORY_REQUEST_BURST, HISTORY_MAX_IN_FLIGHT, HISTORY_MAX_ATTEMPTS,
+     * HISTORY_RETRY_DELAY_MS and HISTORY_CACHE_DIR; missing keys keep their
+     * defaults. The API key is taken from polygon_credentials.API_KEY.
+     *
+     * @param config The configuration.
+     * @return The settings.
+     * @throws std::invalid_argument If a value is out of range.
+     */
+    static HistoryDownloadSettings load(const ConfigSnapshot& config);
+};
+
+/**
+ * @brief One planned request: a ticker over a range of days.
+ */
+struct HistoryRequest {
+    std::string ticker;     /**< Ticker requested */
+    std::int32_t first_day; /**< First day covered (days since epoch) */
+    std::int32_t last_day;  /**< Last day covered, inclusive */
+    std::string path;       /**< Path and query of the first page */
+};
+
+/**
+ * @brief Counters describing one download.
+ */
+struct HistoryDownloadStats {
+    std::size_t requests = 0;      /**< Requests planned */
+    std::size_t pages = 0;         /**< Pages delivered, cached or fetched */
+    std::size_t cache_hits = 0;    /**< Pages read from the cache */
+    std::size_t fetched = 0;       /**< Pages fetched over the network */
+    std::size_t retries = 0;       /**< Failed attempts that were retried */
+    std::size_t failed = 0;        /**< Pages given up on */
+    std::size_t bytes_fetched = 0; /**< Body bytes received */
+};
+
+/**
+ * @class HistoryDownloader
+ * @brief Backfills Polygon history concurrently within its rate limit.
+ *
+ * A download takes a plan of requests and keeps up to max_in_flight of
+ * them outstanding on an HttpClient, which multiplexes them over a few
+ * kept-alive connections. Every network request first takes a token from
+ * a TokenBucket, so the plan runs as fast as the account allows and no
+ * faster. Pagination cursors in "next_url" are followed until the last
+ * page. Rate limit responses (429) drain the bucket and are retried, as
+ * are server and transport errors, with exponential backoff.
+ *
+ * With a cache directory set, every page whose range has closed (it ends
+ * before the current UTC day) is kept in a ResponseCache keyed by its path
+ * and query, without the API key. Repeated backfills, and restarts midway
+ * through one, are then served from local disk; only pages covering the
+ * current day, which may still change, are always fetched.
+ *
+ * Pages are handed to the caller on the thread that called download(), in
+ * the order they complete. The pages of one request arrive in order.
+ */
+class HistoryDownloader {
+   public:
+    /**
+     * @brief Receives one page of a request.
+     */
+    using PageHandler =
+        std::function<void(const HistoryRequest& request,
+                           std::string_view body)>;
+
+    /**
+     * @brief Creates a downloader.
+     * @param http The client to fetch with; must outlive the downloader.
+     * @param settings Endpoint, limits and cache.
+     * @throws std::invalid_argument If a limit is out of range.
+     * @throws std::runtime_error If the cache directory cannot be created.
+     */
+    HistoryDownloader(HttpClient& http, HistoryDownloadSettings settings);
+
+    /**
+     * @brief Splits tickers and a date range into aggregates requests.
+     *
+     * Ranges are cut into spans of days_per_request days so that each
+     * response stays well within Polygon's 50000 bar limit, e.g. 30 days of
+     * minute bars.
+     *
+     * @param tickers Tickers to request.
+     * @param first_day First day (days since epoch).
+     * @param last_day Last day, inclusive.
+     * @param multiplier Size of a bar in timespans.
+     * @param timespan "minute", "hour", "day" and so on.
+     * @param days_per_request Days covered by one request.
+     * @return One request per ticker and span, ticker by ticker.
+     * @throws std::invalid_argument If the range is empty or a size is not
+     *         positive.
+     */
+    static std::vector<HistoryRequest> plan_aggregates(
+        const std::vector<std::string>& tickers, std::int32_t first_day,
+        std::int32_t last_day, int multiplier, std::string_view timespan,
+        std::int32_t days_per_request);
+
+    /**
+     * @brief Downloads every page of the planned requests.
+     *
+     * A page is only cached once the handler has accepted it. A handler
+     * that throws marks the page as failed, and pages after it in the same
+     * request are not fetched.
+     *
+     * @param requests The plan.
+     * @param handler Called once per page.
+     * @return What was done.
+     */
+    HistoryDownloadStats download(const std::vector<HistoryRequest>& requests,
+                                  const PageHandler& handler);
+
+    /**
+     * @brief Downloads aggregates requests into a tick store.
+     * @param requests The plan, e.g. from plan_aggregates().
+     * @param importer Importer writing to the destination store.
+     * @return What was done.
+     */
+    HistoryDownloadStats import_aggregates(
+        const std::vector<HistoryRequest>& requests,
+        PolygonImporter& importer);
+
+    /** @brief Gets the settings. */
+    const HistoryDownloadSettings& get_settings() const { return settings; }
+
+   private:
+    struct Page;
+
+    std::string url(const std::string& path) const;
+
+    HttpClient& http;
+    HistoryDownloadSettings settings;
+    TokenBucket bucket;
+    std::unique_ptr<ResponseCache> cache;
+    PolygonRestParser parser;
+};
+
+}  // namespace thales
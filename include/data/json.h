@@ -0,0 +1,169 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+#include "trading/black_scholes.h"
+
+namespace thales {
+
+/**
+ * @class JsonCursor
+ * @brief Forward-only, on-demand reader over an indexed JSON document.
+ *
+ * Values are decoded only when asked for, straight from the source text:
+ * strings are returned as views (escape sequences are left as-is) and
+ * skipped objects and arrays cost one step per structural character rather
+ * than one per byte. Every read must consume exactly one value, with the
+ * get_*() functions, skip(), for_each_field() or for_each_element().
+ *
+ * The cursor refers to the text and to the parser's index, so both must
+ * outlive it and the parser must not be reused meanwhile.
+ */
+class JsonCursor {
+   public:
+    JsonCursor(std::string_view text, const std::uint32_t* index,
+               std::size_t count)
+        : text(text), index(index), count(count) {}
+
+    /**
+     * @brief Calls fn(key) for every field of the next value, an object.
+     *
+     * fn must consume the field's value.
+     *
+     * @throws std::invalid_argument If the value is not a valid object.
+     */
+    template <typename Fn>
+    void for_each_field(Fn&& fn) {
+        if (!begin_object()) {
+            return;
+        }
+        do {
+            fn(key());
+        } while (next());
+    }
+
+    /**
+     * @brief Calls fn() for every element of the next value, an array.
+     *
+     * fn must consume the element.
+     *
+     * @throws std::invalid_argument If the value is not a valid array.
+     */
+    template <typename Fn>
+    void for_each_element(Fn&& fn) {
+        if (!begin_array()) {
+            return;
+        }
+        do {
+            fn();
+        } while (next());
+    }
+
+    /**
+     * @brief Gets the first character of the next value.
+     * @return '{', '[', '"' or the first character of a number or literal.
+     */
+    char peek();
+
+    /**
+     * @brief Consumes a null if it is the next value.
+     * @return True if a null was consumed.
+     */
+    bool is_null();
+
+    /** @brief Reads a number. */
+    double get_number();
+
+    /** @brief Reads a string, without unescaping it. */
+    std::string_view get_string();
+
+    /** @brief Skips the next value, whatever its type. */
+    void skip();
+
+    /**
+     * @brief Checks that the whole document has been consumed.
+     * @throws std::invalid_argument If anything but whitespace is left.
+     */
+    void expect_end();
+
+   private:
+    bool begin_object();
+    bool begin_array();
+    std::string_view key();
+    bool next();
+    std::size_t value_start();
+    std::size_t structural(std::size_t i, char expected) const;
+    std::size_t scalar_end() const;
+
+    std::string_view text;
+    const std::uint32_t* index;
+    std::size_t count;
+    std::size_t next_index = 0; /**< Next structural to consume */
+    std::size_t position = 0;   /**< Where the next value may start */
+};
+
+/**
+ * @class JsonParser
+ * @brief Builds the structural index that a JsonCursor walks.
+ *
+ * The first pass classifies 64 bytes at a time with SIMD compares, then
+ * resolves escapes and string boundaries with carry-free bit arithmetic,
+ * so structural characters inside strings are never indexed. The index
+ * buffer is kept between documents, so a long-lived parser does not
+ * allocate once it has seen its largest input.
+ */
+class JsonParser {
+   public:
+    /**
+     * @brief Creates a parser.
+     * @param backend AUTO, SCALAR or AVX2 (where supported).
+     * @throws std::invalid_argument If the backend is not supported.
+     */
+    explicit JsonParser(SimdBackend backend = SimdBackend::AUTO);
+
+    /**
+     * @brief Indexes a document.
+     * @param text The document; it is read in place and not copied.
+     * @return A cursor positioned on the root value.
+     * @throws std::invalid_argument If a string is unterminated or the
+     *         document exceeds 4 GiB.
+     */
+    JsonCursor parse(std::string_view text);
+
+   private:
+    using IndexFunction = std::size_t (*)(const char*, std::size_t,
+                                          std::uint32_t*);
+
+    IndexFunction build_index;
+    std::unique_ptr<std::uint32_t[]> index;
+    std::size_t capacity = 0;
+};
+
+}  // namespace thales
@@ -0,0 +1,95 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "trading/black_scholes.h"
+#include "trading/symbol_table.h"
+
+namespace thales {
+
+/**
+ * @brief OHLCV bars stored column-wise, one entry per bar in every column.
+ */
+struct BarColumns {
+    std::vector<SymbolId> symbol;          /**< Instrument */
+    std::vector<std::int64_t> timestamp_ns; /**< Bar start (ns since epoch) */
+    std::vector<double> open;              /**< Opening price */
+    std::vector<double> high;              /**< Highest price */
+    std::vector<double> low;               /**< Lowest price */
+    std::vector<double> close;             /**< Closing price */
+    std::vector<double> volume;            /**< Traded volume */
+    std::vector<double> vwap;              /**< Volume-weighted price */
+    std::vector<std::uint32_t> trades;     /**< Number of trades */
+
+    std::size_t size() const { return timestamp_ns.size(); }
+
+    /** @brief Removes every bar, keeping the allocated capacity. */
+    void clear();
+
+    /** @brief Reserves room for a number of bars in every column. */
+    void reserve(std::size_t capacity);
+
+    /** @brief Appends a bar with every field zeroed; returns its index. */
+    std::size_t append();
+};
+
+/**
+ * @brief Option chain snapshots stored column-wise.
+ *
+ * Fields missing from a snapshot are left as NaN (prices, volatility) or
+ * zero (sizes, open interest, timestamp).
+ */
+struct OptionChainColumns {
+    std::vector<SymbolId> contract;         /**< Option contract ticker */
+    std::vector<SymbolId> underlying;       /**< Underlying ticker */
+    std::vector<OptionType> type;           /**< Call or put */
+    std::vector<double> strike;             /**< Strike price */
+    std::vector<std::int32_t> expiration;   /**< Expiry (days since epoch) */
+    std::vector<double> bid;                /**< Best bid */
+    std::vector<double> ask;                /**< Best ask */
+    std::vector<std::uint32_t> bid_size;    /**< Size at the best bid */
+    std::vector<std::uint32_t> ask_size;    /**< Size at the best ask */
+    std::vector<std::int64_t> timestamp_ns; /**< Quote time (ns since epoch) */
+    std::vector<double> implied_volatility; /**< Vendor implied volatility */
+    std::vector<double> open_interest;      /**< Open contracts */
+    std::vector<double> underlying_price;   /**< Underlying spot */
+
+    std::size_t size() const { return contract.size(); }
+
+    /** @brief Removes every entry, keeping the allocated capacity. */
+    void clear();
+
+    /** @brief Reserves room for a number of entries in every column. */
+    void reserve(std::size_t capacity);
+
+    /** @brief Appends an entry with missing-value defaults. */
+    std::size_t append();
+};
+
+}  // namespace thales
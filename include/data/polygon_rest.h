@@ -0,0 +1,95 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+#include "data/json.h"
+#include "data/market_data.h"
+
+namespace thales {
+
+/**
+ * @class PolygonRestParser
+ * @brief Decodes Polygon REST responses straight into columnar stores.
+ *
+ * Responses are read in place, e.g. from HttpClient's receive buffer:
+ * numbers are converted as they are reached and tickers are interned from
+ * views into the text, so no document tree or per-field string is built.
+ * Unknown fields are skipped using the structural index alone.
+ */
+class PolygonRestParser {
+   public:
+    /**
+     * @brief Creates a parser.
+     * @param backend JSON indexing backend (see JsonParser).
+     */
+    explicit PolygonRestParser(SimdBackend backend = SimdBackend::AUTO)
+        : json(backend) {}
+
+    /**
+     * @brief Decodes an aggregates response (/v2/aggs/...).
+     *
+     * Grouped-daily responses, which name the ticker of every bar in "T",
+     * are supported as well.
+     *
+     * @param body The response body.
+     * @param bars Receives the bars (appended).
+     * @return The number of bars appended.
+     * @throws std::invalid_argument If the body is malformed.
+     * @throws std::runtime_error If Polygon reports an error status.
+     */
+    std::size_t parse_aggregates(std::string_view body, BarColumns& bars);
+
+    /**
+     * @brief Decodes an option chain snapshot (/v3/snapshot/options/...).
+     * @param body The response body.
+     * @param chain Receives one entry per contract (appended).
+     * @return The number of contracts appended.
+     * @throws std::invalid_argument If the body is malformed.
+     * @throws std::runtime_error If Polygon reports an error status.
+     */
+    std::size_t parse_option_chain(std::string_view body,
+                                   OptionChainColumns& chain);
+
+    /**
+     * @brief Finds the cursor of the next page of a paginated response.
+     *
+     * Only the top level is read; large result arrays are skipped over
+     * using the structural index.
+     *
+     * @param body The response body.
+     * @return The absolute URL of the next page, or an empty view on the
+     *         last page. It points into body.
+     * @throws std::invalid_argument If the body is malformed.
+     */
+    std::string_view next_url(std::string_view body);
+
+   private:
+    JsonParser json;
+};
+
+}  // namespace thales
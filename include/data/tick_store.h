@@ -0,0 +1,287 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "data/market_data.h"
+#include "data/polygon_rest.h"
+#include "utils/mapped_file.h"
+
+namespace thales {
+
+/**
+ * @brief Maximum number of columns in a tick store file.
+ */
+constexpr std::size_t TICK_FILE_MAX_COLUMNS = 16;
+
+/**
+ * @brief Maximum length of the symbol recorded in a tick store file.
+ */
+constexpr std::size_t TICK_FILE_SYMBOL_LENGTH = 31;
+
+/**
+ * @brief Alignment of every column in a tick store file, in bytes.
+ */
+constexpr std::size_t TICK_FILE_ALIGNMENT = 64;
+
+/**
+ * @enum TickFileKind
+ * @brief Record layout held by a tick store file.
+ */
+enum class TickFileKind : std::uint32_t {
+    BARS = 1,         /**< OHLCV bars of one symbol */
+    OPTION_QUOTES = 2 /**< Option chain quotes of one underlying */
+};
+
+/**
+ * @brief Header at the start of every tick store file (the file index).
+ *
+ * The header is followed by one array per column, each TICK_FILE_ALIGNMENT
+ * aligned and holding `rows` fixed-width values in native byte order, so
+ * a mapped file is used in place without decoding.
+ */
+struct TickFileHeader {
+    char magic[8];              /**< "THALESTK" */
+    std::uint32_t version;      /**< Format version */
+    TickFileKind kind;          /**< Record layout */
+    std::uint64_t rows;         /**< Values per column */
+    std::int32_t day;           /**< Trading day (days since epoch) */
+    std::uint32_t column_count; /**< Number of columns */
+    char symbol[TICK_FILE_SYMBOL_LENGTH + 1]; /**< NUL-terminated symbol */
+    std::uint64_t column_offset[TICK_FILE_MAX_COLUMNS]; /**< Byte offsets */
+};
+
+/**
+ * @class TickFile
+ * @brief Memory-mapped tick store file, validated against its header.
+ */
+class TickFile {
+   public:
+    /** @brief Gets the number of rows. */
+    std::size_t size() const { return header().rows; }
+
+    /** @brief Gets the trading day (days since epoch). */
+    std::int32_t day() const { return header().day; }
+
+    /** @brief Gets the symbol the file belongs to. */
+    std::string_view symbol() const { return header().symbol; }
+
+   protected:
+    /**
+     * @brief Maps a file and checks it holds the expected layout.
+     * @param path The file.
+     * @param kind Expected record layout.
+     * @param widths Expected width of every column, in bytes.
+     * @throws std::runtime_error If the file is missing or malformed.
+     */
+    TickFile(const std::string& path, TickFileKind kind,
+             const std::vector<std::size_t>& widths);
+
+    const TickFileHeader& header() const {
+        return *reinterpret_cast<const TickFileHeader*>(file.data());
+    }
+
+    template <typename T>
+    const T* column(std::size_t index) const {
+        return reinterpret_cast<const T*>(file.data() +
+                                          header().column_offset[index]);
+    }
+
+   private:
+    MappedFile file;
+};
+
+/**
+ * @class BarFile
+ * @brief One symbol's bars for one day, sorted by timestamp.
+ */
+class BarFile : public TickFile {
+   public:
+    /**
+     * @brief Maps a bar file.
+     * @param path The file.
+     * @throws std::runtime_error If the file is missing or malformed.
+     */
+    explicit BarFile(const std::string& path);
+
+    const std::int64_t* timestamp_ns() const { return column<std::int64_t>(0); }
+    const double* open() const { return column<double>(1); }
+    const double* high() const { return column<double>(2); }
+    const double* low() const { return column<double>(3); }
+    const double* close() const { return column<double>(4); }
+    const double* volume() const { return column<double>(5); }
+    const double* vwap() const { return column<double>(6); }
+    const std::uint32_t* trades() const { return column<std::uint32_t>(7); }
+};
+
+/**
+ * @class OptionQuoteFile
+ * @brief One underlying's option quotes for one day.
+ *
+ * Rows are sorted by timestamp, then expiration, type and strike; a
+ * contract is identified by its (expiration, type, strike) triple.
+ */
+class OptionQuoteFile : public TickFile {
+   public:
+    /**
+     * @brief Maps an option quote file.
+     * @param path The file.
+     * @throws std::runtime_error If the file is missing or malformed.
+     */
+    explicit OptionQuoteFile(const std::string& path);
+
+    const std::int64_t* timestamp_ns() const { return column<std::int64_t>(0); }
+    const std::int32_t* expiration() const { return column<std::int32_t>(1); }
+    const OptionType* type() const { return column<OptionType>(2); }
+    const double* strike() const { return column<double>(3); }
+    const double* bid() const { return column<double>(4); }
+    const double* ask() const { return column<double>(5); }
+    const std::uint32_t* bid_size() const { return column<std::uint32_t>(6); }
+    const std::uint32_t* ask_size() const { return column<std::uint32_t>(7); }
+    const double* implied_volatility() const { return column<double>(8); }
+    const double* open_interest() const { return column<double>(9); }
+    const double* underlying_price() const { return column<double>(10); }
+};
+
+/**
+ * @class TickStore
+ * @brief Directory of per-symbol, per-day columnar files.
+ *
+ * Bars live in `<root>/bars/<symbol>/<YYYY-MM-DD>.tick` and option quotes
+ * in `<root>/options/<underlying>/<YYYY-MM-DD>.tick`. Days are UTC. Files
+ * are replaced atomically, so readers holding a mapping keep a consistent
+ * snapshot while a day is rewritten.
+ */
+class TickStore {
+   public:
+    /**
+     * @brief Opens a store, creating the root directory if needed.
+     * @param root The store directory.
+     * @throws std::runtime_error If the directory cannot be created.
+     */
+    explicit TickStore(std::string root);
+
+    /**
+     * @brief Merges bars into the store.
+     *
+     * Bars are grouped by symbol and day and merged with what is already
+     * stored; a bar with the timestamp of a stored one replaces it.
+     *
+     * @param bars The bars; every symbol must be set.
+     * @return The number of files written.
+     * @throws std::invalid_argument If a symbol is unset or unusable as a
+     * file name.
+     */
+    std::size_t write_bars(const BarColumns& bars) const;
+
+    /**
+     * @brief Merges option quotes into the store.
+     *
+     * Quotes are grouped by underlying and day; entries without a timestamp
+     * are skipped. A quote with the timestamp and contract of a stored one
+     * replaces it.
+     *
+     * @param chain The quotes; every underlying must be set.
+     * @return The number of files written.
+     * @throws std::invalid_argument If an underlying is unset or unusable as
+     * a file name.
+     */
+    std::size_t write_option_quotes(const OptionChainColumns& chain) const;
+
+    /**
+     * @brief Maps one day of bars.
+     * @throws std::runtime_error If the day is not stored.
+     */
+    BarFile read_bars(std::string_view symbol, std::int32_t day) const;
+
+    /**
+     * @brief Maps one day of option quotes.
+     * @throws std::runtime_error If the day is not stored.
+     */
+    OptionQuoteFile read_option_quotes(std::string_view underlying,
+                                       std::int32_t day) const;
+
+    /** @brief Lists the stored days of a symbol's bars, ascending. */
+    std::vector<std::int32_t> bar_days(std::string_view symbol) const;
+
+    /** @brief Lists the stored days of an underlying's quotes, ascending. */
+    std::vector<std::int32_t> option_quote_days(
+        std::string_view underlying) const;
+
+   private:
+    std::string path(std::string_view kind, std::string_view symbol,
+                     std::int32_t day) const;
+    std::vector<std::int32_t> days(std::string_view kind,
+                                   std::string_view symbol) const;
+
+    std::string root;
+};
+
+/**
+ * @class PolygonImporter
+ * @brief Imports Polygon REST responses into a TickStore.
+ */
+class PolygonImporter {
+   public:
+    /**
+     * @brief Creates an importer.
+     * @param store The destination store (must outlive the importer).
+     * @param backend JSON indexing backend (see JsonParser).
+     */
+    explicit PolygonImporter(const TickStore& store,
+                             SimdBackend backend = SimdBackend::AUTO)
+        : store(store), parser(backend) {}
+
+    /**
+     * @brief Imports an aggregates response.
+     * @param body The response body.
+     * @return The number of bars imported.
+     * @throws std::invalid_argument If the body is malformed.
+     * @throws std::runtime_error If Polygon reports an error status.
+     */
+    std::size_t import_aggregates(std::string_view body);
+
+    /**
+     * @brief Imports an option chain snapshot.
+     * @param body The response body.
+     * @return The number of quotes imported.
+     * @throws std::invalid_argument If the body is malformed.
+     * @throws std::runtime_error If Polygon reports an error status.
+     */
+    std::size_t import_option_chain(std::string_view body);
+
+   private:
+    const TickStore& store;
+    PolygonRestParser parser;
+    BarColumns bars;
+    OptionChainColumns chain;
+};
+
+}  // namespace thales
@@ -0,0 +1,99 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "black_scholes.h"
+
+/**
+ * @brief Numerical methods for American option prices
+ */
+enum class AmericanMethod {
+    COX_ROSS_RUBINSTEIN, /**< Binomial tree with u = 1 / d */
+    LEISEN_REIMER,       /**< Binomial tree centred on the strike */
+    CRANK_NICOLSON,      /**< Finite differences in log-spot */
+    BARONE_ADESI_WHALEY, /**< Quadratic early-exercise approximation */
+    JU_ZHONG             /**< Barone-Adesi-Whaley with a second-order term */
+};
+
+/**
+ * @brief Resolution of the American pricers
+ */
+struct AmericanSettings {
+    AmericanMethod method = AmericanMethod::LEISEN_REIMER; /**< Method */
+    int time_steps = 201;  /**< Tree levels or PDE time steps */
+    int space_steps = 400; /**< PDE intervals in log-spot */
+};
+
+/**
+ * @brief American option pricing without dividends
+ *
+ * Without dividends early exercise never pays for a call when r >= 0, nor
+ * for a put when r <= 0, so those options get the Black-Scholes price from
+ * every method. The analytic approximations handle puts with r > 0 and fall
+ * back to the Leisen-Reimer tree for calls with r < 0.
+ *
+ * Trees roll back through one preallocated buffer per thread, so pricing
+ * does not allocate once the buffer has grown to the largest tree used.
+ */
+class AmericanOption {
+   public:
+    /**
+     * @brief Calculate the price of an American option
+     *
+     * @param S Current stock price
+     * @param K Strike price
+     * @param T Time to maturity (in years)
+     * @param r Risk-free interest rate
+     * @param sigma Volatility
+     * @param type Option type (CALL or PUT)
+     * @param settings Method and resolution
+     * @return double Option price
+     * @throws std::invalid_argument If any input or setting is invalid
+     */
+    static double calculate_option_price(double S, double K, double T,
+                                         double r, double sigma,
+                                         OptionType type,
+                                         const AmericanSettings& settings = {});
+
+    /**
+     * @brief Calculate the prices of a batch of American options
+     *
+     * Neighbouring options with the same S, T, r and sigma (a chain sorted
+     * by expiry) share one lattice with COX_ROSS_RUBINSTEIN, rolled back
+     * for all their strikes at once, and, when they are also of one type,
+     * one factorised grid with CRANK_NICOLSON. Other methods price option
+     * by option.
+     *
+     * @param batch Structure-of-arrays view over the options to price
+     * @param prices Output array of at least @c batch.size elements
+     * @param settings Method and resolution
+     * @throws std::invalid_argument If any input or setting is invalid
+     */
+    static void calculate_option_prices(const OptionBatch& batch,
+                                        double* prices,
+                                        const AmericanSettings& settings = {});
+};
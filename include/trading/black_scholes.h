@@ -25,6 +25,9 @@
 #pragma once
 
 #include <cmath>
+#include <cstddef>
+
+#include "math_policy.h"
 
 /**
  * @brief Option types
@@ -34,8 +37,103 @@ enum OptionType {
     PUT   /**< Put option */
 };
 
+/**
+ * @brief Instruction sets available to the batch pricing kernels
+ */
+enum class SimdBackend {
+    AUTO,   /**< Best instruction set supported by the running CPU */
+    SCALAR, /**< Portable scalar fallback */
+    NEON,   /**< ARM NEON, 2 doubles per vector */
+    AVX2,   /**< x86 AVX2 with FMA, 4 doubles per vector */
+    AVX512  /**< x86 AVX-512F, 8 doubles per vector */
+};
+
+/**
+ * @brief Non-owning structure-of-arrays view over a batch of options
+ *
+ * Each pointer refers to @c size contiguous elements owned by the caller, so
+ * a whole option chain can be priced without gathering per-option structs.
+ */
+struct OptionBatch {
+    const double* S;        /**< Current stock prices */
+    const double* K;        /**< Strike prices */
+    const double* T;        /**< Times to maturity (in years) */
+    const double* r;        /**< Risk-free interest rates */
+    const double* sigma;    /**< Volatilities */
+    const OptionType* type; /**< Option types (CALL or PUT) */
+    std::size_t size;       /**< Number of options in the batch */
+};
+
+/**
+ * @brief OptionBatch whose inputs were validated when it was built
+ *
+ * The OptionBatch overloads check every option on each call. A chain that
+ * is priced repeatedly can be validated once instead and passed to the
+ * overloads taking this type, which go straight to the kernels. The view
+ * does not own the arrays; they must stay valid and unchanged while it is
+ * in use.
+ */
+class ValidatedOptionBatch {
+   public:
+    /**
+     * @brief Validate every option of a batch
+     *
+     * @param batch Structure-of-arrays view over the options
+     * @throws std::invalid_argument If any input is invalid
+     */
+    explicit ValidatedOptionBatch(const OptionBatch& batch);
+
+    /** @brief The validated view */
+    const OptionBatch& view() const { return batch; }
+
+   private:
+    OptionBatch batch;
+};
+
+/**
+ * @brief Option price together with its analytic sensitivities
+ *
+ * Sensitivities are per unit change of the input: vega and volga per 1.0 of
+ * volatility, theta per year and rho per 1.0 of interest rate.
+ */
+struct Greeks {
+    double price; /**< Option price */
+    double delta; /**< dV/dS */
+    double gamma; /**< d2V/dS2 */
+    double vega;  /**< dV/dsigma */
+    double theta; /**< -dV/dT, the change in value as time passes */
+    double rho;   /**< dV/dr */
+    double vanna; /**< d2V/dS dsigma */
+    double volga; /**< d2V/dsigma2 */
+};
+
+/**
+ * @brief Output arrays for batch Greeks, one element per option
+ *
+ * Any pointer may be null to skip that output.
+ */
+struct GreeksBatch {
+    double* price; /**< Option prices */
+    double* delta; /**< Deltas */
+    double* gamma; /**< Gammas */
+    double* vega;  /**< Vegas */
+    double* theta; /**< Thetas */
+    double* rho;   /**< Rhos */
+    double* vanna; /**< Vannas */
+    double* volga; /**< Volgas */
+};
+
 /**
  * @brief Black-Scholes model for option pricing
+ *
+ * Every pricing function takes a math policy as its template argument:
+ * ExactMath (the default), RiskMath or ScreeningMath. The policy fixes the
+ * normal distribution at compile time, so the fast paths cost no dispatch
+ * and their error is bounded by @c Math::MAX_ERROR per evaluation of N(x).
+ *
+ * These functions validate their inputs and dispatch on the option type at
+ * run time; the kernels behind them are option_price() and
+ * option_greeks() in option_kernels.h.
  */
 class BlackScholes {
    public:
@@ -49,7 +147,107 @@ class BlackScholes {
      * @param sigma Volatility
      * @param type Option type (CALL or PUT)
      * @return double Option price
+     * @throws std::invalid_argument If any input is invalid
      */
+    template <class Math = ExactMath>
     static double calculate_option_price(double S, double K, double T, double r,
                                   double sigma, OptionType type);
+
+    /**
+     * @brief Calculate the price and Greeks of an option in one pass
+     *
+     * d1, d2, the density and the cumulative probabilities are evaluated
+     * once and shared by the price and every sensitivity.
+     *
+     * @param S Current stock price
+     * @param K Strike price
+     * @param T Time to maturity (in years)
+     * @param r Risk-free interest rate
+     * @param sigma Volatility
+     * @param type Option type (CALL or PUT)
+     * @return Greeks Option price and sensitivities
+     * @throws std::invalid_argument If any input is invalid
+     */
+    template <class Math = ExactMath>
+    static Greeks calculate_greeks(double S, double K, double T, double r,
+                                   double sigma, OptionType type);
+
+    /**
+     * @brief Calculate the prices of a batch of options
+     *
+     * All inputs are validated before any price is written. The kernel
+     * evaluates several options per instruction using the requested SIMD
+     * backend; results agree with calculate_option_price() for the same
+     * policy to within floating-point rounding.
+     *
+     * @param batch Structure-of-arrays view over the options to price
+     * @param prices Output array of at least @c batch.size elements
+     * @param backend Instruction set to use (AUTO picks the best available)
+     * @throws std::invalid_argument If any input is invalid or the backend is
+     * not supported on this CPU
+     */
+    template <class Math = ExactMath>
+    static void calculate_option_prices(
+        const OptionBatch& batch, double* prices,
+        SimdBackend backend = SimdBackend::AUTO);
+
+    /**
+     * @brief Calculate the prices of a batch validated in advance
+     *
+     * @param batch Options to price
+     * @param prices Output array of at least @c batch.view().size elements
+     * @param backend Instruction set to use (AUTO picks the best available)
+     * @throws std::invalid_argument If the backend is not supported on this
+     * CPU
+     */
+    template <class Math = ExactMath>
+    static void calculate_option_prices(
+        const ValidatedOptionBatch& batch, double* prices,
+        SimdBackend backend = SimdBackend::AUTO);
+
+    /**
+     * @brief Calculate the prices and Greeks of a batch of options
+     *
+     * The batch counterpart of calculate_greeks(), vectorised like
+     * calculate_option_prices().
+     *
+     * @param batch Structure-of-arrays view over the options to evaluate
+     * @param greeks Output arrays of at least @c batch.size elements each
+     * @param backend Instruction set to use (AUTO picks the best available)
+     * @throws std::invalid_argument If any input is invalid or the backend is
+     * not supported on this CPU
+     */
+    template <class Math = ExactMath>
+    static void calculate_greeks(const OptionBatch& batch,
+                                 const GreeksBatch& greeks,
+                                 SimdBackend backend = SimdBackend::AUTO);
+
+    /**
+     * @brief Calculate the prices and Greeks of a batch validated in advance
+     *
+     * @param batch Options to evaluate
+     * @param greeks Output arrays of at least @c batch.view().size elements
+     * @param backend Instruction set to use (AUTO picks the best available)
+     * @throws std::invalid_argument If the backend is not supported on this
+     * CPU
+     */
+    template <class Math = ExactMath>
+    static void calculate_greeks(const ValidatedOptionBatch& batch,
+                                 const GreeksBatch& greeks,
+                                 SimdBackend backend = SimdBackend::AUTO);
+
+    /**
+     * @brief Check whether a SIMD backend can run on this CPU
+     *
+     * @param backend Instruction set to query
+     * @return bool True if the backend was compiled in and the CPU supports it
+     */
+    static bool is_simd_backend_supported(SimdBackend backend);
+
+    /**
+     * @brief Get the backend that AUTO resolves to on this CPU
+     *
+     * @return SimdBackend The widest supported instruction set
+     */
+    static SimdBackend best_simd_backend();
 };
@@ -0,0 +1,108 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "strategy.h"
+
+namespace thales {
+
+class OrderManager;
+
+/**
+ * @brief An order that passed pre-trade risk, as handed to a broker.
+ */
+struct BrokerOrder {
+    std::uint64_t id;          /**< Order manager ID */
+    OrderRequest request;      /**< What to trade */
+    double price;              /**< Limit, or the reference price */
+    std::int64_t tick_ns;      /**< Market data time that triggered it */
+};
+
+/**
+ * @enum ExecutionKind
+ * @brief What a broker reports about a working order.
+ */
+enum class ExecutionKind : std::uint8_t {
+    FILL,   /**< Some or all of the order traded */
+    CANCEL, /**< The rest of the order was cancelled */
+    REJECT  /**< The broker refused the rest of the order */
+};
+
+/**
+ * @brief A broker's report on a working order.
+ */
+struct ExecutionReport {
+    std::uint64_t order_id;     /**< Order manager ID */
+    ExecutionKind kind;         /**< Fill, cancel or reject */
+    int quantity;               /**< Contracts filled; ignored otherwise */
+    double price;               /**< Fill price; ignored otherwise */
+    std::int64_t timestamp_ns;  /**< Broker time */
+};
+
+/**
+ * @class BrokerAdapter
+ * @brief Connection to a broker or exchange.
+ *
+ * send() is called on the order manager thread and should hand the order
+ * off without blocking; executions come back through
+ * OrderManager::report(), from any thread.
+ */
+class BrokerAdapter {
+   public:
+    virtual ~BrokerAdapter() = default;
+
+    /** @brief Sends an order that passed pre-trade risk. */
+    virtual void send(const BrokerOrder& order) = 0;
+};
+
+/**
+ * @class SimulatedBroker
+ * @brief Broker that fills every order in full at its price, immediately.
+ */
+class SimulatedBroker : public BrokerAdapter {
+   public:
+    /**
+     * @brief Sets the order manager that fills are reported to.
+     *
+     * Must be called before the manager starts.
+     */
+    void connect(OrderManager& manager) { this->manager = &manager; }
+
+    void send(const BrokerOrder& order) override;
+
+    /** @brief Gets the number of orders sent. */
+    std::uint64_t sent() const {
+        return orders.load(std::memory_order_relaxed);
+    }
+
+   private:
+    OrderManager* manager = nullptr;
+    std::atomic<std::uint64_t> orders{0};
+};
+
+}  // namespace thales
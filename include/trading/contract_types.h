@@ -0,0 +1,73 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "black_scholes.h"
+
+namespace thales {
+
+/**
+ * @enum Side
+ * @brief Direction of an order.
+ */
+enum class Side : std::uint8_t {
+    BUY, /**< Buy to open or close */
+    SELL /**< Sell to open or close */
+};
+
+/**
+ * @brief Parses an option type such as "Call" or "PUT" (case-insensitive).
+ * @param text The option type.
+ * @return The option type.
+ * @throws std::invalid_argument If the text is not a call or put.
+ */
+OptionType parse_option_type(std::string_view text);
+
+/**
+ * @brief Gets the display name of an option type.
+ * @param type The option type.
+ * @return "Call" or "Put".
+ */
+std::string_view to_string(OptionType type);
+
+/**
+ * @brief Parses an order side such as "Buy" or "SELL" (case-insensitive).
+ * @param text The order side.
+ * @return The order side.
+ * @throws std::invalid_argument If the text is not a buy or sell.
+ */
+Side parse_side(std::string_view text);
+
+/**
+ * @brief Gets the display name of an order side.
+ * @param side The order side.
+ * @return "Buy" or "Sell".
+ */
+std::string_view to_string(Side side);
+
+}  // namespace thales
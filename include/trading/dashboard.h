@@ -0,0 +1,126 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "order.h"
+#include "portfolio.h"
+#include "utils/terminal_screen.h"
+
+namespace thales {
+
+/**
+ * @class Dashboard
+ * @brief Live terminal view of the portfolio and recent orders.
+ *
+ * Producers publish new data from any thread; the render loop wakes up on
+ * each publication, draws only the rows that fit on the screen and writes
+ * the cells that changed since the previous frame in a single write().
+ * Bursts of publications are coalesced into at most one frame per
+ * minimum frame interval.
+ */
+class Dashboard {
+   public:
+    /**
+     * @brief Creates a dashboard.
+     * @param fd Terminal to draw on.
+     * @param rows Screen height; 0 to ask the terminal.
+     * @param columns Screen width; 0 to ask the terminal.
+     */
+    explicit Dashboard(int fd = 1, std::size_t rows = 0,
+                       std::size_t columns = 0);
+
+    /** @brief Restores the cursor and default rendition. */
+    ~Dashboard();
+
+    Dashboard(const Dashboard&) = delete;
+    Dashboard& operator=(const Dashboard&) = delete;
+
+    /**
+     * @brief Publishes a new portfolio snapshot.
+     *
+     * Data from another memory resource is copied into the dashboard's
+     * own storage, so a per-cycle Arena may be reset once this returns.
+     */
+    void publish(Portfolio portfolio);
+
+    /** @brief Publishes the list of recent orders; copied like above. */
+    void publish(std::pmr::vector<Order> orders);
+
+    /**
+     * @brief Draws a frame if anything was published since the last one.
+     * @return The number of bytes written to the terminal.
+     */
+    std::size_t render();
+
+    /**
+     * @brief Renders on every publication until stop() is called.
+     * @param min_interval Shortest time between two frames.
+     */
+    void run(std::chrono::milliseconds min_interval =
+                 std::chrono::milliseconds(33));
+
+    /** @brief Makes run() return. */
+    void stop();
+
+    /**
+     * @brief Changes the screen size and redraws everything.
+     *
+     * Call from the rendering thread, e.g. after SIGWINCH.
+     *
+     * @param rows Screen height; 0 to ask the terminal.
+     * @param columns Screen width; 0 to ask the terminal.
+     */
+    void resize(std::size_t rows = 0, std::size_t columns = 0);
+
+   private:
+    void draw();
+
+    int fd;
+    TerminalScreen screen;
+    std::string output;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    Portfolio pending_portfolio;
+    std::pmr::vector<Order> pending_orders;
+    bool portfolio_changed = false;
+    bool orders_changed = false;
+    bool dirty = true;
+    bool stopped = false;
+
+    Portfolio portfolio;
+    std::pmr::vector<Order> orders;
+    bool cursor_hidden = false;
+};
+
+}  // namespace thales
@@ -0,0 +1,87 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "black_scholes.h"
+
+/**
+ * @brief Convergence settings for the implied volatility solver
+ */
+struct ImpliedVolatilitySettings {
+    double tolerance = 1e-10; /**< Stop once a step moves sigma less */
+    int max_iterations = 32;  /**< Give up (and return NaN) after this */
+};
+
+/**
+ * @brief Implied volatility inversion of the Black-Scholes model
+ *
+ * Each option starts from the Corrado-Miller approximation and is refined
+ * with Halley steps that reuse the vega and volga of the Greeks kernel,
+ * safeguarded by bisection. Most liquid options converge in two or three
+ * iterations.
+ */
+class ImpliedVolatility {
+   public:
+    /**
+     * @brief Solve for the volatility that reproduces a market price
+     *
+     * @param price Market price of the option
+     * @param S Current stock price
+     * @param K Strike price
+     * @param T Time to maturity (in years)
+     * @param r Risk-free interest rate
+     * @param type Option type (CALL or PUT)
+     * @param settings Tolerance and iteration cap
+     * @return double The implied volatility, or NaN if the price violates
+     * the no-arbitrage bounds, T is zero or the solver did not converge
+     * @throws std::invalid_argument If any input or setting is invalid
+     */
+    static double calculate_implied_volatility(
+        double price, double S, double K, double T, double r, OptionType type,
+        const ImpliedVolatilitySettings& settings = {});
+
+    /**
+     * @brief Solve for the implied volatilities of a batch of options
+     *
+     * The whole batch is converged vector by vector without per-option
+     * branches, using the same SIMD backends as the pricing kernels.
+     *
+     * @param batch Options to solve; @c batch.sigma is ignored and may be null
+     * @param prices Market prices, @c batch.size elements
+     * @param vols Output array of at least @c batch.size elements, set to NaN
+     * for options without a solution
+     * @param settings Tolerance and iteration cap
+     * @param backend Instruction set to use (AUTO picks the best available)
+     * @return std::size_t Number of options that converged
+     * @throws std::invalid_argument If any input or setting is invalid or the
+     * backend is not supported on this CPU
+     */
+    static std::size_t calculate_implied_volatilities(
+        const OptionBatch& batch, const double* prices, double* vols,
+        const ImpliedVolatilitySettings& settings = {},
+        SimdBackend backend = SimdBackend::AUTO);
+};
@@ -0,0 +1,200 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "portfolio.h"
+#include "strategy.h"
+#include "utils/seqlock.h"
+
+namespace thales {
+
+/**
+ * @brief Published totals of the positions on one underlying.
+ *
+ * Values are in currency and scaled like UnderlyingRisk. Expired
+ * positions count as settled and contribute only their realized P&L.
+ */
+struct UnderlyingBook {
+    UnderlyingRisk risk;       /**< Model value and Greeks */
+    double cost = 0.0;         /**< Average cost of the open positions */
+    double realized_pnl = 0.0; /**< P&L realized by closing trades */
+    int contracts = 0;         /**< Gross open contracts */
+
+    /** @brief Gets the model value less the average cost. */
+    double unrealized_pnl() const { return risk.value - cost; }
+};
+
+/**
+ * @class LivePortfolio
+ * @brief Portfolio kept up to date by fills and quotes instead of rebuilt.
+ *
+ * Each fill changes one position's quantity and average price and
+ * revalues only that position; each underlying quote revalues only the
+ * positions on that underlying. The per-underlying and book totals are
+ * adjusted by the difference, so an update costs O(positions changed)
+ * rather than O(book).
+ *
+ * One thread applies updates. The totals are published through a
+ * SeqlockTable, so any number of display or risk threads can take
+ * consistent snapshots without locking or slowing the writer down.
+ * Positions on an underlying without a spot and volatility are carried at
+ * zero value until update_underlying() is called for it.
+ */
+class LivePortfolio {
+   public:
+    /** Default number of underlyings the snapshot table has room for. */
+    static constexpr std::size_t DEFAULT_UNDERLYINGS = 4096;
+
+    /**
+     * @brief Creates an empty live portfolio.
+     * @param rate Risk-free interest rate.
+     * @param valuation_date Valuation date (days since epoch).
+     * @param max_underlyings One past the largest SymbolId that may be
+     *        traded.
+     */
+    LivePortfolio(double rate, std::int32_t valuation_date,
+                  std::size_t max_underlyings = DEFAULT_UNDERLYINGS);
+
+    /**
+     * @brief Books every position of a portfolio at its premium.
+     *
+     * Revalues the whole book once; call before streaming updates.
+     *
+     * @param portfolio The positions already held.
+     * @throws std::invalid_argument If an underlying is out of range.
+     */
+    void load(const Portfolio& portfolio);
+
+    /**
+     * @brief Applies a fill to its position.
+     * @param contract The contract traded.
+     * @param side Whether the contracts were bought or sold.
+     * @param quantity Contracts filled; positive.
+     * @param price Fill price per contract.
+     * @throws std::invalid_argument If the quantity or price is invalid or
+     *         the underlying is out of range.
+     */
+    void apply_fill(const ContractKey& contract, Side side, int quantity,
+                    double price);
+
+    /** @brief Applies an executed order as a fill. */
+    void apply(const Order& fill);
+
+    /**
+     * @brief Updates an underlying's spot and volatility.
+     *
+     * Revalues the positions on that underlying only.
+     *
+     * @param symbol The underlying.
+     * @param spot The spot price.
+     * @param volatility The volatility.
+     * @throws std::invalid_argument If the spot or volatility is not
+     *         positive or the underlying is out of range.
+     */
+    void update_underlying(SymbolId symbol, double spot, double volatility);
+
+    /**
+     * @brief Moves the valuation date and revalues the whole book.
+     * @param day Valuation date (days since epoch).
+     */
+    void set_valuation_date(std::int32_t day);
+
+    /**
+     * @brief Gets the positions, with premiums at average cost.
+     *
+     * Writer thread only.
+     */
+    const Portfolio& positions() const { return book; }
+
+    /** @brief Reads the totals of one underlying; any thread. */
+    UnderlyingBook underlying(SymbolId symbol) const;
+
+    /** @brief Reads the totals of the whole book; any thread. */
+    UnderlyingBook totals() const { return table.read(0); }
+
+    /**
+     * @brief Reads the book and underlying totals as of one update; any
+     *        thread.
+     * @param totals Receives the totals of the whole book.
+     * @param underlyings Receives one entry per underlying, indexed by
+     *        SymbolId; resized to one past the largest SymbolId traded.
+     * @return The number of updates applied before the snapshot.
+     */
+    std::uint64_t snapshot(UnderlyingBook& totals,
+                           std::vector<UnderlyingBook>& underlyings) const;
+
+    /** @brief Gets the number of updates published so far; any thread. */
+    std::uint64_t version() const { return table.version(); }
+
+   private:
+    /** One position's share of its underlying's totals. */
+    struct Contribution {
+        double value = 0.0;
+        double delta = 0.0;
+        double gamma = 0.0;
+        double vega = 0.0;
+        double theta = 0.0;
+        double cost = 0.0;
+        int contracts = 0;
+    };
+
+    void add_symbol(SymbolId symbol);
+    std::size_t trade(const ContractKey& contract, int quantity,
+                      double price);
+    bool priced(SymbolId symbol) const;
+    Contribution contribution(std::size_t row, const Greeks* greeks) const;
+    void revalue(SymbolId symbol);
+    void revalue_all();
+    void publish(SymbolId symbol, const UnderlyingBook& previous);
+
+    double rate;
+    std::int32_t valuation_date;
+    Portfolio book;
+    std::unordered_map<ContractKey, std::size_t, ContractKeyHash> rows;
+    std::vector<Contribution> contributions;
+    std::vector<std::vector<std::size_t>> rows_by_underlying;
+    std::vector<UnderlyingBook> books;
+    UnderlyingBook total;
+    std::vector<double> spots;
+    std::vector<double> volatilities;
+    SeqlockTable<UnderlyingBook> table;
+    std::atomic<std::size_t> symbol_count{0};
+
+    /** Batch kernel scratch, reused across quotes. */
+    struct Scratch {
+        std::vector<double> S, K, T, r, sigma;
+        std::vector<OptionType> type;
+        std::vector<double> price, delta, gamma, vega, theta;
+        std::vector<std::size_t> rows;
+    } scratch;
+};
+
+}  // namespace thales
@@ -0,0 +1,190 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "black_scholes.h"
+
+namespace thales {
+class ThreadPool;
+}
+
+/**
+ * @brief Philox4x32-10 counter-based random number generator
+ *
+ * Maps a 128-bit counter and a 64-bit key to 128 random bits (Salmon et
+ * al., 2011). Nothing is carried between calls, so any block of any stream
+ * can be generated independently and in any order.
+ */
+struct Philox4x32 {
+    using Counter = std::array<std::uint32_t, 4>; /**< Block counter */
+    using Key = std::array<std::uint32_t, 2>;     /**< Stream key */
+
+    /**
+     * @brief Generate the random block for one counter
+     *
+     * @param counter Block counter
+     * @param key Stream key
+     * @return Counter 128 random bits
+     */
+    static Counter generate(Counter counter, Key key) {
+        for (int round = 0; round < 10; ++round) {
+            std::uint64_t p0 = std::uint64_t{0xD2511F53} * counter[0];
+            std::uint64_t p1 = std::uint64_t{0xCD9E8D57} * counter[2];
+            counter = {static_cast<std::uint32_t>(p1 >> 32) ^ counter[1] ^
+                           key[0],
+                       static_cast<std::uint32_t>(p1),
+                       static_cast<std::uint32_t>(p0 >> 32) ^ counter[3] ^
+                           key[1],
+                       static_cast<std::uint32_t>(p0)};
+            key[0] += 0x9E3779B9;
+            key[1] += 0xBB67AE85;
+        }
+        return counter;
+    }
+};
+
+/**
+ * @brief Payoffs supported by the Monte Carlo engine
+ *
+ * Averaging and barrier monitoring use the @c steps equally spaced dates
+ * up to and including expiry.
+ */
+enum class PathPayoff {
+    EUROPEAN,      /**< Payoff on the final spot */
+    ASIAN,         /**< Payoff on the arithmetic average spot */
+    UP_AND_OUT,    /**< Knocked out once the spot reaches the barrier */
+    UP_AND_IN,     /**< Only pays if the spot reaches the barrier */
+    DOWN_AND_OUT,  /**< Knocked out once the spot falls to the barrier */
+    DOWN_AND_IN    /**< Only pays if the spot falls to the barrier */
+};
+
+/**
+ * @brief A path-dependent option on a lognormal underlying
+ */
+struct PathOption {
+    PathPayoff payoff = PathPayoff::EUROPEAN; /**< Payoff family */
+    OptionType type = CALL;                   /**< Call or put */
+    double S = 100.0;                         /**< Current stock price */
+    double K = 100.0;                         /**< Strike price */
+    double T = 1.0;                           /**< Time to maturity (years) */
+    double r = 0.0;                           /**< Risk-free interest rate */
+    double sigma = 0.2;                       /**< Volatility */
+    double barrier = 0.0;                     /**< Barrier level */
+    int steps = 1;                            /**< Monitoring dates */
+};
+
+/**
+ * @brief Sources of the normal draws
+ */
+enum class RandomSequence {
+    PHILOX, /**< Pseudo-random, one Philox stream per path */
+    SOBOL   /**< Sobol points through a Brownian bridge */
+};
+
+/**
+ * @brief Simulation settings
+ */
+struct MonteCarloSettings {
+    std::size_t paths = 1 << 16; /**< Simulated paths */
+    std::uint64_t seed = 0;      /**< Philox key */
+    bool antithetic = true;      /**< Pair every path with its mirror */
+    bool control_variate = true; /**< Regress on the European payoff */
+    /** Source of the normal draws */
+    RandomSequence sequence = RandomSequence::PHILOX;
+    /** Instruction set of the normal and exp kernels */
+    SimdBackend backend = SimdBackend::AUTO;
+};
+
+/**
+ * @brief Price estimate with its statistical error
+ */
+struct MonteCarloResult {
+    double price = 0.0;          /**< Discounted mean payoff */
+    double standard_error = 0.0; /**< Standard error of the price */
+    std::size_t paths = 0;       /**< Paths simulated */
+};
+
+/**
+ * @brief Monte Carlo pricing of path-dependent options
+ *
+ * Path i always draws from the Philox stream (seed, i), or from Sobol
+ * point i, and paths are summed in fixed chunks combined in chunk order,
+ * so a result is bit-for-bit the same on any number of threads.
+ *
+ * With SOBOL, the first SOBOL_DIMENSIONS Brownian bridge draws, which
+ * carry most of the variance of the path, come from a Sobol sequence and
+ * the rest from Philox. The standard error then assumes independent paths
+ * and overstates the true error.
+ *
+ * The control variate is the discounted European payoff of the same
+ * strike, whose Black-Scholes price is known; its coefficient is estimated
+ * from the simulated paths.
+ */
+class MonteCarlo {
+   public:
+    /** @brief Bridge dimensions drawn from the Sobol sequence */
+    static constexpr int SOBOL_DIMENSIONS = 16;
+
+    /**
+     * @brief Price an option on the calling thread
+     *
+     * @param option Option to price
+     * @param settings Simulation settings
+     * @return MonteCarloResult Price and standard error
+     * @throws std::invalid_argument If the option or settings are invalid
+     */
+    static MonteCarloResult price(const PathOption& option,
+                                  const MonteCarloSettings& settings = {});
+
+    /**
+     * @brief Price an option with the chunks spread over a thread pool
+     *
+     * @param option Option to price
+     * @param settings Simulation settings
+     * @param pool Pool that simulates the chunks
+     * @return MonteCarloResult The same result as the single-threaded call
+     * @throws std::invalid_argument If the option or settings are invalid
+     */
+    static MonteCarloResult price(const PathOption& option,
+                                  const MonteCarloSettings& settings,
+                                  thales::ThreadPool& pool);
+
+    /**
+     * @brief Standard normal quantiles of an array of probabilities
+     *
+     * @param p Probabilities in (0, 1)
+     * @param z Output array of at least @p size elements (may alias @p p)
+     * @param size Number of elements
+     * @param backend Instruction set to use (AUTO picks the best available)
+     * @throws std::invalid_argument If the backend is not supported
+     */
+    static void inverse_normal_cdf(const double* p, double* z,
+                                   std::size_t size,
+                                   SimdBackend backend = SimdBackend::AUTO);
+};
@@ -0,0 +1,219 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "portfolio.h"
+#include "strategy.h"
+
+namespace thales {
+
+struct OptionChainColumns;
+
+/**
+ * @brief Contracts to select from an OptionChainIndex.
+ *
+ * Bounds are inclusive; the defaults select every contract of the
+ * underlying.
+ */
+struct ChainQuery {
+    SymbolId underlying = INVALID_SYMBOL; /**< Underlying ticker */
+    std::int32_t first_expiration =       /**< Earliest expiry (days) */
+        std::numeric_limits<std::int32_t>::min();
+    std::int32_t last_expiration =        /**< Latest expiry (days) */
+        std::numeric_limits<std::int32_t>::max();
+    bool calls = true;                    /**< Include calls */
+    bool puts = true;                     /**< Include puts */
+    double min_strike = -std::numeric_limits<double>::infinity();
+    double max_strike = std::numeric_limits<double>::infinity();
+};
+
+/**
+ * @class OptionChainIndex
+ * @brief Sorted index of option contracts by underlying, expiry, type and
+ *        strike.
+ *
+ * Each underlying has a sorted table of its expiries, and each expiry
+ * points to two strike-sorted runs, calls then puts, in one contiguous
+ * strike array. A contract is found with two binary searches, and a range
+ * such as "AAPL December calls between 140 and 160" is a contiguous run
+ * of each matching expiry. Every entry remembers the row it was built
+ * from (a portfolio position or a chain quote), so results map back to
+ * the source columns.
+ *
+ * The index is immutable; rebuild it when the contract set changes.
+ */
+class OptionChainIndex {
+   public:
+    /** Row returned by find() for contracts not in the index. */
+    static constexpr std::size_t NOT_FOUND =
+        std::numeric_limits<std::size_t>::max();
+
+    /**
+     * @brief One expiry of one underlying.
+     *
+     * Calls are entries [begin, puts) and puts [puts, end).
+     */
+    struct Expiry {
+        SymbolId underlying;      /**< Underlying ticker */
+        std::int32_t expiration;  /**< Expiry (days since epoch) */
+        std::uint32_t begin;      /**< First call */
+        std::uint32_t puts;       /**< First put */
+        std::uint32_t end;        /**< One past the last put */
+    };
+
+    /** @brief Creates an empty index. */
+    OptionChainIndex() = default;
+
+    /**
+     * @brief Indexes a list of contracts.
+     *
+     * When a contract appears more than once the last row is kept; rows
+     * with an invalid underlying or a non-finite strike are skipped.
+     *
+     * @param contracts The contracts; their positions are the source rows.
+     * @throws std::invalid_argument If there are 2^32 or more contracts.
+     */
+    explicit OptionChainIndex(const std::vector<ContractKey>& contracts);
+
+    /** @brief Indexes the positions of a portfolio. */
+    explicit OptionChainIndex(const Portfolio& portfolio);
+
+    /** @brief Indexes the contracts of a chain snapshot. */
+    explicit OptionChainIndex(const OptionChainColumns& chain);
+
+    /** @brief Gets the number of contracts. */
+    std::size_t size() const { return strikes.size(); }
+
+    /**
+     * @brief Finds a contract.
+     * @param contract The contract.
+     * @return Its entry, or NOT_FOUND.
+     */
+    std::size_t find(const ContractKey& contract) const;
+
+    /** @brief Checks whether a contract is in the index. */
+    bool contains(const ContractKey& contract) const {
+        return find(contract) != NOT_FOUND;
+    }
+
+    /**
+     * @brief Gets every expiry of an underlying, ascending.
+     * @param underlying The underlying.
+     * @param first Receives the first expiry; null if there are none.
+     * @return The number of expiries.
+     */
+    std::size_t expiries(SymbolId underlying, const Expiry** first) const;
+
+    /**
+     * @brief Gets the entries of one expiry and type within a strike
+     *        range.
+     * @param expiry An expiry of this index.
+     * @param type Calls or puts.
+     * @param min_strike Lowest strike, inclusive.
+     * @param max_strike Highest strike, inclusive.
+     * @return The entries [first, second), ascending by strike.
+     */
+    std::pair<std::size_t, std::size_t> strike_range(
+        const Expiry& expiry, OptionType type, double min_strike,
+        double max_strike) const;
+
+    /**
+     * @brief Calls fn(entry) for every contract matching a query.
+     *
+     * Contracts are visited by expiry, calls before puts, then by strike.
+     *
+     * @return The number of contracts visited.
+     */
+    template <typename Fn>
+    std::size_t for_each(const ChainQuery& query, Fn fn) const;
+
+    /**
+     * @brief Appends the source rows of every contract matching a query.
+     * @param query The contracts to select.
+     * @param rows Receives the rows, in for_each() order.
+     * @return The number of rows appended.
+     */
+    std::size_t select(const ChainQuery& query,
+                       std::vector<std::size_t>& rows) const;
+
+    /** @brief Gets the strike of an entry. */
+    double strike(std::size_t entry) const { return strikes[entry]; }
+
+    /** @brief Gets the source row of an entry. */
+    std::size_t source(std::size_t entry) const { return sources[entry]; }
+
+    /** @brief Gets the contract of an entry. */
+    ContractKey contract(std::size_t entry) const;
+
+   private:
+    friend class StateSnapshot;
+
+    template <typename Key>
+    void build(std::size_t count, Key key);
+
+    std::vector<std::uint32_t> underlying_begin; /**< Expiries per symbol */
+    std::vector<Expiry> expiry_table;
+    std::vector<double> strikes;
+    std::vector<std::uint32_t> sources;
+    std::vector<std::uint32_t> entry_expiry; /**< Expiry of each entry */
+};
+
+template <typename Fn>
+std::size_t OptionChainIndex::for_each(const ChainQuery& query,
+                                       Fn fn) const {
+    const Expiry* first = nullptr;
+    std::size_t count = expiries(query.underlying, &first);
+    const Expiry* last = first + count;
+    // Expiries are sorted, so the matching ones are a contiguous run
+    first = std::lower_bound(first, last, query.first_expiration,
+                             [](const Expiry& expiry, std::int32_t day) {
+                                 return expiry.expiration < day;
+                             });
+    std::size_t visited = 0;
+    for (; first != last && first->expiration <= query.last_expiration;
+         ++first) {
+        for (OptionType type : {CALL, PUT}) {
+            if (!(type == CALL ? query.calls : query.puts)) {
+                continue;
+            }
+            auto [begin, end] = strike_range(*first, type, query.min_strike,
+                                             query.max_strike);
+            for (std::size_t entry = begin; entry < end; ++entry) {
+                fn(entry);
+            }
+            visited += end - begin;
+        }
+    }
+    return visited;
+}
+
+}  // namespace thales
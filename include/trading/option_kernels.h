@@ -0,0 +1,269 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <algorithm>
+
+#include "black_scholes.h"
+#include "math_policy.h"
+
+/**
+ * @brief Inputs of one option for the pricing kernels
+ *
+ * The kernels do not validate: S and K must be positive and T and sigma
+ * non-negative. The checked entry points are BlackScholes and
+ * AmericanOption, which validate once and then call a kernel.
+ */
+struct OptionInputs {
+    double S;     /**< Current stock price */
+    double K;     /**< Strike price */
+    double T;     /**< Time to maturity (in years) */
+    double r;     /**< Risk-free interest rate */
+    double sigma; /**< Volatility */
+};
+
+/**
+ * @brief Call option tag for the pricing kernels
+ */
+struct Call {
+    static constexpr OptionType TYPE = CALL;
+    static constexpr double SIGN = 1.0; /**< Sign of the payoff S - K */
+};
+
+/**
+ * @brief Put option tag for the pricing kernels
+ */
+struct Put {
+    static constexpr OptionType TYPE = PUT;
+    static constexpr double SIGN = -1.0; /**< Sign of the payoff S - K */
+};
+
+/**
+ * @brief European exercise, priced by the Black-Scholes closed form
+ */
+struct European {
+    /**
+     * @brief Option price
+     *
+     * price = w * (S * N(w * d1) - K * exp(-r * T) * N(w * d2)) with w the
+     * sign of the option type.
+     */
+    template <class Type, class Math>
+    static constexpr double price(const OptionInputs& o) {
+        constexpr double w = Type::SIGN;
+        const double sigma_sqrt_T = o.sigma * Math::sqrt(o.T);
+        const double d1 = (Math::log(o.S / o.K) +
+                           (o.r + o.sigma * o.sigma / 2.0) * o.T) /
+                          sigma_sqrt_T;
+        const double d2 = d1 - sigma_sqrt_T;
+        return w * (o.S * Math::norm_cdf(w * d1) -
+                    o.K * Math::exp(-o.r * o.T) * Math::norm_cdf(w * d2));
+    }
+
+    /**
+     * @brief Option price and analytic sensitivities in one pass
+     */
+    template <class Type, class Math>
+    static constexpr Greeks greeks(const OptionInputs& o) {
+        constexpr double w = Type::SIGN;
+        const double sqrt_T = Math::sqrt(o.T);
+        const double sigma_sqrt_T = o.sigma * sqrt_T;
+        const double d1 = (Math::log(o.S / o.K) +
+                           (o.r + o.sigma * o.sigma / 2.0) * o.T) /
+                          sigma_sqrt_T;
+        const double d2 = d1 - sigma_sqrt_T;
+        const double discounted_K = o.K * Math::exp(-o.r * o.T);
+
+        const double pdf1 = Math::norm_pdf(d1);
+        const double Nd1 = Math::norm_cdf(w * d1);
+        const double Nd2 = Math::norm_cdf(w * d2);
+        const double carry = discounted_K * Nd2;
+
+        Greeks greeks{};
+        greeks.price = w * (o.S * Nd1 - carry);
+        greeks.delta = w * Nd1;
+        greeks.gamma = pdf1 / (o.S * sigma_sqrt_T);
+        greeks.vega = o.S * pdf1 * sqrt_T;
+        greeks.theta =
+            -o.S * pdf1 * o.sigma / (2.0 * sqrt_T) - w * o.r * carry;
+        greeks.rho = w * o.T * carry;
+        greeks.vanna = -pdf1 * d2 / o.sigma;
+        greeks.volga = greeks.vega * d1 * d2 / o.sigma;
+        return greeks;
+    }
+};
+
+/**
+ * @brief Early-exercise boundary of the quadratic approximation
+ */
+struct ExerciseBoundary {
+    double critical; /**< Spot at and beyond which exercise is optimal */
+    double lambda;   /**< Exponent of the early-exercise premium */
+    double h;        /**< 1 - exp(-rT) */
+    double alpha;    /**< 2r / sigma^2 */
+};
+
+/**
+ * @brief American exercise, priced by the Barone-Adesi-Whaley quadratic
+ * approximation
+ *
+ * Without dividends a call is only exercised early when r < 0 and a put
+ * only when r > 0; otherwise the European price is exact and returned.
+ * With T == 0 or sigma == 0 the spot path is known and the price is the
+ * larger of the intrinsic value and the discounted forward payoff.
+ */
+struct American {
+    /** @brief Newton iterations allowed for the critical spot */
+    static constexpr int MAX_CRITICAL_ITERATIONS = 100;
+
+    /**
+     * @brief Solve for the early-exercise boundary
+     *
+     * Requires T > 0, sigma > 0 and early exercise to be possible.
+     */
+    template <class Type, class Math>
+    static constexpr ExerciseBoundary boundary(double K, double T, double r,
+                                               double sigma) {
+        constexpr double w = Type::SIGN;
+        const double alpha = 2.0 * r / (sigma * sigma);
+        const double h = 1.0 - Math::exp(-r * T);
+        const double lambda =
+            (-(alpha - 1.0) +
+             w * Math::sqrt((alpha - 1.0) * (alpha - 1.0) + 4.0 * alpha / h)) /
+            2.0;
+        const double sigma_sqrt_T = sigma * Math::sqrt(T);
+
+        // Barone-Adesi and Whaley's seed from the perpetual boundary. For a
+        // call it is only finite when alpha < -1; its limit otherwise is
+        // K (1 + rT + 2 sigma sqrt(T)), kept above K.
+        const double lambda_inf =
+            (-(alpha - 1.0) +
+             w * Math::sqrt((alpha - 1.0) * (alpha - 1.0) + 4.0 * alpha)) /
+            2.0;
+        double critical = 0.0;
+        if (w < 0 || alpha < -1.0) {
+            const double perpetual = K / (1.0 - 1.0 / lambda_inf);
+            const double e = Math::exp(-(r * T + w * 2.0 * sigma_sqrt_T) *
+                                       K / (perpetual - K));
+            critical = w < 0 ? perpetual + (K - perpetual) * e
+                             : K + (perpetual - K) * (1.0 - e);
+        } else {
+            critical = K * std::max(1.0 + r * T + 2.0 * sigma_sqrt_T,
+                                    1.0 + sigma_sqrt_T);
+        }
+
+        // Newton on w (S - K) - V(S) - w N(-w d1) S / lambda = 0, with each
+        // step kept on the exercise side of K
+        for (int i = 0; i < MAX_CRITICAL_ITERATIONS; ++i) {
+            const double d1 = (Math::log(critical / K) +
+                               (r + sigma * sigma / 2.0) * T) /
+                              sigma_sqrt_T;
+            const double european = European::price<Type, Math>(
+                {critical, K, T, r, sigma});
+            const double far = Math::norm_cdf(-w * d1);
+            const double g =
+                w * (critical - K) - european - w * far * critical / lambda;
+            const double slope =
+                w * far -
+                w * (far - w * Math::norm_pdf(d1) / sigma_sqrt_T) / lambda;
+            double next = critical - g / slope;
+            next = w < 0
+                       ? std::clamp(next, critical / 2.0, (critical + K) / 2.0)
+                       : std::clamp(next, (critical + K) / 2.0, 2.0 * critical);
+            const double step = next - critical;
+            critical = next;
+            if ((step < 0 ? -step : step) <= 1e-12 * K) {
+                break;
+            }
+        }
+        return {critical, lambda, h, alpha};
+    }
+
+    /**
+     * @brief Option price
+     */
+    template <class Type, class Math>
+    static constexpr double price(const OptionInputs& o) {
+        constexpr double w = Type::SIGN;
+        if (o.T == 0 || o.sigma == 0) {
+            const double intrinsic = std::max(w * (o.S - o.K), 0.0);
+            const double forward =
+                std::max(w * (o.S - o.K * Math::exp(-o.r * o.T)), 0.0);
+            return std::max(intrinsic, forward);
+        }
+        if (!(w * o.r < 0)) {
+            return European::price<Type, Math>(o);
+        }
+        const ExerciseBoundary b =
+            boundary<Type, Math>(o.K, o.T, o.r, o.sigma);
+        if (w * (o.S - b.critical) >= 0) {
+            return w * (o.S - o.K);
+        }
+        const double d1 = (Math::log(b.critical / o.K) +
+                           (o.r + o.sigma * o.sigma / 2.0) * o.T) /
+                          (o.sigma * Math::sqrt(o.T));
+        const double premium =
+            w * b.critical * Math::norm_cdf(-w * d1) / b.lambda;
+        return European::price<Type, Math>(o) +
+               premium * Math::exp(b.lambda * Math::log(o.S / b.critical));
+    }
+};
+
+/**
+ * @brief Price one option with the kernel chosen at compile time
+ *
+ * The option type, exercise style and math policy are all template
+ * arguments, so the call has no branches on them and no validation and
+ * inlines into the caller's loop. With ConstexprMath it can be evaluated
+ * by the compiler:
+ *
+ *     constexpr double atm =
+ *         option_price<Call, European, ConstexprMath>({100, 100, 1, 0.05,
+ *                                                      0.2});
+ *
+ * @tparam Type Call or Put
+ * @tparam Exercise European or American
+ * @tparam Math ExactMath, RiskMath, ScreeningMath or ConstexprMath
+ * @param o Option inputs, which must be valid
+ * @return double Option price
+ */
+template <class Type, class Exercise = European, class Math = ExactMath>
+constexpr double option_price(const OptionInputs& o) {
+    return Exercise::template price<Type, Math>(o);
+}
+
+/**
+ * @brief Price and Greeks of one option with the kernel chosen at compile
+ * time
+ *
+ * Only European exercise has analytic Greeks.
+ *
+ * @param o Option inputs, which must be valid
+ * @return Greeks Option price and sensitivities
+ */
+template <class Type, class Exercise = European, class Math = ExactMath>
+constexpr Greeks option_greeks(const OptionInputs& o) {
+    return Exercise::template greeks<Type, Math>(o);
+}
@@ -24,38 +24,109 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "contract_types.h"
+#include "symbol_table.h"
 
 namespace thales {
 
 /**
  * @brief Represents a single options order executed by the trading bot.
+ *
+ * Like Position, an Order is a trivially copyable record of interned IDs,
+ * enums and integer dates; the execution time is kept in nanoseconds since
+ * the Unix epoch. The string-based constructor and getters convert at the
+ * I/O edges.
  */
 class Order {
    public:
-    Order(const std::string& action, const std::string& symbol,
-          const std::string& option_type, double strike_price,
-          const std::string& expiration_date, int quantity, double premium,
-          const std::string& timestamp);
-
-    std::string get_action() const;
-    std::string get_symbol() const;
-    std::string get_option_type() const;
-    double get_strike_price() const;
+    /**
+     * @brief Constructs an Order from its compact representation.
+     * @param side Whether the contracts were bought or sold.
+     * @param symbol The interned symbol of the underlying security.
+     * @param type The type of the option.
+     * @param strike_price The strike price of the option.
+     * @param expiration The expiration date, in days since 1970-01-01.
+     * @param quantity The number of option contracts traded.
+     * @param premium The premium paid per option contract.
+     * @param timestamp The execution time, in nanoseconds since the epoch.
+     */
+    Order(Side side, SymbolId symbol, OptionType type, double strike_price,
+          std::int32_t expiration, int quantity, double premium,
+          std::int64_t timestamp);
+
+    /**
+     * @brief Constructs an Order from display strings.
+     * @param action The action taken (e.g., "Buy" or "Sell").
+     * @param symbol The symbol of the underlying security.
+     * @param option_type The type of the option (e.g., "Call" or "Put").
+     * @param strike_price The strike price of the option.
+     * @param expiration_date The expiration date ("YYYY-MM-DD").
+     * @param quantity The number of option contracts traded.
+     * @param premium The premium paid per option contract.
+     * @param timestamp The ISO 8601 UTC execution time.
+     * @throws std::invalid_argument If any string field is invalid.
+     */
+    Order(std::string_view action, std::string_view symbol,
+          std::string_view option_type, double strike_price,
+          std::string_view expiration_date, int quantity, double premium,
+          std::string_view timestamp);
+
+    Side get_side() const { return side; }
+    SymbolId get_symbol_id() const { return symbol; }
+    OptionType get_type() const { return type; }
+    double get_strike_price() const { return strike_price; }
+    std::int32_t get_expiration() const { return expiration; }
+    int get_quantity() const { return quantity; }
+    double get_premium() const { return premium; }
+    std::int64_t get_timestamp_ns() const { return timestamp; }
+
+    /**
+     * @brief Gets the display name of the order side.
+     * @return "Buy" or "Sell".
+     */
+    std::string_view get_action() const;
+
+    /**
+     * @brief Gets the symbol of the underlying security.
+     * @return A reference into the symbol table.
+     */
+    const std::string& get_symbol() const;
+
+    /**
+     * @brief Gets the display name of the option type.
+     * @return "Call" or "Put".
+     */
+    std::string_view get_option_type() const;
+
+    /**
+     * @brief Formats the expiration date for display.
+     * @return The expiration date as "YYYY-MM-DD".
+     */
     std::string get_expiration_date() const;
-    int get_quantity() const;
-    double get_premium() const;
+
+    /**
+     * @brief Formats the execution time for display.
+     * @return The ISO 8601 UTC timestamp.
+     */
     std::string get_timestamp() const;
 
    private:
-    std::string action;      /**< The action taken (e.g., Buy or Sell). */
-    std::string symbol;      /**< The symbol of the underlying security. */
-    std::string option_type; /**< The type of the option (e.g., Call or Put). */
+    std::int64_t timestamp;  /**< Execution time (ns since epoch). */
     double strike_price;     /**< The strike price of the option. */
-    std::string expiration_date; /**< The expiration date of the option. */
-    int quantity;                /**< The number of option contracts traded. */
-    double premium;              /**< The premium paid per option contract. */
-    std::string timestamp;       /**< The timestamp of the order execution. */
+    double premium;          /**< The premium paid per option contract. */
+    SymbolId symbol;         /**< The symbol of the underlying security. */
+    std::int32_t expiration; /**< The expiration date (days since epoch). */
+    int quantity;            /**< The number of option contracts traded. */
+    OptionType type;         /**< The type of the option. */
+    Side side;               /**< Whether the contracts were bought or sold. */
 };
 
+static_assert(std::is_trivially_copyable<Order>::value,
+              "Order must stay trivially copyable");
+
 }  // namespace thales
@@ -0,0 +1,405 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "broker_interface.h"
+#include "config/config_store.h"
+#include "option_chain.h"
+#include "portfolio.h"
+#include "strategy.h"
+#include "utils/latency_histogram.h"
+#include "utils/ring_buffer.h"
+#include "utils/thread_affinity.h"
+
+namespace thales {
+
+/**
+ * @brief Pre-trade risk limits.
+ *
+ * Quantities are option contracts; notionals are premium dollars, that is
+ * price times quantity times CONTRACT_MULTIPLIER.
+ */
+struct RiskLimits {
+    int max_order_quantity = 100;           /**< Per order */
+    double max_order_notional = 250000.0;   /**< Per order */
+    int max_position = 500;                 /**< Net, per contract */
+    int max_underlying_position = 2000;     /**< Gross, per underlying */
+    double max_working_notional = 1000000.0; /**< All working orders */
+    double max_orders_per_second = 50.0;    /**< Sustained order rate */
+    int order_burst = 10;                   /**< Orders allowed at once */
+
+    /**
+     * @brief Reads limits from a KEY=VALUE file such as
+     *        config/risk_management.cfg.
+     *
+     * Keys missing from the file keep their defaults.
+     *
+     * @param path The file to read.
+     * @return The limits.
+     * @throws std::runtime_error If the file cannot be opened.
+     * @throws std::invalid_argument If a key is unknown or a value is not a
+     *         positive number.
+     */
+    static RiskLimits load(const std::string& path);
+
+    /** Section of a ConfigSnapshot holding the limits. */
+    static constexpr const char* CONFIG_SECTION = "risk_management";
+
+    /**
+     * @brief Reads limits from the CONFIG_SECTION of a configuration
+     *        snapshot, such as Config::store().current().
+     *
+     * Keys missing from the section keep their defaults.
+     *
+     * @throws std::invalid_argument If a key is unknown or a value is not a
+     *         positive number.
+     */
+    static RiskLimits load(const ConfigSnapshot& config);
+};
+
+/**
+ * @enum RejectReason
+ * @brief Why pre-trade risk refused an order.
+ */
+enum class RejectReason : std::uint8_t {
+    NONE,             /**< Accepted */
+    INVALID,          /**< Non-positive quantity or no usable price */
+    UNKNOWN_CONTRACT, /**< Contract not in the listed universe */
+    ORDER_QUANTITY,   /**< Order larger than max_order_quantity */
+    ORDER_NOTIONAL,   /**< Order larger than max_order_notional */
+    POSITION_LIMIT,   /**< Contract could exceed max_position */
+    UNDERLYING_LIMIT, /**< Underlying could exceed max_underlying_position */
+    WORKING_NOTIONAL, /**< Working orders would exceed the limit */
+    RATE_LIMIT        /**< Order rate above max_orders_per_second */
+};
+
+/**
+ * @brief Gets the display name of a reject reason.
+ * @param reason The reject reason.
+ * @return A name such as "position limit".
+ */
+std::string_view to_string(RejectReason reason);
+
+/**
+ * @class PreTradeRisk
+ * @brief Checks orders against risk limits using running exposure totals.
+ *
+ * Exposure is maintained incrementally as orders are accepted, filled and
+ * released, so a check is a few hash lookups and comparisons regardless of
+ * portfolio size. Limits are checked against the worst case in which every
+ * working order fills. Not thread-safe: OrderManager drives it from its own
+ * thread.
+ */
+class PreTradeRisk {
+   public:
+    /**
+     * @brief Creates a book with no positions or working orders.
+     * @param limits The limits to enforce.
+     * @param resource Resource the exposure tables are allocated from.
+     */
+    explicit PreTradeRisk(
+        const RiskLimits& limits,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    const RiskLimits& get_limits() const { return limits; }
+
+    /**
+     * @brief Restricts orders to listed contracts.
+     * @param listed Index of the tradable contracts, or null to allow any;
+     *        must outlive its use here.
+     */
+    void set_universe(const OptionChainIndex* listed) { universe = listed; }
+
+    /**
+     * @brief Adds the positions of a portfolio to the filled exposure.
+     * @param portfolio The portfolio whose positions are already held.
+     */
+    void load(const Portfolio& portfolio);
+
+    /**
+     * @brief Adds a held position to the filled exposure.
+     * @param contract The contract held.
+     * @param quantity Contracts held; negative if short.
+     */
+    void add_position(const ContractKey& contract, int quantity);
+
+    /**
+     * @brief Checks an order without changing any exposure.
+     * @param order The order.
+     * @param price The price the order is valued at.
+     * @param now_ns Steady-clock time, for the rate limit.
+     * @return NONE, or the first limit the order breaks.
+     */
+    RejectReason check(const OrderRequest& order, double price,
+                       std::int64_t now_ns) const;
+
+    /**
+     * @brief Books a checked order as working.
+     * @param order The order, which check() accepted.
+     * @param price The price the order is valued at.
+     * @param now_ns Steady-clock time, for the rate limit.
+     */
+    void accept(const OrderRequest& order, double price, std::int64_t now_ns);
+
+    /**
+     * @brief Moves part of a working order into the filled position.
+     * @param order The working order.
+     * @param quantity Contracts filled.
+     * @param price The price the order was accepted at.
+     */
+    void fill(const OrderRequest& order, int quantity, double price);
+
+    /**
+     * @brief Removes part of a working order that will not fill.
+     * @param order The working order.
+     * @param quantity Contracts cancelled or rejected.
+     * @param price The price the order was accepted at.
+     */
+    void release(const OrderRequest& order, int quantity, double price);
+
+    /** @brief Gets the filled net position in a contract. */
+    int position(const ContractKey& contract) const;
+
+    /** @brief Gets the working contracts on one side of a contract. */
+    int working(const ContractKey& contract, Side side) const;
+
+    /**
+     * @brief Gets the gross exposure of an underlying: filled contracts
+     *        held long or short plus every working contract.
+     */
+    int underlying_exposure(SymbolId underlying) const;
+
+    /** @brief Gets the premium of every working order. */
+    double working_notional() const { return notional; }
+
+   private:
+    /** Filled and working contracts of one contract. */
+    struct Exposure {
+        int position = 0;
+        int buying = 0;
+        int selling = 0;
+    };
+
+    /** Rate limit tokens available at a time. */
+    double tokens_at(std::int64_t now_ns) const;
+
+    Exposure& exposure(const ContractKey& contract);
+    int& underlying(SymbolId symbol);
+    void close_working(const OrderRequest& order, int quantity, double price);
+
+    RiskLimits limits;
+    const OptionChainIndex* universe = nullptr;
+    std::pmr::unordered_map<ContractKey, Exposure, ContractKeyHash> contracts;
+    std::pmr::vector<int> underlyings;
+    double notional = 0.0;
+    std::size_t working_orders = 0;
+    double tokens;
+    std::int64_t refilled_ns = 0;
+};
+
+/**
+ * @enum OrderStatus
+ * @brief State of an order after an event.
+ */
+enum class OrderStatus : std::uint8_t {
+    SENT,             /**< Passed risk and sent to the broker */
+    RISK_REJECTED,    /**< Refused by pre-trade risk */
+    PARTIALLY_FILLED, /**< Some contracts filled, the rest working */
+    FILLED,           /**< Every contract filled */
+    CANCELLED,        /**< The broker cancelled the unfilled rest */
+    BROKER_REJECTED   /**< The broker refused the unfilled rest */
+};
+
+/**
+ * @brief Change to an order, as delivered to the order listener.
+ */
+struct OrderUpdate {
+    std::uint64_t order_id;  /**< Order manager ID */
+    OrderStatus status;      /**< State after the event */
+    RejectReason reason;     /**< Why risk refused it, if it did */
+    OrderRequest request;    /**< The order */
+    int filled_quantity;     /**< Contracts filled so far */
+    int last_quantity;       /**< Contracts filled by this event */
+    double last_price;       /**< Price of this event's fill */
+};
+
+/**
+ * @class OrderManager
+ * @brief Order management thread between strategies and a broker.
+ *
+ * Strategies on any thread submit orders into a lock-free MPSC queue. The
+ * manager thread pops them, runs pre-trade risk and sends accepted orders
+ * to the broker; executions come back through a second MPSC queue and
+ * update the risk exposure. Nothing on this path locks, and once the
+ * working-order table has warmed up nothing allocates.
+ *
+ * The manager measures tick-to-order latency, from the market data
+ * timestamp passed to submit() to the moment the order is handed to the
+ * broker, and the part of it spent between submit() and the broker.
+ */
+class OrderManager {
+   public:
+    /** Called on the manager thread for every order event. */
+    using Listener = std::function<void(const OrderUpdate&)>;
+
+    /** Default capacity of the order and execution queues. */
+    static constexpr std::size_t DEFAULT_CAPACITY = 4096;
+
+    /**
+     * @brief Creates a stopped order manager.
+     * @param limits The pre-trade risk limits.
+     * @param broker Where accepted orders are sent.
+     * @param listener Called for every order event; may be empty.
+     * @param capacity Size of each queue; a power of two.
+     * @throws std::invalid_argument If capacity is not a power of two.
+     */
+    OrderManager(const RiskLimits& limits, BrokerAdapter& broker,
+                 Listener listener = {},
+                 std::size_t capacity = DEFAULT_CAPACITY);
+
+    OrderManager(const OrderManager&) = delete;
+    OrderManager& operator=(const OrderManager&) = delete;
+
+    /** @brief Stops the manager thread. */
+    ~OrderManager();
+
+    /**
+     * @brief Sets the CPUs and idle strategy of the manager thread.
+     *
+     * Takes effect at the next start(). By default the thread is unpinned
+     * and spins for 1000 empty polls before it starts yielding.
+     */
+    void set_placement(const ThreadPlacement& placement);
+
+    /** @brief Starts the manager thread; does nothing if running. */
+    void start();
+
+    /**
+     * @brief Processes every queued order and report, then stops the
+     *        manager thread.
+     */
+    void stop();
+
+    /**
+     * @brief Queues an order; safe from any thread.
+     * @param order The order.
+     * @param reference_price Price the order is valued at when it has no
+     *        limit, such as the strategy's mark.
+     * @param tick_ns Steady-clock time of the market data the order reacts
+     *        to (see steady_now_ns()).
+     * @return The order ID, or 0 if the queue is full.
+     */
+    std::uint64_t submit(const OrderRequest& order, double reference_price,
+                         std::int64_t tick_ns);
+
+    /**
+     * @brief Queues a broker execution report; safe from any thread.
+     * @return False if the queue is full; the caller should retry.
+     */
+    bool report(const ExecutionReport& execution);
+
+    /**
+     * @brief Gets the risk book.
+     *
+     * Only safe to use while the manager is stopped, for example to load
+     * the held portfolio before starting.
+     */
+    PreTradeRisk& risk() { return book; }
+    const PreTradeRisk& risk() const { return book; }
+
+    /** @brief Latency from market data to the broker handoff. */
+    const LatencyHistogram& tick_to_order() const { return tick_latency; }
+
+    /** @brief Latency from submit() to the broker handoff. */
+    const LatencyHistogram& submit_to_send() const { return send_latency; }
+
+    /** @brief Gets the number of orders sent to the broker. */
+    std::uint64_t sent() const {
+        return sent_count.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Gets the number of orders refused by pre-trade risk. */
+    std::uint64_t rejected() const {
+        return rejected_count.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Gets the number of orders still working at the broker. */
+    std::size_t working_orders() const {
+        return working_count.load(std::memory_order_relaxed);
+    }
+
+   private:
+    /** An order on its way from submit() to the manager thread. */
+    struct Ticket {
+        std::uint64_t id;
+        OrderRequest request;
+        double reference_price;
+        std::int64_t tick_ns;
+        std::int64_t submit_ns;
+    };
+
+    /** An order sent to the broker and not yet done. */
+    struct Working {
+        OrderRequest request;
+        double price;
+        int filled;
+    };
+
+    void run();
+    bool poll();
+    void process(const Ticket& ticket);
+    void apply(const ExecutionReport& execution);
+    void notify(const OrderUpdate& update);
+
+    MpscRingBuffer<Ticket> orders;
+    MpscRingBuffer<ExecutionReport> executions;
+    BrokerAdapter& broker;
+    Listener listener;
+    std::pmr::unsynchronized_pool_resource pool;
+    PreTradeRisk book;
+    std::pmr::unordered_map<std::uint64_t, Working> working;
+    LatencyHistogram tick_latency;
+    LatencyHistogram send_latency;
+    std::atomic<std::uint64_t> next_id{1};
+    std::atomic<std::uint64_t> sent_count{0};
+    std::atomic<std::uint64_t> rejected_count{0};
+    std::atomic<std::size_t> working_count{0};
+    ThreadPlacement placement;
+    std::atomic<bool> running{false};
+    std::thread thread;
+};
+
+}  // namespace thales
@@ -24,39 +24,345 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
 #include <vector>
+
+#include "black_scholes.h"
+#include "order.h"
 #include "position.h"
 
 namespace thales {
 
+class ThreadPool;
+class VolSurface;
+
+/**
+ * @brief Number of shares controlled by one option contract.
+ */
+constexpr double CONTRACT_MULTIPLIER = 100.0;
+
+/**
+ * @brief Market inputs used to revalue a portfolio.
+ *
+ * Spots and volatilities are indexed by SymbolId, so every underlying held
+ * in the portfolio needs an entry. An underlying with a non-null entry in
+ * surfaces takes each position's volatility from that surface at the
+ * position's strike and expiry instead of the flat volatility.
+ */
+struct MarketData {
+    std::vector<double> spot;       /**< Spot price per underlying */
+    std::vector<double> volatility; /**< Volatility per underlying */
+    double rate = 0.0;              /**< Risk-free interest rate */
+    std::int32_t valuation_date = 0; /**< Valuation date (days since epoch) */
+    std::vector<const VolSurface*> surfaces; /**< Optional smile per symbol */
+};
+
+/**
+ * @brief Aggregated risk of every position on one underlying.
+ *
+ * Values are in currency and already scaled by quantity and
+ * CONTRACT_MULTIPLIER, so delta is a share-equivalent position.
+ */
+struct UnderlyingRisk {
+    double value = 0.0; /**< Mark-to-market value */
+    double delta = 0.0; /**< dV/dS */
+    double gamma = 0.0; /**< d2V/dS2 */
+    double vega = 0.0;  /**< dV/dsigma */
+    double theta = 0.0; /**< -dV/dT, per year */
+};
+
 /**
  * @class Portfolio
  * @brief Represents a portfolio of options positions.
+ *
+ * Positions are stored column-wise (one array per field) so that aggregate
+ * queries stream through contiguous memory and feed the batch pricing
+ * kernels directly. Positions whose expiration is before the valuation date
+ * are treated as settled and contribute nothing to the aggregates; an
+ * option expires at the end of its expiration date.
+ *
+ * The columns are allocated from a std::pmr::memory_resource, so a
+ * per-cycle portfolio can live in an Arena. Copies allocate from the
+ * default resource and moves keep the source's; assigning between
+ * portfolios on different resources copies the positions into the
+ * target's storage.
  */
 class Portfolio {
 public:
+    class Positions;
+
+    /**
+     * @brief Constructs an empty Portfolio.
+     * @param net_liquidity The net liquidity of the portfolio.
+     * @param resource Resource the position columns are allocated from.
+     */
+    explicit Portfolio(
+        double net_liquidity = 0.0,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
     /**
      * @brief Constructs a Portfolio object.
      * @param net_liquidity The net liquidity of the portfolio.
      * @param positions The positions held in the portfolio.
+     * @param resource Resource the position columns are allocated from.
      */
-    Portfolio(double net_liquidity, const std::vector<Position>& positions);
+    Portfolio(
+        double net_liquidity, const std::vector<Position>& positions,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
     /**
      * @brief Gets the net liquidity of the portfolio.
+     *
+     * This is the book value, with every position marked at its premium.
+     *
      * @return The net liquidity.
      */
     double get_net_liquidity() const;
 
     /**
      * @brief Gets the positions held in the portfolio.
-     * @return The positions.
+     * @return A lightweight view that rebuilds Position records on access.
+     */
+    Positions get_positions() const;
+
+    /**
+     * @brief Appends a position to the portfolio.
+     * @param position The position to add.
+     */
+    void add_position(const Position& position);
+
+    /**
+     * @brief Changes the holding of a position in place.
+     *
+     * Lets a ledger track fills without rebuilding the portfolio; the
+     * contract of the position is unchanged.
+     *
+     * @param index Index of the position, in insertion order.
+     * @param quantity The new number of contracts held.
+     * @param premium The new premium per contract (e.g., average cost).
+     */
+    void set_position(std::size_t index, int quantity, double premium);
+
+    /**
+     * @brief Sets the net liquidity of the portfolio.
+     * @param value The book value, with every position at its premium.
+     */
+    void set_net_liquidity(double value) { net_liquidity = value; }
+
+    /**
+     * @brief Reserves storage for a number of positions.
+     * @param capacity The number of positions to reserve room for.
+     */
+    void reserve(std::size_t capacity);
+
+    /**
+     * @brief Gets the number of positions held in the portfolio.
+     * @return The number of positions.
+     */
+    std::size_t size() const { return strikes.size(); }
+
+    /**
+     * @brief Gets one position of the portfolio.
+     * @param index Index of the position, in insertion order.
+     * @return The position.
+     */
+    Position get_position(std::size_t index) const;
+
+    /**
+     * @brief Gets the resource the position columns are allocated from.
+     * @return The memory resource given at construction.
+     */
+    std::pmr::memory_resource* get_resource() const {
+        return strikes.get_allocator().resource();
+    }
+
+    const std::pmr::vector<SymbolId>& get_symbol_ids() const {
+        return symbols;
+    }
+    const std::pmr::vector<OptionType>& get_types() const { return types; }
+    const std::pmr::vector<double>& get_strikes() const { return strikes; }
+    const std::pmr::vector<std::int32_t>& get_expirations() const {
+        return expirations;
+    }
+    const std::pmr::vector<int>& get_quantities() const { return quantities; }
+    const std::pmr::vector<double>& get_premiums() const { return premiums; }
+
+    /**
+     * @brief Calculates the mark-to-market value of all positions.
+     * @param market The market to revalue against.
+     * @return The sum of model value times quantity and multiplier.
+     * @throws std::invalid_argument If the market does not cover every
+     *         underlying or holds invalid inputs.
      */
-    const std::vector<Position>& get_positions() const;
+    double calculate_market_value(const MarketData& market) const;
+
+    /**
+     * @brief Calculates the mark-to-market value on a thread pool.
+     * @param market The market to revalue against.
+     * @param pool The pool to split the positions across.
+     * @return The sum of model value times quantity and multiplier.
+     * @throws std::invalid_argument If the market is invalid.
+     */
+    double calculate_market_value(const MarketData& market,
+                                  ThreadPool& pool) const;
+
+    /**
+     * @brief Calculates the net liquidity with positions marked to market.
+     *
+     * Replaces each position's premium mark in get_net_liquidity() with its
+     * model value.
+     *
+     * @param market The market to revalue against.
+     * @return The marked-to-market net liquidity.
+     * @throws std::invalid_argument If the market is invalid.
+     */
+    double calculate_net_liquidity(const MarketData& market) const;
+
+    /**
+     * @brief Aggregates value and Greeks per underlying.
+     * @param market The market to revalue against.
+     * @param risk Receives one entry per underlying, indexed by SymbolId;
+     *             resized to market.spot.size().
+     * @throws std::invalid_argument If the market is invalid.
+     */
+    void calculate_risk(const MarketData& market,
+                        std::vector<UnderlyingRisk>& risk) const;
+
+    /**
+     * @brief Aggregates value and Greeks per underlying on a thread pool.
+     *
+     * Each worker accumulates into its own totals, which are summed once
+     * every chunk of positions has been revalued.
+     *
+     * @param market The market to revalue against.
+     * @param risk Receives one entry per underlying, indexed by SymbolId.
+     * @param pool The pool to split the positions across.
+     * @throws std::invalid_argument If the market is invalid.
+     */
+    void calculate_risk(const MarketData& market,
+                        std::vector<UnderlyingRisk>& risk,
+                        ThreadPool& pool) const;
+
+    /**
+     * @brief Calculates the P&L of moving every spot by the same fraction.
+     * @param market The market to revalue against.
+     * @param spot_move Relative spot move (e.g., -0.1 for a 10% drop).
+     * @return The change in mark-to-market value.
+     * @throws std::invalid_argument If the market is invalid or the move
+     *         is not above -1.
+     */
+    double calculate_spot_move_pnl(const MarketData& market,
+                                   double spot_move) const;
+
+    /**
+     * @brief Calculates the P&L of a spot move on a thread pool.
+     * @param market The market to revalue against.
+     * @param spot_move Relative spot move (e.g., -0.1 for a 10% drop).
+     * @param pool The pool to split the positions across.
+     * @return The change in mark-to-market value.
+     * @throws std::invalid_argument If the market or move is invalid.
+     */
+    double calculate_spot_move_pnl(const MarketData& market, double spot_move,
+                                   ThreadPool& pool) const;
+
+private:
+    double net_liquidity;  /**< The net liquidity of the portfolio */
+    std::pmr::vector<SymbolId> symbols;    /**< Underlying of each position */
+    std::pmr::vector<OptionType> types;    /**< Option type of each position */
+    std::pmr::vector<double> strikes;      /**< Strike of each position */
+    std::pmr::vector<std::int32_t> expirations; /**< Expiration (days) */
+    std::pmr::vector<int> quantities;      /**< Contracts held */
+    std::pmr::vector<double> premiums;     /**< Premium per contract */
+    std::size_t symbol_count = 0; /**< One past the largest SymbolId held */
+};
+
+/**
+ * @brief Read-only range over the positions of a Portfolio.
+ *
+ * Elements are returned by value since positions are not stored as records.
+ * The view is invalidated when positions are added to the portfolio.
+ */
+class Portfolio::Positions {
+public:
+    class const_iterator {
+    public:
+        const_iterator(const Portfolio* portfolio, std::size_t index)
+            : portfolio(portfolio), index(index) {}
+        Position operator*() const { return portfolio->get_position(index); }
+        const_iterator& operator++() {
+            ++index;
+            return *this;
+        }
+        bool operator==(const const_iterator& other) const {
+            return index == other.index;
+        }
+        bool operator!=(const const_iterator& other) const {
+            return index != other.index;
+        }
+
+    private:
+        const Portfolio* portfolio;
+        std::size_t index;
+    };
+
+    explicit Positions(const Portfolio& portfolio) : portfolio(&portfolio) {}
+
+    std::size_t size() const { return portfolio->size(); }
+    bool empty() const { return size() == 0; }
+    Position operator[](std::size_t index) const {
+        return portfolio->get_position(index);
+    }
+    const_iterator begin() const { return const_iterator(portfolio, 0); }
+    const_iterator end() const { return const_iterator(portfolio, size()); }
 
 private:
-    double net_liquidity;       /**< The net liquidity of the portfolio */
-    std::vector<Position> positions; /**< The positions held in the portfolio */
+    const Portfolio* portfolio;
 };
 
+/**
+ * @brief Books a trade against a holding at average cost.
+ *
+ * Trades that add to the holding move the average price; trades that
+ * reduce it realize P&L against the average, and a trade that flips the
+ * holding through flat opens the remainder at the trade price.
+ *
+ * @param quantity Contracts held; updated.
+ * @param average Average price of the holding; updated.
+ * @param traded Contracts traded; negative for sales.
+ * @param price Trade price per contract.
+ * @return The realized P&L, scaled by CONTRACT_MULTIPLIER.
+ */
+double book_trade(int& quantity, double& average, int traded, double price);
+
+/**
+ * @brief Fetches the current portfolio information.
+ * @param resource Resource the portfolio is allocated from, e.g. the
+ *                 Arena of the current cycle.
+ * @return The current portfolio.
+ */
+Portfolio fetch_portfolio(
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+/**
+ * @brief Fetches the list of recently executed orders.
+ * @param resource Resource the list is allocated from.
+ * @return A list of recently executed orders.
+ */
+std::pmr::vector<Order> fetch_orders(
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+/**
+ * @brief Displays the portfolio information.
+ * @param portfolio The portfolio to display.
+ */
+void display_portfolio(const Portfolio& portfolio);
+
+/**
+ * @brief Displays the list of recently executed orders.
+ * @param orders The list of orders to display.
+ */
+void display_orders(const std::pmr::vector<Order>& orders);
+
 }  // namespace thales
@@ -24,33 +24,87 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "contract_types.h"
+#include "symbol_table.h"
 
 namespace thales {
 
 /**
  * @brief Represents a single position in the portfolio.
+ *
+ * Positions are stored compactly: the symbol is an interned ID, the
+ * expiration date is a day count since 1970-01-01 and the option type is an
+ * enum, so a Position is 32 bytes, trivially copyable and never allocates.
+ * The string-based constructor and getters convert at the I/O edges.
  */
 class Position {
    public:
-    Position(const std::string& symbol, const std::string& option_type,
-             double strike_price, const std::string& expiration_date,
+    /**
+     * @brief Constructs a Position from its compact representation.
+     * @param symbol The interned symbol of the underlying security.
+     * @param type The type of the option.
+     * @param strike_price The strike price of the option.
+     * @param expiration The expiration date, in days since 1970-01-01.
+     * @param quantity The number of option contracts held.
+     * @param premium The premium paid per option contract.
+     */
+    Position(SymbolId symbol, OptionType type, double strike_price,
+             std::int32_t expiration, int quantity, double premium);
+
+    /**
+     * @brief Constructs a Position from display strings.
+     * @param symbol The symbol of the underlying security.
+     * @param option_type The type of the option (e.g., "Call" or "Put").
+     * @param strike_price The strike price of the option.
+     * @param expiration_date The expiration date ("YYYY-MM-DD").
+     * @param quantity The number of option contracts held.
+     * @param premium The premium paid per option contract.
+     * @throws std::invalid_argument If the option type or date is invalid.
+     */
+    Position(std::string_view symbol, std::string_view option_type,
+             double strike_price, std::string_view expiration_date,
              int quantity, double premium);
 
-    std::string get_symbol() const;
-    std::string get_option_type() const;
-    double get_strike_price() const;
+    SymbolId get_symbol_id() const { return symbol; }
+    OptionType get_type() const { return type; }
+    double get_strike_price() const { return strike_price; }
+    std::int32_t get_expiration() const { return expiration; }
+    int get_quantity() const { return quantity; }
+    double get_premium() const { return premium; }
+
+    /**
+     * @brief Gets the symbol of the underlying security.
+     * @return A reference into the symbol table.
+     */
+    const std::string& get_symbol() const;
+
+    /**
+     * @brief Gets the display name of the option type.
+     * @return "Call" or "Put".
+     */
+    std::string_view get_option_type() const;
+
+    /**
+     * @brief Formats the expiration date for display.
+     * @return The expiration date as "YYYY-MM-DD".
+     */
     std::string get_expiration_date() const;
-    int get_quantity() const;
-    double get_premium() const;
 
    private:
-    std::string symbol;      /**< The symbol of the underlying security. */
-    std::string option_type; /**< The type of the option (e.g., Call or Put). */
+    SymbolId symbol;         /**< The symbol of the underlying security. */
+    std::int32_t expiration; /**< The expiration date (days since epoch). */
     double strike_price;     /**< The strike price of the option. */
-    std::string expiration_date; /**< The expiration date of the option. */
-    int quantity;                /**< The number of option contracts held. */
-    double premium;              /**< The premium paid per option contract. */
+    double premium;          /**< The premium paid per option contract. */
+    int quantity;            /**< The number of option contracts held. */
+    OptionType type;         /**< The type of the option. */
 };
 
+static_assert(std::is_trivially_copyable<Position>::value,
+              "Position must stay trivially copyable");
+
 }  // namespace thales
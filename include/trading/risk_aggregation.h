@@ -0,0 +1,376 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "config/config_store.h"
+#include "live_portfolio.h"
+#include "portfolio.h"
+
+/**
+ * @file risk_aggregation.h
+ * @brief Firm-wide risk from a book sharded across processes.
+ *
+ * Each shard process books only the positions that shard_of() assigns to
+ * it, keeps them in a LivePortfolio, and a RiskShardPublisher sends its
+ * per-underlying totals to a RiskAggregator. After the first frame only
+ * the underlyings whose totals changed are sent, so traffic follows what
+ * moves, not the size of the book, and no process holds every position.
+ *
+ * Frames are self-delimiting and in native byte order (little-endian on
+ * every supported target):
+ *
+ *     header      FrameHeader, 40 bytes
+ *     account     u16 length + bytes; SNAPSHOT frames only
+ *     names       per new underlying: u32 index, u16 length, bytes
+ *     records     per changed underlying: 64-byte WireRecord
+ *
+ * Underlyings travel by name once per connection and by a shard-assigned
+ * index afterwards, since SymbolIds are only stable within a process.
+ * Records carry a shard's absolute totals for an underlying rather than
+ * differences, so applying one twice is harmless. A SNAPSHOT frame
+ * replaces everything the aggregator holds for the shard; shards send one
+ * on every (re)connect, and the aggregator refuses a DELTA frame whose
+ * sequence number does not follow the previous one, which drops the
+ * connection and so forces a resend.
+ */
+
+namespace thales {
+
+/**
+ * @brief Settings of a shard process and of the aggregator it reports to.
+ */
+struct RiskAggregationSettings {
+    std::string account = "MAIN";   /**< Account this shard books */
+    std::uint32_t shard = 0;        /**< This process's shard */
+    std::uint32_t shard_count = 1;  /**< Shards the account is split into */
+    std::string host = "127.0.0.1"; /**< Aggregator address */
+    std::uint16_t port = 7300;      /**< Aggregator port */
+    /** How often the shard's totals are sent */
+    std::chrono::milliseconds publish_interval{200};
+
+    /**
+     * @brief Configuration section the settings are read from.
+     */
+    static constexpr const char* CONFIG_SECTION = "risk_aggregation";
+
+    /**
+     * @brief Reads settings from the CONFIG_SECTION of a configuration
+     *        snapshot.
+     *
+     * Recognised keys are ACCOUNT, SHARD, SHARD_COUNT, AGGREGATOR_HOST,
+     * AGGREGATOR_PORT and PUBLISH_INTERVAL_MS; missing keys keep their
+     * defaults.
+     *
+     * @param config The configuration.
+     * @return The settings.
+     * @throws std::invalid_argument If a value is out of range.
+     */
+    static RiskAggregationSettings load(const ConfigSnapshot& config);
+};
+
+/**
+ * @brief Gets the shard that books an account's positions on an
+ *        underlying.
+ *
+ * A hash of the names, so every process agrees without coordination.
+ *
+ * @param account The account.
+ * @param underlying The underlying's name.
+ * @param shard_count Number of shards; positive.
+ * @return The shard, in [0, shard_count).
+ */
+std::uint32_t shard_of(std::string_view account, std::string_view underlying,
+                       std::uint32_t shard_count);
+
+/**
+ * @brief Copies the positions of one shard out of a book.
+ *
+ * Cash belongs to shard 0, so the net liquidity of the shards still sums
+ * to the book's.
+ *
+ * @param book The account's whole book.
+ * @param account The account.
+ * @param shard The shard to keep.
+ * @param shard_count Number of shards.
+ * @param resource Resource the shard's columns are allocated from.
+ * @return The shard's positions.
+ * @throws std::invalid_argument If shard is not below shard_count.
+ */
+Portfolio select_shard(
+    const Portfolio& book, std::string_view account, std::uint32_t shard,
+    std::uint32_t shard_count,
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+/**
+ * @class RiskDeltaEncoder
+ * @brief Encodes a shard's per-underlying totals as frames.
+ *
+ * The first frame, and the first after reset(), is a SNAPSHOT of every
+ * underlying the shard holds anything on; later frames are DELTAs holding
+ * only the underlyings whose totals changed since the previous frame.
+ * Frames without records still go out and serve as heartbeats.
+ */
+class RiskDeltaEncoder {
+   public:
+    /**
+     * @param shard The shard's number, unique across the firm.
+     * @param account The account the shard books.
+     */
+    RiskDeltaEncoder(std::uint32_t shard, std::string account);
+
+    /**
+     * @brief Encodes the next frame.
+     * @param underlyings The shard's totals, indexed by SymbolId, e.g. from
+     *        LivePortfolio::snapshot().
+     * @param timestamp_ns When the totals were taken (ns since epoch).
+     * @param frame Receives the frame; replaced.
+     * @return The number of underlyings in the frame.
+     */
+    std::size_t encode(const std::vector<UnderlyingBook>& underlyings,
+                       std::int64_t timestamp_ns, std::string& frame);
+
+    /** @brief Makes the next frame a SNAPSHOT, e.g. after reconnecting. */
+    void reset();
+
+    /** @brief Gets the sequence number of the last frame encoded. */
+    std::uint64_t sequence() const { return next_sequence - 1; }
+
+   private:
+    std::uint32_t shard;
+    std::string account;
+    std::uint64_t next_sequence = 1;
+    bool full = true;
+    std::vector<UnderlyingBook> sent;   /**< As last encoded, by SymbolId */
+    std::vector<std::uint32_t> indices; /**< Wire index, by SymbolId */
+    std::uint32_t next_index = 0;
+};
+
+/**
+ * @brief What the aggregator last heard from one shard.
+ */
+struct ShardStatus {
+    std::uint32_t shard = 0;       /**< Shard number */
+    std::string account;           /**< Account the shard books */
+    std::uint64_t sequence = 0;    /**< Last frame applied */
+    std::int64_t timestamp_ns = 0; /**< When its totals were taken */
+    UnderlyingBook totals;         /**< Sum over its underlyings */
+};
+
+/**
+ * @class RiskAggregator
+ * @brief Firm-wide totals assembled from the frames of every shard.
+ *
+ * Keeps each shard's latest totals per underlying and, for every
+ * underlying a frame touches, re-sums that underlying across shards, so
+ * applying a frame costs O(records x shards) whatever the size of the
+ * book. Thread-safe; frames are applied under a mutex that readers share.
+ */
+class RiskAggregator {
+   public:
+    /** Largest frame accepted, in bytes. */
+    static constexpr std::size_t MAX_FRAME_BYTES = 64 << 20;
+
+    /**
+     * @brief Gets the size of the frame at the start of a byte stream.
+     * @param data Bytes received so far.
+     * @return The frame's size, or 0 if its header is incomplete.
+     * @throws std::invalid_argument If the data does not start with a
+     *         frame header.
+     */
+    static std::size_t frame_size(std::string_view data);
+
+    /**
+     * @brief Applies one frame; all or nothing.
+     * @param frame Exactly one frame.
+     * @throws std::invalid_argument If the frame is malformed, or is a
+     *         DELTA that does not follow the shard's previous frame.
+     */
+    void apply(std::string_view frame);
+
+    /**
+     * @brief Reads the firm-wide totals.
+     * @param totals Receives the totals over every underlying.
+     * @param underlyings Receives one entry per underlying, indexed by
+     *        SymbolId in this process; resized to one past the largest
+     *        SymbolId reported.
+     * @return The number of frames applied so far.
+     */
+    std::uint64_t snapshot(UnderlyingBook& totals,
+                           std::vector<UnderlyingBook>& underlyings) const;
+
+    /** @brief Gets the status of every shard heard from, by shard. */
+    std::vector<ShardStatus> shards() const;
+
+    /**
+     * @brief Gets the age of the oldest shard's totals.
+     * @param now_ns The current time (ns since epoch).
+     * @return The age in ns, or 0 before any shard was heard from.
+     */
+    std::int64_t staleness_ns(std::int64_t now_ns) const;
+
+   private:
+    struct Shard {
+        std::string account;
+        std::uint64_t sequence = 0;
+        std::int64_t timestamp_ns = 0;
+        std::vector<SymbolId> symbols;     /**< By wire index */
+        std::vector<UnderlyingBook> books; /**< By SymbolId */
+    };
+
+    void resum(SymbolId symbol);
+
+    mutable std::mutex mutex;
+    std::map<std::uint32_t, Shard> shard_books;
+    std::vector<UnderlyingBook> firm; /**< By SymbolId */
+    std::uint64_t frames = 0;
+};
+
+/**
+ * @class RiskAggregatorServer
+ * @brief Accepts shard connections over TCP and applies their frames.
+ *
+ * One thread multiplexes every connection with poll(2). A connection that
+ * sends a malformed or out-of-sequence frame is closed; its shard
+ * reconnects and starts over with a SNAPSHOT. The shard's last totals are
+ * kept meanwhile and age in staleness_ns().
+ */
+class RiskAggregatorServer {
+   public:
+    /**
+     * @brief Binds a stopped server.
+     * @param aggregator Where frames are applied; must outlive the server.
+     * @param port Port to listen on; 0 picks a free one.
+     * @param address Local address to listen on.
+     * @throws std::runtime_error If the address cannot be bound.
+     */
+    RiskAggregatorServer(RiskAggregator& aggregator, std::uint16_t port,
+                         const std::string& address = "0.0.0.0");
+
+    /** @brief Stops the server and closes every connection. */
+    ~RiskAggregatorServer();
+
+    RiskAggregatorServer(const RiskAggregatorServer&) = delete;
+    RiskAggregatorServer& operator=(const RiskAggregatorServer&) = delete;
+
+    /** @brief Starts the server thread; does nothing if running. */
+    void start();
+
+    /** @brief Stops the server thread and closes every connection. */
+    void stop();
+
+    /** @brief Gets the port listened on. */
+    std::uint16_t port() const { return listen_port; }
+
+    /** @brief Gets the number of connections accepted so far. */
+    std::uint64_t connections() const {
+        return accepted.load(std::memory_order_relaxed);
+    }
+
+   private:
+    void run();
+    bool receive(int client, std::string& buffer);
+
+    RiskAggregator& aggregator;
+    int listener = -1;
+    std::uint16_t listen_port = 0;
+    std::atomic<std::uint64_t> accepted{0};
+    std::atomic<bool> stopping{false};
+    std::thread thread;
+};
+
+/**
+ * @class RiskShardPublisher
+ * @brief Sends a LivePortfolio's totals to the aggregator periodically.
+ *
+ * A background thread takes a snapshot of the portfolio every publish
+ * interval, encodes it with a RiskDeltaEncoder and writes it to the
+ * aggregator, reconnecting (and resending a SNAPSHOT) whenever the
+ * connection fails. Snapshots never block the portfolio's writer.
+ */
+class RiskShardPublisher {
+   public:
+    /**
+     * @brief Creates a stopped publisher.
+     * @param settings Shard identity, aggregator address and interval.
+     * @param source The shard's positions; must outlive the publisher.
+     */
+    RiskShardPublisher(RiskAggregationSettings settings,
+                       const LivePortfolio& source);
+
+    /** @brief Stops the publisher. */
+    ~RiskShardPublisher();
+
+    RiskShardPublisher(const RiskShardPublisher&) = delete;
+    RiskShardPublisher& operator=(const RiskShardPublisher&) = delete;
+
+    /** @brief Starts the publisher thread; does nothing if running. */
+    void start();
+
+    /** @brief Stops the thread and closes the connection. */
+    void stop();
+
+    /** @brief Gets the number of frames sent. */
+    std::uint64_t frames_sent() const {
+        return sent.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Gets the number of connections made to the aggregator. */
+    std::uint64_t connections() const {
+        return connects.load(std::memory_order_relaxed);
+    }
+
+   private:
+    void run();
+    bool connect();
+    bool send(const std::string& frame);
+    void disconnect();
+
+    RiskAggregationSettings settings;
+    const LivePortfolio& source;
+    RiskDeltaEncoder encoder;
+    int socket_fd = -1; /**< Publisher thread only */
+    std::atomic<std::uint64_t> sent{0};
+    std::atomic<std::uint64_t> connects{0};
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::thread thread;
+};
+
+}  // namespace thales
@@ -0,0 +1,205 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "black_scholes.h"
+#include "math_policy.h"
+#include "portfolio.h"
+#include "symbol_table.h"
+
+namespace thales {
+
+class OptionChainIndex;
+class ThreadPool;
+struct ChainQuery;
+
+/**
+ * @brief Axes of a spot x volatility x time stress grid.
+ *
+ * Every combination of the three axes is one scenario. Spot moves apply to
+ * every underlying at once, as do volatility shifts.
+ */
+struct ScenarioGrid {
+    std::vector<double> spot_moves; /**< Relative moves, e.g. -0.2 for -20% */
+    std::vector<double> vol_shifts; /**< Absolute shifts, e.g. 0.05 */
+    std::vector<int> horizons;      /**< Days after the valuation date */
+
+    /**
+     * @brief Builds an evenly spaced axis.
+     * @param first The first point.
+     * @param last The last point.
+     * @param count The number of points; 1 gives just @p first.
+     * @return The points from first to last inclusive.
+     */
+    static std::vector<double> linear(double first, double last,
+                                      std::size_t count);
+
+    /** @brief Gets the number of scenarios in the grid. */
+    std::size_t size() const {
+        return spot_moves.size() * vol_shifts.size() * horizons.size();
+    }
+};
+
+/**
+ * @brief P&L of a portfolio in every scenario of a grid.
+ *
+ * Scenarios are stored densely with the spot move varying fastest, then
+ * the volatility shift, then the horizon; index() gives the offset.
+ */
+struct ScenarioResult {
+    std::size_t spot_count = 0;    /**< Points on the spot axis */
+    std::size_t vol_count = 0;     /**< Points on the volatility axis */
+    std::size_t horizon_count = 0; /**< Points on the time axis */
+    double base_value = 0.0;       /**< Mark-to-market value today */
+    std::vector<double> pnl;       /**< Portfolio P&L per scenario */
+    /** P&L per scenario for each underlying, indexed by SymbolId first */
+    std::vector<double> underlying_pnl;
+
+    /** @brief Gets the number of scenarios. */
+    std::size_t size() const { return spot_count * vol_count * horizon_count; }
+
+    /** @brief Gets the offset of a scenario in the cubes. */
+    std::size_t index(std::size_t spot, std::size_t vol,
+                      std::size_t horizon) const {
+        return (horizon * vol_count + vol) * spot_count + spot;
+    }
+
+    /** @brief Gets the portfolio P&L of one scenario. */
+    double at(std::size_t spot, std::size_t vol, std::size_t horizon) const {
+        return pnl[index(spot, vol, horizon)];
+    }
+
+    /** @brief Gets the P&L of one underlying's positions in one scenario. */
+    double at(SymbolId id, std::size_t spot, std::size_t vol,
+              std::size_t horizon) const {
+        return underlying_pnl[id * size() + index(spot, vol, horizon)];
+    }
+
+    /**
+     * @brief Gets the most negative P&L over every scenario.
+     * @return The worst loss, or 0 if no scenario loses money.
+     */
+    double worst() const;
+
+    /**
+     * @brief Gets the most negative P&L of one underlying's positions.
+     * @param id The underlying.
+     * @return The worst loss, or 0 if no scenario loses money.
+     */
+    double worst(SymbolId id) const;
+};
+
+/**
+ * @class ScenarioEngine
+ * @brief Revalues a whole portfolio over a stress grid.
+ *
+ * Inputs that only depend on a position and the horizon (log-moneyness,
+ * discount factor, square root of time) are computed once per block of
+ * positions, and those that also depend on the volatility once per shift;
+ * the spot moves are then swept in the SIMD kernels with the block held in
+ * cache. Positions that expire before a horizon are valued at their payoff
+ * under the shocked spot; shocked volatilities are floored at
+ * MIN_VOLATILITY. Volatilities come from the market's surfaces at the
+ * position's strike and current expiry and stay fixed across horizons.
+ */
+class ScenarioEngine {
+public:
+    /** @brief Floor applied to shocked volatilities. */
+    static constexpr double MIN_VOLATILITY = 1e-4;
+
+    /**
+     * @brief Creates an engine for a grid.
+     * @param grid The scenario axes.
+     * @param backend The instruction set of the sweep kernel.
+     * @throws std::invalid_argument If an axis is empty, a spot move is
+     *         not above -1 or a horizon is negative.
+     */
+    explicit ScenarioEngine(ScenarioGrid grid,
+                            SimdBackend backend = SimdBackend::AUTO);
+
+    /** @brief Gets the scenario axes. */
+    const ScenarioGrid& grid() const { return axes; }
+
+    /**
+     * @brief Runs every scenario over a portfolio.
+     * @tparam Math Normal distribution policy of the kernels; the cheaper
+     *         tabulated policies suit large grids.
+     * @param portfolio The positions to revalue.
+     * @param market The base market; its spots set the underlying count.
+     * @return The P&L cube against today's mark-to-market value.
+     * @throws std::invalid_argument If the market does not cover every
+     *         underlying or holds invalid inputs.
+     */
+    template <class Math = ExactMath>
+    ScenarioResult run(const Portfolio& portfolio,
+                       const MarketData& market) const;
+
+    /**
+     * @brief Runs every scenario on a thread pool.
+     *
+     * Work is split both into chunks of positions and across horizons, so
+     * small books still spread over the pool.
+     *
+     * @tparam Math Normal distribution policy of the kernels.
+     * @param portfolio The positions to revalue.
+     * @param market The base market.
+     * @param pool The pool to run on.
+     * @return The P&L cube against today's mark-to-market value.
+     * @throws std::invalid_argument If the market is invalid.
+     */
+    template <class Math = ExactMath>
+    ScenarioResult run(const Portfolio& portfolio, const MarketData& market,
+                       ThreadPool& pool) const;
+
+    /**
+     * @brief Runs every scenario over the positions matching a query.
+     *
+     * Stresses part of a book, e.g. one underlying's December calls,
+     * without revaluing the rest.
+     *
+     * @tparam Math Normal distribution policy of the kernels.
+     * @param portfolio The positions.
+     * @param index Index built from @p portfolio.
+     * @param query The positions to revalue.
+     * @param market The base market.
+     * @return The P&L cube of the selected positions.
+     * @throws std::invalid_argument If the market is invalid.
+     */
+    template <class Math = ExactMath>
+    ScenarioResult run(const Portfolio& portfolio,
+                       const OptionChainIndex& index, const ChainQuery& query,
+                       const MarketData& market) const;
+
+private:
+    ScenarioGrid axes;
+    std::vector<double> spot_factors;     /**< 1 + spot move */
+    std::vector<double> log_spot_factors; /**< log(1 + spot move) */
+    SimdBackend backend;
+};
+
+}  // namespace thales
@@ -0,0 +1,204 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "config/config_store.h"
+#include "option_chain.h"
+#include "order.h"
+#include "portfolio.h"
+#include "vol_surface.h"
+
+namespace thales {
+
+/**
+ * @brief Alignment of every section in a snapshot file, in bytes.
+ */
+constexpr std::size_t SNAPSHOT_ALIGNMENT = 64;
+
+/**
+ * @brief Everything a restart needs before it can price and trade.
+ */
+struct TradingState {
+    std::int64_t timestamp_ns = 0; /**< Capture time (ns since epoch) */
+    Portfolio portfolio;           /**< Positions held */
+    std::vector<Order> orders;     /**< Recently executed orders */
+    OptionChainIndex chain;        /**< Portfolio contracts, by row */
+    std::vector<std::optional<VolSurface>> surfaces; /**< By SymbolId */
+    ConfigSnapshot config;         /**< Configuration in effect */
+};
+
+/**
+ * @brief What reconcile() changed in a restored state.
+ */
+struct ReconcileStats {
+    std::size_t positions_changed = 0; /**< Holdings that moved */
+    std::size_t positions_added = 0;   /**< Contracts new to the book */
+    std::size_t orders_added = 0;      /**< Executions since the snapshot */
+};
+
+/**
+ * @class StateSnapshot
+ * @brief Binary snapshot file of a TradingState.
+ *
+ * The file is a header indexing a fixed set of sections, each
+ * SNAPSHOT_ALIGNMENT aligned and holding fixed-width records in native
+ * byte order: the portfolio's columns as they are kept in memory, the
+ * executed orders, the arrays of the option chain index, every surface's
+ * slices, quotes and tabulated grid, and the configuration as text.
+ * Symbols are stored by name once and re-interned on load, since SymbolIds
+ * are only stable within a process.
+ *
+ * Loading maps the file and copies the columns out with memcpy; surfaces
+ * come back fitted, so nothing is refetched or refitted before the first
+ * price. Files are written next to their destination, synced and renamed
+ * into place, so a crash leaves the previous snapshot intact.
+ */
+class StateSnapshot {
+   public:
+    /**
+     * @brief Writes a snapshot.
+     * @param path The destination file.
+     * @param state The state to persist.
+     * @throws std::runtime_error If the file cannot be written.
+     */
+    static void write(const std::string& path, const TradingState& state);
+
+    /**
+     * @brief Maps a snapshot and restores its state.
+     * @param path The snapshot file.
+     * @param state Receives the state; every part is replaced.
+     * @throws std::runtime_error If the file is missing, was written by an
+     *         incompatible build or is malformed.
+     */
+    static void read(const std::string& path, TradingState& state);
+};
+
+/**
+ * @brief Brings a restored state up to date with the broker.
+ *
+ * Only differences are applied: holdings whose quantity or average cost
+ * differs are set in place, contracts the snapshot did not hold are
+ * appended, and contracts the broker no longer holds are set to zero so
+ * row numbers stay stable. Executions newer than the newest order in the
+ * snapshot are appended. The chain index is rebuilt only if contracts were
+ * added.
+ *
+ * @param state The restored state.
+ * @param broker The broker's current positions.
+ * @param executions The broker's recent executions, oldest first.
+ * @return What was changed.
+ */
+ReconcileStats reconcile(TradingState& state, const Portfolio& broker,
+                         const std::pmr::vector<Order>& executions);
+
+/**
+ * @class StateSnapshotWriter
+ * @brief Writes snapshots periodically on a background thread.
+ *
+ * The state lives in a triple buffer: update() fills the buffer the hot
+ * thread owns and publishes it with one atomic exchange, and the writer
+ * thread takes the latest published buffer with another. Neither side
+ * ever waits for the other, so the hot thread is never held up by file
+ * I/O, and a writer that falls behind skips to the newest state.
+ *
+ * Buffers are reused, so the buffer handed to update() holds an older
+ * state; the callback should assign every part it maintains.
+ */
+class StateSnapshotWriter {
+   public:
+    /**
+     * @brief Creates a stopped writer.
+     * @param path The snapshot file.
+     * @param interval How often a published state is written.
+     */
+    StateSnapshotWriter(std::string path, std::chrono::milliseconds interval);
+
+    /** @brief Writes the latest state and stops. */
+    ~StateSnapshotWriter();
+
+    StateSnapshotWriter(const StateSnapshotWriter&) = delete;
+    StateSnapshotWriter& operator=(const StateSnapshotWriter&) = delete;
+
+    /** @brief Starts the writer thread; does nothing if running. */
+    void start();
+
+    /** @brief Writes the latest published state, then stops the thread. */
+    void stop();
+
+    /**
+     * @brief Fills a buffer and publishes it; one thread only.
+     * @param fill Called with the buffer to fill.
+     */
+    void update(const std::function<void(TradingState&)>& fill);
+
+    /**
+     * @brief Writes the latest published state now, on the calling thread.
+     * @return False if nothing new was published or the write failed.
+     */
+    bool flush();
+
+    /** @brief Gets the number of snapshots written. */
+    std::uint64_t written() const {
+        return writes.load(std::memory_order_relaxed);
+    }
+
+    const std::string& get_path() const { return path; }
+
+   private:
+    /** Set in `middle` while its buffer has not been taken. */
+    static constexpr unsigned FRESH = 4;
+
+    void run();
+
+    std::string path;
+    std::chrono::milliseconds interval;
+    std::array<TradingState, 3> buffers;
+    unsigned back = 0;               /**< Filled by update() */
+    std::atomic<unsigned> middle{1}; /**< Index, plus FRESH */
+    unsigned front = 2;              /**< Written out; guarded by io */
+    std::mutex io;
+    std::atomic<std::uint64_t> writes{0};
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::thread thread;
+};
+
+}  // namespace thales
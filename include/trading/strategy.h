@@ -0,0 +1,416 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "data/tick_store.h"
+#include "order.h"
+#include "portfolio.h"
+
+namespace thales {
+
+class ThreadPool;
+
+/**
+ * @brief Identifies an option contract by its terms.
+ */
+struct ContractKey {
+    SymbolId underlying = INVALID_SYMBOL; /**< Underlying ticker */
+    std::int32_t expiration = 0;          /**< Expiry (days since epoch) */
+    OptionType type = CALL;               /**< Call or put */
+    double strike = 0.0;                  /**< Strike price */
+
+    bool operator==(const ContractKey& other) const {
+        return underlying == other.underlying &&
+               expiration == other.expiration && type == other.type &&
+               strike == other.strike;
+    }
+};
+
+/**
+ * @brief Hash of a ContractKey for unordered containers.
+ */
+struct ContractKeyHash {
+    std::size_t operator()(const ContractKey& key) const noexcept;
+};
+
+/**
+ * @brief One bar of an underlying, as replayed by the backtester.
+ */
+struct BarEvent {
+    SymbolId symbol;           /**< Instrument */
+    std::int64_t timestamp_ns; /**< Bar start (ns since epoch) */
+    double open;               /**< Opening price */
+    double high;               /**< Highest price */
+    double low;                /**< Lowest price */
+    double close;              /**< Closing price */
+    double volume;             /**< Traded volume */
+    double vwap;               /**< Volume-weighted price */
+};
+
+/**
+ * @brief One option quote, as replayed by the backtester.
+ */
+struct OptionQuoteEvent {
+    ContractKey contract;       /**< Quoted contract */
+    std::int64_t timestamp_ns;  /**< Quote time (ns since epoch) */
+    double bid;                 /**< Best bid */
+    double ask;                 /**< Best ask */
+    std::uint32_t bid_size;     /**< Size at the best bid */
+    std::uint32_t ask_size;     /**< Size at the best ask */
+    double implied_volatility;  /**< Vendor implied volatility */
+    double underlying_price;    /**< Underlying spot */
+};
+
+/**
+ * @brief Every event sharing one timestamp, delivered together.
+ */
+struct EventBatch {
+    std::int64_t timestamp_ns = 0;        /**< Common timestamp */
+    std::vector<BarEvent> bars;           /**< Bars, by symbol */
+    std::vector<OptionQuoteEvent> quotes; /**< Option quotes */
+
+    std::size_t size() const { return bars.size() + quotes.size(); }
+};
+
+/**
+ * @class BacktestData
+ * @brief Time range of the tick store, mapped once and shared read-only.
+ *
+ * Nothing is copied out of the files: backtests read the mapped columns
+ * directly, so any number of them can replay the same data concurrently.
+ */
+class BacktestData {
+   public:
+    /**
+     * @brief Files of one trading day.
+     */
+    struct Day {
+        std::int32_t day;                                  /**< Trading day */
+        std::vector<std::pair<SymbolId, BarFile>> bars;    /**< Per symbol */
+        std::vector<std::pair<SymbolId, OptionQuoteFile>> quotes;
+    };
+
+    /**
+     * @brief Maps the bars and option quotes of some symbols.
+     * @param store The tick store.
+     * @param symbols Underlyings to replay.
+     * @param first_day First day to include (days since epoch).
+     * @param last_day Last day to include.
+     * @throws std::invalid_argument If the range is empty.
+     * @throws std::runtime_error If a stored file is malformed.
+     */
+    BacktestData(const TickStore& store,
+                 const std::vector<std::string>& symbols,
+                 std::int32_t first_day, std::int32_t last_day);
+
+    /** @brief Gets the stored days in the range, ascending. */
+    const std::vector<Day>& days() const { return stored_days; }
+
+    /** @brief Gets the total number of events. */
+    std::size_t size() const { return events; }
+
+   private:
+    std::vector<Day> stored_days;
+    std::size_t events = 0;
+};
+
+/**
+ * @brief Size recorded for quotes that do not carry one.
+ */
+constexpr std::uint32_t UNKNOWN_QUOTE_SIZE =
+    std::numeric_limits<std::uint32_t>::max();
+
+/**
+ * @brief Latest quote seen for a contract.
+ *
+ * Sizes are reduced as simulated fills take liquidity, and are
+ * UNKNOWN_QUOTE_SIZE for quotes without sizes.
+ */
+struct QuoteState {
+    double bid;                 /**< Best bid */
+    double ask;                 /**< Best ask */
+    std::uint32_t bid_size;     /**< Size at the best bid */
+    std::uint32_t ask_size;     /**< Size at the best ask */
+    std::int64_t timestamp_ns;  /**< Quote time */
+
+    /** @brief Gets the mid price, or NaN without a two-sided quote. */
+    double mid() const;
+};
+
+/**
+ * @class MarketState
+ * @brief Latest spot per underlying and quote per contract.
+ */
+class MarketState {
+   public:
+    /** @brief Records a bar's close as the underlying's spot. */
+    void update(const BarEvent& bar);
+
+    /** @brief Records a quote and the underlying price it carries. */
+    void update(const OptionQuoteEvent& quote);
+
+    /**
+     * @brief Gets the latest spot of an underlying.
+     * @return The spot, or NaN if none was seen.
+     */
+    double spot(SymbolId symbol) const;
+
+    /**
+     * @brief Gets the latest quote of a contract.
+     * @return The quote, or nullptr if none was seen.
+     */
+    const QuoteState* quote(const ContractKey& contract) const;
+
+    /** @brief Gets the latest quote of a contract for updating. */
+    QuoteState* quote(const ContractKey& contract);
+
+    /** @brief Forgets every spot and quote. */
+    void clear();
+
+   private:
+    void set_spot(SymbolId symbol, double price);
+
+    std::vector<double> spots;
+    std::unordered_map<ContractKey, QuoteState, ContractKeyHash> quotes;
+};
+
+/**
+ * @class Ledger
+ * @brief Cash and positions of a backtest, updated fill by fill.
+ *
+ * Positions are kept in a Portfolio, one row per contract ever traded,
+ * with the quantity and average cost changed in place; the portfolio's net
+ * liquidity tracks cash plus cost basis.
+ */
+class Ledger {
+   public:
+    /**
+     * @brief Creates a ledger holding only cash.
+     * @param cash Starting cash.
+     */
+    explicit Ledger(double cash = 0.0);
+
+    /**
+     * @brief Applies an execution.
+     * @param fill The executed order; its premium is the fill price.
+     * @param commission Fees charged for the execution.
+     * @throws std::invalid_argument If the quantity is not positive.
+     */
+    void apply(const Order& fill, double commission);
+
+    /**
+     * @brief Settles positions that expired before a day at intrinsic value.
+     * @param day The current day (days since epoch).
+     * @param market Source of the underlying spots; positions without a
+     *        known spot settle worthless.
+     */
+    void settle_expired(std::int32_t day, const MarketState& market);
+
+    /**
+     * @brief Gets the signed number of contracts held.
+     */
+    int quantity(const ContractKey& contract) const;
+
+    /**
+     * @brief Values the book with positions at their quoted mids.
+     *
+     * Positions without a two-sided quote are carried at average cost.
+     */
+    double equity(const MarketState& market) const;
+
+    double cash() const { return balance; }
+    double realized_pnl() const { return realized; }
+    double commissions() const { return fees; }
+    const Portfolio& portfolio() const { return book; }
+    const std::vector<Order>& fills() const { return executions; }
+
+   private:
+    void trade(std::size_t row, int quantity, double price);
+
+    Portfolio book;
+    std::unordered_map<ContractKey, std::size_t, ContractKeyHash> rows;
+    std::vector<Order> executions;
+    double balance;
+    double cost_basis = 0.0;
+    double realized = 0.0;
+    double fees = 0.0;
+};
+
+/**
+ * @brief An order placed by a strategy.
+ *
+ * Orders without a limit price trade at the touch; limit orders work until
+ * filled or cancelled.
+ */
+struct OrderRequest {
+    Side side;             /**< Buy or sell */
+    ContractKey contract;  /**< Contract to trade */
+    int quantity;          /**< Contracts, positive */
+    double limit_price = std::numeric_limits<double>::quiet_NaN();
+};
+
+/**
+ * @brief Fill simulation and accounting settings.
+ */
+struct BacktestSettings {
+    double initial_cash = 100000.0;        /**< Starting cash */
+    double commission_per_contract = 0.65; /**< Fees per contract */
+
+    /** Limit fills to the quoted size, leaving the rest working */
+    bool respect_quote_size = true;
+};
+
+/**
+ * @brief Outcome of one backtest.
+ */
+struct BacktestResult {
+    double final_equity = 0.0;       /**< Equity after the last event */
+    double cash = 0.0;               /**< Cash after the last event */
+    double realized_pnl = 0.0;       /**< Realized P&L, before fees */
+    double commissions = 0.0;        /**< Fees paid */
+    double max_drawdown = 0.0;       /**< Largest end-of-day peak to trough */
+    std::size_t events = 0;          /**< Events replayed */
+    std::size_t batches = 0;         /**< Distinct timestamps replayed */
+    std::size_t fills = 0;           /**< Executions */
+    std::vector<std::int32_t> days;  /**< Trading days replayed */
+    std::vector<double> daily_equity; /**< Equity at the end of each day */
+};
+
+class Backtester;
+
+/**
+ * @class Strategy
+ * @brief Trading logic driven by the backtester.
+ */
+class Strategy {
+   public:
+    virtual ~Strategy() = default;
+
+    /** @brief Called once before the first event. */
+    virtual void on_start(Backtester& backtester) { (void)backtester; }
+
+    /**
+     * @brief Called for every batch of same-timestamp events.
+     *
+     * The backtester's market state already includes the batch. Orders
+     * submitted here are filled against later quotes, never this batch's.
+     */
+    virtual void on_events(const EventBatch& batch,
+                           Backtester& backtester) = 0;
+
+    /** @brief Called once after the last event. */
+    virtual void on_finish(Backtester& backtester) { (void)backtester; }
+};
+
+/**
+ * @class Backtester
+ * @brief Replays data through a strategy in time order.
+ *
+ * Each day's files are merged by timestamp, and events sharing a timestamp
+ * are delivered as one batch. Working orders are matched against each new
+ * batch before the strategy sees it: buys fill at the ask and sells at the
+ * bid, limit orders only at or through their limit.
+ */
+class Backtester {
+   public:
+    /**
+     * @brief Creates a backtester.
+     * @param data The data to replay (must outlive the backtester).
+     * @param settings Fill simulation and accounting settings.
+     */
+    explicit Backtester(const BacktestData& data,
+                        const BacktestSettings& settings = {});
+
+    /**
+     * @brief Runs a strategy over the whole data set.
+     *
+     * The market state, ledger and working orders are reset first, so a
+     * backtester can run several strategies in turn.
+     *
+     * @param strategy The strategy.
+     * @return The outcome.
+     */
+    BacktestResult run(Strategy& strategy);
+
+    /**
+     * @brief Places an order.
+     * @param order The order.
+     * @throws std::invalid_argument If the quantity is not positive.
+     */
+    void submit(const OrderRequest& order);
+
+    /** @brief Cancels every working order. */
+    void cancel_orders() { working.clear(); }
+
+    /** @brief Gets the number of working orders. */
+    std::size_t working_orders() const { return working.size(); }
+
+    /** @brief Gets the timestamp of the current batch. */
+    std::int64_t now() const { return timestamp; }
+
+    const MarketState& market() const { return state; }
+    const Ledger& ledger() const { return book; }
+
+   private:
+    void replay_day(const BacktestData::Day& day, Strategy& strategy,
+                    BacktestResult& result);
+    void match_orders();
+
+    const BacktestData& data;
+    BacktestSettings settings;
+    MarketState state;
+    Ledger book;
+    std::vector<OrderRequest> working;
+    EventBatch batch;
+    std::int64_t timestamp = 0;
+};
+
+/**
+ * @brief Runs many strategy configurations over one data set in parallel.
+ * @param data The shared data set.
+ * @param configurations The number of configurations.
+ * @param make_strategy Creates the strategy for a configuration index;
+ *        called from pool workers.
+ * @param pool The pool to run the backtests on.
+ * @param settings Fill simulation and accounting settings.
+ * @return One result per configuration, in index order.
+ */
+std::vector<BacktestResult> run_parameter_sweep(
+    const BacktestData& data, std::size_t configurations,
+    const std::function<std::unique_ptr<Strategy>(std::size_t)>&
+        make_strategy,
+    ThreadPool& pool, const BacktestSettings& settings = {});
+
+}  // namespace thales
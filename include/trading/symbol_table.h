@@ -0,0 +1,77 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+
+namespace thales {
+
+/**
+ * @brief Compact identifier of an interned ticker symbol.
+ */
+using SymbolId = std::uint32_t;
+
+/**
+ * @brief Placeholder for a symbol that is not known (yet).
+ */
+constexpr SymbolId INVALID_SYMBOL = std::numeric_limits<SymbolId>::max();
+
+/**
+ * @class SymbolTable
+ * @brief Process-wide interner mapping ticker symbols to dense integer IDs.
+ *
+ * IDs are assigned in order of first use and stay valid for the lifetime of
+ * the process, so positions and orders can store a 4-byte ID instead of a
+ * std::string. Interning and lookups are thread-safe.
+ */
+class SymbolTable {
+   public:
+    /**
+     * @brief Gets the ID of a symbol, interning it on first use.
+     * @param symbol The ticker symbol.
+     * @return The symbol ID.
+     */
+    static SymbolId intern(std::string_view symbol);
+
+    /**
+     * @brief Gets the ticker symbol of an ID.
+     * @param id An ID returned by intern().
+     * @return The symbol; the reference stays valid for the process lifetime.
+     * @throws std::out_of_range If the ID was never assigned.
+     */
+    static const std::string& name(SymbolId id);
+
+    /**
+     * @brief Gets the number of interned symbols.
+     * @return The number of symbols, which is also the next ID to be assigned.
+     */
+    static std::size_t size();
+};
+
+}  // namespace thales
@@ -0,0 +1,79 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "config/config_store.h"
+#include "utils/thread_affinity.h"
+
+namespace thales {
+
+/**
+ * @brief Where each long-running thread runs and how it waits.
+ *
+ * On a dedicated box, give every latency-critical thread its own isolated
+ * cores (see the isolcpus and nohz_full kernel options) and put the
+ * logging thread on a housekeeping core, so nothing migrates or shares a
+ * core with the hot path. Memory a pinned thread owns should come from
+ * NumaMemoryResource::for_node(placement.node()).
+ *
+ * Defaults leave every thread unpinned and keep the historical waits: the
+ * order manager spins then yields, everything else sleeps.
+ */
+struct ThreadingSettings {
+    /** MarketDataStream thread */
+    ThreadPlacement market_data{{}, {WaitMode::SLEEP}};
+    /** Pricing ThreadPool workers, one per CPU */
+    ThreadPlacement pricing;
+    /** OrderManager thread */
+    ThreadPlacement order_manager;
+    /** Logger writer thread */
+    ThreadPlacement logging;
+    /** Main update loop */
+    ThreadPlacement main_loop{{}, {WaitMode::SLEEP}};
+
+    /**
+     * @brief Configuration section the settings are read from.
+     */
+    static constexpr const char* CONFIG_SECTION = "threading";
+
+    /**
+     * @brief Reads settings from the CONFIG_SECTION of a configuration
+     *        snapshot.
+     *
+     * Recognised keys are MARKET_DATA_CPUS, PRICING_CPUS,
+     * ORDER_MANAGER_CPUS, LOGGING_CPUS and MAIN_LOOP_CPUS, each a CPU list
+     * such as "2-3,6"; MARKET_DATA_WAIT, ORDER_MANAGER_WAIT and
+     * MAIN_LOOP_WAIT, each sleep, busy_poll or spin_then_park; and
+     * SPIN_ITERATIONS and PARK_US, which apply to every wait. Missing keys
+     * keep their defaults.
+     *
+     * @param config The configuration.
+     * @return The settings.
+     * @throws std::invalid_argument If a value is malformed or out of range.
+     */
+    static ThreadingSettings load(const ConfigSnapshot& config);
+};
+
+}  // namespace thales
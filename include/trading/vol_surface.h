@@ -0,0 +1,255 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "black_scholes.h"
+#include "symbol_table.h"
+
+namespace thales {
+
+class OptionChainIndex;
+struct OptionChainColumns;
+
+/**
+ * @brief Number of log-moneyness nodes tabulated per expiry slice.
+ */
+constexpr std::size_t VOL_GRID_POINTS = 64;
+
+/**
+ * @brief Raw SVI parameters of one smile.
+ *
+ * Total implied variance at log-moneyness k = ln(K/F) is
+ * w(k) = a + b (rho (k - m) + sqrt((k - m)^2 + sigma^2)).
+ */
+struct SviParameters {
+    double a = 0.0;     /**< Variance level */
+    double b = 0.0;     /**< Wing slope, >= 0 */
+    double rho = 0.0;   /**< Skew, in [-1, 1] */
+    double m = 0.0;     /**< Smile centre */
+    double sigma = 0.1; /**< ATM curvature, > 0 */
+
+    /** @brief Evaluates the total implied variance. */
+    double total_variance(double k) const;
+};
+
+/**
+ * @brief Fits an SVI smile to total implied variances.
+ *
+ * Uses the quasi-explicit method: for a given (m, sigma) the best
+ * (a, b, rho) solve a 3x3 weighted least-squares problem, which leaves a
+ * two-dimensional Nelder-Mead search. Fewer than five points give a flat
+ * smile at their mean variance.
+ *
+ * @param k Log-moneyness of each point.
+ * @param w Total implied variance (vol^2 T) of each point.
+ * @param weights Weight of each point; null for equal weights.
+ * @param size Number of points.
+ * @param guess Starting (m, sigma), e.g. the previous fit of the slice.
+ * @return The fitted parameters.
+ * @throws std::invalid_argument If there are no points.
+ */
+SviParameters fit_svi(const double* k, const double* w, const double* weights,
+                      std::size_t size, const SviParameters& guess = {});
+
+/**
+ * @brief An implied volatility observation.
+ */
+struct SmileQuote {
+    double strike;      /**< Strike price */
+    double volatility;  /**< Implied volatility */
+    double weight = 1.0; /**< Fit weight, e.g. inverse spread */
+};
+
+/**
+ * @enum SurfaceInterpolation
+ * @brief Interpolation of the tabulated smiles.
+ */
+enum class SurfaceInterpolation {
+    BILINEAR, /**< Linear in log-moneyness and in total variance over time */
+    CUBIC     /**< Catmull-Rom in log-moneyness, linear over time */
+};
+
+/**
+ * @class VolSurface
+ * @brief Implied volatility surface of one underlying, fitted slice by
+ * slice.
+ *
+ * Each expiry holds its quotes, an SVI fit and the fit tabulated on a
+ * uniform log-moneyness grid; the grids of every slice sit in one array,
+ * so lookups touch a few adjacent doubles. Quote updates only mark their
+ * slice stale, and refresh() refits stale slices alone.
+ *
+ * Volatilities are looked up by strike and time to expiry against the
+ * forward S exp(r T); between expiries total variance is interpolated
+ * linearly, and outside the quoted expiries volatility is held flat.
+ */
+class VolSurface {
+   public:
+    /**
+     * @brief Creates an empty surface.
+     * @param spot Underlying spot.
+     * @param rate Risk-free interest rate.
+     * @param interpolation Interpolation of the tabulated smiles.
+     * @throws std::invalid_argument If the spot is not positive.
+     */
+    VolSurface(
+        double spot, double rate,
+        SurfaceInterpolation interpolation = SurfaceInterpolation::CUBIC);
+
+    /**
+     * @brief Moves the spot, keeping smiles in log-moneyness.
+     * @throws std::invalid_argument If the spot is not positive.
+     */
+    void set_spot(double spot);
+
+    double get_spot() const { return spot; }
+    double get_rate() const { return rate; }
+
+    /**
+     * @brief Replaces the quotes of an expiry, adding the slice if needed.
+     * @param expiry Time to expiry in years; slices are matched exactly.
+     * @param quotes The slice's quotes.
+     * @throws std::invalid_argument If the expiry or a quote is invalid.
+     */
+    void set_quotes(double expiry, const std::vector<SmileQuote>& quotes);
+
+    /**
+     * @brief Inserts or replaces the quote of one strike.
+     * @param expiry Time to expiry in years; slices are matched exactly.
+     * @param quote The quote.
+     * @throws std::invalid_argument If the expiry or quote is invalid.
+     */
+    void update_quote(double expiry, const SmileQuote& quote);
+
+    /**
+     * @brief Refits every slice whose quotes changed.
+     * @return The number of slices refitted.
+     */
+    std::size_t refresh();
+
+    /**
+     * @brief Looks up an implied volatility.
+     *
+     * Slices changed since the last refresh() still use their previous
+     * fit, and slices never fitted are skipped.
+     *
+     * @param strike Strike price.
+     * @param expiry Time to expiry in years.
+     * @return The volatility.
+     * @throws std::runtime_error If no slice has been fitted.
+     */
+    double volatility(double strike, double expiry) const;
+
+    /**
+     * @brief Looks up the volatilities of a batch of options.
+     * @param strikes Strike of each option.
+     * @param expiries Time to expiry of each option, in years.
+     * @param vols Receives the volatility of each option.
+     * @param size Number of options.
+     * @throws std::runtime_error If no slice has been fitted.
+     */
+    void volatilities(const double* strikes, const double* expiries,
+                      double* vols, std::size_t size) const;
+
+    /** @brief Gets the number of expiry slices. */
+    std::size_t size() const { return slices.size(); }
+
+    /** @brief Gets the expiry of a slice, in years; slices are sorted. */
+    double expiry(std::size_t slice) const { return slices[slice].expiry; }
+
+    /** @brief Gets the latest SVI fit of a slice. */
+    const SviParameters& parameters(std::size_t slice) const {
+        return slices[slice].fit;
+    }
+
+   private:
+    friend class StateSnapshot;
+
+    struct Slice {
+        double expiry;
+        std::vector<SmileQuote> quotes; /**< Sorted by strike */
+        SviParameters fit;
+        double k_min = 0.0;     /**< First grid node */
+        double k_step = 0.0;    /**< Grid spacing */
+        bool fitted = false;
+        bool stale = true;
+    };
+
+    std::size_t slice_index(double expiry);
+    void fit(std::size_t index);
+    double slice_variance(std::size_t index, double k) const;
+
+    double spot;
+    double rate;
+    SurfaceInterpolation interpolation;
+    std::vector<Slice> slices;
+    std::vector<double> grid; /**< VOL_GRID_POINTS variances per slice */
+    std::vector<std::size_t> fitted; /**< Indices of fitted slices */
+};
+
+/**
+ * @brief Loads an option chain snapshot into a surface.
+ *
+ * Implied volatilities are solved from quote mids in one batch; out-of-
+ * the-money options are used on each side of the forward, weighted by
+ * inverse spread. Slices of the underlying's expirations are replaced and
+ * left stale for refresh().
+ *
+ * @param surface The surface of the underlying.
+ * @param chain The snapshot.
+ * @param underlying The underlying to load.
+ * @param valuation_date Current date (days since epoch); options expire at
+ *        the end of their expiration date.
+ * @return The number of quotes loaded.
+ */
+std::size_t load_option_chain(VolSurface& surface,
+                              const OptionChainColumns& chain,
+                              SymbolId underlying,
+                              std::int32_t valuation_date);
+
+/**
+ * @brief Loads one underlying's quotes from an indexed chain snapshot.
+ *
+ * Same as the full scan, but only the out-of-the-money strike runs of the
+ * underlying's unexpired expiries are visited.
+ *
+ * @param surface The surface of the underlying.
+ * @param chain The snapshot.
+ * @param index Index built from @p chain.
+ * @param underlying The underlying to load.
+ * @param valuation_date Current date (days since epoch).
+ * @return The number of quotes loaded.
+ */
+std::size_t load_option_chain(VolSurface& surface,
+                              const OptionChainColumns& chain,
+                              const OptionChainIndex& index,
+                              SymbolId underlying,
+                              std::int32_t valuation_date);
+
+}  // namespace thales
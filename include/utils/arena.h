@@ -0,0 +1,224 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+
+namespace thales {
+
+/**
+ * @class Arena
+ * @brief Monotonic memory resource for per-cycle scratch data.
+ *
+ * Allocation bumps a pointer through blocks obtained from an upstream
+ * resource and deallocation is a no-op. reset() rewinds to the first block
+ * in constant time but keeps every block, so once a cycle has run at its
+ * peak size later cycles make no upstream allocations at all. Containers
+ * take an Arena through std::pmr::polymorphic_allocator.
+ *
+ * An Arena is not thread-safe; give each thread its own.
+ */
+class Arena : public std::pmr::memory_resource {
+   public:
+    class Scope;
+
+    /**
+     * @brief Creates an empty arena; no memory is taken until first use.
+     * @param block_size Size of the first block; later blocks double.
+     * @param upstream Resource the blocks are obtained from.
+     */
+    explicit Arena(
+        std::size_t block_size = 64 * 1024,
+        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+    /** @brief Returns every block to the upstream resource. */
+    ~Arena() override;
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * @brief Invalidates everything allocated so far, keeping the blocks.
+     *
+     * Objects in the arena are not destroyed; destroy or abandon them
+     * first.
+     */
+    void reset();
+
+    /** @brief Rewinds and returns every block to the upstream resource. */
+    void release();
+
+    /**
+     * @brief Gets the number of bytes handed out since the last reset().
+     * @return The requested sizes summed, excluding alignment padding.
+     */
+    std::size_t used() const { return used_bytes; }
+
+    /**
+     * @brief Gets the number of bytes held in blocks.
+     * @return The total size of the blocks, used or not.
+     */
+    std::size_t capacity() const { return capacity_bytes; }
+
+    /**
+     * @brief Gets the number of blocks obtained from upstream.
+     * @return The block count; it stops changing once the arena is warm.
+     */
+    std::size_t block_count() const { return blocks; }
+
+   private:
+    struct Block {
+        Block* next;
+        std::size_t size; /**< Usable bytes after the header */
+    };
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+    bool do_is_equal(
+        const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    /** @brief Advances to a block with room, adding one if needed. */
+    void next_block(std::size_t bytes, std::size_t alignment);
+
+    std::pmr::memory_resource* upstream;
+    std::size_t next_size;
+    Block* first = nullptr;
+    Block* current = nullptr;
+    char* cursor = nullptr;
+    char* end = nullptr;
+    std::size_t used_bytes = 0;
+    std::size_t capacity_bytes = 0;
+    std::size_t blocks = 0;
+};
+
+/**
+ * @brief Rewinds an arena to where it was when the scope was entered.
+ *
+ * Scopes nest, so a function can borrow a caller's arena for its own
+ * temporaries without disturbing what the caller has already allocated.
+ */
+class Arena::Scope {
+   public:
+    explicit Scope(Arena& arena)
+        : arena(arena),
+          current(arena.current),
+          cursor(arena.cursor),
+          end(arena.end),
+          used_bytes(arena.used_bytes) {}
+
+    ~Scope() {
+        if (current == nullptr) {
+            // Entered before the first block: rewind to the start
+            arena.reset();
+            return;
+        }
+        arena.current = current;
+        arena.cursor = cursor;
+        arena.end = end;
+        arena.used_bytes = used_bytes;
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    Arena& arena;
+    Block* current;
+    char* cursor;
+    char* end;
+    std::size_t used_bytes;
+};
+
+/**
+ * @class CountingResource
+ * @brief Memory resource that counts the allocations it forwards.
+ *
+ * Wrap the upstream of an Arena, or install one with
+ * std::pmr::set_default_resource(), to check that a code path stops
+ * allocating once warm. Counters are atomic, so it may be shared between
+ * threads when its upstream is.
+ */
+class CountingResource : public std::pmr::memory_resource {
+   public:
+    /**
+     * @brief Creates a counter in front of another resource.
+     * @param upstream Resource allocations are forwarded to.
+     */
+    explicit CountingResource(
+        std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : upstream(upstream) {}
+
+    /** @brief Number of allocations since construction or clear(). */
+    std::size_t allocations() const {
+        return allocation_count.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Number of deallocations since construction or clear(). */
+    std::size_t deallocations() const {
+        return deallocation_count.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Bytes allocated since construction or clear(). */
+    std::size_t bytes_allocated() const {
+        return allocated_bytes.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Zeroes the counters. */
+    void clear() {
+        allocation_count.store(0, std::memory_order_relaxed);
+        deallocation_count.store(0, std::memory_order_relaxed);
+        allocated_bytes.store(0, std::memory_order_relaxed);
+    }
+
+   private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        void* p = upstream->allocate(bytes, alignment);
+        allocation_count.fetch_add(1, std::memory_order_relaxed);
+        allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        return p;
+    }
+
+    void do_deallocate(void* p, std::size_t bytes,
+                       std::size_t alignment) override {
+        deallocation_count.fetch_add(1, std::memory_order_relaxed);
+        upstream->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(
+        const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::pmr::memory_resource* upstream;
+    std::atomic<std::size_t> allocation_count{0};
+    std::atomic<std::size_t> deallocation_count{0};
+    std::atomic<std::size_t> allocated_bytes{0};
+};
+
+}  // namespace thales
@@ -0,0 +1,94 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace thales {
+
+/**
+ * @brief Length of a formatted date, "YYYY-MM-DD"
+ */
+constexpr std::size_t DATE_LENGTH = 10;
+
+/**
+ * @brief Length of a formatted timestamp, "YYYY-MM-DDTHH:MM:SS.nnnnnnnnnZ"
+ */
+constexpr std::size_t TIMESTAMP_LENGTH = 30;
+
+/**
+ * @brief Converts an ISO 8601 date to days since 1970-01-01.
+ * @param date The date, formatted as "YYYY-MM-DD".
+ * @return The number of days since the Unix epoch.
+ * @throws std::invalid_argument If the date is malformed.
+ */
+std::int32_t parse_date(std::string_view date);
+
+/**
+ * @brief Writes days since 1970-01-01 as "YYYY-MM-DD" without allocating.
+ * @param days The number of days since the Unix epoch.
+ * @param out Buffer of at least DATE_LENGTH characters (not terminated).
+ */
+void format_date(std::int32_t days, char* out);
+
+/**
+ * @brief Converts days since 1970-01-01 to "YYYY-MM-DD".
+ * @param days The number of days since the Unix epoch.
+ * @return The formatted date.
+ */
+std::string format_date(std::int32_t days);
+
+/**
+ * @brief Converts an ISO 8601 UTC timestamp to nanoseconds since the epoch.
+ * @param timestamp The timestamp, formatted as "YYYY-MM-DDTHH:MM:SS" with an
+ * optional fraction of up to nine digits and an optional trailing "Z".
+ * @return The number of nanoseconds since the Unix epoch.
+ * @throws std::invalid_argument If the timestamp is malformed.
+ */
+std::int64_t parse_timestamp(std::string_view timestamp);
+
+/**
+ * @brief Writes nanoseconds since the epoch as an ISO 8601 UTC timestamp.
+ *
+ * Whole seconds are written as "YYYY-MM-DDTHH:MM:SSZ" (20 characters);
+ * otherwise nine fraction digits are added.
+ *
+ * @param nanoseconds The number of nanoseconds since the Unix epoch.
+ * @param out Buffer of at least TIMESTAMP_LENGTH characters (not terminated).
+ * @return The number of characters written.
+ */
+std::size_t format_timestamp(std::int64_t nanoseconds, char* out);
+
+/**
+ * @brief Converts nanoseconds since the epoch to an ISO 8601 UTC timestamp.
+ * @param nanoseconds The number of nanoseconds since the Unix epoch.
+ * @return The formatted timestamp.
+ */
+std::string format_timestamp(std::int64_t nanoseconds);
+
+}  // namespace thales
@@ -24,15 +24,99 @@
 
 #pragma once
 
+#include <cstddef>
+#include <future>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace thales {
 
+/**
+ * @brief Result of one HTTP request.
+ */
+struct HttpResponse {
+    long status = 0;       /**< HTTP status code, 0 if no response arrived */
+    std::string body;      /**< Response body */
+    std::string error;     /**< Transport error message, empty on success */
+    double latency_us = 0; /**< Time from submission to completion */
+
+    /**
+     * @brief Checks whether the request completed with a 2xx status.
+     * @return True on success.
+     */
+    bool ok() const { return error.empty() && status >= 200 && status < 300; }
+};
+
+/**
+ * @brief Latency percentiles over the most recent requests of a client.
+ */
+struct HttpLatencyStats {
+    std::size_t count = 0; /**< Number of samples */
+    double p50_us = 0;     /**< Median latency */
+    double p90_us = 0;     /**< 90th percentile latency */
+    double p99_us = 0;     /**< 99th percentile latency */
+    double max_us = 0;     /**< Slowest request */
+};
+
+/**
+ * @class HttpClient
+ * @brief Persistent HTTP client with connection reuse and multiplexing.
+ *
+ * All requests run on one background thread driving a curl multi handle, so
+ * TCP and TLS connections are kept alive and reused between calls, and
+ * concurrent requests to the same host are multiplexed over a single
+ * HTTP/2 connection when the server supports it. The client is safe to use
+ * from several threads.
+ */
 class HttpClient {
    public:
-    HttpClient();
+    /**
+     * @brief Starts the I/O thread.
+     * @param max_connections_per_host Connections kept open to one host.
+     */
+    explicit HttpClient(long max_connections_per_host = 8);
+
+    /**
+     * @brief Cancels outstanding requests and stops the I/O thread.
+     */
     ~HttpClient();
+
+    HttpClient(const HttpClient&) = delete;
+    HttpClient& operator=(const HttpClient&) = delete;
+
+    /**
+     * @brief Performs a blocking GET request.
+     * @param url The URL to fetch.
+     * @return The response body.
+     * @throws std::runtime_error On transport errors or a non-2xx status.
+     */
     std::string get(const std::string& url);
+
+    /**
+     * @brief Queues a GET request.
+     * @param url The URL to fetch.
+     * @return A future for the response; errors are reported in it rather
+     *         than thrown.
+     */
+    std::future<HttpResponse> get_async(const std::string& url);
+
+    /**
+     * @brief Fetches several URLs concurrently.
+     * @param urls The URLs to fetch.
+     * @return One response per URL, in the same order.
+     */
+    std::vector<HttpResponse> get_all(const std::vector<std::string>& urls);
+
+    /**
+     * @brief Gets latency percentiles over the most recent requests.
+     * @return Percentiles over up to the last 4096 completed requests.
+     */
+    HttpLatencyStats latency_stats() const;
+
+   private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
 };
 
 }  // namespace thales
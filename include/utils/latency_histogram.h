@@ -0,0 +1,154 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace thales {
+
+/**
+ * @brief Current steady-clock time in nanoseconds.
+ *
+ * The clock latency measurements are taken on; market data timestamps
+ * compared against it must come from the same clock.
+ */
+inline std::int64_t steady_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/**
+ * @class LatencyHistogram
+ * @brief Log-linear histogram of latencies in nanoseconds.
+ *
+ * Values below 16 ns are counted exactly; above that each power of two is
+ * split into 16 buckets, so percentiles are within 6.25% of the recorded
+ * values. Recording is a handful of relaxed atomic stores with no
+ * allocation. One thread records; any thread may read, seeing counts that
+ * are at most a few records stale.
+ */
+class LatencyHistogram {
+   public:
+    /** Buckets per power of two, as a number of bits. */
+    static constexpr int SUB_BUCKET_BITS = 4;
+
+    /** Largest power of two tracked; longer latencies go in the last. */
+    static constexpr int MAX_EXPONENT = 40;
+
+    /** Number of buckets. */
+    static constexpr std::size_t BUCKETS =
+        (MAX_EXPONENT - SUB_BUCKET_BITS + 2) << SUB_BUCKET_BITS;
+
+    LatencyHistogram() { clear(); }
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /**
+     * @brief Records one latency; writer thread only.
+     * @param nanoseconds The latency; negative values count as zero.
+     */
+    void record(std::int64_t nanoseconds) {
+        std::uint64_t value =
+            nanoseconds > 0 ? static_cast<std::uint64_t>(nanoseconds) : 0;
+        bump(counts[bucket(value)], 1);
+        bump(total, 1);
+        bump(sum, value);
+        if (value < smallest.load(std::memory_order_relaxed)) {
+            smallest.store(value, std::memory_order_relaxed);
+        }
+        if (value > largest.load(std::memory_order_relaxed)) {
+            largest.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    /** @brief Adds another histogram's records; writer thread only. */
+    void merge(const LatencyHistogram& other);
+
+    /** @brief Forgets every record; writer thread only. */
+    void clear();
+
+    /** @brief Number of records. */
+    std::uint64_t count() const {
+        return total.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Smallest recorded latency, or 0 if empty. */
+    std::uint64_t min() const;
+
+    /** @brief Largest recorded latency, or 0 if empty. */
+    std::uint64_t max() const {
+        return largest.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Mean latency, or 0 if empty. */
+    double mean() const;
+
+    /**
+     * @brief Gets a percentile of the recorded latencies.
+     * @param percent The percentile, from 0 to 100.
+     * @return The upper edge of the bucket holding the percentile, capped
+     *         at max(); 0 if empty.
+     */
+    std::uint64_t percentile(double percent) const;
+
+    /** @brief Index of the bucket holding a value. */
+    static std::size_t bucket(std::uint64_t value) {
+        constexpr std::uint64_t EXACT = std::uint64_t{1} << SUB_BUCKET_BITS;
+        if (value < EXACT) {
+            return static_cast<std::size_t>(value);
+        }
+        int exponent = 63 - __builtin_clzll(value);
+        if (exponent > MAX_EXPONENT) {
+            return BUCKETS - 1;
+        }
+        int shift = exponent - SUB_BUCKET_BITS;
+        std::size_t sub = (value >> shift) & (EXACT - 1);
+        return ((shift + 1) << SUB_BUCKET_BITS) + sub;
+    }
+
+    /** @brief Largest value counted in a bucket. */
+    static std::uint64_t bucket_upper(std::size_t index);
+
+   private:
+    static void bump(std::atomic<std::uint64_t>& counter,
+                     std::uint64_t amount) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount,
+                      std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<std::uint64_t>, BUCKETS> counts;
+    std::atomic<std::uint64_t> total;
+    std::atomic<std::uint64_t> sum;
+    std::atomic<std::uint64_t> smallest;
+    std::atomic<std::uint64_t> largest;
+};
+
+}  // namespace thales
@@ -24,6 +24,316 @@
 
 #pragma once
 
-#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
-#define LOG(message) std::cout << message << std::endl
+#include "utils/ring_buffer.h"
+
+/**
+ * @file logging.h
+ * @brief Asynchronous binary logger.
+ *
+ * A log call copies a pointer to its call site's static description (level,
+ * location and format string, which doubles as the format ID) and the raw
+ * argument values into a lock-free buffer owned by the calling thread. A
+ * background thread formats the records and writes them out, so the hot
+ * path never formats, locks or makes a system call. Each thread's records
+ * keep their order; records from different threads are merged by timestamp
+ * within each batch the writer drains.
+ *
+ * Formats use "{}" placeholders, filled in order by the arguments:
+ *
+ *     LOG_INFO("Priced {} options in {} us", count, elapsed);
+ *
+ * Arguments may be integers, floating-point numbers, booleans, characters,
+ * enums and strings (copied, so temporaries are safe).
+ *
+ * Calls below THALES_LOG_MIN_LEVEL are removed at compile time, with their
+ * arguments left unevaluated; the others are filtered at run time by
+ * Logger::set_level().
+ */
+
+namespace thales {
+
+/**
+ * @enum LogLevel
+ * @brief Severity of a log record.
+ */
+enum class LogLevel : std::uint8_t {
+    TRACE, /**< Tracing of the hot path */
+    DEBUG, /**< Diagnostics */
+    INFO,  /**< Normal operation */
+    WARN,  /**< Recoverable problems */
+    ERROR, /**< Failures */
+    OFF    /**< Disables logging */
+};
+
+/**
+ * @brief Settings of the process-wide logger.
+ */
+struct LogSettings {
+    std::string path;                /**< Output file; empty for stdout */
+    LogLevel level = LogLevel::INFO; /**< Least severe level written */
+    std::size_t buffer_size = 1 << 20; /**< Per-thread buffer, power of 2 */
+    std::chrono::microseconds flush_interval{1000}; /**< Writer wake-up */
+};
+
+/**
+ * @brief Static description of one log call site.
+ */
+struct LogSite {
+    LogLevel level;     /**< Severity */
+    const char* file;   /**< Source file */
+    int line;           /**< Source line */
+    const char* format; /**< Format with "{}" placeholders */
+};
+
+namespace detail {
+
+/** Type tags written before each argument value. */
+enum class LogArgument : std::uint8_t { INT, UINT, DOUBLE, BOOL, CHAR, STRING };
+
+/** Fixed part of every record. */
+struct LogRecord {
+    const LogSite* site;
+    std::int64_t timestamp_ns;
+    std::uint32_t argument_bytes;
+};
+
+/** Run-time level, read on every call before any work is done. */
+inline std::atomic<LogLevel> log_level{LogLevel::INFO};
+
+/** Buffer of the calling thread, created on its first log call. */
+inline thread_local SpscByteRing* log_buffer = nullptr;
+
+SpscByteRing& register_log_thread();
+void count_dropped_log();
+
+template <typename T>
+constexpr LogArgument argument_type() {
+    using U = std::decay_t<T>;
+    if constexpr (std::is_same_v<U, bool>) {
+        return LogArgument::BOOL;
+    } else if constexpr (std::is_same_v<U, char>) {
+        return LogArgument::CHAR;
+    } else if constexpr (std::is_enum_v<U>) {
+        return argument_type<std::underlying_type_t<U>>();
+    } else if constexpr (std::is_floating_point_v<U>) {
+        return LogArgument::DOUBLE;
+    } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+        return LogArgument::INT;
+    } else if constexpr (std::is_integral_v<U>) {
+        return LogArgument::UINT;
+    } else {
+        static_assert(std::is_convertible_v<const U&, std::string_view>,
+                      "Unsupported log argument type");
+        return LogArgument::STRING;
+    }
+}
+
+template <typename T>
+std::size_t argument_size(const T& value) {
+    if constexpr (argument_type<T>() == LogArgument::STRING) {
+        return 1 + sizeof(std::uint32_t) + std::string_view(value).size();
+    } else {
+        return 1 + sizeof(std::uint64_t);
+    }
+}
+
+template <typename T>
+char* write_argument(char* out, const T& value) {
+    constexpr LogArgument type = argument_type<T>();
+    *out++ = static_cast<char>(type);
+    if constexpr (type == LogArgument::STRING) {
+        std::string_view text(value);
+        auto length = static_cast<std::uint32_t>(text.size());
+        std::memcpy(out, &length, sizeof(length));
+        std::memcpy(out + sizeof(length), text.data(), text.size());
+        return out + sizeof(length) + text.size();
+    } else {
+        std::uint64_t bits = 0;
+        if constexpr (type == LogArgument::DOUBLE) {
+            double number = static_cast<double>(value);
+            std::memcpy(&bits, &number, sizeof(bits));
+        } else if constexpr (type == LogArgument::INT) {
+            bits = static_cast<std::uint64_t>(static_cast<std::int64_t>(value));
+        } else {
+            bits = static_cast<std::uint64_t>(value);
+        }
+        std::memcpy(out, &bits, sizeof(bits));
+        return out + sizeof(bits);
+    }
+}
+
+/**
+ * @brief Encodes one record into the calling thread's buffer.
+ *
+ * Records that do not fit are dropped and counted rather than blocking.
+ */
+template <typename... Args>
+void log(const LogSite* site, const Args&... args) {
+    SpscByteRing* buffer = log_buffer;
+    if (buffer == nullptr) {
+        buffer = &register_log_thread();
+    }
+    std::size_t arguments = (argument_size(args) + ... + 0);
+    char* out = buffer->try_reserve(sizeof(LogRecord) + arguments);
+    if (out == nullptr) {
+        count_dropped_log();
+        return;
+    }
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    LogRecord record{
+        site,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now).count(),
+        static_cast<std::uint32_t>(arguments)};
+    std::memcpy(out, &record, sizeof(record));
+    out += sizeof(record);
+    ((out = write_argument(out, args)), ...);
+    buffer->commit();
+}
+
+}  // namespace detail
+
+/**
+ * @class Logger
+ * @brief Process-wide writer thread draining every thread's log buffer.
+ */
+class Logger {
+   public:
+    /**
+     * @brief Gets the logger, starting its writer thread on first use.
+     */
+    static Logger& instance();
+
+    /**
+     * @brief Changes the output, level and sizes.
+     *
+     * The buffer size applies to threads that log for the first time
+     * afterwards.
+     *
+     * @param settings The new settings.
+     * @throws std::runtime_error If the output file cannot be opened.
+     * @throws std::invalid_argument If the buffer size is not a power of two.
+     */
+    void configure(const LogSettings& settings);
+
+    /** @brief Sets the least severe level written. */
+    void set_level(LogLevel level) {
+        detail::log_level.store(level, std::memory_order_relaxed);
+    }
+
+    /** @brief Gets the least severe level written. */
+    LogLevel level() const {
+        return detail::log_level.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Writes out every record logged so far and flushes the output.
+     */
+    void flush();
+
+    /**
+     * @brief Restricts the writer thread to a set of CPUs, keeping it off
+     *        the cores of latency-critical threads.
+     * @param cpus The CPUs; empty leaves the affinity unchanged.
+     * @throws std::invalid_argument If a CPU number is out of range.
+     * @throws std::runtime_error If the thread cannot be pinned.
+     */
+    void pin_writer(const std::vector<int>& cpus);
+
+    /** @brief Gets the number of records dropped because a buffer was full. */
+    std::uint64_t dropped() const;
+
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+   private:
+    struct State;
+
+    friend SpscByteRing& detail::register_log_thread();
+    friend void detail::count_dropped_log();
+
+    Logger();
+
+    State* state;
+};
+
+/**
+ * @brief Gets the display name of a level ("INFO", ...).
+ */
+std::string_view to_string(LogLevel level);
+
+/**
+ * @brief Formats a record's arguments into its format string.
+ *
+ * Exposed for the writer thread and tests.
+ *
+ * @param format Format with "{}" placeholders.
+ * @param arguments Encoded arguments.
+ * @param size Size of the encoded arguments, in bytes.
+ * @param out Receives the text (appended).
+ */
+void format_log_arguments(const char* format, const char* arguments,
+                          std::size_t size, std::string& out);
+
+}  // namespace thales
+
+/**
+ * @brief Least severe level compiled in (0 = TRACE ... 5 = OFF).
+ */
+#ifndef THALES_LOG_MIN_LEVEL
+#define THALES_LOG_MIN_LEVEL 0
+#endif
+
+namespace thales {
+namespace detail {
+
+/**
+ * @brief Whether calls at a level are compiled in.
+ *
+ * At the default of 0 the comparison would always hold, which -Wtype-limits
+ * reports at every call site, so it is only made when something is removed.
+ */
+constexpr bool log_compiled([[maybe_unused]] LogLevel level) {
+#if THALES_LOG_MIN_LEVEL > 0
+    return static_cast<int>(level) >= THALES_LOG_MIN_LEVEL;
+#else
+    return true;
+#endif
+}
+
+}  // namespace detail
+}  // namespace thales
+
+#define THALES_LOG(level, format, ...)                                      \
+    do {                                                                    \
+        if constexpr (::thales::detail::log_compiled(level)) {             \
+            static constexpr ::thales::LogSite thales_log_site{             \
+                level, __FILE__, __LINE__, format};                         \
+            if (level >= ::thales::detail::log_level.load(                  \
+                             std::memory_order_relaxed)) {                  \
+                ::thales::detail::log(&thales_log_site, ##__VA_ARGS__);     \
+            }                                                               \
+        }                                                                   \
+    } while (0)
+
+#define LOG_TRACE(...) THALES_LOG(::thales::LogLevel::TRACE, __VA_ARGS__)
+#define LOG_DEBUG(...) THALES_LOG(::thales::LogLevel::DEBUG, __VA_ARGS__)
+#define LOG_INFO(...) THALES_LOG(::thales::LogLevel::INFO, __VA_ARGS__)
+#define LOG_WARN(...) THALES_LOG(::thales::LogLevel::WARN, __VA_ARGS__)
+#define LOG_ERROR(...) THALES_LOG(::thales::LogLevel::ERROR, __VA_ARGS__)
+
+/**
+ * @brief Logs at INFO level; kept for existing call sites.
+ */
+#define LOG(...) LOG_INFO(__VA_ARGS__)
@@ -0,0 +1,372 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "utils/latency_histogram.h"
+
+/**
+ * @brief Set to 0 to compile the METRIC_* instrumentation out entirely.
+ */
+#ifndef THALES_METRICS
+#define THALES_METRICS 1
+#endif
+
+namespace thales {
+
+/**
+ * @brief Cheapest timestamp for short intervals: the TSC on x86, else the
+ *        steady clock in nanoseconds.
+ */
+inline std::uint64_t cycle_now() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(steady_now_ns());
+#endif
+}
+
+/**
+ * @brief Nanoseconds per cycle_now() tick.
+ *
+ * Calibrated against the steady clock on first use, which spins for a few
+ * milliseconds; MetricsRegistry does this when it is created.
+ */
+double nanoseconds_per_cycle();
+
+namespace detail {
+
+/** @brief Allocates the slot of a new PerThread in every thread's table. */
+std::size_t next_metric_slot();
+
+/**
+ * @brief Grows the calling thread's table to cover a slot.
+ * @return The table.
+ */
+void** reserve_metric_cells(std::size_t slot);
+
+// Each thread's cells, by PerThread slot. Plain pointers need no thread
+// exit hook; the tables themselves are kept for the life of the process
+inline thread_local void** metric_cells = nullptr;
+inline thread_local std::size_t metric_cell_count = 0;
+
+}  // namespace detail
+
+/**
+ * @class PerThread
+ * @brief One Cell for each thread that touches it.
+ *
+ * local() finds the calling thread's cell with one thread-local vector
+ * index, so each thread writes only its own cell. Cells outlive their
+ * threads, so nothing recorded is lost when a thread exits.
+ */
+template <typename Cell>
+class PerThread {
+   public:
+    PerThread() : slot(detail::next_metric_slot()) {}
+
+    PerThread(const PerThread&) = delete;
+    PerThread& operator=(const PerThread&) = delete;
+
+    /** @brief Gets the calling thread's cell. */
+    Cell& local() {
+        if (slot < detail::metric_cell_count &&
+            detail::metric_cells[slot] != nullptr) {
+            return *static_cast<Cell*>(detail::metric_cells[slot]);
+        }
+        return add_thread();
+    }
+
+    /** @brief Calls fn(cell) for every thread's cell. */
+    template <typename Fn>
+    void for_each(Fn fn) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& cell : all) {
+            fn(static_cast<const Cell&>(*cell));
+        }
+    }
+
+   private:
+    Cell& add_thread() {
+        std::lock_guard<std::mutex> lock(mutex);
+        all.push_back(std::make_unique<Cell>());
+        detail::reserve_metric_cells(slot)[slot] = all.back().get();
+        return *all.back();
+    }
+
+    const std::size_t slot; /**< Never reused, so stale entries are inert */
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<Cell>> all;
+};
+
+/**
+ * @class Counter
+ * @brief Monotonic count, such as requests made or quotes processed.
+ *
+ * Adding is a relaxed load and store on the calling thread's own cache
+ * line; value() sums every thread.
+ */
+class Counter {
+   public:
+    Counter(std::string name, std::string help)
+        : name(std::move(name)), help(std::move(help)) {}
+
+    /** @brief Adds to the count; safe from any thread. */
+    void add(std::uint64_t amount = 1) {
+        std::atomic<std::uint64_t>& cell = cells.local().value;
+        cell.store(cell.load(std::memory_order_relaxed) + amount,
+                   std::memory_order_relaxed);
+    }
+
+    /** @brief Gets the count over every thread. */
+    std::uint64_t value() const;
+
+    const std::string& get_name() const { return name; }
+    const std::string& get_help() const { return help; }
+
+   private:
+    struct alignas(64) Cell {
+        std::atomic<std::uint64_t> value{0};
+    };
+
+    std::string name;
+    std::string help;
+    PerThread<Cell> cells;
+};
+
+/**
+ * @class LatencyMetric
+ * @brief Latency distribution, kept as one LatencyHistogram per thread.
+ */
+class LatencyMetric {
+   public:
+    LatencyMetric(std::string name, std::string help)
+        : name(std::move(name)), help(std::move(help)) {}
+
+    /** @brief Records one latency in nanoseconds; safe from any thread. */
+    void record(std::int64_t nanoseconds) {
+        histograms.local().record(nanoseconds);
+    }
+
+    /**
+     * @brief Merges every thread's records.
+     * @param out Cleared, then receives the records.
+     */
+    void snapshot(LatencyHistogram& out) const;
+
+    const std::string& get_name() const { return name; }
+    const std::string& get_help() const { return help; }
+
+   private:
+    std::string name;
+    std::string help;
+    PerThread<LatencyHistogram> histograms;
+};
+
+/**
+ * @class ScopedTimer
+ * @brief Records the time from construction to destruction.
+ */
+class ScopedTimer {
+   public:
+    explicit ScopedTimer(LatencyMetric& metric)
+        : metric(metric), start(cycle_now()) {}
+
+    ~ScopedTimer() {
+        static const double scale = nanoseconds_per_cycle();
+        metric.record(static_cast<std::int64_t>(
+            static_cast<double>(cycle_now() - start) * scale));
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+   private:
+    LatencyMetric& metric;
+    std::uint64_t start;
+};
+
+/**
+ * @class MetricsRegistry
+ * @brief Named counters and latencies, exported in the Prometheus text
+ *        format.
+ *
+ * Metrics are created on first request and live as long as the registry;
+ * asking again for a name returns the same metric, so call sites look
+ * theirs up once and keep the reference.
+ */
+class MetricsRegistry {
+   public:
+    MetricsRegistry();
+
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    /** @brief Gets the process-wide registry the METRIC_* macros use. */
+    static MetricsRegistry& instance();
+
+    /**
+     * @brief Gets or creates a counter.
+     * @param name Prometheus metric name, such as thales_orders_total.
+     * @param help One-line description.
+     * @throws std::invalid_argument If the name is not a valid metric name
+     *         or is already a latency.
+     */
+    Counter& counter(const std::string& name, const std::string& help);
+
+    /**
+     * @brief Gets or creates a latency, exported in seconds.
+     * @throws std::invalid_argument If the name is not a valid metric name
+     *         or is already a counter.
+     */
+    LatencyMetric& latency(const std::string& name, const std::string& help);
+
+    /**
+     * @brief Writes every metric in the Prometheus text format.
+     *
+     * Latencies are summaries with their 50th, 90th, 99th and 99.9th
+     * percentiles.
+     *
+     * @param out Receives the text (appended).
+     */
+    void write_prometheus(std::string& out) const;
+
+   private:
+    mutable std::mutex mutex;
+    std::map<std::string, std::unique_ptr<Counter>> counters;
+    std::map<std::string, std::unique_ptr<LatencyMetric>> latencies;
+};
+
+/**
+ * @class MetricsDumper
+ * @brief Writes a registry to a file at a fixed interval.
+ *
+ * Each dump replaces the file atomically, so it suits the node exporter's
+ * textfile collector and anything else that polls it.
+ */
+class MetricsDumper {
+   public:
+    /**
+     * @brief Creates a stopped dumper.
+     * @param registry The metrics to write; must outlive the dumper.
+     * @param path The file to write.
+     * @param interval Time between dumps.
+     */
+    MetricsDumper(const MetricsRegistry& registry, std::string path,
+                  std::chrono::milliseconds interval);
+
+    /** @brief Stops the dumper thread. */
+    ~MetricsDumper();
+
+    MetricsDumper(const MetricsDumper&) = delete;
+    MetricsDumper& operator=(const MetricsDumper&) = delete;
+
+    /** @brief Starts the dumper thread; does nothing if running. */
+    void start();
+
+    /** @brief Stops the dumper thread after a final dump. */
+    void stop();
+
+    /**
+     * @brief Writes the metrics now.
+     * @throws std::runtime_error If the file cannot be written.
+     */
+    void dump() const;
+
+   private:
+    void run();
+
+    const MetricsRegistry& registry;
+    std::string path;
+    std::chrono::milliseconds interval;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::thread thread;
+};
+
+}  // namespace thales
+
+#define THALES_METRIC_CONCAT_(a, b) a##b
+#define THALES_METRIC_CONCAT(a, b) THALES_METRIC_CONCAT_(a, b)
+
+#if THALES_METRICS
+
+/**
+ * @brief Adds to a counter of the process-wide registry.
+ */
+#define METRIC_COUNT(name, help, amount)                                    \
+    do {                                                                    \
+        static ::thales::Counter& thales_counter =                          \
+            ::thales::MetricsRegistry::instance().counter(name, help);      \
+        thales_counter.add(amount);                                         \
+    } while (0)
+
+/**
+ * @brief Records a latency in nanoseconds to the process-wide registry.
+ */
+#define METRIC_RECORD_NS(name, help, nanoseconds)                           \
+    do {                                                                    \
+        static ::thales::LatencyMetric& thales_latency =                    \
+            ::thales::MetricsRegistry::instance().latency(name, help);      \
+        thales_latency.record(nanoseconds);                                 \
+    } while (0)
+
+/**
+ * @brief Times the rest of the enclosing scope.
+ */
+#define METRIC_TIME_SCOPE(name, help)                                       \
+    static ::thales::LatencyMetric& THALES_METRIC_CONCAT(                   \
+        thales_latency_, __LINE__) =                                        \
+        ::thales::MetricsRegistry::instance().latency(name, help);          \
+    ::thales::ScopedTimer THALES_METRIC_CONCAT(thales_timer_, __LINE__)(    \
+        THALES_METRIC_CONCAT(thales_latency_, __LINE__))
+
+#else
+
+#define METRIC_COUNT(name, help, amount) \
+    do {                                 \
+    } while (0)
+#define METRIC_RECORD_NS(name, help, nanoseconds) \
+    do {                                          \
+    } while (0)
+#define METRIC_TIME_SCOPE(name, help) static_assert(true, "")
+
+#endif
@@ -0,0 +1,86 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace thales {
+
+/**
+ * @class ResponseCache
+ * @brief Content-addressed on-disk cache of HTTP response bodies.
+ *
+ * An entry is named after a 64-bit hash of its key, normally the request
+ * path and query, and lives in `<directory>/<2 hex digits>/<16 hex
+ * digits>.z` so no directory grows too large. It records the key next to
+ * the zlib-compressed body; a hash collision or a damaged file therefore
+ * reads as a miss rather than as the wrong body. Entries are written to a
+ * temporary file and renamed into place, so several processes can share a
+ * cache and a crash never leaves a partial entry behind.
+ */
+class ResponseCache {
+   public:
+    /**
+     * @brief Opens a cache, creating the directory if needed.
+     * @param directory The cache directory.
+     * @param level zlib compression level, 1 (fastest) to 9 (smallest).
+     * @throws std::invalid_argument If the level is out of range.
+     * @throws std::runtime_error If the directory cannot be created.
+     */
+    explicit ResponseCache(std::string directory, int level = 6);
+
+    /**
+     * @brief Looks up an entry.
+     * @param key The request key.
+     * @param body Receives the body on a hit.
+     * @return True on a hit.
+     */
+    bool load(std::string_view key, std::string& body) const;
+
+    /**
+     * @brief Stores an entry, replacing any with the same key.
+     * @param key The request key.
+     * @param body The response body.
+     * @throws std::runtime_error If the entry cannot be written.
+     */
+    void store(std::string_view key, std::string_view body) const;
+
+    /**
+     * @brief Gets the file an entry is stored in.
+     * @param key The request key.
+     * @return The path, whether or not the entry exists.
+     */
+    std::string path(std::string_view key) const;
+
+    /** @brief Gets the cache directory. */
+    const std::string& get_directory() const { return directory; }
+
+   private:
+    std::string directory;
+    int level;
+};
+
+}  // namespace thales
@@ -0,0 +1,335 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+namespace thales {
+
+/** Cache line size used to keep producer and consumer state apart. */
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * @brief Validates a ring capacity and returns its index mask.
+ * @throws std::invalid_argument If capacity is not a power of two.
+ */
+inline std::size_t ring_mask(std::size_t capacity) {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        throw std::invalid_argument("Capacity must be a power of two");
+    }
+    return capacity - 1;
+}
+
+/**
+ * @brief Bounded lock-free queue for one producer and one consumer thread.
+ *
+ * Each side caches the other side's index so that the shared atomics are
+ * only re-read when the queue looks full or empty.
+ *
+ * @tparam T A trivially copyable element type.
+ */
+template <typename T>
+class SpscRingBuffer {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Ring buffer elements must be trivially copyable");
+
+   public:
+    /**
+     * @brief Creates an empty queue.
+     * @param capacity Number of slots; must be a power of two.
+     * @throws std::invalid_argument If capacity is not a power of two.
+     */
+    explicit SpscRingBuffer(std::size_t capacity)
+        : mask(ring_mask(capacity)), slots(new T[capacity]) {}
+
+    std::size_t capacity() const { return mask + 1; }
+
+    /**
+     * @brief Appends an element; producer thread only.
+     * @return False if the queue is full.
+     */
+    bool try_push(const T& value) {
+        std::size_t tail = producer.index.load(std::memory_order_relaxed);
+        if (tail - producer.cached > mask) {
+            producer.cached = consumer.index.load(std::memory_order_acquire);
+            if (tail - producer.cached > mask) {
+                return false;
+            }
+        }
+        slots[tail & mask] = value;
+        producer.index.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Removes the oldest element; consumer thread only.
+     * @return False if the queue is empty.
+     */
+    bool try_pop(T& value) {
+        std::size_t head = consumer.index.load(std::memory_order_relaxed);
+        if (head == consumer.cached) {
+            consumer.cached = producer.index.load(std::memory_order_acquire);
+            if (head == consumer.cached) {
+                return false;
+            }
+        }
+        value = slots[head & mask];
+        consumer.index.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Approximate number of queued elements.
+     */
+    std::size_t size() const {
+        return producer.index.load(std::memory_order_acquire) -
+               consumer.index.load(std::memory_order_acquire);
+    }
+
+   private:
+    /** One side's index and its cached copy of the other side's. */
+    struct alignas(CACHE_LINE_SIZE) Cursor {
+        std::atomic<std::size_t> index{0};
+        std::size_t cached = 0;
+    };
+
+    const std::size_t mask;
+    std::unique_ptr<T[]> slots;
+    Cursor producer;
+    Cursor consumer;
+};
+
+/**
+ * @brief Bounded lock-free queue for many producers and one consumer.
+ *
+ * Producers claim slots with a compare-and-swap on the tail; each slot
+ * carries a sequence number telling whether it is free or filled (Vyukov's
+ * bounded queue), so a slow producer never exposes a half-written element.
+ *
+ * @tparam T A trivially copyable element type.
+ */
+template <typename T>
+class MpscRingBuffer {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Ring buffer elements must be trivially copyable");
+
+   public:
+    /**
+     * @brief Creates an empty queue.
+     * @param capacity Number of slots; must be a power of two.
+     * @throws std::invalid_argument If capacity is not a power of two.
+     */
+    explicit MpscRingBuffer(std::size_t capacity)
+        : mask(ring_mask(capacity)), slots(new Slot[capacity]) {
+        for (std::size_t i = 0; i < capacity; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    std::size_t capacity() const { return mask + 1; }
+
+    /**
+     * @brief Appends an element; safe from any number of threads.
+     * @return False if the queue is full.
+     */
+    bool try_push(const T& value) {
+        std::size_t tail = this->tail.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots[tail & mask];
+            std::size_t sequence =
+                slot.sequence.load(std::memory_order_acquire);
+            auto lag = static_cast<std::ptrdiff_t>(sequence - tail);
+            if (lag == 0) {
+                if (this->tail.compare_exchange_weak(
+                        tail, tail + 1, std::memory_order_relaxed)) {
+                    slot.value = value;
+                    slot.sequence.store(tail + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (lag < 0) {
+                return false;  // Slot not yet consumed: full
+            } else {
+                tail = this->tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Removes the oldest element; one consumer thread only.
+     * @return False if the queue is empty or the next element is still
+     *         being written.
+     */
+    bool try_pop(T& value) {
+        Slot& slot = slots[head & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1) {
+            return false;
+        }
+        value = slot.value;
+        slot.sequence.store(head + mask + 1, std::memory_order_release);
+        ++head;
+        return true;
+    }
+
+   private:
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    const std::size_t mask;
+    std::unique_ptr<Slot[]> slots;
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail{0};
+    alignas(CACHE_LINE_SIZE) std::size_t head = 0;
+};
+
+/**
+ * @brief Bounded lock-free queue of variable-length records for one
+ * producer and one consumer thread.
+ *
+ * Every record is prefixed with its length and padded to RECORD_ALIGNMENT,
+ * and records never wrap around the end of the ring: one that does not fit
+ * is preceded by a zero length telling the consumer to skip to the start.
+ * The consumer may read several records before releasing their space.
+ */
+class SpscByteRing {
+   public:
+    /** Alignment of every record, and size of its length prefix. */
+    static constexpr std::size_t RECORD_ALIGNMENT = 8;
+
+    /**
+     * @brief Creates an empty ring.
+     * @param capacity Size in bytes; must be a power of two of at least
+     *        RECORD_ALIGNMENT.
+     * @throws std::invalid_argument If capacity is invalid.
+     */
+    explicit SpscByteRing(std::size_t capacity)
+        : mask(ring_mask(capacity)), bytes(new char[capacity]) {
+        if (capacity < RECORD_ALIGNMENT) {
+            throw std::invalid_argument("Ring capacity is too small");
+        }
+    }
+
+    std::size_t capacity() const { return mask + 1; }
+
+    /**
+     * @brief Reserves space for the next record; producer thread only.
+     *
+     * The record is published by commit(); reserving again without
+     * committing discards the reservation.
+     *
+     * @param size Record size in bytes.
+     * @return Where to write the record (RECORD_ALIGNMENT aligned), or
+     *         nullptr if the ring is full.
+     */
+    char* try_reserve(std::size_t size) {
+        std::size_t length =
+            RECORD_ALIGNMENT + ((size + RECORD_ALIGNMENT - 1) &
+                                ~(RECORD_ALIGNMENT - 1));
+        std::size_t head = producer.index.load(std::memory_order_relaxed);
+        std::size_t room = capacity() - (head & mask);
+        std::size_t skip = room < length ? room : 0;
+        if (length + skip > capacity()) {
+            return nullptr;
+        }
+        if (head + skip + length - producer.cached > capacity()) {
+            producer.cached = consumer.index.load(std::memory_order_acquire);
+            if (head + skip + length - producer.cached > capacity()) {
+                return nullptr;
+            }
+        }
+        if (skip != 0) {
+            write_length(head, 0);
+            head += skip;
+        }
+        write_length(head, length);
+        reserved = head + length;
+        return bytes.get() + (head & mask) + RECORD_ALIGNMENT;
+    }
+
+    /** @brief Publishes the last reserved record; producer thread only. */
+    void commit() {
+        producer.index.store(reserved, std::memory_order_release);
+    }
+
+    /**
+     * @brief Reads the next record without releasing it; consumer only.
+     * @param size Receives the record size, rounded up to RECORD_ALIGNMENT.
+     * @return The record, or nullptr if none is published.
+     */
+    const char* try_read(std::size_t& size) {
+        while (true) {
+            if (read == consumer.cached) {
+                consumer.cached =
+                    producer.index.load(std::memory_order_acquire);
+                if (read == consumer.cached) {
+                    return nullptr;
+                }
+            }
+            std::uint64_t length;
+            std::memcpy(&length, bytes.get() + (read & mask), sizeof(length));
+            if (length == 0) {
+                read += capacity() - (read & mask);
+                continue;
+            }
+            const char* record = bytes.get() + (read & mask) + RECORD_ALIGNMENT;
+            size = static_cast<std::size_t>(length) - RECORD_ALIGNMENT;
+            read += static_cast<std::size_t>(length);
+            return record;
+        }
+    }
+
+    /** @brief Frees every record read so far; consumer thread only. */
+    void release() { consumer.index.store(read, std::memory_order_release); }
+
+    /** @brief Tells whether no published record is left to read. */
+    bool empty() const {
+        return read == producer.index.load(std::memory_order_acquire);
+    }
+
+   private:
+    struct alignas(CACHE_LINE_SIZE) Cursor {
+        std::atomic<std::size_t> index{0};
+        std::size_t cached = 0;
+    };
+
+    void write_length(std::size_t position, std::uint64_t length) {
+        std::memcpy(bytes.get() + (position & mask), &length, sizeof(length));
+    }
+
+    const std::size_t mask;
+    std::unique_ptr<char[]> bytes;
+    Cursor producer;
+    std::size_t reserved = 0;
+    Cursor consumer;
+    std::size_t read = 0;
+};
+
+}  // namespace thales
@@ -0,0 +1,158 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+namespace thales {
+
+/**
+ * @class SeqlockTable
+ * @brief Fixed-size table written by one thread and read lock-free by any.
+ *
+ * The writer brackets each batch of row updates with begin_write() and
+ * end_write(), which bump a shared sequence number; readers copy the rows
+ * they want and retry if the sequence moved meanwhile, so every read sees
+ * the table as it was between two batches. Rows are stored as relaxed
+ * atomic words, which keeps the racing copies well defined.
+ *
+ * @tparam T A trivially copyable row type.
+ */
+template <typename T>
+class SeqlockTable {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Seqlock rows must be trivially copyable");
+
+   public:
+    /**
+     * @brief Creates a table of value-initialised rows.
+     * @param capacity Number of rows.
+     */
+    explicit SeqlockTable(std::size_t capacity)
+        : rows(capacity),
+          words(new std::atomic<std::uint64_t>[capacity * WORDS]) {
+        T empty{};
+        for (std::size_t i = 0; i < capacity; ++i) {
+            store(i, empty);
+        }
+    }
+
+    std::size_t capacity() const { return rows; }
+
+    /** @brief Starts a batch of updates; writer thread only. */
+    void begin_write() {
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1,
+                       std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    /** @brief Replaces a row; writer thread only, inside a batch. */
+    void set(std::size_t index, const T& row) { store(index, row); }
+
+    /** @brief Publishes the batch; writer thread only. */
+    void end_write() {
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1,
+                       std::memory_order_release);
+    }
+
+    /** @brief Reads one row; writer thread only, no retry needed. */
+    T peek(std::size_t index) const { return load(index); }
+
+    /** @brief Reads one row consistently; any thread. */
+    T read(std::size_t index) const {
+        T row;
+        read(index, 1, &row);
+        return row;
+    }
+
+    /**
+     * @brief Reads consecutive rows as of one batch; any thread.
+     * @param first First row to read.
+     * @param count Number of rows.
+     * @param out Receives the rows.
+     * @return The number of batches published before the copy.
+     */
+    std::uint64_t read(std::size_t first, std::size_t count, T* out) const {
+        for (int attempt = 0;; ++attempt) {
+            std::uint64_t before = sequence.load(std::memory_order_acquire);
+            if ((before & 1) == 0) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    out[i] = load(first + i);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence.load(std::memory_order_relaxed) == before) {
+                    return before / 2;
+                }
+            }
+            if (attempt >= SPIN_LIMIT) {
+                std::this_thread::yield();  // The writer may be descheduled
+            }
+        }
+    }
+
+    /** @brief Gets the number of batches published so far. */
+    std::uint64_t version() const {
+        return sequence.load(std::memory_order_acquire) / 2;
+    }
+
+   private:
+    static constexpr std::size_t WORDS =
+        (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    /** Failed reads before a reader starts yielding to the writer. */
+    static constexpr int SPIN_LIMIT = 64;
+
+    void store(std::size_t index, const T& row) {
+        std::uint64_t buffer[WORDS] = {};
+        std::memcpy(buffer, &row, sizeof(T));
+        std::atomic<std::uint64_t>* slot = &words[index * WORDS];
+        for (std::size_t w = 0; w < WORDS; ++w) {
+            slot[w].store(buffer[w], std::memory_order_relaxed);
+        }
+    }
+
+    T load(std::size_t index) const {
+        std::uint64_t buffer[WORDS];
+        const std::atomic<std::uint64_t>* slot = &words[index * WORDS];
+        for (std::size_t w = 0; w < WORDS; ++w) {
+            buffer[w] = slot[w].load(std::memory_order_relaxed);
+        }
+        T row;
+        std::memcpy(&row, buffer, sizeof(T));
+        return row;
+    }
+
+    const std::size_t rows;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> words;
+    alignas(64) std::atomic<std::uint64_t> sequence{0};
+};
+
+}  // namespace thales
@@ -0,0 +1,126 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace thales {
+
+/**
+ * @enum CellStyle
+ * @brief Rendition of a screen cell.
+ */
+enum class CellStyle : std::uint8_t {
+    NORMAL,   /**< Default colours */
+    BOLD,     /**< Bold text */
+    HEADER,   /**< Reverse video */
+    POSITIVE, /**< Green text */
+    NEGATIVE  /**< Red text */
+};
+
+/**
+ * @class TerminalScreen
+ * @brief Double-buffered model of an ANSI terminal.
+ *
+ * Frames are drawn into a back buffer of cells, then compared with the
+ * frame already on the terminal: only changed cells are emitted, with
+ * cursor moves and style changes written only where the run of output
+ * breaks.
+ */
+class TerminalScreen {
+   public:
+    /**
+     * @brief Creates a blank screen.
+     * @param rows Number of rows.
+     * @param columns Number of columns.
+     */
+    TerminalScreen(std::size_t rows, std::size_t columns);
+
+    std::size_t rows() const { return height; }
+    std::size_t columns() const { return width; }
+
+    /**
+     * @brief Changes the size; the next render redraws everything.
+     */
+    void resize(std::size_t rows, std::size_t columns);
+
+    /** @brief Blanks the back buffer. */
+    void clear();
+
+    /**
+     * @brief Writes text into the back buffer, clipped to the screen.
+     * @param row Row, from 0.
+     * @param column Column, from 0.
+     * @param text Printable ASCII text.
+     * @param style Rendition of the text.
+     * @return The column after the text.
+     */
+    std::size_t put(std::size_t row, std::size_t column,
+                    std::string_view text,
+                    CellStyle style = CellStyle::NORMAL);
+
+    /** @brief Makes the next render redraw everything. */
+    void invalidate() { full_redraw = true; }
+
+    /**
+     * @brief Emits the escape sequences turning the last frame into the
+     * back buffer, which becomes the current frame.
+     * @param out Receives the output (appended); nothing is appended when
+     *        no cell changed.
+     */
+    void render(std::string& out);
+
+   private:
+    struct Cell {
+        char character = ' ';
+        CellStyle style = CellStyle::NORMAL;
+
+        bool operator!=(const Cell& other) const {
+            return character != other.character || style != other.style;
+        }
+    };
+
+    std::size_t height;
+    std::size_t width;
+    std::vector<Cell> back;
+    std::vector<Cell> front;
+    bool full_redraw = true;
+};
+
+/**
+ * @brief Writes a whole buffer to a file descriptor.
+ *
+ * Retries on partial writes and interruptions, so a frame normally leaves
+ * in a single write() call.
+ *
+ * @throws std::runtime_error If the write fails.
+ */
+void write_all(int fd, std::string_view data);
+
+}  // namespace thales
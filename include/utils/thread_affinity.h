@@ -0,0 +1,274 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace thales {
+
+/**
+ * @brief Tells the CPU the calling thread is spinning.
+ *
+ * Lets a hyperthread sibling run and saves power without giving up the
+ * core, unlike std::this_thread::yield().
+ */
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+/**
+ * @brief Parses a Linux CPU list such as "0-3,8,10-11".
+ * @param text The list; empty gives an empty list.
+ * @return The CPUs in the order listed, ranges expanded.
+ * @throws std::invalid_argument If the text is not a CPU list.
+ */
+std::vector<int> parse_cpu_list(std::string_view text);
+
+/**
+ * @class CpuTopology
+ * @brief Which CPUs belong to which NUMA node.
+ */
+class CpuTopology {
+   public:
+    /**
+     * @brief Gets the machine's topology, read once from sysfs.
+     */
+    static const CpuTopology& instance();
+
+    /**
+     * @brief Reads a topology from the node directories under a root.
+     *
+     * Every nodeN/cpulist under the root describes node N. Machines without
+     * NUMA support have no such directories; they are read as a single
+     * node holding every hardware thread.
+     *
+     * @param root The sysfs node directory.
+     * @throws std::invalid_argument If a cpulist is malformed.
+     */
+    static CpuTopology read(
+        const std::string& root = "/sys/devices/system/node");
+
+    /** @brief Gets one more than the highest node number. */
+    std::size_t nodes() const { return node_cpus.size(); }
+
+    /**
+     * @brief Gets the CPUs of a node.
+     * @return The CPUs, empty for an unknown node.
+     */
+    const std::vector<int>& cpus_of(int node) const;
+
+    /**
+     * @brief Gets the node a CPU belongs to.
+     * @return The node, or 0 for an unknown CPU.
+     */
+    int node_of(int cpu) const;
+
+   private:
+    std::vector<std::vector<int>> node_cpus; /**< By node number */
+};
+
+/**
+ * @brief Restricts a thread to a set of CPUs.
+ * @param thread The thread; see std::thread::native_handle().
+ * @param cpus The CPUs; empty leaves the thread's affinity unchanged.
+ * @throws std::invalid_argument If a CPU number is out of range.
+ * @throws std::runtime_error If the kernel refuses the set, e.g. because
+ *         none of the CPUs is online or allowed to this process.
+ */
+void pin_thread(std::thread::native_handle_type thread,
+                const std::vector<int>& cpus);
+
+/**
+ * @brief Restricts the calling thread to a set of CPUs.
+ * @see pin_thread()
+ */
+void pin_current_thread(const std::vector<int>& cpus);
+
+/**
+ * @brief How a polling thread waits when it finds nothing to do.
+ */
+enum class WaitMode {
+    SLEEP,          /**< Sleep for the park interval every time */
+    BUSY_POLL,      /**< Never give up the core */
+    SPIN_THEN_PARK, /**< Spin for a while, then park */
+};
+
+/**
+ * @brief Parses "sleep", "busy_poll" or "spin_then_park".
+ * @throws std::invalid_argument For any other text.
+ */
+WaitMode parse_wait_mode(std::string_view text);
+
+/**
+ * @brief Parameters of an IdleWaiter.
+ */
+struct WaitSettings {
+    WaitMode mode = WaitMode::SPIN_THEN_PARK;
+    int spin_iterations = 1000; /**< Idle polls spent spinning first */
+    /** Length of one parked wait; zero parks by yielding instead */
+    std::chrono::microseconds park{0};
+};
+
+/**
+ * @class IdleWaiter
+ * @brief Wait strategy of one polling thread.
+ *
+ * A thread that polls for work calls idle() after every empty poll and
+ * reset() after every poll that found something. BUSY_POLL spins on the
+ * core forever, which gives the lowest wake-up latency and needs a core of
+ * its own; SLEEP always sleeps; SPIN_THEN_PARK spins through short gaps
+ * and only parks once the thread has been idle for a while.
+ */
+class IdleWaiter {
+   public:
+    explicit IdleWaiter(const WaitSettings& settings = {})
+        : settings(settings) {}
+
+    /** @brief Waits once after a poll that found nothing. */
+    void idle();
+
+    /** @brief Starts spinning again after a poll that found work. */
+    void reset() { idle_polls = 0; }
+
+    /**
+     * @brief Whether the next idle() would park rather than spin.
+     *
+     * Lets a thread that can block in a system call, such as poll(2), do
+     * so instead of calling idle().
+     */
+    bool parking() const;
+
+    /** Longest wait_until() sleeps before checking stop() again. */
+    static constexpr std::chrono::milliseconds MAX_SLEEP{100};
+
+    /**
+     * @brief Waits until a deadline or until stop() returns true.
+     *
+     * SLEEP sleeps to the deadline; BUSY_POLL spins the whole time;
+     * SPIN_THEN_PARK sleeps until one park interval before the deadline
+     * and spins the rest, so it wakes on time without holding the core.
+     * Sleeps are cut into steps of at most MAX_SLEEP.
+     *
+     * @return False if stop() returned true first.
+     */
+    template <typename Clock, typename Duration, typename Stop>
+    bool wait_until(std::chrono::time_point<Clock, Duration> deadline,
+                    Stop stop) {
+        while (!stop()) {
+            auto now = Clock::now();
+            if (now >= deadline) {
+                return true;
+            }
+            auto remaining = deadline - now;
+            if (settings.mode == WaitMode::SPIN_THEN_PARK) {
+                // Sleeping straight to the deadline would oversleep by the
+                // scheduler's wake-up latency
+                remaining -= settings.park;
+            }
+            if (settings.mode == WaitMode::BUSY_POLL ||
+                remaining <= remaining.zero()) {
+                cpu_relax();
+            } else if (remaining < MAX_SLEEP) {
+                std::this_thread::sleep_for(remaining);
+            } else {
+                std::this_thread::sleep_for(MAX_SLEEP);
+            }
+        }
+        return false;
+    }
+
+   private:
+    WaitSettings settings;
+    int idle_polls = 0;
+};
+
+/**
+ * @brief Where a thread runs and how it waits.
+ */
+struct ThreadPlacement {
+    std::vector<int> cpus; /**< Allowed CPUs; empty leaves it unpinned */
+    WaitSettings wait;     /**< Idle strategy */
+
+    /**
+     * @brief Gets the NUMA node of the first CPU.
+     * @return The node, or -1 if the thread is unpinned.
+     */
+    int node() const;
+};
+
+/**
+ * @class NumaMemoryResource
+ * @brief Memory resource whose pages are placed on one NUMA node.
+ *
+ * Every allocation is its own anonymous mapping with a preferred-node
+ * policy, so pages come from the node even when first touched by a thread
+ * elsewhere, and fall back to other nodes rather than fail when it is
+ * full. Mappings cost a system call each and round up to whole pages:
+ * use the resource as the upstream of an Arena or a pool resource, not
+ * directly for small objects.
+ *
+ * On kernels without NUMA support the policy is skipped and the resource
+ * behaves like plain mmap. Thread-safe.
+ */
+class NumaMemoryResource : public std::pmr::memory_resource {
+   public:
+    /**
+     * @brief Creates a resource for a node.
+     * @param node The NUMA node; -1 applies no policy.
+     */
+    explicit NumaMemoryResource(int node) : numa_node(node) {}
+
+    /**
+     * @brief Gets a process-wide resource for a node, like
+     *        std::pmr::new_delete_resource().
+     * @param node The NUMA node; -1 gives the default resource.
+     */
+    static std::pmr::memory_resource* for_node(int node);
+
+    int node() const { return numa_node; }
+
+   private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes,
+                       std::size_t alignment) override;
+    bool do_is_equal(
+        const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    int numa_node;
+};
+
+}  // namespace thales
@@ -0,0 +1,161 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace thales {
+
+/**
+ * @brief Fixed-size pool of worker threads with work stealing.
+ *
+ * Every worker owns a task deque. Tasks submitted from a worker go to the
+ * back of its own deque and are popped LIFO, which keeps recently touched
+ * data hot; idle workers steal the oldest task from the front of another
+ * worker's deque. Tasks submitted from other threads are spread round-robin.
+ *
+ * Worker indices are stable and lie in [0, size()), so callers can keep
+ * per-worker accumulators and combine them afterwards without locking.
+ * Workers can be pinned to CPUs; memory(worker) then allocates on the
+ * worker's NUMA node, for data that worker owns.
+ */
+class ThreadPool {
+   public:
+    /**
+     * @brief Starts the worker threads.
+     * @param threads Number of workers; 0 uses one per CPU in cpus, or one
+     *        per hardware thread if cpus is empty.
+     * @param cpus CPUs to pin the workers to, worker i on cpus[i % n];
+     *        empty leaves them unpinned.
+     * @throws std::invalid_argument If a CPU number is out of range.
+     * @throws std::runtime_error If a worker cannot be pinned.
+     */
+    explicit ThreadPool(std::size_t threads = 0,
+                        const std::vector<int>& cpus = {});
+
+    /**
+     * @brief Runs every queued task, then joins the workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Gets the number of worker threads.
+     * @return The number of workers.
+     */
+    std::size_t size() const { return workers.size(); }
+
+    /**
+     * @brief Queues a task for execution.
+     * @param task Callable taking no arguments.
+     * @return A future for the task's result or exception.
+     */
+    template <typename F>
+    auto submit(F&& task) -> std::future<std::invoke_result_t<F&>> {
+        using Result = std::invoke_result_t<F&>;
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(
+            std::forward<F>(task));
+        std::future<Result> result = packaged->get_future();
+        push([packaged] { (*packaged)(); });
+        return result;
+    }
+
+    /**
+     * @brief Runs body(index, worker) for every index in [0, count).
+     *
+     * Blocks until all iterations have finished. When called from one of
+     * this pool's workers the caller runs queued tasks while it waits, so
+     * nested calls cannot deadlock. The first exception thrown by body is
+     * rethrown once every iteration has completed.
+     *
+     * @param count Number of iterations.
+     * @param body Callable receiving the iteration and worker indices.
+     */
+    void parallel_for(
+        std::size_t count,
+        const std::function<void(std::size_t, std::size_t)>& body);
+
+    /**
+     * @brief Gets the index of the calling worker thread.
+     * @return The worker index, or size() if called from another thread.
+     */
+    std::size_t current_worker() const;
+
+    /**
+     * @brief Gets the CPU a worker is pinned to.
+     * @return The CPU, or -1 if the pool is unpinned.
+     */
+    int cpu(std::size_t worker) const { return workers[worker]->cpu; }
+
+    /**
+     * @brief Gets a resource allocating on a worker's NUMA node.
+     *
+     * Backed by whole-page mappings; put an Arena or pool resource in
+     * front of it for small allocations.
+     *
+     * @return The node's resource, or the default resource if the pool is
+     *         unpinned.
+     */
+    std::pmr::memory_resource* memory(std::size_t worker) const;
+
+   private:
+    using Task = std::function<void()>;
+
+    /** Task deque owned by one worker, padded to its own cache line. */
+    struct alignas(64) Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::thread thread;
+        int cpu = -1;
+    };
+
+    void push(Task task);
+    void shutdown();
+    bool try_pop(std::size_t worker, Task& task);
+    void run(std::size_t worker);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<std::size_t> next_worker{0}; /**< Round-robin cursor */
+    std::atomic<std::ptrdiff_t> pending{0};  /**< Queued task count */
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+};
+
+}  // namespace thales
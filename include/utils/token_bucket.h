@@ -0,0 +1,90 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <mutex>
+
+namespace thales {
+
+/**
+ * @class TokenBucket
+ * @brief Thread-safe rate limiter allowing short bursts.
+ *
+ * The bucket holds up to `burst` tokens and refills at `rate` tokens per
+ * second. acquire() takes a token and, when the bucket is empty, sleeps
+ * until its token has refilled. Waiters reserve tokens in the order they
+ * arrive, so a busy bucket is shared fairly and never exceeds its rate.
+ */
+class TokenBucket {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Creates a full bucket.
+     * @param rate Tokens added per second; 0 disables the limit.
+     * @param burst Tokens the bucket holds when full.
+     * @throws std::invalid_argument If rate is negative or burst below 1.
+     */
+    TokenBucket(double rate, double burst);
+
+    /**
+     * @brief Takes a token, sleeping until one is available.
+     */
+    void acquire();
+
+    /**
+     * @brief Takes a token if one is available now.
+     * @return True if a token was taken.
+     */
+    bool try_acquire();
+
+    /**
+     * @brief Empties the bucket, e.g. after the server reported that the
+     *        rate was exceeded anyway.
+     *
+     * Requests already waiting keep their reservations; new ones wait for
+     * the bucket to refill.
+     */
+    void drain();
+
+    /** @brief Gets the refill rate in tokens per second. */
+    double rate() const { return tokens_per_second; }
+
+   private:
+    /** Adds the tokens refilled since the last call; mutex must be held. */
+    void refill(Clock::time_point now);
+
+    /** Takes a token and returns when it becomes available. */
+    Clock::time_point reserve();
+
+    const double tokens_per_second;
+    const double capacity;
+    std::mutex mutex;
+    double tokens;               /**< Guarded by mutex; negative if owed */
+    Clock::time_point refilled;  /**< Guarded by mutex */
+};
+
+}  // namespace thales
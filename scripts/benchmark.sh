@@ -0,0 +1,53 @@
+#!/bin/sh
+set -e
+
+# Builds the benchmarks optimized and without sanitizers, runs them and
+# writes the results as JSON.
+#
+# Usage: scripts/benchmark.sh [OUTPUT] [BENCHMARK FLAGS...]
+#   OUTPUT defaults to benchmarks/results.json. Extra flags go to the
+#   benchmark binary, e.g. --benchmark_filter=Portfolio.
+#
+# Record a baseline, change the code, then compare:
+#   scripts/benchmark.sh benchmarks/baseline.json
+#   scripts/benchmark.sh
+#   scripts/compare_benchmarks.py benchmarks/baseline.json \
+#       benchmarks/results.json
+
+# Navigate to the project root directory
+cd "$(git rev-parse --show-toplevel)"
+ROOT=$(pwd)
+
+OUTPUT=${1:-benchmarks/results.json}
+if [ $# -gt 0 ]; then
+    shift
+fi
+case "$OUTPUT" in
+    /*) ;;
+    *) OUTPUT="$ROOT/$OUTPUT" ;;
+esac
+
+# Determine the number of available CPU cores
+if command -v nproc > /dev/null 2>&1; then
+    NUM_CORES=$(nproc)
+elif command -v sysctl > /dev/null 2>&1; then
+    NUM_CORES=$(sysctl -n hw.ncpu)
+else
+    NUM_CORES=1
+fi
+
+# Separate from the sanitized build/ used for tests
+BUILD_DIR=build-bench
+cmake -S . -B "$BUILD_DIR" -DTHALES_SANITIZE=OFF -DCMAKE_BUILD_TYPE=Release
+cmake --build "$BUILD_DIR" --target thales_benchmarks -j"$NUM_CORES"
+
+# Run from the build directory, like the main executable, so ../config
+# resolves. Repetitions give the comparison script medians to work with
+cd "$BUILD_DIR"
+./thales_benchmarks \
+    --benchmark_out="$OUTPUT" \
+    --benchmark_out_format=json \
+    --benchmark_repetitions=3 \
+    --benchmark_report_aggregates_only=true \
+    "$@"
+echo "Results written to $OUTPUT"
@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""Compares two Google Benchmark JSON result files.
+
+Usage: scripts/compare_benchmarks.py BASELINE CURRENT [--threshold PCT]
+                                     [--filter REGEX]
+
+Both files are produced by scripts/benchmark.sh. When the runs contain
+repetitions the median aggregate is compared, otherwise the single
+iteration. Benchmarks that use real time (multithreaded ones) are compared
+on wall time, the rest on CPU time. Exits with status 1 if any benchmark
+got slower than the threshold allows.
+"""
+
+import argparse
+import json
+import re
+import sys
+
+UNIT_TO_NS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    context = data.get("context", {})
+    medians = {}
+    singles = {}
+    for bench in data.get("benchmarks", []):
+        if bench.get("error_occurred"):
+            continue
+        name = bench.get("run_name", bench["name"])
+        metric = "real_time" if "/real_time" in name else "cpu_time"
+        value = bench[metric] * UNIT_TO_NS[bench.get("time_unit", "ns")]
+        if bench.get("run_type") == "aggregate":
+            if bench.get("aggregate_name") == "median":
+                medians[name] = value
+        else:
+            # Without aggregates keep the first repetition
+            singles.setdefault(name, value)
+    singles.update(medians)
+    return context, singles
+
+
+def format_ns(value):
+    for unit, scale in (("s", 1e9), ("ms", 1e6), ("us", 1e3)):
+        if value >= scale:
+            return "%.3g %s" % (value / scale, unit)
+    return "%.3g ns" % value
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="allowed slowdown in percent (default 10)")
+    parser.add_argument("--filter", default="",
+                        help="only compare benchmarks matching this regex")
+    args = parser.parse_args()
+
+    base_context, baseline = load(args.baseline)
+    cur_context, current = load(args.current)
+
+    base_build = base_context.get("thales_build", "unknown")
+    cur_build = cur_context.get("thales_build", "unknown")
+    if "sanitized" in (base_build, cur_build):
+        print("error: sanitized builds are not comparable, "
+              "use scripts/benchmark.sh", file=sys.stderr)
+        return 2
+    if base_build != cur_build:
+        print("warning: comparing a %s build against a %s build"
+              % (base_build, cur_build), file=sys.stderr)
+    if base_context.get("host_name") != cur_context.get("host_name"):
+        print("warning: results come from different hosts",
+              file=sys.stderr)
+
+    pattern = re.compile(args.filter)
+    names = sorted(n for n in baseline.keys() | current.keys()
+                   if pattern.search(n))
+    width = max([len(n) for n in names] + [9])
+
+    regressions = []
+    print("%-*s %12s %12s %9s" % (width, "Benchmark", "Baseline",
+                                  "Current", "Change"))
+    for name in names:
+        if name not in current:
+            print("%-*s %12s %12s %9s" % (width, name,
+                                          format_ns(baseline[name]),
+                                          "-", "missing"))
+            continue
+        if name not in baseline:
+            print("%-*s %12s %12s %9s" % (width, name, "-",
+                                          format_ns(current[name]), "new"))
+            continue
+        change = (current[name] / baseline[name] - 1.0) * 100.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions.append(name)
+        print("%-*s %12s %12s %+8.1f%%%s" % (width, name,
+                                              format_ns(baseline[name]),
+                                              format_ns(current[name]),
+                                              change, flag))
+
+    if regressions:
+        print("\n%d benchmark(s) slower than the %.0f%% threshold"
+              % (len(regressions), args.threshold))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -23,33 +23,84 @@
  */
 
 #include "config/config.h"
+#include <algorithm>
+#include <cstdlib>
 #include <fstream>
-#include <sstream>
 #include <stdexcept>
+#include <string_view>
+
+#include "config/config_store.h"
 
 namespace thales {
+
+namespace {
+
+std::string_view trim(std::string_view text) {
+    const char* whitespace = " \t\r";
+    std::size_t first = text.find_first_not_of(whitespace);
+    if (first == std::string_view::npos) {
+        return {};
+    }
+    std::size_t last = text.find_last_not_of(whitespace);
+    return text.substr(first, last - first + 1);
+}
+
+}  // namespace
+
 std::string Config::get_api_key() {
-    // Assuming the executable is run from the build/ directory
-    std::string config_path = "../config/polygon_credentials.cfg";
+    const ConfigValue* key =
+        store().current().find("polygon_credentials", "API_KEY");
+    if (key == nullptr) {
+        // The file may have been left out for failing to parse
+        std::string skipped = store().last_error();
+        throw std::runtime_error(
+            "API_KEY not found in configuration file: " +
+            store().get_directory() + "/polygon_credentials.cfg" +
+            (skipped.empty() ? "" : " (" + skipped + ")"));
+    }
+    return key->text();
+}
+
+ConfigStore& Config::store() {
+    static ConfigStore config([] {
+        const char* directory = std::getenv("THALES_CONFIG_DIR");
+        return std::string(directory != nullptr && *directory != '\0'
+                               ? directory
+                               : "../config");
+    }());
+    return config;
+}
 
-    std::ifstream file(config_path);
+std::unordered_map<std::string, std::string> Config::load(
+    const std::string& path) {
+    std::ifstream file(path);
     if (!file.is_open()) {
-        throw std::runtime_error("Unable to open configuration file: " + config_path);
+        throw std::runtime_error("Unable to open configuration file: " + path);
     }
 
+    std::unordered_map<std::string, std::string> values;
     std::string line;
-
+    int number = 0;
     while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        std::string key, value;
-
-        if (std::getline(std::getline(iss, key, '='), value)) {
-            if (key == "API_KEY") {
-                return value;
-            }
+        ++number;
+        std::string_view text = trim(line);
+        if (text.empty() || text.front() == '#') {
+            continue;
+        }
+        std::size_t equals = text.find('=');
+        std::string_view key =
+            trim(text.substr(0, std::min(equals, text.size())));
+        if (equals == std::string_view::npos || key.empty()) {
+            throw std::invalid_argument(path + ":" + std::to_string(number) +
+                                        ": expected KEY=VALUE");
+        }
+        std::string_view value = trim(text.substr(equals + 1));
+        if (!values.emplace(key, value).second) {
+            throw std::invalid_argument(path + ":" + std::to_string(number) +
+                                        ": duplicate key " +
+                                        std::string(key));
         }
     }
-
-    throw std::runtime_error("API_KEY not found in configuration file: " + config_path);
+    return values;
 }
 }  // namespace thales
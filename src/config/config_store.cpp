@@ -0,0 +1,378 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "config/config_store.h"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#include "config/config.h"
+
+namespace thales {
+
+namespace {
+
+constexpr const char* EXTENSION = ".cfg";
+
+/** Quiet period that ends a burst of writes from one save. */
+constexpr int SETTLE_MS = 20;
+
+bool equals_lower(std::string_view text, std::string_view lower) {
+    return text.size() == lower.size() &&
+           std::equal(text.begin(), text.end(), lower.begin(),
+                      [](char a, char b) {
+                          return std::tolower(static_cast<unsigned char>(
+                                     a)) == b;
+                      });
+}
+
+signed char parse_flag(std::string_view text) {
+    for (std::string_view yes : {"true", "yes", "on", "1"}) {
+        if (equals_lower(text, yes)) {
+            return 1;
+        }
+    }
+    for (std::string_view no : {"false", "no", "off", "0"}) {
+        if (equals_lower(text, no)) {
+            return 0;
+        }
+    }
+    return -1;
+}
+
+bool is_config_file(std::string_view name) {
+    std::string_view extension(EXTENSION);
+    return name.size() > extension.size() &&
+           name.substr(name.size() - extension.size()) == extension;
+}
+
+[[noreturn]] void not_a(std::string_view what, const std::string& value) {
+    throw std::invalid_argument("Configuration value is not " +
+                                std::string(what) + ": " + value);
+}
+
+[[noreturn]] void fail(const std::string& what, const std::string& path) {
+    throw std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+}
+
+}  // namespace
+
+ConfigValue::ConfigValue(std::string_view text)
+    : value(text), flag(parse_flag(text)) {
+    errno = 0;
+    char* end = nullptr;
+    number = std::strtod(value.c_str(), &end);
+    numeric = !value.empty() && *end == '\0' && errno == 0 &&
+              std::isfinite(number);
+}
+
+double ConfigValue::as_double() const {
+    if (!numeric) {
+        not_a("a number", value);
+    }
+    return number;
+}
+
+std::int64_t ConfigValue::as_int() const {
+    // 2^63 is exact as a double; anything at or above it does not fit
+    constexpr double LIMIT = 9223372036854775808.0;
+    if (!numeric || number != std::floor(number) || number >= LIMIT ||
+        number < -LIMIT) {
+        not_a("an integer", value);
+    }
+    return static_cast<std::int64_t>(number);
+}
+
+bool ConfigValue::as_bool() const {
+    if (flag < 0) {
+        not_a("a flag", value);
+    }
+    return flag == 1;
+}
+
+ConfigSnapshot ConfigSnapshot::read_directory(const std::string& directory) {
+    return read_files(directory, nullptr);
+}
+
+ConfigSnapshot ConfigSnapshot::read_directory(const std::string& directory,
+                                              std::string& skipped) {
+    return read_files(directory, &skipped);
+}
+
+ConfigSnapshot ConfigSnapshot::read_files(const std::string& directory,
+                                          std::string* skipped) {
+    namespace fs = std::filesystem;
+    std::error_code error;
+    fs::directory_iterator entries(directory, error);
+    if (error) {
+        throw std::runtime_error("Unable to open configuration directory " +
+                                 directory + ": " + error.message());
+    }
+    std::vector<fs::path> files;
+    for (const fs::directory_entry& entry : entries) {
+        if (is_config_file(entry.path().filename().native()) &&
+            entry.is_regular_file(error)) {
+            files.push_back(entry.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    ConfigSnapshot snapshot;
+    for (const fs::path& file : files) {
+        std::string section = file.stem().native();
+        std::unordered_map<std::string, std::string> values;
+        try {
+            values = Config::load(file.native());
+        } catch (const std::exception& e) {
+            if (skipped == nullptr) {
+                throw;
+            }
+            if (!skipped->empty()) {
+                skipped->append("; ");
+            }
+            skipped->append(e.what());
+            continue;
+        }
+        for (const auto& [key, value] : values) {
+            snapshot.set(section, key, value);
+        }
+    }
+    return snapshot;
+}
+
+std::string_view ConfigSnapshot::own(std::string_view text) {
+    return names.emplace_back(text);
+}
+
+void ConfigSnapshot::set(std::string_view section, std::string_view key,
+                         std::string_view value) {
+    auto found = sections.find(section);
+    if (found == sections.end()) {
+        found = sections.emplace(own(section), Section()).first;
+    }
+    Section& values = found->second;
+    auto existing = values.find(key);
+    if (existing != values.end()) {
+        existing->second = ConfigValue(value);
+    } else {
+        values.emplace(own(key), ConfigValue(value));
+    }
+}
+
+const ConfigSnapshot::Section* ConfigSnapshot::section(
+    std::string_view name) const {
+    auto found = sections.find(name);
+    return found == sections.end() ? nullptr : &found->second;
+}
+
+const ConfigValue* ConfigSnapshot::find(std::string_view section,
+                                        std::string_view key) const {
+    const Section* values = this->section(section);
+    if (values == nullptr) {
+        return nullptr;
+    }
+    auto found = values->find(key);
+    return found == values->end() ? nullptr : &found->second;
+}
+
+const ConfigValue& ConfigSnapshot::get(std::string_view section,
+                                       std::string_view key) const {
+    const ConfigValue* value = find(section, key);
+    if (value == nullptr) {
+        throw std::invalid_argument("Configuration value " +
+                                    std::string(section) + "." +
+                                    std::string(key) + " is not set");
+    }
+    return *value;
+}
+
+double ConfigSnapshot::get_double(std::string_view section,
+                                  std::string_view key,
+                                  double fallback) const {
+    const ConfigValue* value = find(section, key);
+    return value == nullptr ? fallback : value->as_double();
+}
+
+std::int64_t ConfigSnapshot::get_int(std::string_view section,
+                                     std::string_view key,
+                                     std::int64_t fallback) const {
+    const ConfigValue* value = find(section, key);
+    return value == nullptr ? fallback : value->as_int();
+}
+
+bool ConfigSnapshot::get_bool(std::string_view section, std::string_view key,
+                              bool fallback) const {
+    const ConfigValue* value = find(section, key);
+    return value == nullptr ? fallback : value->as_bool();
+}
+
+std::size_t ConfigSnapshot::size() const {
+    std::size_t count = 0;
+    for (const auto& [name, values] : sections) {
+        count += values.size();
+    }
+    return count;
+}
+
+ConfigSnapshot ConfigSnapshot::clone() const {
+    ConfigSnapshot copy;
+    for_each([&copy](std::string_view section, std::string_view key,
+                     const ConfigValue& value) {
+        copy.set(section, key, value.text());
+    });
+    return copy;
+}
+
+ConfigStore::ConfigStore(std::string directory)
+    : directory(std::move(directory)) {
+    // There is no previous snapshot to keep, so one broken file must not
+    // take the others down with it
+    published.push_back(std::make_unique<const ConfigSnapshot>(
+        ConfigSnapshot::read_directory(this->directory, error)));
+    snapshot.store(published.back().get(), std::memory_order_release);
+    versions.store(1, std::memory_order_release);
+}
+
+ConfigStore::~ConfigStore() { stop(); }
+
+bool ConfigStore::reload() {
+    std::lock_guard<std::mutex> lock(reload_mutex);
+    std::unique_ptr<const ConfigSnapshot> next;
+    try {
+        next = std::make_unique<const ConfigSnapshot>(
+            ConfigSnapshot::read_directory(directory));
+    } catch (const std::exception& e) {
+        error = e.what();
+        return false;
+    }
+    published.push_back(std::move(next));
+    snapshot.store(published.back().get(), std::memory_order_release);
+    versions.fetch_add(1, std::memory_order_acq_rel);
+    return true;
+}
+
+std::string ConfigStore::last_error() const {
+    std::lock_guard<std::mutex> lock(reload_mutex);
+    return error;
+}
+
+void ConfigStore::watch() {
+    if (watcher.joinable()) {
+        return;
+    }
+    notify_fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (notify_fd < 0) {
+        fail("Unable to watch", directory);
+    }
+    // Editors often save by writing a new file and renaming it over the
+    // old one, so the directory is watched rather than the files
+    if (::inotify_add_watch(notify_fd, directory.c_str(),
+                            IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM |
+                                IN_DELETE | IN_ONLYDIR) < 0) {
+        int saved = errno;
+        ::close(notify_fd);
+        notify_fd = -1;
+        errno = saved;
+        fail("Unable to watch", directory);
+    }
+    wake_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd < 0) {
+        int saved = errno;
+        ::close(notify_fd);
+        notify_fd = -1;
+        errno = saved;
+        fail("Unable to watch", directory);
+    }
+    watcher = std::thread(&ConfigStore::run, this);
+}
+
+void ConfigStore::stop() {
+    if (!watcher.joinable()) {
+        return;
+    }
+    std::uint64_t one = 1;
+    // A full counter still wakes the thread, so the result is not needed
+    [[maybe_unused]] ssize_t written = ::write(wake_fd, &one, sizeof(one));
+    watcher.join();
+    ::close(notify_fd);
+    ::close(wake_fd);
+    notify_fd = -1;
+    wake_fd = -1;
+}
+
+void ConfigStore::run() {
+    alignas(inotify_event) char buffer[4096];
+    pollfd fds[2] = {{notify_fd, POLLIN, 0}, {wake_fd, POLLIN, 0}};
+    bool pending = false;
+    while (true) {
+        // After a change, wait for the burst of events from one save to
+        // settle so the files are read once, complete
+        int ready = ::poll(fds, 2, pending ? SETTLE_MS : -1);
+        if (ready < 0 && errno != EINTR) {
+            return;
+        }
+        if (fds[1].revents != 0) {
+            return;
+        }
+        if (ready == 0) {
+            reload();
+            pending = false;
+            continue;
+        }
+        if (fds[0].revents == 0) {
+            continue;
+        }
+        ssize_t length;
+        while ((length = ::read(notify_fd, buffer, sizeof(buffer))) > 0) {
+            for (ssize_t offset = 0; offset < length;) {
+                const auto* event =
+                    reinterpret_cast<const inotify_event*>(buffer + offset);
+                if (event->mask & IN_IGNORED) {
+                    // The directory itself is gone
+                    return;
+                }
+                if (event->len > 0 && is_config_file(event->name)) {
+                    pending = true;
+                }
+                offset += sizeof(inotify_event) + event->len;
+            }
+        }
+    }
+}
+
+}  // namespace thales
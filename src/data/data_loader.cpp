@@ -21,3 +21,387 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  * SOFTWARE.
  */
+
+#include "data/data_loader.h"
+
+#include <curl/curl.h>
+#include <poll.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include "utils/logging.h"
+
+namespace thales {
+
+namespace {
+
+/** Longest a blocked read waits before re-checking for stop(). */
+constexpr int POLL_INTERVAL_MS = 100;
+
+/** First reconnect delay; doubled after every failed attempt. */
+constexpr int INITIAL_RECONNECT_DELAY_MS = 250;
+
+constexpr std::int64_t NANOSECONDS_PER_MILLISECOND = 1000000;
+
+/**
+ * @brief Forward-only JSON tokenizer over a message, without allocation.
+ */
+class Scanner {
+   public:
+    explicit Scanner(std::string_view text)
+        : p(text.data()), end(text.data() + text.size()) {}
+
+    static bool is_space(char c) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    void skip_space() {
+        while (p < end && is_space(*p)) {
+            ++p;
+        }
+    }
+
+    bool at_end() {
+        skip_space();
+        return p == end;
+    }
+
+    char peek() {
+        skip_space();
+        if (p == end) {
+            fail();
+        }
+        return *p;
+    }
+
+    bool consume(char c) {
+        if (peek() != c) {
+            return false;
+        }
+        ++p;
+        return true;
+    }
+
+    void expect(char c) {
+        if (!consume(c)) {
+            fail();
+        }
+    }
+
+    /**
+     * @brief Reads a string, returning its raw (still escaped) contents.
+     */
+    std::string_view string() {
+        expect('"');
+        const char* begin = p;
+        while (p < end && *p != '"') {
+            p += *p == '\\' ? 2 : 1;
+        }
+        if (p >= end) {
+            fail();
+        }
+        return std::string_view(begin, p++ - begin);
+    }
+
+    double number() {
+        skip_space();
+        double value = 0.0;
+        auto result = std::from_chars(p, end, value);
+        if (result.ec != std::errc()) {
+            fail();
+        }
+        p = result.ptr;
+        return value;
+    }
+
+    void skip_value() {
+        char c = peek();
+        if (c == '"') {
+            string();
+        } else if (c == '{' || c == '[') {
+            int depth = 0;
+            do {
+                if (*p == '"') {
+                    string();
+                    continue;
+                }
+                depth += (*p == '{' || *p == '[') - (*p == '}' || *p == ']');
+                ++p;
+            } while (depth > 0 && p < end);
+            if (depth > 0) {
+                fail();
+            }
+        } else {
+            // Number or literal
+            const char* begin = p;
+            while (p < end && *p != ',' && *p != '}' && *p != ']' &&
+                   !is_space(*p)) {
+                ++p;
+            }
+            if (p == begin) {
+                fail();
+            }
+        }
+    }
+
+    [[noreturn]] static void fail() {
+        throw std::invalid_argument("Malformed feed message");
+    }
+
+   private:
+    const char* p;
+    const char* end;
+};
+
+/**
+ * @brief Fields of one feed event that the parser cares about.
+ */
+struct Event {
+    std::string_view type;
+    std::string_view symbol;
+    std::string_view status;
+    Quote quote = {};
+};
+
+void parse_event(Scanner& in, Event& event) {
+    in.expect('{');
+    if (in.consume('}')) {
+        return;
+    }
+    do {
+        std::string_view key = in.string();
+        in.expect(':');
+        if (key == "ev") {
+            event.type = in.string();
+        } else if (key == "sym") {
+            event.symbol = in.string();
+        } else if (key == "status") {
+            event.status = in.string();
+        } else if (key == "bp") {
+            event.quote.bid_price = in.number();
+        } else if (key == "ap") {
+            event.quote.ask_price = in.number();
+        } else if (key == "bs") {
+            event.quote.bid_size = static_cast<std::uint32_t>(in.number());
+        } else if (key == "as") {
+            event.quote.ask_size = static_cast<std::uint32_t>(in.number());
+        } else if (key == "t") {
+            event.quote.timestamp_ns =
+                std::llround(in.number()) * NANOSECONDS_PER_MILLISECOND;
+        } else {
+            in.skip_value();
+        }
+    } while (in.consume(','));
+    in.expect('}');
+}
+
+struct CurlDeleter {
+    void operator()(CURL* easy) const { curl_easy_cleanup(easy); }
+};
+
+/**
+ * @brief Sends one text frame, retrying while the socket is busy.
+ */
+CURLcode send_text(CURL* easy, const std::string& text) {
+    std::size_t offset = 0;
+    while (offset < text.size()) {
+        std::size_t sent = 0;
+        CURLcode result = curl_ws_send(easy, text.data() + offset,
+                                       text.size() - offset, &sent, 0,
+                                       CURLWS_TEXT);
+        if (result != CURLE_OK && result != CURLE_AGAIN) {
+            return result;
+        }
+        offset += sent;
+    }
+    return CURLE_OK;
+}
+
+}  // namespace
+
+std::size_t PolygonFeedParser::parse(std::string_view message,
+                                     std::vector<Quote>& quotes) {
+    Scanner in(message);
+    std::size_t count = 0;
+    bool array = in.consume('[');
+    if (array && in.consume(']')) {
+        return 0;
+    }
+    do {
+        Event event;
+        parse_event(in, event);
+        if (event.type == "Q" && !event.symbol.empty()) {
+            event.quote.symbol = SymbolTable::intern(event.symbol);
+            quotes.push_back(event.quote);
+            ++count;
+        } else if (event.type == "status") {
+            last_status.assign(event.status);
+        }
+    } while (array && in.consume(','));
+    if (array) {
+        in.expect(']');
+    }
+    if (!in.at_end()) {
+        Scanner::fail();
+    }
+    return count;
+}
+
+MarketDataStream::MarketDataStream(MarketDataStreamSettings settings,
+                                   QuoteQueue& queue)
+    : settings(std::move(settings)), queue(queue) {}
+
+MarketDataStream::~MarketDataStream() { stop(); }
+
+void MarketDataStream::start() {
+    if (thread.joinable()) {
+        return;
+    }
+    stopping = false;
+    thread = std::thread([this] { run(); });
+}
+
+void MarketDataStream::stop() {
+    stopping = true;
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+std::string MarketDataStream::last_error() const {
+    std::lock_guard<std::mutex> lock(error_mutex);
+    return error;
+}
+
+void MarketDataStream::set_error(std::string message) {
+    std::lock_guard<std::mutex> lock(error_mutex);
+    error = std::move(message);
+}
+
+void MarketDataStream::run() {
+    try {
+        pin_current_thread(settings.placement.cpus);
+    } catch (const std::exception& e) {
+        LOG_WARN("Market data thread left unpinned: {}",
+                 std::string_view(e.what()));
+    }
+    int delay_ms = INITIAL_RECONNECT_DELAY_MS;
+    while (!stopping) {
+        if (stream_once()) {
+            delay_ms = INITIAL_RECONNECT_DELAY_MS;
+        }
+        // Back off in short sleeps so that stop() stays responsive
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(delay_ms);
+        while (!stopping && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(
+                std::chrono::milliseconds(POLL_INTERVAL_MS / 4));
+        }
+        delay_ms = std::min(delay_ms * 2, settings.max_reconnect_delay_ms);
+    }
+}
+
+bool MarketDataStream::stream_once() {
+    std::unique_ptr<CURL, CurlDeleter> easy(curl_easy_init());
+    if (!easy) {
+        set_error("Failed to create curl handle");
+        return false;
+    }
+    curl_easy_setopt(easy.get(), CURLOPT_URL, settings.url.c_str());
+    curl_easy_setopt(easy.get(), CURLOPT_CONNECT_ONLY, 2L);  // WebSocket
+    curl_easy_setopt(easy.get(), CURLOPT_NOSIGNAL, 1L);
+    CURLcode result = curl_easy_perform(easy.get());
+    if (result != CURLE_OK) {
+        set_error(curl_easy_strerror(result));
+        return false;
+    }
+
+    std::string subscribe;
+    for (const auto& channel : settings.subscriptions) {
+        subscribe += (subscribe.empty() ? "" : ",") + channel;
+    }
+    result = send_text(easy.get(), "{\"action\":\"auth\",\"params\":\"" +
+                                       settings.api_key + "\"}");
+    if (result == CURLE_OK && !subscribe.empty()) {
+        result = send_text(easy.get(),
+                           "{\"action\":\"subscribe\",\"params\":\"" +
+                               subscribe + "\"}");
+    }
+    if (result != CURLE_OK) {
+        set_error(curl_easy_strerror(result));
+        return false;
+    }
+
+    curl_socket_t socket = CURL_SOCKET_BAD;
+    curl_easy_getinfo(easy.get(), CURLINFO_ACTIVESOCKET, &socket);
+
+    PolygonFeedParser parser;
+    std::string message;
+    std::vector<Quote> quotes;
+    char buffer[64 * 1024];
+    bool healthy = false;
+    IdleWaiter waiter(settings.placement.wait);
+    while (!stopping) {
+        std::size_t length = 0;
+        curl_ws_frame* frame = nullptr;
+        result = curl_ws_recv(easy.get(), buffer, sizeof(buffer), &length,
+                              &frame);
+        if (result == CURLE_AGAIN) {
+            if (waiter.parking()) {
+                pollfd descriptor = {socket, POLLIN, 0};
+                ::poll(&descriptor, 1, POLL_INTERVAL_MS);
+            } else {
+                waiter.idle();
+            }
+            continue;
+        }
+        waiter.reset();
+        if (result != CURLE_OK) {
+            set_error(curl_easy_strerror(result));
+            return healthy;
+        }
+        if (frame->flags & CURLWS_CLOSE) {
+            set_error("Connection closed by server");
+            return healthy;
+        }
+        if (!(frame->flags & (CURLWS_TEXT | CURLWS_CONT))) {
+            continue;  // Pings are answered by libcurl
+        }
+
+        // A message may span several reads and several frames
+        message.append(buffer, length);
+        if (frame->bytesleft > 0 || (frame->flags & CURLWS_CONT)) {
+            continue;
+        }
+        quotes.clear();
+        try {
+            parser.parse(message, quotes);
+        } catch (const std::invalid_argument& e) {
+            set_error(e.what());
+        }
+        message.clear();
+        for (const Quote& quote : quotes) {
+            if (queue.try_push(quote)) {
+                ++received;
+            } else {
+                ++dropped;
+            }
+        }
+        healthy = true;
+        if (parser.status() == "auth_failed") {
+            // Retrying cannot help with a rejected key
+            set_error("Polygon authentication failed");
+            stopping = true;
+        }
+    }
+    return healthy;
+}
+
+}  // namespace thales
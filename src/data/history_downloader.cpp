@@ -0,0 +1,327 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "data/history_downloader.h"
+
+#include <algorithm>
+#include <deque>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "config/config_store.h"
+#include "data/tick_store.h"
+#include "utils/date.h"
+#include "utils/logging.h"
+#include "utils/metrics.h"
+
+namespace thales {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/** How long to wait on the oldest request before checking the others. */
+constexpr auto POLL_INTERVAL = std::chrono::milliseconds(2);
+
+/** Current UTC day, in days since epoch. */
+std::int32_t utc_today() {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    return static_cast<std::int32_t>(
+        std::chrono::duration_cast<std::chrono::hours>(now).count() / 24);
+}
+
+/** Drops the scheme and host of an absolute URL. */
+std::string path_of(std::string_view url) {
+    std::size_t scheme = url.find("://");
+    if (scheme != std::string_view::npos) {
+        std::size_t path = url.find('/', scheme + 3);
+        url = path == std::string_view::npos ? std::string_view("/")
+                                             : url.substr(path);
+    }
+    return std::string(url);
+}
+
+}  // namespace
+
+HistoryDownloadSettings HistoryDownloadSettings::load(
+    const ConfigSnapshot& config) {
+    HistoryDownloadSettings settings;
+    if (const ConfigValue* key = config.find("polygon_credentials",
+                                             "API_KEY")) {
+        settings.api_key = key->text();
+    }
+    if (const ConfigValue* url = config.find(CONFIG_SECTION,
+                                             "HISTORY_BASE_URL")) {
+        settings.base_url = url->text();
+    }
+    if (const ConfigValue* dir = config.find(CONFIG_SECTION,
+                                             "HISTORY_CACHE_DIR")) {
+        settings.cache_directory = dir->text();
+    }
+    settings.requests_per_second =
+        config.get_double(CONFIG_SECTION, "HISTORY_REQUESTS_PER_MINUTE",
+                          settings.requests_per_second * 60.0) /
+        60.0;
+    settings.request_burst = config.get_double(
+        CONFIG_SECTION, "HISTORY_REQUEST_BURST", settings.request_burst);
+    std::int64_t in_flight = config.get_int(
+        CONFIG_SECTION, "HISTORY_MAX_IN_FLIGHT",
+        static_cast<std::int64_t>(settings.max_in_flight));
+    std::int64_t attempts = config.get_int(
+        CONFIG_SECTION, "HISTORY_MAX_ATTEMPTS", settings.max_attempts);
+    std::int64_t delay = config.get_int(CONFIG_SECTION,
+                                        "HISTORY_RETRY_DELAY_MS",
+                                        settings.retry_delay.count());
+    if (in_flight < 1 || attempts < 1 || delay < 0) {
+        throw std::invalid_argument("Invalid history download settings in " +
+                                    std::string(CONFIG_SECTION) + ".cfg");
+    }
+    settings.max_in_flight = static_cast<std::size_t>(in_flight);
+    settings.max_attempts = static_cast<int>(attempts);
+    settings.retry_delay = std::chrono::milliseconds(delay);
+    return settings;
+}
+
+/**
+ * @brief One page waiting to be fetched.
+ */
+struct HistoryDownloader::Page {
+    const HistoryRequest* request = nullptr;
+    std::string path;             /**< Path and query; the cache key */
+    int attempts = 0;             /**< Failed attempts so far */
+    Clock::time_point not_before; /**< Earliest retry */
+};
+
+HistoryDownloader::HistoryDownloader(HttpClient& http,
+                                     HistoryDownloadSettings settings)
+    : http(http),
+      settings(std::move(settings)),
+      bucket(this->settings.requests_per_second,
+             this->settings.request_burst) {
+    if (this->settings.max_in_flight == 0 || this->settings.max_attempts < 1) {
+        throw std::invalid_argument(
+            "A download needs at least one request in flight and attempt");
+    }
+    if (!this->settings.cache_directory.empty()) {
+        cache = std::make_unique<ResponseCache>(
+            this->settings.cache_directory);
+    }
+}
+
+std::vector<HistoryRequest> HistoryDownloader::plan_aggregates(
+    const std::vector<std::string>& tickers, std::int32_t first_day,
+    std::int32_t last_day, int multiplier, std::string_view timespan,
+    std::int32_t days_per_request) {
+    if (last_day < first_day) {
+        throw std::invalid_argument("History range is empty");
+    }
+    if (multiplier < 1 || days_per_request < 1) {
+        throw std::invalid_argument(
+            "Bar size and days per request must be positive");
+    }
+    std::vector<HistoryRequest> plan;
+    std::int32_t spans = (last_day - first_day) / days_per_request + 1;
+    plan.reserve(tickers.size() * static_cast<std::size_t>(spans));
+    for (const std::string& ticker : tickers) {
+        for (std::int32_t from = first_day; from <= last_day;
+             from += days_per_request) {
+            std::int32_t to = std::min(last_day, from + days_per_request - 1);
+            std::string path = "/v2/aggs/ticker/" + ticker + "/range/" +
+                               std::to_string(multiplier) + "/" +
+                               std::string(timespan) + "/" +
+                               format_date(from) + "/" + format_date(to) +
+                               "?adjusted=true&sort=asc&limit=50000";
+            plan.push_back({ticker, from, to, std::move(path)});
+        }
+    }
+    return plan;
+}
+
+std::string HistoryDownloader::url(const std::string& path) const {
+    std::string url = settings.base_url + path;
+    if (!settings.api_key.empty()) {
+        url += path.find('?') == std::string::npos ? "?apiKey=" : "&apiKey=";
+        url += settings.api_key;
+    }
+    return url;
+}
+
+HistoryDownloadStats HistoryDownloader::download(
+    const std::vector<HistoryRequest>& requests, const PageHandler& handler) {
+    struct InFlight {
+        Page page;
+        std::future<HttpResponse> response;
+    };
+
+    HistoryDownloadStats stats;
+    stats.requests = requests.size();
+    const std::int32_t today = utc_today();
+
+    std::deque<Page> queue;
+    for (const HistoryRequest& request : requests) {
+        queue.push_back({&request, request.path, 0, {}});
+    }
+    std::deque<Page> retries;
+    std::deque<InFlight> in_flight;
+
+    auto cacheable = [&](const Page& page) {
+        return cache != nullptr && page.request->last_day < today;
+    };
+
+    // Hands a page to the caller, then caches it and queues the next one
+    // before any other request so each request finishes as soon as it can
+    auto deliver = [&](const Page& page, std::string_view body,
+                       bool from_cache) {
+        std::string next;
+        try {
+            handler(*page.request, body);
+            next = path_of(parser.next_url(body));
+        } catch (const std::exception& e) {
+            ++stats.failed;
+            LOG_WARN("History page {} rejected: {}", page.path,
+                     std::string_view(e.what()));
+            return;
+        }
+        ++stats.pages;
+        if (!from_cache && cacheable(page)) {
+            try {
+                cache->store(page.path, body);
+            } catch (const std::exception& e) {
+                LOG_WARN("{}", std::string_view(e.what()));
+            }
+        }
+        if (!next.empty() && next != "/") {
+            queue.push_front({page.request, std::move(next), 0, {}});
+        }
+    };
+
+    auto take_ready = [&](Page& page) {
+        Clock::time_point now = Clock::now();
+        for (auto it = retries.begin(); it != retries.end(); ++it) {
+            if (it->not_before <= now) {
+                page = std::move(*it);
+                retries.erase(it);
+                return true;
+            }
+        }
+        if (queue.empty()) {
+            return false;
+        }
+        page = std::move(queue.front());
+        queue.pop_front();
+        return true;
+    };
+
+    while (!queue.empty() || !retries.empty() || !in_flight.empty()) {
+        Page page;
+        while (in_flight.size() < settings.max_in_flight && take_ready(page)) {
+            std::string body;
+            if (cacheable(page) && cache->load(page.path, body)) {
+                ++stats.cache_hits;
+                METRIC_COUNT("thales_history_cache_hits_total",
+                             "History pages served from the cache", 1);
+                deliver(page, body, true);
+                continue;
+            }
+            bucket.acquire();
+            std::future<HttpResponse> response =
+                http.get_async(url(page.path));
+            in_flight.push_back({std::move(page), std::move(response)});
+        }
+
+        if (in_flight.empty()) {
+            // Only backed-off retries are left
+            if (!retries.empty()) {
+                auto next = std::min_element(
+                    retries.begin(), retries.end(),
+                    [](const Page& a, const Page& b) {
+                        return a.not_before < b.not_before;
+                    });
+                std::this_thread::sleep_until(next->not_before);
+            }
+            continue;
+        }
+
+        // Wait on the oldest request, but take any that completes first
+        std::size_t done = in_flight.size();
+        if (in_flight.front().response.wait_for(POLL_INTERVAL) ==
+            std::future_status::ready) {
+            done = 0;
+        } else {
+            for (std::size_t i = 1; i < in_flight.size(); ++i) {
+                if (in_flight[i].response.wait_for(std::chrono::seconds(0)) ==
+                    std::future_status::ready) {
+                    done = i;
+                    break;
+                }
+            }
+        }
+        if (done == in_flight.size()) {
+            continue;
+        }
+        InFlight finished = std::move(in_flight[done]);
+        in_flight.erase(in_flight.begin() +
+                        static_cast<std::ptrdiff_t>(done));
+        HttpResponse response = finished.response.get();
+
+        if (response.ok()) {
+            ++stats.fetched;
+            METRIC_COUNT("thales_history_pages_fetched_total",
+                         "History pages fetched from Polygon", 1);
+            stats.bytes_fetched += response.body.size();
+            deliver(finished.page, response.body, false);
+            continue;
+        }
+        bool retryable = !response.error.empty() || response.status == 429 ||
+                         response.status >= 500;
+        if (response.status == 429) {
+            bucket.drain();
+        }
+        Page& failed = finished.page;
+        if (retryable && ++failed.attempts < settings.max_attempts) {
+            ++stats.retries;
+            int doublings = std::min(failed.attempts - 1, 16);
+            failed.not_before =
+                Clock::now() + settings.retry_delay * (1 << doublings);
+            retries.push_back(std::move(failed));
+            continue;
+        }
+        ++stats.failed;
+        LOG_WARN("History page {} failed with status {}: {}", failed.path,
+                 response.status, response.error);
+    }
+    return stats;
+}
+
+HistoryDownloadStats HistoryDownloader::import_aggregates(
+    const std::vector<HistoryRequest>& requests, PolygonImporter& importer) {
+    return download(requests,
+                    [&importer](const HistoryRequest&, std::string_view body) {
+                        importer.import_aggregates(body);
+                    });
+}
+
+}  // namespace thales
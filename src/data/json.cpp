@@ -0,0 +1,271 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "data/json.h"
+
+#include <charconv>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+
+#include "json_stage1.h"
+
+namespace thales {
+
+namespace json {
+
+std::size_t build_index_scalar(const char* text, std::size_t size,
+                               std::uint32_t* index) {
+    return build_index(text, size, index, [](const char* block) {
+        BlockMasks masks = {0, 0, 0};
+        for (std::size_t i = 0; i < BLOCK_SIZE; ++i) {
+            std::uint64_t bit = std::uint64_t{1} << i;
+            switch (block[i]) {
+                case '"':
+                    masks.quote |= bit;
+                    break;
+                case '\\':
+                    masks.backslash |= bit;
+                    break;
+                case '{':
+                case '}':
+                case '[':
+                case ']':
+                case ':':
+                case ',':
+                    masks.structural |= bit;
+                    break;
+                default:
+                    break;
+            }
+        }
+        return masks;
+    });
+}
+
+}  // namespace json
+
+namespace {
+
+[[noreturn]] void fail() { throw std::invalid_argument("Malformed JSON"); }
+
+bool is_space(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+}  // namespace
+
+JsonParser::JsonParser(SimdBackend backend) {
+    switch (backend) {
+        case SimdBackend::SCALAR:
+            build_index = json::build_index_scalar;
+            return;
+#if defined(THALES_HAVE_AVX2)
+        case SimdBackend::AVX2:
+            if (!__builtin_cpu_supports("avx2")) {
+                break;
+            }
+            build_index = json::build_index_avx2;
+            return;
+#endif
+        case SimdBackend::AUTO:
+#if defined(THALES_HAVE_AVX2)
+            build_index = __builtin_cpu_supports("avx2")
+                              ? json::build_index_avx2
+                              : json::build_index_scalar;
+#else
+            build_index = json::build_index_scalar;
+#endif
+            return;
+        default:
+            break;
+    }
+    throw std::invalid_argument("SIMD backend not supported");
+}
+
+JsonCursor JsonParser::parse(std::string_view text) {
+    if (text.size() >= std::numeric_limits<std::uint32_t>::max()) {
+        throw std::invalid_argument("JSON document too large");
+    }
+    std::size_t needed = text.size() + json::BLOCK_SIZE;
+    if (capacity < needed) {
+        index.reset(new std::uint32_t[needed]);
+        capacity = needed;
+    }
+    std::size_t count = build_index(text.data(), text.size(), index.get());
+    if (count > text.size()) {
+        throw std::invalid_argument("Unterminated JSON string");
+    }
+    return JsonCursor(text, index.get(), count);
+}
+
+std::size_t JsonCursor::structural(std::size_t i, char expected) const {
+    if (i >= count || text[index[i]] != expected) {
+        fail();
+    }
+    return index[i];
+}
+
+std::size_t JsonCursor::value_start() {
+    while (position < text.size() && is_space(text[position])) {
+        ++position;
+    }
+    if (position >= text.size()) {
+        fail();
+    }
+    return position;
+}
+
+std::size_t JsonCursor::scalar_end() const {
+    return next_index < count ? index[next_index] : text.size();
+}
+
+char JsonCursor::peek() { return text[value_start()]; }
+
+bool JsonCursor::begin_object() {
+    std::size_t start = value_start();
+    if (structural(next_index, '{') != start) {
+        fail();
+    }
+    ++next_index;
+    position = start + 1;
+    if (peek() == '}') {
+        position = structural(next_index++, '}') + 1;
+        return false;
+    }
+    return true;
+}
+
+bool JsonCursor::begin_array() {
+    std::size_t start = value_start();
+    if (structural(next_index, '[') != start) {
+        fail();
+    }
+    ++next_index;
+    position = start + 1;
+    if (peek() == ']') {
+        position = structural(next_index++, ']') + 1;
+        return false;
+    }
+    return true;
+}
+
+std::string_view JsonCursor::key() {
+    std::string_view name = get_string();
+    position = structural(next_index++, ':') + 1;
+    return name;
+}
+
+bool JsonCursor::next() {
+    if (next_index >= count) {
+        fail();
+    }
+    std::size_t at = index[next_index];
+    for (std::size_t p = position; p < at; ++p) {
+        if (!is_space(text[p])) {
+            fail();
+        }
+    }
+    char c = text[at];
+    if (c != ',' && c != '}' && c != ']') {
+        fail();
+    }
+    ++next_index;
+    position = at + 1;
+    return c == ',';
+}
+
+bool JsonCursor::is_null() {
+    std::size_t start = value_start();
+    if (text.compare(start, 4, "null") != 0) {
+        return false;
+    }
+    position = start + 4;
+    return true;
+}
+
+double JsonCursor::get_number() {
+    std::size_t start = value_start();
+    double value = 0.0;
+    auto result = std::from_chars(text.data() + start,
+                                  text.data() + scalar_end(), value);
+    if (result.ec != std::errc()) {
+        fail();
+    }
+    position = result.ptr - text.data();
+    return value;
+}
+
+std::string_view JsonCursor::get_string() {
+    std::size_t start = value_start();
+    if (structural(next_index, '"') != start) {
+        fail();
+    }
+    std::size_t end = structural(next_index + 1, '"');
+    next_index += 2;
+    position = end + 1;
+    return text.substr(start + 1, end - start - 1);
+}
+
+void JsonCursor::skip() {
+    std::size_t start = value_start();
+    char c = text[start];
+    if (c == '"') {
+        get_string();
+    } else if (c == '{' || c == '[') {
+        if (next_index >= count || index[next_index] != start) {
+            fail();
+        }
+        // Strings are indexed as quote pairs and never contain brackets
+        int depth = 0;
+        do {
+            if (next_index >= count) {
+                fail();
+            }
+            char s = text[index[next_index++]];
+            depth += (s == '{' || s == '[') - (s == '}' || s == ']');
+        } while (depth > 0);
+        position = index[next_index - 1] + 1;
+    } else {
+        std::size_t end = scalar_end();
+        while (end > start && is_space(text[end - 1])) {
+            --end;
+        }
+        if (end == start) {
+            fail();
+        }
+        position = end;
+    }
+}
+
+void JsonCursor::expect_end() {
+    while (position < text.size() && is_space(text[position])) {
+        ++position;
+    }
+    if (position != text.size() || next_index != count) {
+        fail();
+    }
+}
+
+}  // namespace thales
@@ -0,0 +1,80 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Compiled with -mavx2; only reached after a runtime CPU check.
+
+#include <immintrin.h>
+
+#include <initializer_list>
+
+#include "json_stage1.h"
+
+namespace thales {
+namespace json {
+
+namespace {
+
+std::uint64_t movemask(__m256i lo, __m256i hi) {
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(lo)) |
+           static_cast<std::uint64_t>(
+               static_cast<std::uint32_t>(_mm256_movemask_epi8(hi)))
+               << 32;
+}
+
+BlockMasks classify(const char* block) {
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    __m256i hi =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+    auto equal = [&](char c, __m256i& out_lo, __m256i& out_hi) {
+        __m256i v = _mm256_set1_epi8(c);
+        out_lo = _mm256_cmpeq_epi8(lo, v);
+        out_hi = _mm256_cmpeq_epi8(hi, v);
+    };
+
+    __m256i quote_lo, quote_hi, backslash_lo, backslash_hi;
+    equal('"', quote_lo, quote_hi);
+    equal('\\', backslash_lo, backslash_hi);
+
+    __m256i structural_lo = _mm256_setzero_si256();
+    __m256i structural_hi = _mm256_setzero_si256();
+    for (char c : {'{', '}', '[', ']', ':', ','}) {
+        __m256i eq_lo, eq_hi;
+        equal(c, eq_lo, eq_hi);
+        structural_lo = _mm256_or_si256(structural_lo, eq_lo);
+        structural_hi = _mm256_or_si256(structural_hi, eq_hi);
+    }
+    return {movemask(quote_lo, quote_hi),
+            movemask(backslash_lo, backslash_hi),
+            movemask(structural_lo, structural_hi)};
+}
+
+}  // namespace
+
+std::size_t build_index_avx2(const char* text, std::size_t size,
+                             std::uint32_t* index) {
+    return build_index(text, size, index, classify);
+}
+
+}  // namespace json
+}  // namespace thales
@@ -0,0 +1,128 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace thales {
+namespace json {
+
+/** Bytes classified per step of the first pass. */
+constexpr std::size_t BLOCK_SIZE = 64;
+
+/**
+ * @brief Character classes of one 64-byte block, one bit per byte.
+ */
+struct BlockMasks {
+    std::uint64_t quote;      /**< '"' */
+    std::uint64_t backslash;  /**< '\\' */
+    std::uint64_t structural; /**< '{', '}', '[', ']', ':' and ',' */
+};
+
+/**
+ * @brief Sets every bit that has an odd number of set bits at or below it.
+ */
+inline std::uint64_t prefix_xor(std::uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+/**
+ * @brief Finds characters escaped by a backslash.
+ *
+ * A character is escaped when it follows an odd-length run of backslashes;
+ * runs are told apart by the parity of their starting bit, using one
+ * addition to propagate them. Runs may continue across blocks through
+ * prev_escaped.
+ */
+inline std::uint64_t find_escaped(std::uint64_t backslash,
+                                  std::uint64_t& prev_escaped) {
+    constexpr std::uint64_t EVEN_BITS = 0x5555555555555555ULL;
+    backslash &= ~prev_escaped;
+    std::uint64_t follows_escape = (backslash << 1) | prev_escaped;
+    std::uint64_t odd_starts = backslash & ~EVEN_BITS & ~follows_escape;
+    std::uint64_t even_runs = 0;
+    prev_escaped = __builtin_add_overflow(odd_starts, backslash, &even_runs);
+    std::uint64_t invert = even_runs << 1;
+    return (EVEN_BITS ^ invert) & follows_escape;
+}
+
+/**
+ * @brief Writes the offsets of structural characters outside strings and
+ * of every unescaped quote.
+ *
+ * @tparam Classify Callable mapping 64 readable bytes to BlockMasks.
+ * @param text The document.
+ * @param size Length of the document.
+ * @param index Output with room for size + BLOCK_SIZE offsets.
+ * @return The number of offsets written, or size + 1 if a string is left
+ *         unterminated.
+ */
+template <typename Classify>
+std::size_t build_index(const char* text, std::size_t size,
+                        std::uint32_t* index, Classify classify) {
+    std::uint64_t prev_escaped = 0;
+    std::uint64_t prev_in_string = 0;
+    std::size_t count = 0;
+    for (std::size_t base = 0; base < size; base += BLOCK_SIZE) {
+        const char* block = text + base;
+        char tail[BLOCK_SIZE];
+        if (size - base < BLOCK_SIZE) {
+            std::memset(tail, ' ', BLOCK_SIZE);
+            std::memcpy(tail, block, size - base);
+            block = tail;
+        }
+        BlockMasks masks = classify(block);
+        std::uint64_t escaped = find_escaped(masks.backslash, prev_escaped);
+        std::uint64_t quotes = masks.quote & ~escaped;
+        // Covers each opening quote up to, not including, its closing quote
+        std::uint64_t in_string = prefix_xor(quotes) ^ prev_in_string;
+        prev_in_string = static_cast<std::uint64_t>(
+            static_cast<std::int64_t>(in_string) >> 63);
+
+        std::uint64_t bits = (masks.structural & ~in_string) | quotes;
+        while (bits != 0) {
+            index[count++] =
+                static_cast<std::uint32_t>(base + __builtin_ctzll(bits));
+            bits &= bits - 1;
+        }
+    }
+    return prev_in_string != 0 ? size + 1 : count;
+}
+
+std::size_t build_index_scalar(const char* text, std::size_t size,
+                               std::uint32_t* index);
+std::size_t build_index_avx2(const char* text, std::size_t size,
+                             std::uint32_t* index);
+
+}  // namespace json
+}  // namespace thales
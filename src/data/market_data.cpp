@@ -0,0 +1,123 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "data/market_data.h"
+
+#include <limits>
+
+namespace thales {
+
+namespace {
+
+constexpr double MISSING = std::numeric_limits<double>::quiet_NaN();
+
+}  // namespace
+
+void BarColumns::clear() {
+    symbol.clear();
+    timestamp_ns.clear();
+    open.clear();
+    high.clear();
+    low.clear();
+    close.clear();
+    volume.clear();
+    vwap.clear();
+    trades.clear();
+}
+
+void BarColumns::reserve(std::size_t capacity) {
+    symbol.reserve(capacity);
+    timestamp_ns.reserve(capacity);
+    open.reserve(capacity);
+    high.reserve(capacity);
+    low.reserve(capacity);
+    close.reserve(capacity);
+    volume.reserve(capacity);
+    vwap.reserve(capacity);
+    trades.reserve(capacity);
+}
+
+std::size_t BarColumns::append() {
+    symbol.push_back(INVALID_SYMBOL);
+    timestamp_ns.push_back(0);
+    open.push_back(0.0);
+    high.push_back(0.0);
+    low.push_back(0.0);
+    close.push_back(0.0);
+    volume.push_back(0.0);
+    vwap.push_back(0.0);
+    trades.push_back(0);
+    return size() - 1;
+}
+
+void OptionChainColumns::clear() {
+    contract.clear();
+    underlying.clear();
+    type.clear();
+    strike.clear();
+    expiration.clear();
+    bid.clear();
+    ask.clear();
+    bid_size.clear();
+    ask_size.clear();
+    timestamp_ns.clear();
+    implied_volatility.clear();
+    open_interest.clear();
+    underlying_price.clear();
+}
+
+void OptionChainColumns::reserve(std::size_t capacity) {
+    contract.reserve(capacity);
+    underlying.reserve(capacity);
+    type.reserve(capacity);
+    strike.reserve(capacity);
+    expiration.reserve(capacity);
+    bid.reserve(capacity);
+    ask.reserve(capacity);
+    bid_size.reserve(capacity);
+    ask_size.reserve(capacity);
+    timestamp_ns.reserve(capacity);
+    implied_volatility.reserve(capacity);
+    open_interest.reserve(capacity);
+    underlying_price.reserve(capacity);
+}
+
+std::size_t OptionChainColumns::append() {
+    contract.push_back(INVALID_SYMBOL);
+    underlying.push_back(INVALID_SYMBOL);
+    type.push_back(CALL);
+    strike.push_back(MISSING);
+    expiration.push_back(0);
+    bid.push_back(MISSING);
+    ask.push_back(MISSING);
+    bid_size.push_back(0);
+    ask_size.push_back(0);
+    timestamp_ns.push_back(0);
+    implied_volatility.push_back(MISSING);
+    open_interest.push_back(0.0);
+    underlying_price.push_back(MISSING);
+    return size() - 1;
+}
+
+}  // namespace thales
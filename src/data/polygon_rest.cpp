@@ -0,0 +1,236 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "data/polygon_rest.h"
+
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "trading/contract_types.h"
+#include "utils/date.h"
+
+namespace thales {
+
+namespace {
+
+constexpr std::int64_t NANOSECONDS_PER_MILLISECOND = 1000000;
+
+/**
+ * @brief Top-level fields shared by every Polygon response.
+ */
+struct Envelope {
+    std::string_view status;
+    std::string_view error;
+
+    /** @brief Consumes the value of key if it is an envelope field. */
+    bool read(std::string_view key, JsonCursor& in) {
+        if (key == "status") {
+            status = in.get_string();
+        } else if (key == "error" || key == "message") {
+            error = in.get_string();
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    /** @brief Throws if Polygon reported a failure. */
+    void check() const {
+        if (status == "ERROR" || status == "NOT_AUTHORIZED" ||
+            status == "NOT_FOUND") {
+            throw std::runtime_error(
+                "Polygon request failed: " +
+                std::string(error.empty() ? status : error));
+        }
+    }
+};
+
+std::uint32_t get_count(JsonCursor& in) {
+    return static_cast<std::uint32_t>(std::llround(in.get_number()));
+}
+
+std::int64_t get_milliseconds(JsonCursor& in) {
+    return std::llround(in.get_number()) * NANOSECONDS_PER_MILLISECOND;
+}
+
+}  // namespace
+
+std::size_t PolygonRestParser::parse_aggregates(std::string_view body,
+                                                BarColumns& bars) {
+    JsonCursor in = json.parse(body);
+    std::size_t first = bars.size();
+    SymbolId ticker = INVALID_SYMBOL;
+    Envelope envelope;
+
+    in.for_each_field([&](std::string_view key) {
+        if (key == "results") {
+            if (in.is_null()) {
+                return;
+            }
+            in.for_each_element([&] {
+                std::size_t row = bars.append();
+                in.for_each_field([&](std::string_view field) {
+                    if (field == "o") {
+                        bars.open[row] = in.get_number();
+                    } else if (field == "h") {
+                        bars.high[row] = in.get_number();
+                    } else if (field == "l") {
+                        bars.low[row] = in.get_number();
+                    } else if (field == "c") {
+                        bars.close[row] = in.get_number();
+                    } else if (field == "v") {
+                        bars.volume[row] = in.get_number();
+                    } else if (field == "vw") {
+                        bars.vwap[row] = in.get_number();
+                    } else if (field == "n") {
+                        bars.trades[row] = get_count(in);
+                    } else if (field == "t") {
+                        bars.timestamp_ns[row] = get_milliseconds(in);
+                    } else if (field == "T") {
+                        bars.symbol[row] = SymbolTable::intern(in.get_string());
+                    } else {
+                        in.skip();
+                    }
+                });
+            });
+        } else if (key == "ticker") {
+            ticker = SymbolTable::intern(in.get_string());
+        } else if (!envelope.read(key, in)) {
+            in.skip();
+        }
+    });
+    in.expect_end();
+    envelope.check();
+
+    // The ticker may come after the results it applies to
+    for (std::size_t row = first; row < bars.size(); ++row) {
+        if (bars.symbol[row] == INVALID_SYMBOL) {
+            if (ticker == INVALID_SYMBOL) {
+                throw std::invalid_argument("Aggregates without a ticker");
+            }
+            bars.symbol[row] = ticker;
+        }
+    }
+    return bars.size() - first;
+}
+
+std::size_t PolygonRestParser::parse_option_chain(std::string_view body,
+                                                  OptionChainColumns& chain) {
+    JsonCursor in = json.parse(body);
+    std::size_t first = chain.size();
+    Envelope envelope;
+
+    in.for_each_field([&](std::string_view key) {
+        if (key != "results") {
+            if (!envelope.read(key, in)) {
+                in.skip();
+            }
+            return;
+        }
+        if (in.is_null()) {
+            return;
+        }
+        in.for_each_element([&] {
+            std::size_t row = chain.append();
+            in.for_each_field([&](std::string_view field) {
+                if (field == "details") {
+                    in.for_each_field([&](std::string_view detail) {
+                        if (detail == "ticker") {
+                            chain.contract[row] =
+                                SymbolTable::intern(in.get_string());
+                        } else if (detail == "contract_type") {
+                            chain.type[row] =
+                                parse_option_type(in.get_string());
+                        } else if (detail == "strike_price") {
+                            chain.strike[row] = in.get_number();
+                        } else if (detail == "expiration_date") {
+                            chain.expiration[row] =
+                                parse_date(in.get_string());
+                        } else {
+                            in.skip();
+                        }
+                    });
+                } else if (field == "last_quote") {
+                    in.for_each_field([&](std::string_view quote) {
+                        if (quote == "bid") {
+                            chain.bid[row] = in.get_number();
+                        } else if (quote == "ask") {
+                            chain.ask[row] = in.get_number();
+                        } else if (quote == "bid_size") {
+                            chain.bid_size[row] = get_count(in);
+                        } else if (quote == "ask_size") {
+                            chain.ask_size[row] = get_count(in);
+                        } else if (quote == "last_updated") {
+                            chain.timestamp_ns[row] =
+                                std::llround(in.get_number());
+                        } else {
+                            in.skip();
+                        }
+                    });
+                } else if (field == "underlying_asset") {
+                    in.for_each_field([&](std::string_view asset) {
+                        if (asset == "ticker") {
+                            chain.underlying[row] =
+                                SymbolTable::intern(in.get_string());
+                        } else if (asset == "price") {
+                            chain.underlying_price[row] = in.get_number();
+                        } else {
+                            in.skip();
+                        }
+                    });
+                } else if (field == "implied_volatility") {
+                    chain.implied_volatility[row] = in.get_number();
+                } else if (field == "open_interest") {
+                    chain.open_interest[row] = in.get_number();
+                } else {
+                    in.skip();
+                }
+            });
+            if (chain.contract[row] == INVALID_SYMBOL) {
+                throw std::invalid_argument("Snapshot without a ticker");
+            }
+        });
+    });
+    in.expect_end();
+    envelope.check();
+    return chain.size() - first;
+}
+
+std::string_view PolygonRestParser::next_url(std::string_view body) {
+    JsonCursor in = json.parse(body);
+    std::string_view url;
+    in.for_each_field([&](std::string_view key) {
+        if (key != "next_url") {
+            in.skip();
+        } else if (!in.is_null()) {
+            url = in.get_string();
+        }
+    });
+    in.expect_end();
+    return url;
+}
+
+}  // namespace thales
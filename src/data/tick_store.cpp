@@ -0,0 +1,415 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "data/tick_store.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <system_error>
+#include <tuple>
+#include <utility>
+
+#include "utils/date.h"
+
+namespace thales {
+
+namespace {
+
+constexpr char MAGIC[8] = {'T', 'H', 'A', 'L', 'E', 'S', 'T', 'K'};
+constexpr std::uint32_t VERSION = 1;
+constexpr std::int64_t NANOSECONDS_PER_DAY = 86'400'000'000'000;
+constexpr std::string_view BARS = "bars";
+constexpr std::string_view OPTIONS = "options";
+constexpr std::string_view EXTENSION = ".tick";
+
+static_assert(sizeof(TickFileHeader) % TICK_FILE_ALIGNMENT == 0,
+              "Columns must start aligned after the header");
+static_assert(sizeof(OptionType) == sizeof(std::int32_t),
+              "Option types are stored as 32-bit values");
+
+const std::vector<std::size_t> BAR_WIDTHS = {8, 8, 8, 8, 8, 8, 8, 4};
+const std::vector<std::size_t> OPTION_QUOTE_WIDTHS = {8, 4, 4, 8, 8, 8,
+                                                      4, 4, 8, 8, 8};
+
+std::size_t align_up(std::size_t offset) {
+    return (offset + TICK_FILE_ALIGNMENT - 1) & ~(TICK_FILE_ALIGNMENT - 1);
+}
+
+std::int32_t day_of(std::int64_t timestamp_ns) {
+    std::int64_t day = timestamp_ns / NANOSECONDS_PER_DAY;
+    if (timestamp_ns % NANOSECONDS_PER_DAY < 0) {
+        --day;
+    }
+    return static_cast<std::int32_t>(day);
+}
+
+void check_symbol(std::string_view symbol) {
+    if (symbol.empty() || symbol.size() > TICK_FILE_SYMBOL_LENGTH ||
+        symbol == "." || symbol == ".." ||
+        symbol.find_first_of(std::string_view("/\0", 2)) !=
+            std::string_view::npos) {
+        throw std::invalid_argument("Symbol unusable as a file name: " +
+                                    std::string(symbol));
+    }
+}
+
+/**
+ * @brief A column to write: a pointer to `rows` values of a given width.
+ */
+struct ColumnData {
+    const void* data;
+    std::size_t width;
+};
+
+/**
+ * @brief Writes a file next to its destination, then renames it in place.
+ */
+void write_file(const std::string& path, TickFileKind kind,
+                std::string_view symbol, std::int32_t day, std::size_t rows,
+                const std::vector<ColumnData>& columns) {
+    TickFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.kind = kind;
+    header.rows = rows;
+    header.day = day;
+    header.column_count = static_cast<std::uint32_t>(columns.size());
+    std::memcpy(header.symbol, symbol.data(), symbol.size());
+
+    std::size_t offset = sizeof(header);
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+        header.column_offset[i] = offset;
+        offset = align_up(offset + rows * columns[i].width);
+    }
+
+    std::filesystem::create_directories(
+        std::filesystem::path(path).parent_path());
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        static const char padding[TICK_FILE_ALIGNMENT] = {};
+        std::size_t written = sizeof(header);
+        for (const ColumnData& column : columns) {
+            std::size_t bytes = rows * column.width;
+            out.write(static_cast<const char*>(column.data),
+                      static_cast<std::streamsize>(bytes));
+            written += bytes;
+            out.write(padding, static_cast<std::streamsize>(
+                                   align_up(written) - written));
+            written = align_up(written);
+        }
+        if (!out) {
+            throw std::runtime_error("Unable to write " + temporary);
+        }
+    }
+    std::filesystem::rename(temporary, path);
+}
+
+/**
+ * @brief One bar, used while merging a day with what is already stored.
+ */
+struct BarRow {
+    std::int64_t timestamp_ns;
+    double open, high, low, close, volume, vwap;
+    std::uint32_t trades;
+};
+
+/**
+ * @brief One option quote, used while merging a day.
+ */
+struct OptionQuoteRow {
+    std::int64_t timestamp_ns;
+    std::int32_t expiration;
+    OptionType type;
+    double strike, bid, ask;
+    std::uint32_t bid_size, ask_size;
+    double implied_volatility, open_interest, underlying_price;
+
+    auto key() const {
+        return std::make_tuple(timestamp_ns, expiration, type, strike);
+    }
+};
+
+/**
+ * @brief Sorts rows by key, keeping the last of rows with equal keys.
+ *
+ * Stored rows come first, so new rows replace them.
+ */
+template <typename Row, typename Key>
+void sort_unique(std::vector<Row>& rows, Key key) {
+    std::stable_sort(rows.begin(), rows.end(),
+                     [&](const Row& a, const Row& b) {
+                         return key(a) < key(b);
+                     });
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        if (kept > 0 && !(key(rows[kept - 1]) < key(rows[i]))) {
+            rows[kept - 1] = rows[i];
+        } else {
+            rows[kept++] = rows[i];
+        }
+    }
+    rows.resize(kept);
+}
+
+template <typename Row, typename Field>
+std::vector<Field> gather(const std::vector<Row>& rows, Field Row::*field) {
+    std::vector<Field> column(rows.size());
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        column[i] = rows[i].*field;
+    }
+    return column;
+}
+
+template <typename T>
+ColumnData column_of(const std::vector<T>& values) {
+    return {values.data(), sizeof(T)};
+}
+
+}  // namespace
+
+TickFile::TickFile(const std::string& path, TickFileKind kind,
+                   const std::vector<std::size_t>& widths)
+    : file(path, true) {
+    if (file.size() < sizeof(TickFileHeader)) {
+        throw std::runtime_error("Truncated tick file " + path);
+    }
+    const TickFileHeader& h = header();
+    if (std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        h.version != VERSION) {
+        throw std::runtime_error("Not a tick file " + path);
+    }
+    if (h.kind != kind || h.column_count != widths.size() ||
+        std::memchr(h.symbol, '\0', sizeof(h.symbol)) == nullptr) {
+        throw std::runtime_error("Unexpected tick file layout " + path);
+    }
+    for (std::size_t i = 0; i < widths.size(); ++i) {
+        std::uint64_t offset = h.column_offset[i];
+        if (offset % TICK_FILE_ALIGNMENT != 0 || offset > file.size() ||
+            h.rows > (file.size() - offset) / widths[i]) {
+            throw std::runtime_error("Truncated tick file " + path);
+        }
+    }
+}
+
+BarFile::BarFile(const std::string& path)
+    : TickFile(path, TickFileKind::BARS, BAR_WIDTHS) {}
+
+OptionQuoteFile::OptionQuoteFile(const std::string& path)
+    : TickFile(path, TickFileKind::OPTION_QUOTES, OPTION_QUOTE_WIDTHS) {}
+
+TickStore::TickStore(std::string root) : root(std::move(root)) {
+    std::error_code error;
+    std::filesystem::create_directories(this->root, error);
+    if (error) {
+        throw std::runtime_error("Unable to create " + this->root + ": " +
+                                 error.message());
+    }
+}
+
+std::string TickStore::path(std::string_view kind, std::string_view symbol,
+                            std::int32_t day) const {
+    check_symbol(symbol);
+    std::string path = root;
+    path.append("/").append(kind).append("/").append(symbol).append("/");
+    path.append(format_date(day)).append(EXTENSION);
+    return path;
+}
+
+std::vector<std::int32_t> TickStore::days(std::string_view kind,
+                                          std::string_view symbol) const {
+    check_symbol(symbol);
+    std::filesystem::path directory =
+        std::filesystem::path(root) / kind / symbol;
+    std::vector<std::int32_t> days;
+    std::error_code error;
+    for (const auto& entry :
+         std::filesystem::directory_iterator(directory, error)) {
+        const std::filesystem::path& file = entry.path();
+        if (file.extension() != EXTENSION) {
+            continue;
+        }
+        try {
+            days.push_back(parse_date(file.stem().string()));
+        } catch (const std::invalid_argument&) {
+            // Not one of ours
+        }
+    }
+    std::sort(days.begin(), days.end());
+    return days;
+}
+
+std::size_t TickStore::write_bars(const BarColumns& bars) const {
+    std::map<std::pair<SymbolId, std::int32_t>, std::vector<std::size_t>>
+        groups;
+    for (std::size_t i = 0; i < bars.size(); ++i) {
+        if (bars.symbol[i] == INVALID_SYMBOL) {
+            throw std::invalid_argument("Bar without a symbol");
+        }
+        groups[{bars.symbol[i], day_of(bars.timestamp_ns[i])}].push_back(i);
+    }
+
+    std::vector<BarRow> rows;
+    for (const auto& [key, indices] : groups) {
+        const std::string& symbol = SymbolTable::name(key.first);
+        std::string file = path(BARS, symbol, key.second);
+        rows.clear();
+        if (std::filesystem::exists(file)) {
+            BarFile stored(file);
+            for (std::size_t i = 0; i < stored.size(); ++i) {
+                rows.push_back({stored.timestamp_ns()[i], stored.open()[i],
+                                stored.high()[i], stored.low()[i],
+                                stored.close()[i], stored.volume()[i],
+                                stored.vwap()[i], stored.trades()[i]});
+            }
+        }
+        for (std::size_t i : indices) {
+            rows.push_back({bars.timestamp_ns[i], bars.open[i], bars.high[i],
+                            bars.low[i], bars.close[i], bars.volume[i],
+                            bars.vwap[i], bars.trades[i]});
+        }
+        sort_unique(rows, [](const BarRow& row) { return row.timestamp_ns; });
+
+        auto timestamp = gather(rows, &BarRow::timestamp_ns);
+        auto open = gather(rows, &BarRow::open);
+        auto high = gather(rows, &BarRow::high);
+        auto low = gather(rows, &BarRow::low);
+        auto close = gather(rows, &BarRow::close);
+        auto volume = gather(rows, &BarRow::volume);
+        auto vwap = gather(rows, &BarRow::vwap);
+        auto trades = gather(rows, &BarRow::trades);
+        write_file(file, TickFileKind::BARS, symbol, key.second, rows.size(),
+                   {column_of(timestamp), column_of(open), column_of(high),
+                    column_of(low), column_of(close), column_of(volume),
+                    column_of(vwap), column_of(trades)});
+    }
+    return groups.size();
+}
+
+std::size_t TickStore::write_option_quotes(
+    const OptionChainColumns& chain) const {
+    std::map<std::pair<SymbolId, std::int32_t>, std::vector<std::size_t>>
+        groups;
+    for (std::size_t i = 0; i < chain.size(); ++i) {
+        if (chain.timestamp_ns[i] == 0) {
+            continue;
+        }
+        if (chain.underlying[i] == INVALID_SYMBOL) {
+            throw std::invalid_argument("Option quote without an underlying");
+        }
+        groups[{chain.underlying[i], day_of(chain.timestamp_ns[i])}]
+            .push_back(i);
+    }
+
+    std::vector<OptionQuoteRow> rows;
+    for (const auto& [key, indices] : groups) {
+        const std::string& underlying = SymbolTable::name(key.first);
+        std::string file = path(OPTIONS, underlying, key.second);
+        rows.clear();
+        if (std::filesystem::exists(file)) {
+            OptionQuoteFile stored(file);
+            for (std::size_t i = 0; i < stored.size(); ++i) {
+                rows.push_back(
+                    {stored.timestamp_ns()[i], stored.expiration()[i],
+                     stored.type()[i], stored.strike()[i], stored.bid()[i],
+                     stored.ask()[i], stored.bid_size()[i],
+                     stored.ask_size()[i], stored.implied_volatility()[i],
+                     stored.open_interest()[i],
+                     stored.underlying_price()[i]});
+            }
+        }
+        for (std::size_t i : indices) {
+            rows.push_back({chain.timestamp_ns[i], chain.expiration[i],
+                            chain.type[i], chain.strike[i], chain.bid[i],
+                            chain.ask[i], chain.bid_size[i],
+                            chain.ask_size[i], chain.implied_volatility[i],
+                            chain.open_interest[i],
+                            chain.underlying_price[i]});
+        }
+        sort_unique(rows, [](const OptionQuoteRow& row) { return row.key(); });
+
+        auto timestamp = gather(rows, &OptionQuoteRow::timestamp_ns);
+        auto expiration = gather(rows, &OptionQuoteRow::expiration);
+        auto type = gather(rows, &OptionQuoteRow::type);
+        auto strike = gather(rows, &OptionQuoteRow::strike);
+        auto bid = gather(rows, &OptionQuoteRow::bid);
+        auto ask = gather(rows, &OptionQuoteRow::ask);
+        auto bid_size = gather(rows, &OptionQuoteRow::bid_size);
+        auto ask_size = gather(rows, &OptionQuoteRow::ask_size);
+        auto volatility = gather(rows, &OptionQuoteRow::implied_volatility);
+        auto interest = gather(rows, &OptionQuoteRow::open_interest);
+        auto spot = gather(rows, &OptionQuoteRow::underlying_price);
+        write_file(file, TickFileKind::OPTION_QUOTES, underlying, key.second,
+                   rows.size(),
+                   {column_of(timestamp), column_of(expiration),
+                    column_of(type), column_of(strike), column_of(bid),
+                    column_of(ask), column_of(bid_size), column_of(ask_size),
+                    column_of(volatility), column_of(interest),
+                    column_of(spot)});
+    }
+    return groups.size();
+}
+
+BarFile TickStore::read_bars(std::string_view symbol,
+                             std::int32_t day) const {
+    return BarFile(path(BARS, symbol, day));
+}
+
+OptionQuoteFile TickStore::read_option_quotes(std::string_view underlying,
+                                              std::int32_t day) const {
+    return OptionQuoteFile(path(OPTIONS, underlying, day));
+}
+
+std::vector<std::int32_t> TickStore::bar_days(std::string_view symbol) const {
+    return days(BARS, symbol);
+}
+
+std::vector<std::int32_t> TickStore::option_quote_days(
+    std::string_view underlying) const {
+    return days(OPTIONS, underlying);
+}
+
+std::size_t PolygonImporter::import_aggregates(std::string_view body) {
+    bars.clear();
+    std::size_t count = parser.parse_aggregates(body, bars);
+    store.write_bars(bars);
+    return count;
+}
+
+std::size_t PolygonImporter::import_option_chain(std::string_view body) {
+    chain.clear();
+    parser.parse_option_chain(body, chain);
+    store.write_option_quotes(chain);
+    return static_cast<std::size_t>(
+        std::count_if(chain.timestamp_ns.begin(), chain.timestamp_ns.end(),
+                      [](std::int64_t t) { return t != 0; }));
+}
+
+}  // namespace thales
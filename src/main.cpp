@@ -23,21 +23,74 @@
  */
 
 #include <chrono>
+#include <csignal>
 #include <cstdlib>
+#include <filesystem>
 #include <iostream>
+#include <memory>
 #include <thread>
 
 #include "config/config.h"
+#include "config/config_store.h"
+#include "trading/dashboard.h"
 #include "trading/portfolio.h"
+#include "trading/state_snapshot.h"
+#include "trading/threading.h"
+#include "utils/arena.h"
 #include "utils/http_client.h"
+#include "utils/logging.h"
+#include "utils/metrics.h"
 
 using namespace thales;
 
+namespace {
+
+volatile std::sig_atomic_t interrupted = 0;
+
+/** Time between broker polls in the main loop. */
+constexpr std::chrono::seconds UPDATE_INTERVAL{1};
+
+}  // namespace
+
 int main() {
     std::string api_key;
+    std::unique_ptr<MetricsDumper> metrics;
+    std::unique_ptr<StateSnapshotWriter> snapshots;
+    TradingState restored;
+    bool have_snapshot = false;
+    ThreadingSettings threading;
 
     try {
         api_key = Config::get_api_key();
+        const ConfigSnapshot& config = Config::store().current();
+        threading = ThreadingSettings::load(config);
+        Logger::instance().pin_writer(threading.logging.cpus);
+        if (const ConfigValue* file = config.find("metrics", "METRICS_FILE")) {
+            metrics = std::make_unique<MetricsDumper>(
+                MetricsRegistry::instance(), file->text(),
+                std::chrono::milliseconds(
+                    config.get_int("metrics", "DUMP_INTERVAL_MS", 1000)));
+            metrics->start();
+        }
+        // Restore the last snapshot so the book can be shown and priced
+        // before the broker has been asked for anything
+        if (const ConfigValue* file =
+                config.find("snapshot", "SNAPSHOT_FILE")) {
+            if (std::filesystem::exists(file->text())) {
+                try {
+                    StateSnapshot::read(file->text(), restored);
+                    have_snapshot = true;
+                } catch (const std::exception& e) {
+                    LOG_WARN("Ignoring state snapshot: {}",
+                             std::string_view(e.what()));
+                }
+            }
+            snapshots = std::make_unique<StateSnapshotWriter>(
+                file->text(),
+                std::chrono::milliseconds(
+                    config.get_int("snapshot", "WRITE_INTERVAL_MS", 5000)));
+            snapshots->start();
+        }
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << "\n";
         return EXIT_FAILURE;
@@ -57,23 +110,68 @@ int main() {
         return EXIT_FAILURE;
     }
 
-    while (true) {
-        Portfolio portfolio = fetch_portfolio();
-        display_portfolio(portfolio);
-
-        std::vector<Order> orders = fetch_orders();
-        display_orders(orders);
-
-        // Sleep for 1 second before updating
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+    // Ctrl-C stops the dashboard so it can restore the terminal
+    std::signal(SIGINT, [](int) { interrupted = 1; });
 
-        // Clear the screen (platform-dependent)
-#if defined(_WIN32) || defined(_WIN64)
-        std::system("cls");
-#else
-        std::system("clear");
-#endif
+    Dashboard dashboard;
+    if (have_snapshot) {
+        reconcile(restored, fetch_portfolio(), fetch_orders());
+        dashboard.publish(restored.portfolio);
+        dashboard.publish(std::pmr::vector<Order>(restored.orders.begin(),
+                                                  restored.orders.end()));
     }
+    std::thread feed([&dashboard, &snapshots, &restored, &threading] {
+        const ThreadPlacement& placement = threading.main_loop;
+        try {
+            pin_current_thread(placement.cpus);
+        } catch (const std::exception& e) {
+            LOG_WARN("Main loop left unpinned: {}",
+                     std::string_view(e.what()));
+        }
+        // The broker feed is simulated by polling the fetch functions; the
+        // dashboard redraws when they publish and writes only what changed.
+        // Each cycle's snapshots live in an arena that the dashboard copies
+        // out of, so it is rewound as soon as they are published. Its
+        // blocks come from the loop's own NUMA node
+        Arena arena(64 * 1024,
+                    NumaMemoryResource::for_node(placement.node()));
+        IdleWaiter waiter(placement.wait);
+        auto next_update = std::chrono::steady_clock::now();
+        while (!interrupted) {
+            {
+                METRIC_TIME_SCOPE("thales_main_loop_seconds",
+                                  "Time to fetch and publish one update");
+                Portfolio portfolio = fetch_portfolio(&arena);
+                std::pmr::vector<Order> orders = fetch_orders(&arena);
+                if (snapshots) {
+                    // Copied out of the arena into the writer's buffer;
+                    // the file is written on the writer's thread
+                    snapshots->update([&](TradingState& state) {
+                        state.timestamp_ns =
+                            std::chrono::duration_cast<
+                                std::chrono::nanoseconds>(
+                                std::chrono::system_clock::now()
+                                    .time_since_epoch())
+                                .count();
+                        state.portfolio = portfolio;
+                        state.orders.assign(orders.begin(), orders.end());
+                        state.chain = OptionChainIndex(state.portfolio);
+                        state.surfaces = restored.surfaces;
+                        state.config = Config::store().current().clone();
+                    });
+                }
+                dashboard.publish(std::move(portfolio));
+                dashboard.publish(std::move(orders));
+                arena.reset();
+            }
+            // Fixed cadence: the time spent updating is not added on top
+            next_update += UPDATE_INTERVAL;
+            waiter.wait_until(next_update, [] { return interrupted != 0; });
+        }
+        dashboard.stop();
+    });
+    dashboard.run();
+    feed.join();
 
     return EXIT_SUCCESS;
 }
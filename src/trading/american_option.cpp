@@ -0,0 +1,478 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "trading/american_option.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "trading/option_kernels.h"
+
+namespace {
+
+/** @brief Options priced together on one lattice or grid */
+constexpr std::size_t MAX_GROUP_SIZE = 64;
+
+/** @brief Standard deviations of log-spot covered by the PDE grid */
+constexpr double GRID_WIDTH = 5.0;
+
+void validate(double S, double K, double T, double sigma, OptionType type) {
+    if (!(S > 0) || !(K > 0) || !(T >= 0) || !(sigma >= 0)) {
+        throw std::invalid_argument("Invalid input parameters");
+    }
+    if (type != CALL && type != PUT) {
+        throw std::invalid_argument("Invalid option type");
+    }
+}
+
+void validate(const AmericanSettings& settings) {
+    if (settings.time_steps < 1 || settings.space_steps < 4) {
+        throw std::invalid_argument("Invalid American pricer settings");
+    }
+    switch (settings.method) {
+        case AmericanMethod::COX_ROSS_RUBINSTEIN:
+        case AmericanMethod::LEISEN_REIMER:
+        case AmericanMethod::CRANK_NICOLSON:
+        case AmericanMethod::BARONE_ADESI_WHALEY:
+        case AmericanMethod::JU_ZHONG:
+            return;
+    }
+    throw std::invalid_argument("Invalid American pricing method");
+}
+
+/**
+ * @brief Whether early exercise can pay, i.e. the option is not worth
+ * exactly its European price
+ */
+bool early_exercise(double r, OptionType type) {
+    return type == CALL ? r < 0 : r > 0;
+}
+
+/**
+ * @brief Price for T == 0 or sigma == 0, where the spot path is known
+ */
+double degenerate_price(double S, double K, double T, double r,
+                        OptionType type) {
+    double w = type == CALL ? 1.0 : -1.0;
+    double intrinsic = std::max(w * (S - K), 0.0);
+    double forward = std::max(w * (S - K * std::exp(-r * T)), 0.0);
+    return std::max(intrinsic, forward);
+}
+
+/** @brief Per-thread lattice storage, grown on demand and never shrunk */
+struct TreeBuffer {
+    std::vector<double> values;
+    std::vector<double> spots;
+};
+
+TreeBuffer& tree_buffer() {
+    thread_local TreeBuffer buffer;
+    return buffer;
+}
+
+/**
+ * @brief Rolls back one recombining binomial tree for several strikes
+ *
+ * Node values are interleaved by strike, so the inner loop runs over
+ * contiguous strikes at each node.
+ *
+ * @param w +1 for a call and -1 for a put, per strike
+ */
+void roll_back(double S, double u, double d, double p, double discount,
+               int steps, const double* K, const double* w, std::size_t count,
+               double* prices) {
+    TreeBuffer& buffer = tree_buffer();
+    std::size_t nodes = static_cast<std::size_t>(steps) + 1;
+    if (buffer.values.size() < nodes * count) {
+        buffer.values.resize(nodes * count);
+    }
+    if (buffer.spots.size() < nodes) {
+        buffer.spots.resize(nodes);
+    }
+    double* values = buffer.values.data();
+    double* spots = buffer.spots.data();
+
+    double ratio = u / d;
+    spots[0] = S * std::pow(d, steps);
+    for (std::size_t i = 1; i < nodes; ++i) {
+        spots[i] = spots[i - 1] * ratio;
+    }
+    for (std::size_t i = 0; i < nodes; ++i) {
+        for (std::size_t j = 0; j < count; ++j) {
+            values[i * count + j] = std::max(w[j] * (spots[i] - K[j]), 0.0);
+        }
+    }
+
+    double up = discount * p;
+    double down = discount * (1.0 - p);
+    double inverse_d = 1.0 / d;
+    for (int level = steps - 1; level >= 0; --level) {
+        for (int i = 0; i <= level; ++i) {
+            // S(level, i) = S(level + 1, i) / d
+            double spot = spots[i] *= inverse_d;
+            double* low = values + static_cast<std::size_t>(i) * count;
+            const double* high = low + count;
+            for (std::size_t j = 0; j < count; ++j) {
+                double held = up * high[j] + down * low[j];
+                low[j] = std::max(held, w[j] * (spot - K[j]));
+            }
+        }
+    }
+    std::copy(values, values + count, prices);
+}
+
+void cox_ross_rubinstein(double S, double T, double r, double sigma,
+                         int steps, const double* K, const double* w,
+                         std::size_t count, double* prices) {
+    double dt = T / steps;
+    double u = std::exp(sigma * std::sqrt(dt));
+    double d = 1.0 / u;
+    double growth = std::exp(r * dt);
+    double p = (growth - d) / (u - d);
+    roll_back(S, u, d, p, 1.0 / growth, steps, K, w, count, prices);
+}
+
+/**
+ * @brief Peizer-Pratt method 2 inversion of the normal distribution
+ */
+double peizer_pratt(double z, int n) {
+    double scaled = z / (n + 1.0 / 3.0 + 0.1 / (n + 1.0));
+    double root = std::sqrt(1.0 - std::exp(-scaled * scaled * (n + 1.0 / 6.0)));
+    return 0.5 + std::copysign(0.5 * root, z);
+}
+
+double leisen_reimer(double S, double K, double T, double r, double sigma,
+                     int steps, OptionType type) {
+    // The scheme needs an odd number of levels
+    steps |= 1;
+    double dt = T / steps;
+    double sigma_sqrt_T = sigma * std::sqrt(T);
+    double d1 = (std::log(S / K) + (r + sigma * sigma / 2.0) * T) /
+                sigma_sqrt_T;
+    double d2 = d1 - sigma_sqrt_T;
+    double p = peizer_pratt(d2, steps);
+    double p_bar = peizer_pratt(d1, steps);
+    double growth = std::exp(r * dt);
+    double u = growth * p_bar / p;
+    double d = (growth - p * u) / (1.0 - p);
+    double w = type == CALL ? 1.0 : -1.0;
+    double price;
+    roll_back(S, u, d, p, 1.0 / growth, steps, &K, &w, 1, &price);
+    return price;
+}
+
+/**
+ * @brief Crank-Nicolson in x = ln S for several strikes of one type on one
+ * grid
+ *
+ * The first step is split into two implicit Euler half-steps (Rannacher
+ * smoothing) to damp the payoff kink; both use the same matrix as the
+ * Crank-Nicolson steps. Early exercise is imposed exactly by
+ * Brennan-Schwartz elimination, sweeping towards the exercise region, so
+ * the factorisation is shared by every strike and step. Node values are
+ * interleaved by strike so that the serial sweeps advance every strike at
+ * once.
+ */
+void crank_nicolson(double S, double T, double r, double sigma,
+                    int time_steps, int space_steps, const double* K,
+                    OptionType type, std::size_t count, double* prices) {
+    double log_S = std::log(S);
+    double k_min = *std::min_element(K, K + count);
+    double k_max = *std::max_element(K, K + count);
+    double width = GRID_WIDTH * sigma * std::sqrt(T);
+    double lo = std::min(log_S, std::log(k_min)) - width;
+    double hi = std::max(log_S, std::log(k_max)) + width;
+    double dx = (hi - lo) / space_steps;
+    // Shift the grid so that the spot is a node
+    int spot_node = static_cast<int>(std::lround((log_S - lo) / dx));
+    lo = log_S - spot_node * dx;
+    int last = space_steps;
+
+    std::vector<double> spots(last + 1);
+    for (int j = 0; j <= last; ++j) {
+        spots[j] = std::exp(lo + j * dx);
+    }
+    spots[spot_node] = S;
+
+    double dt = T / time_steps;
+    double drift = r - sigma * sigma / 2.0;
+    double diffusion = sigma * sigma / (dx * dx);
+    double alpha = dt / 2.0 * (diffusion / 2.0 - drift / (2.0 * dx));
+    double beta = dt / 2.0 * (-diffusion - r);
+    double gamma = dt / 2.0 * (diffusion / 2.0 + drift / (2.0 * dx));
+    // (I - dt/2 L) V(n + 1) = (I + dt/2 L) V(n)
+    double sub = -alpha;
+    double diag = 1.0 - beta;
+    double sup = -gamma;
+
+    // Multipliers and inverse pivots of the elimination away from the
+    // exercise region: from the top for puts, from the bottom for calls
+    bool call = type == CALL;
+    std::vector<double> factor(last + 1);
+    std::vector<double> inverse_pivot(last + 1);
+    double pivot = diag;
+    if (call) {
+        inverse_pivot[1] = 1.0 / pivot;
+        for (int j = 2; j < last; ++j) {
+            factor[j] = sub / pivot;
+            pivot = diag - factor[j] * sup;
+            inverse_pivot[j] = 1.0 / pivot;
+        }
+    } else {
+        inverse_pivot[last - 1] = 1.0 / pivot;
+        for (int j = last - 2; j >= 1; --j) {
+            factor[j] = sup / pivot;
+            pivot = diag - factor[j] * sub;
+            inverse_pivot[j] = 1.0 / pivot;
+        }
+    }
+
+    std::size_t nodes = static_cast<std::size_t>(last) + 1;
+    std::vector<double> value_buffer(nodes * count);
+    std::vector<double> rhs_buffer(nodes * count);
+    std::vector<double> payoff_buffer(nodes * count);
+    double* values = value_buffer.data();
+    double* rhs = rhs_buffer.data();
+    double* payoff = payoff_buffer.data();
+    auto row = [count](int j) { return static_cast<std::size_t>(j) * count; };
+    for (int j = 0; j <= last; ++j) {
+        for (std::size_t s = 0; s < count; ++s) {
+            double intrinsic = call ? spots[j] - K[s] : K[s] - spots[j];
+            payoff[row(j) + s] = std::max(intrinsic, 0.0);
+        }
+    }
+    std::copy(payoff, payoff + nodes * count, values);
+
+    // Implicit Euler over dt / 2 shares the Crank-Nicolson matrix
+    auto step = [&](double tau, bool crank_nicolson_step) {
+        for (int j = 1; j < last; ++j) {
+            const double* v = values + row(j);
+            double* d = rhs + row(j);
+            for (std::size_t s = 0; s < count; ++s) {
+                d[s] = v[s];
+                if (crank_nicolson_step) {
+                    d[s] += alpha * v[s - count] + beta * v[s] +
+                            gamma * v[s + count];
+                }
+            }
+        }
+        double discount = std::exp(-r * tau);
+        for (std::size_t s = 0; s < count; ++s) {
+            double low = call ? 0.0 : K[s] - spots[0];
+            double high = call ? spots[last] - K[s] * std::min(discount, 1.0)
+                               : 0.0;
+            rhs[row(1) + s] -= sub * low;
+            rhs[row(last - 1) + s] -= sup * high;
+            values[s] = low;
+            values[row(last) + s] = high;
+        }
+        if (call) {
+            for (int j = 2; j < last; ++j) {
+                double* d = rhs + row(j);
+                for (std::size_t s = 0; s < count; ++s) {
+                    d[s] -= factor[j] * d[s - count];
+                }
+            }
+            for (int j = last - 1; j >= 1; --j) {
+                double* v = values + row(j);
+                const double* d = rhs + row(j);
+                const double* exercise = payoff + row(j);
+                for (std::size_t s = 0; s < count; ++s) {
+                    double held = (d[s] - sup * v[s + count]) *
+                                  inverse_pivot[j];
+                    v[s] = std::max(held, exercise[s]);
+                }
+            }
+        } else {
+            for (int j = last - 2; j >= 1; --j) {
+                double* d = rhs + row(j);
+                for (std::size_t s = 0; s < count; ++s) {
+                    d[s] -= factor[j] * d[s + count];
+                }
+            }
+            for (int j = 1; j < last; ++j) {
+                double* v = values + row(j);
+                const double* d = rhs + row(j);
+                const double* exercise = payoff + row(j);
+                for (std::size_t s = 0; s < count; ++s) {
+                    double held = (d[s] - sub * v[s - count]) *
+                                  inverse_pivot[j];
+                    v[s] = std::max(held, exercise[s]);
+                }
+            }
+        }
+    };
+
+    step(dt / 2.0, false);
+    step(dt, false);
+    for (int n = 2; n <= time_steps; ++n) {
+        step(n * dt, true);
+    }
+    std::copy(values + row(spot_node), values + row(spot_node) + count,
+              prices);
+}
+
+double ju_zhong(double S, double K, double T, double r, double sigma) {
+    ExerciseBoundary boundary =
+        American::boundary<Put, ExactMath>(K, T, r, sigma);
+    double critical = boundary.critical;
+    if (S <= critical) {
+        return K - S;
+    }
+    double alpha = boundary.alpha;
+    double h = boundary.h;
+    double lambda = boundary.lambda;
+    double beta = alpha;  // No dividends, so 2(r - q) / sigma^2 = alpha
+    double root = std::sqrt((beta - 1.0) * (beta - 1.0) + 4.0 * alpha / h);
+    double lambda_h = alpha / (h * h * root);
+    double denominator = 2.0 * lambda + beta - 1.0;
+
+    Greeks at_critical =
+        option_greeks<Put, European>({critical, K, T, r, sigma});
+    double premium = K - critical - at_critical.price;
+    // dP/dh = (dP/dT) / (dh/dT), with dh/dT = r (1 - h)
+    double dP_dh = -at_critical.theta / (r * (1.0 - h));
+    double b = (1.0 - h) * alpha * lambda_h / (2.0 * denominator);
+    double c = -(1.0 - h) * alpha / denominator *
+               (dP_dh / premium + 1.0 / h + lambda_h / denominator);
+    double log_ratio = std::log(S / critical);
+    double chi = b * log_ratio * log_ratio + c * log_ratio;
+    return option_price<Put, European>({S, K, T, r, sigma}) +
+           premium * std::pow(S / critical, lambda) / (1.0 - chi);
+}
+
+/**
+ * @brief Prices one option whose inputs and settings are already valid
+ */
+double price_one(double S, double K, double T, double r, double sigma,
+                 OptionType type, const AmericanSettings& settings) {
+    if (T == 0 || sigma == 0) {
+        return degenerate_price(S, K, T, r, type);
+    }
+    if (!early_exercise(r, type)) {
+        return type == CALL ? option_price<Call, European>({S, K, T, r, sigma})
+                            : option_price<Put, European>({S, K, T, r, sigma});
+    }
+    double w = type == CALL ? 1.0 : -1.0;
+    double price = 0.0;
+    switch (settings.method) {
+        case AmericanMethod::COX_ROSS_RUBINSTEIN:
+            cox_ross_rubinstein(S, T, r, sigma, settings.time_steps, &K, &w,
+                                1, &price);
+            return price;
+        case AmericanMethod::CRANK_NICOLSON:
+            crank_nicolson(S, T, r, sigma, settings.time_steps,
+                           settings.space_steps, &K, type, 1, &price);
+            return price;
+        case AmericanMethod::BARONE_ADESI_WHALEY:
+            if (type == PUT) {
+                return option_price<Put, American>({S, K, T, r, sigma});
+            }
+            break;
+        case AmericanMethod::JU_ZHONG:
+            if (type == PUT) {
+                return ju_zhong(S, K, T, r, sigma);
+            }
+            break;
+        case AmericanMethod::LEISEN_REIMER:
+            break;
+    }
+    return leisen_reimer(S, K, T, r, sigma, settings.time_steps, type);
+}
+
+}  // namespace
+
+double AmericanOption::calculate_option_price(
+    double S, double K, double T, double r, double sigma, OptionType type,
+    const AmericanSettings& settings) {
+    validate(S, K, T, sigma, type);
+    validate(settings);
+    return price_one(S, K, T, r, sigma, type, settings);
+}
+
+void AmericanOption::calculate_option_prices(
+    const OptionBatch& batch, double* prices,
+    const AmericanSettings& settings) {
+    validate(settings);
+    for (std::size_t i = 0; i < batch.size; ++i) {
+        validate(batch.S[i], batch.K[i], batch.T[i], batch.sigma[i],
+                 batch.type[i]);
+    }
+
+    bool shared_grid =
+        settings.method == AmericanMethod::COX_ROSS_RUBINSTEIN ||
+        settings.method == AmericanMethod::CRANK_NICOLSON;
+    double K[MAX_GROUP_SIZE];
+    double w[MAX_GROUP_SIZE];
+    std::size_t index[MAX_GROUP_SIZE];
+    double group_prices[MAX_GROUP_SIZE];
+    std::size_t begin = 0;
+    while (begin < batch.size) {
+        double S = batch.S[begin];
+        double T = batch.T[begin];
+        double r = batch.r[begin];
+        double sigma = batch.sigma[begin];
+        std::size_t end = begin + 1;
+        if (shared_grid) {
+            while (end < batch.size && end - begin < MAX_GROUP_SIZE &&
+                   batch.S[end] == S && batch.T[end] == T &&
+                   batch.r[end] == r && batch.sigma[end] == sigma &&
+                   (settings.method != AmericanMethod::CRANK_NICOLSON ||
+                    batch.type[end] == batch.type[begin])) {
+                ++end;
+            }
+        }
+
+        // Options that cannot be exercised early never reach the grid
+        std::size_t count = 0;
+        for (std::size_t i = begin; i < end; ++i) {
+            if (end - begin == 1 || T == 0 || sigma == 0 ||
+                !early_exercise(r, batch.type[i])) {
+                prices[i] = price_one(S, batch.K[i], T, r, sigma,
+                                      batch.type[i], settings);
+                continue;
+            }
+            K[count] = batch.K[i];
+            w[count] = batch.type[i] == CALL ? 1.0 : -1.0;
+            index[count] = i;
+            ++count;
+        }
+        if (count > 0) {
+            if (settings.method == AmericanMethod::COX_ROSS_RUBINSTEIN) {
+                cox_ross_rubinstein(S, T, r, sigma, settings.time_steps, K, w,
+                                    count, group_prices);
+            } else {
+                crank_nicolson(S, T, r, sigma, settings.time_steps,
+                               settings.space_steps, K, batch.type[begin],
+                               count, group_prices);
+            }
+            for (std::size_t i = 0; i < count; ++i) {
+                prices[index[i]] = group_prices[i];
+            }
+        }
+        begin = end;
+    }
+}
@@ -25,27 +25,130 @@
 #include "trading/black_scholes.h"
 
 #include <cmath>
+#include <cstdint>
 #include <stdexcept>
 
-double BlackScholes::calculate_option_price(double S, double K, double T,
-                                            double r, double sigma,
-                                            OptionType type) {
+#include "simd/dispatch.h"
+#include "trading/option_kernels.h"
+#include "utils/metrics.h"
+
+namespace {
+
+void validate(double S, double K, double T, double sigma, OptionType type) {
     if (S <= 0 || K <= 0 || T < 0 || sigma < 0) {
         throw std::invalid_argument("Invalid input parameters");
     }
+    if (type != CALL && type != PUT) {
+        throw std::invalid_argument("Invalid option type");
+    }
+}
+
+}  // namespace
 
-    double d1 =
-        (log(S / K) + (r + sigma * sigma / 2.0) * T) / (sigma * sqrt(T));
-    double d2 = d1 - sigma * sqrt(T);
-
-    switch (type) {
-        case CALL:
-            return S * 0.5 * (1 + erf(d1 / sqrt(2))) -
-                   K * exp(-r * T) * 0.5 * (1 + erf(d2 / sqrt(2)));
-        case PUT:
-            return K * exp(-r * T) * 0.5 * (1 + erf(-d2 / sqrt(2))) -
-                   S * 0.5 * (1 + erf(-d1 / sqrt(2)));
-        default:
-            throw std::invalid_argument("Invalid option type");
+ValidatedOptionBatch::ValidatedOptionBatch(const OptionBatch& batch)
+    : batch(batch) {
+    for (std::size_t i = 0; i < batch.size; ++i) {
+        validate(batch.S[i], batch.K[i], batch.T[i], batch.sigma[i],
+                 batch.type[i]);
     }
 }
+
+template <class Math>
+double BlackScholes::calculate_option_price(double S, double K, double T,
+                                            double r, double sigma,
+                                            OptionType type) {
+    validate(S, K, T, sigma, type);
+    const OptionInputs option = {S, K, T, r, sigma};
+    return type == CALL ? option_price<Call, European, Math>(option)
+                        : option_price<Put, European, Math>(option);
+}
+
+template <class Math>
+Greeks BlackScholes::calculate_greeks(double S, double K, double T, double r,
+                                      double sigma, OptionType type) {
+    validate(S, K, T, sigma, type);
+    const OptionInputs option = {S, K, T, r, sigma};
+    return type == CALL ? option_greeks<Call, European, Math>(option)
+                        : option_greeks<Put, European, Math>(option);
+}
+
+template <class Math>
+void BlackScholes::calculate_option_prices(const OptionBatch& batch,
+                                           double* prices,
+                                           SimdBackend backend) {
+    calculate_option_prices<Math>(ValidatedOptionBatch(batch), prices,
+                                  backend);
+}
+
+template <class Math>
+void BlackScholes::calculate_option_prices(const ValidatedOptionBatch& batch,
+                                           double* prices,
+                                           SimdBackend backend) {
+    METRIC_COUNT("thales_options_priced_total",
+                 "Options priced by the batch kernels", batch.view().size);
+    METRIC_TIME_SCOPE("thales_pricing_kernel_seconds",
+                      "Time in one batch pricing kernel call");
+    thales::simd::kernels_for(backend).price(
+        {thales::simd::kernel_inputs(batch.view()), prices,
+         thales::simd::normal_grid<Math>()});
+}
+
+template <class Math>
+void BlackScholes::calculate_greeks(const OptionBatch& batch,
+                                    const GreeksBatch& greeks,
+                                    SimdBackend backend) {
+    calculate_greeks<Math>(ValidatedOptionBatch(batch), greeks, backend);
+}
+
+template <class Math>
+void BlackScholes::calculate_greeks(const ValidatedOptionBatch& batch,
+                                    const GreeksBatch& greeks,
+                                    SimdBackend backend) {
+    METRIC_COUNT("thales_options_priced_total",
+                 "Options priced by the batch kernels", batch.view().size);
+    METRIC_TIME_SCOPE("thales_pricing_kernel_seconds",
+                      "Time in one batch pricing kernel call");
+    thales::simd::kernels_for(backend).greeks(
+        {thales::simd::kernel_inputs(batch.view()), greeks.price,
+         greeks.delta, greeks.gamma, greeks.vega, greeks.theta, greeks.rho,
+         greeks.vanna, greeks.volga, thales::simd::normal_grid<Math>()});
+}
+
+// The policies are a closed set, so the templates are compiled here once
+#define INSTANTIATE_BLACK_SCHOLES(Math)                                      \
+    template double BlackScholes::calculate_option_price<Math>(              \
+        double, double, double, double, double, OptionType);                 \
+    template Greeks BlackScholes::calculate_greeks<Math>(                    \
+        double, double, double, double, double, OptionType);                 \
+    template void BlackScholes::calculate_option_prices<Math>(               \
+        const OptionBatch&, double*, SimdBackend);                           \
+    template void BlackScholes::calculate_option_prices<Math>(               \
+        const ValidatedOptionBatch&, double*, SimdBackend);                  \
+    template void BlackScholes::calculate_greeks<Math>(                      \
+        const OptionBatch&, const GreeksBatch&, SimdBackend);                \
+    template void BlackScholes::calculate_greeks<Math>(                      \
+        const ValidatedOptionBatch&, const GreeksBatch&, SimdBackend);
+
+INSTANTIATE_BLACK_SCHOLES(ExactMath)
+INSTANTIATE_BLACK_SCHOLES(RiskMath)
+INSTANTIATE_BLACK_SCHOLES(ScreeningMath)
+
+#undef INSTANTIATE_BLACK_SCHOLES
+
+bool BlackScholes::is_simd_backend_supported(SimdBackend backend) {
+    return backend == SimdBackend::AUTO ||
+           thales::simd::find_kernels(backend) != nullptr;
+}
+
+SimdBackend BlackScholes::best_simd_backend() {
+    static const SimdBackend best = [] {
+        for (SimdBackend backend : {SimdBackend::AVX512, SimdBackend::AVX2,
+                                    SimdBackend::NEON}) {
+            if (thales::simd::find_kernels(backend) != nullptr) {
+                return backend;
+            }
+        }
+        return SimdBackend::SCALAR;
+    }();
+    return best;
+}
@@ -21,3 +21,26 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  * SOFTWARE.
  */
+
+#include "trading/broker_interface.h"
+
+#include <stdexcept>
+
+#include "trading/order_manager.h"
+#include "utils/latency_histogram.h"
+
+namespace thales {
+
+void SimulatedBroker::send(const BrokerOrder& order) {
+    orders.fetch_add(1, std::memory_order_relaxed);
+    if (manager == nullptr) {
+        return;
+    }
+    ExecutionReport fill{order.id, ExecutionKind::FILL, order.request.quantity,
+                         order.price, steady_now_ns()};
+    if (!manager->report(fill)) {
+        throw std::runtime_error("Execution queue is full");
+    }
+}
+
+}  // namespace thales
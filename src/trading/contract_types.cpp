@@ -0,0 +1,78 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "trading/contract_types.h"
+
+#include <cctype>
+#include <stdexcept>
+#include <string>
+
+namespace thales {
+
+namespace {
+
+bool equals_ignore_case(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) !=
+            std::tolower(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+OptionType parse_option_type(std::string_view text) {
+    if (equals_ignore_case(text, "call")) {
+        return OptionType::CALL;
+    }
+    if (equals_ignore_case(text, "put")) {
+        return OptionType::PUT;
+    }
+    throw std::invalid_argument("Invalid option type: " + std::string(text));
+}
+
+std::string_view to_string(OptionType type) {
+    return type == OptionType::CALL ? "Call" : "Put";
+}
+
+Side parse_side(std::string_view text) {
+    if (equals_ignore_case(text, "buy")) {
+        return Side::BUY;
+    }
+    if (equals_ignore_case(text, "sell")) {
+        return Side::SELL;
+    }
+    throw std::invalid_argument("Invalid order side: " + std::string(text));
+}
+
+std::string_view to_string(Side side) {
+    return side == Side::BUY ? "Buy" : "Sell";
+}
+
+}  // namespace thales
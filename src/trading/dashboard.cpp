@@ -0,0 +1,278 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "trading/dashboard.h"
+
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <iterator>
+#include <cstdio>
+#include <thread>
+#include <utility>
+
+#include "utils/date.h"
+
+namespace thales {
+
+namespace {
+
+constexpr std::size_t DEFAULT_ROWS = 24;
+constexpr std::size_t DEFAULT_COLUMNS = 80;
+
+/** Rows above the position table: title, summary, blank, header, rule. */
+constexpr std::size_t TABLE_TOP = 5;
+
+/** Most recent orders listed under the table. */
+constexpr std::size_t MAX_ORDERS = 5;
+
+struct Column {
+    const char* title;
+    std::size_t width;
+};
+
+constexpr Column COLUMNS[] = {{"Symbol", 10},     {"Type", 6},
+                              {"Strike", 10},     {"Expiration", 12},
+                              {"Quantity", 10},   {"Premium", 10}};
+
+void terminal_size(int fd, std::size_t& rows, std::size_t& columns) {
+    winsize size{};
+    bool known = ::ioctl(fd, TIOCGWINSZ, &size) == 0 && size.ws_row > 0 &&
+                 size.ws_col > 0;
+    if (rows == 0) {
+        rows = known ? size.ws_row : DEFAULT_ROWS;
+    }
+    if (columns == 0) {
+        columns = known ? size.ws_col : DEFAULT_COLUMNS;
+    }
+}
+
+std::size_t screen_rows(int fd, std::size_t rows) {
+    std::size_t columns = 1;
+    terminal_size(fd, rows, columns);
+    return rows;
+}
+
+std::size_t screen_columns(int fd, std::size_t columns) {
+    std::size_t rows = 1;
+    terminal_size(fd, rows, columns);
+    return columns;
+}
+
+/**
+ * @brief snprintf into a fixed buffer, returning a view of the result.
+ */
+template <typename... Args>
+std::string_view print(char (&buffer)[128], const char* format,
+                       Args... args) {
+    int length = std::snprintf(buffer, sizeof(buffer), format, args...);
+    return {buffer, static_cast<std::size_t>(
+                        std::clamp(length, 0, int(sizeof(buffer)) - 1))};
+}
+
+}  // namespace
+
+Dashboard::Dashboard(int fd, std::size_t rows, std::size_t columns)
+    : fd(fd), screen(screen_rows(fd, rows), screen_columns(fd, columns)) {}
+
+Dashboard::~Dashboard() {
+    if (!cursor_hidden) {
+        return;
+    }
+    std::string restore = "\x1b[0m\x1b[" + std::to_string(screen.rows()) +
+                          ";1H\n\x1b[?25h";
+    try {
+        write_all(fd, restore);
+    } catch (const std::exception&) {
+        // The terminal is gone; nothing left to restore
+    }
+}
+
+void Dashboard::publish(Portfolio portfolio) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending_portfolio = std::move(portfolio);
+        portfolio_changed = dirty = true;
+    }
+    changed.notify_one();
+}
+
+void Dashboard::publish(std::pmr::vector<Order> orders) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending_orders = std::move(orders);
+        orders_changed = dirty = true;
+    }
+    changed.notify_one();
+}
+
+std::size_t Dashboard::render() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!dirty) {
+            return 0;
+        }
+        if (portfolio_changed) {
+            std::swap(portfolio, pending_portfolio);
+        }
+        if (orders_changed) {
+            std::swap(orders, pending_orders);
+        }
+        portfolio_changed = orders_changed = dirty = false;
+    }
+
+    draw();
+    output.clear();
+    if (!cursor_hidden) {
+        output += "\x1b[?25l";
+        cursor_hidden = true;
+    }
+    screen.render(output);
+    if (!output.empty()) {
+        write_all(fd, output);
+    }
+    return output.size();
+}
+
+void Dashboard::run(std::chrono::milliseconds min_interval) {
+    auto last = std::chrono::steady_clock::now() - min_interval;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&] { return dirty || stopped; });
+            if (stopped) {
+                return;
+            }
+        }
+        // Let a burst of publications land in the same frame
+        std::this_thread::sleep_until(last + min_interval);
+        render();
+        last = std::chrono::steady_clock::now();
+    }
+}
+
+void Dashboard::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+    changed.notify_all();
+}
+
+void Dashboard::resize(std::size_t rows, std::size_t columns) {
+    terminal_size(fd, rows, columns);
+    screen.resize(rows, columns);
+    std::lock_guard<std::mutex> lock(mutex);
+    dirty = true;
+}
+
+void Dashboard::draw() {
+    char text[128];
+    std::size_t width = screen.columns();
+    std::size_t height = screen.rows();
+    screen.clear();
+
+    screen.put(0, 0, std::string(width, ' '), CellStyle::HEADER);
+    screen.put(0, 1, "Thales | portfolio", CellStyle::HEADER);
+    screen.put(1, 1,
+               print(text, "Net liquidity: $%.2f   Positions: %zu",
+                     portfolio.get_net_liquidity(), portfolio.size()),
+               CellStyle::BOLD);
+
+    std::size_t offsets[std::size(COLUMNS)];
+    std::size_t column = 1;
+    for (std::size_t i = 0; i < std::size(COLUMNS); ++i) {
+        offsets[i] = column;
+        screen.put(3, column, COLUMNS[i].title, CellStyle::BOLD);
+        column += COLUMNS[i].width;
+    }
+    screen.put(4, 1, std::string(std::min(column, width) - 1, '-'));
+    auto put_cell = [&](std::size_t row, std::size_t index,
+                        std::string_view value,
+                        CellStyle style = CellStyle::NORMAL) {
+        screen.put(row, offsets[index], value, style);
+    };
+
+    // Orders go at the bottom; positions get whatever rows are left, so
+    // only the visible ones are formatted however large the book is
+    std::size_t shown_orders = std::min(orders.size(), MAX_ORDERS);
+    std::size_t order_rows = shown_orders > 0 ? shown_orders + 2 : 0;
+    std::size_t table_rows =
+        height > TABLE_TOP + order_rows ? height - TABLE_TOP - order_rows : 0;
+    std::size_t shown = std::min(portfolio.size(), table_rows);
+    if (shown < portfolio.size() && shown > 0) {
+        --shown;  // Room for the overflow line
+    }
+
+    const std::pmr::vector<SymbolId>& symbols = portfolio.get_symbol_ids();
+    const std::pmr::vector<OptionType>& types = portfolio.get_types();
+    const std::pmr::vector<int>& quantities = portfolio.get_quantities();
+    char date[DATE_LENGTH];
+    for (std::size_t i = 0; i < shown; ++i) {
+        std::size_t row = TABLE_TOP + i;
+        put_cell(row, 0, SymbolTable::name(symbols[i]));
+        put_cell(row, 1, types[i] == CALL ? "Call" : "Put");
+        put_cell(row, 2, print(text, "%.2f", portfolio.get_strikes()[i]));
+        format_date(portfolio.get_expirations()[i], date);
+        put_cell(row, 3, std::string_view(date, DATE_LENGTH));
+        put_cell(row, 4, print(text, "%d", quantities[i]),
+                 quantities[i] < 0 ? CellStyle::NEGATIVE
+                                   : CellStyle::POSITIVE);
+        put_cell(row, 5, print(text, "%.2f", portfolio.get_premiums()[i]));
+    }
+    if (shown < portfolio.size()) {
+        screen.put(TABLE_TOP + shown, 1,
+                   print(text, "... %zu more positions",
+                         portfolio.size() - shown));
+    }
+
+    if (shown_orders == 0) {
+        return;
+    }
+    std::size_t row = height - shown_orders - 1;
+    screen.put(row++, 1, "Recent orders", CellStyle::BOLD);
+    char timestamp[TIMESTAMP_LENGTH];
+    for (std::size_t i = orders.size() - shown_orders; i < orders.size();
+         ++i, ++row) {
+        const Order& order = orders[i];
+        std::size_t length =
+            format_timestamp(order.get_timestamp_ns(), timestamp);
+        format_date(order.get_expiration(), date);
+        column = screen.put(row, 1, std::string_view(timestamp, length));
+        column = screen.put(row, column + 2, order.get_action(),
+                            order.get_side() == Side::BUY
+                                ? CellStyle::POSITIVE
+                                : CellStyle::NEGATIVE);
+        screen.put(row, column + 1,
+                   print(text, "%d %s %s %.2f %.*s @ $%.2f",
+                         order.get_quantity(), order.get_symbol().c_str(),
+                         order.get_type() == CALL ? "Call" : "Put",
+                         order.get_strike_price(),
+                         static_cast<int>(DATE_LENGTH), date,
+                         order.get_premium()));
+    }
+}
+
+}  // namespace thales
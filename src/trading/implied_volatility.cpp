@@ -0,0 +1,83 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "trading/implied_volatility.h"
+
+#include <cmath>
+#include <stdexcept>
+
+#include "simd/dispatch.h"
+
+namespace {
+
+/**
+ * @brief Validate the solver settings
+ *
+ * @throws std::invalid_argument If the tolerance or iteration cap is invalid
+ */
+void validate(const ImpliedVolatilitySettings& settings) {
+    if (!(settings.tolerance > 0) || settings.max_iterations <= 0) {
+        throw std::invalid_argument("Invalid solver settings");
+    }
+}
+
+}  // namespace
+
+double ImpliedVolatility::calculate_implied_volatility(
+    double price, double S, double K, double T, double r, OptionType type,
+    const ImpliedVolatilitySettings& settings) {
+    double vol;
+    OptionBatch batch = {&S, &K, &T, &r, nullptr, &type, 1};
+    calculate_implied_volatilities(batch, &price, &vol, settings,
+                                   SimdBackend::SCALAR);
+    return vol;
+}
+
+std::size_t ImpliedVolatility::calculate_implied_volatilities(
+    const OptionBatch& batch, const double* prices, double* vols,
+    const ImpliedVolatilitySettings& settings, SimdBackend backend) {
+    const thales::simd::KernelTable& kernels =
+        thales::simd::kernels_for(backend);
+    validate(settings);
+    for (std::size_t i = 0; i < batch.size; ++i) {
+        if (batch.S[i] <= 0 || batch.K[i] <= 0 || batch.T[i] < 0) {
+            throw std::invalid_argument("Invalid input parameters");
+        }
+        if (batch.type[i] != CALL && batch.type[i] != PUT) {
+            throw std::invalid_argument("Invalid option type");
+        }
+    }
+
+    // The kernel reads the market prices through the volatility slot
+    thales::simd::BatchInputs inputs = thales::simd::kernel_inputs(batch);
+    inputs.sigma = prices;
+    kernels.implied_vol(
+        {inputs, vols, settings.tolerance, settings.max_iterations});
+
+    std::size_t converged = 0;
+    for (std::size_t i = 0; i < batch.size; ++i) {
+        converged += std::isnan(vols[i]) ? 0 : 1;
+    }
+    return converged;
+}
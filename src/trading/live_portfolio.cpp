@@ -0,0 +1,303 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "trading/live_portfolio.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+
+#include "utils/metrics.h"
+
+namespace thales {
+
+namespace {
+
+constexpr double DAYS_PER_YEAR = 365.0;
+
+/** Adds sign times the totals of one book to another. */
+void accumulate(UnderlyingBook& total, const UnderlyingBook& book, int sign) {
+    total.risk.value += sign * book.risk.value;
+    total.risk.delta += sign * book.risk.delta;
+    total.risk.gamma += sign * book.risk.gamma;
+    total.risk.vega += sign * book.risk.vega;
+    total.risk.theta += sign * book.risk.theta;
+    total.cost += sign * book.cost;
+    total.realized_pnl += sign * book.realized_pnl;
+    total.contracts += sign * book.contracts;
+}
+
+}  // namespace
+
+LivePortfolio::LivePortfolio(double rate, std::int32_t valuation_date,
+                             std::size_t max_underlyings)
+    : rate(rate), valuation_date(valuation_date), table(max_underlyings + 1) {}
+
+void LivePortfolio::load(const Portfolio& portfolio) {
+    const auto& quantities = portfolio.get_quantities();
+    for (std::size_t i = 0; i < portfolio.size(); ++i) {
+        if (quantities[i] != 0) {
+            trade({portfolio.get_symbol_ids()[i],
+                   portfolio.get_expirations()[i], portfolio.get_types()[i],
+                   portfolio.get_strikes()[i]},
+                  quantities[i], portfolio.get_premiums()[i]);
+        }
+    }
+    revalue_all();
+}
+
+void LivePortfolio::apply_fill(const ContractKey& contract, Side side,
+                               int quantity, double price) {
+    if (quantity <= 0) {
+        throw std::invalid_argument("Fill quantity must be positive");
+    }
+    if (!(price >= 0.0) || !std::isfinite(price)) {
+        throw std::invalid_argument("Fill price must be finite and >= 0");
+    }
+    SymbolId symbol = contract.underlying;
+    add_symbol(symbol);
+    UnderlyingBook previous = books[symbol];
+    std::size_t row =
+        trade(contract, side == Side::BUY ? quantity : -quantity, price);
+
+    // Only the filled position is revalued
+    Greeks greeks{};
+    bool live = book.get_expirations()[row] >= valuation_date;
+    bool value = live && priced(symbol);
+    if (value) {
+        double days = book.get_expirations()[row] - valuation_date + 1;
+        greeks = BlackScholes::calculate_greeks(
+            spots[symbol], contract.strike, days / DAYS_PER_YEAR, rate,
+            volatilities[symbol], contract.type);
+    }
+    Contribution updated = contribution(row, value ? &greeks : nullptr);
+    Contribution& current = contributions[row];
+    UnderlyingBook& totals = books[symbol];
+    totals.risk.value += updated.value - current.value;
+    totals.risk.delta += updated.delta - current.delta;
+    totals.risk.gamma += updated.gamma - current.gamma;
+    totals.risk.vega += updated.vega - current.vega;
+    totals.risk.theta += updated.theta - current.theta;
+    totals.cost += updated.cost - current.cost;
+    totals.contracts += updated.contracts - current.contracts;
+    current = updated;
+    publish(symbol, previous);
+}
+
+void LivePortfolio::apply(const Order& fill) {
+    apply_fill({fill.get_symbol_id(), fill.get_expiration(), fill.get_type(),
+                fill.get_strike_price()},
+               fill.get_side(), fill.get_quantity(), fill.get_premium());
+}
+
+void LivePortfolio::update_underlying(SymbolId symbol, double spot,
+                                      double volatility) {
+    if (!(spot > 0.0) || !(volatility > 0.0) || !std::isfinite(spot) ||
+        !std::isfinite(volatility)) {
+        throw std::invalid_argument(
+            "Spot and volatility must be finite and positive");
+    }
+    METRIC_COUNT("thales_quotes_processed_total",
+                 "Underlying and option quotes applied", 1);
+    add_symbol(symbol);
+    UnderlyingBook previous = books[symbol];
+    spots[symbol] = spot;
+    volatilities[symbol] = volatility;
+    revalue(symbol);
+    publish(symbol, previous);
+}
+
+void LivePortfolio::set_valuation_date(std::int32_t day) {
+    valuation_date = day;
+    revalue_all();
+}
+
+UnderlyingBook LivePortfolio::underlying(SymbolId symbol) const {
+    if (symbol + std::size_t{1} >= table.capacity()) {
+        return {};
+    }
+    return table.read(symbol + std::size_t{1});
+}
+
+std::uint64_t LivePortfolio::snapshot(
+    UnderlyingBook& totals, std::vector<UnderlyingBook>& underlyings) const {
+    while (true) {
+        // Underlyings are only added inside an update, so an unchanged
+        // count means the rows read cover every underlying of that update
+        std::size_t count = symbol_count.load(std::memory_order_acquire);
+        underlyings.resize(count + 1);
+        std::uint64_t version = table.read(0, count + 1, underlyings.data());
+        if (symbol_count.load(std::memory_order_acquire) == count) {
+            totals = underlyings.front();
+            underlyings.erase(underlyings.begin());
+            return version;
+        }
+    }
+}
+
+void LivePortfolio::add_symbol(SymbolId symbol) {
+    if (symbol + std::size_t{1} >= table.capacity()) {
+        throw std::invalid_argument(
+            "Underlying is outside the live portfolio's capacity");
+    }
+    if (symbol >= books.size()) {
+        std::size_t count = symbol + std::size_t{1};
+        books.resize(count);
+        rows_by_underlying.resize(count);
+        spots.resize(count, std::numeric_limits<double>::quiet_NaN());
+        volatilities.resize(count, std::numeric_limits<double>::quiet_NaN());
+        symbol_count.store(count, std::memory_order_release);
+    }
+}
+
+std::size_t LivePortfolio::trade(const ContractKey& contract, int quantity,
+                                 double price) {
+    SymbolId symbol = contract.underlying;
+    add_symbol(symbol);
+
+    auto [entry, inserted] = rows.try_emplace(contract, book.size());
+    std::size_t row = entry->second;
+    if (inserted) {
+        book.add_position(Position(symbol, contract.type, contract.strike,
+                                   contract.expiration, 0, 0.0));
+        contributions.emplace_back();
+        rows_by_underlying[symbol].push_back(row);
+    }
+    int held = book.get_quantities()[row];
+    double average = book.get_premiums()[row];
+    books[symbol].realized_pnl += book_trade(held, average, quantity, price);
+    book.set_position(row, held, average);
+    return row;
+}
+
+bool LivePortfolio::priced(SymbolId symbol) const {
+    return spots[symbol] > 0.0 && volatilities[symbol] > 0.0;
+}
+
+LivePortfolio::Contribution LivePortfolio::contribution(
+    std::size_t row, const Greeks* greeks) const {
+    Contribution share;
+    int quantity = book.get_quantities()[row];
+    if (quantity == 0 || book.get_expirations()[row] < valuation_date) {
+        return share;  // Flat or settled
+    }
+    share.cost = quantity * book.get_premiums()[row] * CONTRACT_MULTIPLIER;
+    share.contracts = std::abs(quantity);
+    if (greeks != nullptr) {
+        double weight = quantity * CONTRACT_MULTIPLIER;
+        share.value = weight * greeks->price;
+        share.delta = weight * greeks->delta;
+        share.gamma = weight * greeks->gamma;
+        share.vega = weight * greeks->vega;
+        share.theta = weight * greeks->theta;
+    }
+    return share;
+}
+
+void LivePortfolio::revalue(SymbolId symbol) {
+    const std::vector<std::size_t>& positions = rows_by_underlying[symbol];
+    Scratch& s = scratch;
+    s.rows.clear();
+    if (priced(symbol)) {
+        for (std::size_t row : positions) {
+            if (book.get_quantities()[row] != 0 &&
+                book.get_expirations()[row] >= valuation_date) {
+                s.rows.push_back(row);
+            }
+        }
+    }
+
+    std::size_t count = s.rows.size();
+    for (auto* column : {&s.S, &s.K, &s.T, &s.r, &s.sigma, &s.price,
+                         &s.delta, &s.gamma, &s.vega, &s.theta}) {
+        column->resize(count);
+    }
+    s.type.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        std::size_t row = s.rows[i];
+        s.S[i] = spots[symbol];
+        s.K[i] = book.get_strikes()[row];
+        s.T[i] =
+            (book.get_expirations()[row] - valuation_date + 1) / DAYS_PER_YEAR;
+        s.r[i] = rate;
+        s.sigma[i] = volatilities[symbol];
+        s.type[i] = book.get_types()[row];
+    }
+    if (count > 0) {
+        OptionBatch batch{s.S.data(),     s.K.data(),     s.T.data(),
+                          s.r.data(),     s.sigma.data(), s.type.data(),
+                          count};
+        GreeksBatch greeks{s.price.data(), s.delta.data(), s.gamma.data(),
+                           s.vega.data(),  s.theta.data(), nullptr,
+                           nullptr,        nullptr};
+        BlackScholes::calculate_greeks(batch, greeks);
+    }
+
+    UnderlyingBook& totals = books[symbol];
+    totals = UnderlyingBook{{}, 0.0, totals.realized_pnl, 0};
+    for (std::size_t row : positions) {
+        contributions[row] = contribution(row, nullptr);
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        Greeks greeks{s.price[i], s.delta[i], s.gamma[i], s.vega[i],
+                      s.theta[i], 0.0,        0.0,        0.0};
+        contributions[s.rows[i]] = contribution(s.rows[i], &greeks);
+    }
+    for (std::size_t row : positions) {
+        const Contribution& share = contributions[row];
+        totals.risk.value += share.value;
+        totals.risk.delta += share.delta;
+        totals.risk.gamma += share.gamma;
+        totals.risk.vega += share.vega;
+        totals.risk.theta += share.theta;
+        totals.cost += share.cost;
+        totals.contracts += share.contracts;
+    }
+}
+
+void LivePortfolio::revalue_all() {
+    total = UnderlyingBook{};
+    for (SymbolId symbol = 0; symbol < books.size(); ++symbol) {
+        revalue(symbol);
+        accumulate(total, books[symbol], 1);
+    }
+    table.begin_write();
+    table.set(0, total);
+    for (SymbolId symbol = 0; symbol < books.size(); ++symbol) {
+        table.set(symbol + std::size_t{1}, books[symbol]);
+    }
+    table.end_write();
+}
+
+void LivePortfolio::publish(SymbolId symbol, const UnderlyingBook& previous) {
+    accumulate(total, previous, -1);
+    accumulate(total, books[symbol], 1);
+    table.begin_write();
+    table.set(0, total);
+    table.set(symbol + std::size_t{1}, books[symbol]);
+    table.end_write();
+}
+
+}  // namespace thales
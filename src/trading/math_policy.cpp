@@ -0,0 +1,54 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "trading/math_policy.h"
+
+#include <cstddef>
+
+namespace {
+
+/**
+ * @brief Fill the nodes of a normal table
+ */
+template <class Table>
+constexpr Table build_table() {
+    Table table{};
+    for (std::size_t i = 0; i <= Table::INTERVALS; ++i) {
+        const double x = Table::node(i);
+        table.nodes[2 * i] = ConstexprMath::norm_cdf(x);
+        table.nodes[2 * i + 1] = ConstexprMath::norm_pdf(x);
+    }
+    return table;
+}
+
+// Evaluated by the compiler, so the tables are in place before any static
+// constructor could price an option
+constexpr RiskMath::Table RISK_TABLE = build_table<RiskMath::Table>();
+constexpr ScreeningMath::Table SCREENING_TABLE =
+    build_table<ScreeningMath::Table>();
+
+}  // namespace
+
+const RiskMath::Table RiskMath::TABLE = RISK_TABLE;
+const ScreeningMath::Table ScreeningMath::TABLE = SCREENING_TABLE;
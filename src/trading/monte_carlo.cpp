@@ -0,0 +1,526 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "trading/monte_carlo.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "simd/dispatch.h"
+#include "utils/thread_pool.h"
+
+namespace {
+
+/** @brief Samples per reduction chunk, independent of the thread count */
+constexpr std::size_t CHUNK_SAMPLES = 2048;
+
+/** @brief Samples simulated together, one array lane each */
+constexpr std::size_t BLOCK_SAMPLES = 64;
+
+/**
+ * @brief Primitive polynomial and initial direction numbers of one Sobol
+ * dimension (Joe and Kuo, 2008)
+ */
+struct SobolPolynomial {
+    int degree;
+    std::uint32_t coefficients;
+    std::uint32_t m[6];
+};
+
+constexpr SobolPolynomial SOBOL_POLYNOMIALS[] = {
+    {1, 0, {1}},
+    {2, 1, {1, 3}},
+    {3, 1, {1, 3, 1}},
+    {3, 2, {1, 1, 1}},
+    {4, 1, {1, 1, 3, 3}},
+    {4, 4, {1, 3, 5, 13}},
+    {5, 2, {1, 1, 5, 5, 17}},
+    {5, 4, {1, 1, 5, 5, 5}},
+    {5, 7, {1, 1, 7, 11, 19}},
+    {5, 11, {1, 1, 5, 1, 1}},
+    {5, 13, {1, 1, 1, 3, 11}},
+    {5, 14, {1, 3, 5, 5, 31}},
+    {6, 1, {1, 3, 3, 9, 7, 49}},
+    {6, 13, {1, 1, 1, 15, 21, 21}},
+    {6, 16, {1, 3, 1, 13, 27, 49}}};
+
+static_assert(std::size(SOBOL_POLYNOMIALS) + 1 ==
+                  MonteCarlo::SOBOL_DIMENSIONS,
+              "One polynomial per Sobol dimension after the first");
+
+/**
+ * @brief Direction numbers of the first SOBOL_DIMENSIONS dimensions
+ */
+class SobolDirections {
+   public:
+    SobolDirections() {
+        for (int k = 0; k < 32; ++k) {
+            v[0][k] = std::uint32_t{1} << (31 - k);
+        }
+        for (int d = 1; d < MonteCarlo::SOBOL_DIMENSIONS; ++d) {
+            const SobolPolynomial& poly = SOBOL_POLYNOMIALS[d - 1];
+            int s = poly.degree;
+            for (int k = 0; k < 32; ++k) {
+                if (k < s) {
+                    v[d][k] = poly.m[k] << (31 - k);
+                    continue;
+                }
+                v[d][k] = v[d][k - s] ^ (v[d][k - s] >> s);
+                for (int j = 1; j < s; ++j) {
+                    if ((poly.coefficients >> (s - 1 - j)) & 1) {
+                        v[d][k] ^= v[d][k - j];
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Coordinate of point @p n in Gray code order
+     */
+    double point(std::uint64_t n, int dimension) const {
+        std::uint64_t gray = n ^ (n >> 1);
+        std::uint32_t x = 0;
+        for (int k = 0; gray != 0 && k < 32; ++k, gray >>= 1) {
+            if (gray & 1) {
+                x ^= v[dimension][k];
+            }
+        }
+        return (x + 0.5) * 0x1p-32;
+    }
+
+   private:
+    std::uint32_t v[MonteCarlo::SOBOL_DIMENSIONS][32];
+};
+
+const SobolDirections& sobol_directions() {
+    static const SobolDirections directions;
+    return directions;
+}
+
+/**
+ * @brief Brownian bridge over the dates 1, 2, ..., steps
+ *
+ * Draw 0 fixes the final value and each later draw bisects the widest
+ * remaining gap, so the early draws carry most of the path's variance.
+ */
+class BrownianBridge {
+   public:
+    explicit BrownianBridge(int steps)
+        : point(steps), left(steps), right(steps), left_weight(steps),
+          right_weight(steps), deviation(steps) {
+        std::vector<bool> filled(steps, false);
+        filled[steps - 1] = true;
+        point[0] = steps - 1;
+        left[0] = -1;
+        right[0] = -1;
+        left_weight[0] = 0.0;
+        right_weight[0] = 0.0;
+        deviation[0] = std::sqrt(static_cast<double>(steps));
+        int j = 0;
+        for (int i = 1; i < steps; ++i) {
+            while (filled[j]) {
+                j = j + 1 == steps ? 0 : j + 1;
+            }
+            int k = j;
+            while (!filled[k]) {
+                ++k;
+            }
+            // Dates are index + 1, with W(0) = 0 left of index 0
+            int l = j + ((k - 1 - j) >> 1);
+            double t_left = j;
+            double t = l + 1.0;
+            double t_right = k + 1.0;
+            filled[l] = true;
+            point[i] = l;
+            left[i] = j - 1;
+            right[i] = k;
+            left_weight[i] = (t_right - t) / (t_right - t_left);
+            right_weight[i] = (t - t_left) / (t_right - t_left);
+            deviation[i] =
+                std::sqrt((t - t_left) * (t_right - t) / (t_right - t_left));
+            j = k + 1 == steps ? 0 : k + 1;
+        }
+    }
+
+    /**
+     * @brief Turns draws into unit-variance increments, in place
+     *
+     * @param z Draws, @c steps rows of @p width samples; receives the
+     * increments W(t) - W(t - 1)
+     * @param path Scratch of the same size
+     */
+    void transform(double* z, double* path, std::size_t width) const {
+        std::size_t steps = point.size();
+        for (std::size_t i = 0; i < steps; ++i) {
+            double* out = path + point[i] * width;
+            const double* draw = z + i * width;
+            const double* a = left[i] >= 0 ? path + left[i] * width : nullptr;
+            const double* b = right[i] >= 0 ? path + right[i] * width
+                                            : nullptr;
+            for (std::size_t p = 0; p < width; ++p) {
+                double mean = (a != nullptr ? left_weight[i] * a[p] : 0.0) +
+                              (b != nullptr ? right_weight[i] * b[p] : 0.0);
+                out[p] = mean + deviation[i] * draw[p];
+            }
+        }
+        for (std::size_t p = 0; p < width; ++p) {
+            z[p] = path[p];
+        }
+        for (std::size_t s = 1; s < steps; ++s) {
+            for (std::size_t p = 0; p < width; ++p) {
+                z[s * width + p] = path[s * width + p] -
+                                   path[(s - 1) * width + p];
+            }
+        }
+    }
+
+   private:
+    std::vector<int> point;
+    std::vector<int> left;
+    std::vector<int> right;
+    std::vector<double> left_weight;
+    std::vector<double> right_weight;
+    std::vector<double> deviation;
+};
+
+/**
+ * @brief Sums of the payoffs y and controls c over a set of samples
+ */
+struct Moments {
+    double n = 0.0;
+    double y = 0.0;
+    double c = 0.0;
+    double yy = 0.0;
+    double cc = 0.0;
+    double yc = 0.0;
+
+    void add(double payoff, double control) {
+        n += 1.0;
+        y += payoff;
+        c += control;
+        yy += payoff * payoff;
+        cc += control * control;
+        yc += payoff * control;
+    }
+
+    void add(const Moments& other) {
+        n += other.n;
+        y += other.y;
+        c += other.c;
+        yy += other.yy;
+        cc += other.cc;
+        yc += other.yc;
+    }
+};
+
+/**
+ * @brief Everything a chunk needs, derived once from the inputs
+ */
+struct Simulation {
+    PathOption option;
+    MonteCarloSettings settings;
+    const thales::simd::KernelTable* kernels;
+    std::size_t samples;
+    std::size_t steps;
+    double drift;       /**< Log-spot drift per step */
+    double volatility;  /**< Log-spot deviation per step */
+    double log_barrier; /**< ln(barrier / S) */
+    double w;           /**< +1 for calls, -1 for puts */
+    BrownianBridge bridge;
+
+    Simulation(const PathOption& option, const MonteCarloSettings& settings)
+        : option(option), settings(settings),
+          kernels(&thales::simd::kernels_for(settings.backend)),
+          samples(settings.antithetic ? (settings.paths + 1) / 2
+                                      : settings.paths),
+          steps(option.payoff == PathPayoff::EUROPEAN
+                    ? 1
+                    : static_cast<std::size_t>(option.steps)),
+          bridge(static_cast<int>(steps)) {
+        double dt = option.T / static_cast<double>(steps);
+        drift = (option.r - option.sigma * option.sigma / 2.0) * dt;
+        volatility = option.sigma * std::sqrt(dt);
+        log_barrier = option.barrier > 0.0
+                          ? std::log(option.barrier / option.S)
+                          : 0.0;
+        w = option.type == CALL ? 1.0 : -1.0;
+    }
+
+    std::size_t chunks() const {
+        return (samples + CHUNK_SAMPLES - 1) / CHUNK_SAMPLES;
+    }
+
+    /**
+     * @brief Fills the uniforms of samples [first, first + count)
+     */
+    void uniforms(std::size_t first, std::size_t count, double* u) const {
+        std::size_t sobol_draws =
+            settings.sequence == RandomSequence::SOBOL
+                ? std::min<std::size_t>(steps, MonteCarlo::SOBOL_DIMENSIONS)
+                : 0;
+        Philox4x32::Key key = {static_cast<std::uint32_t>(settings.seed),
+                               static_cast<std::uint32_t>(settings.seed >>
+                                                          32)};
+        for (std::size_t p = 0; p < count; ++p) {
+            std::uint64_t n = first + p;
+            for (std::size_t i = 0; i < sobol_draws; ++i) {
+                // Point 0 is the origin, whose quantiles are infinite
+                u[i * BLOCK_SAMPLES + p] =
+                    sobol_directions().point(n + 1, static_cast<int>(i));
+            }
+            for (std::size_t i = sobol_draws & ~std::size_t{1}; i < steps;
+                 i += 2) {
+                Philox4x32::Counter bits = Philox4x32::generate(
+                    {static_cast<std::uint32_t>(i / 2), 0,
+                     static_cast<std::uint32_t>(n),
+                     static_cast<std::uint32_t>(n >> 32)},
+                    key);
+                for (std::size_t half = 0; half < 2; ++half) {
+                    if (i + half < sobol_draws || i + half >= steps) {
+                        continue;
+                    }
+                    std::uint64_t mantissa =
+                        (std::uint64_t{bits[2 * half]} << 21) ^
+                        (bits[2 * half + 1] >> 11);
+                    u[(i + half) * BLOCK_SAMPLES + p] =
+                        (mantissa + 0.5) * 0x1p-53;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Simulates one chunk of samples
+     */
+    Moments run_chunk(std::size_t chunk) const {
+        std::size_t first = chunk * CHUNK_SAMPLES;
+        std::size_t last = std::min(samples, first + CHUNK_SAMPLES);
+        std::vector<double> z(steps * BLOCK_SAMPLES);
+        std::vector<double> path(steps * BLOCK_SAMPLES);
+        double payoff[BLOCK_SAMPLES];
+        double control[BLOCK_SAMPLES];
+        Moments moments;
+        for (std::size_t begin = first; begin < last;
+             begin += BLOCK_SAMPLES) {
+            std::size_t count = std::min(BLOCK_SAMPLES, last - begin);
+            uniforms(begin, count, z.data());
+            // Unused lanes of a short block still go through the kernels
+            for (std::size_t i = 0; i < steps; ++i) {
+                std::fill(z.begin() + i * BLOCK_SAMPLES + count,
+                          z.begin() + (i + 1) * BLOCK_SAMPLES, 0.5);
+            }
+            kernels->inverse_norm_cdf({z.data(), z.data(), z.size()});
+            if (settings.sequence == RandomSequence::SOBOL) {
+                bridge.transform(z.data(), path.data(), BLOCK_SAMPLES);
+            }
+
+            std::fill(payoff, payoff + BLOCK_SAMPLES, 0.0);
+            std::fill(control, control + BLOCK_SAMPLES, 0.0);
+            double weight = settings.antithetic ? 0.5 : 1.0;
+            simulate(z.data(), path.data(), 1.0, weight, payoff, control);
+            if (settings.antithetic) {
+                simulate(z.data(), path.data(), -1.0, weight, payoff,
+                         control);
+            }
+            for (std::size_t p = 0; p < count; ++p) {
+                moments.add(payoff[p], control[p]);
+            }
+        }
+        return moments;
+    }
+
+    /**
+     * @brief Adds weight times the payoff and control of every lane
+     *
+     * @param sign -1 for the antithetic paths
+     * @param path Scratch receiving the log-spot at each date
+     */
+    void simulate(const double* z, double* path, double sign, double weight,
+                  double* payoff, double* control) const {
+        constexpr std::size_t B = BLOCK_SAMPLES;
+        double x[B] = {};
+        double extreme[B];
+        bool up = option.payoff == PathPayoff::UP_AND_OUT ||
+                  option.payoff == PathPayoff::UP_AND_IN;
+        std::fill(extreme, extreme + B, up ? -HUGE_VAL : HUGE_VAL);
+        double scale = sign * volatility;
+        for (std::size_t s = 0; s < steps; ++s) {
+            const double* draw = z + s * B;
+            double* row = path + s * B;
+            for (std::size_t p = 0; p < B; ++p) {
+                x[p] += drift + scale * draw[p];
+                row[p] = x[p];
+                extreme[p] = up ? std::max(extreme[p], x[p])
+                                : std::min(extreme[p], x[p]);
+            }
+        }
+
+        double terminal[B];
+        kernels->exp({x, terminal, B});
+        double average[B];
+        if (option.payoff == PathPayoff::ASIAN) {
+            kernels->exp({path, path, steps * B});
+            std::fill(average, average + B, 0.0);
+            for (std::size_t s = 0; s < steps; ++s) {
+                for (std::size_t p = 0; p < B; ++p) {
+                    average[p] += path[s * B + p];
+                }
+            }
+        }
+
+        double S = option.S;
+        double K = option.K;
+        for (std::size_t p = 0; p < B; ++p) {
+            double vanilla = std::max(w * (S * terminal[p] - K), 0.0);
+            double value = vanilla;
+            switch (option.payoff) {
+                case PathPayoff::EUROPEAN:
+                    break;
+                case PathPayoff::ASIAN:
+                    value = std::max(
+                        w * (S * average[p] / static_cast<double>(steps) -
+                             K),
+                        0.0);
+                    break;
+                case PathPayoff::UP_AND_OUT:
+                    value = extreme[p] >= log_barrier ? 0.0 : vanilla;
+                    break;
+                case PathPayoff::UP_AND_IN:
+                    value = extreme[p] >= log_barrier ? vanilla : 0.0;
+                    break;
+                case PathPayoff::DOWN_AND_OUT:
+                    value = extreme[p] <= log_barrier ? 0.0 : vanilla;
+                    break;
+                case PathPayoff::DOWN_AND_IN:
+                    value = extreme[p] <= log_barrier ? vanilla : 0.0;
+                    break;
+            }
+            payoff[p] += weight * value;
+            control[p] += weight * vanilla;
+        }
+    }
+
+    MonteCarloResult result(const Moments& m) const {
+        double discount = std::exp(-option.r * option.T);
+        double mean_y = m.y / m.n;
+        double mean_c = m.c / m.n;
+        double var_y = std::max(m.yy - m.n * mean_y * mean_y, 0.0) /
+                       (m.n - 1.0);
+        double var_c = std::max(m.cc - m.n * mean_c * mean_c, 0.0) /
+                       (m.n - 1.0);
+        double cov = (m.yc - m.n * mean_y * mean_c) / (m.n - 1.0);
+
+        MonteCarloResult result;
+        result.paths = settings.antithetic ? 2 * samples : samples;
+        double estimate = mean_y;
+        double variance = var_y;
+        if (settings.control_variate && var_c > 0.0) {
+            double beta = cov / var_c;
+            double expected = BlackScholes::calculate_option_price(
+                                  option.S, option.K, option.T, option.r,
+                                  option.sigma, option.type) /
+                              discount;
+            estimate -= beta * (mean_c - expected);
+            variance = std::max(var_y - beta * cov, 0.0);
+        }
+        result.price = discount * estimate;
+        result.standard_error = discount * std::sqrt(variance / m.n);
+        return result;
+    }
+};
+
+void validate(const PathOption& option, const MonteCarloSettings& settings) {
+    if (!(option.S > 0) || !(option.K > 0) || !(option.T > 0) ||
+        !(option.sigma >= 0) || !std::isfinite(option.r)) {
+        throw std::invalid_argument("Invalid input parameters");
+    }
+    if (option.type != CALL && option.type != PUT) {
+        throw std::invalid_argument("Invalid option type");
+    }
+    switch (option.payoff) {
+        case PathPayoff::EUROPEAN:
+        case PathPayoff::ASIAN:
+            break;
+        case PathPayoff::UP_AND_OUT:
+        case PathPayoff::UP_AND_IN:
+        case PathPayoff::DOWN_AND_OUT:
+        case PathPayoff::DOWN_AND_IN:
+            if (!(option.barrier > 0) || !std::isfinite(option.barrier)) {
+                throw std::invalid_argument("Invalid barrier");
+            }
+            break;
+        default:
+            throw std::invalid_argument("Invalid payoff");
+    }
+    if (option.steps < 1) {
+        throw std::invalid_argument("Invalid number of steps");
+    }
+    // The variance needs two samples, and antithetic paths come in pairs
+    if (settings.paths < (settings.antithetic ? 4u : 2u)) {
+        throw std::invalid_argument("Too few paths");
+    }
+    if (settings.sequence != RandomSequence::PHILOX &&
+        settings.sequence != RandomSequence::SOBOL) {
+        throw std::invalid_argument("Invalid random sequence");
+    }
+}
+
+}  // namespace
+
+MonteCarloResult MonteCarlo::price(const PathOption& option,
+                                   const MonteCarloSettings& settings) {
+    validate(option, settings);
+    Simulation simulation(option, settings);
+    Moments total;
+    for (std::size_t chunk = 0; chunk < simulation.chunks(); ++chunk) {
+        total.add(simulation.run_chunk(chunk));
+    }
+    return simulation.result(total);
+}
+
+MonteCarloResult MonteCarlo::price(const PathOption& option,
+                                   const MonteCarloSettings& settings,
+                                   thales::ThreadPool& pool) {
+    validate(option, settings);
+    Simulation simulation(option, settings);
+    std::vector<Moments> chunks(simulation.chunks());
+    pool.parallel_for(chunks.size(),
+                      [&](std::size_t chunk, std::size_t /*worker*/) {
+                          chunks[chunk] = simulation.run_chunk(chunk);
+                      });
+    // Summed in chunk order so that the result does not depend on timing
+    Moments total;
+    for (const Moments& chunk : chunks) {
+        total.add(chunk);
+    }
+    return simulation.result(total);
+}
+
+void MonteCarlo::inverse_normal_cdf(const double* p, double* z,
+                                    std::size_t size, SimdBackend backend) {
+    thales::simd::kernels_for(backend).inverse_norm_cdf({p, z, size});
+}
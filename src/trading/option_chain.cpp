@@ -0,0 +1,179 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "trading/option_chain.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+
+#include "data/market_data.h"
+
+namespace thales {
+
+namespace {
+
+auto order_of(const ContractKey& key) {
+    return std::make_tuple(key.underlying, key.expiration, key.type,
+                           key.strike);
+}
+
+}  // namespace
+
+OptionChainIndex::OptionChainIndex(const std::vector<ContractKey>& contracts) {
+    build(contracts.size(), [&](std::size_t i) { return contracts[i]; });
+}
+
+OptionChainIndex::OptionChainIndex(const Portfolio& portfolio) {
+    build(portfolio.size(), [&](std::size_t i) {
+        return ContractKey{portfolio.get_symbol_ids()[i],
+                           portfolio.get_expirations()[i],
+                           portfolio.get_types()[i],
+                           portfolio.get_strikes()[i]};
+    });
+}
+
+OptionChainIndex::OptionChainIndex(const OptionChainColumns& chain) {
+    build(chain.size(), [&](std::size_t i) {
+        return ContractKey{chain.underlying[i], chain.expiration[i],
+                           chain.type[i], chain.strike[i]};
+    });
+}
+
+template <typename Key>
+void OptionChainIndex::build(std::size_t count, Key key) {
+    if (count >= std::numeric_limits<std::uint32_t>::max()) {
+        throw std::invalid_argument("Too many contracts to index");
+    }
+    std::vector<ContractKey> keys(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        keys[i] = key(i);
+    }
+    // Rows without a usable contract, e.g. missing chain fields, are left
+    // out
+    std::vector<std::uint32_t> order;
+    order.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (keys[i].underlying != INVALID_SYMBOL &&
+            std::isfinite(keys[i].strike)) {
+            order.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+    count = order.size();
+    std::stable_sort(order.begin(), order.end(),
+                     [&](std::uint32_t a, std::uint32_t b) {
+                         return order_of(keys[a]) < order_of(keys[b]);
+                     });
+
+    strikes.reserve(count);
+    sources.reserve(count);
+    entry_expiry.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const ContractKey& contract = keys[order[i]];
+        if (i + 1 < count && keys[order[i + 1]] == contract) {
+            continue;  // Keep the last row of a repeated contract
+        }
+        auto entry = static_cast<std::uint32_t>(strikes.size());
+        if (expiry_table.empty() ||
+            expiry_table.back().underlying != contract.underlying ||
+            expiry_table.back().expiration != contract.expiration) {
+            expiry_table.push_back({contract.underlying, contract.expiration,
+                                    entry, entry, entry});
+        }
+        Expiry& expiry = expiry_table.back();
+        if (contract.type == CALL) {
+            ++expiry.puts;
+        }
+        ++expiry.end;
+        strikes.push_back(contract.strike);
+        sources.push_back(order[i]);
+        entry_expiry.push_back(
+            static_cast<std::uint32_t>(expiry_table.size() - 1));
+    }
+
+    // Offsets of each underlying's expiries, indexed by SymbolId
+    std::size_t symbols =
+        expiry_table.empty() ? 0 : expiry_table.back().underlying + 1;
+    underlying_begin.assign(symbols + 1, 0);
+    for (const Expiry& expiry : expiry_table) {
+        ++underlying_begin[expiry.underlying + 1];
+    }
+    std::partial_sum(underlying_begin.begin(), underlying_begin.end(),
+                     underlying_begin.begin());
+}
+
+std::size_t OptionChainIndex::find(const ContractKey& contract) const {
+    const Expiry* first = nullptr;
+    std::size_t count = expiries(contract.underlying, &first);
+    const Expiry* last = first + count;
+    const Expiry* expiry = std::lower_bound(
+        first, last, contract.expiration,
+        [](const Expiry& e, std::int32_t day) { return e.expiration < day; });
+    if (expiry == last || expiry->expiration != contract.expiration) {
+        return NOT_FOUND;
+    }
+    auto [begin, end] = strike_range(*expiry, contract.type, contract.strike,
+                                     contract.strike);
+    return begin == end ? NOT_FOUND : begin;
+}
+
+std::size_t OptionChainIndex::expiries(SymbolId underlying,
+                                       const Expiry** first) const {
+    if (underlying + std::size_t{1} >= underlying_begin.size()) {
+        *first = nullptr;
+        return 0;
+    }
+    std::uint32_t begin = underlying_begin[underlying];
+    *first = expiry_table.data() + begin;
+    return underlying_begin[underlying + 1] - begin;
+}
+
+std::pair<std::size_t, std::size_t> OptionChainIndex::strike_range(
+    const Expiry& expiry, OptionType type, double min_strike,
+    double max_strike) const {
+    const double* first = strikes.data() + (type == CALL ? expiry.begin
+                                                          : expiry.puts);
+    const double* last = strikes.data() + (type == CALL ? expiry.puts
+                                                         : expiry.end);
+    const double* begin = std::lower_bound(first, last, min_strike);
+    const double* end = std::upper_bound(begin, last, max_strike);
+    return {static_cast<std::size_t>(begin - strikes.data()),
+            static_cast<std::size_t>(end - strikes.data())};
+}
+
+std::size_t OptionChainIndex::select(const ChainQuery& query,
+                                     std::vector<std::size_t>& rows) const {
+    return for_each(query,
+                    [&](std::size_t entry) { rows.push_back(sources[entry]); });
+}
+
+ContractKey OptionChainIndex::contract(std::size_t entry) const {
+    const Expiry& expiry = expiry_table[entry_expiry[entry]];
+    return {expiry.underlying, expiry.expiration,
+            entry < expiry.puts ? CALL : PUT, strikes[entry]};
+}
+
+}  // namespace thales
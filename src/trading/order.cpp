@@ -24,28 +24,43 @@
 
 #include "trading/order.h"
 
+#include "utils/date.h"
+
 namespace thales {
 
-Order::Order(const std::string& action, const std::string& symbol,
-             const std::string& option_type, double strike_price,
-             const std::string& expiration_date, int quantity, double premium,
-             const std::string& timestamp)
-    : action(action),
-      symbol(symbol),
-      option_type(option_type),
+Order::Order(Side side, SymbolId symbol, OptionType type, double strike_price,
+             std::int32_t expiration, int quantity, double premium,
+             std::int64_t timestamp)
+    : timestamp(timestamp),
       strike_price(strike_price),
-      expiration_date(expiration_date),
-      quantity(quantity),
       premium(premium),
-      timestamp(timestamp) {}
-
-std::string Order::get_action() const { return action; }
-std::string Order::get_symbol() const { return symbol; }
-std::string Order::get_option_type() const { return option_type; }
-double Order::get_strike_price() const { return strike_price; }
-std::string Order::get_expiration_date() const { return expiration_date; }
-int Order::get_quantity() const { return quantity; }
-double Order::get_premium() const { return premium; }
-std::string Order::get_timestamp() const { return timestamp; }
+      symbol(symbol),
+      expiration(expiration),
+      quantity(quantity),
+      type(type),
+      side(side) {}
+
+Order::Order(std::string_view action, std::string_view symbol,
+             std::string_view option_type, double strike_price,
+             std::string_view expiration_date, int quantity, double premium,
+             std::string_view timestamp)
+    : Order(parse_side(action), SymbolTable::intern(symbol),
+            parse_option_type(option_type), strike_price,
+            parse_date(expiration_date), quantity, premium,
+            parse_timestamp(timestamp)) {}
+
+std::string_view Order::get_action() const { return to_string(side); }
+
+const std::string& Order::get_symbol() const {
+    return SymbolTable::name(symbol);
+}
+
+std::string_view Order::get_option_type() const { return to_string(type); }
+
+std::string Order::get_expiration_date() const {
+    return format_date(expiration);
+}
+
+std::string Order::get_timestamp() const { return format_timestamp(timestamp); }
 
 }  // namespace thales
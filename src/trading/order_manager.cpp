@@ -0,0 +1,438 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "trading/order_manager.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+
+#include "config/config.h"
+#include "utils/logging.h"
+#include "utils/metrics.h"
+
+namespace thales {
+
+namespace {
+
+double parse_limit(const std::string& key, const std::string& value) {
+    errno = 0;
+    char* end = nullptr;
+    double limit = std::strtod(value.c_str(), &end);
+    if (value.empty() || *end != '\0' || errno != 0 || !(limit > 0.0) ||
+        !std::isfinite(limit)) {
+        throw std::invalid_argument("Risk limit " + key +
+                                    " must be a positive number: " + value);
+    }
+    return limit;
+}
+
+int parse_count(const std::string& key, const std::string& value) {
+    double limit = parse_limit(key, value);
+    if (limit != std::floor(limit) ||
+        limit > std::numeric_limits<int>::max()) {
+        throw std::invalid_argument("Risk limit " + key +
+                                    " must be a positive integer: " + value);
+    }
+    return static_cast<int>(limit);
+}
+
+double notional_of(int quantity, double price) {
+    return quantity * price * CONTRACT_MULTIPLIER;
+}
+
+void set_limit(RiskLimits& limits, const std::string& key,
+               const std::string& value, const std::string& source) {
+    if (key == "MAX_ORDER_QUANTITY") {
+        limits.max_order_quantity = parse_count(key, value);
+    } else if (key == "MAX_ORDER_NOTIONAL") {
+        limits.max_order_notional = parse_limit(key, value);
+    } else if (key == "MAX_POSITION") {
+        limits.max_position = parse_count(key, value);
+    } else if (key == "MAX_UNDERLYING_POSITION") {
+        limits.max_underlying_position = parse_count(key, value);
+    } else if (key == "MAX_WORKING_NOTIONAL") {
+        limits.max_working_notional = parse_limit(key, value);
+    } else if (key == "MAX_ORDERS_PER_SECOND") {
+        limits.max_orders_per_second = parse_limit(key, value);
+    } else if (key == "ORDER_BURST") {
+        limits.order_burst = parse_count(key, value);
+    } else {
+        throw std::invalid_argument("Unknown risk limit " + key + " in " +
+                                    source);
+    }
+}
+
+}  // namespace
+
+RiskLimits RiskLimits::load(const std::string& path) {
+    RiskLimits limits;
+    for (const auto& [key, value] : Config::load(path)) {
+        set_limit(limits, key, value, path);
+    }
+    return limits;
+}
+
+RiskLimits RiskLimits::load(const ConfigSnapshot& config) {
+    RiskLimits limits;
+    if (const ConfigSnapshot::Section* section =
+            config.section(CONFIG_SECTION)) {
+        for (const auto& [key, value] : *section) {
+            set_limit(limits, std::string(key), value.text(),
+                      std::string(CONFIG_SECTION) + ".cfg");
+        }
+    }
+    return limits;
+}
+
+std::string_view to_string(RejectReason reason) {
+    switch (reason) {
+        case RejectReason::NONE:
+            return "none";
+        case RejectReason::INVALID:
+            return "invalid order";
+        case RejectReason::UNKNOWN_CONTRACT:
+            return "unknown contract";
+        case RejectReason::ORDER_QUANTITY:
+            return "order quantity";
+        case RejectReason::ORDER_NOTIONAL:
+            return "order notional";
+        case RejectReason::POSITION_LIMIT:
+            return "position limit";
+        case RejectReason::UNDERLYING_LIMIT:
+            return "underlying limit";
+        case RejectReason::WORKING_NOTIONAL:
+            return "working notional";
+        case RejectReason::RATE_LIMIT:
+            return "rate limit";
+    }
+    return "unknown";
+}
+
+PreTradeRisk::PreTradeRisk(const RiskLimits& limits,
+                           std::pmr::memory_resource* resource)
+    : limits(limits),
+      contracts(resource),
+      underlyings(resource),
+      tokens(limits.order_burst) {}
+
+void PreTradeRisk::load(const Portfolio& portfolio) {
+    const auto& symbols = portfolio.get_symbol_ids();
+    const auto& types = portfolio.get_types();
+    const auto& strikes = portfolio.get_strikes();
+    const auto& expirations = portfolio.get_expirations();
+    const auto& quantities = portfolio.get_quantities();
+    for (std::size_t i = 0; i < portfolio.size(); ++i) {
+        add_position({symbols[i], expirations[i], types[i], strikes[i]},
+                     quantities[i]);
+    }
+}
+
+void PreTradeRisk::add_position(const ContractKey& contract, int quantity) {
+    Exposure& held = exposure(contract);
+    int before = std::abs(held.position);
+    held.position += quantity;
+    underlying(contract.underlying) += std::abs(held.position) - before;
+}
+
+RejectReason PreTradeRisk::check(const OrderRequest& order, double price,
+                                 std::int64_t now_ns) const {
+    if (order.quantity <= 0 || !(price > 0.0) || !std::isfinite(price) ||
+        order.contract.underlying == INVALID_SYMBOL) {
+        return RejectReason::INVALID;
+    }
+    if (universe != nullptr && !universe->contains(order.contract)) {
+        return RejectReason::UNKNOWN_CONTRACT;
+    }
+    if (order.quantity > limits.max_order_quantity) {
+        return RejectReason::ORDER_QUANTITY;
+    }
+    double order_notional = notional_of(order.quantity, price);
+    if (order_notional > limits.max_order_notional) {
+        return RejectReason::ORDER_NOTIONAL;
+    }
+
+    Exposure held;
+    auto found = contracts.find(order.contract);
+    if (found != contracts.end()) {
+        held = found->second;
+    }
+    // Worst case: every working order on this side fills
+    if (order.side == Side::BUY
+            ? held.position + held.buying + order.quantity >
+                  limits.max_position
+            : held.position - held.selling - order.quantity <
+                  -limits.max_position) {
+        return RejectReason::POSITION_LIMIT;
+    }
+    if (underlying_exposure(order.contract.underlying) + order.quantity >
+        limits.max_underlying_position) {
+        return RejectReason::UNDERLYING_LIMIT;
+    }
+    if (notional + order_notional > limits.max_working_notional) {
+        return RejectReason::WORKING_NOTIONAL;
+    }
+    if (tokens_at(now_ns) < 1.0) {
+        return RejectReason::RATE_LIMIT;
+    }
+    return RejectReason::NONE;
+}
+
+void PreTradeRisk::accept(const OrderRequest& order, double price,
+                          std::int64_t now_ns) {
+    Exposure& held = exposure(order.contract);
+    (order.side == Side::BUY ? held.buying : held.selling) += order.quantity;
+    underlying(order.contract.underlying) += order.quantity;
+    notional += notional_of(order.quantity, price);
+    tokens = tokens_at(now_ns) - 1.0;
+    refilled_ns = std::max(refilled_ns, now_ns);
+}
+
+void PreTradeRisk::fill(const OrderRequest& order, int quantity,
+                        double price) {
+    Exposure& held = exposure(order.contract);
+    int before = std::abs(held.position);
+    held.position += order.side == Side::BUY ? quantity : -quantity;
+    // The contracts leave the working total and join the held one
+    underlying(order.contract.underlying) +=
+        std::abs(held.position) - before - quantity;
+    close_working(order, quantity, price);
+}
+
+void PreTradeRisk::release(const OrderRequest& order, int quantity,
+                           double price) {
+    underlying(order.contract.underlying) -= quantity;
+    close_working(order, quantity, price);
+}
+
+void PreTradeRisk::close_working(const OrderRequest& order, int quantity,
+                                 double price) {
+    Exposure& held = exposure(order.contract);
+    (order.side == Side::BUY ? held.buying : held.selling) -= quantity;
+    notional = std::max(0.0, notional - notional_of(quantity, price));
+}
+
+int PreTradeRisk::position(const ContractKey& contract) const {
+    auto found = contracts.find(contract);
+    return found == contracts.end() ? 0 : found->second.position;
+}
+
+int PreTradeRisk::working(const ContractKey& contract, Side side) const {
+    auto found = contracts.find(contract);
+    if (found == contracts.end()) {
+        return 0;
+    }
+    return side == Side::BUY ? found->second.buying : found->second.selling;
+}
+
+int PreTradeRisk::underlying_exposure(SymbolId underlying) const {
+    return underlying < underlyings.size() ? underlyings[underlying] : 0;
+}
+
+double PreTradeRisk::tokens_at(std::int64_t now_ns) const {
+    double elapsed = std::max<std::int64_t>(now_ns - refilled_ns, 0) * 1e-9;
+    return std::min(tokens + elapsed * limits.max_orders_per_second,
+                    static_cast<double>(limits.order_burst));
+}
+
+PreTradeRisk::Exposure& PreTradeRisk::exposure(const ContractKey& contract) {
+    return contracts[contract];
+}
+
+int& PreTradeRisk::underlying(SymbolId symbol) {
+    if (symbol >= underlyings.size()) {
+        underlyings.resize(symbol + 1, 0);
+    }
+    return underlyings[symbol];
+}
+
+OrderManager::OrderManager(const RiskLimits& limits, BrokerAdapter& broker,
+                           Listener listener, std::size_t capacity)
+    : orders(capacity),
+      executions(capacity),
+      broker(broker),
+      listener(std::move(listener)),
+      book(limits, &pool),
+      working(&pool) {
+    working.reserve(capacity);
+}
+
+OrderManager::~OrderManager() { stop(); }
+
+void OrderManager::start() {
+    if (running.exchange(true)) {
+        return;
+    }
+    thread = std::thread(&OrderManager::run, this);
+}
+
+void OrderManager::stop() {
+    running.store(false, std::memory_order_release);
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+std::uint64_t OrderManager::submit(const OrderRequest& order,
+                                   double reference_price,
+                                   std::int64_t tick_ns) {
+    std::uint64_t id = next_id.fetch_add(1, std::memory_order_relaxed);
+    Ticket ticket{id, order, reference_price, tick_ns, steady_now_ns()};
+    if (!orders.try_push(ticket)) {
+        return 0;
+    }
+    METRIC_COUNT("thales_orders_submitted_total",
+                 "Orders queued to the order manager", 1);
+    return id;
+}
+
+bool OrderManager::report(const ExecutionReport& execution) {
+    return executions.try_push(execution);
+}
+
+void OrderManager::set_placement(const ThreadPlacement& placement) {
+    this->placement = placement;
+}
+
+void OrderManager::run() {
+    try {
+        pin_current_thread(placement.cpus);
+    } catch (const std::exception& e) {
+        LOG_WARN("Order manager thread left unpinned: {}",
+                 std::string_view(e.what()));
+    }
+    IdleWaiter waiter(placement.wait);
+    while (running.load(std::memory_order_acquire)) {
+        if (poll()) {
+            waiter.reset();
+        } else {
+            waiter.idle();
+        }
+    }
+    while (poll()) {
+    }
+}
+
+bool OrderManager::poll() {
+    bool busy = false;
+    Ticket ticket;
+    if (orders.try_pop(ticket)) {
+        process(ticket);
+        busy = true;
+    }
+    // Drain executions after every order so a broker that reports from
+    // send() can never fill the queue
+    ExecutionReport execution;
+    while (executions.try_pop(execution)) {
+        apply(execution);
+        busy = true;
+    }
+    return busy;
+}
+
+void OrderManager::process(const Ticket& ticket) {
+    const OrderRequest& request = ticket.request;
+    double price = std::isfinite(request.limit_price) ? request.limit_price
+                                                      : ticket.reference_price;
+    std::int64_t now = steady_now_ns();
+    RejectReason reason = book.check(request, price, now);
+    if (reason != RejectReason::NONE) {
+        rejected_count.fetch_add(1, std::memory_order_relaxed);
+        METRIC_COUNT("thales_orders_rejected_total",
+                     "Orders rejected by pre-trade risk", 1);
+        notify({ticket.id, OrderStatus::RISK_REJECTED, reason, request, 0, 0,
+                0.0});
+        return;
+    }
+
+    book.accept(request, price, now);
+    working.emplace(ticket.id, Working{request, price, 0});
+    working_count.store(working.size(), std::memory_order_relaxed);
+
+    std::int64_t sent_ns = steady_now_ns();
+    tick_latency.record(sent_ns - ticket.tick_ns);
+    send_latency.record(sent_ns - ticket.submit_ns);
+    try {
+        broker.send({ticket.id, request, price, ticket.tick_ns});
+    } catch (const std::exception&) {
+        book.release(request, request.quantity, price);
+        working.erase(ticket.id);
+        working_count.store(working.size(), std::memory_order_relaxed);
+        notify({ticket.id, OrderStatus::BROKER_REJECTED, RejectReason::NONE,
+                request, 0, 0, 0.0});
+        return;
+    }
+    sent_count.fetch_add(1, std::memory_order_relaxed);
+    METRIC_COUNT("thales_orders_sent_total", "Orders sent to the broker", 1);
+    notify({ticket.id, OrderStatus::SENT, RejectReason::NONE, request, 0, 0,
+            0.0});
+}
+
+void OrderManager::apply(const ExecutionReport& execution) {
+    auto found = working.find(execution.order_id);
+    if (found == working.end()) {
+        return;  // Unknown or already done
+    }
+    Working& order = found->second;
+    int remaining = order.request.quantity - order.filled;
+    OrderUpdate update{execution.order_id, OrderStatus::FILLED,
+                       RejectReason::NONE, order.request, order.filled, 0,
+                       0.0};
+
+    if (execution.kind == ExecutionKind::FILL) {
+        int quantity = std::min(std::max(execution.quantity, 0), remaining);
+        book.fill(order.request, quantity, order.price);
+        order.filled += quantity;
+        update.filled_quantity = order.filled;
+        update.last_quantity = quantity;
+        update.last_price = execution.price;
+        METRIC_COUNT("thales_fills_total", "Broker fills applied", 1);
+        if (order.filled < order.request.quantity) {
+            update.status = OrderStatus::PARTIALLY_FILLED;
+        }
+    } else {
+        book.release(order.request, remaining, order.price);
+        update.status = execution.kind == ExecutionKind::CANCEL
+                            ? OrderStatus::CANCELLED
+                            : OrderStatus::BROKER_REJECTED;
+    }
+
+    if (update.status != OrderStatus::PARTIALLY_FILLED) {
+        working.erase(found);
+        working_count.store(working.size(), std::memory_order_relaxed);
+    }
+    notify(update);
+}
+
+void OrderManager::notify(const OrderUpdate& update) {
+    if (listener) {
+        listener(update);
+    }
+}
+
+}  // namespace thales
@@ -24,25 +24,397 @@
 
 #include "trading/portfolio.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include <iomanip>
+#include <stdexcept>
+#include <string_view>
 #include <vector>
 
 #include "trading/order.h"
+#include "trading/vol_surface.h"
+#include "utils/arena.h"
+#include "utils/date.h"
+#include "utils/metrics.h"
+#include "utils/thread_pool.h"
 
 namespace thales {
 
+namespace {
+
+/** Number of positions revalued per call into the batch kernels. */
+constexpr std::size_t BLOCK_SIZE = 256;
+
+/**
+ * @brief Batch kernel inputs for one block of positions.
+ *
+ * Strikes and types are read straight from the portfolio columns; spots,
+ * volatilities and times to expiry are gathered from the market here.
+ * Settled positions get a zero weight and harmless dummy inputs.
+ */
+struct Block {
+    double S[BLOCK_SIZE];
+    double T[BLOCK_SIZE];
+    double r[BLOCK_SIZE];
+    double sigma[BLOCK_SIZE];
+    double weight[BLOCK_SIZE]; /**< Quantity times contract multiplier */
+    OptionBatch batch;
+};
+
+void validate(const MarketData& market, std::size_t symbol_count) {
+    if (market.spot.size() < symbol_count ||
+        market.volatility.size() < symbol_count) {
+        throw std::invalid_argument("Market data does not cover portfolio");
+    }
+}
+
+/**
+ * @brief Walks positions [first, last) in blocks, calling
+ * fn(block, begin, count) with begin relative to the portfolio.
+ */
+template <typename Fn>
+void for_each_block(const Portfolio& portfolio, const MarketData& market,
+                    std::size_t first, std::size_t last, Fn fn) {
+    constexpr double DAYS_PER_YEAR = 365.0;
+    Block block;
+    for (std::size_t i = 0; i < BLOCK_SIZE; ++i) {
+        block.r[i] = market.rate;
+    }
+    const SymbolId* symbols = portfolio.get_symbol_ids().data();
+    const OptionType* types = portfolio.get_types().data();
+    const double* strikes = portfolio.get_strikes().data();
+    const std::int32_t* expirations = portfolio.get_expirations().data();
+    const int* quantities = portfolio.get_quantities().data();
+    const double* spot = market.spot.data();
+    const double* volatility = market.volatility.data();
+    const std::vector<const VolSurface*>& surfaces = market.surfaces;
+
+    for (std::size_t begin = first; begin < last; begin += BLOCK_SIZE) {
+        std::size_t count = std::min(BLOCK_SIZE, last - begin);
+        for (std::size_t i = 0; i < count; ++i) {
+            std::size_t j = begin + i;
+            // Options expire at the end of their expiration date
+            double days = expirations[j] - market.valuation_date + 1;
+            bool live = days > 0;
+            block.S[i] = spot[symbols[j]];
+            block.T[i] = live ? days / DAYS_PER_YEAR : 1.0;
+            const VolSurface* surface =
+                symbols[j] < surfaces.size() ? surfaces[symbols[j]] : nullptr;
+            block.sigma[i] = surface != nullptr
+                                 ? surface->volatility(strikes[j], block.T[i])
+                                 : volatility[symbols[j]];
+            block.weight[i] = live ? quantities[j] * CONTRACT_MULTIPLIER : 0.0;
+        }
+        block.batch = {block.S, strikes + begin, block.T, block.r,
+                       block.sigma, types + begin, count};
+        fn(block, begin, count);
+    }
+}
+
+double market_value(const Portfolio& portfolio, const MarketData& market,
+                    std::size_t first, std::size_t last) {
+    double value = 0.0;
+    double prices[BLOCK_SIZE];
+    for_each_block(portfolio, market, first, last,
+                   [&](const Block& block, std::size_t, std::size_t count) {
+                       BlackScholes::calculate_option_prices(block.batch,
+                                                             prices);
+                       for (std::size_t i = 0; i < count; ++i) {
+                           value += block.weight[i] * prices[i];
+                       }
+                   });
+    return value;
+}
+
+void accumulate_risk(const Portfolio& portfolio, const MarketData& market,
+                     std::size_t first, std::size_t last,
+                     UnderlyingRisk* risk) {
+    const SymbolId* symbols = portfolio.get_symbol_ids().data();
+    double price[BLOCK_SIZE];
+    double delta[BLOCK_SIZE];
+    double gamma[BLOCK_SIZE];
+    double vega[BLOCK_SIZE];
+    double theta[BLOCK_SIZE];
+    GreeksBatch greeks = {price,   delta,   gamma,   vega,
+                          theta,   nullptr, nullptr, nullptr};
+    for_each_block(
+        portfolio, market, first, last,
+        [&](const Block& block, std::size_t begin, std::size_t count) {
+            BlackScholes::calculate_greeks(block.batch, greeks);
+            for (std::size_t i = 0; i < count; ++i) {
+                UnderlyingRisk& total = risk[symbols[begin + i]];
+                double weight = block.weight[i];
+                total.value += weight * price[i];
+                total.delta += weight * delta[i];
+                total.gamma += weight * gamma[i];
+                total.vega += weight * vega[i];
+                total.theta += weight * theta[i];
+            }
+        });
+}
+
+double spot_move_pnl(const Portfolio& portfolio, const MarketData& market,
+                     double spot_move, std::size_t first, std::size_t last) {
+    double pnl = 0.0;
+    double base[BLOCK_SIZE];
+    double moved[BLOCK_SIZE];
+    double moved_spots[BLOCK_SIZE];
+    for_each_block(portfolio, market, first, last,
+                   [&](const Block& block, std::size_t, std::size_t count) {
+                       for (std::size_t i = 0; i < count; ++i) {
+                           moved_spots[i] = block.S[i] * (1.0 + spot_move);
+                       }
+                       OptionBatch shocked = block.batch;
+                       shocked.S = moved_spots;
+                       BlackScholes::calculate_option_prices(block.batch, base);
+                       BlackScholes::calculate_option_prices(shocked, moved);
+                       for (std::size_t i = 0; i < count; ++i) {
+                           pnl += block.weight[i] * (moved[i] - base[i]);
+                       }
+                   });
+    return pnl;
+}
+
+void validate_spot_move(double spot_move) {
+    if (!(spot_move > -1.0)) {
+        throw std::invalid_argument("Spot move must be above -100%");
+    }
+}
+
+/** Positions per pool task: large enough to amortize scheduling. */
+constexpr std::size_t CHUNK_SIZE = 16 * BLOCK_SIZE;
+
+/** Per-worker partial sum, on its own cache line. */
+struct alignas(64) PartialSum {
+    double value = 0.0;
+};
+
+/**
+ * @brief Splits [0, size) into CHUNK_SIZE ranges run on the pool, calling
+ * fn(first, last, worker).
+ */
+template <typename Fn>
+void for_each_chunk(ThreadPool& pool, std::size_t size, Fn fn) {
+    std::size_t chunks = (size + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    pool.parallel_for(chunks, [&](std::size_t chunk, std::size_t worker) {
+        std::size_t first = chunk * CHUNK_SIZE;
+        fn(first, std::min(size, first + CHUNK_SIZE), worker);
+    });
+}
+
+/**
+ * @brief Scratch space for the per-worker partials of the calling thread.
+ *
+ * Each call takes its partials from an Arena::Scope, so repeated
+ * revaluations reuse the same memory instead of allocating.
+ */
+Arena& scratch() {
+    thread_local Arena arena(16 * 1024);
+    return arena;
+}
+
+/**
+ * @brief Sums fn(first, last) over the chunks of [0, size) on the pool.
+ */
+template <typename Fn>
+double parallel_sum(ThreadPool& pool, std::size_t size, Fn fn) {
+    Arena::Scope scope(scratch());
+    std::pmr::vector<PartialSum> partials(pool.size(), &scratch());
+    for_each_chunk(pool, size,
+                   [&](std::size_t first, std::size_t last,
+                       std::size_t worker) {
+                       partials[worker].value += fn(first, last);
+                   });
+    double total = 0.0;
+    for (const PartialSum& partial : partials) {
+        total += partial.value;
+    }
+    return total;
+}
+
+}  // namespace
+
 /**
  * @brief Constructs a Portfolio object.
  */
-Portfolio::Portfolio(double net_liquidity, const std::vector<Position>& positions)
-    : net_liquidity(net_liquidity), positions(positions) {}
+Portfolio::Portfolio(double net_liquidity,
+                     std::pmr::memory_resource* resource)
+    : net_liquidity(net_liquidity),
+      symbols(resource),
+      types(resource),
+      strikes(resource),
+      expirations(resource),
+      quantities(resource),
+      premiums(resource) {}
+
+Portfolio::Portfolio(double net_liquidity,
+                     const std::vector<Position>& positions,
+                     std::pmr::memory_resource* resource)
+    : Portfolio(net_liquidity, resource) {
+    reserve(positions.size());
+    for (const auto& position : positions) {
+        add_position(position);
+    }
+}
 
 /**
  * @brief Getters for Portfolio class members.
  */
 double Portfolio::get_net_liquidity() const { return net_liquidity; }
-std::vector<Position> Portfolio::get_positions() const { return positions; }
+Portfolio::Positions Portfolio::get_positions() const {
+    return Positions(*this);
+}
+
+Position Portfolio::get_position(std::size_t index) const {
+    return Position(symbols[index], types[index], strikes[index],
+                    expirations[index], quantities[index], premiums[index]);
+}
+
+void Portfolio::add_position(const Position& position) {
+    symbols.push_back(position.get_symbol_id());
+    types.push_back(position.get_type());
+    strikes.push_back(position.get_strike_price());
+    expirations.push_back(position.get_expiration());
+    quantities.push_back(position.get_quantity());
+    premiums.push_back(position.get_premium());
+    symbol_count = std::max<std::size_t>(symbol_count,
+                                         position.get_symbol_id() + 1);
+}
+
+void Portfolio::set_position(std::size_t index, int quantity,
+                             double premium) {
+    quantities[index] = quantity;
+    premiums[index] = premium;
+}
+
+void Portfolio::reserve(std::size_t capacity) {
+    symbols.reserve(capacity);
+    types.reserve(capacity);
+    strikes.reserve(capacity);
+    expirations.reserve(capacity);
+    quantities.reserve(capacity);
+    premiums.reserve(capacity);
+}
+
+double Portfolio::calculate_market_value(const MarketData& market) const {
+    METRIC_TIME_SCOPE("thales_portfolio_revaluation_seconds",
+                      "Time to revalue a whole portfolio");
+    METRIC_COUNT("thales_positions_repriced_total",
+                 "Positions repriced by portfolio revaluations", size());
+    validate(market, symbol_count);
+    return market_value(*this, market, 0, size());
+}
+
+double Portfolio::calculate_market_value(const MarketData& market,
+                                         ThreadPool& pool) const {
+    METRIC_TIME_SCOPE("thales_portfolio_revaluation_seconds",
+                      "Time to revalue a whole portfolio");
+    METRIC_COUNT("thales_positions_repriced_total",
+                 "Positions repriced by portfolio revaluations", size());
+    validate(market, symbol_count);
+    return parallel_sum(pool, size(), [&](std::size_t first, std::size_t last) {
+        return market_value(*this, market, first, last);
+    });
+}
+
+double Portfolio::calculate_net_liquidity(const MarketData& market) const {
+    double book_value = 0.0;
+    for (std::size_t i = 0; i < premiums.size(); ++i) {
+        bool live = expirations[i] >= market.valuation_date;
+        book_value += live ? quantities[i] * premiums[i] : 0.0;
+    }
+    return net_liquidity + calculate_market_value(market) -
+           book_value * CONTRACT_MULTIPLIER;
+}
+
+void Portfolio::calculate_risk(const MarketData& market,
+                               std::vector<UnderlyingRisk>& risk) const {
+    METRIC_TIME_SCOPE("thales_portfolio_revaluation_seconds",
+                      "Time to revalue a whole portfolio");
+    METRIC_COUNT("thales_positions_repriced_total",
+                 "Positions repriced by portfolio revaluations", size());
+    validate(market, symbol_count);
+    risk.assign(market.spot.size(), UnderlyingRisk{});
+    accumulate_risk(*this, market, 0, size(), risk.data());
+}
+
+void Portfolio::calculate_risk(const MarketData& market,
+                               std::vector<UnderlyingRisk>& risk,
+                               ThreadPool& pool) const {
+    METRIC_TIME_SCOPE("thales_portfolio_revaluation_seconds",
+                      "Time to revalue a whole portfolio");
+    METRIC_COUNT("thales_positions_repriced_total",
+                 "Positions repriced by portfolio revaluations", size());
+    validate(market, symbol_count);
+    std::size_t underlyings = market.spot.size();
+    // One accumulator per worker, reduced once all chunks are done. The
+    // arena is not thread-safe, so the partials are sized up front here
+    Arena::Scope scope(scratch());
+    std::pmr::vector<std::pmr::vector<UnderlyingRisk>> partials(
+        pool.size(), &scratch());
+    for (auto& partial : partials) {
+        partial.resize(underlyings);
+    }
+    for_each_chunk(pool, size(),
+                   [&](std::size_t first, std::size_t last,
+                       std::size_t worker) {
+                       accumulate_risk(*this, market, first, last,
+                                       partials[worker].data());
+                   });
+
+    risk.assign(underlyings, UnderlyingRisk{});
+    for (const auto& partial : partials) {
+        for (std::size_t id = 0; id < partial.size(); ++id) {
+            risk[id].value += partial[id].value;
+            risk[id].delta += partial[id].delta;
+            risk[id].gamma += partial[id].gamma;
+            risk[id].vega += partial[id].vega;
+            risk[id].theta += partial[id].theta;
+        }
+    }
+}
+
+double Portfolio::calculate_spot_move_pnl(const MarketData& market,
+                                          double spot_move) const {
+    validate_spot_move(spot_move);
+    validate(market, symbol_count);
+    return spot_move_pnl(*this, market, spot_move, 0, size());
+}
+
+double Portfolio::calculate_spot_move_pnl(const MarketData& market,
+                                          double spot_move,
+                                          ThreadPool& pool) const {
+    validate_spot_move(spot_move);
+    validate(market, symbol_count);
+    return parallel_sum(pool, size(), [&](std::size_t first, std::size_t last) {
+        return spot_move_pnl(*this, market, spot_move, first, last);
+    });
+}
+
+double book_trade(int& quantity, double& average, int traded, double price) {
+    if (traded == 0) {
+        return 0.0;
+    }
+    int held = quantity;
+    int total = held + traded;
+    double realized = 0.0;
+    if (held == 0 || (held > 0) == (traded > 0)) {
+        average = (held * average + traded * price) / total;
+    } else {
+        int closed = std::min(std::abs(held), std::abs(traded));
+        realized = (held > 0 ? closed : -closed) * (price - average) *
+                   CONTRACT_MULTIPLIER;
+        if (total == 0) {
+            average = 0.0;
+        } else if ((total > 0) != (held > 0)) {
+            // Flipped through flat: the remainder opens at the fill price
+            average = price;
+        }
+    }
+    quantity = total;
+    return realized;
+}
 
 /**
  * @brief Fetches the current portfolio information.
@@ -50,12 +422,16 @@ std::vector<Position> Portfolio::get_positions() const { return positions; }
  * This is a simulated function that generates a portfolio with predefined
  * values.
  *
+ * @param resource Resource the portfolio is allocated from.
  * @return The current portfolio.
  */
-Portfolio fetch_portfolio() {
-    Portfolio portfolio(
-        10000.0, {Position("AAPL", "Call", 150.0, "2024-12-15", 10, 5.0),
-                  Position("TSLA", "Put", 700.0, "2024-12-15", 5, 10.0)});
+Portfolio fetch_portfolio(std::pmr::memory_resource* resource) {
+    Portfolio portfolio(10000.0, resource);
+    portfolio.reserve(2);
+    portfolio.add_position(
+        Position("AAPL", "Call", 150.0, "2024-12-15", 10, 5.0));
+    portfolio.add_position(
+        Position("TSLA", "Put", 700.0, "2024-12-15", 5, 10.0));
     return portfolio;
 }
 
@@ -65,16 +441,21 @@ Portfolio fetch_portfolio() {
  * This is a simulated function that generates a list of orders with predefined
  * values.
  *
+ * @param resource Resource the list is allocated from.
  * @return A list of recently executed orders.
  */
-std::vector<Order> fetch_orders() {
+std::pmr::vector<Order> fetch_orders(std::pmr::memory_resource* resource) {
+    // Parsed once; each call only copies the compact records
+    static const Order buy("Buy", "AAPL", "Call", 150.0, "2024-12-15", 10, 5.0,
+                           "2024-06-15T10:15:00Z");
+    static const Order sell("Sell", "TSLA", "Put", 700.0, "2024-12-15", 5,
+                            10.0, "2024-06-15T10:16:00Z");
     static int count = 0;
-    std::vector<Order> orders;
-    orders.push_back(Order("Buy", "AAPL", "Call", 150.0, "2024-12-15", 10, 5.0,
-                           "2024-06-15T10:15:00Z"));
+    std::pmr::vector<Order> orders(resource);
+    orders.reserve(2);
+    orders.push_back(buy);
     if (++count % 2 == 0) {
-        orders.push_back(Order("Sell", "TSLA", "Put", 700.0, "2024-12-15", 5,
-                               10.0, "2024-06-15T10:16:00Z"));
+        orders.push_back(sell);
     }
     return orders;
 }
@@ -97,11 +478,14 @@ void display_portfolio(const Portfolio& portfolio) {
     std::cout << std::string(65, '-') << std::endl;
 
     // Display the portfolio positions
+    char expiration[DATE_LENGTH];
     for (const auto& position : portfolio.get_positions()) {
+        format_date(position.get_expiration(), expiration);
         std::cout << std::left << std::setw(10) << position.get_symbol()
                   << std::setw(10) << position.get_option_type()
                   << std::setw(10) << position.get_strike_price()
-                  << std::setw(15) << position.get_expiration_date()
+                  << std::setw(15)
+                  << std::string_view(expiration, DATE_LENGTH)
                   << std::setw(10) << position.get_quantity()
                   << std::setw(10) << position.get_premium()
                   << std::endl;
@@ -117,14 +501,19 @@ void display_portfolio(const Portfolio& portfolio) {
  *
  * @param orders The list of orders to display.
  */
-void display_orders(const std::vector<Order>& orders) {
+void display_orders(const std::pmr::vector<Order>& orders) {
     std::cout << "Recent orders:\n";
+    char timestamp[TIMESTAMP_LENGTH];
+    char expiration[DATE_LENGTH];
     for (const auto& order : orders) {
-        std::cout << "  " << order.get_timestamp() << " - "
+        std::size_t length =
+            format_timestamp(order.get_timestamp_ns(), timestamp);
+        format_date(order.get_expiration(), expiration);
+        std::cout << "  " << std::string_view(timestamp, length) << " - "
                   << order.get_action() << " " << order.get_quantity() << " "
                   << order.get_symbol() << " " << order.get_option_type() << " "
                   << order.get_strike_price() << " @ "
-                  << order.get_expiration_date() << " for $"
+                  << std::string_view(expiration, DATE_LENGTH) << " for $"
                   << order.get_premium() << " each\n";
     }
 }
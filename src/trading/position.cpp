@@ -22,43 +22,35 @@
  * SOFTWARE.
  */
 
-/*
- * MIT License
- *
- * Copyright (c) 2024 Cody Michael Jones
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
- * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
- * SOFTWARE.
- */
-
 #include "trading/position.h"
 
+#include "utils/date.h"
+
 namespace thales {
 
-Position::Position(const Option& option, int quantity)
-    : option(option), quantity(quantity) {}
+Position::Position(SymbolId symbol, OptionType type, double strike_price,
+                   std::int32_t expiration, int quantity, double premium)
+    : symbol(symbol),
+      expiration(expiration),
+      strike_price(strike_price),
+      premium(premium),
+      quantity(quantity),
+      type(type) {}
+
+Position::Position(std::string_view symbol, std::string_view option_type,
+                   double strike_price, std::string_view expiration_date,
+                   int quantity, double premium)
+    : Position(SymbolTable::intern(symbol), parse_option_type(option_type),
+               strike_price, parse_date(expiration_date), quantity, premium) {}
 
-const Option& Position::get_option() const {
-    return option;
+const std::string& Position::get_symbol() const {
+    return SymbolTable::name(symbol);
 }
 
-int Position::get_quantity() const {
-    return quantity;
+std::string_view Position::get_option_type() const { return to_string(type); }
+
+std::string Position::get_expiration_date() const {
+    return format_date(expiration);
 }
 
 }  // namespace thales
@@ -0,0 +1,687 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "trading/risk_aggregation.h"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#include "trading/symbol_table.h"
+#include "utils/logging.h"
+#include "utils/metrics.h"
+
+namespace thales {
+
+namespace {
+
+constexpr char FRAME_MAGIC[4] = {'T', 'R', 'S', 'K'};
+constexpr std::uint16_t FRAME_VERSION = 1;
+
+enum FrameType : std::uint16_t {
+    SNAPSHOT = 1, /**< Replaces everything held for the shard */
+    DELTA = 2,    /**< Changes since the previous frame */
+};
+
+struct FrameHeader {
+    char magic[4];
+    std::uint16_t version;
+    std::uint16_t type;
+    std::uint32_t bytes; /**< Whole frame, header included */
+    std::uint32_t shard;
+    std::uint32_t names;
+    std::uint32_t records;
+    std::uint64_t sequence;
+    std::int64_t timestamp_ns;
+};
+static_assert(sizeof(FrameHeader) == 40, "FrameHeader must be packed");
+
+/** One underlying's totals in a shard. */
+struct WireRecord {
+    std::uint32_t symbol; /**< Wire index */
+    std::int32_t contracts;
+    double value;
+    double delta;
+    double gamma;
+    double vega;
+    double theta;
+    double cost;
+    double realized_pnl;
+};
+static_assert(sizeof(WireRecord) == 64, "WireRecord must be packed");
+
+constexpr std::uint32_t NO_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+/** Longest the server blocks before checking for stop(). */
+constexpr int POLL_INTERVAL_MS = 100;
+
+std::uint64_t hash_names(std::string_view account,
+                         std::string_view underlying) {
+    // FNV-1a over both names, separated so "AB"+"C" differs from "A"+"BC"
+    std::uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](std::string_view text) {
+        for (char c : text) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ull;
+        }
+    };
+    mix(account);
+    hash ^= 0xff;
+    hash *= 1099511628211ull;
+    mix(underlying);
+    return hash;
+}
+
+bool same(const UnderlyingBook& a, const UnderlyingBook& b) {
+    return a.risk.value == b.risk.value && a.risk.delta == b.risk.delta &&
+           a.risk.gamma == b.risk.gamma && a.risk.vega == b.risk.vega &&
+           a.risk.theta == b.risk.theta && a.cost == b.cost &&
+           a.realized_pnl == b.realized_pnl && a.contracts == b.contracts;
+}
+
+void add(UnderlyingBook& total, const UnderlyingBook& book) {
+    total.risk.value += book.risk.value;
+    total.risk.delta += book.risk.delta;
+    total.risk.gamma += book.risk.gamma;
+    total.risk.vega += book.risk.vega;
+    total.risk.theta += book.risk.theta;
+    total.cost += book.cost;
+    total.realized_pnl += book.realized_pnl;
+    total.contracts += book.contracts;
+}
+
+template <typename T>
+void append(std::string& frame, const T& value) {
+    frame.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void append_text(std::string& frame, std::string_view text) {
+    std::uint16_t length = static_cast<std::uint16_t>(
+        std::min<std::size_t>(text.size(), 0xffff));
+    append(frame, length);
+    frame.append(text.data(), length);
+}
+
+/**
+ * @brief Bounds-checked reads from a frame.
+ */
+class FrameReader {
+   public:
+    explicit FrameReader(std::string_view frame) : rest(frame) {}
+
+    template <typename T>
+    T read() {
+        T value;
+        std::memcpy(&value, take(sizeof(T)).data(), sizeof(T));
+        return value;
+    }
+
+    std::string_view read_text() {
+        return take(read<std::uint16_t>());
+    }
+
+    bool done() const { return rest.empty(); }
+
+   private:
+    std::string_view take(std::size_t count) {
+        if (count > rest.size()) {
+            throw std::invalid_argument("Truncated risk frame");
+        }
+        std::string_view taken = rest.substr(0, count);
+        rest.remove_prefix(count);
+        return taken;
+    }
+
+    std::string_view rest;
+};
+
+std::int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+}  // namespace
+
+RiskAggregationSettings RiskAggregationSettings::load(
+    const ConfigSnapshot& config) {
+    RiskAggregationSettings settings;
+    if (const ConfigValue* account = config.find(CONFIG_SECTION, "ACCOUNT")) {
+        settings.account = account->text();
+    }
+    if (const ConfigValue* host =
+            config.find(CONFIG_SECTION, "AGGREGATOR_HOST")) {
+        settings.host = host->text();
+    }
+    std::int64_t shard =
+        config.get_int(CONFIG_SECTION, "SHARD", settings.shard);
+    std::int64_t shards =
+        config.get_int(CONFIG_SECTION, "SHARD_COUNT", settings.shard_count);
+    std::int64_t port =
+        config.get_int(CONFIG_SECTION, "AGGREGATOR_PORT", settings.port);
+    std::int64_t interval =
+        config.get_int(CONFIG_SECTION, "PUBLISH_INTERVAL_MS",
+                       settings.publish_interval.count());
+    if (shards < 1 || shards > std::numeric_limits<std::uint32_t>::max() ||
+        shard < 0 || shard >= shards || port < 1 || port > 65535 ||
+        interval < 1) {
+        throw std::invalid_argument("Invalid risk aggregation settings in " +
+                                    std::string(CONFIG_SECTION) + ".cfg");
+    }
+    settings.shard = static_cast<std::uint32_t>(shard);
+    settings.shard_count = static_cast<std::uint32_t>(shards);
+    settings.port = static_cast<std::uint16_t>(port);
+    settings.publish_interval = std::chrono::milliseconds(interval);
+    return settings;
+}
+
+std::uint32_t shard_of(std::string_view account, std::string_view underlying,
+                       std::uint32_t shard_count) {
+    if (shard_count == 0) {
+        throw std::invalid_argument("Shard count must be positive");
+    }
+    return static_cast<std::uint32_t>(hash_names(account, underlying) %
+                                      shard_count);
+}
+
+Portfolio select_shard(const Portfolio& book, std::string_view account,
+                       std::uint32_t shard, std::uint32_t shard_count,
+                       std::pmr::memory_resource* resource) {
+    if (shard >= shard_count) {
+        throw std::invalid_argument("Shard out of range");
+    }
+    Portfolio selected(shard == 0 ? book.get_net_liquidity() : 0.0,
+                       resource);
+    // Decide once per underlying rather than hashing every row
+    std::unordered_map<SymbolId, bool> mine;
+    const auto& symbols = book.get_symbol_ids();
+    for (std::size_t i = 0; i < book.size(); ++i) {
+        auto [entry, added] = mine.try_emplace(symbols[i], false);
+        if (added) {
+            entry->second = shard_of(account, SymbolTable::name(symbols[i]),
+                                     shard_count) == shard;
+        }
+        if (entry->second) {
+            selected.add_position(book.get_position(i));
+        }
+    }
+    return selected;
+}
+
+RiskDeltaEncoder::RiskDeltaEncoder(std::uint32_t shard, std::string account)
+    : shard(shard), account(std::move(account)) {}
+
+void RiskDeltaEncoder::reset() {
+    full = true;
+}
+
+std::size_t RiskDeltaEncoder::encode(
+    const std::vector<UnderlyingBook>& underlyings, std::int64_t timestamp_ns,
+    std::string& frame) {
+    if (full) {
+        sent.clear();
+        indices.clear();
+        next_index = 0;
+    }
+    std::size_t count = std::max(underlyings.size(), sent.size());
+    sent.resize(count);
+    indices.resize(count, NO_INDEX);
+
+    FrameHeader header = {};
+    std::memcpy(header.magic, FRAME_MAGIC, sizeof(FRAME_MAGIC));
+    header.version = FRAME_VERSION;
+    header.type = full ? SNAPSHOT : DELTA;
+    header.shard = shard;
+    header.sequence = next_sequence;
+    header.timestamp_ns = timestamp_ns;
+
+    // Names go before the records that use them, so records are gathered
+    // separately and appended last
+    frame.assign(sizeof(header), '\0');
+    if (full) {
+        append_text(frame, account);
+    }
+    std::string records;
+    for (std::size_t id = 0; id < count; ++id) {
+        UnderlyingBook book =
+            id < underlyings.size() ? underlyings[id] : UnderlyingBook{};
+        // A SNAPSHOT compares against nothing held
+        if (same(book, sent[id])) {
+            continue;
+        }
+        if (indices[id] == NO_INDEX) {
+            indices[id] = next_index++;
+            append(frame, indices[id]);
+            append_text(frame, SymbolTable::name(static_cast<SymbolId>(id)));
+            ++header.names;
+        }
+        WireRecord record = {indices[id],     book.contracts,
+                             book.risk.value, book.risk.delta,
+                             book.risk.gamma, book.risk.vega,
+                             book.risk.theta, book.cost,
+                             book.realized_pnl};
+        append(records, record);
+        ++header.records;
+        sent[id] = book;
+    }
+    frame += records;
+    header.bytes = static_cast<std::uint32_t>(frame.size());
+    std::memcpy(frame.data(), &header, sizeof(header));
+
+    full = false;
+    ++next_sequence;
+    return header.records;
+}
+
+std::size_t RiskAggregator::frame_size(std::string_view data) {
+    if (data.size() < sizeof(FrameHeader)) {
+        return 0;
+    }
+    FrameHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (std::memcmp(header.magic, FRAME_MAGIC, sizeof(FRAME_MAGIC)) != 0 ||
+        header.version != FRAME_VERSION) {
+        throw std::invalid_argument("Not a risk frame");
+    }
+    if (header.bytes < sizeof(header) || header.bytes > MAX_FRAME_BYTES) {
+        throw std::invalid_argument("Risk frame size out of range");
+    }
+    return header.bytes;
+}
+
+void RiskAggregator::apply(std::string_view frame) {
+    if (frame_size(frame) != frame.size()) {
+        throw std::invalid_argument("Risk frame size mismatch");
+    }
+    FrameReader reader(frame);
+    FrameHeader header = reader.read<FrameHeader>();
+    if (header.type != SNAPSHOT && header.type != DELTA) {
+        throw std::invalid_argument("Unknown risk frame type");
+    }
+
+    // Decode everything before touching any state
+    std::string_view account;
+    if (header.type == SNAPSHOT) {
+        account = reader.read_text();
+    }
+    // Names stay views into the frame until it is accepted, so a rejected
+    // frame never grows the process-wide symbol table
+    std::vector<std::pair<std::uint32_t, std::string_view>> names;
+    names.reserve(std::min<std::size_t>(header.names, frame.size()));
+    for (std::uint32_t i = 0; i < header.names; ++i) {
+        std::uint32_t index = reader.read<std::uint32_t>();
+        names.emplace_back(index, reader.read_text());
+    }
+    std::vector<WireRecord> records;
+    records.reserve(std::min<std::size_t>(header.records, frame.size()));
+    for (std::uint32_t i = 0; i < header.records; ++i) {
+        records.push_back(reader.read<WireRecord>());
+    }
+    if (!reader.done()) {
+        throw std::invalid_argument("Trailing bytes in risk frame");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = shard_books.find(header.shard);
+    if (header.type == DELTA &&
+        (found == shard_books.end() ||
+         header.sequence != found->second.sequence + 1)) {
+        throw std::invalid_argument("Risk frame out of sequence for shard " +
+                                    std::to_string(header.shard));
+    }
+    std::size_t known = header.type == DELTA ? found->second.symbols.size() : 0;
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        if (names[i].first != known + i) {
+            throw std::invalid_argument("Risk frame names out of order");
+        }
+    }
+    for (const WireRecord& record : records) {
+        if (record.symbol >= known + names.size()) {
+            throw std::invalid_argument("Risk frame uses an unknown name");
+        }
+    }
+
+    // Valid: apply
+    Shard& shard = shard_books[header.shard];
+    if (header.type == SNAPSHOT) {
+        shard.account = std::string(account);
+        shard.symbols.clear();
+        std::vector<UnderlyingBook> previous;
+        previous.swap(shard.books);
+        for (std::size_t id = 0; id < previous.size(); ++id) {
+            if (!same(previous[id], UnderlyingBook{})) {
+                resum(static_cast<SymbolId>(id));
+            }
+        }
+    }
+    for (const auto& entry : names) {
+        shard.symbols.push_back(SymbolTable::intern(entry.second));
+    }
+    shard.sequence = header.sequence;
+    shard.timestamp_ns = header.timestamp_ns;
+    for (const WireRecord& record : records) {
+        SymbolId symbol = shard.symbols[record.symbol];
+        if (symbol >= shard.books.size()) {
+            shard.books.resize(symbol + std::size_t{1});
+        }
+        UnderlyingBook& book = shard.books[symbol];
+        book.risk = {record.value, record.delta, record.gamma, record.vega,
+                     record.theta};
+        book.cost = record.cost;
+        book.realized_pnl = record.realized_pnl;
+        book.contracts = record.contracts;
+        resum(symbol);
+    }
+    ++frames;
+    METRIC_COUNT("thales_risk_frames_applied_total",
+                 "Shard risk frames applied by the aggregator", 1);
+}
+
+void RiskAggregator::resum(SymbolId symbol) {
+    if (symbol >= firm.size()) {
+        firm.resize(symbol + std::size_t{1});
+    }
+    UnderlyingBook total;
+    for (const auto& [number, shard] : shard_books) {
+        if (symbol < shard.books.size()) {
+            add(total, shard.books[symbol]);
+        }
+    }
+    firm[symbol] = total;
+}
+
+std::uint64_t RiskAggregator::snapshot(
+    UnderlyingBook& totals, std::vector<UnderlyingBook>& underlyings) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    underlyings = firm;
+    totals = UnderlyingBook{};
+    for (const UnderlyingBook& book : firm) {
+        add(totals, book);
+    }
+    return frames;
+}
+
+std::vector<ShardStatus> RiskAggregator::shards() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<ShardStatus> statuses;
+    for (const auto& [number, shard] : shard_books) {
+        ShardStatus status;
+        status.shard = number;
+        status.account = shard.account;
+        status.sequence = shard.sequence;
+        status.timestamp_ns = shard.timestamp_ns;
+        for (const UnderlyingBook& book : shard.books) {
+            add(status.totals, book);
+        }
+        statuses.push_back(std::move(status));
+    }
+    return statuses;
+}
+
+std::int64_t RiskAggregator::staleness_ns(std::int64_t now_ns) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::int64_t oldest = 0;
+    for (const auto& [number, shard] : shard_books) {
+        oldest = std::max(oldest, now_ns - shard.timestamp_ns);
+    }
+    return oldest;
+}
+
+RiskAggregatorServer::RiskAggregatorServer(RiskAggregator& aggregator,
+                                           std::uint16_t port,
+                                           const std::string& address)
+    : aggregator(aggregator) {
+    sockaddr_in local = {};
+    local.sin_family = AF_INET;
+    local.sin_port = htons(port);
+    if (::inet_pton(AF_INET, address.c_str(), &local.sin_addr) != 1) {
+        throw std::runtime_error("Invalid aggregator address " + address);
+    }
+    listener = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    int one = 1;
+    socklen_t length = sizeof(local);
+    if (listener < 0 ||
+        ::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one,
+                     sizeof(one)) != 0 ||
+        ::bind(listener, reinterpret_cast<sockaddr*>(&local),
+               sizeof(local)) != 0 ||
+        ::listen(listener, 128) != 0 ||
+        ::getsockname(listener, reinterpret_cast<sockaddr*>(&local),
+                      &length) != 0) {
+        std::string error = std::strerror(errno);
+        if (listener >= 0) {
+            ::close(listener);
+        }
+        throw std::runtime_error("Unable to listen on " + address + ":" +
+                                 std::to_string(port) + ": " + error);
+    }
+    listen_port = ntohs(local.sin_port);
+}
+
+RiskAggregatorServer::~RiskAggregatorServer() {
+    stop();
+    ::close(listener);
+}
+
+void RiskAggregatorServer::start() {
+    if (thread.joinable()) {
+        return;
+    }
+    stopping = false;
+    thread = std::thread([this] { run(); });
+}
+
+void RiskAggregatorServer::stop() {
+    stopping = true;
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void RiskAggregatorServer::run() {
+    // Bytes received but not yet applied, by connection
+    std::map<int, std::string> clients;
+    std::vector<pollfd> fds;
+    while (!stopping) {
+        fds.assign(1, {listener, POLLIN, 0});
+        for (const auto& client : clients) {
+            fds.push_back({client.first, POLLIN, 0});
+        }
+        if (::poll(fds.data(), fds.size(), POLL_INTERVAL_MS) <= 0) {
+            continue;
+        }
+        if (fds[0].revents & POLLIN) {
+            int client = ::accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client >= 0) {
+                clients[client];
+                accepted.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        for (std::size_t i = 1; i < fds.size(); ++i) {
+            if ((fds[i].revents & (POLLIN | POLLHUP | POLLERR)) &&
+                !receive(fds[i].fd, clients[fds[i].fd])) {
+                ::close(fds[i].fd);
+                clients.erase(fds[i].fd);
+            }
+        }
+    }
+    for (const auto& client : clients) {
+        ::close(client.first);
+    }
+}
+
+bool RiskAggregatorServer::receive(int client, std::string& buffer) {
+    char data[64 * 1024];
+    ssize_t count = ::recv(client, data, sizeof(data), 0);
+    if (count <= 0) {
+        return count < 0 && (errno == EAGAIN || errno == EINTR);
+    }
+    buffer.append(data, static_cast<std::size_t>(count));
+    try {
+        std::size_t consumed = 0;
+        std::size_t size;
+        while ((size = RiskAggregator::frame_size(
+                    std::string_view(buffer).substr(consumed))) != 0 &&
+               consumed + size <= buffer.size()) {
+            aggregator.apply(std::string_view(buffer).substr(consumed, size));
+            consumed += size;
+        }
+        buffer.erase(0, consumed);
+    } catch (const std::invalid_argument& e) {
+        LOG_WARN("Dropping risk shard connection: {}",
+                 std::string_view(e.what()));
+        return false;
+    }
+    return true;
+}
+
+RiskShardPublisher::RiskShardPublisher(RiskAggregationSettings settings,
+                                       const LivePortfolio& source)
+    : settings(std::move(settings)),
+      source(source),
+      encoder(this->settings.shard, this->settings.account) {}
+
+RiskShardPublisher::~RiskShardPublisher() { stop(); }
+
+void RiskShardPublisher::start() {
+    if (thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = false;
+    }
+    thread = std::thread([this] { run(); });
+}
+
+void RiskShardPublisher::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void RiskShardPublisher::run() {
+    UnderlyingBook totals;
+    std::vector<UnderlyingBook> underlyings;
+    std::string frame;
+    auto next = std::chrono::steady_clock::now();
+    while (true) {
+        if (socket_fd >= 0 || connect()) {
+            source.snapshot(totals, underlyings);
+            encoder.encode(underlyings, now_ns(), frame);
+            if (send(frame)) {
+                sent.fetch_add(1, std::memory_order_relaxed);
+                METRIC_COUNT("thales_risk_frame_bytes_sent_total",
+                             "Bytes of shard risk frames sent",
+                             frame.size());
+            } else {
+                disconnect();
+            }
+        }
+        // A failed connect waits one interval too, which paces retries
+        next += settings.publish_interval;
+        std::unique_lock<std::mutex> lock(mutex);
+        if (wake.wait_until(lock, next, [this] { return stopping; })) {
+            break;
+        }
+    }
+    disconnect();
+}
+
+bool RiskShardPublisher::connect() {
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    std::string port = std::to_string(settings.port);
+    if (::getaddrinfo(settings.host.c_str(), port.c_str(), &hints,
+                      &addresses) != 0) {
+        return false;
+    }
+    for (addrinfo* address = addresses; address; address = address->ai_next) {
+        int fd = ::socket(address->ai_family,
+                          address->ai_socktype | SOCK_CLOEXEC,
+                          address->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        if (::connect(fd, address->ai_addr, address->ai_addrlen) == 0) {
+            // Frames are small and latency matters more than packing
+            int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            socket_fd = fd;
+            break;
+        }
+        ::close(fd);
+    }
+    ::freeaddrinfo(addresses);
+    if (socket_fd < 0) {
+        return false;
+    }
+    connects.fetch_add(1, std::memory_order_relaxed);
+    encoder.reset();
+    return true;
+}
+
+bool RiskShardPublisher::send(const std::string& frame) {
+    std::size_t offset = 0;
+    while (offset < frame.size()) {
+        ssize_t count = ::send(socket_fd, frame.data() + offset,
+                               frame.size() - offset, MSG_NOSIGNAL);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        offset += static_cast<std::size_t>(count);
+    }
+    return true;
+}
+
+void RiskShardPublisher::disconnect() {
+    if (socket_fd >= 0) {
+        ::close(socket_fd);
+        socket_fd = -1;
+    }
+}
+
+}  // namespace thales
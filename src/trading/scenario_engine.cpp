@@ -0,0 +1,435 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "trading/scenario_engine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+#include "simd/dispatch.h"
+#include "trading/option_chain.h"
+#include "trading/vol_surface.h"
+#include "utils/arena.h"
+#include "utils/thread_pool.h"
+
+namespace thales {
+
+namespace {
+
+constexpr double DAYS_PER_YEAR = 365.0;
+
+/** Positions whose inputs stay in cache while the grid is swept. */
+constexpr std::size_t BLOCK_SIZE = 128;
+
+/** Spot moves per kernel call, so the value rows stay in L1. */
+constexpr std::size_t SPOT_BLOCK = 16;
+
+/** Positions per pool task. */
+constexpr std::size_t CHUNK_SIZE = 16 * BLOCK_SIZE;
+
+/**
+ * @brief Storage for the positions selected by a query, reused across
+ * runs on the calling thread.
+ */
+Arena& selection_arena() {
+    thread_local Arena arena;
+    return arena;
+}
+
+/**
+ * Time to expiry of positions expiring before a horizon: small enough
+ * that the kernel returns the payoff at the shocked spot.
+ */
+constexpr double EXPIRED_TIME = 1e-12;
+
+static_assert(BLOCK_SIZE % simd::SCENARIO_PADDING == 0,
+              "Blocks must fill whole kernel vectors");
+
+/**
+ * @brief Kernel inputs of one block of positions at one horizon.
+ *
+ * The horizon columns are filled by load(), the volatility columns by
+ * shift(); padding positions up to a whole vector have a zero weight.
+ */
+struct Block {
+    double S[BLOCK_SIZE];
+    double log_moneyness[BLOCK_SIZE];
+    double discounted_K[BLOCK_SIZE];
+    double T[BLOCK_SIZE];
+    double sqrt_T[BLOCK_SIZE];
+    double rate_T[BLOCK_SIZE];
+    double sigma[BLOCK_SIZE];
+    double weight[BLOCK_SIZE];
+    std::int32_t type[BLOCK_SIZE];
+    SymbolId symbol[BLOCK_SIZE];
+    double drift[BLOCK_SIZE];
+    double sigma_sqrt_T[BLOCK_SIZE];
+    double inverse_sigma_sqrt_T[BLOCK_SIZE];
+    std::size_t count = 0;  /**< Positions in the block */
+    std::size_t padded = 0; /**< count rounded up to whole vectors */
+
+    /**
+     * @brief Fills the horizon columns for positions [begin, begin + n).
+     */
+    void load(const Portfolio& portfolio, const MarketData& market,
+              std::size_t begin, std::size_t n, int horizon) {
+        const SymbolId* symbols = portfolio.get_symbol_ids().data() + begin;
+        const OptionType* types = portfolio.get_types().data() + begin;
+        const double* strikes = portfolio.get_strikes().data() + begin;
+        const std::int32_t* expirations =
+            portfolio.get_expirations().data() + begin;
+        const int* quantities = portfolio.get_quantities().data() + begin;
+        const std::vector<const VolSurface*>& surfaces = market.surfaces;
+
+        count = n;
+        padded = (n + simd::SCENARIO_PADDING - 1) /
+                 simd::SCENARIO_PADDING * simd::SCENARIO_PADDING;
+        for (std::size_t i = 0; i < n; ++i) {
+            // Options expire at the end of their expiration date
+            double days = expirations[i] - market.valuation_date + 1;
+            bool live = days > 0;
+            double today = live ? days / DAYS_PER_YEAR : 1.0;
+            double left = (days - horizon) / DAYS_PER_YEAR;
+            double t = !live ? 1.0 : left > 0 ? left : EXPIRED_TIME;
+            SymbolId id = symbols[i];
+            const VolSurface* surface =
+                id < surfaces.size() ? surfaces[id] : nullptr;
+            S[i] = market.spot[id];
+            T[i] = t;
+            sqrt_T[i] = std::sqrt(t);
+            rate_T[i] = market.rate * t;
+            log_moneyness[i] = std::log(S[i] / strikes[i]);
+            discounted_K[i] = strikes[i] * std::exp(-rate_T[i]);
+            sigma[i] = surface != nullptr
+                           ? surface->volatility(strikes[i], today)
+                           : market.volatility[id];
+            weight[i] = live ? quantities[i] * CONTRACT_MULTIPLIER : 0.0;
+            type[i] = types[i];
+            symbol[i] = id;
+        }
+        for (std::size_t i = n; i < padded; ++i) {
+            S[i] = discounted_K[i] = 100.0;
+            log_moneyness[i] = rate_T[i] = weight[i] = 0.0;
+            T[i] = sqrt_T[i] = 1.0;
+            sigma[i] = 0.2;
+            type[i] = 0;
+            symbol[i] = 0;
+        }
+    }
+
+    /** @brief Fills the volatility columns for one shift. */
+    void shift(double vol_shift) {
+        for (std::size_t i = 0; i < padded; ++i) {
+            double s = std::max(sigma[i] + vol_shift,
+                                ScenarioEngine::MIN_VOLATILITY);
+            drift[i] = rate_T[i] + 0.5 * s * s * T[i];
+            sigma_sqrt_T[i] = s * sqrt_T[i];
+            inverse_sigma_sqrt_T[i] = 1.0 / sigma_sqrt_T[i];
+        }
+    }
+
+    simd::ScenarioInputs inputs() const {
+        return {S, log_moneyness, discounted_K, drift, sigma_sqrt_T,
+                inverse_sigma_sqrt_T, weight, type, padded};
+    }
+};
+
+/**
+ * @brief Values summed per underlying by one worker.
+ */
+struct Partial {
+    std::vector<double> values; /**< [symbol][scenario] */
+    std::vector<double> base;   /**< [symbol] value today */
+};
+
+/**
+ * @brief Everything one sweep needs besides the positions.
+ */
+struct Sweep {
+    const ScenarioGrid& grid;
+    const double* spot_factors;
+    const double* log_spot_factors;
+    const simd::KernelTable& kernels;
+    const simd::NormalGrid* normal;
+    std::size_t underlyings;
+};
+
+/**
+ * @brief Adds the value of positions [first, last) today to partial.base.
+ */
+void value_today(const Sweep& sweep, const Portfolio& portfolio,
+                 const MarketData& market, std::size_t first,
+                 std::size_t last, Block& block, Partial& partial) {
+    const double one = 1.0;
+    const double zero = 0.0;
+    double values[BLOCK_SIZE];
+    for (std::size_t begin = first; begin < last; begin += BLOCK_SIZE) {
+        block.load(portfolio, market, begin,
+                   std::min(BLOCK_SIZE, last - begin), 0);
+        block.shift(0.0);
+        sweep.kernels.scenario(
+            {block.inputs(), &one, &zero, 1, values, sweep.normal});
+        for (std::size_t i = 0; i < block.count; ++i) {
+            partial.base[block.symbol[i]] += values[i];
+        }
+    }
+}
+
+/**
+ * @brief Adds the values of positions [first, last) in every scenario of
+ * one horizon to partial.values.
+ */
+void sweep_horizon(const Sweep& sweep, const Portfolio& portfolio,
+                   const MarketData& market, std::size_t first,
+                   std::size_t last, std::size_t horizon, Block& block,
+                   Partial& partial) {
+    const ScenarioGrid& grid = sweep.grid;
+    std::size_t spots = grid.spot_moves.size();
+    std::size_t scenarios = grid.size();
+    double values[SPOT_BLOCK * BLOCK_SIZE];
+    for (std::size_t begin = first; begin < last; begin += BLOCK_SIZE) {
+        block.load(portfolio, market, begin,
+                   std::min(BLOCK_SIZE, last - begin),
+                   grid.horizons[horizon]);
+        for (std::size_t v = 0; v < grid.vol_shifts.size(); ++v) {
+            block.shift(grid.vol_shifts[v]);
+            std::size_t offset = (horizon * grid.vol_shifts.size() + v) *
+                                 spots;
+            for (std::size_t s0 = 0; s0 < spots; s0 += SPOT_BLOCK) {
+                std::size_t n = std::min(SPOT_BLOCK, spots - s0);
+                sweep.kernels.scenario({block.inputs(),
+                                        sweep.spot_factors + s0,
+                                        sweep.log_spot_factors + s0, n,
+                                        values, sweep.normal});
+                for (std::size_t i = 0; i < block.count; ++i) {
+                    double* out = partial.values.data() +
+                                  block.symbol[i] * scenarios + offset + s0;
+                    for (std::size_t s = 0; s < n; ++s) {
+                        out[s] += values[s * block.padded + i];
+                    }
+                }
+            }
+        }
+    }
+}
+
+void validate(const Portfolio& portfolio, const MarketData& market) {
+    const std::pmr::vector<SymbolId>& symbols = portfolio.get_symbol_ids();
+    const std::pmr::vector<double>& strikes = portfolio.get_strikes();
+    for (std::size_t i = 0; i < portfolio.size(); ++i) {
+        SymbolId id = symbols[i];
+        if (id >= market.spot.size() || id >= market.volatility.size()) {
+            throw std::invalid_argument(
+                "Market data does not cover portfolio");
+        }
+        if (!(market.spot[id] > 0) || !(strikes[i] > 0) ||
+            !(market.volatility[id] >= 0)) {
+            throw std::invalid_argument("Invalid input parameters");
+        }
+    }
+}
+
+Partial make_partial(const Sweep& sweep) {
+    return {std::vector<double>(sweep.underlyings * sweep.grid.size()),
+            std::vector<double>(sweep.underlyings)};
+}
+
+/**
+ * @brief Sums the workers' partials into a result.
+ */
+ScenarioResult reduce(const ScenarioGrid& grid,
+                      const std::vector<Partial>& partials,
+                      std::size_t underlyings) {
+    ScenarioResult result;
+    result.spot_count = grid.spot_moves.size();
+    result.vol_count = grid.vol_shifts.size();
+    result.horizon_count = grid.horizons.size();
+    std::size_t scenarios = grid.size();
+    result.pnl.assign(scenarios, 0.0);
+    result.underlying_pnl.assign(underlyings * scenarios, 0.0);
+
+    std::vector<double> base(underlyings, 0.0);
+    for (const Partial& partial : partials) {
+        if (partial.values.empty()) {
+            continue;
+        }
+        for (std::size_t k = 0; k < result.underlying_pnl.size(); ++k) {
+            result.underlying_pnl[k] += partial.values[k];
+        }
+        for (std::size_t id = 0; id < underlyings; ++id) {
+            base[id] += partial.base[id];
+        }
+    }
+    for (std::size_t id = 0; id < underlyings; ++id) {
+        double* row = result.underlying_pnl.data() + id * scenarios;
+        for (std::size_t k = 0; k < scenarios; ++k) {
+            row[k] -= base[id];
+            result.pnl[k] += row[k];
+        }
+        result.base_value += base[id];
+    }
+    return result;
+}
+
+}  // namespace
+
+std::vector<double> ScenarioGrid::linear(double first, double last,
+                                         std::size_t count) {
+    std::vector<double> points(count, first);
+    for (std::size_t i = 1; i < count; ++i) {
+        points[i] = i + 1 == count
+                        ? last
+                        : first + (last - first) * i / (count - 1);
+    }
+    return points;
+}
+
+double ScenarioResult::worst() const {
+    double loss = 0.0;
+    for (double value : pnl) {
+        loss = std::min(loss, value);
+    }
+    return loss;
+}
+
+double ScenarioResult::worst(SymbolId id) const {
+    double loss = 0.0;
+    const double* row = underlying_pnl.data() + id * size();
+    for (std::size_t k = 0; k < size(); ++k) {
+        loss = std::min(loss, row[k]);
+    }
+    return loss;
+}
+
+ScenarioEngine::ScenarioEngine(ScenarioGrid grid, SimdBackend backend)
+    : axes(std::move(grid)), backend(backend) {
+    if (axes.size() == 0) {
+        throw std::invalid_argument("Scenario grid has an empty axis");
+    }
+    for (double move : axes.spot_moves) {
+        if (!(move > -1.0)) {
+            throw std::invalid_argument("Spot move must be above -100%");
+        }
+        spot_factors.push_back(1.0 + move);
+        log_spot_factors.push_back(std::log1p(move));
+    }
+    for (int horizon : axes.horizons) {
+        if (horizon < 0) {
+            throw std::invalid_argument("Horizon must not be negative");
+        }
+    }
+    simd::kernels_for(backend);
+}
+
+template <class Math>
+ScenarioResult ScenarioEngine::run(const Portfolio& portfolio,
+                                   const MarketData& market) const {
+    validate(portfolio, market);
+    Sweep sweep = {axes,
+                   spot_factors.data(),
+                   log_spot_factors.data(),
+                   simd::kernels_for(backend),
+                   simd::normal_grid<Math>(),
+                   market.spot.size()};
+    std::vector<Partial> partials(1, make_partial(sweep));
+    Block block;
+    value_today(sweep, portfolio, market, 0, portfolio.size(), block,
+                partials[0]);
+    for (std::size_t h = 0; h < axes.horizons.size(); ++h) {
+        sweep_horizon(sweep, portfolio, market, 0, portfolio.size(), h, block,
+                      partials[0]);
+    }
+    return reduce(axes, partials, sweep.underlyings);
+}
+
+template <class Math>
+ScenarioResult ScenarioEngine::run(const Portfolio& portfolio,
+                                   const MarketData& market,
+                                   ThreadPool& pool) const {
+    validate(portfolio, market);
+    Sweep sweep = {axes,
+                   spot_factors.data(),
+                   log_spot_factors.data(),
+                   simd::kernels_for(backend),
+                   simd::normal_grid<Math>(),
+                   market.spot.size()};
+    std::size_t chunks = (portfolio.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    std::size_t horizons = axes.horizons.size();
+    // One accumulator per worker, sized on first use and reduced at the end
+    std::vector<Partial> partials(pool.size());
+    pool.parallel_for(
+        chunks * horizons, [&](std::size_t task, std::size_t worker) {
+            std::size_t first = task / horizons * CHUNK_SIZE;
+            std::size_t last = std::min(portfolio.size(), first + CHUNK_SIZE);
+            std::size_t h = task % horizons;
+            Partial& partial = partials[worker];
+            if (partial.values.empty()) {
+                partial = make_partial(sweep);
+            }
+            Block block;
+            if (h == 0) {
+                value_today(sweep, portfolio, market, first, last, block,
+                            partial);
+            }
+            sweep_horizon(sweep, portfolio, market, first, last, h, block,
+                          partial);
+        });
+    return reduce(axes, partials, sweep.underlyings);
+}
+
+template <class Math>
+ScenarioResult ScenarioEngine::run(const Portfolio& portfolio,
+                                   const OptionChainIndex& index,
+                                   const ChainQuery& query,
+                                   const MarketData& market) const {
+    // The selected positions are copied out so the sweep streams through
+    // contiguous columns as usual
+    Arena::Scope scope(selection_arena());
+    Portfolio selected(0.0, &selection_arena());
+    selected.reserve(index.for_each(query, [](std::size_t) {}));
+    index.for_each(query, [&](std::size_t entry) {
+        selected.add_position(portfolio.get_position(index.source(entry)));
+    });
+    return run<Math>(selected, market);
+}
+
+#define INSTANTIATE_SCENARIO_ENGINE(Math)                                    \
+    template ScenarioResult ScenarioEngine::run<Math>(                       \
+        const Portfolio&, const MarketData&) const;                          \
+    template ScenarioResult ScenarioEngine::run<Math>(                       \
+        const Portfolio&, const MarketData&, ThreadPool&) const;             \
+    template ScenarioResult ScenarioEngine::run<Math>(                       \
+        const Portfolio&, const OptionChainIndex&, const ChainQuery&,        \
+        const MarketData&) const;
+
+INSTANTIATE_SCENARIO_ENGINE(ExactMath)
+INSTANTIATE_SCENARIO_ENGINE(RiskMath)
+INSTANTIATE_SCENARIO_ENGINE(ScreeningMath)
+
+#undef INSTANTIATE_SCENARIO_ENGINE
+
+}  // namespace thales
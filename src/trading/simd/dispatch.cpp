@@ -0,0 +1,84 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "dispatch.h"
+
+#include <cstdint>
+#include <stdexcept>
+
+namespace thales {
+namespace simd {
+
+static_assert(sizeof(OptionType) == sizeof(std::int32_t),
+              "SIMD kernels load option types as 32-bit integers");
+
+const KernelTable* find_kernels(SimdBackend backend) {
+    switch (backend) {
+        case SimdBackend::SCALAR:
+            return &scalar_kernels();
+#if defined(THALES_HAVE_NEON)
+        case SimdBackend::NEON:
+            return &neon_kernels();
+#endif
+#if defined(THALES_HAVE_AVX2)
+        case SimdBackend::AVX2:
+            return __builtin_cpu_supports("avx2") &&
+                           __builtin_cpu_supports("fma")
+                       ? &avx2_kernels()
+                       : nullptr;
+#endif
+#if defined(THALES_HAVE_AVX512)
+        case SimdBackend::AVX512:
+            return __builtin_cpu_supports("avx512f")
+                       ? &avx512_kernels()
+                       : nullptr;
+#endif
+        default:
+            return nullptr;
+    }
+}
+
+const KernelTable& kernels_for(SimdBackend backend) {
+    if (backend == SimdBackend::AUTO) {
+        backend = BlackScholes::best_simd_backend();
+    }
+    const KernelTable* kernels = find_kernels(backend);
+    if (kernels == nullptr) {
+        throw std::invalid_argument("SIMD backend not supported");
+    }
+    return *kernels;
+}
+
+BatchInputs kernel_inputs(const OptionBatch& batch) {
+    return {batch.S,
+            batch.K,
+            batch.T,
+            batch.r,
+            batch.sigma,
+            reinterpret_cast<const std::int32_t*>(batch.type),
+            batch.size};
+}
+
+}  // namespace simd
+}  // namespace thales
@@ -0,0 +1,78 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "kernels.h"
+#include "trading/black_scholes.h"
+
+namespace thales {
+namespace simd {
+
+/**
+ * @brief Look up the kernels compiled for a backend
+ *
+ * @param backend Instruction set (AUTO is not resolved here)
+ * @return The kernel table, or nullptr if the backend was not compiled in or
+ * the CPU does not support it
+ */
+const KernelTable* find_kernels(SimdBackend backend);
+
+/**
+ * @brief Resolve AUTO and fetch the kernels for a backend
+ *
+ * @param backend Instruction set to use
+ * @return The kernel table
+ * @throws std::invalid_argument If the backend cannot run on this CPU
+ */
+const KernelTable& kernels_for(SimdBackend backend);
+
+/**
+ * @brief Convert a public batch view to kernel inputs
+ *
+ * @param batch Options to convert
+ * @return The same arrays, with option types viewed as 32-bit integers
+ */
+BatchInputs kernel_inputs(const OptionBatch& batch);
+
+/**
+ * @brief Kernel view of a math policy's normal table
+ *
+ * @return The table, or nullptr for ExactMath
+ */
+template <class Math>
+const NormalGrid* normal_grid() {
+    using Table = typename Math::Table;
+    static const NormalGrid grid = {Math::TABLE.nodes, Table::INTERVALS,
+                                    -Table::node(0), Table::STEP};
+    return &grid;
+}
+
+template <>
+inline const NormalGrid* normal_grid<ExactMath>() {
+    return nullptr;
+}
+
+}  // namespace simd
+}  // namespace thales
@@ -0,0 +1,183 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace thales {
+namespace simd {
+
+/**
+ * @brief Structure-of-arrays inputs shared by every batch kernel
+ *
+ * Option types are passed as 32-bit integers (0 = CALL, 1 = PUT) so that the
+ * instruction-set specific translation units do not depend on the public
+ * headers.
+ */
+struct BatchInputs {
+    const double* S;          /**< Current stock prices */
+    const double* K;          /**< Strike prices */
+    const double* T;          /**< Times to maturity (in years) */
+    const double* r;          /**< Risk-free interest rates */
+    const double* sigma;      /**< Volatilities */
+    const std::int32_t* type; /**< Option types */
+    std::size_t size;         /**< Number of options */
+};
+
+/**
+ * @brief Standard normal distribution tabulated on a uniform grid
+ *
+ * A view of a NormalTable from the public headers: @c nodes holds N(x_i)
+ * and n(x_i) interleaved at x_i = -range + i * step, i = 0 .. intervals.
+ */
+struct NormalGrid {
+    const double* nodes;   /**< CDF and density pairs */
+    std::size_t intervals; /**< Number of intervals between nodes */
+    double range;          /**< Half-width of the grid */
+    double step;           /**< Distance between nodes */
+};
+
+/**
+ * @brief Arguments of the batch pricing kernel
+ */
+struct PriceArgs {
+    BatchInputs in;           /**< Options to price */
+    double* prices;           /**< Output prices */
+    const NormalGrid* normal; /**< Tabulated normal, or null for exact */
+};
+
+/**
+ * @brief Arguments of the batch Greeks kernel
+ *
+ * Null output pointers are skipped.
+ */
+struct GreeksArgs {
+    BatchInputs in;           /**< Options to evaluate */
+    double* price;            /**< Output prices */
+    double* delta;            /**< Output deltas */
+    double* gamma;            /**< Output gammas */
+    double* vega;             /**< Output vegas */
+    double* theta;            /**< Output thetas */
+    double* rho;              /**< Output rhos */
+    double* vanna;            /**< Output vannas */
+    double* volga;            /**< Output volgas */
+    const NormalGrid* normal; /**< Tabulated normal, or null for exact */
+};
+
+/**
+ * @brief Arguments of the batch implied volatility kernel
+ */
+struct ImpliedVolArgs {
+    BatchInputs in;     /**< Options to solve; in.sigma holds market prices */
+    double* vols;       /**< Output implied volatilities (NaN if unsolved) */
+    double tolerance;   /**< Convergence threshold on the volatility step */
+    int max_iterations; /**< Iteration cap */
+};
+
+/**
+ * @brief Per-position invariants of a scenario sweep
+ *
+ * Everything that does not depend on the spot move is computed once per
+ * position, horizon and volatility shift, so each scenario costs an add, a
+ * few multiplies and two normal CDFs. The size must be a multiple of
+ * SCENARIO_PADDING; padding positions should have a zero weight.
+ */
+struct ScenarioInputs {
+    const double* S;             /**< Base stock prices */
+    const double* log_moneyness; /**< log(S / K) */
+    const double* discounted_K;  /**< K * exp(-r * T) */
+    const double* drift;         /**< (r + sigma^2 / 2) * T */
+    const double* sigma_sqrt_T;  /**< sigma * sqrt(T) */
+    const double* inverse_sigma_sqrt_T; /**< 1 / (sigma * sqrt(T)) */
+    const double* weight;        /**< Scale applied to each value */
+    const std::int32_t* type;    /**< Option types */
+    std::size_t size;            /**< Number of positions */
+};
+
+/** @brief Multiple of the widest vector that ScenarioInputs are padded to */
+constexpr std::size_t SCENARIO_PADDING = 8;
+
+/**
+ * @brief Arguments of the scenario sweep kernel
+ */
+struct ScenarioArgs {
+    ScenarioInputs in;             /**< Positions to revalue */
+    const double* spot_factors;    /**< 1 + relative spot move */
+    const double* log_spot_factors; /**< log(1 + relative spot move) */
+    std::size_t spot_count;        /**< Number of spot moves */
+    double* values; /**< Output weighted values, one row of in.size per move */
+    const NormalGrid* normal; /**< Tabulated normal, or null for exact */
+};
+
+/**
+ * @brief Arguments of the element-wise array kernels
+ */
+struct ArrayArgs {
+    const double* in; /**< Input values */
+    double* out;      /**< Output values, which may alias the input */
+    std::size_t size; /**< Number of elements */
+};
+
+/**
+ * @brief Entry points compiled for one instruction set
+ */
+struct KernelTable {
+    void (*price)(const PriceArgs& args);   /**< Batch option pricing */
+    void (*greeks)(const GreeksArgs& args); /**< Batch price and Greeks */
+    void (*implied_vol)(const ImpliedVolArgs& args); /**< Batch IV solver */
+    void (*exp)(const ArrayArgs& args);              /**< Element-wise exp */
+    void (*inverse_norm_cdf)(const ArrayArgs& args); /**< Normal quantiles */
+    void (*scenario)(const ScenarioArgs& args);      /**< Spot move sweep */
+};
+
+/**
+ * @brief Kernels for the portable scalar fallback (always available)
+ */
+const KernelTable& scalar_kernels();
+
+#if defined(THALES_HAVE_AVX2)
+/**
+ * @brief Kernels compiled with AVX2 and FMA enabled
+ */
+const KernelTable& avx2_kernels();
+#endif
+
+#if defined(THALES_HAVE_AVX512)
+/**
+ * @brief Kernels compiled with AVX-512F enabled
+ */
+const KernelTable& avx512_kernels();
+#endif
+
+#if defined(THALES_HAVE_NEON)
+/**
+ * @brief Kernels compiled for ARM NEON
+ */
+const KernelTable& neon_kernels();
+#endif
+
+}  // namespace simd
+}  // namespace thales
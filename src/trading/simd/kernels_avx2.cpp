@@ -0,0 +1,134 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Compiled with -mavx2 -mfma; only reached after a runtime CPU check.
+
+#include <immintrin.h>
+
+#include "kernels_impl.h"
+
+namespace thales {
+namespace simd {
+
+namespace {
+
+/**
+ * @brief Traits for 4-wide AVX2 double vectors
+ */
+struct Avx2 {
+    using V = __m256d;
+    using M = __m256d;
+    static constexpr std::size_t width = 4;
+
+    static V set1(double x) { return _mm256_set1_pd(x); }
+    static V load(const double* p) { return _mm256_loadu_pd(p); }
+    static void store(double* p, V x) { _mm256_storeu_pd(p, x); }
+    static V load_int32(const std::int32_t* p) {
+        return _mm256_cvtepi32_pd(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+    }
+
+    static V add(V a, V b) { return _mm256_add_pd(a, b); }
+    static V sub(V a, V b) { return _mm256_sub_pd(a, b); }
+    static V mul(V a, V b) { return _mm256_mul_pd(a, b); }
+    static V div(V a, V b) { return _mm256_div_pd(a, b); }
+    static V fmadd(V a, V b, V c) { return _mm256_fmadd_pd(a, b, c); }
+    static V fnmadd(V a, V b, V c) { return _mm256_fnmadd_pd(a, b, c); }
+
+    static V sqrt(V x) { return _mm256_sqrt_pd(x); }
+    static V min(V a, V b) { return _mm256_min_pd(a, b); }
+    static V max(V a, V b) { return _mm256_max_pd(a, b); }
+    static V abs(V x) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), x); }
+    static V round(V x) {
+        return _mm256_round_pd(x,
+                               _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    }
+
+    static M lt(V a, V b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    static M gt(V a, V b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+    static V select(M m, V a, V b) { return _mm256_blendv_pd(b, a, m); }
+    static M mask_and(M a, M b) { return _mm256_and_pd(a, b); }
+    static M mask_or(M a, M b) { return _mm256_or_pd(a, b); }
+    static M mask_not(M m) {
+        return _mm256_xor_pd(m, _mm256_castsi256_pd(_mm256_set1_epi64x(-1)));
+    }
+    static bool all(M m) { return _mm256_movemask_pd(m) == 0xF; }
+
+    static V ldexp(V x, V n) {
+        __m256i bits = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(n));
+        bits = _mm256_slli_epi64(
+            _mm256_add_epi64(bits, _mm256_set1_epi64x(1023)), 52);
+        return _mm256_mul_pd(x, _mm256_castsi256_pd(bits));
+    }
+    static V frexp(V x, V& e) {
+        // The biased exponent is OR-ed into the mantissa of 2^52, which turns
+        // it into an exact double without a 64-bit integer conversion.
+        const __m256i bits = _mm256_castpd_si256(x);
+        const __m256i biased = _mm256_and_si256(_mm256_srli_epi64(bits, 52),
+                                                _mm256_set1_epi64x(0x7ff));
+        const __m256d two52 = _mm256_set1_pd(4503599627370496.0);
+        e = _mm256_sub_pd(
+            _mm256_castsi256_pd(_mm256_or_si256(
+                biased, _mm256_castpd_si256(two52))),
+            _mm256_set1_pd(4503599627370496.0 + 1022.0));
+        const __m256i mantissa = _mm256_or_si256(
+            _mm256_and_si256(bits, _mm256_set1_epi64x(
+                                       static_cast<long long>(
+                                           0x800FFFFFFFFFFFFFULL))),
+            _mm256_set1_epi64x(0x3FE0000000000000LL));
+        return _mm256_castsi256_pd(mantissa);
+    }
+    static V gather(const double* p, V i) {
+        return _mm256_i32gather_pd(p, _mm256_cvtpd_epi32(i), 8);
+    }
+};
+
+void price_avx2(const PriceArgs& args) { price_batch<Avx2>(args); }
+
+void greeks_avx2(const GreeksArgs& args) { greeks_batch<Avx2>(args); }
+
+void implied_vol_avx2(const ImpliedVolArgs& args) {
+    implied_vol_batch<Avx2>(args);
+}
+
+void exp_avx2(const ArrayArgs& args) { exp_array<Avx2>(args); }
+
+void inverse_norm_cdf_avx2(const ArrayArgs& args) {
+    inverse_norm_cdf_array<Avx2>(args);
+}
+
+void scenario_avx2(const ScenarioArgs& args) { scenario_batch<Avx2>(args); }
+
+}  // namespace
+
+const KernelTable& avx2_kernels() {
+    static const KernelTable table = {price_avx2, greeks_avx2,
+                                       implied_vol_avx2, exp_avx2,
+                                       inverse_norm_cdf_avx2,
+                                       scenario_avx2};
+    return table;
+}
+
+}  // namespace simd
+}  // namespace thales
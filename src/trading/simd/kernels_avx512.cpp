@@ -0,0 +1,113 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Compiled with -mavx512f; only reached after a runtime CPU check.
+
+#include <immintrin.h>
+
+#include "kernels_impl.h"
+
+namespace thales {
+namespace simd {
+
+namespace {
+
+/**
+ * @brief Traits for 8-wide AVX-512 double vectors
+ */
+struct Avx512 {
+    using V = __m512d;
+    using M = __mmask8;
+    static constexpr std::size_t width = 8;
+
+    static V set1(double x) { return _mm512_set1_pd(x); }
+    static V load(const double* p) { return _mm512_loadu_pd(p); }
+    static void store(double* p, V x) { _mm512_storeu_pd(p, x); }
+    static V load_int32(const std::int32_t* p) {
+        return _mm512_cvtepi32_pd(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+    }
+
+    static V add(V a, V b) { return _mm512_add_pd(a, b); }
+    static V sub(V a, V b) { return _mm512_sub_pd(a, b); }
+    static V mul(V a, V b) { return _mm512_mul_pd(a, b); }
+    static V div(V a, V b) { return _mm512_div_pd(a, b); }
+    static V fmadd(V a, V b, V c) { return _mm512_fmadd_pd(a, b, c); }
+    static V fnmadd(V a, V b, V c) { return _mm512_fnmadd_pd(a, b, c); }
+
+    static V sqrt(V x) { return _mm512_sqrt_pd(x); }
+    static V min(V a, V b) { return _mm512_min_pd(a, b); }
+    static V max(V a, V b) { return _mm512_max_pd(a, b); }
+    static V abs(V x) { return _mm512_abs_pd(x); }
+    static V round(V x) {
+        return _mm512_roundscale_pd(
+            x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    }
+
+    static M lt(V a, V b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+    static M gt(V a, V b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+    static V select(M m, V a, V b) { return _mm512_mask_blend_pd(m, b, a); }
+    static M mask_and(M a, M b) { return a & b; }
+    static M mask_or(M a, M b) { return a | b; }
+    static M mask_not(M m) { return static_cast<M>(~m); }
+    static bool all(M m) { return m == 0xFF; }
+
+    static V ldexp(V x, V n) { return _mm512_scalef_pd(x, n); }
+    static V frexp(V x, V& e) {
+        e = _mm512_add_pd(_mm512_getexp_pd(x), _mm512_set1_pd(1.0));
+        return _mm512_getmant_pd(x, _MM_MANT_NORM_p5_1, _MM_MANT_SIGN_src);
+    }
+    static V gather(const double* p, V i) {
+        return _mm512_i32gather_pd(_mm512_cvtpd_epi32(i), p, 8);
+    }
+};
+
+void price_avx512(const PriceArgs& args) { price_batch<Avx512>(args); }
+
+void greeks_avx512(const GreeksArgs& args) { greeks_batch<Avx512>(args); }
+
+void implied_vol_avx512(const ImpliedVolArgs& args) {
+    implied_vol_batch<Avx512>(args);
+}
+
+void exp_avx512(const ArrayArgs& args) { exp_array<Avx512>(args); }
+
+void inverse_norm_cdf_avx512(const ArrayArgs& args) {
+    inverse_norm_cdf_array<Avx512>(args);
+}
+
+void scenario_avx512(const ScenarioArgs& args) { scenario_batch<Avx512>(args); }
+
+}  // namespace
+
+const KernelTable& avx512_kernels() {
+    static const KernelTable table = {price_avx512, greeks_avx512,
+                                       implied_vol_avx512, exp_avx512,
+                                       inverse_norm_cdf_avx512,
+                                       scenario_avx512};
+    return table;
+}
+
+}  // namespace simd
+}  // namespace thales
@@ -0,0 +1,732 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+/*
+ * Instruction-set independent implementation of the batch kernels.
+ *
+ * Every function is a template over a traits type @c A that wraps one SIMD
+ * instruction set (see kernels_avx2.cpp and friends). The traits provide:
+ *
+ *   V, M, width          vector type, comparison mask type, lanes per vector
+ *   set1, load, store    broadcast and unaligned memory access
+ *   load_int32           load @c width 32-bit integers converted to doubles
+ *   add, sub, mul, div   lane-wise arithmetic
+ *   fmadd(a, b, c)       a * b + c
+ *   fnmadd(a, b, c)      c - a * b
+ *   sqrt, min, max, abs  lane-wise functions
+ *   round                round to nearest integer
+ *   lt, gt, select       comparisons and blend (select(m, a, b) = m ? a : b)
+ *   mask_and, mask_or,   mask logic
+ *   mask_not, all        (all(m) is true if every lane of m is set)
+ *   ldexp(x, n)          x * 2^n for integer-valued n in the normal range
+ *   frexp(x, e)          mantissa in [0.5, 1) with the exponent stored in e
+ *   gather(p, i)         p[i] for integer-valued, non-negative lanes i
+ *
+ * Each translation unit declares its traits type in an anonymous namespace,
+ * so the instantiations below never leak across instruction sets.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "kernels.h"
+
+namespace thales {
+namespace simd {
+
+/**
+ * @brief Evaluate a polynomial with coefficients ordered from highest degree
+ */
+template <class A, std::size_t N>
+inline typename A::V polevl(typename A::V x, const double (&c)[N]) {
+    typename A::V p = A::set1(c[0]);
+    for (std::size_t i = 1; i < N; ++i) {
+        p = A::fmadd(p, x, A::set1(c[i]));
+    }
+    return p;
+}
+
+/**
+ * @brief Natural exponential (Cephes exp, about 1 ulp on [-708, 709])
+ *
+ * Arguments outside [-708, 709] are clamped instead of producing 0 or inf.
+ */
+template <class A>
+inline typename A::V vec_exp(typename A::V x) {
+    static constexpr double P[] = {1.26177193074810590878e-4,
+                                   3.02994407707441961300e-2,
+                                   9.99999999999999999910e-1};
+    static constexpr double Q[] = {
+        3.00198505138664455042e-6, 2.52448340349684104192e-3,
+        2.27265548208155028766e-1, 2.00000000000000000009e0};
+
+    x = A::min(A::max(x, A::set1(-708.0)), A::set1(709.0));
+    typename A::V n = A::round(A::mul(x, A::set1(1.4426950408889634074)));
+    x = A::fnmadd(n, A::set1(6.93145751953125e-1), x);
+    x = A::fnmadd(n, A::set1(1.42860682030941723212e-6), x);
+
+    typename A::V xx = A::mul(x, x);
+    typename A::V px = A::mul(x, polevl<A>(xx, P));
+    x = A::div(px, A::sub(polevl<A>(xx, Q), px));
+    x = A::fmadd(A::set1(2.0), x, A::set1(1.0));
+    return A::ldexp(x, n);
+}
+
+/**
+ * @brief Natural logarithm (Cephes log) for positive, normal arguments
+ */
+template <class A>
+inline typename A::V vec_log(typename A::V x) {
+    static constexpr double P[] = {
+        1.01875663804580931796e-4, 4.97494994976747001425e-1,
+        4.70579119878881725854e0,  1.44989225341610930846e1,
+        1.79368678507819816313e1,  7.70838733755885391666e0};
+    static constexpr double Q[] = {
+        1.0,
+        1.12873587189167450590e1,
+        4.52279145837532221105e1,
+        8.29875266912776603211e1,
+        7.11544750618563894466e1,
+        2.31251620126765340583e1};
+
+    typename A::V e;
+    typename A::V m = A::frexp(x, e);
+    typename A::M small = A::lt(m, A::set1(0.70710678118654752440));
+    e = A::select(small, A::sub(e, A::set1(1.0)), e);
+    m = A::select(small, A::sub(A::add(m, m), A::set1(1.0)),
+                  A::sub(m, A::set1(1.0)));
+
+    typename A::V z = A::mul(m, m);
+    typename A::V y =
+        A::mul(m, A::div(A::mul(z, polevl<A>(m, P)), polevl<A>(m, Q)));
+    y = A::fnmadd(e, A::set1(2.121944400546905827679e-4), y);
+    y = A::fnmadd(A::set1(0.5), z, y);
+    z = A::add(m, y);
+    return A::fmadd(e, A::set1(0.693359375), z);
+}
+
+/**
+ * @brief Standard normal cumulative distribution function
+ *
+ * Uses Hart's double-precision rational approximation for |x| < 7.07 and a
+ * continued fraction beyond (West, 2005). Absolute error is below 1e-14 and
+ * +/-inf map to 1 and 0. The continued fraction is expanded into a ratio of
+ * polynomials so that both branches are selected before a single division
+ * and the kernel stays branch-free.
+ *
+ * @param g exp(-x^2 / 2), shared with the density by callers that need both
+ */
+template <class A>
+inline typename A::V vec_norm_cdf(typename A::V x, typename A::V g) {
+    static constexpr double N[] = {
+        3.52624965998911e-02, 0.700383064443688, 6.37396220353165,
+        33.912866078383,      112.079291497871,  221.213596169931,
+        220.206867912376};
+    static constexpr double D[] = {
+        8.83883476483184e-02, 1.75566716318264, 16.064177579207,
+        86.7807322029461,     296.564248779674, 637.333633378831,
+        793.826512519948,     440.413735824752};
+
+    typename A::V ax = A::abs(x);
+
+    // ax + 1 / (ax + 2 / (ax + 3 / (ax + 4 / (ax + 0.65)))) = cf_num / cf_den
+    typename A::V n4 = A::add(ax, A::set1(0.65));
+    typename A::V n3 = A::fmadd(ax, n4, A::set1(4.0));
+    typename A::V n2 = A::fmadd(ax, n3, A::mul(A::set1(3.0), n4));
+    typename A::V n1 = A::fmadd(ax, n2, A::mul(A::set1(2.0), n3));
+    typename A::V cf_num = A::fmadd(ax, n1, n2);
+    typename A::V cf_den = n1;
+
+    typename A::M central = A::lt(ax, A::set1(7.07106781186547));
+    typename A::V num = A::select(central, polevl<A>(ax, N), cf_den);
+    typename A::V den =
+        A::select(central, polevl<A>(ax, D),
+                  A::mul(cf_num, A::set1(2.506628274631000502415765)));
+    typename A::V tail = A::div(A::mul(g, num), den);
+
+    tail = A::select(A::gt(ax, A::set1(37.0)), A::set1(0.0), tail);
+    return A::select(A::gt(x, A::set1(0.0)), A::sub(A::set1(1.0), tail),
+                     tail);
+}
+
+/**
+ * @brief exp(-x^2 / 2), the unnormalised standard normal density
+ */
+template <class A>
+inline typename A::V vec_gaussian(typename A::V x) {
+    return vec_exp<A>(A::mul(A::mul(x, x), A::set1(-0.5)));
+}
+
+/**
+ * @brief Standard normal cumulative distribution function
+ */
+template <class A>
+inline typename A::V vec_norm_cdf(typename A::V x) {
+    return vec_norm_cdf<A>(x, vec_gaussian<A>(x));
+}
+
+/**
+ * @brief Inverse of the standard normal distribution for p in (0, 1)
+ *
+ * Acklam's rational approximation (relative error 1.15e-9) refined by one
+ * Halley step. Both are applied to the lower tail min(p, 1 - p), where
+ * vec_norm_cdf() is accurate to full relative precision, and the sign is
+ * restored afterwards.
+ */
+template <class A>
+inline typename A::V vec_inverse_norm_cdf(typename A::V p) {
+    static constexpr double CENTRAL_N[] = {
+        -3.969683028665376e+01, 2.209460984245205e+02,
+        -2.759285104469687e+02, 1.383577518672690e+02,
+        -3.066479806614716e+01, 2.506628277459239e+00};
+    static constexpr double CENTRAL_D[] = {
+        -5.447609879822406e+01, 1.615858368580409e+02,
+        -1.556989798598866e+02, 6.680131188771972e+01,
+        -1.328068155288572e+01, 1.0};
+    static constexpr double TAIL_N[] = {
+        -7.784894002430293e-03, -3.223964580411365e-01,
+        -2.400758277161838e+00, -2.549732539343734e+00,
+        4.374664141464968e+00,  2.938163982698783e+00};
+    static constexpr double TAIL_D[] = {
+        7.784695709041462e-03, 3.224671290700398e-01,
+        2.445134137142996e+00, 3.754408661907416e+00, 1.0};
+
+    typename A::M upper = A::gt(p, A::set1(0.5));
+    typename A::V t = A::min(p, A::sub(A::set1(1.0), p));
+
+    typename A::V q = A::sub(t, A::set1(0.5));
+    typename A::V r = A::mul(q, q);
+    typename A::V central = A::div(A::mul(q, polevl<A>(r, CENTRAL_N)),
+                                   polevl<A>(r, CENTRAL_D));
+    typename A::V s = A::sqrt(A::mul(A::set1(-2.0), vec_log<A>(t)));
+    typename A::V tail =
+        A::div(polevl<A>(s, TAIL_N), polevl<A>(s, TAIL_D));
+    typename A::V x = A::select(A::lt(t, A::set1(0.02425)), tail, central);
+
+    // Halley step on N(x) - t, with N'(x) = g / sqrt(2 pi)
+    typename A::V g = vec_gaussian<A>(x);
+    typename A::V e = A::sub(vec_norm_cdf<A>(x, g), t);
+    typename A::V u =
+        A::div(A::mul(e, A::set1(2.506628274631000502415765)), g);
+    x = A::sub(x, A::div(u, A::fmadd(A::mul(A::set1(0.5), x), u,
+                                     A::set1(1.0))));
+    return A::select(upper, A::sub(A::set1(0.0), x), x);
+}
+
+/**
+ * @brief Apply an element-wise vector function to an array
+ *
+ * The remainder that does not fill a whole vector is padded with @p pad.
+ */
+template <class A, class Function>
+inline void for_each_element(const ArrayArgs& args, double pad,
+                             Function function) {
+    constexpr std::size_t W = A::width;
+    std::size_t i = 0;
+    for (; i + W <= args.size; i += W) {
+        A::store(args.out + i, function(A::load(args.in + i)));
+    }
+    std::size_t rest = args.size - i;
+    if (rest == 0) {
+        return;
+    }
+    double buffer[W];
+    for (std::size_t j = 0; j < W; ++j) {
+        buffer[j] = pad;
+    }
+    std::memcpy(buffer, args.in + i, rest * sizeof(double));
+    A::store(buffer, function(A::load(buffer)));
+    std::memcpy(args.out + i, buffer, rest * sizeof(double));
+}
+
+/**
+ * @brief Element-wise exp of an array
+ */
+template <class A>
+void exp_array(const ArrayArgs& args) {
+    for_each_element<A>(args, 0.0,
+                        [](typename A::V x) { return vec_exp<A>(x); });
+}
+
+/**
+ * @brief Element-wise standard normal quantiles of probabilities in (0, 1)
+ */
+template <class A>
+void inverse_norm_cdf_array(const ArrayArgs& args) {
+    for_each_element<A>(args, 0.5, [](typename A::V p) {
+        return vec_inverse_norm_cdf<A>(p);
+    });
+}
+
+/**
+ * @brief Normal distribution of the exact pricing kernels
+ */
+template <class A>
+struct ExactNormal {
+    using V = typename A::V;
+
+    /** @brief N(x) */
+    V cdf(V x) const { return vec_norm_cdf<A>(x); }
+
+    /** @brief N(x), with n(x) stored in @p pdf */
+    V cdf(V x, V& pdf) const {
+        V g = vec_gaussian<A>(x);
+        pdf = A::mul(g, A::set1(0.398942280401432677939946));
+        return vec_norm_cdf<A>(x, g);
+    }
+};
+
+/**
+ * @brief Normal distribution interpolated from a NormalGrid
+ *
+ * Replaces the exp() and division of each CDF with four gathers and a
+ * cubic Hermite interpolation that matches NormalTable::cdf() and
+ * NormalTable::pdf().
+ */
+template <class A>
+struct TabulatedNormal {
+    using V = typename A::V;
+    using M = typename A::M;
+
+    const double* nodes;
+    V lo, hi, step, inverse_step, last;
+
+    explicit TabulatedNormal(const NormalGrid& grid)
+        : nodes(grid.nodes),
+          lo(A::set1(-grid.range)),
+          hi(A::set1(grid.range)),
+          step(A::set1(grid.step)),
+          inverse_step(A::set1(1.0 / grid.step)),
+          last(A::set1(static_cast<double>(grid.intervals - 1))) {}
+
+    /** @brief N(x) */
+    V cdf(V x) const { return evaluate<false>(x, nullptr); }
+
+    /** @brief N(x), with n(x) stored in @p pdf */
+    V cdf(V x, V& pdf) const { return evaluate<true>(x, &pdf); }
+
+   private:
+    template <bool DENSITY>
+    V evaluate(V x, V* pdf) const {
+        const V one = A::set1(1.0);
+        // Only NaN fails both; its lanes read node 0 and are restored below
+        M ordered = A::mask_or(A::lt(x, one), A::gt(x, A::set1(0.0)));
+        V clamped = A::select(ordered, A::min(A::max(x, lo), hi), lo);
+        V u = A::mul(A::sub(clamped, lo), inverse_step);
+        // round(u - 1/2) is floor(u) except at nodes, where t = 1 is exact
+        V i = A::min(A::round(A::sub(u, A::set1(0.5))), last);
+        V t = A::sub(u, i);
+        V s = A::sub(one, t);
+        V j = A::add(i, i);
+        V c0 = A::gather(nodes, j);
+        V p0 = A::gather(nodes + 1, j);
+        V c1 = A::gather(nodes + 2, j);
+        V p1 = A::gather(nodes + 3, j);
+
+        V rise = A::mul(A::mul(t, t), A::fnmadd(A::set1(2.0), t,
+                                                A::set1(3.0)));
+        V hts = A::mul(step, A::mul(t, s));
+        if (DENSITY) {
+            V x0 = A::fmadd(i, step, lo);
+            V x1 = A::add(x0, step);
+            V slopes = A::fnmadd(A::mul(s, x0), p0, A::mul(A::mul(t, x1), p1));
+            V density =
+                A::fmadd(hts, slopes, A::fmadd(rise, A::sub(p1, p0), p0));
+            *pdf = A::select(ordered, density, x);
+        }
+        V cdf = A::fmadd(hts, A::fnmadd(t, p1, A::mul(s, p0)),
+                         A::fmadd(rise, A::sub(c1, c0), c0));
+        return A::select(ordered, cdf, x);
+    }
+};
+
+/**
+ * @brief One vector of options loaded from a BatchInputs view
+ */
+template <class A>
+struct Lanes {
+    typename A::V S;     /**< Current stock prices */
+    typename A::V K;     /**< Strike prices */
+    typename A::V T;     /**< Times to maturity */
+    typename A::V r;     /**< Risk-free interest rates */
+    typename A::V sigma; /**< Volatilities */
+    typename A::V w;     /**< +1 for calls, -1 for puts */
+};
+
+/**
+ * @brief Intermediates shared by the price and every Greek
+ */
+template <class A>
+struct Terms {
+    typename A::V sqrt_T;       /**< sqrt(T) */
+    typename A::V d1;           /**< d1 */
+    typename A::V d2;           /**< d2 */
+    typename A::V discounted_K; /**< K * exp(-r * T) */
+};
+
+/**
+ * @brief Compute d1, d2 and the discounted strike
+ */
+template <class A>
+inline Terms<A> terms(const Lanes<A>& x) {
+    Terms<A> t;
+    t.sqrt_T = A::sqrt(x.T);
+    typename A::V sigma_sqrt_T = A::mul(x.sigma, t.sqrt_T);
+    typename A::V drift =
+        A::fmadd(A::mul(x.sigma, x.sigma), A::set1(0.5), x.r);
+    t.d1 = A::div(A::fmadd(drift, x.T, vec_log<A>(A::div(x.S, x.K))),
+                  sigma_sqrt_T);
+    t.d2 = A::sub(t.d1, sigma_sqrt_T);
+    t.discounted_K =
+        A::mul(x.K, vec_exp<A>(A::sub(A::set1(0.0), A::mul(x.r, x.T))));
+    return t;
+}
+
+/**
+ * @brief Black-Scholes price of one vector of options
+ *
+ * Calls and puts share
+ * price = w * (S * N(w * d1) - K * exp(-r * T) * N(w * d2)).
+ */
+template <class A, class Normal>
+inline typename A::V price_vector(const Lanes<A>& x, const Normal& normal) {
+    Terms<A> t = terms<A>(x);
+    typename A::V call_leg = A::mul(x.S, normal.cdf(A::mul(x.w, t.d1)));
+    typename A::V put_leg =
+        A::mul(t.discounted_K, normal.cdf(A::mul(x.w, t.d2)));
+    return A::mul(x.w, A::sub(call_leg, put_leg));
+}
+
+/**
+ * @brief Load one vector of options starting at element @p i
+ */
+template <class A>
+inline Lanes<A> load_lanes(const BatchInputs& in, std::size_t i) {
+    return {A::load(in.S + i),
+            A::load(in.K + i),
+            A::load(in.T + i),
+            A::load(in.r + i),
+            A::load(in.sigma + i),
+            A::fnmadd(A::set1(2.0), A::load_int32(in.type + i),
+                      A::set1(1.0))};
+}
+
+/**
+ * @brief Store the first @p n lanes of @p x at @p p + @p i
+ *
+ * Nothing is stored if @p p is null.
+ */
+template <class A>
+inline void store_lanes(double* p, std::size_t i, typename A::V x,
+                        std::size_t n) {
+    if (p == nullptr) {
+        return;
+    }
+    if constexpr (A::width == 1) {
+        // A partial store of a single lane is no store at all
+        if (n != 0) {
+            A::store(p + i, x);
+        }
+    } else {
+        if (n == A::width) {
+            A::store(p + i, x);
+            return;
+        }
+        double buffer[A::width];
+        A::store(buffer, x);
+        std::memcpy(p + i, buffer,
+                    std::min(n, std::size_t{A::width}) * sizeof(double));
+    }
+}
+
+/**
+ * @brief Run @p kernel over a batch, one vector at a time
+ *
+ * The kernel is called as kernel(lanes, i, n) and must store its results
+ * with store_lanes(). The remainder that does not fill a whole vector is
+ * copied into padded scratch buffers so that every option goes through the
+ * same code path.
+ */
+template <class A, class Kernel>
+inline void for_each_vector(const BatchInputs& in, Kernel kernel) {
+    constexpr std::size_t W = A::width;
+    std::size_t i = 0;
+
+    for (; i + W <= in.size; i += W) {
+        kernel(load_lanes<A>(in, i), i, W);
+    }
+
+    std::size_t rest = in.size - i;
+    if (rest == 0) {
+        return;
+    }
+
+    double S[W], K[W], T[W], r[W], sigma[W];
+    std::int32_t type[W];
+    for (std::size_t j = 0; j < W; ++j) {
+        S[j] = K[j] = 100.0;
+        T[j] = 1.0;
+        r[j] = 0.0;
+        sigma[j] = 0.2;
+        type[j] = 0;
+    }
+    std::memcpy(S, in.S + i, rest * sizeof(double));
+    std::memcpy(K, in.K + i, rest * sizeof(double));
+    std::memcpy(T, in.T + i, rest * sizeof(double));
+    std::memcpy(r, in.r + i, rest * sizeof(double));
+    std::memcpy(sigma, in.sigma + i, rest * sizeof(double));
+    std::memcpy(type, in.type + i, rest * sizeof(std::int32_t));
+
+    BatchInputs padded = {S, K, T, r, sigma, type, W};
+    kernel(load_lanes<A>(padded, 0), i, rest);
+}
+
+/**
+ * @brief Price a batch of options with the given normal distribution
+ */
+template <class A, class Normal>
+void price_batch(const PriceArgs& args, const Normal& normal) {
+    for_each_vector<A>(
+        args.in, [&](const Lanes<A>& x, std::size_t i, std::size_t n) {
+            store_lanes<A>(args.prices, i, price_vector<A>(x, normal), n);
+        });
+}
+
+/**
+ * @brief Price a batch of options
+ */
+template <class A>
+void price_batch(const PriceArgs& args) {
+    if (args.normal != nullptr) {
+        price_batch<A>(args, TabulatedNormal<A>(*args.normal));
+    } else {
+        price_batch<A>(args, ExactNormal<A>());
+    }
+}
+
+/**
+ * @brief Sweep a block of positions over a row of spot moves
+ *
+ * Each vector of positions is loaded once and stays in registers while
+ * every spot move is applied, which only shifts log-moneyness and scales
+ * the spot.
+ */
+template <class A, class Normal>
+void scenario_batch(const ScenarioArgs& args, const Normal& normal) {
+    using V = typename A::V;
+    const ScenarioInputs& in = args.in;
+    for (std::size_t i = 0; i < in.size; i += A::width) {
+        V S = A::load(in.S + i);
+        V discounted_K = A::load(in.discounted_K + i);
+        V sigma_sqrt_T = A::load(in.sigma_sqrt_T + i);
+        V inverse = A::load(in.inverse_sigma_sqrt_T + i);
+        V w = A::fnmadd(A::set1(2.0), A::load_int32(in.type + i),
+                        A::set1(1.0));
+        V scale = A::mul(w, A::load(in.weight + i));
+        V d1_base = A::mul(
+            A::add(A::load(in.log_moneyness + i), A::load(in.drift + i)),
+            inverse);
+        for (std::size_t s = 0; s < args.spot_count; ++s) {
+            V d1 = A::fmadd(A::set1(args.log_spot_factors[s]), inverse,
+                            d1_base);
+            V d2 = A::sub(d1, sigma_sqrt_T);
+            V spot = A::mul(S, A::set1(args.spot_factors[s]));
+            V call_leg = A::mul(spot, normal.cdf(A::mul(w, d1)));
+            V put_leg = A::mul(discounted_K, normal.cdf(A::mul(w, d2)));
+            A::store(args.values + s * in.size + i,
+                     A::mul(scale, A::sub(call_leg, put_leg)));
+        }
+    }
+}
+
+/**
+ * @brief Sweep a block of positions over a row of spot moves
+ */
+template <class A>
+void scenario_batch(const ScenarioArgs& args) {
+    if (args.normal != nullptr) {
+        scenario_batch<A>(args, TabulatedNormal<A>(*args.normal));
+    } else {
+        scenario_batch<A>(args, ExactNormal<A>());
+    }
+}
+
+/**
+ * @brief Price and Greeks of a batch of options in one pass
+ *
+ * d1, d2, the density n(d1) and the two cumulative probabilities are
+ * evaluated once per option and shared by every output.
+ */
+template <class A, class Normal>
+void greeks_batch(const GreeksArgs& args, const Normal& normal) {
+    using V = typename A::V;
+    for_each_vector<A>(args.in, [&](const Lanes<A>& x, std::size_t i,
+                                    std::size_t n) {
+        Terms<A> t = terms<A>(x);
+        V pdf1;
+        V Nd1 = normal.cdf(A::mul(x.w, t.d1), pdf1);
+        V Nd2 = normal.cdf(A::mul(x.w, t.d2));
+        V carry = A::mul(t.discounted_K, Nd2);
+        V S_pdf1 = A::mul(x.S, pdf1);
+        V sigma_sqrt_T = A::mul(x.sigma, t.sqrt_T);
+
+        V price = A::mul(x.w, A::fnmadd(t.discounted_K, Nd2,
+                                        A::mul(x.S, Nd1)));
+        V delta = A::mul(x.w, Nd1);
+        V gamma = A::div(pdf1, A::mul(x.S, sigma_sqrt_T));
+        V vega = A::mul(S_pdf1, t.sqrt_T);
+        V decay = A::div(A::mul(S_pdf1, x.sigma),
+                         A::mul(A::set1(-2.0), t.sqrt_T));
+        V theta = A::fnmadd(A::mul(x.w, x.r), carry, decay);
+        V rho = A::mul(A::mul(x.w, x.T), carry);
+        V vanna = A::div(A::mul(pdf1, t.d2), A::sub(A::set1(0.0), x.sigma));
+        V volga = A::div(A::mul(vega, A::mul(t.d1, t.d2)), x.sigma);
+
+        store_lanes<A>(args.price, i, price, n);
+        store_lanes<A>(args.delta, i, delta, n);
+        store_lanes<A>(args.gamma, i, gamma, n);
+        store_lanes<A>(args.vega, i, vega, n);
+        store_lanes<A>(args.theta, i, theta, n);
+        store_lanes<A>(args.rho, i, rho, n);
+        store_lanes<A>(args.vanna, i, vanna, n);
+        store_lanes<A>(args.volga, i, volga, n);
+    });
+}
+
+/**
+ * @brief Price and Greeks of a batch of options
+ */
+template <class A>
+void greeks_batch(const GreeksArgs& args) {
+    if (args.normal != nullptr) {
+        greeks_batch<A>(args, TabulatedNormal<A>(*args.normal));
+    } else {
+        greeks_batch<A>(args, ExactNormal<A>());
+    }
+}
+
+/**
+ * @brief Solve for the implied volatilities of a batch of options
+ *
+ * Option prices are converted to call prices by put-call parity and seeded
+ * with the Corrado-Miller approximation. Every lane then takes Halley steps
+ * that reuse the vega and volga of the Greeks kernel, falling back to
+ * bisection of a running [lo, hi] bracket whenever a step larger than the
+ * tolerance would leave it.
+ * All lanes of a vector iterate together until each has converged or the
+ * iteration cap is reached; finished lanes are frozen with a blend rather
+ * than a branch. Prices outside the no-arbitrage bounds, options with T = 0
+ * and lanes that fail to converge produce NaN.
+ */
+template <class A>
+void implied_vol_batch(const ImpliedVolArgs& args) {
+    using V = typename A::V;
+    using M = typename A::M;
+    for_each_vector<A>(args.in, [&](const Lanes<A>& x, std::size_t i,
+                                    std::size_t n) {
+        const V zero = A::set1(0.0);
+        const V half = A::set1(0.5);
+        const V target = x.sigma;
+
+        // Invariants of the option, hoisted out of the iteration
+        const V sqrt_T = A::sqrt(x.T);
+        const V log_moneyness = vec_log<A>(A::div(x.S, x.K));
+        const V discounted_K =
+            A::mul(x.K, vec_exp<A>(A::sub(zero, A::mul(x.r, x.T))));
+        const V forward_gap = A::sub(x.S, discounted_K);
+        const V call = A::fmadd(A::mul(half, A::sub(A::set1(1.0), x.w)),
+                                forward_gap, target);
+
+        const M valid = A::mask_and(
+            A::lt(zero, x.T),
+            A::mask_and(A::lt(A::max(forward_gap, zero), call),
+                        A::lt(call, x.S)));
+
+        // Corrado-Miller (1996) initial guess
+        const V a = A::fnmadd(half, forward_gap, call);
+        const V radicand = A::max(
+            A::fnmadd(A::mul(forward_gap, forward_gap),
+                      A::set1(0.318309886183790671537767), A::mul(a, a)),
+            zero);
+        V sigma = A::mul(
+            A::div(A::sqrt(A::div(A::set1(6.283185307179586476925287), x.T)),
+                   A::add(x.S, discounted_K)),
+            A::add(a, A::sqrt(radicand)));
+        V lo = zero;
+        V hi = A::set1(10.0);
+        sigma = A::select(
+            A::mask_and(A::gt(sigma, A::set1(1e-3)), A::lt(sigma, hi)), sigma,
+            A::set1(0.3));
+
+        const V tolerance = A::set1(args.tolerance);
+        M done = A::mask_not(valid);
+        for (int k = 0; k < args.max_iterations && !A::all(done); ++k) {
+            V sigma_sqrt_T = A::mul(sigma, sqrt_T);
+            V drift = A::fmadd(A::mul(sigma, sigma), half, x.r);
+            V d1 = A::div(A::fmadd(drift, x.T, log_moneyness), sigma_sqrt_T);
+            V d2 = A::sub(d1, sigma_sqrt_T);
+            V g1 = vec_gaussian<A>(d1);
+            V Nd1 = vec_norm_cdf<A>(A::mul(x.w, d1), g1);
+            V Nd2 = vec_norm_cdf<A>(A::mul(x.w, d2));
+            V price = A::mul(x.w, A::fnmadd(discounted_K, Nd2,
+                                            A::mul(x.S, Nd1)));
+            V vega = A::mul(
+                A::mul(x.S, A::mul(g1, A::set1(0.398942280401432677939946))),
+                sqrt_T);
+            V volga = A::div(A::mul(vega, A::mul(d1, d2)), sigma);
+
+            // Prices increase with volatility, which keeps the bracket valid
+            V f = A::sub(price, target);
+            M above = A::gt(f, zero);
+            hi = A::select(above, sigma, hi);
+            lo = A::select(above, lo, sigma);
+
+            V newton = A::div(f, vega);
+            V halley = A::div(
+                newton,
+                A::fnmadd(A::mul(half, newton), A::div(volga, vega),
+                          A::set1(1.0)));
+            V next = A::sub(sigma, halley);
+            M inside = A::mask_and(A::gt(next, lo), A::lt(next, hi));
+            M accept = A::mask_or(A::lt(A::abs(halley), tolerance), inside);
+            next = A::select(accept, next, A::mul(half, A::add(lo, hi)));
+
+            M converged = A::lt(A::abs(A::sub(next, sigma)), tolerance);
+            sigma = A::select(done, sigma, next);
+            done = A::mask_or(done, converged);
+        }
+
+        const V nan = A::set1(std::numeric_limits<double>::quiet_NaN());
+        store_lanes<A>(args.vols, i,
+                       A::select(A::mask_and(valid, done), sigma, nan), n);
+    });
+}
+
+}  // namespace simd
+}  // namespace thales
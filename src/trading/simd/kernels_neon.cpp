@@ -0,0 +1,124 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// NEON is part of the AArch64 baseline, so no runtime check is needed.
+
+#include <arm_neon.h>
+
+#include "kernels_impl.h"
+
+namespace thales {
+namespace simd {
+
+namespace {
+
+/**
+ * @brief Traits for 2-wide NEON double vectors
+ */
+struct Neon {
+    using V = float64x2_t;
+    using M = uint64x2_t;
+    static constexpr std::size_t width = 2;
+
+    static V set1(double x) { return vdupq_n_f64(x); }
+    static V load(const double* p) { return vld1q_f64(p); }
+    static void store(double* p, V x) { vst1q_f64(p, x); }
+    static V load_int32(const std::int32_t* p) {
+        return vcvtq_f64_s64(vmovl_s32(vld1_s32(p)));
+    }
+
+    static V add(V a, V b) { return vaddq_f64(a, b); }
+    static V sub(V a, V b) { return vsubq_f64(a, b); }
+    static V mul(V a, V b) { return vmulq_f64(a, b); }
+    static V div(V a, V b) { return vdivq_f64(a, b); }
+    static V fmadd(V a, V b, V c) { return vfmaq_f64(c, a, b); }
+    static V fnmadd(V a, V b, V c) { return vfmsq_f64(c, a, b); }
+
+    static V sqrt(V x) { return vsqrtq_f64(x); }
+    static V min(V a, V b) { return vminq_f64(a, b); }
+    static V max(V a, V b) { return vmaxq_f64(a, b); }
+    static V abs(V x) { return vabsq_f64(x); }
+    static V round(V x) { return vrndnq_f64(x); }
+
+    static M lt(V a, V b) { return vcltq_f64(a, b); }
+    static M gt(V a, V b) { return vcgtq_f64(a, b); }
+    static V select(M m, V a, V b) { return vbslq_f64(m, a, b); }
+    static M mask_and(M a, M b) { return vandq_u64(a, b); }
+    static M mask_or(M a, M b) { return vorrq_u64(a, b); }
+    static M mask_not(M m) {
+        return vreinterpretq_u64_u32(vmvnq_u32(vreinterpretq_u32_u64(m)));
+    }
+    static bool all(M m) {
+        return (vgetq_lane_u64(m, 0) & vgetq_lane_u64(m, 1)) != 0;
+    }
+
+    static V ldexp(V x, V n) {
+        int64x2_t bits = vaddq_s64(vcvtq_s64_f64(n), vdupq_n_s64(1023));
+        return vmulq_f64(x, vreinterpretq_f64_s64(vshlq_n_s64(bits, 52)));
+    }
+    static V frexp(V x, V& e) {
+        const uint64x2_t bits = vreinterpretq_u64_f64(x);
+        const uint64x2_t biased =
+            vandq_u64(vshrq_n_u64(bits, 52), vdupq_n_u64(0x7ff));
+        e = vsubq_f64(vcvtq_f64_u64(biased), vdupq_n_f64(1022.0));
+        const uint64x2_t mantissa =
+            vorrq_u64(vandq_u64(bits, vdupq_n_u64(0x800FFFFFFFFFFFFFULL)),
+                      vdupq_n_u64(0x3FE0000000000000ULL));
+        return vreinterpretq_f64_u64(mantissa);
+    }
+    static V gather(const double* p, V i) {
+        return vcombine_f64(
+            vld1_f64(p + static_cast<std::size_t>(vgetq_lane_f64(i, 0))),
+            vld1_f64(p + static_cast<std::size_t>(vgetq_lane_f64(i, 1))));
+    }
+};
+
+void price_neon(const PriceArgs& args) { price_batch<Neon>(args); }
+
+void greeks_neon(const GreeksArgs& args) { greeks_batch<Neon>(args); }
+
+void implied_vol_neon(const ImpliedVolArgs& args) {
+    implied_vol_batch<Neon>(args);
+}
+
+void exp_neon(const ArrayArgs& args) { exp_array<Neon>(args); }
+
+void inverse_norm_cdf_neon(const ArrayArgs& args) {
+    inverse_norm_cdf_array<Neon>(args);
+}
+
+void scenario_neon(const ScenarioArgs& args) { scenario_batch<Neon>(args); }
+
+}  // namespace
+
+const KernelTable& neon_kernels() {
+    static const KernelTable table = {price_neon, greeks_neon,
+                                       implied_vol_neon, exp_neon,
+                                       inverse_norm_cdf_neon,
+                                       scenario_neon};
+    return table;
+}
+
+}  // namespace simd
+}  // namespace thales
@@ -0,0 +1,126 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cmath>
+#include <cstring>
+
+#include "kernels_impl.h"
+
+namespace thales {
+namespace simd {
+
+namespace {
+
+/**
+ * @brief Traits for plain doubles, used when no SIMD backend is available
+ */
+struct Scalar {
+    using V = double;
+    using M = bool;
+    static constexpr std::size_t width = 1;
+
+    static V set1(double x) { return x; }
+    static V load(const double* p) { return *p; }
+    static void store(double* p, V x) { *p = x; }
+    static V load_int32(const std::int32_t* p) {
+        std::int32_t x;
+        std::memcpy(&x, p, sizeof(x));
+        return static_cast<double>(x);
+    }
+
+    static V add(V a, V b) { return a + b; }
+    static V sub(V a, V b) { return a - b; }
+    static V mul(V a, V b) { return a * b; }
+    static V div(V a, V b) { return a / b; }
+    static V fmadd(V a, V b, V c) { return a * b + c; }
+    static V fnmadd(V a, V b, V c) { return c - a * b; }
+
+    static V sqrt(V x) { return std::sqrt(x); }
+    static V min(V a, V b) { return a < b ? a : b; }
+    static V max(V a, V b) { return a > b ? a : b; }
+    static V abs(V x) { return std::fabs(x); }
+    static V round(V x) {
+        // Adding 1.5 * 2^52 pushes the fraction bits out of the mantissa, so
+        // the sum rounds to nearest even without a libm call (|x| < 2^51).
+        return (x + 6755399441055744.0) - 6755399441055744.0;
+    }
+
+    static M lt(V a, V b) { return a < b; }
+    static M gt(V a, V b) { return a > b; }
+    static V select(M m, V a, V b) { return m ? a : b; }
+    static M mask_and(M a, M b) { return a && b; }
+    static M mask_or(M a, M b) { return a || b; }
+    static M mask_not(M m) { return !m; }
+    static bool all(M m) { return m; }
+
+    static V ldexp(V x, V n) {
+        std::uint64_t bits =
+            static_cast<std::uint64_t>(static_cast<std::int64_t>(n) + 1023)
+            << 52;
+        double scale;
+        std::memcpy(&scale, &bits, sizeof(scale));
+        return x * scale;
+    }
+    static V frexp(V x, V& e) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        e = static_cast<double>((bits >> 52) & 0x7ff) - 1022.0;
+        bits = (bits & 0x800FFFFFFFFFFFFFULL) | 0x3FE0000000000000ULL;
+        double m;
+        std::memcpy(&m, &bits, sizeof(m));
+        return m;
+    }
+    static V gather(const double* p, V i) {
+        return p[static_cast<std::size_t>(i)];
+    }
+};
+
+void price_scalar(const PriceArgs& args) { price_batch<Scalar>(args); }
+
+void greeks_scalar(const GreeksArgs& args) { greeks_batch<Scalar>(args); }
+
+void implied_vol_scalar(const ImpliedVolArgs& args) {
+    implied_vol_batch<Scalar>(args);
+}
+
+void exp_scalar(const ArrayArgs& args) { exp_array<Scalar>(args); }
+
+void inverse_norm_cdf_scalar(const ArrayArgs& args) {
+    inverse_norm_cdf_array<Scalar>(args);
+}
+
+void scenario_scalar(const ScenarioArgs& args) { scenario_batch<Scalar>(args); }
+
+}  // namespace
+
+const KernelTable& scalar_kernels() {
+    static const KernelTable table = {price_scalar, greeks_scalar,
+                                       implied_vol_scalar, exp_scalar,
+                                       inverse_norm_cdf_scalar,
+                                       scenario_scalar};
+    return table;
+}
+
+}  // namespace simd
+}  // namespace thales
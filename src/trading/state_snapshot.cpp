@@ -0,0 +1,725 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "trading/state_snapshot.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "trading/strategy.h"
+#include "utils/logging.h"
+#include "utils/mapped_file.h"
+#include "utils/metrics.h"
+
+namespace thales {
+
+namespace {
+
+constexpr char MAGIC[8] = {'T', 'H', 'A', 'L', 'E', 'S', 'S', 'N'};
+constexpr std::uint32_t VERSION = 1;
+
+/**
+ * @brief Sections of a snapshot file, in file order.
+ *
+ * Text sections (symbols, configuration) are NUL-separated strings with a
+ * width of one byte.
+ */
+enum Section : std::uint32_t {
+    SYMBOLS,              /**< Symbol names, indexed by stored SymbolId */
+    POSITION_SYMBOLS,     /**< Portfolio columns */
+    POSITION_TYPES,
+    POSITION_STRIKES,
+    POSITION_EXPIRATIONS,
+    POSITION_QUANTITIES,
+    POSITION_PREMIUMS,
+    ORDERS,               /**< Order records */
+    CHAIN_EXPIRIES,       /**< OptionChainIndex arrays */
+    CHAIN_STRIKES,
+    CHAIN_SOURCES,
+    CHAIN_ENTRY_EXPIRY,
+    SURFACES,             /**< SurfaceRecord per surface */
+    SLICES,               /**< SliceRecord per slice of every surface */
+    QUOTES,               /**< SmileQuote per quote of every slice */
+    GRID,                 /**< VOL_GRID_POINTS variances per slice */
+    CONFIG,               /**< Section, key and value of every entry */
+    SECTION_COUNT
+};
+
+/**
+ * @brief Location of one section.
+ */
+struct SectionEntry {
+    std::uint64_t offset; /**< Byte offset from the start of the file */
+    std::uint64_t count;  /**< Records */
+    std::uint64_t width;  /**< Bytes per record */
+};
+
+/**
+ * @brief Header at the start of every snapshot file.
+ */
+struct SnapshotHeader {
+    char magic[8];              /**< "THALESSN" */
+    std::uint32_t version;      /**< Format version */
+    std::uint32_t section_count; /**< SECTION_COUNT */
+    std::uint64_t file_size;    /**< Bytes, to detect truncation */
+    std::int64_t timestamp_ns;  /**< TradingState::timestamp_ns */
+    double net_liquidity;       /**< Portfolio book value */
+    std::uint64_t symbol_count; /**< Strings in the SYMBOLS section */
+    SectionEntry sections[SECTION_COUNT];
+};
+
+/**
+ * @brief One surface; its slices are [first_slice, first_slice + slices).
+ */
+struct SurfaceRecord {
+    SymbolId underlying;
+    std::uint32_t interpolation;
+    double spot;
+    double rate;
+    std::uint64_t first_slice;
+    std::uint64_t slices;
+};
+
+/**
+ * @brief One slice; its quotes are [first_quote, first_quote + quotes)
+ *        and its grid is the GRID run at its index.
+ */
+struct SliceRecord {
+    double expiry;
+    SviParameters fit;
+    double k_min;
+    double k_step;
+    std::uint64_t first_quote;
+    std::uint64_t quotes;
+    std::uint32_t fitted;
+    std::uint32_t stale;
+};
+
+std::size_t align_up(std::size_t offset) {
+    return (offset + SNAPSHOT_ALIGNMENT - 1) & ~(SNAPSHOT_ALIGNMENT - 1);
+}
+
+/**
+ * @brief Typed access to the sections of a mapped snapshot.
+ */
+class SnapshotView {
+   public:
+    SnapshotView(const MappedFile& file, const SnapshotHeader& header)
+        : file(file), header(header) {}
+
+    std::size_t count(Section section) const {
+        return static_cast<std::size_t>(header.sections[section].count);
+    }
+
+    template <typename T>
+    const T* column(Section section) const {
+        return reinterpret_cast<const T*>(file.data() +
+                                          header.sections[section].offset);
+    }
+
+   private:
+    const MappedFile& file;
+    const SnapshotHeader& header;
+};
+
+/**
+ * @brief Appends a string and its terminating NUL to a text section.
+ */
+void append_text(std::string& text, std::string_view value) {
+    text.append(value.data(), value.size());
+    text.push_back('\0');
+}
+
+/**
+ * @brief Splits a text section into its strings.
+ */
+std::vector<std::string_view> split_text(const char* data, std::size_t size) {
+    std::vector<std::string_view> values;
+    std::string_view text(data, size);
+    while (!text.empty()) {
+        std::size_t end = text.find('\0');
+        if (end == std::string_view::npos) {
+            throw std::runtime_error("Snapshot text is not terminated");
+        }
+        values.push_back(text.substr(0, end));
+        text.remove_prefix(end + 1);
+    }
+    return values;
+}
+
+}  // namespace
+
+void StateSnapshot::write(const std::string& path,
+                          const TradingState& state) {
+    METRIC_TIME_SCOPE("thales_snapshot_write_seconds",
+                      "Time to write a state snapshot");
+    // Every SymbolId in the state was interned before this point
+    std::size_t symbol_count = SymbolTable::size();
+    std::string symbols;
+    for (std::size_t id = 0; id < symbol_count; ++id) {
+        append_text(symbols, SymbolTable::name(static_cast<SymbolId>(id)));
+    }
+
+    std::vector<SurfaceRecord> surfaces;
+    std::vector<SliceRecord> slices;
+    std::vector<SmileQuote> quotes;
+    std::vector<double> grid;
+    for (std::size_t id = 0; id < state.surfaces.size(); ++id) {
+        if (!state.surfaces[id]) {
+            continue;
+        }
+        const VolSurface& surface = *state.surfaces[id];
+        surfaces.push_back({static_cast<SymbolId>(id),
+                            static_cast<std::uint32_t>(surface.interpolation),
+                            surface.spot, surface.rate, slices.size(),
+                            surface.slices.size()});
+        for (const VolSurface::Slice& slice : surface.slices) {
+            slices.push_back({slice.expiry, slice.fit, slice.k_min,
+                              slice.k_step, quotes.size(),
+                              slice.quotes.size(), slice.fitted, slice.stale});
+            quotes.insert(quotes.end(), slice.quotes.begin(),
+                          slice.quotes.end());
+        }
+        grid.insert(grid.end(), surface.grid.begin(), surface.grid.end());
+    }
+
+    std::string config;
+    state.config.for_each([&](std::string_view section, std::string_view key,
+                              const ConfigValue& value) {
+        append_text(config, section);
+        append_text(config, key);
+        append_text(config, value.text());
+    });
+
+    const Portfolio& portfolio = state.portfolio;
+    const OptionChainIndex& chain = state.chain;
+    struct SectionData {
+        const void* data;
+        std::size_t count;
+        std::size_t width;
+    };
+    const SectionData data[SECTION_COUNT] = {
+        {symbols.data(), symbols.size(), 1},
+        {portfolio.get_symbol_ids().data(), portfolio.size(),
+         sizeof(SymbolId)},
+        {portfolio.get_types().data(), portfolio.size(), sizeof(OptionType)},
+        {portfolio.get_strikes().data(), portfolio.size(), sizeof(double)},
+        {portfolio.get_expirations().data(), portfolio.size(),
+         sizeof(std::int32_t)},
+        {portfolio.get_quantities().data(), portfolio.size(), sizeof(int)},
+        {portfolio.get_premiums().data(), portfolio.size(), sizeof(double)},
+        {state.orders.data(), state.orders.size(), sizeof(Order)},
+        {chain.expiry_table.data(), chain.expiry_table.size(),
+         sizeof(OptionChainIndex::Expiry)},
+        {chain.strikes.data(), chain.strikes.size(), sizeof(double)},
+        {chain.sources.data(), chain.sources.size(), sizeof(std::uint32_t)},
+        {chain.entry_expiry.data(), chain.entry_expiry.size(),
+         sizeof(std::uint32_t)},
+        {surfaces.data(), surfaces.size(), sizeof(SurfaceRecord)},
+        {slices.data(), slices.size(), sizeof(SliceRecord)},
+        {quotes.data(), quotes.size(), sizeof(SmileQuote)},
+        {grid.data(), grid.size(), sizeof(double)},
+        {config.data(), config.size(), 1},
+    };
+
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.section_count = SECTION_COUNT;
+    header.timestamp_ns = state.timestamp_ns;
+    header.net_liquidity = portfolio.get_net_liquidity();
+    header.symbol_count = symbol_count;
+    std::size_t offset = align_up(sizeof(header));
+    for (std::size_t i = 0; i < SECTION_COUNT; ++i) {
+        header.sections[i] = {offset, data[i].count, data[i].width};
+        offset = align_up(offset + data[i].count * data[i].width);
+    }
+    header.file_size = offset;
+
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent);
+    }
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        static const char padding[SNAPSHOT_ALIGNMENT] = {};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        std::size_t written = sizeof(header);
+        for (const SectionData& section : data) {
+            out.write(padding, static_cast<std::streamsize>(
+                                   align_up(written) - written));
+            written = align_up(written);
+            std::size_t bytes = section.count * section.width;
+            out.write(static_cast<const char*>(section.data),
+                      static_cast<std::streamsize>(bytes));
+            written += bytes;
+        }
+        out.write(padding,
+                  static_cast<std::streamsize>(align_up(written) - written));
+        out.flush();
+        if (!out) {
+            std::remove(temporary.c_str());
+            throw std::runtime_error("Unable to write " + temporary);
+        }
+    }
+    // The rename must not reach the disk before the data it points to
+    int fd = ::open(temporary.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0 || ::fsync(fd) != 0) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        std::remove(temporary.c_str());
+        throw std::runtime_error("Unable to sync " + temporary);
+    }
+    ::close(fd);
+    std::filesystem::rename(temporary, path);
+}
+
+void StateSnapshot::read(const std::string& path, TradingState& state) {
+    METRIC_TIME_SCOPE("thales_snapshot_read_seconds",
+                      "Time to load a state snapshot");
+    MappedFile file(path, true);
+    SnapshotHeader header;
+    if (file.size() < sizeof(header)) {
+        throw std::runtime_error("Not a state snapshot: " + path);
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("Not a state snapshot: " + path);
+    }
+    if (header.version != VERSION || header.section_count != SECTION_COUNT) {
+        throw std::runtime_error("Unsupported state snapshot version: " +
+                                 path);
+    }
+    if (header.file_size != file.size()) {
+        throw std::runtime_error("Truncated state snapshot: " + path);
+    }
+
+    // Record widths differ between incompatible builds, e.g. if Order's
+    // layout changed
+    const std::size_t widths[SECTION_COUNT] = {
+        1,
+        sizeof(SymbolId),
+        sizeof(OptionType),
+        sizeof(double),
+        sizeof(std::int32_t),
+        sizeof(int),
+        sizeof(double),
+        sizeof(Order),
+        sizeof(OptionChainIndex::Expiry),
+        sizeof(double),
+        sizeof(std::uint32_t),
+        sizeof(std::uint32_t),
+        sizeof(SurfaceRecord),
+        sizeof(SliceRecord),
+        sizeof(SmileQuote),
+        sizeof(double),
+        1,
+    };
+    for (std::size_t i = 0; i < SECTION_COUNT; ++i) {
+        const SectionEntry& section = header.sections[i];
+        if (section.width != widths[i] ||
+            section.offset % SNAPSHOT_ALIGNMENT != 0 ||
+            section.offset > file.size() ||
+            section.count > (file.size() - section.offset) / section.width) {
+            throw std::runtime_error("Malformed state snapshot: " + path);
+        }
+    }
+    SnapshotView view(file, header);
+    auto count = [&view](Section section) { return view.count(section); };
+    auto fail = [&path]() {
+        throw std::runtime_error("Malformed state snapshot: " + path);
+    };
+
+    // Every section is validated before any name is interned, so a rejected
+    // file leaves the process-wide symbol table as it was
+    std::vector<std::string_view> names = split_text(
+        view.column<char>(SYMBOLS), count(SYMBOLS));
+    if (names.size() != header.symbol_count) {
+        fail();
+    }
+    auto check_symbol = [&](SymbolId stored) {
+        if (stored >= names.size()) {
+            fail();
+        }
+    };
+    // Read as integers: a stored value outside the enum is not an OptionType
+    using TypeValue = std::underlying_type_t<OptionType>;
+    auto check_type = [&](TypeValue type) {
+        if (type != CALL && type != PUT) {
+            fail();
+        }
+    };
+
+    std::size_t rows = count(POSITION_SYMBOLS);
+    for (Section section : {POSITION_TYPES, POSITION_STRIKES,
+                            POSITION_EXPIRATIONS, POSITION_QUANTITIES,
+                            POSITION_PREMIUMS}) {
+        if (count(section) != rows) {
+            fail();
+        }
+    }
+    const SymbolId* symbols =
+        view.column<SymbolId>(POSITION_SYMBOLS);
+    const TypeValue* types =
+        view.column<TypeValue>(POSITION_TYPES);
+    const double* strikes =
+        view.column<double>(POSITION_STRIKES);
+    const std::int32_t* expirations =
+        view.column<std::int32_t>(POSITION_EXPIRATIONS);
+    const int* quantities =
+        view.column<int>(POSITION_QUANTITIES);
+    const double* premiums =
+        view.column<double>(POSITION_PREMIUMS);
+    for (std::size_t i = 0; i < rows; ++i) {
+        check_symbol(symbols[i]);
+        check_type(types[i]);
+    }
+
+    std::vector<Order> orders;
+    orders.reserve(count(ORDERS));
+    const char* order_records = view.column<char>(ORDERS);
+    for (std::size_t i = 0; i < count(ORDERS); ++i) {
+        // Records are copied out rather than aliased as Order objects
+        Order stored(Side::BUY, 0, CALL, 0.0, 0, 0, 0.0, 0);
+        std::memcpy(static_cast<void*>(&stored),
+                    order_records + i * sizeof(Order), sizeof(Order));
+        if (stored.get_side() != Side::BUY &&
+            stored.get_side() != Side::SELL) {
+            fail();
+        }
+        check_symbol(stored.get_symbol_id());
+        check_type(stored.get_type());
+        orders.push_back(stored);
+    }
+
+    OptionChainIndex chain;
+    const auto* expiries =
+        view.column<OptionChainIndex::Expiry>(CHAIN_EXPIRIES);
+    chain.expiry_table.assign(expiries, expiries + count(CHAIN_EXPIRIES));
+    const double* chain_strikes =
+        view.column<double>(CHAIN_STRIKES);
+    chain.strikes.assign(chain_strikes, chain_strikes + count(CHAIN_STRIKES));
+    const auto* sources =
+        view.column<std::uint32_t>(CHAIN_SOURCES);
+    chain.sources.assign(sources, sources + count(CHAIN_SOURCES));
+    const auto* entry_expiry =
+        view.column<std::uint32_t>(CHAIN_ENTRY_EXPIRY);
+    chain.entry_expiry.assign(entry_expiry,
+                              entry_expiry + count(CHAIN_ENTRY_EXPIRY));
+    if (chain.sources.size() != chain.strikes.size() ||
+        chain.entry_expiry.size() != chain.strikes.size()) {
+        fail();
+    }
+    for (const OptionChainIndex::Expiry& expiry : chain.expiry_table) {
+        if (expiry.begin > expiry.puts || expiry.puts > expiry.end ||
+            expiry.end > chain.strikes.size()) {
+            fail();
+        }
+        check_symbol(expiry.underlying);
+    }
+    for (std::uint32_t expiry : chain.entry_expiry) {
+        if (expiry >= chain.expiry_table.size()) {
+            fail();
+        }
+    }
+    // reconcile() indexes the book by these rows
+    for (std::uint32_t source : chain.sources) {
+        if (source >= rows) {
+            fail();
+        }
+    }
+
+    const SurfaceRecord* surface_records =
+        view.column<SurfaceRecord>(SURFACES);
+    const SliceRecord* slice_records =
+        view.column<SliceRecord>(SLICES);
+    const SmileQuote* quotes = view.column<SmileQuote>(QUOTES);
+    const double* grid = view.column<double>(GRID);
+    if (count(GRID) != count(SLICES) * VOL_GRID_POINTS) {
+        fail();
+    }
+    for (std::size_t i = 0; i < count(SURFACES); ++i) {
+        const SurfaceRecord& record = surface_records[i];
+        if (record.first_slice > count(SLICES) ||
+            record.slices > count(SLICES) - record.first_slice ||
+            record.interpolation >
+                static_cast<std::uint32_t>(SurfaceInterpolation::CUBIC)) {
+            fail();
+        }
+        check_symbol(record.underlying);
+        const SliceRecord* first = slice_records + record.first_slice;
+        for (std::size_t s = 0; s < record.slices; ++s) {
+            if (first[s].first_quote > count(QUOTES) ||
+                first[s].quotes > count(QUOTES) - first[s].first_quote) {
+                fail();
+            }
+        }
+    }
+
+    std::vector<std::string_view> entries = split_text(
+        view.column<char>(CONFIG), count(CONFIG));
+    if (entries.size() % 3 != 0) {
+        fail();
+    }
+
+    // Valid: stored IDs are translated to this process's IDs
+    std::vector<SymbolId> ids(names.size());
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        ids[i] = SymbolTable::intern(names[i]);
+    }
+
+    Portfolio portfolio(header.net_liquidity,
+                        state.portfolio.get_resource());
+    portfolio.reserve(rows);
+    for (std::size_t i = 0; i < rows; ++i) {
+        portfolio.add_position(Position(
+            ids[symbols[i]], static_cast<OptionType>(types[i]), strikes[i],
+            expirations[i], quantities[i], premiums[i]));
+    }
+
+    for (Order& order : orders) {
+        order = Order(order.get_side(), ids[order.get_symbol_id()],
+                      order.get_type(), order.get_strike_price(),
+                      order.get_expiration(), order.get_quantity(),
+                      order.get_premium(), order.get_timestamp_ns());
+    }
+
+    for (OptionChainIndex::Expiry& expiry : chain.expiry_table) {
+        expiry.underlying = ids[expiry.underlying];
+    }
+    // New IDs may sort differently; strike runs stay where they are, so
+    // only the expiry table and the entries' links to it are reordered
+    auto expiry_order = [](const OptionChainIndex::Expiry& a,
+                           const OptionChainIndex::Expiry& b) {
+        return std::tie(a.underlying, a.expiration) <
+               std::tie(b.underlying, b.expiration);
+    };
+    if (!std::is_sorted(chain.expiry_table.begin(), chain.expiry_table.end(),
+                        expiry_order)) {
+        std::vector<std::uint32_t> order(chain.expiry_table.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(),
+                  [&](std::uint32_t a, std::uint32_t b) {
+                      return expiry_order(chain.expiry_table[a],
+                                          chain.expiry_table[b]);
+                  });
+        std::vector<OptionChainIndex::Expiry> sorted;
+        std::vector<std::uint32_t> moved_to(order.size());
+        sorted.reserve(order.size());
+        for (std::uint32_t old_index : order) {
+            moved_to[old_index] = static_cast<std::uint32_t>(sorted.size());
+            sorted.push_back(chain.expiry_table[old_index]);
+        }
+        chain.expiry_table.swap(sorted);
+        for (std::uint32_t& expiry : chain.entry_expiry) {
+            expiry = moved_to[expiry];
+        }
+    }
+    std::size_t underlyings = chain.expiry_table.empty()
+                                  ? 0
+                                  : chain.expiry_table.back().underlying + 1;
+    chain.underlying_begin.assign(underlyings + 1, 0);
+    for (const OptionChainIndex::Expiry& expiry : chain.expiry_table) {
+        ++chain.underlying_begin[expiry.underlying + 1];
+    }
+    std::partial_sum(chain.underlying_begin.begin(),
+                     chain.underlying_begin.end(),
+                     chain.underlying_begin.begin());
+
+    std::vector<std::optional<VolSurface>> surfaces;
+    for (std::size_t i = 0; i < count(SURFACES); ++i) {
+        const SurfaceRecord& record = surface_records[i];
+        SymbolId id = ids[record.underlying];
+        if (id >= surfaces.size()) {
+            surfaces.resize(id + std::size_t{1});
+        }
+        VolSurface& surface = surfaces[id].emplace(
+            record.spot, record.rate,
+            static_cast<SurfaceInterpolation>(record.interpolation));
+        const SliceRecord* first = slice_records + record.first_slice;
+        for (std::size_t s = 0; s < record.slices; ++s) {
+            const SliceRecord& stored = first[s];
+            VolSurface::Slice slice;
+            slice.expiry = stored.expiry;
+            slice.quotes.assign(quotes + stored.first_quote,
+                                quotes + stored.first_quote + stored.quotes);
+            slice.fit = stored.fit;
+            slice.k_min = stored.k_min;
+            slice.k_step = stored.k_step;
+            slice.fitted = stored.fitted != 0;
+            slice.stale = stored.stale != 0;
+            if (slice.fitted) {
+                surface.fitted.push_back(s);
+            }
+            surface.slices.push_back(std::move(slice));
+        }
+        const double* nodes = grid + record.first_slice * VOL_GRID_POINTS;
+        surface.grid.assign(nodes, nodes + record.slices * VOL_GRID_POINTS);
+    }
+
+    ConfigSnapshot config;
+    for (std::size_t i = 0; i < entries.size(); i += 3) {
+        config.set(entries[i], entries[i + 1], entries[i + 2]);
+    }
+
+    state.timestamp_ns = header.timestamp_ns;
+    state.portfolio = std::move(portfolio);
+    state.orders = std::move(orders);
+    state.chain = std::move(chain);
+    state.surfaces = std::move(surfaces);
+    state.config = std::move(config);
+}
+
+ReconcileStats reconcile(TradingState& state, const Portfolio& broker,
+                         const std::pmr::vector<Order>& executions) {
+    ReconcileStats stats;
+    Portfolio& book = state.portfolio;
+    if (state.chain.size() != book.size()) {
+        state.chain = OptionChainIndex(book);
+    }
+
+    std::vector<bool> held(book.size(), false);
+    for (std::size_t i = 0; i < broker.size(); ++i) {
+        ContractKey contract{broker.get_symbol_ids()[i],
+                             broker.get_expirations()[i],
+                             broker.get_types()[i], broker.get_strikes()[i]};
+        int quantity = broker.get_quantities()[i];
+        double premium = broker.get_premiums()[i];
+        std::size_t entry = state.chain.find(contract);
+        if (entry == OptionChainIndex::NOT_FOUND) {
+            book.add_position(broker.get_position(i));
+            ++stats.positions_added;
+            continue;
+        }
+        std::size_t row = state.chain.source(entry);
+        held[row] = true;
+        if (book.get_quantities()[row] != quantity ||
+            book.get_premiums()[row] != premium) {
+            book.set_position(row, quantity, premium);
+            ++stats.positions_changed;
+        }
+    }
+    for (std::size_t row = 0; row < held.size(); ++row) {
+        if (!held[row] && book.get_quantities()[row] != 0) {
+            book.set_position(row, 0, book.get_premiums()[row]);
+            ++stats.positions_changed;
+        }
+    }
+    book.set_net_liquidity(broker.get_net_liquidity());
+    if (stats.positions_added > 0) {
+        state.chain = OptionChainIndex(book);
+    }
+
+    std::int64_t newest = std::numeric_limits<std::int64_t>::min();
+    for (const Order& order : state.orders) {
+        newest = std::max(newest, order.get_timestamp_ns());
+    }
+    for (const Order& execution : executions) {
+        if (execution.get_timestamp_ns() > newest) {
+            state.orders.push_back(execution);
+            ++stats.orders_added;
+        }
+    }
+    return stats;
+}
+
+StateSnapshotWriter::StateSnapshotWriter(std::string path,
+                                         std::chrono::milliseconds interval)
+    : path(std::move(path)), interval(interval) {}
+
+StateSnapshotWriter::~StateSnapshotWriter() { stop(); }
+
+void StateSnapshotWriter::start() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (thread.joinable()) {
+        return;
+    }
+    stopping = false;
+    thread = std::thread(&StateSnapshotWriter::run, this);
+}
+
+void StateSnapshotWriter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (thread.joinable()) {
+        thread.join();
+    }
+    flush();
+}
+
+void StateSnapshotWriter::update(
+    const std::function<void(TradingState&)>& fill) {
+    fill(buffers[back]);
+    back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & ~FRESH;
+}
+
+bool StateSnapshotWriter::flush() {
+    std::lock_guard<std::mutex> lock(io);
+    if ((middle.load(std::memory_order_acquire) & FRESH) == 0) {
+        return false;
+    }
+    // Only update() sets FRESH, so the buffer taken is the newest one
+    front = middle.exchange(front, std::memory_order_acq_rel) & ~FRESH;
+    try {
+        StateSnapshot::write(path, buffers[front]);
+    } catch (const std::exception& e) {
+        LOG_WARN("State snapshot not written: {}", std::string_view(e.what()));
+        return false;
+    }
+    writes.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void StateSnapshotWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        if (wake.wait_for(lock, interval, [this] { return stopping; })) {
+            break;
+        }
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
+
+}  // namespace thales
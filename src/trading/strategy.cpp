@@ -21,3 +21,378 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  * SOFTWARE.
  */
+
+#include "trading/strategy.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+
+#include "utils/thread_pool.h"
+
+namespace thales {
+
+namespace {
+
+constexpr double MISSING = std::numeric_limits<double>::quiet_NaN();
+
+std::uint32_t known_size(std::uint32_t size) {
+    return size == 0 ? UNKNOWN_QUOTE_SIZE : size;
+}
+
+ContractKey contract_of(const Order& order) {
+    return {order.get_symbol_id(), order.get_expiration(), order.get_type(),
+            order.get_strike_price()};
+}
+
+/**
+ * @brief Read position in one of a day's files during the merge.
+ */
+struct Cursor {
+    const std::int64_t* timestamps;
+    std::size_t row;
+    std::size_t rows;
+    std::size_t file;
+    bool quotes;
+};
+
+}  // namespace
+
+std::size_t ContractKeyHash::operator()(const ContractKey& key) const
+    noexcept {
+    std::uint64_t strike;
+    std::memcpy(&strike, &key.strike, sizeof(strike));
+    std::uint64_t hash = key.underlying;
+    hash = (hash << 32) ^ static_cast<std::uint32_t>(key.expiration);
+    hash = hash * 0x9E3779B97F4A7C15ULL ^ strike ^ key.type;
+    hash *= 0x9E3779B97F4A7C15ULL;
+    return static_cast<std::size_t>(hash ^ (hash >> 32));
+}
+
+BacktestData::BacktestData(const TickStore& store,
+                           const std::vector<std::string>& symbols,
+                           std::int32_t first_day, std::int32_t last_day) {
+    if (first_day > last_day) {
+        throw std::invalid_argument("Backtest range is empty");
+    }
+    std::map<std::int32_t, Day> by_day;
+    auto day_of = [&](std::int32_t day) -> Day& {
+        Day& entry = by_day[day];
+        entry.day = day;
+        return entry;
+    };
+    for (const std::string& symbol : symbols) {
+        SymbolId id = SymbolTable::intern(symbol);
+        for (std::int32_t day : store.bar_days(symbol)) {
+            if (day >= first_day && day <= last_day) {
+                BarFile file = store.read_bars(symbol, day);
+                events += file.size();
+                day_of(day).bars.emplace_back(id, std::move(file));
+            }
+        }
+        for (std::int32_t day : store.option_quote_days(symbol)) {
+            if (day >= first_day && day <= last_day) {
+                OptionQuoteFile file = store.read_option_quotes(symbol, day);
+                events += file.size();
+                day_of(day).quotes.emplace_back(id, std::move(file));
+            }
+        }
+    }
+    stored_days.reserve(by_day.size());
+    for (auto& entry : by_day) {
+        stored_days.push_back(std::move(entry.second));
+    }
+}
+
+double QuoteState::mid() const {
+    if (!std::isfinite(bid) || !std::isfinite(ask) || bid < 0.0 ||
+        ask <= 0.0) {
+        return MISSING;
+    }
+    return 0.5 * (bid + ask);
+}
+
+void MarketState::update(const BarEvent& bar) {
+    set_spot(bar.symbol, bar.close);
+}
+
+void MarketState::update(const OptionQuoteEvent& quote) {
+    quotes[quote.contract] = {quote.bid, quote.ask,
+                              known_size(quote.bid_size),
+                              known_size(quote.ask_size), quote.timestamp_ns};
+    if (std::isfinite(quote.underlying_price)) {
+        set_spot(quote.contract.underlying, quote.underlying_price);
+    }
+}
+
+double MarketState::spot(SymbolId symbol) const {
+    return symbol < spots.size() ? spots[symbol] : MISSING;
+}
+
+const QuoteState* MarketState::quote(const ContractKey& contract) const {
+    auto found = quotes.find(contract);
+    return found == quotes.end() ? nullptr : &found->second;
+}
+
+QuoteState* MarketState::quote(const ContractKey& contract) {
+    auto found = quotes.find(contract);
+    return found == quotes.end() ? nullptr : &found->second;
+}
+
+void MarketState::clear() {
+    spots.clear();
+    quotes.clear();
+}
+
+void MarketState::set_spot(SymbolId symbol, double price) {
+    if (symbol >= spots.size()) {
+        spots.resize(symbol + 1, MISSING);
+    }
+    spots[symbol] = price;
+}
+
+Ledger::Ledger(double cash) : book(cash), balance(cash) {}
+
+void Ledger::apply(const Order& fill, double commission) {
+    if (fill.get_quantity() <= 0) {
+        throw std::invalid_argument("Fill quantity must be positive");
+    }
+    auto [entry, inserted] = rows.try_emplace(contract_of(fill), book.size());
+    if (inserted) {
+        book.add_position(Position(fill.get_symbol_id(), fill.get_type(),
+                                   fill.get_strike_price(),
+                                   fill.get_expiration(), 0, 0.0));
+    }
+    int quantity = fill.get_side() == Side::BUY ? fill.get_quantity()
+                                                : -fill.get_quantity();
+    balance -= quantity * fill.get_premium() * CONTRACT_MULTIPLIER +
+               commission;
+    fees += commission;
+    trade(entry->second, quantity, fill.get_premium());
+    executions.push_back(fill);
+    book.set_net_liquidity(balance + cost_basis);
+}
+
+void Ledger::trade(std::size_t row, int quantity, double price) {
+    int held = book.get_quantities()[row];
+    double average = book.get_premiums()[row];
+    double previous_cost = held * average * CONTRACT_MULTIPLIER;
+    realized += book_trade(held, average, quantity, price);
+    cost_basis += held * average * CONTRACT_MULTIPLIER - previous_cost;
+    book.set_position(row, held, average);
+}
+
+void Ledger::settle_expired(std::int32_t day, const MarketState& market) {
+    const std::pmr::vector<int>& quantities = book.get_quantities();
+    for (std::size_t row = 0; row < book.size(); ++row) {
+        int held = quantities[row];
+        if (held == 0 || book.get_expirations()[row] >= day) {
+            continue;
+        }
+        double spot = market.spot(book.get_symbol_ids()[row]);
+        double strike = book.get_strikes()[row];
+        double intrinsic = 0.0;
+        if (std::isfinite(spot)) {
+            intrinsic = book.get_types()[row] == CALL
+                            ? std::max(0.0, spot - strike)
+                            : std::max(0.0, strike - spot);
+        }
+        balance += held * intrinsic * CONTRACT_MULTIPLIER;
+        trade(row, -held, intrinsic);
+    }
+    book.set_net_liquidity(balance + cost_basis);
+}
+
+int Ledger::quantity(const ContractKey& contract) const {
+    auto found = rows.find(contract);
+    return found == rows.end() ? 0 : book.get_quantities()[found->second];
+}
+
+double Ledger::equity(const MarketState& market) const {
+    double total = balance;
+    for (std::size_t row = 0; row < book.size(); ++row) {
+        int held = book.get_quantities()[row];
+        if (held == 0) {
+            continue;
+        }
+        ContractKey contract{book.get_symbol_ids()[row],
+                             book.get_expirations()[row],
+                             book.get_types()[row], book.get_strikes()[row]};
+        const QuoteState* quote = market.quote(contract);
+        double mark = quote != nullptr ? quote->mid() : MISSING;
+        if (std::isnan(mark)) {
+            mark = book.get_premiums()[row];
+        }
+        total += held * mark * CONTRACT_MULTIPLIER;
+    }
+    return total;
+}
+
+Backtester::Backtester(const BacktestData& data,
+                       const BacktestSettings& settings)
+    : data(data), settings(settings), book(settings.initial_cash) {}
+
+BacktestResult Backtester::run(Strategy& strategy) {
+    state.clear();
+    book = Ledger(settings.initial_cash);
+    working.clear();
+    timestamp = 0;
+
+    BacktestResult result;
+    result.days.reserve(data.days().size());
+    result.daily_equity.reserve(data.days().size());
+    double peak = settings.initial_cash;
+
+    strategy.on_start(*this);
+    for (const BacktestData::Day& day : data.days()) {
+        book.settle_expired(day.day, state);
+        replay_day(day, strategy, result);
+        double equity = book.equity(state);
+        result.days.push_back(day.day);
+        result.daily_equity.push_back(equity);
+        peak = std::max(peak, equity);
+        result.max_drawdown = std::max(result.max_drawdown, peak - equity);
+    }
+    strategy.on_finish(*this);
+
+    result.final_equity = book.equity(state);
+    result.cash = book.cash();
+    result.realized_pnl = book.realized_pnl();
+    result.commissions = book.commissions();
+    result.fills = book.fills().size();
+    return result;
+}
+
+void Backtester::submit(const OrderRequest& order) {
+    if (order.quantity <= 0) {
+        throw std::invalid_argument("Order quantity must be positive");
+    }
+    working.push_back(order);
+}
+
+void Backtester::replay_day(const BacktestData::Day& day, Strategy& strategy,
+                            BacktestResult& result) {
+    // A day holds a handful of files, so a linear scan for the earliest
+    // head beats maintaining a heap
+    std::vector<Cursor> cursors;
+    cursors.reserve(day.bars.size() + day.quotes.size());
+    for (std::size_t i = 0; i < day.bars.size(); ++i) {
+        const BarFile& file = day.bars[i].second;
+        cursors.push_back({file.timestamp_ns(), 0, file.size(), i, false});
+    }
+    for (std::size_t i = 0; i < day.quotes.size(); ++i) {
+        const OptionQuoteFile& file = day.quotes[i].second;
+        cursors.push_back({file.timestamp_ns(), 0, file.size(), i, true});
+    }
+
+    const std::int64_t END = std::numeric_limits<std::int64_t>::max();
+    for (;;) {
+        std::int64_t next = END;
+        for (const Cursor& cursor : cursors) {
+            if (cursor.row < cursor.rows) {
+                next = std::min(next, cursor.timestamps[cursor.row]);
+            }
+        }
+        if (next == END) {
+            break;
+        }
+
+        batch.timestamp_ns = next;
+        batch.bars.clear();
+        batch.quotes.clear();
+        for (Cursor& cursor : cursors) {
+            for (; cursor.row < cursor.rows &&
+                   cursor.timestamps[cursor.row] == next;
+                 ++cursor.row) {
+                std::size_t row = cursor.row;
+                if (cursor.quotes) {
+                    const auto& [symbol, file] = day.quotes[cursor.file];
+                    batch.quotes.push_back(
+                        {{symbol, file.expiration()[row], file.type()[row],
+                          file.strike()[row]},
+                         next,
+                         file.bid()[row],
+                         file.ask()[row],
+                         file.bid_size()[row],
+                         file.ask_size()[row],
+                         file.implied_volatility()[row],
+                         file.underlying_price()[row]});
+                } else {
+                    const auto& [symbol, file] = day.bars[cursor.file];
+                    batch.bars.push_back(
+                        {symbol, next, file.open()[row], file.high()[row],
+                         file.low()[row], file.close()[row],
+                         file.volume()[row], file.vwap()[row]});
+                }
+            }
+        }
+
+        timestamp = next;
+        for (const BarEvent& bar : batch.bars) {
+            state.update(bar);
+        }
+        for (const OptionQuoteEvent& quote : batch.quotes) {
+            state.update(quote);
+        }
+        match_orders();
+        strategy.on_events(batch, *this);
+        result.events += batch.size();
+        ++result.batches;
+    }
+}
+
+void Backtester::match_orders() {
+    std::size_t kept = 0;
+    for (OrderRequest& order : working) {
+        QuoteState* quote = state.quote(order.contract);
+        if (quote != nullptr) {
+            bool buy = order.side == Side::BUY;
+            double price = buy ? quote->ask : quote->bid;
+            std::uint32_t& size = buy ? quote->ask_size : quote->bid_size;
+            bool marketable =
+                std::isfinite(price) && price > 0.0 && size > 0 &&
+                (std::isnan(order.limit_price) ||
+                 (buy ? price <= order.limit_price
+                      : price >= order.limit_price));
+            if (marketable) {
+                int quantity = order.quantity;
+                if (settings.respect_quote_size &&
+                    size != UNKNOWN_QUOTE_SIZE) {
+                    quantity = static_cast<int>(
+                        std::min<std::uint32_t>(size, quantity));
+                    size -= quantity;
+                }
+                const ContractKey& contract = order.contract;
+                book.apply(Order(order.side, contract.underlying,
+                                 contract.type, contract.strike,
+                                 contract.expiration, quantity, price,
+                                 timestamp),
+                           quantity * settings.commission_per_contract);
+                order.quantity -= quantity;
+            }
+        }
+        if (order.quantity > 0) {
+            working[kept++] = order;
+        }
+    }
+    working.resize(kept);
+}
+
+std::vector<BacktestResult> run_parameter_sweep(
+    const BacktestData& data, std::size_t configurations,
+    const std::function<std::unique_ptr<Strategy>(std::size_t)>&
+        make_strategy,
+    ThreadPool& pool, const BacktestSettings& settings) {
+    std::vector<BacktestResult> results(configurations);
+    pool.parallel_for(configurations, [&](std::size_t index, std::size_t) {
+        std::unique_ptr<Strategy> strategy = make_strategy(index);
+        Backtester backtester(data, settings);
+        results[index] = backtester.run(*strategy);
+    });
+    return results;
+}
+
+}  // namespace thales
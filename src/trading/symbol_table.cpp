@@ -0,0 +1,86 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "trading/symbol_table.h"
+
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace thales {
+
+namespace {
+
+/**
+ * @brief Storage behind SymbolTable.
+ *
+ * A deque keeps references to names stable as new symbols are appended, and
+ * the map keys view into those names so each symbol is stored once.
+ */
+struct Symbols {
+    std::mutex mutex;
+    std::deque<std::string> names;
+    std::unordered_map<std::string_view, SymbolId> ids;
+};
+
+Symbols& symbols() {
+    static Symbols instance;
+    return instance;
+}
+
+}  // namespace
+
+SymbolId SymbolTable::intern(std::string_view symbol) {
+    Symbols& table = symbols();
+    std::lock_guard<std::mutex> lock(table.mutex);
+
+    auto it = table.ids.find(symbol);
+    if (it != table.ids.end()) {
+        return it->second;
+    }
+
+    const SymbolId id = static_cast<SymbolId>(table.names.size());
+    table.names.emplace_back(symbol);
+    table.ids.emplace(table.names.back(), id);
+    return id;
+}
+
+const std::string& SymbolTable::name(SymbolId id) {
+    Symbols& table = symbols();
+    std::lock_guard<std::mutex> lock(table.mutex);
+
+    if (id >= table.names.size()) {
+        throw std::out_of_range("Unknown symbol ID");
+    }
+    return table.names[id];
+}
+
+std::size_t SymbolTable::size() {
+    Symbols& table = symbols();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    return table.names.size();
+}
+
+}  // namespace thales
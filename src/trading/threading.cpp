@@ -0,0 +1,79 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "trading/threading.h"
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace thales {
+
+namespace {
+
+/**
+ * @brief Reads <role>_CPUS and, for threads that poll, <role>_WAIT.
+ */
+void load_placement(const ConfigSnapshot& config, const std::string& role,
+                    bool polls, ThreadPlacement& placement) {
+    const char* section = ThreadingSettings::CONFIG_SECTION;
+    try {
+        if (const ConfigValue* cpus = config.find(section, role + "_CPUS")) {
+            placement.cpus = parse_cpu_list(cpus->text());
+        }
+        const ConfigValue* mode =
+            polls ? config.find(section, role + "_WAIT") : nullptr;
+        if (mode) {
+            placement.wait.mode = parse_wait_mode(mode->text());
+        }
+    } catch (const std::invalid_argument& e) {
+        throw std::invalid_argument(std::string(section) + ".cfg " + role +
+                                    ": " + e.what());
+    }
+    std::int64_t spin = config.get_int(section, "SPIN_ITERATIONS",
+                                       placement.wait.spin_iterations);
+    std::int64_t park =
+        config.get_int(section, "PARK_US", placement.wait.park.count());
+    if (spin < 0 || spin > std::numeric_limits<int>::max() || park < 0) {
+        throw std::invalid_argument("Invalid wait settings in " +
+                                    std::string(section) + ".cfg");
+    }
+    placement.wait.spin_iterations = static_cast<int>(spin);
+    placement.wait.park = std::chrono::microseconds(park);
+}
+
+}  // namespace
+
+ThreadingSettings ThreadingSettings::load(const ConfigSnapshot& config) {
+    ThreadingSettings settings;
+    load_placement(config, "MARKET_DATA", true, settings.market_data);
+    load_placement(config, "PRICING", false, settings.pricing);
+    load_placement(config, "ORDER_MANAGER", true, settings.order_manager);
+    load_placement(config, "LOGGING", false, settings.logging);
+    load_placement(config, "MAIN_LOOP", true, settings.main_loop);
+    return settings;
+}
+
+}  // namespace thales
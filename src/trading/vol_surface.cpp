@@ -0,0 +1,563 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "trading/vol_surface.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <stdexcept>
+
+#include "data/market_data.h"
+#include "implied_volatility.h"
+#include "option_chain.h"
+#include "utils/metrics.h"
+
+namespace thales {
+
+namespace {
+
+constexpr double DAYS_PER_YEAR = 365.0;
+
+/** Log-moneyness added on both sides of the quotes when tabulating. */
+constexpr double GRID_MARGIN = 0.2;
+
+constexpr int MAX_SIMPLEX_ITERATIONS = 200;
+
+/**
+ * @brief Best (a, b, rho) for a fixed (m, sigma), as a + d y + c z with
+ * y = (k - m) / sigma, z = sqrt(y^2 + 1), c = b sigma and d = rho b sigma.
+ */
+struct InnerFit {
+    double a = 0.0;
+    double c = 0.0;
+    double d = 0.0;
+    double error = std::numeric_limits<double>::infinity();
+};
+
+/**
+ * @brief Solves a 3x3 system in place by Gaussian elimination.
+ * @return False if the matrix is singular.
+ */
+bool solve3(double A[3][3], double b[3], double x[3]) {
+    for (int col = 0; col < 3; ++col) {
+        int pivot = col;
+        for (int row = col + 1; row < 3; ++row) {
+            if (std::abs(A[row][col]) > std::abs(A[pivot][col])) {
+                pivot = row;
+            }
+        }
+        if (std::abs(A[pivot][col]) < 1e-300) {
+            return false;
+        }
+        std::swap(A[col], A[pivot]);
+        std::swap(b[col], b[pivot]);
+        for (int row = col + 1; row < 3; ++row) {
+            double factor = A[row][col] / A[col][col];
+            for (int j = col; j < 3; ++j) {
+                A[row][j] -= factor * A[col][j];
+            }
+            b[row] -= factor * b[col];
+        }
+    }
+    for (int row = 2; row >= 0; --row) {
+        double sum = b[row];
+        for (int j = row + 1; j < 3; ++j) {
+            sum -= A[row][j] * x[j];
+        }
+        x[row] = sum / A[row][row];
+    }
+    return true;
+}
+
+InnerFit fit_inner(const double* k, const double* w, const double* weights,
+                   std::size_t size, double m, double sigma) {
+    double A[3][3] = {};
+    double rhs[3] = {};
+    double total_weight = 0.0;
+    for (std::size_t i = 0; i < size; ++i) {
+        double y = (k[i] - m) / sigma;
+        double basis[3] = {1.0, y, std::sqrt(y * y + 1.0)};
+        double weight = weights != nullptr ? weights[i] : 1.0;
+        total_weight += weight;
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) {
+                A[r][c] += weight * basis[r] * basis[c];
+            }
+            rhs[r] += weight * basis[r] * w[i];
+        }
+    }
+
+    InnerFit fit;
+    double x[3];
+    if (solve3(A, rhs, x)) {
+        fit.a = x[0];
+        fit.d = x[1];
+        fit.c = x[2];
+    }
+
+    // Keep b >= 0 and |rho| <= 1, re-levelling a after any projection
+    double c = std::max(fit.c, 0.0);
+    double d = std::clamp(fit.d, -c, c);
+    if (c != fit.c || d != fit.d || !std::isfinite(fit.a)) {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < size; ++i) {
+            double y = (k[i] - m) / sigma;
+            double weight = weights != nullptr ? weights[i] : 1.0;
+            sum += weight * (w[i] - d * y - c * std::sqrt(y * y + 1.0));
+        }
+        fit.a = total_weight > 0.0 ? sum / total_weight : 0.0;
+        fit.c = c;
+        fit.d = d;
+    }
+    // The smile's minimum, a + sqrt(c^2 - d^2), must not go negative
+    fit.a = std::max(fit.a, -std::sqrt(std::max(c * c - d * d, 0.0)));
+
+    fit.error = 0.0;
+    for (std::size_t i = 0; i < size; ++i) {
+        double y = (k[i] - m) / sigma;
+        double model = fit.a + fit.d * y + fit.c * std::sqrt(y * y + 1.0);
+        double weight = weights != nullptr ? weights[i] : 1.0;
+        fit.error += weight * (model - w[i]) * (model - w[i]);
+    }
+    return fit;
+}
+
+}  // namespace
+
+double SviParameters::total_variance(double k) const {
+    double x = k - m;
+    return a + b * (rho * x + std::sqrt(x * x + sigma * sigma));
+}
+
+SviParameters fit_svi(const double* k, const double* w, const double* weights,
+                      std::size_t size, const SviParameters& guess) {
+    if (size == 0) {
+        throw std::invalid_argument("SVI fit needs at least one point");
+    }
+    if (size < 5) {
+        double sum = 0.0;
+        double total = 0.0;
+        for (std::size_t i = 0; i < size; ++i) {
+            double weight = weights != nullptr ? weights[i] : 1.0;
+            sum += weight * w[i];
+            total += weight;
+        }
+        SviParameters flat;
+        flat.a = total > 0.0 ? sum / total : w[0];
+        return flat;
+    }
+
+    // Nelder-Mead over (m, log sigma); sigma stays within [1e-4, 10]
+    const double LOG_SIGMA_MIN = std::log(1e-4);
+    const double LOG_SIGMA_MAX = std::log(10.0);
+    auto objective = [&](const double* x) {
+        double log_sigma = std::clamp(x[1], LOG_SIGMA_MIN, LOG_SIGMA_MAX);
+        return fit_inner(k, w, weights, size, x[0], std::exp(log_sigma))
+            .error;
+    };
+    double sigma = guess.sigma > 0.0 ? guess.sigma : 0.1;
+    double simplex[3][2] = {{guess.m, std::log(sigma)},
+                            {guess.m + 0.1, std::log(sigma)},
+                            {guess.m, std::log(sigma) + 0.5}};
+    double values[3];
+    for (int i = 0; i < 3; ++i) {
+        values[i] = objective(simplex[i]);
+    }
+    for (int iteration = 0; iteration < MAX_SIMPLEX_ITERATIONS; ++iteration) {
+        int order[3] = {0, 1, 2};
+        std::sort(order, order + 3,
+                  [&](int a, int b) { return values[a] < values[b]; });
+        int best = order[0];
+        int middle = order[1];
+        int worst = order[2];
+        if (values[worst] - values[best] <=
+            1e-14 * (1.0 + std::abs(values[best]))) {
+            break;
+        }
+
+        double centroid[2];
+        for (int j = 0; j < 2; ++j) {
+            centroid[j] = 0.5 * (simplex[best][j] + simplex[middle][j]);
+        }
+        auto towards = [&](double t, double* out) {
+            for (int j = 0; j < 2; ++j) {
+                out[j] = centroid[j] + t * (simplex[worst][j] - centroid[j]);
+            }
+        };
+        double reflected[2];
+        towards(-1.0, reflected);
+        double reflected_value = objective(reflected);
+        if (reflected_value < values[best]) {
+            double expanded[2];
+            towards(-2.0, expanded);
+            double expanded_value = objective(expanded);
+            bool expand = expanded_value < reflected_value;
+            std::copy_n(expand ? expanded : reflected, 2, simplex[worst]);
+            values[worst] = expand ? expanded_value : reflected_value;
+        } else if (reflected_value < values[middle]) {
+            std::copy_n(reflected, 2, simplex[worst]);
+            values[worst] = reflected_value;
+        } else {
+            double contracted[2];
+            towards(0.5, contracted);
+            double contracted_value = objective(contracted);
+            if (contracted_value < values[worst]) {
+                std::copy_n(contracted, 2, simplex[worst]);
+                values[worst] = contracted_value;
+            } else {
+                for (int i : {middle, worst}) {
+                    for (int j = 0; j < 2; ++j) {
+                        simplex[i][j] = simplex[best][j] +
+                                        0.5 * (simplex[i][j] -
+                                               simplex[best][j]);
+                    }
+                    values[i] = objective(simplex[i]);
+                }
+            }
+        }
+    }
+
+    int best = static_cast<int>(std::min_element(values, values + 3) -
+                                values);
+    double m = simplex[best][0];
+    sigma = std::exp(std::clamp(simplex[best][1], LOG_SIGMA_MIN,
+                                LOG_SIGMA_MAX));
+    InnerFit inner = fit_inner(k, w, weights, size, m, sigma);
+    SviParameters fit;
+    fit.a = inner.a;
+    fit.b = inner.c / sigma;
+    fit.rho = inner.c > 0.0 ? inner.d / inner.c : 0.0;
+    fit.m = m;
+    fit.sigma = sigma;
+    return fit;
+}
+
+VolSurface::VolSurface(double spot, double rate,
+                       SurfaceInterpolation interpolation)
+    : spot(0.0), rate(rate), interpolation(interpolation) {
+    set_spot(spot);
+}
+
+void VolSurface::set_spot(double spot) {
+    if (!(spot > 0.0) || !std::isfinite(spot)) {
+        throw std::invalid_argument("Spot must be positive");
+    }
+    this->spot = spot;
+}
+
+std::size_t VolSurface::slice_index(double expiry) {
+    if (!(expiry > 0.0) || !std::isfinite(expiry)) {
+        throw std::invalid_argument("Expiry must be positive");
+    }
+    auto found = std::lower_bound(
+        slices.begin(), slices.end(), expiry,
+        [](const Slice& slice, double t) { return slice.expiry < t; });
+    std::size_t index = static_cast<std::size_t>(found - slices.begin());
+    if (found == slices.end() || found->expiry != expiry) {
+        Slice slice;
+        slice.expiry = expiry;
+        slices.insert(found, slice);
+        grid.insert(grid.begin() + index * VOL_GRID_POINTS, VOL_GRID_POINTS,
+                    0.0);
+        for (std::size_t& i : fitted) {
+            i += i >= index ? 1 : 0;
+        }
+    }
+    return index;
+}
+
+void VolSurface::set_quotes(double expiry,
+                            const std::vector<SmileQuote>& quotes) {
+    for (const SmileQuote& quote : quotes) {
+        if (!(quote.strike > 0.0) || !(quote.volatility > 0.0) ||
+            !std::isfinite(quote.volatility) || !(quote.weight >= 0.0)) {
+            throw std::invalid_argument("Invalid smile quote");
+        }
+    }
+    Slice& slice = slices[slice_index(expiry)];
+    slice.quotes = quotes;
+    std::stable_sort(slice.quotes.begin(), slice.quotes.end(),
+                     [](const SmileQuote& a, const SmileQuote& b) {
+                         return a.strike < b.strike;
+                     });
+    // Keep the last quote given for a strike
+    std::vector<SmileQuote> unique;
+    unique.reserve(slice.quotes.size());
+    for (const SmileQuote& quote : slice.quotes) {
+        if (!unique.empty() && unique.back().strike == quote.strike) {
+            unique.back() = quote;
+        } else {
+            unique.push_back(quote);
+        }
+    }
+    slice.quotes.swap(unique);
+    slice.stale = true;
+}
+
+void VolSurface::update_quote(double expiry, const SmileQuote& quote) {
+    if (!(quote.strike > 0.0) || !(quote.volatility > 0.0) ||
+        !std::isfinite(quote.volatility) || !(quote.weight >= 0.0)) {
+        throw std::invalid_argument("Invalid smile quote");
+    }
+    METRIC_COUNT("thales_quotes_processed_total",
+                 "Underlying and option quotes applied", 1);
+    Slice& slice = slices[slice_index(expiry)];
+    auto found = std::lower_bound(
+        slice.quotes.begin(), slice.quotes.end(), quote.strike,
+        [](const SmileQuote& q, double strike) { return q.strike < strike; });
+    if (found != slice.quotes.end() && found->strike == quote.strike) {
+        *found = quote;
+    } else {
+        slice.quotes.insert(found, quote);
+    }
+    slice.stale = true;
+}
+
+std::size_t VolSurface::refresh() {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < slices.size(); ++i) {
+        if (slices[i].stale) {
+            fit(i);
+            ++count;
+        }
+    }
+    if (count > 0) {
+        fitted.clear();
+        for (std::size_t i = 0; i < slices.size(); ++i) {
+            if (slices[i].fitted) {
+                fitted.push_back(i);
+            }
+        }
+    }
+    return count;
+}
+
+void VolSurface::fit(std::size_t index) {
+    Slice& slice = slices[index];
+    slice.stale = false;
+    std::size_t size = slice.quotes.size();
+    if (size == 0) {
+        slice.fitted = false;
+        return;
+    }
+
+    double forward = spot * std::exp(rate * slice.expiry);
+    std::vector<double> k(size);
+    std::vector<double> w(size);
+    std::vector<double> weights(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        const SmileQuote& quote = slice.quotes[i];
+        k[i] = std::log(quote.strike / forward);
+        w[i] = quote.volatility * quote.volatility * slice.expiry;
+        weights[i] = quote.weight;
+    }
+
+    // Warm-start from the previous fit; otherwise centre on the lowest
+    // variance quote
+    SviParameters guess = slice.fit;
+    if (!slice.fitted) {
+        guess.m = k[std::min_element(w.begin(), w.end()) - w.begin()];
+        guess.sigma = 0.1;
+    }
+    slice.fit = fit_svi(k.data(), w.data(), weights.data(), size, guess);
+
+    slice.k_min = k.front() - GRID_MARGIN;
+    slice.k_step = (k.back() - k.front() + 2.0 * GRID_MARGIN) /
+                   static_cast<double>(VOL_GRID_POINTS - 1);
+    double* nodes = &grid[index * VOL_GRID_POINTS];
+    for (std::size_t i = 0; i < VOL_GRID_POINTS; ++i) {
+        double node = slice.k_min + static_cast<double>(i) * slice.k_step;
+        nodes[i] = std::max(slice.fit.total_variance(node), 0.0);
+    }
+    slice.fitted = true;
+}
+
+double VolSurface::slice_variance(std::size_t index, double k) const {
+    const Slice& slice = slices[index];
+    double u = (k - slice.k_min) / slice.k_step;
+    if (!(u >= 0.0 && u <= static_cast<double>(VOL_GRID_POINTS - 1))) {
+        return std::max(slice.fit.total_variance(k), 0.0);
+    }
+    std::size_t i = std::min(static_cast<std::size_t>(u), VOL_GRID_POINTS - 2);
+    double t = u - static_cast<double>(i);
+    const double* g = &grid[index * VOL_GRID_POINTS];
+    if (interpolation == SurfaceInterpolation::BILINEAR) {
+        return g[i] + t * (g[i + 1] - g[i]);
+    }
+    double p0 = g[i > 0 ? i - 1 : 0];
+    double p1 = g[i];
+    double p2 = g[i + 1];
+    double p3 = g[std::min(i + 2, VOL_GRID_POINTS - 1)];
+    double value =
+        p1 + 0.5 * t *
+                 ((p2 - p0) +
+                  t * ((2.0 * p0 - 5.0 * p1 + 4.0 * p2 - p3) +
+                       t * (3.0 * (p1 - p2) + p3 - p0)));
+    return std::max(value, 0.0);
+}
+
+double VolSurface::volatility(double strike, double expiry) const {
+    if (fitted.empty()) {
+        throw std::runtime_error("Volatility surface has no fitted slice");
+    }
+    double k = std::log(strike / spot) - rate * expiry;
+    auto after = std::upper_bound(
+        fitted.begin(), fitted.end(), expiry,
+        [&](double t, std::size_t i) { return t < slices[i].expiry; });
+    if (after == fitted.begin() || after == fitted.end()) {
+        // Flat volatility outside the quoted expiries
+        std::size_t i = after == fitted.begin() ? fitted.front()
+                                                : fitted.back();
+        return std::sqrt(slice_variance(i, k) / slices[i].expiry);
+    }
+    std::size_t i0 = *(after - 1);
+    std::size_t i1 = *after;
+    double t0 = slices[i0].expiry;
+    double t1 = slices[i1].expiry;
+    double w0 = slice_variance(i0, k);
+    double w1 = slice_variance(i1, k);
+    double w = w0 + (w1 - w0) * (expiry - t0) / (t1 - t0);
+    return std::sqrt(std::max(w, 0.0) / expiry);
+}
+
+void VolSurface::volatilities(const double* strikes, const double* expiries,
+                              double* vols, std::size_t size) const {
+    for (std::size_t i = 0; i < size; ++i) {
+        vols[i] = volatility(strikes[i], expiries[i]);
+    }
+}
+
+namespace {
+
+/**
+ * @brief Loads the quotes at the rows that visit(fn) passes to fn, which
+ * only admits out-of-the-money options of the underlying.
+ */
+template <typename Visit>
+std::size_t load_rows(VolSurface& surface, const OptionChainColumns& chain,
+                      SymbolId underlying, std::int32_t valuation_date,
+                      Visit visit) {
+    std::vector<double> S;
+    std::vector<double> K;
+    std::vector<double> T;
+    std::vector<double> r;
+    std::vector<OptionType> type;
+    std::vector<double> prices;
+    std::vector<double> weights;
+    double spot = surface.get_spot();
+    double rate = surface.get_rate();
+    visit([&](std::size_t i) {
+        double bid = chain.bid[i];
+        double ask = chain.ask[i];
+        double days = chain.expiration[i] - valuation_date + 1;
+        if (chain.underlying[i] != underlying || !(days > 0) ||
+            !(bid >= 0.0) || !(ask > bid) || !(chain.strike[i] > 0.0)) {
+            return;
+        }
+        double expiry = days / DAYS_PER_YEAR;
+        double forward = spot * std::exp(rate * expiry);
+        OptionType otm = chain.strike[i] >= forward ? CALL : PUT;
+        if (chain.type[i] != otm) {
+            return;
+        }
+        S.push_back(spot);
+        K.push_back(chain.strike[i]);
+        T.push_back(expiry);
+        r.push_back(rate);
+        type.push_back(otm);
+        prices.push_back(0.5 * (bid + ask));
+        weights.push_back(1.0 / std::max(ask - bid, 0.01));
+    });
+
+    std::vector<double> vols(prices.size());
+    OptionBatch batch = {S.data(), K.data(), T.data(), r.data(),
+                         nullptr,  type.data(), prices.size()};
+    ImpliedVolatility::calculate_implied_volatilities(batch, prices.data(),
+                                                      vols.data());
+
+    std::map<double, std::vector<SmileQuote>> slices;
+    std::size_t loaded = 0;
+    for (std::size_t i = 0; i < vols.size(); ++i) {
+        if (std::isfinite(vols[i]) && vols[i] > 0.0) {
+            slices[T[i]].push_back({K[i], vols[i], weights[i]});
+            ++loaded;
+        }
+    }
+    for (const auto& [expiry, quotes] : slices) {
+        surface.set_quotes(expiry, quotes);
+    }
+    return loaded;
+}
+
+}  // namespace
+
+std::size_t load_option_chain(VolSurface& surface,
+                              const OptionChainColumns& chain,
+                              SymbolId underlying,
+                              std::int32_t valuation_date) {
+    return load_rows(surface, chain, underlying, valuation_date,
+                     [&](auto load) {
+                         for (std::size_t i = 0; i < chain.size(); ++i) {
+                             load(i);
+                         }
+                     });
+}
+
+std::size_t load_option_chain(VolSurface& surface,
+                              const OptionChainColumns& chain,
+                              const OptionChainIndex& index,
+                              SymbolId underlying,
+                              std::int32_t valuation_date) {
+    double spot = surface.get_spot();
+    double rate = surface.get_rate();
+    return load_rows(
+        surface, chain, underlying, valuation_date, [&](auto load) {
+            const OptionChainIndex::Expiry* expiries = nullptr;
+            std::size_t count = index.expiries(underlying, &expiries);
+            for (std::size_t e = 0; e < count; ++e) {
+                const OptionChainIndex::Expiry& expiry = expiries[e];
+                double days = expiry.expiration - valuation_date + 1;
+                if (!(days > 0)) {
+                    continue;
+                }
+                // Calls at or above the forward, puts below it
+                double forward =
+                    spot * std::exp(rate * (days / DAYS_PER_YEAR));
+                auto calls = index.strike_range(
+                    expiry, CALL, forward,
+                    std::numeric_limits<double>::infinity());
+                auto puts = index.strike_range(expiry, PUT, 0.0,
+                                               std::nextafter(forward, 0.0));
+                for (auto [begin, end] : {calls, puts}) {
+                    for (std::size_t entry = begin; entry < end; ++entry) {
+                        load(index.source(entry));
+                    }
+                }
+            }
+        });
+}
+
+}  // namespace thales
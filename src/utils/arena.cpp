@@ -0,0 +1,110 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "utils/arena.h"
+
+#include <cstdint>
+
+namespace thales {
+
+namespace {
+
+char* align_up(char* p, std::size_t alignment) {
+    auto address = reinterpret_cast<std::uintptr_t>(p);
+    address = (address + alignment - 1) & ~(std::uintptr_t(alignment) - 1);
+    return reinterpret_cast<char*>(address);
+}
+
+}  // namespace
+
+Arena::Arena(std::size_t block_size, std::pmr::memory_resource* upstream)
+    : upstream(upstream), next_size(block_size > 0 ? block_size : 1) {}
+
+Arena::~Arena() { release(); }
+
+void Arena::reset() {
+    current = first;
+    cursor = first != nullptr ? reinterpret_cast<char*>(first + 1) : nullptr;
+    end = first != nullptr ? cursor + first->size : nullptr;
+    used_bytes = 0;
+}
+
+void Arena::release() {
+    while (first != nullptr) {
+        Block* next = first->next;
+        upstream->deallocate(first, sizeof(Block) + first->size,
+                             alignof(std::max_align_t));
+        first = next;
+    }
+    current = nullptr;
+    cursor = end = nullptr;
+    used_bytes = capacity_bytes = blocks = 0;
+}
+
+void* Arena::do_allocate(std::size_t bytes, std::size_t alignment) {
+    char* p = align_up(cursor, alignment);
+    if (cursor == nullptr || p + bytes > end) {
+        next_block(bytes, alignment);
+        p = align_up(cursor, alignment);
+    }
+    cursor = p + bytes;
+    used_bytes += bytes;
+    return p;
+}
+
+void Arena::next_block(std::size_t bytes, std::size_t alignment) {
+    // Blocks kept from earlier cycles come first; one too small for this
+    // request is skipped until the next reset()
+    std::size_t needed = bytes + alignment;
+    Block* next = current != nullptr ? current->next : first;
+    while (next != nullptr && next->size < needed) {
+        next = next->next;
+    }
+    if (next == nullptr) {
+        std::size_t size = next_size;
+        while (size < needed) {
+            size *= 2;
+        }
+        next = static_cast<Block*>(upstream->allocate(
+            sizeof(Block) + size, alignof(std::max_align_t)));
+        next->size = size;
+        // Splice in after the current block so that blocks not yet reached
+        // this cycle stay reachable
+        if (current != nullptr) {
+            next->next = current->next;
+            current->next = next;
+        } else {
+            next->next = first;
+            first = next;
+        }
+        next_size = size * 2;
+        capacity_bytes += size;
+        ++blocks;
+    }
+    current = next;
+    cursor = reinterpret_cast<char*>(next + 1);
+    end = cursor + next->size;
+}
+
+}  // namespace thales
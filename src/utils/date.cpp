@@ -0,0 +1,233 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "utils/date.h"
+
+#include <stdexcept>
+
+namespace thales {
+
+namespace {
+
+constexpr std::int64_t NANOS_PER_SECOND = 1000000000;
+constexpr std::int64_t SECONDS_PER_DAY = 86400;
+
+/**
+ * @brief Days since 1970-01-01 of a proleptic Gregorian date.
+ *
+ * Howard Hinnant's days_from_civil algorithm.
+ */
+std::int32_t days_from_civil(int year, unsigned month, unsigned day) {
+    year -= month <= 2 ? 1 : 0;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned year_of_era = static_cast<unsigned>(year - era * 400);
+    const unsigned day_of_year =
+        (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned day_of_era = year_of_era * 365 + year_of_era / 4 -
+                                year_of_era / 100 + day_of_year;
+    return era * 146097 + static_cast<int>(day_of_era) - 719468;
+}
+
+/**
+ * @brief Proleptic Gregorian date of a day count since 1970-01-01.
+ */
+void civil_from_days(std::int32_t days, int& year, unsigned& month,
+                     unsigned& day) {
+    const std::int32_t z = days + 719468;
+    const std::int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned day_of_era = static_cast<unsigned>(z - era * 146097);
+    const unsigned year_of_era =
+        (day_of_era - day_of_era / 1460 + day_of_era / 36524 -
+         day_of_era / 146096) /
+        365;
+    const unsigned day_of_year =
+        day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    const unsigned mp = (5 * day_of_year + 2) / 153;
+    day = day_of_year - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = static_cast<int>(year_of_era) + era * 400 + (month <= 2 ? 1 : 0);
+}
+
+/**
+ * @brief Parses exactly @p count decimal digits starting at @p pos.
+ */
+unsigned parse_digits(std::string_view text, std::size_t pos,
+                      std::size_t count) {
+    if (pos + count > text.size()) {
+        throw std::invalid_argument("Malformed date: " + std::string(text));
+    }
+    unsigned value = 0;
+    for (std::size_t i = pos; i < pos + count; ++i) {
+        if (text[i] < '0' || text[i] > '9') {
+            throw std::invalid_argument("Malformed date: " +
+                                        std::string(text));
+        }
+        value = value * 10 + static_cast<unsigned>(text[i] - '0');
+    }
+    return value;
+}
+
+/**
+ * @brief Checks that @p text has @p separator at @p pos.
+ */
+void expect(std::string_view text, std::size_t pos, char separator) {
+    if (pos >= text.size() || text[pos] != separator) {
+        throw std::invalid_argument("Malformed date: " + std::string(text));
+    }
+}
+
+/**
+ * @brief Writes @p value as @p count zero-padded decimal digits.
+ */
+void write_digits(unsigned value, std::size_t count, char* out) {
+    for (std::size_t i = count; i-- > 0;) {
+        out[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+}
+
+/**
+ * @brief Floor division, so that pre-epoch instants map to the right day.
+ */
+std::int64_t floor_div(std::int64_t a, std::int64_t b) {
+    return a / b - ((a % b != 0 && (a < 0) != (b < 0)) ? 1 : 0);
+}
+
+}  // namespace
+
+std::int32_t parse_date(std::string_view date) {
+    const unsigned year = parse_digits(date, 0, 4);
+    expect(date, 4, '-');
+    const unsigned month = parse_digits(date, 5, 2);
+    expect(date, 7, '-');
+    const unsigned day = parse_digits(date, 8, 2);
+    if (date.size() != DATE_LENGTH) {
+        throw std::invalid_argument("Malformed date: " + std::string(date));
+    }
+
+    // Round-tripping rejects days past the end of the month, e.g. 02-30
+    const std::int32_t days =
+        days_from_civil(static_cast<int>(year), month, day);
+    int check_year;
+    unsigned check_month, check_day;
+    civil_from_days(days, check_year, check_month, check_day);
+    if (month < 1 || month > 12 || check_day != day || check_month != month) {
+        throw std::invalid_argument("Invalid date: " + std::string(date));
+    }
+    return days;
+}
+
+void format_date(std::int32_t days, char* out) {
+    int year;
+    unsigned month, day;
+    civil_from_days(days, year, month, day);
+    write_digits(static_cast<unsigned>(year), 4, out);
+    out[4] = '-';
+    write_digits(month, 2, out + 5);
+    out[7] = '-';
+    write_digits(day, 2, out + 8);
+}
+
+std::string format_date(std::int32_t days) {
+    std::string date(DATE_LENGTH, '\0');
+    format_date(days, &date[0]);
+    return date;
+}
+
+std::int64_t parse_timestamp(std::string_view timestamp) {
+    const std::int64_t days = parse_date(timestamp.substr(0, DATE_LENGTH));
+    expect(timestamp, 10, 'T');
+    const unsigned hours = parse_digits(timestamp, 11, 2);
+    expect(timestamp, 13, ':');
+    const unsigned minutes = parse_digits(timestamp, 14, 2);
+    expect(timestamp, 16, ':');
+    const unsigned seconds = parse_digits(timestamp, 17, 2);
+    if (hours > 23 || minutes > 59 || seconds > 60) {
+        throw std::invalid_argument("Invalid timestamp: " +
+                                    std::string(timestamp));
+    }
+
+    std::size_t pos = 19;
+    std::int64_t fraction = 0;
+    if (pos < timestamp.size() && timestamp[pos] == '.') {
+        std::size_t digits = 0;
+        for (++pos; pos < timestamp.size() && timestamp[pos] >= '0' &&
+                    timestamp[pos] <= '9';
+             ++pos, ++digits) {
+            if (digits < 9) {
+                fraction = fraction * 10 + (timestamp[pos] - '0');
+            }
+        }
+        if (digits == 0) {
+            throw std::invalid_argument("Malformed timestamp: " +
+                                        std::string(timestamp));
+        }
+        for (; digits < 9; ++digits) {
+            fraction *= 10;
+        }
+    }
+    if (pos < timestamp.size() && timestamp[pos] == 'Z') {
+        ++pos;
+    }
+    if (pos != timestamp.size()) {
+        throw std::invalid_argument("Malformed timestamp: " +
+                                    std::string(timestamp));
+    }
+
+    const std::int64_t total_seconds =
+        days * SECONDS_PER_DAY + hours * 3600 + minutes * 60 + seconds;
+    return total_seconds * NANOS_PER_SECOND + fraction;
+}
+
+std::size_t format_timestamp(std::int64_t nanoseconds, char* out) {
+    const std::int64_t total_seconds = floor_div(nanoseconds, NANOS_PER_SECOND);
+    const std::int64_t fraction =
+        nanoseconds - total_seconds * NANOS_PER_SECOND;
+    const std::int64_t days = floor_div(total_seconds, SECONDS_PER_DAY);
+    const std::int64_t seconds_of_day = total_seconds - days * SECONDS_PER_DAY;
+
+    format_date(static_cast<std::int32_t>(days), out);
+    out[10] = 'T';
+    write_digits(static_cast<unsigned>(seconds_of_day / 3600), 2, out + 11);
+    out[13] = ':';
+    write_digits(static_cast<unsigned>(seconds_of_day / 60 % 60), 2, out + 14);
+    out[16] = ':';
+    write_digits(static_cast<unsigned>(seconds_of_day % 60), 2, out + 17);
+
+    std::size_t length = 19;
+    if (fraction != 0) {
+        out[length++] = '.';
+        write_digits(static_cast<unsigned>(fraction), 9, out + length);
+        length += 9;
+    }
+    out[length++] = 'Z';
+    return length;
+}
+
+std::string format_timestamp(std::int64_t nanoseconds) {
+    char buffer[TIMESTAMP_LENGTH];
+    return std::string(buffer, format_timestamp(nanoseconds, buffer));
+}
+
+}  // namespace thales
@@ -26,34 +26,298 @@
 
 #include <curl/curl.h>
 
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+
+#include "utils/metrics.h"
+
 namespace thales {
-HttpClient::HttpClient() { curl_global_init(CURL_GLOBAL_DEFAULT); }
 
-HttpClient::~HttpClient() { curl_global_cleanup(); }
+namespace {
 
-std::string HttpClient::get(const std::string& url) {
-    std::string response;
-
-    CURL* curl = curl_easy_init();
-    if (curl) {
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-        curl_easy_setopt(
-            curl, CURLOPT_WRITEFUNCTION,
-            [](char* data, size_t size, size_t nmemb, std::string* response) {
-                response->append(data, size * nmemb);
-                return size * nmemb;
-            });
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-
-        CURLcode res = curl_easy_perform(curl);
-        if (res != CURLE_OK) {
-            // Handle error
+/** Number of latency samples kept for percentiles. */
+constexpr std::size_t LATENCY_SAMPLES = 4096;
+
+/** Upper bound on one curl_multi_poll() sleep, in milliseconds. */
+constexpr int POLL_TIMEOUT_MS = 1000;
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Initializes libcurl once per process.
+ *
+ * curl_global_cleanup() is deliberately never called: it is not thread-safe
+ * and would break any other client still alive.
+ */
+void global_init() {
+    static std::once_flag once;
+    std::call_once(once, [] {
+        if (curl_global_init(CURL_GLOBAL_DEFAULT) != CURLE_OK) {
+            throw std::runtime_error("Failed to initialize libcurl");
+        }
+    });
+}
+
+std::size_t write_body(char* data, std::size_t size, std::size_t nmemb,
+                       void* body) {
+    static_cast<std::string*>(body)->append(data, size * nmemb);
+    return size * nmemb;
+}
+
+/**
+ * @brief One request in flight, owned by the I/O thread once queued.
+ */
+struct Request {
+    std::string url;
+    std::promise<HttpResponse> promise;
+    HttpResponse response;
+    Clock::time_point start;
+    char error[CURL_ERROR_SIZE] = {};
+};
+
+}  // namespace
+
+struct HttpClient::Impl {
+    CURLM* multi = nullptr;
+    std::thread io;
+
+    std::mutex mutex;
+    std::deque<std::unique_ptr<Request>> queue; /**< Guarded by mutex */
+    bool stopping = false;                      /**< Guarded by mutex */
+
+    /** Easy handles ready for reuse; only touched by the I/O thread. */
+    std::vector<CURL*> idle;
+    /** Easy handles attached to the multi handle; I/O thread only. */
+    std::unordered_set<CURL*> in_flight;
+
+    mutable std::mutex stats_mutex;
+    std::vector<double> latencies; /**< Ring of recent samples */
+    std::size_t next_sample = 0;
+
+    void run();
+    void start(std::unique_ptr<Request> request);
+    void finish(CURL* easy, CURLcode result, const char* reason = nullptr);
+    void record(double latency_us);
+};
+
+void HttpClient::Impl::start(std::unique_ptr<Request> request) {
+    CURL* easy = nullptr;
+    if (idle.empty()) {
+        easy = curl_easy_init();
+    } else {
+        easy = idle.back();
+        idle.pop_back();
+        curl_easy_reset(easy);
+    }
+    if (easy == nullptr) {
+        request->response.error = "Failed to create curl handle";
+        request->promise.set_value(std::move(request->response));
+        return;
+    }
+
+    curl_easy_setopt(easy, CURLOPT_URL, request->url.c_str());
+    curl_easy_setopt(easy, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(easy, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(easy, CURLOPT_ACCEPT_ENCODING, "");
+    // HTTP/2 over TLS when offered; wait for a multiplexable connection
+    // rather than opening a new one per concurrent request
+    curl_easy_setopt(easy, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+    curl_easy_setopt(easy, CURLOPT_PIPEWAIT, 1L);
+    curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, write_body);
+    curl_easy_setopt(easy, CURLOPT_WRITEDATA, &request->response.body);
+    curl_easy_setopt(easy, CURLOPT_ERRORBUFFER, request->error);
+    curl_easy_setopt(easy, CURLOPT_PRIVATE, request.get());
+
+    if (curl_multi_add_handle(multi, easy) != CURLM_OK) {
+        idle.push_back(easy);
+        request->response.error = "Failed to queue request";
+        request->promise.set_value(std::move(request->response));
+        return;
+    }
+    // Owned by the easy handle until finish()
+    in_flight.insert(easy);
+    request.release();
+}
+
+void HttpClient::Impl::finish(CURL* easy, CURLcode result,
+                              const char* reason) {
+    Request* raw = nullptr;
+    curl_easy_getinfo(easy, CURLINFO_PRIVATE, &raw);
+    std::unique_ptr<Request> request(raw);
+
+    curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &request->response.status);
+    if (reason != nullptr) {
+        request->response.error = reason;
+    } else if (result != CURLE_OK) {
+        request->response.error = request->error[0] != '\0'
+                                      ? request->error
+                                      : curl_easy_strerror(result);
+    }
+    curl_multi_remove_handle(multi, easy);
+    in_flight.erase(easy);
+    idle.push_back(easy);
+
+    request->response.latency_us =
+        std::chrono::duration<double, std::micro>(Clock::now() -
+                                                   request->start)
+            .count();
+    record(request->response.latency_us);
+    METRIC_COUNT("thales_http_requests_total", "HTTP requests completed", 1);
+    if (!request->response.ok()) {
+        METRIC_COUNT("thales_http_errors_total",
+                     "HTTP requests that failed or returned an error status",
+                     1);
+    }
+    METRIC_RECORD_NS(
+        "thales_http_request_seconds", "HTTP request latency",
+        static_cast<std::int64_t>(request->response.latency_us * 1000.0));
+    request->promise.set_value(std::move(request->response));
+}
+
+void HttpClient::Impl::record(double latency_us) {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    if (latencies.size() < LATENCY_SAMPLES) {
+        latencies.push_back(latency_us);
+    } else {
+        latencies[next_sample] = latency_us;
+    }
+    next_sample = (next_sample + 1) % LATENCY_SAMPLES;
+}
+
+void HttpClient::Impl::run() {
+    std::deque<std::unique_ptr<Request>> incoming;
+    int running = 0;
+    while (true) {
+        bool stop = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            incoming.swap(queue);
+            stop = stopping;
+        }
+        if (stop) {
+            break;
         }
+        for (auto& request : incoming) {
+            start(std::move(request));
+        }
+        incoming.clear();
 
-        curl_easy_cleanup(curl);
+        curl_multi_perform(multi, &running);
+        int remaining = 0;
+        while (CURLMsg* message = curl_multi_info_read(multi, &remaining)) {
+            if (message->msg == CURLMSG_DONE) {
+                finish(message->easy_handle, message->data.result);
+            }
+        }
+        // Woken early by curl_multi_wakeup() when requests are queued
+        curl_multi_poll(multi, nullptr, 0, POLL_TIMEOUT_MS, nullptr);
     }
 
+    // Fail whatever is still queued or in flight
+    for (auto& request : incoming) {
+        request->response.error = "HttpClient destroyed";
+        request->promise.set_value(std::move(request->response));
+    }
+    std::vector<CURL*> active(in_flight.begin(), in_flight.end());
+    for (CURL* easy : active) {
+        finish(easy, CURLE_ABORTED_BY_CALLBACK, "HttpClient destroyed");
+    }
+}
+
+HttpClient::HttpClient(long max_connections_per_host)
+    : impl(std::make_unique<Impl>()) {
+    global_init();
+    impl->multi = curl_multi_init();
+    if (impl->multi == nullptr) {
+        throw std::runtime_error("Failed to create curl multi handle");
+    }
+    curl_multi_setopt(impl->multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    curl_multi_setopt(impl->multi, CURLMOPT_MAX_HOST_CONNECTIONS,
+                      max_connections_per_host);
+    impl->io = std::thread([this] { impl->run(); });
+}
+
+HttpClient::~HttpClient() {
+    {
+        std::lock_guard<std::mutex> lock(impl->mutex);
+        impl->stopping = true;
+    }
+    curl_multi_wakeup(impl->multi);
+    impl->io.join();
+    for (CURL* easy : impl->idle) {
+        curl_easy_cleanup(easy);
+    }
+    curl_multi_cleanup(impl->multi);
+}
+
+std::future<HttpResponse> HttpClient::get_async(const std::string& url) {
+    auto request = std::make_unique<Request>();
+    request->url = url;
+    request->start = Clock::now();
+    std::future<HttpResponse> response = request->promise.get_future();
+    {
+        std::lock_guard<std::mutex> lock(impl->mutex);
+        impl->queue.push_back(std::move(request));
+    }
+    curl_multi_wakeup(impl->multi);
     return response;
 }
+
+std::vector<HttpResponse> HttpClient::get_all(
+    const std::vector<std::string>& urls) {
+    std::vector<std::future<HttpResponse>> pending;
+    pending.reserve(urls.size());
+    for (const auto& url : urls) {
+        pending.push_back(get_async(url));
+    }
+    std::vector<HttpResponse> responses;
+    responses.reserve(urls.size());
+    for (auto& response : pending) {
+        responses.push_back(response.get());
+    }
+    return responses;
+}
+
+std::string HttpClient::get(const std::string& url) {
+    HttpResponse response = get_async(url).get();
+    if (!response.error.empty()) {
+        throw std::runtime_error(response.error);
+    }
+    if (!response.ok()) {
+        throw std::runtime_error("HTTP status " +
+                                 std::to_string(response.status));
+    }
+    return std::move(response.body);
+}
+
+HttpLatencyStats HttpClient::latency_stats() const {
+    std::vector<double> samples;
+    {
+        std::lock_guard<std::mutex> lock(impl->stats_mutex);
+        samples = impl->latencies;
+    }
+    HttpLatencyStats stats;
+    stats.count = samples.size();
+    if (samples.empty()) {
+        return stats;
+    }
+    std::sort(samples.begin(), samples.end());
+    // Nearest-rank percentiles
+    auto percentile = [&](double p) {
+        std::size_t rank = static_cast<std::size_t>(p * samples.size());
+        return samples[std::min(rank, samples.size() - 1)];
+    };
+    stats.p50_us = percentile(0.50);
+    stats.p90_us = percentile(0.90);
+    stats.p99_us = percentile(0.99);
+    stats.max_us = samples.back();
+    return stats;
+}
+
 }  // namespace thales
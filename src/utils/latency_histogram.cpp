@@ -0,0 +1,99 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "utils/latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace thales {
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (std::size_t i = 0; i < BUCKETS; ++i) {
+        bump(counts[i], other.counts[i].load(std::memory_order_relaxed));
+    }
+    bump(total, other.count());
+    bump(sum, other.sum.load(std::memory_order_relaxed));
+    smallest.store(std::min(smallest.load(std::memory_order_relaxed),
+                            other.smallest.load(std::memory_order_relaxed)),
+                   std::memory_order_relaxed);
+    largest.store(std::max(max(), other.max()), std::memory_order_relaxed);
+}
+
+void LatencyHistogram::clear() {
+    for (auto& count : counts) {
+        count.store(0, std::memory_order_relaxed);
+    }
+    total.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    smallest.store(std::numeric_limits<std::uint64_t>::max(),
+                   std::memory_order_relaxed);
+    largest.store(0, std::memory_order_relaxed);
+}
+
+std::uint64_t LatencyHistogram::min() const {
+    return count() == 0 ? 0 : smallest.load(std::memory_order_relaxed);
+}
+
+double LatencyHistogram::mean() const {
+    std::uint64_t n = count();
+    return n == 0 ? 0.0
+                  : static_cast<double>(sum.load(std::memory_order_relaxed)) /
+                        static_cast<double>(n);
+}
+
+std::uint64_t LatencyHistogram::percentile(double percent) const {
+    std::uint64_t n = count();
+    if (n == 0) {
+        return 0;
+    }
+    double clamped = std::min(std::max(percent, 0.0), 100.0);
+    // Rank of the record at the percentile, counting from 1
+    auto rank = static_cast<std::uint64_t>(std::ceil(clamped / 100.0 * n));
+    rank = std::max<std::uint64_t>(rank, 1);
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < BUCKETS; ++i) {
+        seen += counts[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return std::min(bucket_upper(i), max());
+        }
+    }
+    return max();
+}
+
+std::uint64_t LatencyHistogram::bucket_upper(std::size_t index) {
+    constexpr std::size_t EXACT = std::size_t{1} << SUB_BUCKET_BITS;
+    if (index < EXACT) {
+        return index;
+    }
+    if (index >= BUCKETS - 1) {
+        return std::numeric_limits<std::uint64_t>::max();
+    }
+    int shift = static_cast<int>(index >> SUB_BUCKET_BITS) - 1;
+    std::uint64_t sub = index & (EXACT - 1);
+    return ((EXACT + sub + 1) << shift) - 1;
+}
+
+}  // namespace thales
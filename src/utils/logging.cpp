@@ -23,3 +23,325 @@
  */
 
 #include "utils/logging.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "utils/date.h"
+#include "utils/thread_affinity.h"
+
+namespace thales {
+
+namespace {
+
+/**
+ * @brief One thread's buffer, kept alive until drained after the thread
+ * exits.
+ */
+struct ThreadBuffer {
+    explicit ThreadBuffer(std::size_t size) : ring(size) {}
+
+    SpscByteRing ring;
+    std::atomic<bool> retired{false};
+};
+
+/**
+ * @brief Marks the calling thread's buffer as retired when the thread exits.
+ */
+struct ThreadRegistration {
+    ~ThreadRegistration() {
+        if (buffer) {
+            detail::log_buffer = nullptr;
+            buffer->retired.store(true, std::memory_order_release);
+        }
+    }
+
+    std::shared_ptr<ThreadBuffer> buffer;
+};
+
+thread_local ThreadRegistration registration;
+
+/**
+ * @brief A record read from a buffer but not yet written out.
+ */
+struct Pending {
+    std::int64_t timestamp_ns;
+    const LogSite* site;
+    const char* arguments;
+    std::size_t size;
+};
+
+std::string_view base_name(std::string_view path) {
+    std::size_t slash = path.rfind('/');
+    return slash == std::string_view::npos ? path : path.substr(slash + 1);
+}
+
+template <typename T>
+T read_value(const char*& in) {
+    T value;
+    std::memcpy(&value, in, sizeof(value));
+    in += sizeof(value);
+    return value;
+}
+
+template <typename T>
+void append_number(T value, std::string& out) {
+    char digits[32];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr);
+}
+
+/**
+ * @brief Appends one encoded argument and advances past it.
+ */
+void append_argument(const char*& in, std::string& out) {
+    auto type = static_cast<detail::LogArgument>(*in++);
+    switch (type) {
+        case detail::LogArgument::STRING: {
+            auto length = read_value<std::uint32_t>(in);
+            out.append(in, length);
+            in += length;
+            return;
+        }
+        case detail::LogArgument::INT:
+            append_number(read_value<std::int64_t>(in), out);
+            return;
+        case detail::LogArgument::UINT:
+            append_number(read_value<std::uint64_t>(in), out);
+            return;
+        case detail::LogArgument::DOUBLE:
+            append_number(read_value<double>(in), out);
+            return;
+        case detail::LogArgument::BOOL:
+            out += read_value<std::uint64_t>(in) != 0 ? "true" : "false";
+            return;
+        case detail::LogArgument::CHAR:
+            out += static_cast<char>(read_value<std::uint64_t>(in));
+            return;
+    }
+}
+
+}  // namespace
+
+struct Logger::State {
+    std::mutex registry_mutex; /**< Guards buffers and buffer_size */
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::size_t buffer_size = LogSettings().buffer_size;
+
+    std::mutex drain_mutex; /**< Serializes draining and output changes */
+    std::FILE* output = stdout;
+    bool owns_output = false;
+    std::vector<std::shared_ptr<ThreadBuffer>> snapshot;
+    std::vector<Pending> pending;
+    std::string text;
+
+    std::atomic<bool> running{true};
+    std::atomic<std::int64_t> flush_interval_us{
+        LogSettings().flush_interval.count()};
+    std::atomic<std::uint64_t> dropped{0};
+    std::thread writer;
+
+    std::size_t drain();
+    void close_output();
+};
+
+std::size_t Logger::State::drain() {
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        snapshot = buffers;
+    }
+
+    pending.clear();
+    for (const auto& buffer : snapshot) {
+        std::size_t size;
+        while (const char* record = buffer->ring.try_read(size)) {
+            detail::LogRecord header;
+            std::memcpy(&header, record, sizeof(header));
+            pending.push_back({header.timestamp_ns, header.site,
+                               record + sizeof(header),
+                               header.argument_bytes});
+        }
+    }
+
+    // Merge this batch's records from all threads by timestamp
+    std::stable_sort(pending.begin(), pending.end(),
+                     [](const Pending& a, const Pending& b) {
+                         return a.timestamp_ns < b.timestamp_ns;
+                     });
+    text.clear();
+    char timestamp[TIMESTAMP_LENGTH];
+    for (const Pending& record : pending) {
+        std::size_t length = format_timestamp(record.timestamp_ns, timestamp);
+        if (length < TIMESTAMP_LENGTH) {
+            // Whole second: print the fraction anyway to keep columns aligned
+            std::memcpy(timestamp + length - 1, ".000000000Z", 11);
+        }
+        text.append(timestamp, TIMESTAMP_LENGTH);
+        text += ' ';
+        std::string_view level = to_string(record.site->level);
+        text.append(level).append(6 - level.size(), ' ');
+        text.append(base_name(record.site->file));
+        text += ':';
+        append_number(record.site->line, text);
+        text += ' ';
+        format_log_arguments(record.site->format, record.arguments,
+                             record.size, text);
+        text += '\n';
+    }
+    if (!text.empty()) {
+        std::fwrite(text.data(), 1, text.size(), output);
+        std::fflush(output);
+    }
+    for (const auto& buffer : snapshot) {
+        buffer->ring.release();
+    }
+
+    // Retirement is published after the thread's last record, so a retired
+    // buffer found empty stays empty
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    buffers.erase(
+        std::remove_if(buffers.begin(), buffers.end(),
+                       [](const std::shared_ptr<ThreadBuffer>& buffer) {
+                           return buffer->retired.load(
+                                      std::memory_order_acquire) &&
+                                  buffer->ring.empty();
+                       }),
+        buffers.end());
+    snapshot.clear();
+    return pending.size();
+}
+
+void Logger::State::close_output() {
+    if (owns_output) {
+        std::fclose(output);
+    }
+    output = stdout;
+    owns_output = false;
+}
+
+Logger& Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger() : state(new State) {
+    state->writer = std::thread([this] {
+        while (state->running.load(std::memory_order_acquire)) {
+            std::size_t written;
+            {
+                std::lock_guard<std::mutex> lock(state->drain_mutex);
+                written = state->drain();
+            }
+            if (written == 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(
+                    state->flush_interval_us.load(
+                        std::memory_order_relaxed)));
+            }
+        }
+    });
+}
+
+Logger::~Logger() {
+    // Calls made after this point, e.g. from other static destructors,
+    // are filtered out before they touch any buffer
+    set_level(LogLevel::OFF);
+    state->running.store(false, std::memory_order_release);
+    state->writer.join();
+    {
+        std::lock_guard<std::mutex> lock(state->drain_mutex);
+        state->drain();
+        state->close_output();
+    }
+    delete state;
+}
+
+void Logger::configure(const LogSettings& settings) {
+    ring_mask(settings.buffer_size);
+    std::FILE* output = stdout;
+    if (!settings.path.empty()) {
+        output = std::fopen(settings.path.c_str(), "a");
+        if (output == nullptr) {
+            throw std::runtime_error("Unable to open log file " +
+                                     settings.path);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(state->drain_mutex);
+    state->drain();
+    state->close_output();
+    state->output = output;
+    state->owns_output = !settings.path.empty();
+    {
+        std::lock_guard<std::mutex> registry(state->registry_mutex);
+        state->buffer_size = settings.buffer_size;
+    }
+    state->flush_interval_us.store(settings.flush_interval.count(),
+                                   std::memory_order_relaxed);
+    set_level(settings.level);
+}
+
+void Logger::flush() {
+    std::lock_guard<std::mutex> lock(state->drain_mutex);
+    state->drain();
+}
+
+void Logger::pin_writer(const std::vector<int>& cpus) {
+    pin_thread(state->writer.native_handle(), cpus);
+}
+
+std::uint64_t Logger::dropped() const {
+    return state->dropped.load(std::memory_order_relaxed);
+}
+
+SpscByteRing& detail::register_log_thread() {
+    Logger::State& state = *Logger::instance().state;
+    std::lock_guard<std::mutex> lock(state.registry_mutex);
+    registration.buffer = std::make_shared<ThreadBuffer>(state.buffer_size);
+    state.buffers.push_back(registration.buffer);
+    log_buffer = &registration.buffer->ring;
+    return *log_buffer;
+}
+
+void detail::count_dropped_log() {
+    Logger::instance().state->dropped.fetch_add(1,
+                                                std::memory_order_relaxed);
+}
+
+std::string_view to_string(LogLevel level) {
+    switch (level) {
+        case LogLevel::TRACE:
+            return "TRACE";
+        case LogLevel::DEBUG:
+            return "DEBUG";
+        case LogLevel::INFO:
+            return "INFO";
+        case LogLevel::WARN:
+            return "WARN";
+        case LogLevel::ERROR:
+            return "ERROR";
+        case LogLevel::OFF:
+            break;
+    }
+    return "OFF";
+}
+
+void format_log_arguments(const char* format, const char* arguments,
+                          std::size_t size, std::string& out) {
+    const char* end = arguments + size;
+    for (const char* c = format; *c != '\0'; ++c) {
+        if (c[0] == '{' && c[1] == '}' && arguments < end) {
+            append_argument(arguments, out);
+            ++c;
+        } else {
+            out += *c;
+        }
+    }
+}
+
+}  // namespace thales
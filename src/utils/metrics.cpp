@@ -0,0 +1,273 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "utils/metrics.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#include "utils/logging.h"
+
+namespace thales {
+
+namespace {
+
+/** Percentiles exported for each latency. */
+constexpr double QUANTILES[] = {0.5, 0.9, 0.99, 0.999};
+
+/** How long the cycle counter is calibrated against the steady clock. */
+constexpr std::int64_t CALIBRATION_NS = 2000000;
+
+bool valid_name(const std::string& name) {
+    auto allowed = [](char c, bool first) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' ||
+               c == ':' || (!first && c >= '0' && c <= '9');
+    };
+    if (name.empty()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < name.size(); ++i) {
+        if (!allowed(name[i], i == 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Metric>
+Metric& find_or_add(std::map<std::string, std::unique_ptr<Metric>>& metrics,
+                    const std::string& name, const std::string& help) {
+    auto found = metrics.find(name);
+    if (found == metrics.end()) {
+        found = metrics.emplace(name, std::make_unique<Metric>(name, help))
+                    .first;
+    }
+    return *found->second;
+}
+
+void append_header(std::string& out, const std::string& name,
+                   const std::string& help, const char* type) {
+    out += "# HELP " + name + " " + help + "\n";
+    out += "# TYPE " + name + " " + type + "\n";
+}
+
+void append_number(std::string& out, double value) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.9g", value);
+    out += text;
+}
+
+}  // namespace
+
+double nanoseconds_per_cycle() {
+#if defined(__x86_64__) || defined(__i386__)
+    static const double scale = [] {
+        std::int64_t begin_ns = steady_now_ns();
+        std::uint64_t begin = cycle_now();
+        std::int64_t end_ns = begin_ns;
+        while (end_ns - begin_ns < CALIBRATION_NS) {
+            end_ns = steady_now_ns();
+        }
+        std::uint64_t cycles = cycle_now() - begin;
+        return cycles == 0 ? 1.0
+                           : static_cast<double>(end_ns - begin_ns) /
+                                 static_cast<double>(cycles);
+    }();
+    return scale;
+#else
+    return 1.0;
+#endif
+}
+
+namespace detail {
+
+std::size_t next_metric_slot() {
+    static std::atomic<std::size_t> next{0};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+void** reserve_metric_cells(std::size_t slot) {
+    if (slot < metric_cell_count) {
+        return metric_cells;
+    }
+    std::size_t capacity = std::max<std::size_t>(metric_cell_count * 2, 64);
+    while (capacity <= slot) {
+        capacity *= 2;
+    }
+    auto table = std::make_unique<void*[]>(capacity);
+    std::copy(metric_cells, metric_cells + metric_cell_count, table.get());
+
+    // Never destroyed, so threads still running at exit keep their tables
+    static std::mutex mutex;
+    static auto* tables = new std::vector<std::unique_ptr<void*[]>>();
+    std::lock_guard<std::mutex> lock(mutex);
+    metric_cells = table.get();
+    metric_cell_count = capacity;
+    tables->push_back(std::move(table));
+    return metric_cells;
+}
+
+}  // namespace detail
+
+std::uint64_t Counter::value() const {
+    std::uint64_t total = 0;
+    cells.for_each([&](const Cell& cell) {
+        total += cell.value.load(std::memory_order_relaxed);
+    });
+    return total;
+}
+
+void LatencyMetric::snapshot(LatencyHistogram& out) const {
+    out.clear();
+    histograms.for_each(
+        [&](const LatencyHistogram& histogram) { out.merge(histogram); });
+}
+
+MetricsRegistry::MetricsRegistry() {
+    // Calibrate now rather than in the first timed scope
+    nanoseconds_per_cycle();
+}
+
+MetricsRegistry& MetricsRegistry::instance() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name,
+                                  const std::string& help) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!valid_name(name) || latencies.count(name) != 0) {
+        throw std::invalid_argument("Invalid counter name: " + name);
+    }
+    return find_or_add(counters, name, help);
+}
+
+LatencyMetric& MetricsRegistry::latency(const std::string& name,
+                                        const std::string& help) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!valid_name(name) || counters.count(name) != 0) {
+        throw std::invalid_argument("Invalid latency name: " + name);
+    }
+    return find_or_add(latencies, name, help);
+}
+
+void MetricsRegistry::write_prometheus(std::string& out) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& [name, counter] : counters) {
+        append_header(out, name, counter->get_help(), "counter");
+        out += name + " " + std::to_string(counter->value()) + "\n";
+    }
+    // One histogram is enough; each is reused for the next latency
+    auto merged = std::make_unique<LatencyHistogram>();
+    for (const auto& [name, latency] : latencies) {
+        latency->snapshot(*merged);
+        append_header(out, name, latency->get_help(), "summary");
+        for (double quantile : QUANTILES) {
+            out += name + "{quantile=\"";
+            append_number(out, quantile);
+            out += "\"} ";
+            append_number(out, merged->percentile(quantile * 100.0) * 1e-9);
+            out += "\n";
+        }
+        out += name + "_sum ";
+        append_number(out, merged->mean() * merged->count() * 1e-9);
+        out += "\n" + name + "_count " + std::to_string(merged->count()) +
+               "\n";
+    }
+}
+
+MetricsDumper::MetricsDumper(const MetricsRegistry& registry,
+                             std::string path,
+                             std::chrono::milliseconds interval)
+    : registry(registry), path(std::move(path)), interval(interval) {}
+
+MetricsDumper::~MetricsDumper() { stop(); }
+
+void MetricsDumper::start() {
+    if (thread.joinable()) {
+        return;
+    }
+    stopping = false;
+    thread = std::thread(&MetricsDumper::run, this);
+}
+
+void MetricsDumper::stop() {
+    if (!thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    thread.join();
+}
+
+void MetricsDumper::dump() const {
+    std::string text;
+    registry.write_prometheus(text);
+    // Readers see either the previous dump or this one, never a mix
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!(file << text) || !file.flush()) {
+            throw std::runtime_error("Unable to write metrics to " +
+                                     temporary);
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Unable to replace " + path + ": " +
+                                 std::strerror(errno));
+    }
+}
+
+void MetricsDumper::run() {
+    auto next = std::chrono::steady_clock::now();
+    while (true) {
+        try {
+            dump();
+        } catch (const std::exception& e) {
+            LOG_WARN("{}", std::string_view(e.what()));
+        }
+        next += interval;
+        std::unique_lock<std::mutex> lock(mutex);
+        if (wake.wait_until(lock, next, [this] { return stopping; })) {
+            break;
+        }
+    }
+    // The final dump holds everything recorded up to stop()
+    try {
+        dump();
+    } catch (const std::exception& e) {
+        LOG_WARN("{}", std::string_view(e.what()));
+    }
+}
+
+}  // namespace thales
@@ -0,0 +1,174 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "utils/response_cache.h"
+
+#include <unistd.h>
+#include <zlib.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include "utils/mapped_file.h"
+
+namespace thales {
+
+namespace {
+
+constexpr char MAGIC[8] = {'T', 'H', 'A', 'L', 'E', 'S', 'R', 'C'};
+constexpr std::uint32_t VERSION = 1;
+
+/**
+ * @brief Header at the start of every entry, followed by the key and then
+ *        the compressed body.
+ */
+struct EntryHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t key_length;
+    std::uint64_t body_length;
+    std::uint64_t compressed_length;
+};
+
+/** @brief FNV-1a; entries verify their key, so collisions only cost. */
+std::uint64_t hash_key(std::string_view key) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (char c : key) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+}  // namespace
+
+ResponseCache::ResponseCache(std::string directory, int level)
+    : directory(std::move(directory)), level(level) {
+    if (level < 1 || level > 9) {
+        throw std::invalid_argument("Compression level must be 1 to 9");
+    }
+    std::error_code error;
+    std::filesystem::create_directories(this->directory, error);
+    if (error) {
+        throw std::runtime_error("Unable to create " + this->directory +
+                                 ": " + error.message());
+    }
+}
+
+std::string ResponseCache::path(std::string_view key) const {
+    char name[24];
+    std::uint64_t hash = hash_key(key);
+    std::snprintf(name, sizeof(name), "%02x/%016llx.z",
+                  static_cast<unsigned>(hash >> 56),
+                  static_cast<unsigned long long>(hash));
+    return directory + "/" + name;
+}
+
+bool ResponseCache::load(std::string_view key, std::string& body) const {
+    std::string file = path(key);
+    if (::access(file.c_str(), R_OK) != 0) {
+        return false;
+    }
+    std::optional<MappedFile> entry;
+    try {
+        entry.emplace(file, true);
+    } catch (const std::runtime_error&) {
+        return false;  // Replaced or removed since the check
+    }
+    EntryHeader header;
+    if (entry->size() < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, entry->data(), sizeof(header));
+    const char* stored_key = entry->data() + sizeof(header);
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        header.version != VERSION || header.key_length != key.size() ||
+        entry->size() !=
+            sizeof(header) + header.key_length + header.compressed_length ||
+        key.compare(std::string_view(stored_key, key.size())) != 0) {
+        return false;
+    }
+
+    body.resize(header.body_length);
+    uLongf length = static_cast<uLongf>(header.body_length);
+    if (::uncompress(reinterpret_cast<Bytef*>(&body[0]), &length,
+                     reinterpret_cast<const Bytef*>(stored_key + key.size()),
+                     static_cast<uLong>(header.compressed_length)) != Z_OK ||
+        length != header.body_length) {
+        body.clear();
+        return false;
+    }
+    return true;
+}
+
+void ResponseCache::store(std::string_view key, std::string_view body) const {
+    std::string compressed(::compressBound(static_cast<uLong>(body.size())),
+                           '\0');
+    uLongf length = static_cast<uLongf>(compressed.size());
+    if (::compress2(reinterpret_cast<Bytef*>(&compressed[0]), &length,
+                    reinterpret_cast<const Bytef*>(body.data()),
+                    static_cast<uLong>(body.size()), level) != Z_OK) {
+        throw std::runtime_error("Unable to compress a cache entry");
+    }
+
+    EntryHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.key_length = static_cast<std::uint32_t>(key.size());
+    header.body_length = body.size();
+    header.compressed_length = length;
+
+    // Temporary names are unique per writer, so concurrent stores of one
+    // key each rename a complete entry into place
+    static std::atomic<unsigned> writes{0};
+    std::string destination = path(key);
+    std::string temporary = destination + ".tmp" +
+                            std::to_string(::getpid()) + "." +
+                            std::to_string(writes.fetch_add(1));
+    std::filesystem::create_directories(
+        std::filesystem::path(destination).parent_path());
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(key.data(), static_cast<std::streamsize>(key.size()));
+        out.write(compressed.data(), static_cast<std::streamsize>(length));
+        out.flush();
+        if (!out) {
+            std::remove(temporary.c_str());
+            throw std::runtime_error("Unable to write " + temporary);
+        }
+    }
+    std::filesystem::rename(temporary, destination);
+}
+
+}  // namespace thales
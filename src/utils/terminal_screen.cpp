@@ -0,0 +1,141 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "utils/terminal_screen.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace thales {
+
+namespace {
+
+std::string_view style_sequence(CellStyle style) {
+    switch (style) {
+        case CellStyle::NORMAL:
+            break;
+        case CellStyle::BOLD:
+            return "\x1b[0;1m";
+        case CellStyle::HEADER:
+            return "\x1b[0;7m";
+        case CellStyle::POSITIVE:
+            return "\x1b[0;32m";
+        case CellStyle::NEGATIVE:
+            return "\x1b[0;31m";
+    }
+    return "\x1b[0m";
+}
+
+void move_cursor(std::size_t row, std::size_t column, std::string& out) {
+    out += "\x1b[";
+    out += std::to_string(row + 1);
+    out += ';';
+    out += std::to_string(column + 1);
+    out += 'H';
+}
+
+}  // namespace
+
+TerminalScreen::TerminalScreen(std::size_t rows, std::size_t columns)
+    : height(rows), width(columns), back(rows * columns),
+      front(rows * columns) {}
+
+void TerminalScreen::resize(std::size_t rows, std::size_t columns) {
+    height = rows;
+    width = columns;
+    back.assign(rows * columns, Cell());
+    front.assign(rows * columns, Cell());
+    full_redraw = true;
+}
+
+void TerminalScreen::clear() { std::fill(back.begin(), back.end(), Cell()); }
+
+std::size_t TerminalScreen::put(std::size_t row, std::size_t column,
+                                std::string_view text, CellStyle style) {
+    if (row >= height || column >= width) {
+        return column + text.size();
+    }
+    std::size_t count = std::min(text.size(), width - column);
+    Cell* cells = &back[row * width + column];
+    for (std::size_t i = 0; i < count; ++i) {
+        char c = text[i];
+        cells[i] = {c >= ' ' && c <= '~' ? c : '?', style};
+    }
+    return column + text.size();
+}
+
+void TerminalScreen::render(std::string& out) {
+    std::size_t start = out.size();
+    if (full_redraw) {
+        // Clear to blanks, so the front buffer matches the terminal
+        out += "\x1b[0m\x1b[2J";
+        std::fill(front.begin(), front.end(), Cell());
+        full_redraw = false;
+    }
+
+    // Where the terminal's cursor is after the last emitted character
+    std::size_t cursor = back.size();
+    CellStyle style = CellStyle::NORMAL;
+    bool style_known = false;
+    for (std::size_t i = 0; i < back.size(); ++i) {
+        if (!(back[i] != front[i])) {
+            continue;
+        }
+        if (i != cursor) {
+            move_cursor(i / width, i % width, out);
+        }
+        if (!style_known || back[i].style != style) {
+            style = back[i].style;
+            out.append(style_sequence(style));
+            style_known = true;
+        }
+        out += back[i].character;
+        front[i] = back[i];
+        // The cursor does not wrap past the last column
+        cursor = (i + 1) % width == 0 ? back.size() : i + 1;
+    }
+    if (out.size() > start && style != CellStyle::NORMAL) {
+        out.append(style_sequence(CellStyle::NORMAL));
+    }
+}
+
+void write_all(int fd, std::string_view data) {
+    while (!data.empty()) {
+        ssize_t written = ::write(fd, data.data(), data.size());
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(std::string("Terminal write failed: ") +
+                                     std::strerror(errno));
+        }
+        data.remove_prefix(static_cast<std::size_t>(written));
+    }
+}
+
+}  // namespace thales
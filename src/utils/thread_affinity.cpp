@@ -0,0 +1,283 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "utils/thread_affinity.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+
+namespace thales {
+
+namespace {
+
+/** Memory policy of mbind(2) that prefers a node but may fall back. */
+constexpr int MPOL_PREFERRED_NODE = 1;
+
+/** Nodes representable in the mbind(2) mask below. */
+constexpr int MAX_NODES = 1024;
+
+constexpr unsigned long BITS_PER_WORD = 8 * sizeof(unsigned long);
+
+int parse_cpu(std::string_view text, std::string_view list) {
+    int cpu = -1;
+    auto [end, error] =
+        std::from_chars(text.data(), text.data() + text.size(), cpu);
+    if (text.empty() || error != std::errc() ||
+        end != text.data() + text.size() || cpu < 0) {
+        throw std::invalid_argument("Invalid CPU list: " + std::string(list));
+    }
+    return cpu;
+}
+
+std::size_t page_round(std::size_t bytes) {
+    static const std::size_t page =
+        static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    return (std::max<std::size_t>(bytes, 1) + page - 1) / page * page;
+}
+
+}  // namespace
+
+std::vector<int> parse_cpu_list(std::string_view text) {
+    std::vector<int> cpus;
+    // sysfs lists end with a newline
+    while (!text.empty() && (text.back() == '\n' || text.back() == ' ')) {
+        text.remove_suffix(1);
+    }
+    std::string_view rest = text;
+    while (!rest.empty()) {
+        std::size_t comma = rest.find(',');
+        std::string_view item = rest.substr(0, comma);
+        rest = comma == std::string_view::npos ? std::string_view()
+                                               : rest.substr(comma + 1);
+        std::size_t dash = item.find('-');
+        int first = parse_cpu(item.substr(0, dash), text);
+        int last = dash == std::string_view::npos
+                       ? first
+                       : parse_cpu(item.substr(dash + 1), text);
+        if (last < first || (comma != std::string_view::npos && rest.empty())) {
+            throw std::invalid_argument("Invalid CPU list: " +
+                                        std::string(text));
+        }
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+const CpuTopology& CpuTopology::instance() {
+    static const CpuTopology topology = read();
+    return topology;
+}
+
+CpuTopology CpuTopology::read(const std::string& root) {
+    CpuTopology topology;
+    std::error_code error;
+    for (const auto& entry :
+         std::filesystem::directory_iterator(root, error)) {
+        std::string name = entry.path().filename().string();
+        int node = -1;
+        if (name.compare(0, 4, "node") != 0 ||
+            std::from_chars(name.data() + 4, name.data() + name.size(), node)
+                    .ptr != name.data() + name.size() ||
+            node < 0 || node >= MAX_NODES) {
+            continue;  // e.g. "possible", "online", "power"
+        }
+        std::ifstream file(entry.path() / "cpulist");
+        std::string list;
+        if (!file || !std::getline(file, list)) {
+            continue;
+        }
+        if (topology.node_cpus.size() <= static_cast<std::size_t>(node)) {
+            topology.node_cpus.resize(node + 1);
+        }
+        topology.node_cpus[node] = parse_cpu_list(list);
+    }
+    if (topology.node_cpus.empty()) {
+        std::vector<int> cpus(std::max(1u, std::thread::hardware_concurrency()));
+        for (std::size_t i = 0; i < cpus.size(); ++i) {
+            cpus[i] = static_cast<int>(i);
+        }
+        topology.node_cpus.push_back(std::move(cpus));
+    }
+    return topology;
+}
+
+const std::vector<int>& CpuTopology::cpus_of(int node) const {
+    static const std::vector<int> none;
+    if (node < 0 || static_cast<std::size_t>(node) >= node_cpus.size()) {
+        return none;
+    }
+    return node_cpus[node];
+}
+
+int CpuTopology::node_of(int cpu) const {
+    for (std::size_t node = 0; node < node_cpus.size(); ++node) {
+        const auto& cpus = node_cpus[node];
+        if (std::find(cpus.begin(), cpus.end(), cpu) != cpus.end()) {
+            return static_cast<int>(node);
+        }
+    }
+    return 0;
+}
+
+void pin_thread(std::thread::native_handle_type thread,
+                const std::vector<int>& cpus) {
+    if (cpus.empty()) {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu < 0 || cpu >= CPU_SETSIZE) {
+            throw std::invalid_argument("CPU out of range: " +
+                                        std::to_string(cpu));
+        }
+        CPU_SET(cpu, &set);
+    }
+    int error = pthread_setaffinity_np(thread, sizeof(set), &set);
+    if (error != 0) {
+        throw std::runtime_error(std::string("Unable to pin thread: ") +
+                                 std::strerror(error));
+    }
+}
+
+void pin_current_thread(const std::vector<int>& cpus) {
+    pin_thread(pthread_self(), cpus);
+}
+
+WaitMode parse_wait_mode(std::string_view text) {
+    if (text == "sleep") {
+        return WaitMode::SLEEP;
+    }
+    if (text == "busy_poll") {
+        return WaitMode::BUSY_POLL;
+    }
+    if (text == "spin_then_park") {
+        return WaitMode::SPIN_THEN_PARK;
+    }
+    throw std::invalid_argument("Unknown wait mode: " + std::string(text));
+}
+
+void IdleWaiter::idle() {
+    switch (settings.mode) {
+        case WaitMode::BUSY_POLL:
+            cpu_relax();
+            return;
+        case WaitMode::SPIN_THEN_PARK:
+            if (idle_polls < settings.spin_iterations) {
+                ++idle_polls;
+                cpu_relax();
+                return;
+            }
+            break;
+        case WaitMode::SLEEP:
+            break;
+    }
+    if (settings.park.count() > 0) {
+        std::this_thread::sleep_for(settings.park);
+    } else {
+        std::this_thread::yield();
+    }
+}
+
+bool IdleWaiter::parking() const {
+    switch (settings.mode) {
+        case WaitMode::SLEEP:
+            return true;
+        case WaitMode::BUSY_POLL:
+            return false;
+        case WaitMode::SPIN_THEN_PARK:
+            break;
+    }
+    return idle_polls >= settings.spin_iterations;
+}
+
+int ThreadPlacement::node() const {
+    return cpus.empty() ? -1 : CpuTopology::instance().node_of(cpus.front());
+}
+
+std::pmr::memory_resource* NumaMemoryResource::for_node(int node) {
+    if (node < 0) {
+        return std::pmr::get_default_resource();
+    }
+    static std::mutex mutex;
+    // Never destroyed: containers with static lifetime may still hold
+    // memory from these resources when the process exits
+    static auto* resources =
+        new std::map<int, std::unique_ptr<NumaMemoryResource>>();
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& resource = (*resources)[node];
+    if (!resource) {
+        resource = std::make_unique<NumaMemoryResource>(node);
+    }
+    return resource.get();
+}
+
+void* NumaMemoryResource::do_allocate(std::size_t bytes,
+                                      std::size_t alignment) {
+    std::size_t length = page_round(bytes);
+    if (alignment > page_round(1)) {
+        throw std::bad_alloc();
+    }
+    void* address = ::mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (address == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+#ifdef SYS_mbind
+    if (numa_node >= 0 && numa_node < MAX_NODES) {
+        unsigned long mask[MAX_NODES / BITS_PER_WORD] = {};
+        mask[numa_node / BITS_PER_WORD] |= 1UL << (numa_node % BITS_PER_WORD);
+        // Before the first touch, so every page is placed by the policy.
+        // Failure (no NUMA support, or a sandbox forbidding the call)
+        // leaves the default first-touch placement
+        ::syscall(SYS_mbind, address, length, MPOL_PREFERRED_NODE, mask,
+                  static_cast<unsigned long>(MAX_NODES) + 1, 0u);
+    }
+#endif
+    return address;
+}
+
+void NumaMemoryResource::do_deallocate(void* p, std::size_t bytes,
+                                       std::size_t) {
+    ::munmap(p, page_round(bytes));
+}
+
+}  // namespace thales
@@ -0,0 +1,218 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "utils/thread_pool.h"
+
+#include <algorithm>
+#include <exception>
+
+#include "utils/thread_affinity.h"
+
+namespace thales {
+
+namespace {
+
+/** Pool and index of the worker running on this thread, if any. */
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local std::size_t current_index = 0;
+
+}  // namespace
+
+ThreadPool::ThreadPool(std::size_t threads, const std::vector<int>& cpus) {
+    if (threads == 0) {
+        threads = cpus.empty()
+                      ? std::max(1u, std::thread::hardware_concurrency())
+                      : cpus.size();
+    }
+    // Create every deque before any worker starts stealing from them
+    for (std::size_t i = 0; i < threads; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+        if (!cpus.empty()) {
+            workers[i]->cpu = cpus[i % cpus.size()];
+        }
+    }
+    for (std::size_t i = 0; i < threads; ++i) {
+        workers[i]->thread = std::thread([this, i] { run(i); });
+    }
+    try {
+        for (auto& worker : workers) {
+            if (!cpus.empty()) {
+                pin_thread(worker->thread.native_handle(), {worker->cpu});
+            }
+        }
+    } catch (...) {
+        shutdown();
+        throw;
+    }
+}
+
+ThreadPool::~ThreadPool() { shutdown(); }
+
+void ThreadPool::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker->thread.join();
+    }
+}
+
+std::size_t ThreadPool::current_worker() const {
+    return current_pool == this ? current_index : size();
+}
+
+std::pmr::memory_resource* ThreadPool::memory(std::size_t worker) const {
+    int cpu = workers[worker]->cpu;
+    return NumaMemoryResource::for_node(
+        cpu < 0 ? -1 : CpuTopology::instance().node_of(cpu));
+}
+
+void ThreadPool::push(Task task) {
+    std::size_t index = current_worker();
+    if (index == size()) {
+        index = next_worker.fetch_add(1, std::memory_order_relaxed) % size();
+    }
+    {
+        std::lock_guard<std::mutex> lock(workers[index]->mutex);
+        workers[index]->tasks.push_back(std::move(task));
+    }
+    {
+        // Counted under the sleep mutex so a worker cannot miss the wakeup
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    wake.notify_one();
+}
+
+bool ThreadPool::try_pop(std::size_t worker, Task& task) {
+    if (worker < size()) {
+        Worker& own = *workers[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    for (std::size_t k = 1; k <= size(); ++k) {
+        Worker& victim = *workers[(worker + k) % size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::run(std::size_t worker) {
+    current_pool = this;
+    current_index = worker;
+    Task task;
+    while (true) {
+        if (try_pop(worker, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        wake.wait(lock, [this] {
+            return stopping || pending.load(std::memory_order_relaxed) > 0;
+        });
+        if (stopping && pending.load(std::memory_order_relaxed) <= 0) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::parallel_for(
+    std::size_t count,
+    const std::function<void(std::size_t, std::size_t)>& body) {
+    if (count == 0) {
+        return;
+    }
+
+    struct Completion {
+        std::mutex mutex;
+        std::condition_variable done;
+        std::size_t remaining;
+        std::exception_ptr error;
+    } completion;
+    completion.remaining = count;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        push([this, &completion, &body, i] {
+            std::exception_ptr error;
+            try {
+                body(i, current_worker());
+            } catch (...) {
+                error = std::current_exception();
+            }
+            // Notify under the lock: the waiter owns completion and may
+            // destroy it as soon as it can observe remaining == 0
+            std::lock_guard<std::mutex> lock(completion.mutex);
+            if (error && !completion.error) {
+                completion.error = error;
+            }
+            if (--completion.remaining == 0) {
+                completion.done.notify_all();
+            }
+        });
+    }
+
+    std::size_t worker = current_worker();
+    if (worker < size()) {
+        // Help out instead of blocking a worker the iterations may need
+        Task task;
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(completion.mutex);
+                if (completion.remaining == 0) {
+                    break;
+                }
+            }
+            if (try_pop(worker, task)) {
+                task();
+                task = nullptr;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    } else {
+        std::unique_lock<std::mutex> lock(completion.mutex);
+        completion.done.wait(lock,
+                             [&] { return completion.remaining == 0; });
+    }
+
+    if (completion.error) {
+        std::rethrow_exception(completion.error);
+    }
+}
+
+}  // namespace thales
@@ -0,0 +1,95 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "utils/token_bucket.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+namespace thales {
+
+TokenBucket::TokenBucket(double rate, double burst)
+    : tokens_per_second(rate),
+      capacity(burst),
+      tokens(burst),
+      refilled(Clock::now()) {
+    if (!(rate >= 0.0)) {
+        throw std::invalid_argument("Token bucket rate must not be negative");
+    }
+    if (!(burst >= 1.0)) {
+        throw std::invalid_argument("Token bucket burst must be at least 1");
+    }
+}
+
+void TokenBucket::refill(Clock::time_point now) {
+    std::chrono::duration<double> elapsed = now - refilled;
+    tokens = std::min(capacity, tokens + elapsed.count() * tokens_per_second);
+    refilled = now;
+}
+
+TokenBucket::Clock::time_point TokenBucket::reserve() {
+    Clock::time_point now = Clock::now();
+    if (tokens_per_second == 0.0) {
+        return now;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    refill(now);
+    tokens -= 1.0;
+    if (tokens >= 0.0) {
+        return now;
+    }
+    // The token is owed: it becomes available once the deficit refills
+    return now + std::chrono::duration_cast<Clock::duration>(
+                     std::chrono::duration<double>(-tokens /
+                                                   tokens_per_second));
+}
+
+void TokenBucket::acquire() {
+    Clock::time_point ready = reserve();
+    if (ready > Clock::now()) {
+        std::this_thread::sleep_until(ready);
+    }
+}
+
+bool TokenBucket::try_acquire() {
+    if (tokens_per_second == 0.0) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    refill(Clock::now());
+    if (tokens < 1.0) {
+        return false;
+    }
+    tokens -= 1.0;
+    return true;
+}
+
+void TokenBucket::drain() {
+    std::lock_guard<std::mutex> lock(mutex);
+    refill(Clock::now());
+    tokens = std::min(tokens, 0.0);
+}
+
+}  // namespace thales
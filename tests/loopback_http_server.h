@@ -0,0 +1,172 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace thales {
+
+/**
+ * @brief Minimal HTTP/1.1 keep-alive server on 127.0.0.1 for tests.
+ *
+ * Every request is answered with its path as the body; paths starting with
+ * "/status/<code>" are answered with that status instead. A handler may be
+ * given to answer requests differently; it runs on the server thread. The
+ * server counts accepted connections so that tests can check connection
+ * reuse.
+ */
+class LoopbackHttpServer {
+   public:
+    /** Status and body of a response. */
+    using Response = std::pair<int, std::string>;
+
+    /** Produces the response to a request path (including the query). */
+    using Handler = std::function<Response(const std::string& path)>;
+
+    explicit LoopbackHttpServer(Handler handler = {})
+        : handler(std::move(handler)) {
+        listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        ::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        if (::bind(listener, reinterpret_cast<sockaddr*>(&address),
+                   sizeof(address)) != 0 ||
+            ::listen(listener, 128) != 0 ||
+            ::getsockname(listener, reinterpret_cast<sockaddr*>(&address),
+                          &length) != 0) {
+            ::close(listener);
+            throw std::runtime_error("Failed to start loopback server");
+        }
+        port = ntohs(address.sin_port);
+        thread = std::thread([this] { serve(); });
+    }
+
+    ~LoopbackHttpServer() {
+        stopping = true;
+        thread.join();
+        for (const auto& client : clients) {
+            ::close(client.first);
+        }
+        ::close(listener);
+    }
+
+    /** @brief Base URL of the server, without a trailing slash. */
+    std::string url() const {
+        return "http://127.0.0.1:" + std::to_string(port);
+    }
+
+    /** @brief Number of TCP connections accepted so far. */
+    int connections() const { return accepted.load(); }
+
+    /** @brief Number of requests answered so far. */
+    int requests() const { return answered.load(); }
+
+   private:
+    void serve() {
+        while (!stopping) {
+            std::vector<pollfd> fds = {{listener, POLLIN, 0}};
+            for (const auto& client : clients) {
+                fds.push_back({client.first, POLLIN, 0});
+            }
+            if (::poll(fds.data(), fds.size(), 20) <= 0) {
+                continue;
+            }
+            if (fds[0].revents & POLLIN) {
+                int client = ::accept(listener, nullptr, nullptr);
+                if (client >= 0) {
+                    clients[client];
+                    ++accepted;
+                }
+            }
+            for (std::size_t i = 1; i < fds.size(); ++i) {
+                if (fds[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+                    read_from(fds[i].fd);
+                }
+            }
+        }
+    }
+
+    void read_from(int client) {
+        char data[4096];
+        ssize_t count = ::recv(client, data, sizeof(data), 0);
+        if (count <= 0) {
+            ::close(client);
+            clients.erase(client);
+            return;
+        }
+        std::string& buffer = clients[client];
+        buffer.append(data, count);
+        std::size_t end;
+        while ((end = buffer.find("\r\n\r\n")) != std::string::npos) {
+            std::size_t path_begin = buffer.find(' ') + 1;
+            std::string path = buffer.substr(
+                path_begin, buffer.find(' ', path_begin) - path_begin);
+            buffer.erase(0, end + 4);
+            respond(client, path);
+        }
+    }
+
+    void respond(int client, const std::string& path) {
+        Response reply(200, path);
+        if (handler) {
+            reply = handler(path);
+        } else if (path.compare(0, 8, "/status/") == 0) {
+            reply.first = std::stoi(path.substr(8));
+        }
+        ++answered;
+        std::string response = "HTTP/1.1 " + std::to_string(reply.first) +
+                               " X\r\nContent-Length: " +
+                               std::to_string(reply.second.size()) +
+                               "\r\n\r\n" + reply.second;
+        ::send(client, response.data(), response.size(), MSG_NOSIGNAL);
+    }
+
+    int listener = -1;
+    int port = 0;
+    std::atomic<bool> stopping{false};
+    std::atomic<int> accepted{0};
+    std::atomic<int> answered{0};
+    Handler handler;
+    std::map<int, std::string> clients; /**< Pending input per socket */
+    std::thread thread;
+};
+
+}  // namespace thales
@@ -0,0 +1,196 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "trading/american_option.h"
+#include "trading/option_kernels.h"
+
+namespace {
+
+const AmericanMethod kAllMethods[] = {
+    AmericanMethod::COX_ROSS_RUBINSTEIN, AmericanMethod::LEISEN_REIMER,
+    AmericanMethod::CRANK_NICOLSON, AmericanMethod::BARONE_ADESI_WHALEY,
+    AmericanMethod::JU_ZHONG};
+
+AmericanSettings with_method(AmericanMethod method) {
+    AmericanSettings settings;
+    settings.method = method;
+    return settings;
+}
+
+}  // namespace
+
+TEST(AmericanOptionTest, PricesAtTheMoneyPut) {
+    // Reference from a 20001-step Leisen-Reimer tree
+    const double reference = 6.090358;
+    const double tolerance[] = {1e-2, 2e-3, 2e-3, 1e-2, 3e-2};
+    for (std::size_t i = 0; i < std::size(kAllMethods); ++i) {
+        double price = AmericanOption::calculate_option_price(
+            100.0, 100.0, 1.0, 0.05, 0.2, PUT, with_method(kAllMethods[i]));
+        EXPECT_NEAR(price, reference, tolerance[i]) << i;
+    }
+}
+
+TEST(AmericanOptionTest, MatchesEuropeanWhenEarlyExerciseNeverPays) {
+    for (AmericanMethod method : kAllMethods) {
+        AmericanSettings settings = with_method(method);
+        EXPECT_DOUBLE_EQ(AmericanOption::calculate_option_price(
+                             100.0, 90.0, 1.0, 0.05, 0.3, CALL, settings),
+                         BlackScholes::calculate_option_price(
+                             100.0, 90.0, 1.0, 0.05, 0.3, CALL));
+        EXPECT_DOUBLE_EQ(AmericanOption::calculate_option_price(
+                             100.0, 110.0, 1.0, -0.01, 0.3, PUT, settings),
+                         BlackScholes::calculate_option_price(
+                             100.0, 110.0, 1.0, -0.01, 0.3, PUT));
+    }
+}
+
+TEST(AmericanOptionTest, RespectsExerciseBounds) {
+    for (AmericanMethod method : kAllMethods) {
+        AmericanSettings settings = with_method(method);
+        for (double K = 60.0; K <= 160.0; K += 10.0) {
+            double price = AmericanOption::calculate_option_price(
+                100.0, K, 0.75, 0.06, 0.25, PUT, settings);
+            double european = BlackScholes::calculate_option_price(
+                100.0, K, 0.75, 0.06, 0.25, PUT);
+            EXPECT_GE(price, european - 1e-9) << K;
+            EXPECT_GE(price, std::max(K - 100.0, 0.0) - 1e-9) << K;
+        }
+        // Deep in the money the put is exercised at once
+        EXPECT_NEAR(AmericanOption::calculate_option_price(
+                        100.0, 200.0, 0.75, 0.06, 0.25, PUT, settings),
+                    100.0, 1e-6);
+        EXPECT_DOUBLE_EQ(AmericanOption::calculate_option_price(
+                             100.0, 120.0, 0.0, 0.06, 0.25, PUT, settings),
+                         20.0);
+    }
+}
+
+TEST(AmericanOptionTest, ConvergesWithMoreSteps) {
+    const double reference = 6.090358;
+    for (AmericanMethod method :
+         {AmericanMethod::LEISEN_REIMER, AmericanMethod::CRANK_NICOLSON}) {
+        AmericanSettings coarse = with_method(method);
+        coarse.time_steps = 25;
+        coarse.space_steps = 50;
+        AmericanSettings fine = with_method(method);
+        fine.time_steps = 801;
+        fine.space_steps = 1600;
+        double coarse_error = std::abs(
+            AmericanOption::calculate_option_price(100.0, 100.0, 1.0, 0.05,
+                                                   0.2, PUT, coarse) -
+            reference);
+        double fine_error = std::abs(
+            AmericanOption::calculate_option_price(100.0, 100.0, 1.0, 0.05,
+                                                   0.2, PUT, fine) -
+            reference);
+        EXPECT_LT(fine_error, coarse_error);
+        EXPECT_LT(fine_error, 5e-4);
+    }
+}
+
+TEST(AmericanOptionTest, BatchMatchesSinglePricing) {
+    const std::size_t n = 40;
+    std::vector<double> S(n, 100.0), K(n), T(n), r(n, 0.05), sigma(n, 0.3),
+        prices(n);
+    std::vector<OptionType> type(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        K[i] = 80.0 + 2.0 * (i % 20);
+        T[i] = i < 20 ? 0.25 : 1.0;
+        type[i] = i % 3 == 0 ? CALL : PUT;
+    }
+    OptionBatch batch = {S.data(),     K.data(),    T.data(), r.data(),
+                         sigma.data(), type.data(), n};
+
+    for (AmericanMethod method : kAllMethods) {
+        AmericanSettings settings = with_method(method);
+        AmericanOption::calculate_option_prices(batch, prices.data(),
+                                                settings);
+        // The shared PDE grid spans every strike, so it is coarser
+        double tolerance =
+            method == AmericanMethod::CRANK_NICOLSON ? 2e-3 : 1e-12;
+        for (std::size_t i = 0; i < n; ++i) {
+            double single = AmericanOption::calculate_option_price(
+                S[i], K[i], T[i], r[i], sigma[i], type[i], settings);
+            EXPECT_NEAR(prices[i], single, tolerance) << i;
+        }
+    }
+}
+
+TEST(AmericanOptionTest, RejectsInvalidInputs) {
+    EXPECT_THROW(AmericanOption::calculate_option_price(-100.0, 100.0, 1.0,
+                                                        0.05, 0.2, PUT),
+                 std::invalid_argument);
+    EXPECT_THROW(AmericanOption::calculate_option_price(100.0, 100.0, -1.0,
+                                                        0.05, 0.2, PUT),
+                 std::invalid_argument);
+    AmericanSettings settings;
+    settings.time_steps = 0;
+    EXPECT_THROW(AmericanOption::calculate_option_price(
+                     100.0, 100.0, 1.0, 0.05, 0.2, PUT, settings),
+                 std::invalid_argument);
+
+    double S = 100.0, K = 100.0, T = 1.0, r = 0.05, sigma = -0.2, price;
+    OptionType type = PUT;
+    OptionBatch batch = {&S, &K, &T, &r, &sigma, &type, 1};
+    EXPECT_THROW(AmericanOption::calculate_option_prices(batch, &price),
+                 std::invalid_argument);
+}
+
+TEST(AmericanOptionTest, QuadraticKernelPricesBothTypes) {
+    AmericanSettings tree;
+    tree.time_steps = 1001;
+    AmericanSettings quadratic =
+        with_method(AmericanMethod::BARONE_ADESI_WHALEY);
+    for (double S : {80.0, 100.0, 120.0}) {
+        // The pricer's method and the kernel share one implementation
+        double put = option_price<Put, American>({S, 100.0, 1.0, 0.05, 0.25});
+        EXPECT_EQ(put, AmericanOption::calculate_option_price(
+                           S, 100.0, 1.0, 0.05, 0.25, PUT, quadratic));
+
+        // Calls are only exercised early with a negative rate
+        OptionInputs inputs = {S, 100.0, 1.0, -0.03, 0.25};
+        double call = option_price<Call, American>(inputs);
+        double european = option_price<Call, European>(inputs);
+        EXPECT_GE(call, european);
+        EXPECT_GE(call, S - 100.0);
+        // The quadratic approximation is only good to roughly a tenth of
+        // a point at one year, the same as for puts.
+        EXPECT_NEAR(call,
+                    AmericanOption::calculate_option_price(
+                        S, 100.0, 1.0, -0.03, 0.25, CALL, tree),
+                    0.2);
+    }
+
+    OptionInputs positive_rate = {100.0, 90.0, 1.0, 0.05, 0.3};
+    double american = option_price<Call, American>(positive_rate);
+    EXPECT_EQ(american, (option_price<Call, European>(positive_rate)));
+    // Deep in the money the call sits on its exercise boundary
+    double deep = option_price<Call, American>({300.0, 100.0, 1.0, -0.05, 0.2});
+    EXPECT_EQ(deep, 200.0);
+}
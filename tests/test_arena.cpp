@@ -0,0 +1,212 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "trading/portfolio.h"
+#include "trading/symbol_table.h"
+#include "utils/arena.h"
+
+namespace {
+
+/** Counts calls to the replaceable global operator new in this binary. */
+std::atomic<std::size_t> heap_allocations{0};
+
+void* counted_new(std::size_t size) {
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size > 0 ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* counted_new(std::size_t size, std::align_val_t alignment) {
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    auto align = static_cast<std::size_t>(alignment);
+    std::size_t rounded = (size + align - 1) / align * align;
+    if (void* p = std::aligned_alloc(align, rounded > 0 ? rounded : align)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+}  // namespace
+
+// std::pmr::new_delete_resource() uses the aligned overloads
+void* operator new(std::size_t size) { return counted_new(size); }
+void* operator new[](std::size_t size) { return counted_new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return counted_new(size, alignment);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return counted_new(size, alignment);
+}
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+namespace thales {
+
+TEST(ArenaTest, AllocatesNothingUntilFirstUse) {
+    CountingResource upstream;
+    Arena arena(1024, &upstream);
+    EXPECT_EQ(arena.block_count(), 0u);
+    EXPECT_EQ(upstream.allocations(), 0u);
+    arena.reset();
+    EXPECT_EQ(arena.used(), 0u);
+}
+
+TEST(ArenaTest, HonoursAlignment) {
+    Arena arena(1024);
+    EXPECT_NE(arena.allocate(1, 1), nullptr);
+    for (std::size_t alignment : {8u, 16u, 64u, 256u}) {
+        void* p = arena.allocate(3, alignment);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % alignment, 0u);
+    }
+}
+
+TEST(ArenaTest, ResetReusesBlocks) {
+    CountingResource upstream;
+    Arena arena(256, &upstream);
+    for (int cycle = 0; cycle < 5; ++cycle) {
+        std::pmr::vector<double> values(&arena);
+        for (int i = 0; i < 1000; ++i) {
+            values.push_back(i);
+        }
+        EXPECT_EQ(values[999], 999.0);
+        if (cycle == 0) {
+            upstream.clear();
+        }
+        arena.reset();
+    }
+    // Every cycle after the first fits in the blocks kept by reset()
+    EXPECT_EQ(upstream.allocations(), 0u);
+    EXPECT_EQ(upstream.deallocations(), 0u);
+    EXPECT_GE(arena.capacity(), 1000 * sizeof(double));
+
+    std::size_t blocks = arena.block_count();
+    arena.release();
+    EXPECT_EQ(arena.block_count(), 0u);
+    EXPECT_EQ(upstream.deallocations(), blocks);
+}
+
+TEST(ArenaTest, OversizedRequestGetsItsOwnBlock) {
+    Arena arena(64);
+    void* small = arena.allocate(16);
+    void* large = arena.allocate(4096, 64);
+    EXPECT_NE(small, large);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(large) % 64, 0u);
+    EXPECT_GE(arena.capacity(), 4096u + 64u);
+    EXPECT_EQ(arena.used(), 16u + 4096u);
+}
+
+TEST(ArenaTest, ScopesRewindToWhereTheyStarted) {
+    Arena arena(128);
+    void* outer = arena.allocate(32);
+    void* inner = nullptr;
+    {
+        Arena::Scope scope(arena);
+        inner = arena.allocate(32);
+        {
+            Arena::Scope nested(arena);
+            EXPECT_NE(arena.allocate(1000), nullptr);
+        }
+        // The nested scope handed its memory back, including a new block
+        EXPECT_EQ(arena.used(), 64u);
+    }
+    EXPECT_EQ(arena.used(), 32u);
+    EXPECT_EQ(arena.allocate(32), inner);
+    EXPECT_NE(outer, inner);
+
+    Arena empty(128);
+    {
+        Arena::Scope scope(empty);
+        EXPECT_NE(empty.allocate(16), nullptr);
+    }
+    EXPECT_EQ(empty.used(), 0u);
+}
+
+TEST(ArenaTest, PortfolioLivesInArena) {
+    CountingResource upstream;
+    Arena arena(4096, &upstream);
+    Portfolio portfolio = fetch_portfolio(&arena);
+    EXPECT_EQ(portfolio.get_resource(), &arena);
+    EXPECT_EQ(portfolio.size(), 2u);
+    EXPECT_GT(arena.used(), 0u);
+
+    // A copy leaves the arena so it can outlive the cycle
+    Portfolio copy = portfolio;
+    EXPECT_EQ(copy.get_resource(), std::pmr::get_default_resource());
+    EXPECT_EQ(copy.get_strikes(), portfolio.get_strikes());
+}
+
+TEST(ArenaTest, HotPathMakesNoHeapAllocationsOnceWarm) {
+    Arena arena(4096);
+    std::vector<UnderlyingRisk> risk;
+    MarketData market;
+    market.rate = 0.05;
+    market.valuation_date = 19800;
+
+    auto cycle = [&] {
+        Portfolio portfolio = fetch_portfolio(&arena);
+        std::pmr::vector<Order> orders = fetch_orders(&arena);
+        portfolio.calculate_risk(market, risk);
+        arena.reset();
+        return orders.size();
+    };
+
+    // Interning symbols and sizing the market happen once, outside the loop
+    SymbolTable::intern("AAPL");
+    SymbolTable::intern("TSLA");
+    market.spot.assign(SymbolTable::size(), 100.0);
+    market.volatility.assign(SymbolTable::size(), 0.2);
+    cycle();
+    cycle();
+
+    std::size_t before = heap_allocations.load();
+    std::size_t blocks = arena.block_count();
+    std::size_t orders = 0;
+    for (int i = 0; i < 100; ++i) {
+        orders += cycle();
+    }
+    EXPECT_EQ(heap_allocations.load(), before);
+    EXPECT_EQ(arena.block_count(), blocks);
+    EXPECT_EQ(orders, 150u);  // Every other cycle reports a second order
+}
+
+}  // namespace thales
@@ -1,5 +1,135 @@
+#include <array>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "trading/black_scholes.h"
+#include "trading/option_kernels.h"
+
+namespace {
+
+/**
+ * @brief Randomized option chain stored as structure-of-arrays
+ */
+struct Chain {
+    std::vector<double> S, K, T, r, sigma;
+    std::vector<OptionType> type;
+
+    explicit Chain(std::size_t n) {
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<double> moneyness(0.5, 1.5);
+        std::uniform_real_distribution<double> expiry(0.01, 3.0);
+        std::uniform_real_distribution<double> rate(-0.01, 0.08);
+        std::uniform_real_distribution<double> vol(0.05, 1.2);
+        for (std::size_t i = 0; i < n; ++i) {
+            S.push_back(100.0);
+            K.push_back(100.0 * moneyness(gen));
+            T.push_back(expiry(gen));
+            r.push_back(rate(gen));
+            sigma.push_back(vol(gen));
+            type.push_back(i % 3 == 0 ? OptionType::PUT : OptionType::CALL);
+        }
+    }
+
+    OptionBatch view() const {
+        return {S.data(), K.data(),     T.data(),
+                r.data(), sigma.data(), type.data(), S.size()};
+    }
+};
+
+const SimdBackend kAllBackends[] = {SimdBackend::AUTO, SimdBackend::SCALAR,
+                                    SimdBackend::NEON, SimdBackend::AVX2,
+                                    SimdBackend::AVX512};
+
+/**
+ * @brief At-the-money calls across expiries, priced by the compiler
+ */
+constexpr std::array<double, 4> kCompileTimeExpiries = {0.25, 0.5, 1.0, 2.0};
+constexpr std::array<double, 4> kCompileTimePrices = [] {
+    std::array<double, 4> prices{};
+    for (std::size_t i = 0; i < prices.size(); ++i) {
+        prices[i] = option_price<Call, European, ConstexprMath>(
+            {100.0, 100.0, kCompileTimeExpiries[i], 0.05, 0.2});
+    }
+    return prices;
+}();
+static_assert(kCompileTimePrices[2] > 10.4505 &&
+                  kCompileTimePrices[2] < 10.4507,
+              "constexpr kernel disagrees with the reference price");
+
+/**
+ * @brief Check a math policy's normal distribution against the exact one
+ */
+template <class Math>
+void expect_normal_within_bound() {
+    for (double x = -12.0; x <= 12.0; x += 1e-3) {
+        ASSERT_NEAR(Math::norm_cdf(x), ExactMath::norm_cdf(x),
+                    Math::MAX_ERROR)
+            << "x = " << x;
+        ASSERT_NEAR(Math::norm_pdf(x), ExactMath::norm_pdf(x),
+                    Math::MAX_ERROR)
+            << "x = " << x;
+    }
+    const double inf = std::numeric_limits<double>::infinity();
+    EXPECT_NEAR(Math::norm_cdf(-inf), 0.0, Math::MAX_ERROR);
+    EXPECT_NEAR(Math::norm_cdf(inf), 1.0, Math::MAX_ERROR);
+    EXPECT_TRUE(std::isnan(Math::norm_cdf(std::nan(""))));
+}
+
+/**
+ * @brief Check prices and Greeks of a fast policy against the exact path
+ *
+ * An error of e in each N(x) moves the price by at most e * (S + K), the
+ * delta by e and the vega by e * S * sqrt(T).
+ */
+template <class Math>
+void expect_prices_within_bound() {
+    Chain chain(1021);
+    const std::size_t n = chain.S.size();
+    std::vector<double> price(n), delta(n), vega(n);
+    GreeksBatch out = {};
+    out.delta = delta.data();
+    out.vega = vega.data();
+
+    for (std::size_t i = 0; i < n; ++i) {
+        Greeks exact = BlackScholes::calculate_greeks(
+            chain.S[i], chain.K[i], chain.T[i], chain.r[i], chain.sigma[i],
+            chain.type[i]);
+        Greeks fast = BlackScholes::calculate_greeks<Math>(
+            chain.S[i], chain.K[i], chain.T[i], chain.r[i], chain.sigma[i],
+            chain.type[i]);
+        const double e = Math::MAX_ERROR;
+        ASSERT_NEAR(fast.price, exact.price, e * (chain.S[i] + chain.K[i]));
+        ASSERT_NEAR(fast.delta, exact.delta, e);
+        ASSERT_NEAR(fast.vega, exact.vega,
+                    e * chain.S[i] * std::sqrt(chain.T[i]));
+        ASSERT_EQ(fast.price, BlackScholes::calculate_option_price<Math>(
+                                  chain.S[i], chain.K[i], chain.T[i],
+                                  chain.r[i], chain.sigma[i], chain.type[i]));
+    }
+
+    for (SimdBackend backend : kAllBackends) {
+        if (!BlackScholes::is_simd_backend_supported(backend)) {
+            continue;
+        }
+        BlackScholes::calculate_option_prices<Math>(chain.view(),
+                                                    price.data(), backend);
+        BlackScholes::calculate_greeks<Math>(chain.view(), out, backend);
+        for (std::size_t i = 0; i < n; ++i) {
+            Greeks g = BlackScholes::calculate_greeks<Math>(
+                chain.S[i], chain.K[i], chain.T[i], chain.r[i],
+                chain.sigma[i], chain.type[i]);
+            ASSERT_NEAR(price[i], g.price, 1e-10)
+                << "backend " << static_cast<int>(backend) << ", option " << i;
+            ASSERT_NEAR(delta[i], g.delta, 1e-12);
+            ASSERT_NEAR(vega[i], g.vega, 1e-10);
+        }
+    }
+}
+
+}  // namespace
 
 class BlackScholesTest : public ::testing::Test {
 protected:
@@ -121,3 +251,262 @@ TEST_F(BlackScholesTest, InvalidInputParameters) {
         std::invalid_argument
     );
 }
+
+TEST_F(BlackScholesTest, BatchMatchesScalarOnEveryBackend) {
+    // 1021 is not a multiple of any vector width, so the tail is exercised.
+    Chain chain(1021);
+    std::vector<double> prices(chain.S.size());
+
+    for (SimdBackend backend : kAllBackends) {
+        if (!BlackScholes::is_simd_backend_supported(backend)) {
+            continue;
+        }
+        BlackScholes::calculate_option_prices(chain.view(), prices.data(),
+                                              backend);
+        for (std::size_t i = 0; i < prices.size(); ++i) {
+            double expected = BlackScholes::calculate_option_price(
+                chain.S[i], chain.K[i], chain.T[i], chain.r[i], chain.sigma[i],
+                chain.type[i]);
+            ASSERT_NEAR(prices[i], expected, 1e-10)
+                << "backend " << static_cast<int>(backend) << ", option " << i;
+        }
+    }
+}
+
+TEST_F(BlackScholesTest, BatchHandlesZeroVolatility) {
+    double S[] = {100.0, 100.0};
+    double K[] = {100.0, 120.0};
+    double T[] = {1.0, 1.0};
+    double r[] = {0.05, 0.05};
+    double sigma[] = {0.0, 0.0};
+    OptionType type[] = {OptionType::CALL, OptionType::PUT};
+    double prices[2];
+
+    BlackScholes::calculate_option_prices({S, K, T, r, sigma, type, 2},
+                                          prices);
+
+    ASSERT_NEAR(prices[0], 4.8771, 0.0001);
+    ASSERT_NEAR(prices[1], 120.0 * exp(-0.05) - 100.0, 0.0001);
+}
+
+TEST_F(BlackScholesTest, BatchRejectsInvalidInput) {
+    Chain chain(16);
+    chain.sigma[7] = -0.2;
+    std::vector<double> prices(chain.S.size(), -1.0);
+
+    EXPECT_THROW(
+        BlackScholes::calculate_option_prices(chain.view(), prices.data()),
+        std::invalid_argument);
+    // Validation happens before any output is written.
+    EXPECT_EQ(prices[0], -1.0);
+
+    chain.sigma[7] = 0.2;
+    chain.type[3] = static_cast<OptionType>(-1);
+    EXPECT_THROW(
+        BlackScholes::calculate_option_prices(chain.view(), prices.data()),
+        std::invalid_argument);
+}
+
+TEST_F(BlackScholesTest, UnsupportedBackendThrows) {
+    Chain chain(4);
+    std::vector<double> prices(chain.S.size());
+
+    ASSERT_TRUE(BlackScholes::is_simd_backend_supported(
+        BlackScholes::best_simd_backend()));
+    for (SimdBackend backend : kAllBackends) {
+        if (!BlackScholes::is_simd_backend_supported(backend)) {
+            EXPECT_THROW(BlackScholes::calculate_option_prices(
+                             chain.view(), prices.data(), backend),
+                         std::invalid_argument);
+        }
+    }
+}
+
+TEST_F(BlackScholesTest, GreeksAtTheMoneyCall) {
+    Greeks g =
+        BlackScholes::calculate_greeks(100.0, 100.0, 1.0, 0.05, 0.2, CALL);
+
+    ASSERT_NEAR(g.price, 10.4506, 0.0001);
+    ASSERT_NEAR(g.delta, 0.6368, 0.0001);
+    ASSERT_NEAR(g.gamma, 0.018762, 0.000001);
+    ASSERT_NEAR(g.vega, 37.5240, 0.0001);
+    ASSERT_NEAR(g.theta, -6.4140, 0.0001);
+    ASSERT_NEAR(g.rho, 53.2325, 0.0001);
+}
+
+TEST_F(BlackScholesTest, GreeksMatchFiniteDifferences) {
+    const double S = 105.0, K = 95.0, T = 0.75, r = 0.03, sigma = 0.35;
+    const double h = 1e-4;
+    auto price = [](double S, double K, double T, double r, double sigma,
+                    OptionType type) {
+        return BlackScholes::calculate_option_price(S, K, T, r, sigma, type);
+    };
+
+    for (OptionType type : {CALL, PUT}) {
+        Greeks g = BlackScholes::calculate_greeks(S, K, T, r, sigma, type);
+        double base = price(S, K, T, r, sigma, type);
+
+        EXPECT_NEAR(g.price, base, 1e-10);
+        EXPECT_NEAR(g.delta,
+                    (price(S + h, K, T, r, sigma, type) -
+                     price(S - h, K, T, r, sigma, type)) / (2 * h),
+                    1e-6);
+        EXPECT_NEAR(g.gamma,
+                    (price(S + h, K, T, r, sigma, type) - 2 * base +
+                     price(S - h, K, T, r, sigma, type)) / (h * h),
+                    1e-4);
+        EXPECT_NEAR(g.vega,
+                    (price(S, K, T, r, sigma + h, type) -
+                     price(S, K, T, r, sigma - h, type)) / (2 * h),
+                    1e-5);
+        EXPECT_NEAR(g.theta,
+                    -(price(S, K, T + h, r, sigma, type) -
+                      price(S, K, T - h, r, sigma, type)) / (2 * h),
+                    1e-5);
+        EXPECT_NEAR(g.rho,
+                    (price(S, K, T, r + h, sigma, type) -
+                     price(S, K, T, r - h, sigma, type)) / (2 * h),
+                    1e-5);
+
+        double vega_up =
+            BlackScholes::calculate_greeks(S + h, K, T, r, sigma, type).vega;
+        double vega_down =
+            BlackScholes::calculate_greeks(S - h, K, T, r, sigma, type).vega;
+        EXPECT_NEAR(g.vanna, (vega_up - vega_down) / (2 * h), 1e-5);
+
+        vega_up =
+            BlackScholes::calculate_greeks(S, K, T, r, sigma + h, type).vega;
+        vega_down =
+            BlackScholes::calculate_greeks(S, K, T, r, sigma - h, type).vega;
+        EXPECT_NEAR(g.volga, (vega_up - vega_down) / (2 * h), 1e-4);
+    }
+}
+
+TEST_F(BlackScholesTest, BatchGreeksMatchScalarOnEveryBackend) {
+    Chain chain(517);
+    const std::size_t n = chain.S.size();
+    std::vector<double> price(n), delta(n), gamma(n), vega(n), theta(n),
+        rho(n), vanna(n), volga(n);
+    GreeksBatch out = {price.data(), delta.data(), gamma.data(),
+                       vega.data(),  theta.data(), rho.data(),
+                       vanna.data(), volga.data()};
+
+    for (SimdBackend backend : kAllBackends) {
+        if (!BlackScholes::is_simd_backend_supported(backend)) {
+            continue;
+        }
+        BlackScholes::calculate_greeks(chain.view(), out, backend);
+        for (std::size_t i = 0; i < n; ++i) {
+            Greeks g = BlackScholes::calculate_greeks(
+                chain.S[i], chain.K[i], chain.T[i], chain.r[i], chain.sigma[i],
+                chain.type[i]);
+            ASSERT_NEAR(price[i], g.price, 1e-10);
+            ASSERT_NEAR(delta[i], g.delta, 1e-12);
+            ASSERT_NEAR(gamma[i], g.gamma, 1e-12);
+            ASSERT_NEAR(vega[i], g.vega, 1e-10);
+            ASSERT_NEAR(theta[i], g.theta, 1e-10);
+            ASSERT_NEAR(rho[i], g.rho, 1e-10);
+            ASSERT_NEAR(vanna[i], g.vanna, 1e-10);
+            ASSERT_NEAR(volga[i], g.volga, 1e-8);
+        }
+    }
+}
+
+TEST_F(BlackScholesTest, BatchGreeksSkipNullOutputs) {
+    Chain chain(9);
+    std::vector<double> delta(chain.S.size());
+    GreeksBatch out = {};
+    out.delta = delta.data();
+
+    BlackScholes::calculate_greeks(chain.view(), out);
+
+    for (std::size_t i = 0; i < delta.size(); ++i) {
+        EXPECT_NEAR(delta[i],
+                    BlackScholes::calculate_greeks(
+                        chain.S[i], chain.K[i], chain.T[i], chain.r[i],
+                        chain.sigma[i], chain.type[i])
+                        .delta,
+                    1e-12);
+    }
+}
+
+TEST_F(BlackScholesTest, FastNormalStaysWithinDocumentedError) {
+    expect_normal_within_bound<ExactMath>();
+    expect_normal_within_bound<RiskMath>();
+    expect_normal_within_bound<ScreeningMath>();
+}
+
+TEST_F(BlackScholesTest, FastMathPricesTrackExactPath) {
+    expect_prices_within_bound<RiskMath>();
+    expect_prices_within_bound<ScreeningMath>();
+}
+
+TEST_F(BlackScholesTest, FastMathHandlesZeroVolatility) {
+    double S[] = {100.0, 100.0};
+    double K[] = {100.0, 120.0};
+    double T[] = {1.0, 1.0};
+    double r[] = {0.05, 0.05};
+    double sigma[] = {0.0, 0.0};
+    OptionType type[] = {OptionType::CALL, OptionType::PUT};
+    double prices[2];
+
+    BlackScholes::calculate_option_prices<ScreeningMath>(
+        {S, K, T, r, sigma, type, 2}, prices);
+
+    ASSERT_NEAR(prices[0], 4.8771, 0.0001);
+    ASSERT_NEAR(prices[1], 120.0 * exp(-0.05) - 100.0, 0.0001);
+}
+
+TEST_F(BlackScholesTest, CompileTimeKernelsMatchRuntime) {
+    for (std::size_t i = 0; i < kCompileTimePrices.size(); ++i) {
+        EXPECT_NEAR(kCompileTimePrices[i],
+                    BlackScholes::calculate_option_price(
+                        100.0, 100.0, kCompileTimeExpiries[i], 0.05, 0.2,
+                        OptionType::CALL),
+                    1e-12);
+    }
+    constexpr Greeks greeks = option_greeks<Put, European, ConstexprMath>(
+        {100.0, 110.0, 0.5, 0.03, 0.3});
+    Greeks expected = BlackScholes::calculate_greeks(100.0, 110.0, 0.5, 0.03,
+                                                     0.3, OptionType::PUT);
+    EXPECT_NEAR(greeks.price, expected.price, 1e-12);
+    EXPECT_NEAR(greeks.delta, expected.delta, 1e-14);
+    EXPECT_NEAR(greeks.vega, expected.vega, 1e-12);
+}
+
+TEST_F(BlackScholesTest, RuntimeApiDispatchesToKernels) {
+    Chain chain(64);
+    for (std::size_t i = 0; i < chain.S.size(); ++i) {
+        OptionInputs option = {chain.S[i], chain.K[i], chain.T[i],
+                               chain.r[i], chain.sigma[i]};
+        double expected = chain.type[i] == OptionType::CALL
+                              ? option_price<Call, European, RiskMath>(option)
+                              : option_price<Put, European, RiskMath>(option);
+        EXPECT_EQ(BlackScholes::calculate_option_price<RiskMath>(
+                      chain.S[i], chain.K[i], chain.T[i], chain.r[i],
+                      chain.sigma[i], chain.type[i]),
+                  expected);
+    }
+}
+
+TEST_F(BlackScholesTest, ValidatedBatchSkipsRepeatedChecks) {
+    Chain chain(33);
+    std::vector<double> checked(chain.S.size());
+    std::vector<double> prevalidated(chain.S.size());
+    const ValidatedOptionBatch batch(chain.view());
+
+    BlackScholes::calculate_option_prices(chain.view(), checked.data());
+    BlackScholes::calculate_option_prices(batch, prevalidated.data());
+    EXPECT_EQ(checked, prevalidated);
+
+    GreeksBatch out = {};
+    out.price = prevalidated.data();
+    BlackScholes::calculate_greeks<ScreeningMath>(batch, out);
+    for (std::size_t i = 0; i < checked.size(); ++i) {
+        EXPECT_NEAR(prevalidated[i], checked[i],
+                    ScreeningMath::MAX_ERROR * (chain.S[i] + chain.K[i]));
+    }
+
+    chain.K[5] = 0.0;
+    EXPECT_THROW(ValidatedOptionBatch{chain.view()}, std::invalid_argument);
+}
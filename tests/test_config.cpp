@@ -0,0 +1,248 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "config/config.h"
+#include "config/config_store.h"
+#include "gtest/gtest.h"
+
+namespace thales {
+
+namespace {
+
+/**
+ * @brief A configuration directory, removed when the test ends.
+ */
+class ConfigDirectory {
+   public:
+    ConfigDirectory()
+        : path((std::filesystem::temp_directory_path() /
+                ("thales_config_" + std::to_string(::getpid()) + "_" +
+                 ::testing::UnitTest::GetInstance()
+                     ->current_test_info()
+                     ->name()))
+                   .string()) {
+        std::filesystem::create_directories(path);
+    }
+
+    ~ConfigDirectory() { std::filesystem::remove_all(path); }
+
+    /** @brief Saves a file the way editors do: write, then rename. */
+    void write(const std::string& name, const std::string& text) const {
+        std::string temporary = path + "/." + name + ".tmp";
+        std::ofstream(temporary) << text;
+        std::filesystem::rename(temporary, path + "/" + name);
+    }
+
+    const std::string path;
+};
+
+/** @brief Waits for a store to publish past a version. */
+bool wait_for_version(const ConfigStore& store, std::uint64_t version) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (store.version() <= version) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+}  // namespace
+
+TEST(ConfigValueTest, ParsesTypesOnce) {
+    ConfigValue number("2.5");
+    EXPECT_TRUE(number.is_number());
+    EXPECT_FALSE(number.is_bool());
+    EXPECT_EQ(number.as_double(), 2.5);
+    EXPECT_THROW(number.as_int(), std::invalid_argument);
+    EXPECT_THROW(number.as_bool(), std::invalid_argument);
+
+    ConfigValue integer("-42");
+    EXPECT_EQ(integer.as_int(), -42);
+    EXPECT_EQ(ConfigValue("1e3").as_int(), 1000);
+    EXPECT_THROW(ConfigValue("1e30").as_int(), std::invalid_argument);
+
+    EXPECT_TRUE(ConfigValue("Yes").as_bool());
+    EXPECT_TRUE(ConfigValue("1").as_bool());
+    EXPECT_FALSE(ConfigValue("OFF").as_bool());
+    EXPECT_FALSE(ConfigValue("false").as_bool());
+
+    ConfigValue text("polygon.io");
+    EXPECT_EQ(text.text(), "polygon.io");
+    EXPECT_FALSE(text.is_number());
+    EXPECT_THROW(text.as_double(), std::invalid_argument);
+    EXPECT_FALSE(ConfigValue("").is_number());
+    EXPECT_FALSE(ConfigValue("inf").is_number());
+}
+
+TEST(ConfigSnapshotTest, ReadsEveryFileAsASection) {
+    ConfigDirectory directory;
+    directory.write("risk.cfg", "LIMIT=10\nENABLED=true\n");
+    directory.write("feed.cfg", "# Market data\nHOST = example.com\n");
+    directory.write("notes.txt", "NOT=read\n");
+    ConfigSnapshot config = ConfigSnapshot::read_directory(directory.path);
+
+    EXPECT_EQ(config.size(), 3u);
+    EXPECT_EQ(config.get_int("risk", "LIMIT", 0), 10);
+    EXPECT_TRUE(config.get_bool("risk", "ENABLED", false));
+    EXPECT_EQ(config.get("feed", "HOST").text(), "example.com");
+    EXPECT_EQ(config.find("notes", "NOT"), nullptr);
+    EXPECT_EQ(config.section("missing"), nullptr);
+    ASSERT_NE(config.section("risk"), nullptr);
+    EXPECT_EQ(config.section("risk")->size(), 2u);
+
+    // Fallbacks cover missing values only
+    EXPECT_EQ(config.get_double("risk", "OTHER", 1.5), 1.5);
+    EXPECT_EQ(config.get_int("other", "LIMIT", 7), 7);
+    EXPECT_THROW(config.get_double("feed", "HOST", 0.0),
+                 std::invalid_argument);
+    EXPECT_THROW(config.get("risk", "OTHER"), std::invalid_argument);
+
+    // Moving keeps the keys, which are views of the snapshot's strings
+    ConfigSnapshot moved = std::move(config);
+    EXPECT_EQ(moved.get_int("risk", "LIMIT", 0), 10);
+}
+
+TEST(ConfigSnapshotTest, ReadsShippedConfiguration) {
+    ConfigSnapshot config =
+        ConfigSnapshot::read_directory(THALES_TEST_CONFIG_DIR);
+    EXPECT_EQ(config.get_int("risk_management", "MAX_POSITION", 0), 500);
+    EXPECT_NE(config.section("risk_management"), nullptr);
+}
+
+TEST(ConfigSnapshotTest, RejectsBadDirectories) {
+    EXPECT_THROW(ConfigSnapshot::read_directory("/nonexistent/thales"),
+                 std::runtime_error);
+    ConfigDirectory directory;
+    directory.write("bad.cfg", "NO_EQUALS\n");
+    EXPECT_THROW(ConfigSnapshot::read_directory(directory.path),
+                 std::invalid_argument);
+}
+
+TEST(ConfigStoreTest, ReloadSwapsSnapshot) {
+    ConfigDirectory directory;
+    directory.write("risk.cfg", "LIMIT=10\n");
+    ConfigStore store(directory.path);
+    EXPECT_EQ(store.version(), 1u);
+    const ConfigSnapshot& first = store.current();
+    EXPECT_EQ(first.get_int("risk", "LIMIT", 0), 10);
+
+    directory.write("risk.cfg", "LIMIT=20\n");
+    // Nothing changes until the store rereads the directory
+    EXPECT_EQ(store.current().get_int("risk", "LIMIT", 0), 10);
+    EXPECT_TRUE(store.reload());
+    EXPECT_EQ(store.version(), 2u);
+    EXPECT_EQ(store.current().get_int("risk", "LIMIT", 0), 20);
+    // Earlier snapshots stay valid for readers still holding them
+    EXPECT_EQ(first.get_int("risk", "LIMIT", 0), 10);
+
+    directory.write("risk.cfg", "LIMIT=30\nLIMIT=40\n");
+    EXPECT_FALSE(store.reload());
+    EXPECT_NE(store.last_error().find("duplicate key"), std::string::npos);
+    EXPECT_EQ(store.version(), 2u);
+    EXPECT_EQ(store.current().get_int("risk", "LIMIT", 0), 20);
+
+    EXPECT_THROW(ConfigStore("/nonexistent/thales"), std::runtime_error);
+}
+
+TEST(ConfigStoreTest, FirstReadSkipsMalformedFiles) {
+    ConfigDirectory directory;
+    directory.write("polygon_credentials.cfg", "API_KEY=abc123\n");
+    directory.write("trading_strategy.cfg", "HALF_EDITED\n");
+    std::string skipped;
+    ConfigSnapshot partial =
+        ConfigSnapshot::read_directory(directory.path, skipped);
+    EXPECT_EQ(partial.get("polygon_credentials", "API_KEY").text(), "abc123");
+    EXPECT_EQ(partial.section("trading_strategy"), nullptr);
+    EXPECT_NE(skipped.find("trading_strategy.cfg"), std::string::npos);
+
+    ConfigStore store(directory.path);
+    EXPECT_EQ(store.current().get("polygon_credentials", "API_KEY").text(),
+              "abc123");
+    EXPECT_NE(store.last_error().find("expected KEY=VALUE"),
+              std::string::npos);
+
+    // Reloads stay all or nothing, then bring the fixed file in
+    EXPECT_FALSE(store.reload());
+    directory.write("trading_strategy.cfg", "STRATEGY=momentum\n");
+    EXPECT_TRUE(store.reload());
+    EXPECT_EQ(store.current().get("trading_strategy", "STRATEGY").text(),
+              "momentum");
+}
+
+TEST(ConfigStoreTest, WatchReloadsOnChange) {
+    ConfigDirectory directory;
+    directory.write("risk.cfg", "LIMIT=10\n");
+    ConfigStore store(directory.path);
+    store.watch();
+    store.watch();
+
+    directory.write("risk.cfg", "LIMIT=25\n");
+    ASSERT_TRUE(wait_for_version(store, 1));
+    EXPECT_EQ(store.current().get_int("risk", "LIMIT", 0), 25);
+
+    // A broken save is not published
+    std::uint64_t version = store.version();
+    directory.write("risk.cfg", "BROKEN\n");
+    directory.write("feed.cfg", "HOST=example.com\n");
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(store.version(), version);
+    EXPECT_EQ(store.current().get_int("risk", "LIMIT", 0), 25);
+    EXPECT_FALSE(store.last_error().empty());
+
+    directory.write("risk.cfg", "LIMIT=30\n");
+    ASSERT_TRUE(wait_for_version(store, version));
+    EXPECT_EQ(store.current().get_int("risk", "LIMIT", 0), 30);
+    EXPECT_EQ(store.current().get("feed", "HOST").text(), "example.com");
+    store.stop();
+    store.stop();
+}
+
+TEST(ConfigTest, ReadsApiKeyFromConfiguredDirectory) {
+    ConfigDirectory directory;
+    directory.write("polygon_credentials.cfg", "API_KEY=abc123\n");
+    ::setenv("THALES_CONFIG_DIR", directory.path.c_str(), 1);
+    EXPECT_EQ(Config::get_api_key(), "abc123");
+    EXPECT_EQ(Config::store().get_directory(), directory.path);
+    EXPECT_EQ(&Config::store(), &Config::store());
+}
+
+}  // namespace thales
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
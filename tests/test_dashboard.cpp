@@ -0,0 +1,165 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "trading/dashboard.h"
+#include "utils/terminal_screen.h"
+
+namespace thales {
+
+namespace {
+
+/**
+ * @brief Reads whatever is buffered in a non-blocking pipe.
+ */
+std::string drain(int fd) {
+    std::string text;
+    char buffer[4096];
+    ssize_t length;
+    while ((length = ::read(fd, buffer, sizeof(buffer))) > 0) {
+        text.append(buffer, static_cast<std::size_t>(length));
+    }
+    return text;
+}
+
+class DashboardTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        ASSERT_EQ(::pipe(fds), 0);
+        ::fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    }
+
+    void TearDown() override {
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+
+    int fds[2];
+};
+
+}  // namespace
+
+TEST(TerminalScreenTest, RendersOnlyChangedCells) {
+    TerminalScreen screen(3, 10);
+    std::string out;
+    screen.put(0, 0, "hello");
+    screen.render(out);
+    EXPECT_EQ(out, "\x1b[0m\x1b[2J\x1b[1;1H\x1b[0mhello");
+
+    // Same frame: nothing to send
+    out.clear();
+    screen.clear();
+    screen.put(0, 0, "hello");
+    screen.render(out);
+    EXPECT_TRUE(out.empty());
+
+    // One changed cell, then a styled run elsewhere
+    out.clear();
+    screen.clear();
+    screen.put(0, 0, "hallo");
+    screen.put(2, 8, "!!", CellStyle::NEGATIVE);
+    screen.render(out);
+    EXPECT_EQ(out, "\x1b[1;2H\x1b[0ma\x1b[3;9H\x1b[0;31m!!\x1b[0m");
+
+    // Removed text is blanked
+    out.clear();
+    screen.clear();
+    screen.put(0, 0, "hallo");
+    screen.render(out);
+    EXPECT_EQ(out, "\x1b[3;9H\x1b[0m  ");
+}
+
+TEST(TerminalScreenTest, ClipsAndSanitizes) {
+    TerminalScreen screen(2, 4);
+    EXPECT_EQ(screen.put(1, 2, "abc\n"), 6u);
+    screen.put(5, 0, "off screen");
+    std::string out;
+    screen.render(out);
+    EXPECT_NE(out.find("ab"), std::string::npos);
+    EXPECT_EQ(out.find("c"), std::string::npos);
+
+    screen.invalidate();
+    out.clear();
+    screen.render(out);
+    EXPECT_EQ(out.rfind("\x1b[2J"), std::string("\x1b[0m").size());
+}
+
+TEST_F(DashboardTest, RedrawsOnlyOnPublishedChanges) {
+    Dashboard dashboard(fds[1], 20, 80);
+    Portfolio portfolio(10000.0);
+    portfolio.add_position(
+        Position("AAPL", "Call", 150.0, "2024-12-15", 10, 5.0));
+    portfolio.add_position(
+        Position("TSLA", "Put", 700.0, "2024-12-15", -5, 10.0));
+    dashboard.publish(portfolio);
+    dashboard.publish(std::pmr::vector<Order>{
+        Order("Buy", "AAPL", "Call", 150.0, "2024-12-15", 10, 5.0,
+              "2024-06-15T10:15:00Z")});
+
+    std::size_t first = dashboard.render();
+    std::string frame = drain(fds[0]);
+    EXPECT_EQ(frame.size(), first);
+    EXPECT_NE(frame.find("AAPL"), std::string::npos);
+    EXPECT_NE(frame.find("Net liquidity: $10000.00"), std::string::npos);
+    EXPECT_NE(frame.find("2024-06-15T10:15:00Z"), std::string::npos);
+
+    // Nothing published: no frame at all
+    EXPECT_EQ(dashboard.render(), 0u);
+
+    // Republishing identical data produces an empty diff
+    dashboard.publish(portfolio);
+    EXPECT_EQ(dashboard.render(), 0u);
+
+    // A quantity change rewrites a couple of cells, not the screen
+    portfolio.set_position(0, 12, 5.0);
+    dashboard.publish(portfolio);
+    std::size_t update = dashboard.render();
+    EXPECT_GT(update, 0u);
+    EXPECT_LT(update, 32u);
+    EXPECT_NE(drain(fds[0]).find('2'), std::string::npos);
+}
+
+TEST_F(DashboardTest, SummarizesPositionsThatDoNotFit) {
+    Dashboard dashboard(fds[1], 10, 80);
+    Portfolio portfolio;
+    for (int i = 0; i < 1000; ++i) {
+        portfolio.add_position(
+            Position("SPY", "Call", 400.0 + i, "2024-12-20", 1, 2.0));
+    }
+    dashboard.publish(portfolio);
+    dashboard.render();
+    std::string frame = drain(fds[0]);
+    // Blanks are skipped over with cursor moves, so look for single words
+    EXPECT_NE(frame.find("996"), std::string::npos);
+    EXPECT_NE(frame.find("positions"), std::string::npos);
+    EXPECT_EQ(frame.find("404.00"), std::string::npos);
+}
+
+}  // namespace thales
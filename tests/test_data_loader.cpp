@@ -0,0 +1,112 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "data/data_loader.h"
+#include "gtest/gtest.h"
+
+namespace thales {
+
+TEST(PolygonFeedParserTest, ParsesQuotes) {
+    PolygonFeedParser parser;
+    std::vector<Quote> quotes;
+    std::string message =
+        R"([{"ev":"Q","sym":"O:SPY241220C00500000","bx":302,"ax":302,)"
+        R"("bp":9.71,"ap":9.81,"bs":17,"as":24,"t":1644506128351,)"
+        R"("q":844090872},)"
+        R"( {"ev":"Q","sym":"MSFT","bx":4,"bp":114.125,"bs":100,"ax":7,)"
+        R"("ap":114.128,"as":160,"c":0,"i":[604],"t":1536036818784,"z":3}])";
+    ASSERT_EQ(parser.parse(message, quotes), 2u);
+    ASSERT_EQ(quotes.size(), 2u);
+
+    EXPECT_EQ(SymbolTable::name(quotes[0].symbol), "O:SPY241220C00500000");
+    EXPECT_DOUBLE_EQ(quotes[0].bid_price, 9.71);
+    EXPECT_DOUBLE_EQ(quotes[0].ask_price, 9.81);
+    EXPECT_EQ(quotes[0].bid_size, 17u);
+    EXPECT_EQ(quotes[0].ask_size, 24u);
+    EXPECT_EQ(quotes[0].timestamp_ns, 1644506128351000000LL);
+
+    EXPECT_EQ(SymbolTable::name(quotes[1].symbol), "MSFT");
+    EXPECT_DOUBLE_EQ(quotes[1].bid_price, 114.125);
+    EXPECT_DOUBLE_EQ(quotes[1].ask_price, 114.128);
+}
+
+TEST(PolygonFeedParserTest, SkipsOtherEventsAndTracksStatus) {
+    PolygonFeedParser parser;
+    std::vector<Quote> quotes;
+    EXPECT_EQ(parser.parse(R"([{"ev":"status","status":"connected",)"
+                           R"("message":"Connected \"ok\""}])",
+                           quotes),
+              0u);
+    EXPECT_EQ(parser.status(), "connected");
+
+    std::string message =
+        R"([{"ev":"T","sym":"AAPL","p":150.1,"s":100,"c":[12,37],)"
+        R"("x":{"nested":[1,{"a":"]"}]},"t":1},)"
+        R"({"ev":"status","status":"auth_success","message":"authenticated"},)"
+        R"({"ev":"Q","sym":"AAPL","bp":150.0,"ap":150.2,"t":2}])";
+    EXPECT_EQ(parser.parse(message, quotes), 1u);
+    EXPECT_EQ(parser.status(), "auth_success");
+    EXPECT_EQ(quotes.back().timestamp_ns, 2000000);
+    EXPECT_EQ(parser.parse("[]", quotes), 0u);
+}
+
+TEST(PolygonFeedParserTest, RejectsMalformedMessages) {
+    PolygonFeedParser parser;
+    std::vector<Quote> quotes;
+    for (const char* message :
+         {"", "[", R"([{"ev":"Q")", R"([{"ev":"Q","bp":}])",
+          R"([{"ev":"Q","bp":1.0}] trailing)", R"([{"ev":"Q,"bp":1}])"}) {
+        EXPECT_THROW(parser.parse(message, quotes), std::invalid_argument)
+            << message;
+    }
+}
+
+TEST(MarketDataStreamTest, ReportsConnectionErrorsAndStops) {
+    QuoteQueue queue(1024);
+    MarketDataStreamSettings settings;
+    // Nothing listens on port 1, so every attempt fails immediately
+    settings.url = "ws://127.0.0.1:1/";
+    settings.max_reconnect_delay_ms = 50;
+    MarketDataStream stream(settings, queue);
+    stream.start();
+    for (int i = 0; i < 100 && stream.last_error().empty(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_FALSE(stream.last_error().empty());
+    stream.stop();
+    EXPECT_EQ(stream.quotes_received(), 0u);
+}
+
+}  // namespace thales
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,347 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "config/config_store.h"
+#include "data/history_downloader.h"
+#include "data/tick_store.h"
+#include "gtest/gtest.h"
+#include "loopback_http_server.h"
+#include "utils/date.h"
+#include "utils/response_cache.h"
+#include "utils/token_bucket.h"
+
+namespace thales {
+
+namespace {
+
+constexpr std::int64_t kMillisPerDay = 86'400'000;
+
+/**
+ * @brief Answers aggregates requests the way Polygon does.
+ *
+ * Every day of the requested range gets one daily bar closing at the day
+ * number modulo 100. The bars are split over two pages linked by a
+ * next_url cursor, which like Polygon's carries no API key.
+ */
+LoopbackHttpServer::Response serve_aggregates(const std::string& path) {
+    std::size_t ticker_begin = path.find("/ticker/") + 8;
+    std::string ticker =
+        path.substr(ticker_begin, path.find('/', ticker_begin) - ticker_begin);
+    std::string range = path.substr(0, path.find('?'));
+    std::int32_t from = parse_date(range.substr(range.size() - 21, 10));
+    std::int32_t to = parse_date(range.substr(range.size() - 10));
+    std::int32_t middle = from + (to - from) / 2;
+    bool second_page = path.find("cursor=2") != std::string::npos;
+    std::int32_t first = second_page ? middle + 1 : from;
+    std::int32_t last = second_page ? to : middle;
+
+    std::string body =
+        R"({"ticker":")" + ticker + R"(","status":"OK","results":[)";
+    for (std::int32_t day = first; day <= last; ++day) {
+        body += day == first ? "{" : ",{";
+        body += R"("t":)" + std::to_string(day * kMillisPerDay) +
+                R"(,"o":1,"h":2,"l":0.5,"c":)" + std::to_string(day % 100) +
+                R"(,"v":100,"vw":1.5,"n":10})";
+    }
+    body += "]";
+    if (!second_page && last < to) {
+        body += R"(,"next_url":"https://api.polygon.io)" + range +
+                R"(?cursor=2")";
+    }
+    return {200, body + "}"};
+}
+
+std::int32_t utc_today() {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    return static_cast<std::int32_t>(
+        std::chrono::duration_cast<std::chrono::hours>(now).count() / 24);
+}
+
+/**
+ * @brief Gives every test its own cache and store directories.
+ */
+class HistoryDownloaderTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        root = std::filesystem::temp_directory_path() /
+               ("thales_history_" + std::to_string(::getpid()) + "_" +
+                ::testing::UnitTest::GetInstance()
+                    ->current_test_info()
+                    ->name());
+        std::filesystem::remove_all(root);
+    }
+
+    void TearDown() override { std::filesystem::remove_all(root); }
+
+    HistoryDownloadSettings settings(const LoopbackHttpServer& server,
+                                     bool cached = true) const {
+        HistoryDownloadSettings settings;
+        settings.base_url = server.url();
+        settings.api_key = "KEY";
+        settings.requests_per_second = 0.0;
+        settings.retry_delay = std::chrono::milliseconds(1);
+        if (cached) {
+            settings.cache_directory = (root / "cache").string();
+        }
+        return settings;
+    }
+
+    std::filesystem::path root;
+};
+
+}  // namespace
+
+TEST(TokenBucketTest, AllowsBurstThenRate) {
+    TokenBucket bucket(100.0, 2.0);
+    EXPECT_TRUE(bucket.try_acquire());
+    EXPECT_TRUE(bucket.try_acquire());
+    EXPECT_FALSE(bucket.try_acquire());
+
+    // Five more tokens refill at 10 ms each
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 5; ++i) {
+        bucket.acquire();
+    }
+    EXPECT_GE(std::chrono::steady_clock::now() - start,
+              std::chrono::milliseconds(45));
+
+    TokenBucket unlimited(0.0, 1.0);
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_TRUE(unlimited.try_acquire());
+    }
+    EXPECT_THROW(TokenBucket(-1.0, 1.0), std::invalid_argument);
+    EXPECT_THROW(TokenBucket(1.0, 0.5), std::invalid_argument);
+}
+
+TEST(TokenBucketTest, DrainDefersNewRequests) {
+    TokenBucket bucket(1.0, 10.0);
+    EXPECT_TRUE(bucket.try_acquire());
+    bucket.drain();
+    EXPECT_FALSE(bucket.try_acquire());
+}
+
+TEST_F(HistoryDownloaderTest, CacheRoundTripsCompressedBodies) {
+    ResponseCache cache((root / "cache").string());
+    std::string body;
+    for (int i = 0; i < 1000; ++i) {
+        body += R"({"o":130.465,"c":131.86,"h":133.41,"l":129.89},)";
+    }
+    std::string loaded;
+    EXPECT_FALSE(cache.load("/v2/aggs/a", loaded));
+    cache.store("/v2/aggs/a", body);
+    cache.store("/v2/aggs/b", "short");
+    ASSERT_TRUE(cache.load("/v2/aggs/a", loaded));
+    EXPECT_EQ(loaded, body);
+    ASSERT_TRUE(cache.load("/v2/aggs/b", loaded));
+    EXPECT_EQ(loaded, "short");
+    EXPECT_LT(std::filesystem::file_size(cache.path("/v2/aggs/a")),
+              body.size() / 10);
+
+    // A damaged entry reads as a miss and is replaced by the next store
+    {
+        std::ofstream out(cache.path("/v2/aggs/a"),
+                          std::ios::binary | std::ios::trunc);
+        out << "THALESRC garbage";
+    }
+    EXPECT_FALSE(cache.load("/v2/aggs/a", loaded));
+    cache.store("/v2/aggs/a", body);
+    EXPECT_TRUE(cache.load("/v2/aggs/a", loaded));
+    EXPECT_THROW(ResponseCache((root / "other").string(), 0),
+                 std::invalid_argument);
+}
+
+TEST_F(HistoryDownloaderTest, PlansTickersByDateRange) {
+    std::int32_t first = parse_date("2024-03-01");
+    std::vector<HistoryRequest> plan = HistoryDownloader::plan_aggregates(
+        {"SPY", "QQQ"}, first, first + 9, 1, "minute", 4);
+    ASSERT_EQ(plan.size(), 6u);
+    EXPECT_EQ(plan[0].ticker, "SPY");
+    EXPECT_EQ(plan[0].path,
+              "/v2/aggs/ticker/SPY/range/1/minute/2024-03-01/2024-03-04"
+              "?adjusted=true&sort=asc&limit=50000");
+    EXPECT_EQ(plan[2].first_day, first + 8);
+    EXPECT_EQ(plan[2].last_day, first + 9);
+    EXPECT_EQ(plan[3].ticker, "QQQ");
+    EXPECT_THROW(HistoryDownloader::plan_aggregates({"SPY"}, first, first - 1,
+                                                    1, "day", 1),
+                 std::invalid_argument);
+    EXPECT_THROW(HistoryDownloader::plan_aggregates({"SPY"}, first, first, 1,
+                                                    "day", 0),
+                 std::invalid_argument);
+}
+
+TEST_F(HistoryDownloaderTest, FollowsPagesIntoTickStore) {
+    std::atomic<int> unauthenticated{0};
+    LoopbackHttpServer server([&](const std::string& path) {
+        if (path.find("apiKey=KEY") == std::string::npos) {
+            ++unauthenticated;
+        }
+        return serve_aggregates(path);
+    });
+    HttpClient http;
+    HistoryDownloader downloader(http, settings(server, false));
+    std::int32_t first = parse_date("2024-03-01");
+    std::vector<HistoryRequest> plan = HistoryDownloader::plan_aggregates(
+        {"SPY", "QQQ", "IWM"}, first, first + 19, 1, "day", 5);
+
+    TickStore store((root / "ticks").string());
+    PolygonImporter importer(store);
+    HistoryDownloadStats stats = downloader.import_aggregates(plan, importer);
+    EXPECT_EQ(stats.requests, 12u);
+    EXPECT_EQ(stats.pages, 24u);
+    EXPECT_EQ(stats.fetched, 24u);
+    EXPECT_EQ(stats.cache_hits, 0u);
+    EXPECT_EQ(stats.failed, 0u);
+    EXPECT_GT(stats.bytes_fetched, 0u);
+    EXPECT_EQ(unauthenticated.load(), 0);
+
+    for (const char* ticker : {"SPY", "QQQ", "IWM"}) {
+        std::vector<std::int32_t> days = store.bar_days(ticker);
+        ASSERT_EQ(days.size(), 20u) << ticker;
+        EXPECT_EQ(days.front(), first);
+        EXPECT_EQ(days.back(), first + 19);
+        BarFile bars = store.read_bars(ticker, first + 7);
+        ASSERT_EQ(bars.size(), 1u);
+        EXPECT_DOUBLE_EQ(bars.close()[0], (first + 7) % 100);
+    }
+}
+
+TEST_F(HistoryDownloaderTest, RepeatedBackfillIsServedFromCache) {
+    LoopbackHttpServer server(serve_aggregates);
+    HttpClient http;
+    std::int32_t first = parse_date("2024-03-01");
+    std::vector<HistoryRequest> plan = HistoryDownloader::plan_aggregates(
+        {"SPY", "QQQ"}, first, first + 9, 1, "day", 5);
+    std::int32_t today = utc_today();
+    plan.push_back(HistoryDownloader::plan_aggregates({"SPY"}, today - 1,
+                                                      today, 1, "day", 5)[0]);
+
+    std::size_t bars_seen = 0;
+    auto count_bars = [&](const HistoryRequest&, std::string_view body) {
+        BarColumns bars;
+        bars_seen += PolygonRestParser().parse_aggregates(body, bars);
+    };
+    {
+        HistoryDownloader downloader(http, settings(server));
+        HistoryDownloadStats stats = downloader.download(plan, count_bars);
+        EXPECT_EQ(stats.pages, 10u);
+        EXPECT_EQ(stats.fetched, 10u);
+    }
+    EXPECT_EQ(bars_seen, 22u);
+    int requests = server.requests();
+
+    // A restarted backfill only goes back to the network for today
+    bars_seen = 0;
+    HistoryDownloader downloader(http, settings(server));
+    HistoryDownloadStats stats = downloader.download(plan, count_bars);
+    EXPECT_EQ(stats.pages, 10u);
+    EXPECT_EQ(stats.cache_hits, 8u);
+    EXPECT_EQ(stats.fetched, 2u);
+    EXPECT_EQ(server.requests(), requests + 2);
+    EXPECT_EQ(bars_seen, 22u);
+}
+
+TEST_F(HistoryDownloaderTest, RetriesRateLimitedAndFailedRequests) {
+    std::atomic<int> rate_limited{2};
+    LoopbackHttpServer server([&](const std::string& path) {
+        if (path.find("/MISSING/") != std::string::npos) {
+            return LoopbackHttpServer::Response(404, R"({"status":"ERROR"})");
+        }
+        if (path.find("/BUSY/") != std::string::npos) {
+            return LoopbackHttpServer::Response(503, "");
+        }
+        if (rate_limited.fetch_sub(1) > 0) {
+            return LoopbackHttpServer::Response(429, "");
+        }
+        return serve_aggregates(path);
+    });
+    HttpClient http;
+    HistoryDownloader downloader(http, settings(server, false));
+    std::int32_t first = parse_date("2024-03-01");
+    std::vector<HistoryRequest> plan = HistoryDownloader::plan_aggregates(
+        {"SPY", "MISSING", "BUSY"}, first, first + 1, 1, "day", 2);
+
+    HistoryDownloadStats stats = downloader.download(
+        plan, [](const HistoryRequest&, std::string_view) {});
+    EXPECT_EQ(stats.pages, 2u);
+    EXPECT_EQ(stats.failed, 2u);
+    // Two rate limit responses, then three more tries of the busy ticker;
+    // the missing one is not retried
+    EXPECT_EQ(stats.retries, 5u);
+}
+
+TEST_F(HistoryDownloaderTest, RejectedPagesAreNotCached) {
+    LoopbackHttpServer server(serve_aggregates);
+    HttpClient http;
+    HistoryDownloader downloader(http, settings(server));
+    std::int32_t first = parse_date("2024-03-01");
+    std::vector<HistoryRequest> plan = HistoryDownloader::plan_aggregates(
+        {"SPY"}, first, first + 1, 1, "day", 2);
+
+    HistoryDownloadStats stats = downloader.download(
+        plan, [](const HistoryRequest&, std::string_view) {
+            throw std::invalid_argument("Malformed");
+        });
+    EXPECT_EQ(stats.pages, 0u);
+    EXPECT_EQ(stats.failed, 1u);
+    std::string body;
+    EXPECT_FALSE(
+        ResponseCache(settings(server).cache_directory).load(plan[0].path,
+                                                             body));
+}
+
+TEST_F(HistoryDownloaderTest, LoadsSettingsFromConfiguration) {
+    ConfigSnapshot config;
+    config.set("polygon_credentials", "API_KEY", "SECRET");
+    config.set("data_sources", "HISTORY_REQUESTS_PER_MINUTE", "300");
+    config.set("data_sources", "HISTORY_MAX_IN_FLIGHT", "16");
+    config.set("data_sources", "HISTORY_CACHE_DIR", "cache");
+    HistoryDownloadSettings settings = HistoryDownloadSettings::load(config);
+    EXPECT_EQ(settings.api_key, "SECRET");
+    EXPECT_DOUBLE_EQ(settings.requests_per_second, 5.0);
+    EXPECT_EQ(settings.max_in_flight, 16u);
+    EXPECT_EQ(settings.max_attempts, 4);
+    EXPECT_EQ(settings.cache_directory, "cache");
+
+    config.set("data_sources", "HISTORY_MAX_ATTEMPTS", "0");
+    EXPECT_THROW(HistoryDownloadSettings::load(config), std::invalid_argument);
+}
+
+}  // namespace thales
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,108 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "loopback_http_server.h"
+#include "utils/http_client.h"
+
+namespace thales {
+
+TEST(HttpClientTest, GetReturnsBody) {
+    LoopbackHttpServer server;
+    HttpClient client;
+    EXPECT_EQ(client.get(server.url() + "/v2/aggs"), "/v2/aggs");
+}
+
+TEST(HttpClientTest, SequentialRequestsReuseOneConnection) {
+    LoopbackHttpServer server;
+    HttpClient client;
+    for (int i = 0; i < 20; ++i) {
+        std::string path = "/ticker/" + std::to_string(i);
+        EXPECT_EQ(client.get(server.url() + path), path);
+    }
+    EXPECT_EQ(server.connections(), 1);
+}
+
+TEST(HttpClientTest, GetAllKeepsOrderAndBoundsConnections) {
+    LoopbackHttpServer server;
+    HttpClient client(4);
+    std::vector<std::string> urls;
+    for (int i = 0; i < 50; ++i) {
+        urls.push_back(server.url() + "/ticker/" + std::to_string(i));
+    }
+    std::vector<HttpResponse> responses = client.get_all(urls);
+    ASSERT_EQ(responses.size(), urls.size());
+    for (std::size_t i = 0; i < responses.size(); ++i) {
+        EXPECT_TRUE(responses[i].ok()) << responses[i].error;
+        EXPECT_EQ(responses[i].body, "/ticker/" + std::to_string(i));
+    }
+    EXPECT_LE(server.connections(), 4);
+}
+
+TEST(HttpClientTest, ErrorStatusIsReported) {
+    LoopbackHttpServer server;
+    HttpClient client;
+    HttpResponse response =
+        client.get_async(server.url() + "/status/404").get();
+    EXPECT_EQ(response.status, 404);
+    EXPECT_TRUE(response.error.empty());
+    EXPECT_FALSE(response.ok());
+    EXPECT_THROW(client.get(server.url() + "/status/503"), std::runtime_error);
+}
+
+TEST(HttpClientTest, TransportErrorIsReported) {
+    HttpClient client;
+    // Port 1 on loopback is closed, so the connection is refused
+    HttpResponse response = client.get_async("http://127.0.0.1:1/").get();
+    EXPECT_EQ(response.status, 0);
+    EXPECT_FALSE(response.error.empty());
+    EXPECT_THROW(client.get("http://127.0.0.1:1/"), std::runtime_error);
+}
+
+TEST(HttpClientTest, LatencyStats) {
+    LoopbackHttpServer server;
+    HttpClient client;
+    EXPECT_EQ(client.latency_stats().count, 0u);
+    for (int i = 0; i < 10; ++i) {
+        client.get(server.url() + "/");
+    }
+    HttpLatencyStats stats = client.latency_stats();
+    EXPECT_EQ(stats.count, 10u);
+    EXPECT_GT(stats.p50_us, 0.0);
+    EXPECT_LE(stats.p50_us, stats.p90_us);
+    EXPECT_LE(stats.p90_us, stats.p99_us);
+    EXPECT_LE(stats.p99_us, stats.max_us);
+}
+
+}  // namespace thales
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,149 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "trading/implied_volatility.h"
+
+namespace {
+
+const SimdBackend kAllBackends[] = {SimdBackend::SCALAR, SimdBackend::NEON,
+                                    SimdBackend::AVX2, SimdBackend::AVX512};
+
+}  // namespace
+
+TEST(ImpliedVolatilityTest, RecoversVolatilityOfAtTheMoneyCall) {
+    double price = BlackScholes::calculate_option_price(100.0, 100.0, 1.0,
+                                                        0.05, 0.2, CALL);
+
+    double vol = ImpliedVolatility::calculate_implied_volatility(
+        price, 100.0, 100.0, 1.0, 0.05, CALL);
+
+    EXPECT_NEAR(vol, 0.2, 1e-10);
+}
+
+TEST(ImpliedVolatilityTest, RoundTripsChainOnEveryBackend) {
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<double> moneyness(0.6, 1.6);
+    std::uniform_real_distribution<double> expiry(0.02, 2.0);
+    std::uniform_real_distribution<double> vol(0.05, 1.5);
+
+    const std::size_t n = 2003;
+    std::vector<double> S(n, 100.0), K(n), T(n), r(n, 0.03), sigma(n),
+        prices(n), vols(n);
+    std::vector<OptionType> type(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        K[i] = 100.0 * moneyness(gen);
+        T[i] = expiry(gen);
+        sigma[i] = vol(gen);
+        type[i] = i % 2 == 0 ? CALL : PUT;
+        prices[i] = BlackScholes::calculate_option_price(S[i], K[i], T[i],
+                                                         r[i], sigma[i],
+                                                         type[i]);
+    }
+    OptionBatch batch = {S.data(), K.data(), T.data(),
+                         r.data(), nullptr,  type.data(), n};
+
+    for (SimdBackend backend : kAllBackends) {
+        if (!BlackScholes::is_simd_backend_supported(backend)) {
+            continue;
+        }
+        std::size_t solved = ImpliedVolatility::calculate_implied_volatilities(
+            batch, prices.data(), vols.data(), {}, backend);
+
+        std::size_t checked = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            double vega = BlackScholes::calculate_greeks(S[i], K[i], T[i],
+                                                         r[i], sigma[i],
+                                                         type[i])
+                              .vega;
+            if (vega > 1e-3) {
+                ASSERT_NEAR(vols[i], sigma[i], 1e-8) << "option " << i;
+                ++checked;
+            } else if (!std::isnan(vols[i])) {
+                // Prices with almost no time value barely pin down sigma,
+                // but any solution that is reported must reprice the option.
+                double repriced = BlackScholes::calculate_option_price(
+                    S[i], K[i], T[i], r[i], vols[i], type[i]);
+                ASSERT_NEAR(repriced, prices[i], 1e-9) << "option " << i;
+            }
+        }
+        EXPECT_GE(solved, checked);
+        EXPECT_GT(checked, n / 2);
+    }
+}
+
+TEST(ImpliedVolatilityTest, ArbitragePricesHaveNoSolution) {
+    // Below intrinsic value
+    EXPECT_TRUE(std::isnan(ImpliedVolatility::calculate_implied_volatility(
+        10.0, 120.0, 100.0, 1.0, 0.0, CALL)));
+    // Above the stock price
+    EXPECT_TRUE(std::isnan(ImpliedVolatility::calculate_implied_volatility(
+        101.0, 100.0, 100.0, 1.0, 0.0, CALL)));
+    // Above the discounted strike
+    EXPECT_TRUE(std::isnan(ImpliedVolatility::calculate_implied_volatility(
+        99.0, 100.0, 100.0, 1.0, 0.05, PUT)));
+    // Expired
+    EXPECT_TRUE(std::isnan(ImpliedVolatility::calculate_implied_volatility(
+        5.0, 100.0, 100.0, 0.0, 0.05, CALL)));
+}
+
+TEST(ImpliedVolatilityTest, IterationCapReportsUnconverged) {
+    double S = 100.0, K = 180.0, T = 0.25, r = 0.01;
+    OptionType type = CALL;
+    double price =
+        BlackScholes::calculate_option_price(S, K, T, r, 0.9, type);
+    double vol;
+    OptionBatch batch = {&S, &K, &T, &r, nullptr, &type, 1};
+
+    ImpliedVolatilitySettings settings;
+    settings.max_iterations = 1;
+    EXPECT_EQ(ImpliedVolatility::calculate_implied_volatilities(
+                  batch, &price, &vol, settings),
+              0u);
+    EXPECT_TRUE(std::isnan(vol));
+
+    EXPECT_EQ(ImpliedVolatility::calculate_implied_volatilities(batch, &price,
+                                                                &vol),
+              1u);
+    EXPECT_NEAR(vol, 0.9, 1e-8);
+}
+
+TEST(ImpliedVolatilityTest, InvalidInputThrows) {
+    ImpliedVolatilitySettings settings;
+    settings.tolerance = 0.0;
+    EXPECT_THROW(ImpliedVolatility::calculate_implied_volatility(
+                     10.0, 100.0, 100.0, 1.0, 0.05, CALL, settings),
+                 std::invalid_argument);
+    EXPECT_THROW(ImpliedVolatility::calculate_implied_volatility(
+                     10.0, -100.0, 100.0, 1.0, 0.05, CALL),
+                 std::invalid_argument);
+    EXPECT_THROW(ImpliedVolatility::calculate_implied_volatility(
+                     10.0, 100.0, 100.0, 1.0, 0.05,
+                     static_cast<OptionType>(-1)),
+                 std::invalid_argument);
+}
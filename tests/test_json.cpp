@@ -0,0 +1,266 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "data/json.h"
+#include "data/polygon_rest.h"
+#include "gtest/gtest.h"
+#include "utils/date.h"
+
+namespace thales {
+
+namespace {
+
+const SimdBackend kBackends[] = {SimdBackend::SCALAR, SimdBackend::AUTO};
+
+/**
+ * @brief Collects a flat description of a document by walking it.
+ */
+void walk(JsonCursor& in, std::string& out) {
+    char c = in.peek();
+    if (c == '{') {
+        out += '{';
+        in.for_each_field([&](std::string_view key) {
+            out.append(key).append("=");
+            walk(in, out);
+            out += ';';
+        });
+        out += '}';
+    } else if (c == '[') {
+        out += '[';
+        in.for_each_element([&] {
+            walk(in, out);
+            out += ';';
+        });
+        out += ']';
+    } else if (c == '"') {
+        out.append("s:").append(in.get_string());
+    } else if (in.is_null()) {
+        out += "null";
+    } else if (c == 't' || c == 'f') {
+        in.skip();
+        out += c;
+    } else {
+        out += std::to_string(in.get_number());
+    }
+}
+
+std::string walk(std::string_view text, SimdBackend backend) {
+    JsonParser parser(backend);
+    JsonCursor in = parser.parse(text);
+    std::string out;
+    walk(in, out);
+    in.expect_end();
+    return out;
+}
+
+}  // namespace
+
+TEST(JsonTest, WalksValues) {
+    std::string text =
+        R"( {"a": 1.5, "b" : [1, -2e3, "x,y:{}"], "c":{}, "d":[],)"
+        "\n\t\"e\": null, \"f\": true, \"g\": {\"h\": [ {\"i\" : 0} ]}} ";
+    for (SimdBackend backend : kBackends) {
+        EXPECT_EQ(walk(text, backend),
+                  "{a=1.500000;b=[1.000000;-2000.000000;s:x,y:{};];c={};"
+                  "d=[];e=null;f=t;g={h=[{i=0.000000;};];};}");
+    }
+}
+
+TEST(JsonTest, HandlesEscapesAcrossBlocks) {
+    // Place escaped quotes and backslash runs on every offset around the
+    // 64-byte block boundaries
+    for (std::size_t pad = 0; pad < 70; ++pad) {
+        std::string value = std::string(pad, 'p') +
+                            R"(\"q\\\"r\\\\"s)";
+        value.erase(value.size() - 2);  // drop the unbalanced quote
+        std::string text = "[\"" + value + "\", {\"k\": \"]\"}]";
+        for (SimdBackend backend : kBackends) {
+            EXPECT_EQ(walk(text, backend),
+                      "[s:" + value + ";{k=s:];};]")
+                << "pad " << pad;
+        }
+    }
+}
+
+TEST(JsonTest, SkipsNestedValues) {
+    JsonParser parser;
+    JsonCursor in = parser.parse(
+        R"({"skip": {"a": [1, {"b": "}]"}], "c": {"d": []}}, "keep": 7})");
+    double keep = 0;
+    in.for_each_field([&](std::string_view key) {
+        if (key == "keep") {
+            keep = in.get_number();
+        } else {
+            in.skip();
+        }
+    });
+    in.expect_end();
+    EXPECT_EQ(keep, 7.0);
+}
+
+TEST(JsonTest, BackendsAgreeOnRandomDocuments) {
+    std::mt19937 rng(7);
+    const char alphabet[] = "{}[]:,\"\\ ab1";
+    for (int round = 0; round < 200; ++round) {
+        std::string text(1 + rng() % 300, ' ');
+        for (char& c : text) {
+            c = alphabet[rng() % (sizeof(alphabet) - 1)];
+        }
+        // Compare the outcome of walking arbitrary, mostly invalid text
+        std::string results[2];
+        for (int b = 0; b < 2; ++b) {
+            try {
+                results[b] = walk(text, kBackends[b]);
+            } catch (const std::invalid_argument& e) {
+                results[b] = std::string("error: ") + e.what();
+            }
+        }
+        EXPECT_EQ(results[0], results[1]) << text;
+    }
+}
+
+TEST(JsonTest, RejectsMalformedDocuments) {
+    for (const char* text :
+         {"", "{", "[1,]", "{\"a\" 1}", "{\"a\":}", "[1 2]", "\"open",
+          "{\"a\":1}}", "[1.5x]", "{1:2}"}) {
+        EXPECT_THROW(walk(text, SimdBackend::AUTO), std::invalid_argument)
+            << text;
+    }
+    EXPECT_THROW(JsonParser(SimdBackend::NEON), std::invalid_argument);
+}
+
+TEST(PolygonRestTest, ParsesAggregates) {
+    std::string body = R"({"ticker":"AAPL","queryCount":2,"resultsCount":2,)"
+        R"("adjusted":true,"results":[{"v":7.0790813e+07,"vw":131.6292,)"
+        R"("o":130.465,"c":131.86,"h":133.41,"l":129.89,"t":1673240400000,)"
+        R"("n":645365},{"v":63896155,"vw":130.3005,"o":131.25,"c":130.73,)"
+        R"("h":131.2636,"l":128.12,"t":1673326800000,"n":554940}],)"
+        R"("status":"OK","request_id":"6a7e466379af0a71039d60cc78e72282",)"
+        R"("count":2})";
+    for (SimdBackend backend : kBackends) {
+        PolygonRestParser parser(backend);
+        BarColumns bars;
+        ASSERT_EQ(parser.parse_aggregates(body, bars), 2u);
+        EXPECT_EQ(SymbolTable::name(bars.symbol[1]), "AAPL");
+        EXPECT_EQ(bars.timestamp_ns[0], 1673240400000LL * 1000000);
+        EXPECT_DOUBLE_EQ(bars.open[0], 130.465);
+        EXPECT_DOUBLE_EQ(bars.high[0], 133.41);
+        EXPECT_DOUBLE_EQ(bars.low[1], 128.12);
+        EXPECT_DOUBLE_EQ(bars.close[1], 130.73);
+        EXPECT_DOUBLE_EQ(bars.volume[0], 70790813.0);
+        EXPECT_DOUBLE_EQ(bars.vwap[1], 130.3005);
+        EXPECT_EQ(bars.trades[1], 554940u);
+    }
+}
+
+TEST(PolygonRestTest, ParsesGroupedDaily) {
+    PolygonRestParser parser;
+    BarColumns bars;
+    EXPECT_EQ(parser.parse_aggregates(
+                  R"({"results":[{"T":"KIMpL","o":25.1,"c":25.2},)"
+                  R"({"T":"TSLA","o":200,"c":199}],"status":"OK"})",
+                  bars),
+              2u);
+    EXPECT_EQ(SymbolTable::name(bars.symbol[0]), "KIMpL");
+    EXPECT_EQ(SymbolTable::name(bars.symbol[1]), "TSLA");
+}
+
+TEST(PolygonRestTest, FindsNextPage) {
+    PolygonRestParser parser;
+    EXPECT_EQ(parser.next_url(R"({"ticker":"SPY","results":[{"o":1,"c":2}],)"
+                              R"("next_url":"https://api.polygon.io/v2/aggs/)"
+                              R"(ticker/SPY?cursor=YWJj","status":"OK"})"),
+              "https://api.polygon.io/v2/aggs/ticker/SPY?cursor=YWJj");
+    EXPECT_EQ(parser.next_url(R"({"results":[],"status":"OK"})"), "");
+    EXPECT_EQ(parser.next_url(R"({"next_url":null})"), "");
+    EXPECT_THROW(parser.next_url(R"({"next_url":)"), std::invalid_argument);
+}
+
+TEST(PolygonRestTest, ReportsErrors) {
+    PolygonRestParser parser;
+    BarColumns bars;
+    EXPECT_THROW(parser.parse_aggregates(
+                     R"({"status":"ERROR","request_id":"x",)"
+                     R"("error":"Unknown API Key"})",
+                     bars),
+                 std::runtime_error);
+    EXPECT_THROW(parser.parse_aggregates(R"({"results":[{"o":1}]})", bars),
+                 std::invalid_argument);
+    EXPECT_THROW(parser.parse_aggregates(R"({"results":[{"o":1})", bars),
+                 std::invalid_argument);
+}
+
+TEST(PolygonRestTest, ParsesOptionChain) {
+    std::string body = R"({"request_id":"abc","results":[{)"
+        R"("break_even_price":171.075,"day":{"change":-0.05,"close":6.35,)"
+        R"("high":7.01,"low":5.98,"open":6.9,"volume":2574},)"
+        R"("details":{"contract_type":"call","exercise_style":"american",)"
+        R"("expiration_date":"2024-12-20","shares_per_contract":100,)"
+        R"("strike_price":165,"ticker":"O:AAPL241220C00165000"},)"
+        R"("greeks":{"delta":0.5,"gamma":0.03,"theta":-0.1,"vega":0.2},)"
+        R"("implied_volatility":0.2485,)"
+        R"("last_quote":{"ask":6.4,"ask_size":10,"bid":6.15,"bid_size":5,)"
+        R"("last_updated":1702503760123456789,"midpoint":6.275,)"
+        R"("timeframe":"REAL-TIME"},"open_interest":8921,)"
+        R"("underlying_asset":{"change_to_break_even":2.4,"price":168.7,)"
+        R"("ticker":"AAPL","timeframe":"REAL-TIME"}},)"
+        R"({"details":{"contract_type":"put","strike_price":150,)"
+        R"("expiration_date":"2025-01-17","ticker":"O:AAPL250117P00150000"}}],)"
+        R"("status":"OK","next_url":"https://api.polygon.io/v3/snapshot/x"})";
+    PolygonRestParser parser;
+    OptionChainColumns chain;
+    ASSERT_EQ(parser.parse_option_chain(body, chain), 2u);
+
+    EXPECT_EQ(SymbolTable::name(chain.contract[0]), "O:AAPL241220C00165000");
+    EXPECT_EQ(SymbolTable::name(chain.underlying[0]), "AAPL");
+    EXPECT_EQ(chain.type[0], CALL);
+    EXPECT_EQ(chain.strike[0], 165.0);
+    EXPECT_EQ(chain.expiration[0], parse_date("2024-12-20"));
+    EXPECT_EQ(chain.bid[0], 6.15);
+    EXPECT_EQ(chain.ask[0], 6.4);
+    EXPECT_EQ(chain.bid_size[0], 5u);
+    EXPECT_EQ(chain.ask_size[0], 10u);
+    EXPECT_EQ(chain.implied_volatility[0], 0.2485);
+    EXPECT_EQ(chain.open_interest[0], 8921.0);
+    EXPECT_EQ(chain.underlying_price[0], 168.7);
+    EXPECT_GT(chain.timestamp_ns[0], 0);
+
+    EXPECT_EQ(chain.type[1], PUT);
+    EXPECT_EQ(chain.underlying[1], INVALID_SYMBOL);
+    EXPECT_TRUE(std::isnan(chain.bid[1]));
+    EXPECT_TRUE(std::isnan(chain.implied_volatility[1]));
+}
+
+}  // namespace thales
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
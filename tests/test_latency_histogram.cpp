@@ -0,0 +1,117 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "utils/latency_histogram.h"
+
+namespace thales {
+
+TEST(LatencyHistogramTest, EmptyHistogramReportsZero) {
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.count(), 0u);
+    EXPECT_EQ(histogram.min(), 0u);
+    EXPECT_EQ(histogram.max(), 0u);
+    EXPECT_EQ(histogram.mean(), 0.0);
+    EXPECT_EQ(histogram.percentile(50.0), 0u);
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+    LatencyHistogram histogram;
+    for (int value = 0; value < 16; ++value) {
+        histogram.record(value);
+    }
+    EXPECT_EQ(histogram.count(), 16u);
+    EXPECT_EQ(histogram.min(), 0u);
+    EXPECT_EQ(histogram.max(), 15u);
+    EXPECT_EQ(histogram.percentile(50.0), 7u);
+    EXPECT_EQ(histogram.percentile(100.0), 15u);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 7.5);
+}
+
+TEST(LatencyHistogramTest, BucketsBoundRelativeError) {
+    for (std::uint64_t value = 1; value < (std::uint64_t{1} << 40);
+         value = value * 3 / 2 + 1) {
+        std::size_t bucket = LatencyHistogram::bucket(value);
+        std::uint64_t upper = LatencyHistogram::bucket_upper(bucket);
+        EXPECT_GE(upper, value);
+        EXPECT_LE(upper - value, value / 16) << value;
+        EXPECT_EQ(LatencyHistogram::bucket(upper), bucket);
+        EXPECT_EQ(LatencyHistogram::bucket(upper + 1), bucket + 1);
+    }
+}
+
+TEST(LatencyHistogramTest, PercentilesOfUniformLatencies) {
+    LatencyHistogram histogram;
+    for (int value = 1; value <= 10000; ++value) {
+        histogram.record(value);
+    }
+    EXPECT_EQ(histogram.count(), 10000u);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 5000.5);
+    EXPECT_NEAR(histogram.percentile(50.0), 5000.0, 5000.0 / 16);
+    EXPECT_NEAR(histogram.percentile(99.0), 9900.0, 9900.0 / 16);
+    EXPECT_GE(histogram.percentile(99.0), 9900u);
+    EXPECT_EQ(histogram.percentile(100.0), 10000u);
+    EXPECT_EQ(histogram.percentile(0.0), 1u);
+}
+
+TEST(LatencyHistogramTest, ClampsOutOfRangeValues) {
+    LatencyHistogram histogram;
+    histogram.record(-5);
+    histogram.record(std::int64_t{1} << 50);
+    EXPECT_EQ(histogram.min(), 0u);
+    EXPECT_EQ(histogram.max(), std::uint64_t{1} << 50);
+    EXPECT_EQ(histogram.percentile(50.0), 0u);
+    EXPECT_EQ(histogram.percentile(100.0), std::uint64_t{1} << 50);
+}
+
+TEST(LatencyHistogramTest, MergeAndClear) {
+    LatencyHistogram fast;
+    LatencyHistogram slow;
+    for (int i = 0; i < 90; ++i) {
+        fast.record(100);
+    }
+    for (int i = 0; i < 10; ++i) {
+        slow.record(10000);
+    }
+    fast.merge(slow);
+    EXPECT_EQ(fast.count(), 100u);
+    EXPECT_EQ(fast.min(), 100u);
+    EXPECT_EQ(fast.max(), 10000u);
+    EXPECT_LE(fast.percentile(90.0), 100u + 100u / 16);
+    EXPECT_EQ(fast.percentile(91.0), 10000u);
+
+    fast.clear();
+    EXPECT_EQ(fast.count(), 0u);
+    EXPECT_EQ(fast.max(), 0u);
+    EXPECT_EQ(fast.percentile(99.0), 0u);
+}
+
+}  // namespace thales
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,238 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "trading/live_portfolio.h"
+
+namespace thales {
+
+namespace {
+
+constexpr std::int32_t TODAY = 19888;  // 2024-06-15
+
+ContractKey contract(SymbolId symbol, double strike, std::int32_t days,
+                     OptionType type = CALL) {
+    return {symbol, TODAY + days, type, strike};
+}
+
+void expect_near_risk(const UnderlyingRisk& actual,
+                      const UnderlyingRisk& expected) {
+    auto tolerance = [](double value) {
+        return 1e-9 * std::max(1.0, std::abs(value));
+    };
+    EXPECT_NEAR(actual.value, expected.value, tolerance(expected.value));
+    EXPECT_NEAR(actual.delta, expected.delta, tolerance(expected.delta));
+    EXPECT_NEAR(actual.gamma, expected.gamma, tolerance(expected.gamma));
+    EXPECT_NEAR(actual.vega, expected.vega, tolerance(expected.vega));
+    EXPECT_NEAR(actual.theta, expected.theta, tolerance(expected.theta));
+}
+
+}  // namespace
+
+TEST(LivePortfolioTest, FillsTrackAverageCostAndRealizedPnl) {
+    LivePortfolio live(0.04, TODAY);
+    SymbolId aapl = SymbolTable::intern("AAPL");
+    ContractKey call = contract(aapl, 150.0, 30);
+
+    live.apply_fill(call, Side::BUY, 10, 2.0);
+    live.apply_fill(call, Side::BUY, 10, 4.0);
+    live.apply_fill(call, Side::SELL, 15, 5.0);
+
+    UnderlyingBook book = live.underlying(aapl);
+    EXPECT_EQ(book.contracts, 5);
+    EXPECT_DOUBLE_EQ(book.cost, 5 * 3.0 * CONTRACT_MULTIPLIER);
+    EXPECT_DOUBLE_EQ(book.realized_pnl, 15 * 2.0 * CONTRACT_MULTIPLIER);
+    // No quote yet: carried at zero
+    EXPECT_EQ(book.risk.value, 0.0);
+    EXPECT_EQ(live.positions().get_quantities()[0], 5);
+    EXPECT_DOUBLE_EQ(live.positions().get_premiums()[0], 3.0);
+    EXPECT_EQ(live.version(), 3u);
+
+    // Flipping through flat opens the remainder at the fill price
+    live.apply(Order(Side::SELL, aapl, CALL, 150.0, TODAY + 30, 8, 6.0, 0));
+    book = live.underlying(aapl);
+    EXPECT_EQ(book.contracts, 3);
+    EXPECT_DOUBLE_EQ(book.cost, -3 * 6.0 * CONTRACT_MULTIPLIER);
+    EXPECT_DOUBLE_EQ(book.realized_pnl,
+                     (15 * 2.0 + 5 * 3.0) * CONTRACT_MULTIPLIER);
+    EXPECT_EQ(live.totals().contracts, 3);
+}
+
+TEST(LivePortfolioTest, MatchesFullRevaluation) {
+    LivePortfolio live(0.03, TODAY);
+    std::vector<SymbolId> symbols = {SymbolTable::intern("LIVE0"),
+                                     SymbolTable::intern("LIVE1"),
+                                     SymbolTable::intern("LIVE2")};
+    live.update_underlying(symbols[0], 100.0, 0.2);
+    for (int i = 0; i < 60; ++i) {
+        SymbolId symbol = symbols[i % 3];
+        live.apply_fill(contract(symbol, 80.0 + 5 * (i % 9), 10 + 7 * (i % 5),
+                                 i % 2 ? PUT : CALL),
+                        i % 4 == 3 ? Side::SELL : Side::BUY, 1 + i % 6,
+                        1.0 + 0.1 * i);
+    }
+    live.update_underlying(symbols[1], 95.0, 0.35);
+    live.update_underlying(symbols[2], 105.0, 0.25);
+    live.update_underlying(symbols[0], 101.5, 0.22);
+    live.apply_fill(contract(symbols[1], 95.0, 10), Side::SELL, 4, 3.0);
+
+    MarketData market;
+    market.spot.assign(SymbolTable::size(), 100.0);
+    market.volatility.assign(SymbolTable::size(), 0.2);
+    market.spot[symbols[0]] = 101.5;
+    market.volatility[symbols[0]] = 0.22;
+    market.spot[symbols[1]] = 95.0;
+    market.volatility[symbols[1]] = 0.35;
+    market.spot[symbols[2]] = 105.0;
+    market.volatility[symbols[2]] = 0.25;
+    market.rate = 0.03;
+    market.valuation_date = TODAY;
+    std::vector<UnderlyingRisk> expected;
+    live.positions().calculate_risk(market, expected);
+
+    UnderlyingBook totals;
+    std::vector<UnderlyingBook> books;
+    EXPECT_EQ(live.snapshot(totals, books), live.version());
+    UnderlyingRisk sum;
+    for (SymbolId symbol : symbols) {
+        ASSERT_LT(symbol, books.size());
+        expect_near_risk(books[symbol].risk, expected[symbol]);
+        expect_near_risk(live.underlying(symbol).risk, expected[symbol]);
+        sum.value += expected[symbol].value;
+        sum.delta += expected[symbol].delta;
+        sum.gamma += expected[symbol].gamma;
+        sum.vega += expected[symbol].vega;
+        sum.theta += expected[symbol].theta;
+    }
+    expect_near_risk(totals.risk, sum);
+    EXPECT_NEAR(totals.unrealized_pnl(),
+                live.positions().calculate_market_value(market) - totals.cost,
+                1e-6);
+}
+
+TEST(LivePortfolioTest, QuotesRevalueOnlyTheirUnderlying) {
+    LivePortfolio live(0.0, TODAY);
+    SymbolId msft = SymbolTable::intern("MSFT");
+    SymbolId nvda = SymbolTable::intern("NVDA");
+    live.update_underlying(msft, 400.0, 0.25);
+    live.update_underlying(nvda, 120.0, 0.5);
+    live.apply_fill(contract(msft, 400.0, 30), Side::BUY, 2, 10.0);
+    live.apply_fill(contract(nvda, 120.0, 30, PUT), Side::SELL, 3, 8.0);
+
+    UnderlyingBook nvda_before = live.underlying(nvda);
+    double msft_before = live.underlying(msft).risk.value;
+    std::uint64_t version = live.version();
+    live.update_underlying(msft, 410.0, 0.25);
+
+    EXPECT_EQ(live.version(), version + 1);
+    EXPECT_GT(live.underlying(msft).risk.value, msft_before);
+    EXPECT_EQ(live.underlying(nvda).risk.value, nvda_before.risk.value);
+    EXPECT_NEAR(live.totals().risk.value,
+                live.underlying(msft).risk.value + nvda_before.risk.value,
+                1e-9);
+}
+
+TEST(LivePortfolioTest, LoadsPortfolioAndSettlesExpiredPositions) {
+    SymbolId amd = SymbolTable::intern("AMD");
+    Portfolio held(0.0, {Position(amd, CALL, 150.0, TODAY + 2, 4, 6.0),
+                         Position(amd, PUT, 140.0, TODAY + 60, -2, 5.0)});
+    LivePortfolio live(0.04, TODAY);
+    live.update_underlying(amd, 150.0, 0.4);
+    live.load(held);
+    EXPECT_EQ(live.underlying(amd).contracts, 6);
+    EXPECT_DOUBLE_EQ(live.underlying(amd).cost,
+                     (4 * 6.0 - 2 * 5.0) * CONTRACT_MULTIPLIER);
+
+    live.set_valuation_date(TODAY + 3);
+    UnderlyingBook book = live.underlying(amd);
+    EXPECT_EQ(book.contracts, 2);
+    EXPECT_DOUBLE_EQ(book.cost, -2 * 5.0 * CONTRACT_MULTIPLIER);
+    EXPECT_LT(book.risk.value, 0.0);
+}
+
+TEST(LivePortfolioTest, RejectsInvalidUpdates) {
+    LivePortfolio live(0.0, TODAY, 4);
+    ContractKey call = contract(1, 100.0, 30);
+    EXPECT_THROW(live.apply_fill(call, Side::BUY, 0, 1.0),
+                 std::invalid_argument);
+    EXPECT_THROW(live.apply_fill(call, Side::BUY, 1, NAN),
+                 std::invalid_argument);
+    EXPECT_THROW(live.update_underlying(1, -1.0, 0.2), std::invalid_argument);
+    EXPECT_THROW(live.update_underlying(1, 100.0, 0.0), std::invalid_argument);
+    EXPECT_THROW(live.apply_fill(contract(4, 100.0, 30), Side::BUY, 1, 1.0),
+                 std::invalid_argument);
+    EXPECT_NO_THROW(live.apply_fill(contract(3, 100.0, 30), Side::BUY, 1, 1.0));
+    EXPECT_EQ(live.underlying(4).contracts, 0);
+    EXPECT_EQ(live.version(), 1u);
+}
+
+TEST(LivePortfolioTest, SnapshotsStayConsistentDuringUpdates) {
+    LivePortfolio live(0.02, TODAY);
+    std::vector<SymbolId> symbols;
+    for (int i = 0; i < 8; ++i) {
+        symbols.push_back(SymbolTable::intern("SNAP" + std::to_string(i)));
+        live.update_underlying(symbols.back(), 50.0 + i, 0.3);
+    }
+    std::atomic<bool> done{false};
+    std::atomic<int> inconsistent{0};
+    std::thread reader([&] {
+        UnderlyingBook totals;
+        std::vector<UnderlyingBook> books;
+        while (!done.load(std::memory_order_acquire)) {
+            live.snapshot(totals, books);
+            int contracts = 0;
+            for (const UnderlyingBook& book : books) {
+                contracts += book.contracts;
+            }
+            inconsistent += contracts != totals.contracts ? 1 : 0;
+        }
+    });
+
+    for (int i = 0; i < 4000; ++i) {
+        SymbolId symbol = symbols[i % symbols.size()];
+        live.apply_fill(contract(symbol, 50.0, 30), Side::BUY, 1 + i % 3,
+                        2.0);
+        if (i % 10 == 0) {
+            live.update_underlying(symbol, 50.0 + (i % 7), 0.3);
+        }
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+    EXPECT_EQ(inconsistent.load(), 0);
+}
+
+}  // namespace thales
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,195 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Compile TRACE calls out of this file to check that they vanish
+#define THALES_LOG_MIN_LEVEL 1
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "utils/logging.h"
+
+namespace thales {
+
+namespace {
+
+enum class Colour : std::uint8_t { RED = 3 };
+
+template <typename... Args>
+std::string format(const char* format, const Args&... args) {
+    char encoded[256];
+    char* out = encoded;
+    ((out = detail::write_argument(out, args)), ...);
+    std::string text;
+    format_log_arguments(format, encoded,
+                         static_cast<std::size_t>(out - encoded), text);
+    return text;
+}
+
+std::vector<std::string> read_lines(const std::string& path) {
+    std::ifstream in(path);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(in, line);) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+/**
+ * @brief Points the logger at a fresh file for each test.
+ */
+class LoggerTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        path = (std::filesystem::temp_directory_path() /
+                ("thales_log_" + std::to_string(::getpid()) + "_" +
+                 ::testing::UnitTest::GetInstance()
+                     ->current_test_info()
+                     ->name()))
+                   .string();
+        std::filesystem::remove(path);
+        LogSettings settings;
+        settings.path = path;
+        settings.level = LogLevel::INFO;
+        Logger::instance().configure(settings);
+    }
+
+    void TearDown() override {
+        Logger::instance().configure(LogSettings());
+        std::filesystem::remove(path);
+    }
+
+    std::string path;
+};
+
+}  // namespace
+
+TEST(LogFormatTest, FillsPlaceholdersInOrder) {
+    EXPECT_EQ(format("{} + {} = {}", 1, 2u, 3.5), "1 + 2 = 3.5");
+    EXPECT_EQ(format("{} {} {} {}", -7, true, 'x', Colour::RED),
+              "-7 true x 3");
+    std::string owned = "owned";
+    EXPECT_EQ(format("[{}] [{}] [{}]", "literal", owned,
+                     std::string_view("view")),
+              "[literal] [owned] [view]");
+    EXPECT_EQ(format("{} and {}", 1), "1 and {}");
+    EXPECT_EQ(format("no placeholders", 1), "no placeholders");
+    EXPECT_EQ(format("{}", 0.1), "0.1");
+}
+
+TEST_F(LoggerTest, WritesRecordsWithLevelAndLocation) {
+    LOG_INFO("Priced {} options for {}", 42, "SPY");
+    LOG_WARN("Spread {} too wide", 0.25);
+    LOG("Legacy call site");
+    Logger::instance().flush();
+
+    std::vector<std::string> lines = read_lines(path);
+    ASSERT_EQ(lines.size(), 3u);
+    EXPECT_NE(lines[0].find(" INFO  test_logging.cpp:"), std::string::npos);
+    EXPECT_NE(lines[0].find("Priced 42 options for SPY"), std::string::npos);
+    EXPECT_NE(lines[1].find(" WARN  "), std::string::npos);
+    EXPECT_NE(lines[1].find("Spread 0.25 too wide"), std::string::npos);
+    EXPECT_NE(lines[2].find("Legacy call site"), std::string::npos);
+
+    // ISO 8601 timestamp first
+    EXPECT_EQ(lines[0][4], '-');
+    EXPECT_EQ(lines[0][10], 'T');
+}
+
+TEST_F(LoggerTest, FiltersLevels) {
+    int evaluated = 0;
+    auto count = [&] { return ++evaluated; };
+
+    LOG_DEBUG("Filtered at run time {}", count());
+    Logger::instance().set_level(LogLevel::TRACE);
+    LOG_TRACE("Removed at compile time {}", count());
+    LOG_DEBUG("Now written {}", count());
+    Logger::instance().set_level(LogLevel::INFO);
+    Logger::instance().flush();
+
+    EXPECT_EQ(evaluated, 1);
+    std::vector<std::string> lines = read_lines(path);
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_NE(lines[0].find("Now written 1"), std::string::npos);
+}
+
+TEST_F(LoggerTest, KeepsEachThreadInOrder) {
+    constexpr int kThreads = 4;
+    constexpr int kRecords = 500;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < kRecords; ++i) {
+                LOG_INFO("thread {} record {}", t, i);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    Logger::instance().flush();
+
+    std::vector<std::string> lines = read_lines(path);
+    EXPECT_EQ(lines.size() + Logger::instance().dropped(),
+              static_cast<std::size_t>(kThreads * kRecords));
+    std::vector<int> next(kThreads, 0);
+    std::vector<std::string> last(kThreads);
+    for (const std::string& line : lines) {
+        int t = -1;
+        int i = -1;
+        std::size_t at = line.find("thread ");
+        ASSERT_NE(at, std::string::npos);
+        ASSERT_EQ(std::sscanf(line.c_str() + at, "thread %d record %d", &t,
+                              &i), 2);
+        ASSERT_GE(t, 0);
+        ASSERT_LT(t, kThreads);
+        // Drops may skip records but never reorder a thread's own
+        EXPECT_GE(i, next[t]);
+        next[t] = i + 1;
+        // Fixed-width timestamps compare as text
+        EXPECT_LE(last[t], line.substr(0, 30));
+        last[t] = line.substr(0, 30);
+    }
+}
+
+TEST_F(LoggerTest, RejectsBadSettings) {
+    LogSettings settings;
+    settings.buffer_size = 1000;
+    EXPECT_THROW(Logger::instance().configure(settings),
+                 std::invalid_argument);
+    settings.buffer_size = 1 << 16;
+    settings.path = "/nonexistent/directory/log";
+    EXPECT_THROW(Logger::instance().configure(settings), std::runtime_error);
+}
+
+}  // namespace thales
@@ -0,0 +1,189 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "utils/metrics.h"
+
+namespace thales {
+
+namespace {
+
+std::string read_file(const std::string& path) {
+    std::ifstream file(path);
+    std::stringstream text;
+    text << file.rdbuf();
+    return text.str();
+}
+
+}  // namespace
+
+TEST(MetricsTest, CounterSumsEveryThread) {
+    Counter counter("test_counter_total", "Test counter");
+    counter.add();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&counter] {
+            for (int i = 0; i < 10000; ++i) {
+                counter.add(2);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    // The exited threads' counts are kept
+    EXPECT_EQ(counter.value(), 1u + 4u * 20000u);
+}
+
+TEST(MetricsTest, LatencyMergesEveryThread) {
+    LatencyMetric latency("test_latency_seconds", "Test latency");
+    std::thread other([&latency] {
+        for (int i = 0; i < 100; ++i) {
+            latency.record(1000000);
+        }
+    });
+    other.join();
+    for (int i = 0; i < 100; ++i) {
+        latency.record(1000);
+    }
+    LatencyHistogram merged;
+    merged.record(5);
+    latency.snapshot(merged);
+    EXPECT_EQ(merged.count(), 200u);
+    EXPECT_EQ(merged.min(), 1000u);
+    EXPECT_EQ(merged.max(), 1000000u);
+    EXPECT_LE(merged.percentile(50.0), 1000u * 17 / 16);
+    EXPECT_GE(merged.percentile(99.0), 1000000u * 15 / 16);
+}
+
+TEST(MetricsTest, ScopedTimerMeasuresScope) {
+    EXPECT_GT(nanoseconds_per_cycle(), 0.0);
+    LatencyMetric latency("test_timer_seconds", "Test timer");
+    {
+        ScopedTimer timer(latency);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    LatencyHistogram merged;
+    latency.snapshot(merged);
+    ASSERT_EQ(merged.count(), 1u);
+    EXPECT_GE(merged.max(), 4000000u);
+    EXPECT_LT(merged.max(), 1000000000u);
+}
+
+TEST(MetricsTest, RegistryExportsPrometheusText) {
+    MetricsRegistry registry;
+    Counter& orders = registry.counter("test_orders_total", "Orders sent");
+    EXPECT_EQ(&registry.counter("test_orders_total", "Orders sent"),
+              &orders);
+    orders.add(3);
+    LatencyMetric& latency =
+        registry.latency("test_request_seconds", "Request latency");
+    latency.record(2000000);
+    latency.record(2000000);
+
+    EXPECT_THROW(registry.latency("test_orders_total", ""),
+                 std::invalid_argument);
+    EXPECT_THROW(registry.counter("test_request_seconds", ""),
+                 std::invalid_argument);
+    EXPECT_THROW(registry.counter("9starts_with_digit", ""),
+                 std::invalid_argument);
+    EXPECT_THROW(registry.counter("has-dash", ""), std::invalid_argument);
+
+    std::string text;
+    registry.write_prometheus(text);
+    EXPECT_NE(text.find("# HELP test_orders_total Orders sent\n"
+                        "# TYPE test_orders_total counter\n"
+                        "test_orders_total 3\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("# TYPE test_request_seconds summary\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("test_request_seconds{quantile=\"0.99\"} 0.002"),
+              std::string::npos);
+    EXPECT_NE(text.find("test_request_seconds_sum 0.004\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("test_request_seconds_count 2\n"), std::string::npos);
+}
+
+TEST(MetricsTest, DumperReplacesFile) {
+    MetricsRegistry registry;
+    Counter& counter = registry.counter("test_dumps_total", "Test counter");
+    std::string path = (std::filesystem::temp_directory_path() /
+                        ("thales_metrics_" + std::to_string(::getpid()) +
+                         ".prom"))
+                           .string();
+    MetricsDumper dumper(registry, path, std::chrono::milliseconds(5));
+    counter.add(7);
+    dumper.dump();
+    EXPECT_NE(read_file(path).find("test_dumps_total 7\n"),
+              std::string::npos);
+
+    dumper.start();
+    counter.add(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    counter.add(1);
+    dumper.stop();
+    // stop() writes a final dump with everything recorded before it
+    EXPECT_NE(read_file(path).find("test_dumps_total 9\n"),
+              std::string::npos);
+    EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+    std::filesystem::remove(path);
+
+    MetricsDumper bad(registry, "/nonexistent/thales/metrics.prom",
+                      std::chrono::milliseconds(5));
+    EXPECT_THROW(bad.dump(), std::runtime_error);
+}
+
+#if THALES_METRICS
+TEST(MetricsTest, MacrosUseProcessRegistry) {
+    for (int i = 0; i < 3; ++i) {
+        METRIC_COUNT("test_macro_total", "Macro counter", 2);
+        METRIC_TIME_SCOPE("test_macro_seconds", "Macro timer");
+    }
+    METRIC_RECORD_NS("test_macro_seconds", "Macro timer", 100);
+    MetricsRegistry& registry = MetricsRegistry::instance();
+    EXPECT_EQ(registry.counter("test_macro_total", "").value(), 6u);
+    LatencyHistogram merged;
+    registry.latency("test_macro_seconds", "").snapshot(merged);
+    EXPECT_EQ(merged.count(), 4u);
+}
+#endif
+
+}  // namespace thales
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
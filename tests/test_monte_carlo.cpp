@@ -0,0 +1,212 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "trading/monte_carlo.h"
+#include "utils/thread_pool.h"
+
+namespace {
+
+const SimdBackend kAllBackends[] = {SimdBackend::SCALAR, SimdBackend::NEON,
+                                    SimdBackend::AVX2, SimdBackend::AVX512};
+
+MonteCarloSettings plain_settings(std::size_t paths) {
+    MonteCarloSettings settings;
+    settings.paths = paths;
+    settings.antithetic = false;
+    settings.control_variate = false;
+    return settings;
+}
+
+}  // namespace
+
+TEST(MonteCarloTest, PhiloxMatchesKnownAnswers) {
+    // Known-answer vectors of the Random123 reference implementation
+    EXPECT_EQ(Philox4x32::generate({0, 0, 0, 0}, {0, 0}),
+              (Philox4x32::Counter{0x6627e8d5, 0xe169c58d, 0xbc57ac4c,
+                                   0x9b00dbd8}));
+    EXPECT_EQ(Philox4x32::generate(
+                  {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+                  {0xffffffff, 0xffffffff}),
+              (Philox4x32::Counter{0x408f276d, 0x41c83b0e, 0xa20bc7c6,
+                                   0x6d5451fd}));
+}
+
+TEST(MonteCarloTest, InverseNormalRoundTripsOnEveryBackend) {
+    std::vector<double> z;
+    // Near p = 1, 1 - p keeps too few digits to go further
+    for (double x = -8.0; x <= 6.0; x += 0.01) {
+        z.push_back(x);
+    }
+    std::vector<double> p(z.size());
+    for (std::size_t i = 0; i < z.size(); ++i) {
+        p[i] = 0.5 * std::erfc(-z[i] / std::sqrt(2.0));
+    }
+    for (SimdBackend backend : kAllBackends) {
+        if (!BlackScholes::is_simd_backend_supported(backend)) {
+            continue;
+        }
+        std::vector<double> out(z.size());
+        MonteCarlo::inverse_normal_cdf(p.data(), out.data(), p.size(),
+                                       backend);
+        for (std::size_t i = 0; i < z.size(); ++i) {
+            double tolerance = z[i] < -5.0  ? 1e-8
+                               : z[i] > 5.0 ? 1e-6
+                                            : 1e-10;
+            EXPECT_NEAR(out[i], z[i], tolerance) << z[i];
+        }
+    }
+}
+
+TEST(MonteCarloTest, EuropeanMatchesBlackScholes) {
+    PathOption option;
+    option.S = 100.0;
+    option.K = 105.0;
+    option.r = 0.03;
+    option.sigma = 0.25;
+    double exact = BlackScholes::calculate_option_price(100.0, 105.0, 1.0,
+                                                        0.03, 0.25, CALL);
+
+    MonteCarloResult plain = MonteCarlo::price(option, plain_settings(1 << 16));
+    EXPECT_EQ(plain.paths, 1u << 16);
+    EXPECT_NEAR(plain.price, exact, 4.0 * plain.standard_error);
+
+    MonteCarloSettings antithetic = plain_settings(1 << 16);
+    antithetic.antithetic = true;
+    MonteCarloResult paired = MonteCarlo::price(option, antithetic);
+    EXPECT_NEAR(paired.price, exact, 4.0 * paired.standard_error);
+    EXPECT_LT(paired.standard_error, plain.standard_error);
+
+    MonteCarloSettings sobol = plain_settings(1 << 14);
+    sobol.sequence = RandomSequence::SOBOL;
+    EXPECT_NEAR(MonteCarlo::price(option, sobol).price, exact, 0.01);
+}
+
+TEST(MonteCarloTest, ResultDoesNotDependOnThreadCount) {
+    PathOption option;
+    option.payoff = PathPayoff::ASIAN;
+    option.steps = 12;
+    option.r = 0.02;
+    MonteCarloSettings settings;
+    settings.paths = 20001;  // Several chunks and a partial last block
+
+    for (RandomSequence sequence :
+         {RandomSequence::PHILOX, RandomSequence::SOBOL}) {
+        settings.sequence = sequence;
+        MonteCarloResult serial = MonteCarlo::price(option, settings);
+        for (std::size_t threads : {1u, 3u, 8u}) {
+            thales::ThreadPool pool(threads);
+            MonteCarloResult parallel =
+                MonteCarlo::price(option, settings, pool);
+            EXPECT_EQ(parallel.price, serial.price);
+            EXPECT_EQ(parallel.standard_error, serial.standard_error);
+        }
+    }
+
+    // Only the Philox draws depend on the seed
+    settings.sequence = RandomSequence::PHILOX;
+    double seed0 = MonteCarlo::price(option, settings).price;
+    settings.seed = 7;
+    EXPECT_NE(MonteCarlo::price(option, settings).price, seed0);
+}
+
+TEST(MonteCarloTest, AsianLiesBetweenGeometricAndEuropean) {
+    PathOption option;
+    option.payoff = PathPayoff::ASIAN;
+    option.steps = 50;
+    option.r = 0.05;
+    option.sigma = 0.3;
+    MonteCarloSettings settings;
+    settings.paths = 1 << 15;
+    MonteCarloResult asian = MonteCarlo::price(option, settings);
+
+    // Discretely monitored geometric average: lognormal with these moments
+    double n = option.steps;
+    double mean = std::log(option.S) +
+                  (option.r - option.sigma * option.sigma / 2.0) * option.T *
+                      (n + 1.0) / (2.0 * n);
+    double variance = option.sigma * option.sigma * option.T * (n + 1.0) *
+                      (2.0 * n + 1.0) / (6.0 * n * n);
+    double d2 = (mean - std::log(option.K)) / std::sqrt(variance);
+    double d1 = d2 + std::sqrt(variance);
+    auto N = [](double x) { return 0.5 * std::erfc(-x / std::sqrt(2.0)); };
+    double geometric = std::exp(-option.r * option.T) *
+                       (std::exp(mean + variance / 2.0) * N(d1) -
+                        option.K * N(d2));
+    double european = BlackScholes::calculate_option_price(
+        option.S, option.K, option.T, option.r, option.sigma, CALL);
+
+    EXPECT_GT(asian.price, geometric);
+    EXPECT_LT(asian.price, european);
+    // The European control cuts the error well below a crude estimate
+    EXPECT_LT(asian.standard_error,
+              MonteCarlo::price(option, plain_settings(1 << 15))
+                      .standard_error /
+                  2.0);
+}
+
+TEST(MonteCarloTest, KnockInPlusKnockOutIsVanilla) {
+    PathOption option;
+    option.steps = 52;
+    option.r = 0.01;
+    option.type = PUT;
+    MonteCarloSettings settings = plain_settings(1 << 14);
+    // A barrier that cannot be reached gives the vanilla on the same paths
+    option.payoff = PathPayoff::UP_AND_OUT;
+    option.barrier = 1e9;
+    double vanilla = MonteCarlo::price(option, settings).price;
+
+    const PathPayoff pairs[][2] = {
+        {PathPayoff::UP_AND_IN, PathPayoff::UP_AND_OUT},
+        {PathPayoff::DOWN_AND_IN, PathPayoff::DOWN_AND_OUT}};
+    for (const auto& pair : pairs) {
+        option.barrier = pair[0] == PathPayoff::UP_AND_IN ? 115.0 : 85.0;
+        option.payoff = pair[0];
+        double in = MonteCarlo::price(option, settings).price;
+        option.payoff = pair[1];
+        double out = MonteCarlo::price(option, settings).price;
+        EXPECT_GT(in, 0.0);
+        EXPECT_GT(out, 0.0);
+        EXPECT_NEAR(in + out, vanilla, 1e-9);
+    }
+}
+
+TEST(MonteCarloTest, RejectsInvalidInputs) {
+    PathOption option;
+    option.payoff = PathPayoff::UP_AND_OUT;
+    EXPECT_THROW(MonteCarlo::price(option), std::invalid_argument);
+    option.barrier = 120.0;
+    option.steps = 0;
+    EXPECT_THROW(MonteCarlo::price(option), std::invalid_argument);
+    option.steps = 10;
+    MonteCarloSettings settings;
+    settings.paths = 2;
+    EXPECT_THROW(MonteCarlo::price(option, settings), std::invalid_argument);
+    option.sigma = -0.1;
+    EXPECT_THROW(MonteCarlo::price(option), std::invalid_argument);
+}
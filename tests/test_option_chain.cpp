@@ -0,0 +1,256 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "trading/option_chain.h"
+#include "trading/portfolio.h"
+#include "trading/position.h"
+#include "trading/scenario_engine.h"
+#include "utils/date.h"
+
+namespace thales {
+
+namespace {
+
+/**
+ * @brief Three underlyings with four expiries, calls and puts, and eleven
+ * strikes each, listed in a shuffled order.
+ */
+std::vector<ContractKey> universe() {
+    const SymbolId ids[] = {SymbolTable::intern("IDXA"),
+                            SymbolTable::intern("IDXB"),
+                            SymbolTable::intern("IDXC")};
+    std::vector<ContractKey> contracts;
+    for (int i = 0; i < 3 * 4 * 2 * 11; ++i) {
+        // 97 is coprime with the count, so this visits every contract once
+        int k = (i * 97) % (3 * 4 * 2 * 11);
+        contracts.push_back({ids[k % 3], 20000 + 30 * (k / 3 % 4),
+                             k / 12 % 2 ? PUT : CALL,
+                             90.0 + 2.5 * (k / 24)});
+    }
+    return contracts;
+}
+
+bool matches(const ContractKey& contract, const ChainQuery& query) {
+    return contract.underlying == query.underlying &&
+           contract.expiration >= query.first_expiration &&
+           contract.expiration <= query.last_expiration &&
+           (contract.type == CALL ? query.calls : query.puts) &&
+           contract.strike >= query.min_strike &&
+           contract.strike <= query.max_strike;
+}
+
+}  // namespace
+
+TEST(OptionChainIndexTest, FindsEveryContract) {
+    std::vector<ContractKey> contracts = universe();
+    OptionChainIndex index(contracts);
+    ASSERT_EQ(index.size(), contracts.size());
+    for (std::size_t row = 0; row < contracts.size(); ++row) {
+        std::size_t entry = index.find(contracts[row]);
+        ASSERT_NE(entry, OptionChainIndex::NOT_FOUND);
+        EXPECT_EQ(index.source(entry), row);
+        EXPECT_EQ(index.contract(entry), contracts[row]);
+        EXPECT_EQ(index.strike(entry), contracts[row].strike);
+    }
+
+    ContractKey missing = contracts[0];
+    missing.strike += 0.5;
+    EXPECT_FALSE(index.contains(missing));
+    missing = contracts[0];
+    missing.expiration += 1;
+    EXPECT_FALSE(index.contains(missing));
+    missing.underlying = SymbolTable::intern("IDXNONE");
+    EXPECT_FALSE(index.contains(missing));
+    missing.underlying = INVALID_SYMBOL;
+    EXPECT_FALSE(index.contains(missing));
+}
+
+TEST(OptionChainIndexTest, OrdersByExpiryTypeAndStrike) {
+    OptionChainIndex index(universe());
+    SymbolId id = SymbolTable::intern("IDXB");
+    const OptionChainIndex::Expiry* first = nullptr;
+    ASSERT_EQ(index.expiries(id, &first), 4u);
+    for (std::size_t e = 0; e < 4; ++e) {
+        const OptionChainIndex::Expiry& expiry = first[e];
+        EXPECT_EQ(expiry.underlying, id);
+        EXPECT_EQ(expiry.expiration, 20000 + 30 * static_cast<int>(e));
+        EXPECT_EQ(expiry.puts - expiry.begin, 11u);
+        EXPECT_EQ(expiry.end - expiry.puts, 11u);
+        for (std::size_t entry = expiry.begin; entry < expiry.end; ++entry) {
+            ContractKey contract = index.contract(entry);
+            EXPECT_EQ(contract.type, entry < expiry.puts ? CALL : PUT);
+            if (entry + 1 < expiry.end && entry + 1 != expiry.puts) {
+                EXPECT_LT(contract.strike, index.strike(entry + 1));
+            }
+        }
+    }
+    EXPECT_EQ(index.expiries(SymbolTable::intern("IDXNONE"), &first), 0u);
+    EXPECT_EQ(first, nullptr);
+}
+
+TEST(OptionChainIndexTest, RangeQueriesMatchScan) {
+    std::vector<ContractKey> contracts = universe();
+    OptionChainIndex index(contracts);
+    std::vector<ChainQuery> queries(6);
+    queries[0].underlying = SymbolTable::intern("IDXA");
+    queries[1] = queries[0];
+    queries[1].first_expiration = 20030;
+    queries[1].last_expiration = 20060;
+    queries[2] = queries[1];
+    queries[2].puts = false;
+    queries[2].min_strike = 95.0;
+    queries[2].max_strike = 105.0;
+    queries[3] = queries[2];
+    queries[3].min_strike = 96.0;
+    queries[3].max_strike = 96.5;
+    queries[4].underlying = SymbolTable::intern("IDXC");
+    queries[4].calls = false;
+    queries[4].first_expiration = 20001;
+    queries[4].max_strike = 92.5;
+    queries[5].underlying = SymbolTable::intern("IDXNONE");
+
+    for (const ChainQuery& query : queries) {
+        std::vector<std::size_t> rows;
+        std::size_t count = index.select(query, rows);
+        ASSERT_EQ(count, rows.size());
+
+        std::vector<std::size_t> expected;
+        for (std::size_t row = 0; row < contracts.size(); ++row) {
+            if (matches(contracts[row], query)) {
+                expected.push_back(row);
+            }
+        }
+        EXPECT_EQ(rows.size(), expected.size());
+        for (std::size_t row : rows) {
+            EXPECT_TRUE(matches(contracts[row], query));
+        }
+        // Rows come out by expiry, calls first, then by strike
+        for (std::size_t i = 1; i < rows.size(); ++i) {
+            const ContractKey& a = contracts[rows[i - 1]];
+            const ContractKey& b = contracts[rows[i]];
+            EXPECT_LT(std::make_tuple(a.expiration, a.type, a.strike),
+                      std::make_tuple(b.expiration, b.type, b.strike));
+        }
+    }
+    EXPECT_EQ(index.for_each(queries[2], [](std::size_t) {}), 2u * 5u);
+    EXPECT_EQ(index.for_each(queries[3], [](std::size_t) {}), 0u);
+}
+
+TEST(OptionChainIndexTest, KeepsLastDuplicateAndSkipsInvalidRows) {
+    SymbolId id = SymbolTable::intern("IDXA");
+    std::vector<ContractKey> contracts = {
+        {id, 20000, CALL, 100.0},
+        {INVALID_SYMBOL, 20000, CALL, 100.0},
+        {id, 20000, PUT, std::numeric_limits<double>::quiet_NaN()},
+        {id, 20000, CALL, 100.0},
+        {id, 20000, PUT, 100.0},
+    };
+    OptionChainIndex index(contracts);
+    EXPECT_EQ(index.size(), 2u);
+    EXPECT_EQ(index.source(index.find(contracts[0])), 3u);
+    EXPECT_EQ(index.source(index.find(contracts[4])), 4u);
+
+    OptionChainIndex empty;
+    EXPECT_EQ(empty.size(), 0u);
+    EXPECT_FALSE(empty.contains(contracts[0]));
+    ChainQuery query;
+    query.underlying = id;
+    std::vector<std::size_t> rows;
+    EXPECT_EQ(empty.select(query, rows), 0u);
+}
+
+TEST(OptionChainIndexTest, IndexesPortfolioPositions) {
+    std::int32_t today = parse_date("2024-06-14");
+    SymbolId id = SymbolTable::intern("IDXA");
+    Portfolio portfolio(0.0);
+    portfolio.add_position(Position(id, PUT, 95.0, today + 30, -2, 1.0));
+    portfolio.add_position(Position(id, CALL, 105.0, today + 30, 1, 1.0));
+    portfolio.add_position(Position(id, CALL, 110.0, today + 60, 3, 1.0));
+    OptionChainIndex index(portfolio);
+    ASSERT_EQ(index.size(), 3u);
+    for (std::size_t row = 0; row < portfolio.size(); ++row) {
+        Position position = portfolio.get_position(row);
+        ContractKey contract{id, position.get_expiration(),
+                             position.get_type(),
+                             position.get_strike_price()};
+        EXPECT_EQ(index.source(index.find(contract)), row);
+    }
+}
+
+TEST(OptionChainIndexTest, ScenarioQueryRevaluesSelection) {
+    std::int32_t today = parse_date("2024-06-14");
+    SymbolId ids[] = {SymbolTable::intern("IDXA"),
+                      SymbolTable::intern("IDXB")};
+    MarketData market;
+    market.spot.assign(SymbolTable::size(), 1.0);
+    market.volatility.assign(market.spot.size(), 0.25);
+    market.spot[ids[0]] = 100.0;
+    market.spot[ids[1]] = 50.0;
+    market.rate = 0.03;
+    market.valuation_date = today;
+
+    Portfolio portfolio(0.0);
+    Portfolio selected(0.0);
+    for (int i = 0; i < 60; ++i) {
+        SymbolId id = ids[i % 2];
+        OptionType type = i % 3 ? CALL : PUT;
+        double strike = market.spot[id] * (0.9 + 0.004 * i);
+        std::int32_t expiration = today + 30 * (1 + i % 4);
+        Position position(id, type, strike, expiration, i % 5 - 2, 1.0);
+        portfolio.add_position(position);
+        if (id == ids[0] && type == CALL && expiration <= today + 60) {
+            selected.add_position(position);
+        }
+    }
+    OptionChainIndex index(portfolio);
+    ChainQuery query;
+    query.underlying = ids[0];
+    query.puts = false;
+    query.last_expiration = today + 60;
+
+    ScenarioEngine engine(
+        {ScenarioGrid::linear(-0.1, 0.1, 3), {0.0, 0.05}, {0, 5}});
+    ScenarioResult subset = engine.run(portfolio, index, query, market);
+    ScenarioResult direct = engine.run(selected, market);
+    ASSERT_EQ(subset.size(), direct.size());
+    EXPECT_NEAR(subset.base_value, direct.base_value, 1e-9);
+    for (std::size_t k = 0; k < subset.size(); ++k) {
+        EXPECT_NEAR(subset.pnl[k], direct.pnl[k], 1e-9);
+    }
+    EXPECT_EQ(subset.worst(ids[1]), 0.0);
+}
+
+}  // namespace thales
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,477 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <unistd.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "trading/broker_interface.h"
+#include "trading/option_chain.h"
+#include "trading/order_manager.h"
+#include "utils/latency_histogram.h"
+
+namespace thales {
+
+namespace {
+
+constexpr std::int64_t SECOND_NS = 1000000000;
+
+ContractKey contract(const char* symbol, double strike,
+                     OptionType type = CALL) {
+    return {SymbolTable::intern(symbol), 20000, type, strike};
+}
+
+OrderRequest order(Side side, const ContractKey& key, int quantity,
+                   double limit = 1.0) {
+    OrderRequest request{side, key, quantity};
+    request.limit_price = limit;
+    return request;
+}
+
+/** Limits that only the test at hand is meant to hit. */
+RiskLimits loose_limits() {
+    RiskLimits limits;
+    limits.max_order_quantity = 1000;
+    limits.max_order_notional = 1e9;
+    limits.max_position = 1000000;
+    limits.max_underlying_position = 1000000;
+    limits.max_working_notional = 1e12;
+    limits.max_orders_per_second = 1e9;
+    limits.order_burst = 1000000;
+    return limits;
+}
+
+/**
+ * @brief Writes a limits file, removed when the test ends.
+ */
+class LimitsFile {
+   public:
+    explicit LimitsFile(const std::string& text)
+        : path((std::filesystem::temp_directory_path() /
+                ("thales_risk_" + std::to_string(::getpid()) + "_" +
+                 ::testing::UnitTest::GetInstance()
+                     ->current_test_info()
+                     ->name()))
+                   .string()) {
+        std::ofstream(path) << text;
+    }
+
+    ~LimitsFile() { std::filesystem::remove(path); }
+
+    const std::string path;
+};
+
+/**
+ * @brief Broker that keeps orders for the test to execute by hand.
+ */
+class ManualBroker : public BrokerAdapter {
+   public:
+    void send(const BrokerOrder& order) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        orders.push_back(order);
+        count.fetch_add(1, std::memory_order_release);
+    }
+
+    void wait_for(std::size_t sent) const {
+        while (count.load(std::memory_order_acquire) < sent) {
+            std::this_thread::yield();
+        }
+    }
+
+    std::mutex mutex;
+    std::vector<BrokerOrder> orders;
+    std::atomic<std::size_t> count{0};
+};
+
+/**
+ * @brief Collects order updates from the manager thread.
+ */
+struct Updates {
+    OrderManager::Listener listener() {
+        return [this](const OrderUpdate& update) {
+            std::lock_guard<std::mutex> lock(mutex);
+            all.push_back(update);
+        };
+    }
+
+    std::vector<OrderUpdate> of(std::uint64_t id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<OrderUpdate> matching;
+        for (const auto& update : all) {
+            if (update.order_id == id) {
+                matching.push_back(update);
+            }
+        }
+        return matching;
+    }
+
+    std::mutex mutex;
+    std::vector<OrderUpdate> all;
+};
+
+}  // namespace
+
+TEST(RiskLimitsTest, LoadsShippedConfiguration) {
+    RiskLimits limits = RiskLimits::load(
+        std::string(THALES_TEST_CONFIG_DIR) + "/risk_management.cfg");
+    EXPECT_EQ(limits.max_order_quantity, 100);
+    EXPECT_EQ(limits.max_position, 500);
+    EXPECT_DOUBLE_EQ(limits.max_orders_per_second, 50.0);
+}
+
+TEST(RiskLimitsTest, LoadsConfigurationSnapshot) {
+    ConfigSnapshot config =
+        ConfigSnapshot::read_directory(THALES_TEST_CONFIG_DIR);
+    RiskLimits limits = RiskLimits::load(config);
+    EXPECT_EQ(limits.max_underlying_position, 2000);
+    EXPECT_EQ(limits.order_burst, 10);
+
+    ConfigSnapshot partial;
+    partial.set(RiskLimits::CONFIG_SECTION, "MAX_POSITION", "7");
+    EXPECT_EQ(RiskLimits::load(partial).max_position, 7);
+    EXPECT_EQ(RiskLimits::load(partial).max_order_quantity,
+              RiskLimits{}.max_order_quantity);
+    partial.set(RiskLimits::CONFIG_SECTION, "MAX_POSITION", "-7");
+    EXPECT_THROW(RiskLimits::load(partial), std::invalid_argument);
+    EXPECT_EQ(RiskLimits::load(ConfigSnapshot()).max_position,
+              RiskLimits{}.max_position);
+}
+
+TEST(RiskLimitsTest, KeepsDefaultsForMissingKeys) {
+    LimitsFile file("# Tighter order size\n\n  MAX_ORDER_QUANTITY = 7 \n"
+                    "MAX_WORKING_NOTIONAL=12.5e3\n");
+    RiskLimits limits = RiskLimits::load(file.path);
+    EXPECT_EQ(limits.max_order_quantity, 7);
+    EXPECT_DOUBLE_EQ(limits.max_working_notional, 12500.0);
+    EXPECT_EQ(limits.max_position, RiskLimits().max_position);
+}
+
+TEST(RiskLimitsTest, RejectsBadFiles) {
+    EXPECT_THROW(RiskLimits::load("/nonexistent/risk.cfg"), std::runtime_error);
+    EXPECT_THROW(RiskLimits::load(LimitsFile("MAX_LOSS=5\n").path),
+                 std::invalid_argument);
+    EXPECT_THROW(RiskLimits::load(LimitsFile("MAX_POSITION=-1\n").path),
+                 std::invalid_argument);
+    EXPECT_THROW(RiskLimits::load(LimitsFile("MAX_POSITION=2.5\n").path),
+                 std::invalid_argument);
+    EXPECT_THROW(RiskLimits::load(LimitsFile("ORDER_BURST=ten\n").path),
+                 std::invalid_argument);
+    EXPECT_THROW(RiskLimits::load(LimitsFile("MAX_POSITION\n").path),
+                 std::invalid_argument);
+    EXPECT_THROW(
+        RiskLimits::load(LimitsFile("MAX_POSITION=1\nMAX_POSITION=2\n").path),
+        std::invalid_argument);
+}
+
+TEST(PreTradeRiskTest, ChecksEachLimit) {
+    RiskLimits limits;
+    limits.max_order_quantity = 10;
+    limits.max_order_notional = 5000.0;
+    limits.max_position = 15;
+    limits.max_underlying_position = 25;
+    limits.max_working_notional = 4000.0;
+    PreTradeRisk risk(limits);
+    ContractKey call = contract("AAPL", 150.0);
+    ContractKey put = contract("AAPL", 150.0, PUT);
+
+    EXPECT_EQ(risk.check(order(Side::BUY, call, 0), 1.0, 0),
+              RejectReason::INVALID);
+    EXPECT_EQ(risk.check(order(Side::BUY, call, 1), NAN, 0),
+              RejectReason::INVALID);
+    EXPECT_EQ(risk.check(order(Side::BUY, call, 11), 1.0, 0),
+              RejectReason::ORDER_QUANTITY);
+    EXPECT_EQ(risk.check(order(Side::BUY, call, 10), 5.01, 0),
+              RejectReason::ORDER_NOTIONAL);
+
+    risk.accept(order(Side::BUY, call, 10), 1.0, 0);
+    EXPECT_EQ(risk.check(order(Side::BUY, call, 6), 1.0, 0),
+              RejectReason::POSITION_LIMIT);
+    EXPECT_EQ(risk.check(order(Side::BUY, call, 5), 1.0, 0),
+              RejectReason::NONE);
+    // Selling 10 against 10 contracts that may be bought stays in limits
+    EXPECT_EQ(risk.check(order(Side::SELL, call, 10), 1.0, 0),
+              RejectReason::NONE);
+
+    risk.accept(order(Side::SELL, put, 10), 1.0, 0);
+    EXPECT_EQ(risk.underlying_exposure(call.underlying), 20);
+    EXPECT_EQ(risk.check(order(Side::BUY, call, 6), 1.0, 0),
+              RejectReason::POSITION_LIMIT);
+    EXPECT_EQ(risk.check(order(Side::SELL, call, 6), 1.0, 0),
+              RejectReason::UNDERLYING_LIMIT);
+    EXPECT_EQ(risk.check(order(Side::SELL, call, 5), 4.1, 0),
+              RejectReason::WORKING_NOTIONAL);
+    EXPECT_EQ(risk.check(order(Side::SELL, call, 5), 4.0, 0),
+              RejectReason::NONE);
+}
+
+TEST(PreTradeRiskTest, FillsAndReleasesMoveExposure) {
+    PreTradeRisk risk(RiskLimits{});
+    ContractKey call = contract("MSFT", 400.0);
+    OrderRequest buy = order(Side::BUY, call, 10, 2.0);
+
+    risk.accept(buy, 2.0, 0);
+    EXPECT_EQ(risk.working(call, Side::BUY), 10);
+    EXPECT_DOUBLE_EQ(risk.working_notional(), 2000.0);
+
+    risk.fill(buy, 4, 2.0);
+    EXPECT_EQ(risk.position(call), 4);
+    EXPECT_EQ(risk.working(call, Side::BUY), 6);
+    EXPECT_EQ(risk.underlying_exposure(call.underlying), 10);
+    EXPECT_DOUBLE_EQ(risk.working_notional(), 1200.0);
+
+    risk.release(buy, 6, 2.0);
+    EXPECT_EQ(risk.position(call), 4);
+    EXPECT_EQ(risk.working(call, Side::BUY), 0);
+    EXPECT_EQ(risk.underlying_exposure(call.underlying), 4);
+    EXPECT_DOUBLE_EQ(risk.working_notional(), 0.0);
+
+    // Selling through a long position counts the short that is left
+    OrderRequest sell = order(Side::SELL, call, 10, 2.0);
+    risk.accept(sell, 2.0, 0);
+    EXPECT_EQ(risk.underlying_exposure(call.underlying), 14);
+    risk.fill(sell, 10, 2.0);
+    EXPECT_EQ(risk.position(call), -6);
+    EXPECT_EQ(risk.underlying_exposure(call.underlying), 6);
+}
+
+TEST(PreTradeRiskTest, LoadsHeldPortfolio) {
+    Portfolio portfolio(
+        0.0, {Position("NVDA", "Call", 100.0, "2024-12-20", 450, 1.0),
+              Position("NVDA", "Put", 100.0, "2024-12-20", -300, 1.0)});
+    RiskLimits limits;
+    limits.max_underlying_position = 800;
+    PreTradeRisk risk(limits);
+    risk.load(portfolio);
+
+    ContractKey call{SymbolTable::intern("NVDA"),
+                     portfolio.get_expirations()[0], CALL, 100.0};
+    EXPECT_EQ(risk.position(call), 450);
+    EXPECT_EQ(risk.underlying_exposure(call.underlying), 750);
+    EXPECT_EQ(risk.check(order(Side::BUY, call, 60), 1.0, 0),
+              RejectReason::POSITION_LIMIT);
+    EXPECT_EQ(risk.check(order(Side::SELL, call, 60), 1.0, 0),
+              RejectReason::UNDERLYING_LIMIT);
+    EXPECT_EQ(risk.check(order(Side::SELL, call, 50), 1.0, 0),
+              RejectReason::NONE);
+}
+
+TEST(PreTradeRiskTest, RateLimitRefillsOverTime) {
+    RiskLimits limits;
+    limits.max_orders_per_second = 2.0;
+    limits.order_burst = 3;
+    PreTradeRisk risk(limits);
+    OrderRequest buy = order(Side::BUY, contract("AMD", 150.0), 1);
+
+    std::int64_t now = 100 * SECOND_NS;
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQ(risk.check(buy, 1.0, now), RejectReason::NONE);
+        risk.accept(buy, 1.0, now);
+    }
+    EXPECT_EQ(risk.check(buy, 1.0, now), RejectReason::RATE_LIMIT);
+    EXPECT_EQ(risk.check(buy, 1.0, now + SECOND_NS / 4),
+              RejectReason::RATE_LIMIT);
+    EXPECT_EQ(risk.check(buy, 1.0, now + SECOND_NS / 2), RejectReason::NONE);
+}
+
+TEST(PreTradeRiskTest, RejectsUnlistedContracts) {
+    PreTradeRisk risk(loose_limits());
+    ContractKey listed = contract("AMZN", 180.0);
+    ContractKey unlisted = contract("AMZN", 181.0);
+    OptionChainIndex universe(std::vector<ContractKey>{listed});
+    EXPECT_EQ(risk.check(order(Side::BUY, unlisted, 1), 1.0, 0),
+              RejectReason::NONE);
+
+    risk.set_universe(&universe);
+    EXPECT_EQ(risk.check(order(Side::BUY, listed, 1), 1.0, 0),
+              RejectReason::NONE);
+    EXPECT_EQ(risk.check(order(Side::BUY, unlisted, 1), 1.0, 0),
+              RejectReason::UNKNOWN_CONTRACT);
+    EXPECT_EQ(risk.check(order(Side::BUY, unlisted, 0), 1.0, 0),
+              RejectReason::INVALID);
+    EXPECT_EQ(to_string(RejectReason::UNKNOWN_CONTRACT),
+              "unknown contract");
+
+    risk.set_universe(nullptr);
+    EXPECT_EQ(risk.check(order(Side::BUY, unlisted, 1), 1.0, 0),
+              RejectReason::NONE);
+}
+
+TEST(OrderManagerTest, SendsFillsAndRejects) {
+    RiskLimits limits = loose_limits();
+    limits.max_order_quantity = 50;
+    SimulatedBroker broker;
+    Updates updates;
+    OrderManager manager(limits, broker, updates.listener(), 64);
+    broker.connect(manager);
+    ContractKey call = contract("AAPL", 180.0);
+
+    manager.start();
+    std::uint64_t filled = manager.submit(order(Side::BUY, call, 20, 3.0),
+                                          NAN, steady_now_ns());
+    std::uint64_t refused =
+        manager.submit(order(Side::BUY, call, 60), 1.0, steady_now_ns());
+    std::uint64_t marked = manager.submit(
+        order(Side::SELL, call, 5, NAN), 2.5, steady_now_ns());
+    manager.stop();
+
+    ASSERT_NE(filled, 0u);
+    auto events = updates.of(filled);
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].status, OrderStatus::SENT);
+    EXPECT_EQ(events[1].status, OrderStatus::FILLED);
+    EXPECT_EQ(events[1].filled_quantity, 20);
+    EXPECT_DOUBLE_EQ(events[1].last_price, 3.0);
+
+    events = updates.of(refused);
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].status, OrderStatus::RISK_REJECTED);
+    EXPECT_EQ(events[0].reason, RejectReason::ORDER_QUANTITY);
+
+    events = updates.of(marked);
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_DOUBLE_EQ(events[1].last_price, 2.5);
+
+    EXPECT_EQ(manager.sent(), 2u);
+    EXPECT_EQ(manager.rejected(), 1u);
+    EXPECT_EQ(manager.working_orders(), 0u);
+    EXPECT_EQ(manager.risk().position(call), 15);
+    EXPECT_DOUBLE_EQ(manager.risk().working_notional(), 0.0);
+    EXPECT_EQ(manager.tick_to_order().count(), 2u);
+    EXPECT_EQ(manager.submit_to_send().count(), 2u);
+    EXPECT_GE(manager.tick_to_order().min(), manager.submit_to_send().min());
+}
+
+TEST(OrderManagerTest, AppliesBrokerReports) {
+    ManualBroker broker;
+    Updates updates;
+    OrderManager manager(loose_limits(), broker, updates.listener(), 64);
+    ContractKey put = contract("TSLA", 250.0, PUT);
+
+    manager.start();
+    std::uint64_t partial =
+        manager.submit(order(Side::BUY, put, 10), 1.0, steady_now_ns());
+    std::uint64_t refused =
+        manager.submit(order(Side::SELL, put, 4), 1.0, steady_now_ns());
+    broker.wait_for(2);
+    EXPECT_EQ(manager.working_orders(), 2u);
+    ASSERT_TRUE(manager.report({partial, ExecutionKind::FILL, 3, 0.95, 0}));
+    ASSERT_TRUE(manager.report({partial, ExecutionKind::CANCEL, 0, 0.0, 0}));
+    ASSERT_TRUE(manager.report({refused, ExecutionKind::REJECT, 0, 0.0, 0}));
+    ASSERT_TRUE(manager.report({refused, ExecutionKind::FILL, 4, 1.0, 0}));
+    manager.stop();
+
+    auto events = updates.of(partial);
+    ASSERT_EQ(events.size(), 3u);
+    EXPECT_EQ(events[1].status, OrderStatus::PARTIALLY_FILLED);
+    EXPECT_EQ(events[1].last_quantity, 3);
+    EXPECT_EQ(events[2].status, OrderStatus::CANCELLED);
+    EXPECT_EQ(events[2].filled_quantity, 3);
+
+    // Reports after the order is done are ignored
+    events = updates.of(refused);
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[1].status, OrderStatus::BROKER_REJECTED);
+
+    EXPECT_EQ(manager.working_orders(), 0u);
+    EXPECT_EQ(manager.risk().position(put), 3);
+    EXPECT_EQ(manager.risk().working(put, Side::BUY), 0);
+    EXPECT_EQ(manager.risk().working(put, Side::SELL), 0);
+    EXPECT_EQ(manager.risk().underlying_exposure(put.underlying), 3);
+}
+
+TEST(OrderManagerTest, AcceptsOrdersFromManyThreads) {
+    constexpr int PRODUCERS = 4;
+    constexpr int ORDERS = 500;
+    SimulatedBroker broker;
+    std::atomic<int> fills{0};
+    OrderManager manager(loose_limits(), broker,
+                         [&](const OrderUpdate& update) {
+                             if (update.status == OrderStatus::FILLED) {
+                                 fills.fetch_add(1);
+                             }
+                         },
+                         256);
+    broker.connect(manager);
+    manager.start();
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&, p] {
+            ContractKey key = contract("SPY", 500.0 + p);
+            for (int i = 0; i < ORDERS; ++i) {
+                Side side = i % 2 == 0 ? Side::BUY : Side::SELL;
+                while (manager.submit(order(side, key, 1 + p), 1.0,
+                                      steady_now_ns()) == 0) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    manager.stop();
+
+    EXPECT_EQ(fills.load(), PRODUCERS * ORDERS);
+    EXPECT_EQ(broker.sent(), static_cast<std::uint64_t>(PRODUCERS * ORDERS));
+    EXPECT_EQ(manager.tick_to_order().count(),
+              static_cast<std::uint64_t>(PRODUCERS * ORDERS));
+    for (int p = 0; p < PRODUCERS; ++p) {
+        EXPECT_EQ(manager.risk().position(contract("SPY", 500.0 + p)), 0);
+    }
+    EXPECT_EQ(manager.risk().underlying_exposure(SymbolTable::intern("SPY")),
+              0);
+}
+
+TEST(OrderManagerTest, ReportsFullQueue) {
+    ManualBroker broker;
+    OrderManager manager(loose_limits(), broker, {}, 2);
+    OrderRequest buy = order(Side::BUY, contract("QQQ", 400.0), 1);
+    EXPECT_NE(manager.submit(buy, 1.0, 0), 0u);
+    EXPECT_NE(manager.submit(buy, 1.0, 0), 0u);
+    EXPECT_EQ(manager.submit(buy, 1.0, 0), 0u);
+    manager.start();
+    manager.stop();
+    EXPECT_EQ(manager.sent(), 2u);
+    EXPECT_THROW(OrderManager(loose_limits(), broker, {}, 3),
+                 std::invalid_argument);
+}
+
+}  // namespace thales
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
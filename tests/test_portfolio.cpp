@@ -22,11 +22,16 @@
  * SOFTWARE.
  */
 
+#include <cmath>
+#include <stdexcept>
 #include <vector>
 
 #include "gtest/gtest.h"
+#include "trading/black_scholes.h"
 #include "trading/portfolio.h"
 #include "trading/position.h"
+#include "utils/date.h"
+#include "utils/thread_pool.h"
 
 namespace thales {
 
@@ -73,6 +78,170 @@ TEST(PortfolioTest, GetPositions) {
     EXPECT_EQ(portfolio.get_positions()[1].get_premium(), 10.0);
 }
 
+namespace {
+
+/**
+ * @brief Two underlyings, a call and a put on each, valued on 2024-06-14.
+ */
+struct Book {
+    SymbolId aapl = SymbolTable::intern("AAPL");
+    SymbolId tsla = SymbolTable::intern("TSLA");
+    std::int32_t today = parse_date("2024-06-14");
+    Portfolio portfolio{10000.0,
+                        {Position(aapl, CALL, 150.0, today + 180, 10, 5.0),
+                         Position(aapl, PUT, 140.0, today + 90, -4, 3.0),
+                         Position(tsla, PUT, 700.0, today + 180, 5, 10.0),
+                         Position(tsla, CALL, 750.0, today + 30, -2, 8.0)}};
+    MarketData market;
+
+    Book() {
+        market.spot.assign(std::max(aapl, tsla) + 1, 1.0);
+        market.volatility.assign(market.spot.size(), 0.2);
+        market.spot[aapl] = 155.0;
+        market.spot[tsla] = 680.0;
+        market.volatility[tsla] = 0.45;
+        market.rate = 0.04;
+        market.valuation_date = today;
+    }
+
+    Greeks greeks(const Position& position, double spot_move = 0.0) const {
+        SymbolId id = position.get_symbol_id();
+        double T = (position.get_expiration() - today + 1) / 365.0;
+        return BlackScholes::calculate_greeks(
+            market.spot[id] * (1.0 + spot_move), position.get_strike_price(),
+            T, market.rate, market.volatility[id], position.get_type());
+    }
+};
+
+}  // namespace
+
+TEST(PortfolioTest, ColumnsMatchPositions) {
+    Book book;
+    const Portfolio& portfolio = book.portfolio;
+    ASSERT_EQ(portfolio.size(), 4u);
+    EXPECT_EQ(portfolio.get_symbol_ids()[2], book.tsla);
+    EXPECT_EQ(portfolio.get_types()[1], PUT);
+    EXPECT_EQ(portfolio.get_strikes()[3], 750.0);
+    EXPECT_EQ(portfolio.get_expirations()[0], book.today + 180);
+    EXPECT_EQ(portfolio.get_quantities()[1], -4);
+    EXPECT_EQ(portfolio.get_premiums()[2], 10.0);
+
+    std::size_t count = 0;
+    for (const auto& position : portfolio.get_positions()) {
+        EXPECT_EQ(position.get_strike_price(), portfolio.get_strikes()[count]);
+        ++count;
+    }
+    EXPECT_EQ(count, portfolio.size());
+}
+
+TEST(PortfolioTest, RiskByUnderlying) {
+    Book book;
+    std::vector<UnderlyingRisk> risk;
+    book.portfolio.calculate_risk(book.market, risk);
+    ASSERT_EQ(risk.size(), book.market.spot.size());
+
+    std::vector<UnderlyingRisk> expected(risk.size());
+    for (const auto& position : book.portfolio.get_positions()) {
+        Greeks g = book.greeks(position);
+        double weight = position.get_quantity() * CONTRACT_MULTIPLIER;
+        UnderlyingRisk& total = expected[position.get_symbol_id()];
+        total.value += weight * g.price;
+        total.delta += weight * g.delta;
+        total.gamma += weight * g.gamma;
+        total.vega += weight * g.vega;
+        total.theta += weight * g.theta;
+    }
+    for (SymbolId id : {book.aapl, book.tsla}) {
+        EXPECT_NEAR(risk[id].value, expected[id].value, 1e-8);
+        EXPECT_NEAR(risk[id].delta, expected[id].delta, 1e-8);
+        EXPECT_NEAR(risk[id].gamma, expected[id].gamma, 1e-8);
+        EXPECT_NEAR(risk[id].vega, expected[id].vega, 1e-8);
+        EXPECT_NEAR(risk[id].theta, expected[id].theta, 1e-8);
+    }
+    EXPECT_NEAR(risk[book.aapl].value + risk[book.tsla].value,
+                book.portfolio.calculate_market_value(book.market), 1e-8);
+}
+
+TEST(PortfolioTest, NetLiquidityMarksToMarket) {
+    Book book;
+    double value = book.portfolio.calculate_market_value(book.market);
+    double premiums = (10 * 5.0 - 4 * 3.0 + 5 * 10.0 - 2 * 8.0) * 100.0;
+    EXPECT_NEAR(book.portfolio.calculate_net_liquidity(book.market),
+                10000.0 + value - premiums, 1e-8);
+}
+
+TEST(PortfolioTest, SpotMovePnl) {
+    Book book;
+    for (double move : {-0.2, -0.01, 0.0, 0.05, 0.3}) {
+        double expected = 0.0;
+        for (const auto& position : book.portfolio.get_positions()) {
+            expected += position.get_quantity() * CONTRACT_MULTIPLIER *
+                        (book.greeks(position, move).price -
+                         book.greeks(position).price);
+        }
+        EXPECT_NEAR(book.portfolio.calculate_spot_move_pnl(book.market, move),
+                    expected, 1e-8);
+    }
+    EXPECT_THROW(book.portfolio.calculate_spot_move_pnl(book.market, -1.0),
+                 std::invalid_argument);
+}
+
+TEST(PortfolioTest, ExpiredPositionsAreIgnored) {
+    Book book;
+    double before = book.portfolio.calculate_market_value(book.market);
+    book.portfolio.add_position(
+        Position(book.aapl, CALL, 100.0, book.today - 1, 50, 1.0));
+    EXPECT_DOUBLE_EQ(book.portfolio.calculate_market_value(book.market),
+                     before);
+
+    // Still live on its expiration date
+    book.portfolio.add_position(
+        Position(book.aapl, CALL, 100.0, book.today, 1, 1.0));
+    EXPECT_NEAR(book.portfolio.calculate_market_value(book.market) - before,
+                100.0 * (155.0 - 100.0), 2.0);
+}
+
+TEST(PortfolioTest, ParallelMatchesSerial) {
+    Book book;
+    // Enough positions for several pool chunks per worker
+    for (int i = 0; i < 20000; ++i) {
+        book.portfolio.add_position(Position(
+            i % 3 ? book.aapl : book.tsla, i % 2 ? PUT : CALL,
+            (i % 3 ? 150.0 : 700.0) * (0.8 + 0.4 * (i % 41) / 40.0),
+            book.today + i % 400, i % 7 - 3, 1.0));
+    }
+    ThreadPool pool(3);
+
+    EXPECT_NEAR(book.portfolio.calculate_market_value(book.market, pool),
+                book.portfolio.calculate_market_value(book.market), 1e-6);
+    EXPECT_NEAR(book.portfolio.calculate_spot_move_pnl(book.market, 0.02, pool),
+                book.portfolio.calculate_spot_move_pnl(book.market, 0.02),
+                1e-6);
+
+    std::vector<UnderlyingRisk> serial;
+    std::vector<UnderlyingRisk> parallel;
+    book.portfolio.calculate_risk(book.market, serial);
+    book.portfolio.calculate_risk(book.market, parallel, pool);
+    ASSERT_EQ(parallel.size(), serial.size());
+    for (SymbolId id : {book.aapl, book.tsla}) {
+        EXPECT_NEAR(parallel[id].value, serial[id].value, 1e-6);
+        EXPECT_NEAR(parallel[id].delta, serial[id].delta, 1e-6);
+        EXPECT_NEAR(parallel[id].gamma, serial[id].gamma, 1e-6);
+        EXPECT_NEAR(parallel[id].vega, serial[id].vega, 1e-6);
+        EXPECT_NEAR(parallel[id].theta, serial[id].theta, 1e-6);
+    }
+}
+
+TEST(PortfolioTest, MarketMustCoverUnderlyings) {
+    Book book;
+    book.market.spot.resize(book.tsla);
+    EXPECT_THROW(book.portfolio.calculate_market_value(book.market),
+                 std::invalid_argument);
+    std::vector<UnderlyingRisk> risk;
+    EXPECT_THROW(book.portfolio.calculate_risk(book.market, risk),
+                 std::invalid_argument);
+}
+
 }  // namespace thales
 
 int main(int argc, char **argv) {
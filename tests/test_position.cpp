@@ -0,0 +1,105 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdexcept>
+#include <type_traits>
+
+#include "gtest/gtest.h"
+#include "trading/order.h"
+#include "trading/position.h"
+#include "trading/symbol_table.h"
+#include "utils/date.h"
+
+namespace thales {
+
+TEST(PositionTest, FieldsRoundTripThroughStrings) {
+    Position position("AAPL", "Call", 150.0, "2024-12-15", 10, 5.0);
+
+    EXPECT_EQ(position.get_symbol(), "AAPL");
+    EXPECT_EQ(position.get_symbol_id(), SymbolTable::intern("AAPL"));
+    EXPECT_EQ(position.get_type(), OptionType::CALL);
+    EXPECT_EQ(position.get_option_type(), "Call");
+    EXPECT_EQ(position.get_expiration(), parse_date("2024-12-15"));
+    EXPECT_EQ(position.get_expiration_date(), "2024-12-15");
+    EXPECT_EQ(position.get_quantity(), 10);
+    EXPECT_EQ(position.get_premium(), 5.0);
+}
+
+TEST(PositionTest, IsCompactAndTriviallyCopyable) {
+    EXPECT_TRUE(std::is_trivially_copyable<Position>::value);
+    EXPECT_TRUE(std::is_trivially_copyable<Order>::value);
+    EXPECT_LE(sizeof(Position), 32u);
+    EXPECT_LE(sizeof(Order), 48u);
+}
+
+TEST(PositionTest, RejectsInvalidStrings) {
+    EXPECT_THROW(Position("AAPL", "Straddle", 150.0, "2024-12-15", 1, 1.0),
+                 std::invalid_argument);
+    EXPECT_THROW(Position("AAPL", "Call", 150.0, "2024-02-30", 1, 1.0),
+                 std::invalid_argument);
+    EXPECT_THROW(Position("AAPL", "Call", 150.0, "12/15/2024", 1, 1.0),
+                 std::invalid_argument);
+}
+
+TEST(OrderTest, FieldsRoundTripThroughStrings) {
+    Order order("Sell", "TSLA", "PUT", 700.0, "2024-12-15", 5, 10.0,
+                "2024-06-15T10:16:00Z");
+
+    EXPECT_EQ(order.get_side(), Side::SELL);
+    EXPECT_EQ(order.get_action(), "Sell");
+    EXPECT_EQ(order.get_symbol(), "TSLA");
+    EXPECT_EQ(order.get_type(), OptionType::PUT);
+    EXPECT_EQ(order.get_option_type(), "Put");
+    EXPECT_EQ(order.get_expiration_date(), "2024-12-15");
+    EXPECT_EQ(order.get_timestamp(), "2024-06-15T10:16:00Z");
+    EXPECT_EQ(order.get_timestamp_ns(), 1718446560LL * 1000000000LL);
+}
+
+TEST(SymbolTableTest, InternsEachSymbolOnce) {
+    SymbolId first = SymbolTable::intern("SPY");
+    SymbolId second = SymbolTable::intern(std::string("SPY"));
+    SymbolId other = SymbolTable::intern("QQQ");
+
+    EXPECT_EQ(first, second);
+    EXPECT_NE(first, other);
+    EXPECT_EQ(SymbolTable::name(other), "QQQ");
+    EXPECT_THROW(SymbolTable::name(static_cast<SymbolId>(SymbolTable::size())),
+                 std::out_of_range);
+}
+
+TEST(DateTest, ConvertsDatesAndTimestamps) {
+    EXPECT_EQ(parse_date("1970-01-01"), 0);
+    EXPECT_EQ(parse_date("2000-03-01"), 11017);
+    EXPECT_EQ(parse_date("1969-12-31"), -1);
+    EXPECT_EQ(format_date(19706), "2023-12-15");
+    EXPECT_EQ(format_date(parse_date("2024-02-29")), "2024-02-29");
+
+    EXPECT_EQ(parse_timestamp("1970-01-01T00:00:01.5Z"), 1500000000);
+    EXPECT_EQ(format_timestamp(1500000000), "1970-01-01T00:00:01.500000000Z");
+    EXPECT_EQ(format_timestamp(-1000000000), "1969-12-31T23:59:59Z");
+    EXPECT_THROW(parse_timestamp("2024-06-15 10:16:00"),
+                 std::invalid_argument);
+}
+
+}  // namespace thales
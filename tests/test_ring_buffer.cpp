@@ -0,0 +1,204 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "utils/ring_buffer.h"
+
+namespace thales {
+
+TEST(RingBufferTest, CapacityMustBePowerOfTwo) {
+    EXPECT_THROW(SpscRingBuffer<int>(0), std::invalid_argument);
+    EXPECT_THROW(SpscRingBuffer<int>(12), std::invalid_argument);
+    EXPECT_THROW(MpscRingBuffer<int>(3), std::invalid_argument);
+    EXPECT_EQ(SpscRingBuffer<int>(16).capacity(), 16u);
+    EXPECT_EQ(MpscRingBuffer<int>(16).capacity(), 16u);
+}
+
+TEST(RingBufferTest, SpscFillAndDrain) {
+    SpscRingBuffer<int> ring(4);
+    int value = 0;
+    EXPECT_FALSE(ring.try_pop(value));
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(ring.try_push(i));
+    }
+    EXPECT_FALSE(ring.try_push(4));
+    EXPECT_EQ(ring.size(), 4u);
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring.try_pop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(ring.try_pop(value));
+}
+
+TEST(RingBufferTest, MpscFillAndDrain) {
+    MpscRingBuffer<int> ring(4);
+    int value = 0;
+    EXPECT_FALSE(ring.try_pop(value));
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_TRUE(ring.try_push(round * 4 + i));
+        }
+        EXPECT_FALSE(ring.try_push(-1));
+        for (int i = 0; i < 4; ++i) {
+            ASSERT_TRUE(ring.try_pop(value));
+            EXPECT_EQ(value, round * 4 + i);
+        }
+    }
+}
+
+TEST(RingBufferTest, SpscPreservesOrderAcrossThreads) {
+    constexpr std::uint64_t COUNT = 200000;
+    SpscRingBuffer<std::uint64_t> ring(64);
+    std::thread producer([&] {
+        for (std::uint64_t i = 0; i < COUNT; ++i) {
+            while (!ring.try_push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    std::uint64_t expected = 0;
+    std::uint64_t value = 0;
+    while (expected < COUNT) {
+        if (ring.try_pop(value)) {
+            ASSERT_EQ(value, expected);
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+}
+
+TEST(RingBufferTest, MpscDeliversEveryElementOnce) {
+    constexpr std::uint32_t PRODUCERS = 4;
+    constexpr std::uint32_t PER_PRODUCER = 50000;
+    MpscRingBuffer<std::uint32_t> ring(128);
+    std::vector<std::thread> producers;
+    for (std::uint32_t p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&, p] {
+            for (std::uint32_t i = 0; i < PER_PRODUCER; ++i) {
+                while (!ring.try_push(p * PER_PRODUCER + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    // Each producer's elements must arrive in its own order
+    std::vector<std::uint32_t> next(PRODUCERS, 0);
+    std::uint32_t value = 0;
+    for (std::uint32_t received = 0; received < PRODUCERS * PER_PRODUCER;) {
+        if (ring.try_pop(value)) {
+            std::uint32_t producer = value / PER_PRODUCER;
+            ASSERT_EQ(value % PER_PRODUCER, next[producer]);
+            ++next[producer];
+            ++received;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+}
+
+TEST(RingBufferTest, ByteRingWrapsVariableRecords) {
+    SpscByteRing ring(64);
+    std::size_t size = 0;
+    EXPECT_EQ(ring.try_read(size), nullptr);
+    EXPECT_EQ(ring.try_reserve(64), nullptr);
+
+    // 8-byte prefix + 16 bytes each: two fit, a third does not
+    for (char tag : {'a', 'b'}) {
+        char* record = ring.try_reserve(13);
+        ASSERT_NE(record, nullptr);
+        std::memset(record, tag, 13);
+        ring.commit();
+    }
+    EXPECT_EQ(ring.try_reserve(13), nullptr);
+
+    const char* record = ring.try_read(size);
+    ASSERT_NE(record, nullptr);
+    EXPECT_EQ(size, 16u);
+    EXPECT_EQ(record[0], 'a');
+    ring.release();
+
+    // Only 16 bytes remain before the end, so the record skips them and
+    // goes to the start, into the space released by the first one
+    char* wrapped = ring.try_reserve(16);
+    ASSERT_NE(wrapped, nullptr);
+    wrapped[0] = 'c';
+    ring.commit();
+    ASSERT_NE(record = ring.try_read(size), nullptr);
+    EXPECT_EQ(record[0], 'b');
+    ASSERT_NE(record = ring.try_read(size), nullptr);
+    EXPECT_EQ(record[0], 'c');
+    EXPECT_EQ(ring.try_read(size), nullptr);
+    EXPECT_TRUE(ring.empty());
+    ring.release();
+}
+
+TEST(RingBufferTest, ByteRingPreservesOrderAcrossThreads) {
+    SpscByteRing ring(1024);
+    constexpr std::uint32_t kCount = 100000;
+    std::thread producer([&] {
+        for (std::uint32_t i = 0; i < kCount; ++i) {
+            std::size_t length = 4 + i % 29;
+            char* record;
+            while ((record = ring.try_reserve(length)) == nullptr) {
+                std::this_thread::yield();
+            }
+            std::memcpy(record, &i, sizeof(i));
+            ring.commit();
+        }
+    });
+    std::uint32_t expected = 0;
+    while (expected < kCount) {
+        std::size_t size;
+        const char* record = ring.try_read(size);
+        if (record == nullptr) {
+            ring.release();
+            std::this_thread::yield();
+            continue;
+        }
+        std::uint32_t value;
+        std::memcpy(&value, record, sizeof(value));
+        ASSERT_EQ(value, expected);
+        ++expected;
+    }
+    ring.release();
+    producer.join();
+}
+
+}  // namespace thales
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,347 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "trading/risk_aggregation.h"
+
+namespace thales {
+
+namespace {
+
+constexpr std::int32_t TODAY = 19888;  // 2024-06-15
+
+/** @brief A book over RISK0..RISK<count-1>, two positions each. */
+Portfolio make_book(std::size_t count) {
+    Portfolio book(1e6);
+    for (std::size_t u = 0; u < count; ++u) {
+        SymbolId id = SymbolTable::intern("RISK" + std::to_string(u));
+        double strike = 50.0 + 10.0 * static_cast<double>(u);
+        book.add_position(Position(id, CALL, strike, TODAY + 30,
+                                   static_cast<int>(u) + 1, 2.0));
+        book.add_position(Position(id, PUT, strike, TODAY + 60, -3, 1.5));
+    }
+    return book;
+}
+
+/** @brief Loads a book into a live portfolio and quotes its underlyings. */
+void load(LivePortfolio& live, const Portfolio& book) {
+    live.load(book);
+    for (SymbolId id : book.get_symbol_ids()) {
+        live.update_underlying(id, 40.0 + 10.0 * (id % 17), 0.3);
+    }
+}
+
+std::vector<UnderlyingBook> totals_of(const LivePortfolio& live) {
+    UnderlyingBook totals;
+    std::vector<UnderlyingBook> underlyings;
+    live.snapshot(totals, underlyings);
+    return underlyings;
+}
+
+void expect_near_book(const UnderlyingBook& actual,
+                      const UnderlyingBook& expected) {
+    auto tolerance = [](double value) {
+        return 1e-9 * std::max(1.0, std::abs(value));
+    };
+    EXPECT_NEAR(actual.risk.value, expected.risk.value,
+                tolerance(expected.risk.value));
+    EXPECT_NEAR(actual.risk.delta, expected.risk.delta,
+                tolerance(expected.risk.delta));
+    EXPECT_NEAR(actual.risk.gamma, expected.risk.gamma,
+                tolerance(expected.risk.gamma));
+    EXPECT_NEAR(actual.risk.vega, expected.risk.vega,
+                tolerance(expected.risk.vega));
+    EXPECT_NEAR(actual.cost, expected.cost, tolerance(expected.cost));
+    EXPECT_EQ(actual.contracts, expected.contracts);
+}
+
+std::int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+}  // namespace
+
+TEST(RiskAggregationTest, SplitsBooksByAccountAndUnderlying) {
+    Portfolio book = make_book(40);
+    std::size_t rows = 0;
+    double cash = 0.0;
+    for (std::uint32_t shard = 0; shard < 4; ++shard) {
+        Portfolio part = select_shard(book, "ACCT", shard, 4);
+        rows += part.size();
+        cash += part.get_net_liquidity();
+        for (SymbolId id : part.get_symbol_ids()) {
+            EXPECT_EQ(shard_of("ACCT", SymbolTable::name(id), 4), shard);
+        }
+        // Every shard gets something out of 40 underlyings
+        EXPECT_GT(part.size(), 0u);
+    }
+    EXPECT_EQ(rows, book.size());
+    EXPECT_EQ(cash, book.get_net_liquidity());
+
+    EXPECT_EQ(shard_of("ACCT", "SPY", 8), shard_of("ACCT", "SPY", 8));
+    EXPECT_THROW(shard_of("ACCT", "SPY", 0), std::invalid_argument);
+    EXPECT_THROW(select_shard(book, "ACCT", 4, 4), std::invalid_argument);
+}
+
+TEST(RiskAggregationTest, SendsOnlyChangedUnderlyings) {
+    Portfolio book = make_book(50);
+    LivePortfolio live(0.04, TODAY);
+    load(live, book);
+    RiskDeltaEncoder encoder(7, "ACCT");
+
+    std::string snapshot;
+    EXPECT_EQ(encoder.encode(totals_of(live), 1, snapshot), 50u);
+    std::string delta;
+    EXPECT_EQ(encoder.encode(totals_of(live), 2, delta), 0u);
+    EXPECT_EQ(delta.size(), 40u);  // Heartbeat: header only
+
+    SymbolId moved = SymbolTable::intern("RISK3");
+    live.update_underlying(moved, 77.0, 0.35);
+    EXPECT_EQ(encoder.encode(totals_of(live), 3, delta), 1u);
+    EXPECT_EQ(delta.size(), 40u + 64u);  // The name went out already
+    EXPECT_EQ(encoder.sequence(), 3u);
+
+    encoder.reset();
+    EXPECT_EQ(encoder.encode(totals_of(live), 4, snapshot), 50u);
+}
+
+TEST(RiskAggregationTest, AggregatesShardsIntoFirmTotals) {
+    Portfolio book = make_book(30);
+    LivePortfolio whole(0.04, TODAY);
+    load(whole, book);
+
+    RiskAggregator aggregator;
+    std::deque<LivePortfolio> shards;
+    std::vector<RiskDeltaEncoder> encoders;
+    for (std::uint32_t shard = 0; shard < 3; ++shard) {
+        shards.emplace_back(0.04, TODAY);
+        load(shards.back(), select_shard(book, "ACCT", shard, 3));
+        encoders.emplace_back(shard, "ACCT");
+    }
+    std::string frame;
+    for (std::size_t i = 0; i < shards.size(); ++i) {
+        encoders[i].encode(totals_of(shards[i]), now_ns(), frame);
+        aggregator.apply(frame);
+    }
+
+    // A quote on one underlying reaches the firm through one shard
+    SymbolId moved = SymbolTable::intern("RISK5");
+    whole.update_underlying(moved, 91.0, 0.5);
+    std::uint32_t owner = shard_of("ACCT", "RISK5", 3);
+    shards[owner].update_underlying(moved, 91.0, 0.5);
+    for (std::size_t i = 0; i < shards.size(); ++i) {
+        std::size_t records =
+            encoders[i].encode(totals_of(shards[i]), now_ns(), frame);
+        EXPECT_EQ(records, i == owner ? 1u : 0u);
+        aggregator.apply(frame);
+    }
+
+    UnderlyingBook firm;
+    std::vector<UnderlyingBook> firm_underlyings;
+    EXPECT_EQ(aggregator.snapshot(firm, firm_underlyings), 6u);
+    expect_near_book(firm, whole.totals());
+    for (SymbolId id : book.get_symbol_ids()) {
+        ASSERT_LT(id, firm_underlyings.size());
+        expect_near_book(firm_underlyings[id], whole.underlying(id));
+    }
+
+    std::vector<ShardStatus> statuses = aggregator.shards();
+    ASSERT_EQ(statuses.size(), 3u);
+    EXPECT_EQ(statuses[1].account, "ACCT");
+    EXPECT_EQ(statuses[1].sequence, 2u);
+    EXPECT_LT(aggregator.staleness_ns(now_ns()), 1000000000);
+}
+
+TEST(RiskAggregationTest, SnapshotsReplaceAShardsTotals) {
+    LivePortfolio live(0.04, TODAY);
+    load(live, make_book(10));
+    RiskAggregator aggregator;
+    RiskDeltaEncoder encoder(1, "ACCT");
+    std::string frame;
+    encoder.encode(totals_of(live), now_ns(), frame);
+    aggregator.apply(frame);
+
+    // The shard restarts flat
+    LivePortfolio empty(0.04, TODAY);
+    RiskDeltaEncoder restarted(1, "ACCT");
+    restarted.encode(totals_of(empty), now_ns(), frame);
+    aggregator.apply(frame);
+    UnderlyingBook firm;
+    std::vector<UnderlyingBook> underlyings;
+    aggregator.snapshot(firm, underlyings);
+    EXPECT_EQ(firm.contracts, 0);
+    EXPECT_EQ(firm.risk.value, 0.0);
+}
+
+TEST(RiskAggregationTest, RejectsMalformedAndOutOfSequenceFrames) {
+    LivePortfolio live(0.04, TODAY);
+    load(live, make_book(5));
+    RiskDeltaEncoder encoder(2, "ACCT");
+    std::string first;
+    std::string second;
+    std::string third;
+    encoder.encode(totals_of(live), 1, first);
+    encoder.encode(totals_of(live), 2, second);
+    encoder.encode(totals_of(live), 3, third);
+
+    RiskAggregator aggregator;
+    // A DELTA before the shard's SNAPSHOT cannot be applied
+    EXPECT_THROW(aggregator.apply(second), std::invalid_argument);
+    aggregator.apply(first);
+    EXPECT_THROW(aggregator.apply(third), std::invalid_argument);
+    aggregator.apply(second);
+    aggregator.apply(third);
+
+    EXPECT_EQ(RiskAggregator::frame_size(first.substr(0, 39)), 0u);
+    EXPECT_EQ(RiskAggregator::frame_size(first), first.size());
+    EXPECT_THROW(aggregator.apply(first.substr(0, first.size() - 1)),
+                 std::invalid_argument);
+    std::string garbage = first;
+    garbage[0] = 'X';
+    EXPECT_THROW(RiskAggregator::frame_size(garbage), std::invalid_argument);
+    // A record naming an index that was never defined
+    std::string unknown = third;
+    std::uint32_t records = 1;
+    std::memcpy(&unknown[20], &records, sizeof(records));
+    unknown += std::string(64, '\0');
+    std::uint32_t bytes = static_cast<std::uint32_t>(unknown.size());
+    std::memcpy(&unknown[8], &bytes, sizeof(bytes));
+    std::uint32_t index = 999;
+    std::memcpy(&unknown[40], &index, sizeof(index));
+    std::uint64_t sequence = 4;
+    std::memcpy(&unknown[24], &sequence, sizeof(sequence));
+    EXPECT_THROW(aggregator.apply(unknown), std::invalid_argument);
+    EXPECT_EQ(aggregator.shards().front().sequence, 3u);
+
+    // A rejected frame must not intern the names it carries
+    std::string renamed = first;
+    std::size_t at = renamed.find("RISK0");
+    ASSERT_NE(at, std::string::npos);
+    renamed.replace(at, 5, "REJCT");
+    std::memcpy(&renamed[at - 6], &index, sizeof(index));
+    std::size_t interned = SymbolTable::size();
+    EXPECT_THROW(aggregator.apply(renamed), std::invalid_argument);
+    EXPECT_EQ(SymbolTable::size(), interned);
+}
+
+TEST(RiskAggregationTest, StreamsShardsOverTcp) {
+    Portfolio book = make_book(20);
+    LivePortfolio whole(0.04, TODAY);
+    load(whole, book);
+
+    RiskAggregator aggregator;
+    auto server =
+        std::make_unique<RiskAggregatorServer>(aggregator, 0, "127.0.0.1");
+    server->start();
+
+    std::deque<LivePortfolio> shards;
+    std::vector<std::unique_ptr<RiskShardPublisher>> publishers;
+    for (std::uint32_t shard = 0; shard < 2; ++shard) {
+        shards.emplace_back(0.04, TODAY);
+        load(shards.back(), select_shard(book, "ACCT", shard, 2));
+        RiskAggregationSettings settings;
+        settings.account = "ACCT";
+        settings.shard = shard;
+        settings.shard_count = 2;
+        settings.port = server->port();
+        settings.publish_interval = std::chrono::milliseconds(5);
+        publishers.push_back(
+            std::make_unique<RiskShardPublisher>(settings, shards.back()));
+        publishers.back()->start();
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (aggregator.shards().size() < 2 &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ASSERT_EQ(aggregator.shards().size(), 2u);
+    UnderlyingBook firm;
+    std::vector<UnderlyingBook> underlyings;
+    aggregator.snapshot(firm, underlyings);
+    expect_near_book(firm, whole.totals());
+    EXPECT_LT(aggregator.staleness_ns(now_ns()), 1000000000);
+    EXPECT_EQ(server->connections(), 2u);
+
+    // Shards reconnect and resend everything after the server restarts
+    std::uint16_t port = server->port();
+    server.reset();
+    RiskAggregator restarted;
+    {
+        RiskAggregatorServer again(restarted, port, "127.0.0.1");
+        again.start();
+        while (restarted.shards().size() < 2 &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        for (auto& publisher : publishers) {
+            publisher->stop();
+        }
+    }
+    restarted.snapshot(firm, underlyings);
+    expect_near_book(firm, whole.totals());
+    EXPECT_GE(publishers[0]->connections(), 2u);
+    EXPECT_GT(publishers[0]->frames_sent(), 1u);
+}
+
+TEST(RiskAggregationTest, LoadsSettingsFromConfiguration) {
+    ConfigSnapshot config;
+    config.set("risk_aggregation", "ACCOUNT", "HEDGE");
+    config.set("risk_aggregation", "SHARD", "3");
+    config.set("risk_aggregation", "SHARD_COUNT", "4");
+    config.set("risk_aggregation", "AGGREGATOR_PORT", "9000");
+    RiskAggregationSettings settings = RiskAggregationSettings::load(config);
+    EXPECT_EQ(settings.account, "HEDGE");
+    EXPECT_EQ(settings.shard, 3u);
+    EXPECT_EQ(settings.shard_count, 4u);
+    EXPECT_EQ(settings.port, 9000);
+    EXPECT_EQ(settings.publish_interval, std::chrono::milliseconds(200));
+
+    config.set("risk_aggregation", "SHARD", "4");
+    EXPECT_THROW(RiskAggregationSettings::load(config),
+                 std::invalid_argument);
+    EXPECT_NO_THROW(RiskAggregationSettings::load(
+        ConfigSnapshot::read_directory(THALES_TEST_CONFIG_DIR)));
+}
+
+}  // namespace thales
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,236 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "trading/portfolio.h"
+#include "trading/position.h"
+#include "trading/scenario_engine.h"
+#include "utils/date.h"
+#include "utils/thread_pool.h"
+
+namespace thales {
+
+namespace {
+
+/**
+ * @brief Three underlyings with 300 positions, so the sweep spans several
+ * blocks and a partial one.
+ */
+struct Book {
+    std::vector<SymbolId> ids = {SymbolTable::intern("GRIDA"),
+                                 SymbolTable::intern("GRIDB"),
+                                 SymbolTable::intern("GRIDC")};
+    std::int32_t today = parse_date("2024-06-14");
+    Portfolio portfolio{0.0};
+    MarketData market;
+
+    Book() {
+        market.spot.assign(SymbolTable::size(), 1.0);
+        market.volatility.assign(market.spot.size(), 0.2);
+        market.spot[ids[0]] = 50.0;
+        market.spot[ids[1]] = 120.0;
+        market.spot[ids[2]] = 400.0;
+        market.volatility[ids[1]] = 0.35;
+        market.volatility[ids[2]] = 0.5;
+        market.rate = 0.03;
+        market.valuation_date = today;
+        for (int i = 0; i < 300; ++i) {
+            SymbolId id = ids[i % 3];
+            double strike = market.spot[id] * (0.8 + 0.4 * (i % 11) / 10.0);
+            portfolio.add_position(Position(id, i % 2 ? PUT : CALL, strike,
+                                            today + 20 + (i * 13) % 400,
+                                            i % 7 - 3, 1.0));
+        }
+    }
+
+    /** @brief Market value after moving every input by one scenario. */
+    double shocked_value(double spot_move, double vol_shift,
+                         int horizon) const {
+        MarketData shocked = market;
+        for (SymbolId id : ids) {
+            shocked.spot[id] *= 1.0 + spot_move;
+            shocked.volatility[id] += vol_shift;
+        }
+        shocked.valuation_date += horizon;
+        return portfolio.calculate_market_value(shocked);
+    }
+};
+
+ScenarioGrid small_grid() {
+    return {ScenarioGrid::linear(-0.2, 0.2, 5), {-0.05, 0.0, 0.1}, {0, 1, 7}};
+}
+
+}  // namespace
+
+TEST(ScenarioEngineTest, LinearAxisIncludesBothEnds) {
+    std::vector<double> axis = ScenarioGrid::linear(-0.2, 0.2, 41);
+    ASSERT_EQ(axis.size(), 41u);
+    EXPECT_EQ(axis.front(), -0.2);
+    EXPECT_EQ(axis.back(), 0.2);
+    EXPECT_NEAR(axis[20], 0.0, 1e-15);
+    EXPECT_EQ(ScenarioGrid::linear(1.0, 2.0, 1), std::vector<double>{1.0});
+    EXPECT_TRUE(ScenarioGrid::linear(1.0, 2.0, 0).empty());
+}
+
+TEST(ScenarioEngineTest, MatchesFullRevaluation) {
+    Book book;
+    ScenarioGrid grid = small_grid();
+    ScenarioResult result = ScenarioEngine(grid).run(book.portfolio,
+                                                     book.market);
+    ASSERT_EQ(result.size(), 45u);
+    double base = book.portfolio.calculate_market_value(book.market);
+    EXPECT_NEAR(result.base_value, base, 1e-8 * std::abs(base));
+
+    for (std::size_t h = 0; h < grid.horizons.size(); ++h) {
+        for (std::size_t v = 0; v < grid.vol_shifts.size(); ++v) {
+            for (std::size_t s = 0; s < grid.spot_moves.size(); ++s) {
+                double expected =
+                    book.shocked_value(grid.spot_moves[s], grid.vol_shifts[v],
+                                       grid.horizons[h]) -
+                    base;
+                EXPECT_NEAR(result.at(s, v, h), expected, 1e-7)
+                    << "spot " << s << " vol " << v << " horizon " << h;
+            }
+        }
+    }
+    EXPECT_EQ(result.at(2, 1, 0), 0.0);
+}
+
+TEST(ScenarioEngineTest, UnderlyingsSumToPortfolio) {
+    Book book;
+    ScenarioResult result =
+        ScenarioEngine(small_grid()).run(book.portfolio, book.market);
+    ASSERT_EQ(result.underlying_pnl.size(),
+              book.market.spot.size() * result.size());
+    double worst = 0.0;
+    for (std::size_t k = 0; k < result.size(); ++k) {
+        double sum = 0.0;
+        for (SymbolId id = 0; id < book.market.spot.size(); ++id) {
+            sum += result.underlying_pnl[id * result.size() + k];
+        }
+        EXPECT_NEAR(sum, result.pnl[k], 1e-9);
+        worst = std::min(worst, result.pnl[k]);
+    }
+    EXPECT_EQ(result.worst(), worst);
+    EXPECT_LE(result.worst(book.ids[2]), 0.0);
+    // Underlyings without positions are flat in every scenario
+    SymbolId unused = book.ids[0] == 0 ? book.ids[2] + 1 : 0;
+    if (unused < book.market.spot.size()) {
+        EXPECT_EQ(result.worst(unused), 0.0);
+    }
+}
+
+TEST(ScenarioEngineTest, PoolMatchesSerial) {
+    Book book;
+    for (int i = 0; i < 5000; ++i) {
+        book.portfolio.add_position(Position(book.ids[i % 3], CALL,
+                                             book.market.spot[book.ids[i % 3]],
+                                             book.today + 60, 1, 1.0));
+    }
+    ScenarioEngine engine(small_grid());
+    ScenarioResult serial = engine.run(book.portfolio, book.market);
+    ThreadPool pool(4);
+    ScenarioResult parallel = engine.run(book.portfolio, book.market, pool);
+    ASSERT_EQ(parallel.pnl.size(), serial.pnl.size());
+    // Only the order of the sums differs
+    double tolerance = 1e-12 * std::abs(serial.base_value);
+    EXPECT_NEAR(parallel.base_value, serial.base_value, tolerance);
+    for (std::size_t k = 0; k < serial.size(); ++k) {
+        EXPECT_NEAR(parallel.pnl[k], serial.pnl[k], tolerance);
+    }
+}
+
+TEST(ScenarioEngineTest, ExpiryBeforeHorizonPaysPayoff) {
+    SymbolId id = SymbolTable::intern("GRIDA");
+    std::int32_t today = parse_date("2024-06-14");
+    Portfolio portfolio(0.0);
+    portfolio.add_position(Position(id, CALL, 100.0, today + 4, 2, 1.0));
+    portfolio.add_position(Position(id, PUT, 100.0, today - 1, 5, 1.0));
+    MarketData market;
+    market.spot.assign(SymbolTable::size(), 100.0);
+    market.volatility.assign(market.spot.size(), 0.3);
+    market.valuation_date = today;
+
+    ScenarioResult result = ScenarioEngine({{-0.1, 0.1}, {0.0}, {10}})
+                                .run(portfolio, market);
+    double base = portfolio.calculate_market_value(market);
+    // The settled put is worth nothing either way; the call pays S - K
+    EXPECT_NEAR(result.at(0, 0, 0), -base, 1e-9);
+    EXPECT_NEAR(result.at(1, 0, 0), 2 * CONTRACT_MULTIPLIER * 10.0 - base,
+                1e-9);
+}
+
+TEST(ScenarioEngineTest, TabulatedPolicyTracksExact) {
+    Book book;
+    ScenarioEngine engine(small_grid());
+    ScenarioResult exact = engine.run(book.portfolio, book.market);
+    ScenarioResult risk = engine.run<RiskMath>(book.portfolio, book.market);
+    ScenarioResult screening =
+        engine.run<ScreeningMath>(book.portfolio, book.market);
+    for (std::size_t k = 0; k < exact.size(); ++k) {
+        EXPECT_NEAR(risk.pnl[k], exact.pnl[k], 1e-4);
+        EXPECT_NEAR(screening.pnl[k], exact.pnl[k], 1.0);
+    }
+}
+
+TEST(ScenarioEngineTest, BackendsAgree) {
+    Book book;
+    ScenarioResult scalar = ScenarioEngine(small_grid(), SimdBackend::SCALAR)
+                                .run(book.portfolio, book.market);
+    for (SimdBackend backend : {SimdBackend::NEON, SimdBackend::AVX2,
+                                SimdBackend::AVX512}) {
+        if (!BlackScholes::is_simd_backend_supported(backend)) {
+            EXPECT_THROW(ScenarioEngine(small_grid(), backend),
+                         std::invalid_argument);
+            continue;
+        }
+        ScenarioResult result = ScenarioEngine(small_grid(), backend)
+                                    .run(book.portfolio, book.market);
+        for (std::size_t k = 0; k < scalar.size(); ++k) {
+            EXPECT_NEAR(result.pnl[k], scalar.pnl[k], 1e-8);
+        }
+    }
+}
+
+TEST(ScenarioEngineTest, RejectsInvalidInputs) {
+    EXPECT_THROW(ScenarioEngine({{}, {0.0}, {0}}), std::invalid_argument);
+    EXPECT_THROW(ScenarioEngine({{-1.0}, {0.0}, {0}}), std::invalid_argument);
+    EXPECT_THROW(ScenarioEngine({{0.0}, {0.0}, {-1}}), std::invalid_argument);
+
+    Book book;
+    MarketData empty;
+    ScenarioEngine engine(small_grid());
+    EXPECT_THROW(engine.run(book.portfolio, empty), std::invalid_argument);
+    book.market.spot[book.ids[1]] = 0.0;
+    EXPECT_THROW(engine.run(book.portfolio, book.market),
+                 std::invalid_argument);
+}
+
+}  // namespace thales
@@ -0,0 +1,114 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "utils/seqlock.h"
+
+namespace thales {
+
+namespace {
+
+/** A row spanning several words, so torn copies would show. */
+struct Row {
+    std::uint64_t a;
+    std::uint64_t b;
+    std::uint64_t c;
+    std::uint32_t d;
+};
+
+}  // namespace
+
+TEST(SeqlockTest, ReadsPublishedRows) {
+    SeqlockTable<Row> table(4);
+    EXPECT_EQ(table.capacity(), 4u);
+    EXPECT_EQ(table.version(), 0u);
+    EXPECT_EQ(table.read(2).a, 0u);
+
+    table.begin_write();
+    table.set(1, {1, 2, 3, 4});
+    table.set(2, {5, 6, 7, 8});
+    EXPECT_EQ(table.peek(1).c, 3u);
+    table.end_write();
+    EXPECT_EQ(table.version(), 1u);
+
+    Row rows[3];
+    EXPECT_EQ(table.read(0, 3, rows), 1u);
+    EXPECT_EQ(rows[0].a, 0u);
+    EXPECT_EQ(rows[1].d, 4u);
+    EXPECT_EQ(rows[2].b, 6u);
+}
+
+TEST(SeqlockTest, ReadersNeverSeeTornBatches) {
+    constexpr std::size_t ROWS = 8;
+    constexpr std::uint64_t BATCHES = 20000;
+    SeqlockTable<Row> table(ROWS);
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> readers;
+    std::atomic<int> failures{0};
+    for (int r = 0; r < 2; ++r) {
+        readers.emplace_back([&] {
+            Row rows[ROWS];
+            std::uint64_t last = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                std::uint64_t version = table.read(0, ROWS, rows);
+                bool torn = version < last;
+                for (const Row& row : rows) {
+                    torn |= row.a != rows[0].a || row.b != row.a ||
+                            row.c != row.a || row.d != row.a;
+                }
+                torn |= rows[0].a != version;
+                failures += torn ? 1 : 0;
+                last = version;
+            }
+        });
+    }
+
+    for (std::uint64_t batch = 1; batch <= BATCHES; ++batch) {
+        table.begin_write();
+        for (std::size_t i = 0; i < ROWS; ++i) {
+            table.set(i, {batch, batch, batch,
+                          static_cast<std::uint32_t>(batch)});
+        }
+        table.end_write();
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(failures.load(), 0);
+    EXPECT_EQ(table.read(ROWS - 1).a, BATCHES);
+}
+
+}  // namespace thales
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,360 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "trading/state_snapshot.h"
+#include "trading/strategy.h"
+#include "trading/symbol_table.h"
+
+namespace thales {
+
+namespace {
+
+/** @brief A two-slice surface, fitted. */
+VolSurface make_surface(double spot) {
+    VolSurface surface(spot, 0.03);
+    for (double expiry : {0.25, 1.0}) {
+        std::vector<SmileQuote> quotes;
+        for (double moneyness = 0.7; moneyness <= 1.301; moneyness += 0.05) {
+            double k = std::log(moneyness);
+            quotes.push_back({spot * moneyness,
+                              0.2 + 0.1 * k * k - 0.05 * k + 0.02 * expiry,
+                              1.0});
+        }
+        surface.set_quotes(expiry, quotes);
+    }
+    surface.refresh();
+    return surface;
+}
+
+/** @brief A small book on two underlyings with a surface for the first. */
+void make_state(TradingState& state, SymbolId first, SymbolId second) {
+    state.timestamp_ns = 1'718'400'000'000'000'000;
+    state.portfolio = Portfolio(25000.0);
+    state.portfolio.add_position(Position(first, CALL, 100.0, 20000, 5, 2.5));
+    state.portfolio.add_position(Position(second, PUT, 50.0, 20030, -3, 1.2));
+    state.portfolio.add_position(Position(first, PUT, 95.0, 20000, 2, 1.8));
+    state.orders = {
+        Order(Side::BUY, first, CALL, 100.0, 20000, 5, 2.5, 1000),
+        Order(Side::SELL, second, PUT, 50.0, 20030, 3, 1.2, 2000)};
+    state.chain = OptionChainIndex(state.portfolio);
+    state.surfaces.clear();
+    state.surfaces.resize(first + std::size_t{1});
+    state.surfaces[first].emplace(make_surface(100.0));
+    state.config = ConfigSnapshot();
+    state.config.set("risk_management", "MAX_POSITION", "500");
+    state.config.set("metrics", "METRICS_FILE", "thales.prom");
+}
+
+/**
+ * @brief Overwrites the first record of a section of a written snapshot.
+ *
+ * The section table follows the header's first 48 bytes; each entry is the
+ * section's offset, count and width.
+ */
+template <typename T>
+void patch_section(const std::string& file, std::size_t section, T value) {
+    std::fstream io(file, std::ios::binary | std::ios::in | std::ios::out);
+    std::uint64_t offset = 0;
+    io.seekg(static_cast<std::streamoff>(48 + 24 * section));
+    io.read(reinterpret_cast<char*>(&offset), sizeof(offset));
+    io.seekp(static_cast<std::streamoff>(offset));
+    io.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+class StateSnapshotTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        root = std::filesystem::temp_directory_path() /
+               ("thales_snapshot_" + std::to_string(::getpid()) + "_" +
+                ::testing::UnitTest::GetInstance()
+                    ->current_test_info()
+                    ->name());
+        std::filesystem::remove_all(root);
+        std::filesystem::create_directories(root);
+        file = (root / "state.snapshot").string();
+    }
+
+    void TearDown() override { std::filesystem::remove_all(root); }
+
+    std::filesystem::path root;
+    std::string file;
+};
+
+}  // namespace
+
+TEST_F(StateSnapshotTest, RoundTripsEveryPart) {
+    SymbolId first = SymbolTable::intern("SNAPA");
+    SymbolId second = SymbolTable::intern("SNAPB");
+    TradingState saved;
+    make_state(saved, first, second);
+    StateSnapshot::write(file, saved);
+
+    TradingState loaded;
+    StateSnapshot::read(file, loaded);
+    EXPECT_EQ(loaded.timestamp_ns, saved.timestamp_ns);
+    EXPECT_DOUBLE_EQ(loaded.portfolio.get_net_liquidity(), 25000.0);
+    ASSERT_EQ(loaded.portfolio.size(), 3u);
+    for (std::size_t i = 0; i < 3; ++i) {
+        Position expected = saved.portfolio.get_position(i);
+        Position actual = loaded.portfolio.get_position(i);
+        EXPECT_EQ(actual.get_symbol_id(), expected.get_symbol_id());
+        EXPECT_EQ(actual.get_type(), expected.get_type());
+        EXPECT_EQ(actual.get_strike_price(), expected.get_strike_price());
+        EXPECT_EQ(actual.get_expiration(), expected.get_expiration());
+        EXPECT_EQ(actual.get_quantity(), expected.get_quantity());
+        EXPECT_EQ(actual.get_premium(), expected.get_premium());
+    }
+    ASSERT_EQ(loaded.orders.size(), 2u);
+    EXPECT_EQ(loaded.orders[1].get_side(), Side::SELL);
+    EXPECT_EQ(loaded.orders[1].get_symbol_id(), second);
+    EXPECT_EQ(loaded.orders[1].get_timestamp_ns(), 2000);
+
+    ASSERT_EQ(loaded.chain.size(), 3u);
+    std::size_t entry = loaded.chain.find({first, 20000, PUT, 95.0});
+    ASSERT_NE(entry, OptionChainIndex::NOT_FOUND);
+    EXPECT_EQ(loaded.chain.source(entry), 2u);
+
+    // The surface comes back fitted, without a refresh
+    ASSERT_GT(loaded.surfaces.size(), first);
+    ASSERT_TRUE(loaded.surfaces[first].has_value());
+    const VolSurface& surface = *loaded.surfaces[first];
+    ASSERT_EQ(surface.size(), 2u);
+    for (double strike : {80.0, 100.0, 120.0}) {
+        for (double expiry : {0.1, 0.5, 2.0}) {
+            EXPECT_EQ(surface.volatility(strike, expiry),
+                      saved.surfaces[first]->volatility(strike, expiry));
+        }
+    }
+    EXPECT_EQ(loaded.config.get_int("risk_management", "MAX_POSITION", 0),
+              500);
+    EXPECT_EQ(loaded.config.get("metrics", "METRICS_FILE").text(),
+              "thales.prom");
+    EXPECT_EQ(loaded.config.size(), 2u);
+}
+
+TEST_F(StateSnapshotTest, ReinternsSymbolsOfAnotherProcess) {
+    // The child interns the symbols in the opposite order to this process,
+    // so every stored ID and the chain's expiry order change on load
+    pid_t child = ::fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        SymbolId second = SymbolTable::intern("REMAPB");
+        SymbolId first = SymbolTable::intern("REMAPA");
+        TradingState state;
+        make_state(state, first, second);
+        StateSnapshot::write(file, state);
+        ::_exit(0);
+    }
+    int status = 0;
+    ::waitpid(child, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    SymbolId first = SymbolTable::intern("REMAPA");
+    SymbolId second = SymbolTable::intern("REMAPB");
+    ASSERT_LT(first, second);
+    TradingState loaded;
+    StateSnapshot::read(file, loaded);
+    EXPECT_EQ(loaded.portfolio.get_symbol_ids()[0], first);
+    EXPECT_EQ(loaded.portfolio.get_symbol_ids()[1], second);
+    EXPECT_EQ(loaded.orders[1].get_symbol_id(), second);
+    for (std::size_t row = 0; row < loaded.portfolio.size(); ++row) {
+        ContractKey contract{loaded.portfolio.get_symbol_ids()[row],
+                             loaded.portfolio.get_expirations()[row],
+                             loaded.portfolio.get_types()[row],
+                             loaded.portfolio.get_strikes()[row]};
+        std::size_t entry = loaded.chain.find(contract);
+        ASSERT_NE(entry, OptionChainIndex::NOT_FOUND);
+        EXPECT_EQ(loaded.chain.source(entry), row);
+        EXPECT_EQ(loaded.chain.contract(entry), contract);
+    }
+    ASSERT_GT(loaded.surfaces.size(), first);
+    EXPECT_TRUE(loaded.surfaces[first].has_value());
+    EXPECT_NEAR(loaded.surfaces[first]->volatility(100.0, 0.25), 0.205,
+                0.01);
+}
+
+TEST_F(StateSnapshotTest, RejectsDamagedFiles) {
+    TradingState state;
+    make_state(state, SymbolTable::intern("SNAPA"),
+               SymbolTable::intern("SNAPB"));
+    StateSnapshot::write(file, state);
+    TradingState loaded;
+    EXPECT_THROW(StateSnapshot::read((root / "missing").string(), loaded),
+                 std::runtime_error);
+
+    std::filesystem::resize_file(file,
+                                 std::filesystem::file_size(file) - 64);
+    EXPECT_THROW(StateSnapshot::read(file, loaded), std::runtime_error);
+    {
+        std::ofstream out(file, std::ios::binary | std::ios::trunc);
+        out << "THALESTK and then some more bytes than a header";
+    }
+    EXPECT_THROW(StateSnapshot::read(file, loaded), std::runtime_error);
+    EXPECT_EQ(loaded.portfolio.size(), 0u);
+}
+
+TEST_F(StateSnapshotTest, RejectsCorruptRecordsWithoutInterning) {
+    // Written by another process, so its names are new to this one
+    pid_t child = ::fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        TradingState state;
+        make_state(state, SymbolTable::intern("CORRUPTA"),
+                   SymbolTable::intern("CORRUPTB"));
+        StateSnapshot::write(file, state);
+        ::_exit(0);
+    }
+    int status = 0;
+    ::waitpid(child, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    std::string good = (root / "good.snapshot").string();
+    std::filesystem::copy_file(file, good);
+    std::size_t interned = SymbolTable::size();
+    TradingState loaded;
+
+    // A chain entry naming a row past the end of the book
+    patch_section(file, 10, std::uint32_t{1000000});
+    EXPECT_THROW(StateSnapshot::read(file, loaded), std::runtime_error);
+    // A position that is neither a call nor a put
+    std::filesystem::copy_file(
+        good, file, std::filesystem::copy_options::overwrite_existing);
+    patch_section(file, 2, std::underlying_type_t<OptionType>{7});
+    EXPECT_THROW(StateSnapshot::read(file, loaded), std::runtime_error);
+    EXPECT_EQ(SymbolTable::size(), interned);
+    EXPECT_EQ(loaded.portfolio.size(), 0u);
+
+    std::filesystem::copy_file(
+        good, file, std::filesystem::copy_options::overwrite_existing);
+    StateSnapshot::read(file, loaded);
+    EXPECT_EQ(loaded.portfolio.size(), 3u);
+    EXPECT_EQ(SymbolTable::size(), interned + 2);
+}
+
+TEST_F(StateSnapshotTest, ReconcileAppliesOnlyDifferences) {
+    SymbolId first = SymbolTable::intern("SNAPA");
+    SymbolId second = SymbolTable::intern("SNAPB");
+    TradingState state;
+    make_state(state, first, second);
+
+    // The broker traded one contract, closed another and opened a third
+    Portfolio broker(24000.0);
+    broker.add_position(Position(first, CALL, 100.0, 20000, 5, 2.5));
+    broker.add_position(Position(second, PUT, 50.0, 20030, -1, 1.1));
+    broker.add_position(Position(second, CALL, 55.0, 20030, 4, 0.9));
+    std::pmr::vector<Order> executions = {
+        Order(Side::SELL, second, PUT, 50.0, 20030, 3, 1.2, 2000),
+        Order(Side::BUY, second, PUT, 50.0, 20030, 2, 1.0, 3000),
+        Order(Side::BUY, second, CALL, 55.0, 20030, 4, 0.9, 4000)};
+
+    ReconcileStats stats = reconcile(state, broker, executions);
+    EXPECT_EQ(stats.positions_changed, 2u);
+    EXPECT_EQ(stats.positions_added, 1u);
+    EXPECT_EQ(stats.orders_added, 2u);
+    ASSERT_EQ(state.portfolio.size(), 4u);
+    EXPECT_EQ(state.portfolio.get_quantities()[1], -1);
+    EXPECT_DOUBLE_EQ(state.portfolio.get_premiums()[1], 1.1);
+    EXPECT_EQ(state.portfolio.get_quantities()[2], 0);
+    EXPECT_EQ(state.portfolio.get_quantities()[3], 4);
+    EXPECT_DOUBLE_EQ(state.portfolio.get_net_liquidity(), 24000.0);
+    EXPECT_TRUE(state.chain.contains({second, 20030, CALL, 55.0}));
+    ASSERT_EQ(state.orders.size(), 4u);
+    EXPECT_EQ(state.orders.back().get_timestamp_ns(), 4000);
+
+    // Reconciling again is a no-op
+    stats = reconcile(state, broker, executions);
+    EXPECT_EQ(stats.positions_changed + stats.positions_added +
+                  stats.orders_added,
+              0u);
+}
+
+TEST_F(StateSnapshotTest, WriterKeepsLatestState) {
+    SymbolId first = SymbolTable::intern("SNAPA");
+    SymbolId second = SymbolTable::intern("SNAPB");
+    {
+        StateSnapshotWriter writer(file, std::chrono::hours(1));
+        EXPECT_FALSE(writer.flush());
+        for (int quantity = 1; quantity <= 5; ++quantity) {
+            writer.update([&](TradingState& state) {
+                make_state(state, first, second);
+                state.portfolio.set_position(0, quantity, 2.5);
+            });
+        }
+        ASSERT_TRUE(writer.flush());
+        EXPECT_FALSE(writer.flush());
+        TradingState loaded;
+        StateSnapshot::read(file, loaded);
+        EXPECT_EQ(loaded.portfolio.get_quantities()[0], 5);
+
+        // Stopping writes whatever was published last
+        writer.update([&](TradingState& state) {
+            make_state(state, first, second);
+            state.portfolio.set_position(0, 9, 2.5);
+        });
+        writer.start();
+        writer.stop();
+        EXPECT_EQ(writer.written(), 2u);
+    }
+    TradingState loaded;
+    StateSnapshot::read(file, loaded);
+    EXPECT_EQ(loaded.portfolio.get_quantities()[0], 9);
+}
+
+TEST_F(StateSnapshotTest, WriterWritesPeriodically) {
+    SymbolId first = SymbolTable::intern("SNAPA");
+    SymbolId second = SymbolTable::intern("SNAPB");
+    StateSnapshotWriter writer(file, std::chrono::milliseconds(5));
+    writer.start();
+    writer.update(
+        [&](TradingState& state) { make_state(state, first, second); });
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (writer.written() == 0 &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(writer.written(), 1u);
+    EXPECT_TRUE(std::filesystem::exists(file));
+    writer.stop();
+    EXPECT_EQ(writer.written(), 1u);
+}
+
+}  // namespace thales
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,271 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "data/tick_store.h"
+#include "gtest/gtest.h"
+#include "trading/strategy.h"
+#include "utils/date.h"
+#include "utils/thread_pool.h"
+
+namespace thales {
+
+namespace {
+
+constexpr std::int64_t kNanosPerDay = 86'400'000'000'000;
+constexpr std::int64_t kNanosPerMinute = 60'000'000'000;
+
+/**
+ * @brief Buys a fixed number of calls at the first event.
+ */
+class BuyOnce : public Strategy {
+   public:
+    BuyOnce(ContractKey contract, int quantity)
+        : contract(contract), quantity(quantity) {}
+
+    void on_events(const EventBatch& batch, Backtester& backtester) override {
+        timestamps.push_back(batch.timestamp_ns);
+        sizes.push_back(batch.size());
+        if (!submitted) {
+            backtester.submit({Side::BUY, contract, quantity});
+            submitted = true;
+        }
+    }
+
+    ContractKey contract;
+    int quantity;
+    bool submitted = false;
+    std::vector<std::int64_t> timestamps;
+    std::vector<std::size_t> sizes;
+};
+
+/**
+ * @brief Two days of bars and quotes for one call on XYZ.
+ */
+class BacktestTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        root = std::filesystem::temp_directory_path() /
+               ("thales_backtest_" + std::to_string(::getpid()) + "_" +
+                ::testing::UnitTest::GetInstance()
+                    ->current_test_info()
+                    ->name());
+        std::filesystem::remove_all(root);
+        store = std::make_unique<TickStore>(root.string());
+
+        day = parse_date("2024-03-01");
+        symbol = SymbolTable::intern("XYZ");
+        call = {symbol, day, CALL, 95.0};
+        std::int64_t open = day * kNanosPerDay;
+
+        BarColumns bars;
+        add_bar(bars, open + kNanosPerMinute, 100.0);
+        add_bar(bars, open + 3 * kNanosPerMinute, 106.0);
+        add_bar(bars, open + kNanosPerDay + kNanosPerMinute, 110.0);
+        store->write_bars(bars);
+
+        OptionChainColumns chain;
+        add_quote(chain, open + kNanosPerMinute, 5.0, 5.2, 1, 100.0);
+        add_quote(chain, open + 2 * kNanosPerMinute, 5.3, 5.5, 1, 104.0);
+        add_quote(chain, open + 4 * kNanosPerMinute, 5.9, 6.1, 5, 107.0);
+        store->write_option_quotes(chain);
+    }
+
+    void TearDown() override { std::filesystem::remove_all(root); }
+
+    void add_bar(BarColumns& bars, std::int64_t timestamp, double close) {
+        std::size_t row = bars.append();
+        bars.symbol[row] = symbol;
+        bars.timestamp_ns[row] = timestamp;
+        bars.open[row] = bars.high[row] = bars.low[row] = close;
+        bars.close[row] = bars.vwap[row] = close;
+    }
+
+    void add_quote(OptionChainColumns& chain, std::int64_t timestamp,
+                   double bid, double ask, std::uint32_t ask_size,
+                   double spot) {
+        std::size_t row = chain.append();
+        chain.contract[row] = SymbolTable::intern("O:XYZ240301C00095000");
+        chain.underlying[row] = symbol;
+        chain.type[row] = CALL;
+        chain.strike[row] = 95.0;
+        chain.expiration[row] = day;
+        chain.bid[row] = bid;
+        chain.ask[row] = ask;
+        chain.bid_size[row] = 10;
+        chain.ask_size[row] = ask_size;
+        chain.timestamp_ns[row] = timestamp;
+        chain.underlying_price[row] = spot;
+    }
+
+    std::filesystem::path root;
+    std::unique_ptr<TickStore> store;
+    std::int32_t day;
+    SymbolId symbol;
+    ContractKey call;
+};
+
+TEST_F(BacktestTest, ReplaysBatchesInTimeOrder) {
+    BacktestData data(*store, {"XYZ"}, day, day + 1);
+    ASSERT_EQ(data.days().size(), 2u);
+    EXPECT_EQ(data.size(), 6u);
+
+    BuyOnce strategy(call, 1);
+    Backtester backtester(data);
+    BacktestResult result = backtester.run(strategy);
+    EXPECT_EQ(result.events, 6u);
+    EXPECT_EQ(result.batches, 5u);
+    EXPECT_EQ(strategy.sizes, (std::vector<std::size_t>{2, 1, 1, 1, 1}));
+    EXPECT_TRUE(std::is_sorted(strategy.timestamps.begin(),
+                               strategy.timestamps.end()));
+    EXPECT_EQ(result.days, (std::vector<std::int32_t>{day, day + 1}));
+
+    BacktestData first_day(*store, {"XYZ"}, day, day);
+    EXPECT_EQ(first_day.size(), 5u);
+    EXPECT_THROW(BacktestData(*store, {"XYZ"}, day, day - 1),
+                 std::invalid_argument);
+}
+
+TEST_F(BacktestTest, FillsAgainstLaterQuotesAndSettles) {
+    BacktestData data(*store, {"XYZ"}, day, day + 1);
+    BacktestSettings settings;
+    settings.initial_cash = 100000.0;
+    settings.commission_per_contract = 0.65;
+
+    BuyOnce strategy(call, 2);
+    Backtester backtester(data, settings);
+    BacktestResult result = backtester.run(strategy);
+
+    // One contract at 5.5 (quoted size 1), none while that size is used
+    // up, the other at 6.1; both settle at 107 - 95 = 12 after expiry
+    const std::vector<Order>& fills = backtester.ledger().fills();
+    ASSERT_EQ(fills.size(), 2u);
+    EXPECT_EQ(fills[0].get_premium(), 5.5);
+    EXPECT_EQ(fills[0].get_quantity(), 1);
+    EXPECT_EQ(fills[1].get_premium(), 6.1);
+    EXPECT_EQ(backtester.ledger().quantity(call), 0);
+    EXPECT_EQ(backtester.working_orders(), 0u);
+
+    EXPECT_NEAR(result.commissions, 1.3, 1e-9);
+    EXPECT_NEAR(result.realized_pnl, 2 * (12.0 - 5.8) * 100.0, 1e-6);
+    EXPECT_NEAR(result.final_equity,
+                100000.0 - 1160.0 - 1.3 + 2400.0, 1e-6);
+    EXPECT_NEAR(backtester.ledger().portfolio().get_net_liquidity(),
+                result.cash, 1e-6);
+
+    // First day marks the two calls at the 6.0 mid
+    ASSERT_EQ(result.daily_equity.size(), 2u);
+    EXPECT_NEAR(result.daily_equity[0],
+                100000.0 - 1160.0 - 1.3 + 1200.0, 1e-6);
+}
+
+TEST_F(BacktestTest, LimitOrdersWaitForTheirPrice) {
+    class BuyLimit : public Strategy {
+       public:
+        explicit BuyLimit(ContractKey contract) : contract(contract) {}
+        void on_events(const EventBatch&, Backtester& backtester) override {
+            if (!done) {
+                backtester.submit({Side::BUY, contract, 1, 5.3});
+                done = true;
+            }
+        }
+        ContractKey contract;
+        bool done = false;
+    };
+
+    BacktestData data(*store, {"XYZ"}, day, day + 1);
+    BuyLimit strategy(call);
+    Backtester backtester(data);
+    backtester.run(strategy);
+    EXPECT_TRUE(backtester.ledger().fills().empty());
+    EXPECT_EQ(backtester.working_orders(), 1u);
+}
+
+TEST(LedgerTest, TracksAverageCostAndRealizedPnl) {
+    SymbolId symbol = SymbolTable::intern("LEDGER");
+    ContractKey put{symbol, 20000, PUT, 50.0};
+    Ledger ledger(10000.0);
+
+    ledger.apply(Order(Side::SELL, symbol, PUT, 50.0, 20000, 3, 2.0, 0), 0.0);
+    EXPECT_EQ(ledger.quantity(put), -3);
+    EXPECT_DOUBLE_EQ(ledger.cash(), 10600.0);
+
+    // Buying 5 covers the short at a profit and opens 2 long at 1.0
+    ledger.apply(Order(Side::BUY, symbol, PUT, 50.0, 20000, 5, 1.0, 1), 1.0);
+    EXPECT_EQ(ledger.quantity(put), 2);
+    EXPECT_DOUBLE_EQ(ledger.realized_pnl(), 300.0);
+    EXPECT_DOUBLE_EQ(ledger.portfolio().get_premiums()[0], 1.0);
+    EXPECT_DOUBLE_EQ(ledger.cash(), 10099.0);
+    EXPECT_DOUBLE_EQ(ledger.portfolio().get_net_liquidity(), 10299.0);
+    EXPECT_EQ(ledger.portfolio().size(), 1u);
+
+    MarketState market;
+    market.update(BarEvent{symbol, 0, 0, 0, 0, 47.0, 0, 0});
+    ledger.settle_expired(20001, market);
+    EXPECT_EQ(ledger.quantity(put), 0);
+    EXPECT_DOUBLE_EQ(ledger.realized_pnl(), 300.0 + 2 * 2.0 * 100.0);
+    EXPECT_DOUBLE_EQ(ledger.cash(), 10099.0 + 600.0);
+
+    EXPECT_THROW(
+        ledger.apply(Order(Side::BUY, symbol, PUT, 50.0, 20000, 0, 1.0, 1),
+                     0.0),
+        std::invalid_argument);
+}
+
+TEST_F(BacktestTest, SweepMatchesSequentialRuns) {
+    BacktestData data(*store, {"XYZ"}, day, day + 1);
+    BacktestSettings settings;
+    settings.respect_quote_size = false;
+    auto make = [&](std::size_t index) {
+        return std::make_unique<BuyOnce>(call, static_cast<int>(index) + 1);
+    };
+
+    ThreadPool pool(4);
+    std::vector<BacktestResult> results =
+        run_parameter_sweep(data, 8, make, pool, settings);
+    ASSERT_EQ(results.size(), 8u);
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        Backtester backtester(data, settings);
+        auto strategy = make(i);
+        BacktestResult expected = backtester.run(*strategy);
+        EXPECT_DOUBLE_EQ(results[i].final_equity, expected.final_equity);
+        EXPECT_EQ(results[i].fills, 1u);
+        // Every size fills at 5.5 and settles at 12
+        EXPECT_NEAR(results[i].final_equity,
+                    100000.0 + (i + 1) * (1200.0 - 550.0 - 0.65), 1e-6);
+    }
+}
+
+}  // namespace
+
+}  // namespace thales
@@ -0,0 +1,244 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <sched.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "trading/threading.h"
+#include "utils/arena.h"
+#include "utils/thread_affinity.h"
+#include "utils/thread_pool.h"
+
+namespace thales {
+
+namespace {
+
+/** @brief CPUs the test process may run on. */
+std::vector<int> allowed_cpus() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    sched_getaffinity(0, sizeof(set), &set);
+    std::vector<int> cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &set)) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+/** @brief Restores the calling thread's affinity when the test ends. */
+class AffinityGuard {
+   public:
+    AffinityGuard() { sched_getaffinity(0, sizeof(saved), &saved); }
+    ~AffinityGuard() { sched_setaffinity(0, sizeof(saved), &saved); }
+
+   private:
+    cpu_set_t saved;
+};
+
+}  // namespace
+
+TEST(ThreadAffinityTest, ParsesCpuLists) {
+    EXPECT_EQ(parse_cpu_list("0-3,8"), (std::vector<int>{0, 1, 2, 3, 8}));
+    EXPECT_EQ(parse_cpu_list("5\n"), std::vector<int>{5});
+    EXPECT_EQ(parse_cpu_list("10-11,2"), (std::vector<int>{10, 11, 2}));
+    EXPECT_TRUE(parse_cpu_list("").empty());
+    for (const char* bad : {"3-1", "a", "1,", ",1", "-1", "1-", "0-3;8"}) {
+        EXPECT_THROW(parse_cpu_list(bad), std::invalid_argument) << bad;
+    }
+}
+
+TEST(ThreadAffinityTest, ReadsTopologyFromSysfs) {
+    std::filesystem::path root =
+        std::filesystem::temp_directory_path() /
+        ("thales_nodes_" + std::to_string(::getpid()));
+    std::filesystem::create_directories(root / "node0");
+    std::filesystem::create_directories(root / "node2");
+    std::filesystem::create_directories(root / "power");
+    std::ofstream(root / "node0" / "cpulist") << "0-1,4\n";
+    std::ofstream(root / "node2" / "cpulist") << "2-3\n";
+    std::ofstream(root / "online") << "0,2\n";
+
+    CpuTopology topology = CpuTopology::read(root.string());
+    std::filesystem::remove_all(root);
+    EXPECT_EQ(topology.nodes(), 3u);
+    EXPECT_EQ(topology.cpus_of(0), (std::vector<int>{0, 1, 4}));
+    EXPECT_TRUE(topology.cpus_of(1).empty());
+    EXPECT_EQ(topology.cpus_of(2), (std::vector<int>{2, 3}));
+    EXPECT_TRUE(topology.cpus_of(7).empty());
+    EXPECT_EQ(topology.node_of(3), 2);
+    EXPECT_EQ(topology.node_of(4), 0);
+    EXPECT_EQ(topology.node_of(99), 0);
+}
+
+TEST(ThreadAffinityTest, TreatsMachinesWithoutNumaAsOneNode) {
+    CpuTopology topology = CpuTopology::read("/nonexistent/thales");
+    EXPECT_EQ(topology.nodes(), 1u);
+    EXPECT_FALSE(topology.cpus_of(0).empty());
+    EXPECT_GE(CpuTopology::instance().nodes(), 1u);
+}
+
+TEST(ThreadAffinityTest, PinsTheCallingThread) {
+    AffinityGuard guard;
+    int cpu = allowed_cpus().back();
+    pin_current_thread({cpu});
+    EXPECT_EQ(allowed_cpus(), std::vector<int>{cpu});
+    EXPECT_EQ(sched_getcpu(), cpu);
+
+    // Empty leaves the affinity alone
+    pin_current_thread({});
+    EXPECT_EQ(allowed_cpus(), std::vector<int>{cpu});
+
+    EXPECT_THROW(pin_current_thread({-1}), std::invalid_argument);
+    EXPECT_THROW(pin_current_thread({CPU_SETSIZE}), std::invalid_argument);
+}
+
+TEST(ThreadAffinityTest, PinsPoolWorkers) {
+    int cpu = allowed_cpus().front();
+    ThreadPool pool(0, {cpu});
+    ASSERT_EQ(pool.size(), 1u);
+    EXPECT_EQ(pool.cpu(0), cpu);
+    std::atomic<int> ran_on{-1};
+    pool.parallel_for(1, [&](std::size_t, std::size_t) {
+        ran_on = sched_getcpu();
+    });
+    EXPECT_EQ(ran_on.load(), cpu);
+    EXPECT_EQ(pool.memory(0),
+              NumaMemoryResource::for_node(
+                  CpuTopology::instance().node_of(cpu)));
+
+    ThreadPool unpinned(2);
+    EXPECT_EQ(unpinned.cpu(1), -1);
+    EXPECT_EQ(unpinned.memory(1), std::pmr::get_default_resource());
+
+    EXPECT_THROW(ThreadPool(2, {-1}), std::invalid_argument);
+}
+
+TEST(ThreadAffinityTest, SpinsThenParks) {
+    IdleWaiter waiter({WaitMode::SPIN_THEN_PARK, 3,
+                       std::chrono::microseconds(0)});
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_FALSE(waiter.parking());
+        waiter.idle();
+    }
+    EXPECT_TRUE(waiter.parking());
+    waiter.idle();
+    EXPECT_TRUE(waiter.parking());
+    waiter.reset();
+    EXPECT_FALSE(waiter.parking());
+
+    IdleWaiter busy({WaitMode::BUSY_POLL, 0, std::chrono::microseconds(0)});
+    busy.idle();
+    EXPECT_FALSE(busy.parking());
+    EXPECT_TRUE(IdleWaiter({WaitMode::SLEEP}).parking());
+
+    EXPECT_EQ(parse_wait_mode("busy_poll"), WaitMode::BUSY_POLL);
+    EXPECT_EQ(parse_wait_mode("sleep"), WaitMode::SLEEP);
+    EXPECT_EQ(parse_wait_mode("spin_then_park"), WaitMode::SPIN_THEN_PARK);
+    EXPECT_THROW(parse_wait_mode("spin"), std::invalid_argument);
+}
+
+TEST(ThreadAffinityTest, WaitsUntilDeadlineInEveryMode) {
+    using Clock = std::chrono::steady_clock;
+    for (WaitMode mode :
+         {WaitMode::SLEEP, WaitMode::BUSY_POLL, WaitMode::SPIN_THEN_PARK}) {
+        IdleWaiter waiter({mode, 10, std::chrono::microseconds(500)});
+        auto deadline = Clock::now() + std::chrono::milliseconds(5);
+        EXPECT_TRUE(waiter.wait_until(deadline, [] { return false; }));
+        EXPECT_GE(Clock::now(), deadline);
+
+        // Stopping wins over a far deadline
+        int checks = 0;
+        EXPECT_FALSE(waiter.wait_until(Clock::now() + std::chrono::hours(1),
+                                       [&] { return ++checks > 3; }));
+    }
+}
+
+TEST(ThreadAffinityTest, AllocatesFromNumaNodes) {
+    std::pmr::memory_resource* resource = NumaMemoryResource::for_node(0);
+    EXPECT_EQ(resource, NumaMemoryResource::for_node(0));
+    EXPECT_EQ(NumaMemoryResource::for_node(-1),
+              std::pmr::get_default_resource());
+
+    void* block = resource->allocate(10000, 64);
+    ASSERT_NE(block, nullptr);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(block) % 64, 0u);
+    std::memset(block, 0xab, 10000);
+    resource->deallocate(block, 10000, 64);
+
+    // Meant as the upstream of an arena
+    Arena arena(4096, resource);
+    std::pmr::vector<double> values(&arena);
+    values.assign(100000, 1.5);
+    EXPECT_EQ(values.back(), 1.5);
+}
+
+TEST(ThreadingSettingsTest, LoadsPlacementsFromConfiguration) {
+    ConfigSnapshot config;
+    config.set("threading", "ORDER_MANAGER_CPUS", "3");
+    config.set("threading", "ORDER_MANAGER_WAIT", "busy_poll");
+    config.set("threading", "PRICING_CPUS", "4-7");
+    config.set("threading", "PARK_US", "50");
+    ThreadingSettings settings = ThreadingSettings::load(config);
+    EXPECT_EQ(settings.order_manager.cpus, std::vector<int>{3});
+    EXPECT_EQ(settings.order_manager.wait.mode, WaitMode::BUSY_POLL);
+    EXPECT_EQ(settings.pricing.cpus, (std::vector<int>{4, 5, 6, 7}));
+    EXPECT_TRUE(settings.market_data.cpus.empty());
+    EXPECT_EQ(settings.market_data.wait.mode, WaitMode::SLEEP);
+    EXPECT_EQ(settings.main_loop.wait.park, std::chrono::microseconds(50));
+    EXPECT_EQ(settings.order_manager.wait.spin_iterations, 1000);
+
+    config.set("threading", "MAIN_LOOP_WAIT", "nap");
+    EXPECT_THROW(ThreadingSettings::load(config), std::invalid_argument);
+    config.set("threading", "MAIN_LOOP_WAIT", "sleep");
+    config.set("threading", "LOGGING_CPUS", "0-");
+    EXPECT_THROW(ThreadingSettings::load(config), std::invalid_argument);
+}
+
+TEST(ThreadingSettingsTest, ReadsShippedConfiguration) {
+    ThreadingSettings settings =
+        ThreadingSettings::load(ConfigSnapshot::read_directory(
+            THALES_TEST_CONFIG_DIR));
+    EXPECT_EQ(settings.order_manager.wait.mode, WaitMode::SPIN_THEN_PARK);
+    EXPECT_EQ(settings.main_loop.wait.mode, WaitMode::SLEEP);
+}
+
+}  // namespace thales
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,110 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "utils/thread_pool.h"
+
+namespace thales {
+
+TEST(ThreadPoolTest, SubmitReturnsResults) {
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.size(), 4u);
+
+    std::vector<std::future<int>> results;
+    for (int i = 0; i < 100; ++i) {
+        results.push_back(pool.submit([i] { return i * i; }));
+    }
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(results[i].get(), i * i);
+    }
+}
+
+TEST(ThreadPoolTest, SubmitPropagatesExceptions) {
+    ThreadPool pool(2);
+    auto result = pool.submit([]() -> int { throw std::runtime_error("x"); });
+    EXPECT_THROW(result.get(), std::runtime_error);
+}
+
+TEST(ThreadPoolTest, ParallelForVisitsEveryIndexOnce) {
+    ThreadPool pool(4);
+    std::vector<std::atomic<int>> visits(1000);
+    std::vector<long> per_worker(pool.size(), 0);
+    pool.parallel_for(visits.size(), [&](std::size_t i, std::size_t worker) {
+        ASSERT_LT(worker, pool.size());
+        visits[i].fetch_add(1);
+        per_worker[worker] += static_cast<long>(i);
+    });
+    for (const auto& count : visits) {
+        EXPECT_EQ(count.load(), 1);
+    }
+    // Per-worker accumulators need no locking and add up to the total
+    EXPECT_EQ(std::accumulate(per_worker.begin(), per_worker.end(), 0L),
+              999L * 1000L / 2);
+}
+
+TEST(ThreadPoolTest, NestedParallelForDoesNotDeadlock) {
+    ThreadPool pool(2);
+    std::atomic<int> count{0};
+    pool.parallel_for(8, [&](std::size_t, std::size_t) {
+        pool.parallel_for(8, [&](std::size_t, std::size_t) { ++count; });
+    });
+    EXPECT_EQ(count.load(), 64);
+}
+
+TEST(ThreadPoolTest, ParallelForRethrowsAfterCompletion) {
+    ThreadPool pool(3);
+    std::atomic<int> count{0};
+    EXPECT_THROW(pool.parallel_for(50,
+                                   [&](std::size_t i, std::size_t) {
+                                       ++count;
+                                       if (i == 7) {
+                                           throw std::invalid_argument("7");
+                                       }
+                                   }),
+                 std::invalid_argument);
+    EXPECT_EQ(count.load(), 50);
+}
+
+TEST(ThreadPoolTest, DestructorRunsQueuedTasks) {
+    std::atomic<int> count{0};
+    {
+        ThreadPool pool(2);
+        for (int i = 0; i < 200; ++i) {
+            pool.submit([&] { ++count; });
+        }
+    }
+    EXPECT_EQ(count.load(), 200);
+}
+
+}  // namespace thales
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
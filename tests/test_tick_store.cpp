@@ -0,0 +1,197 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "data/tick_store.h"
+#include "gtest/gtest.h"
+#include "utils/date.h"
+
+namespace thales {
+
+namespace {
+
+constexpr std::int64_t kNanosPerDay = 86'400'000'000'000;
+
+/**
+ * @brief Gives every test its own store directory.
+ */
+class TickStoreTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        root = std::filesystem::temp_directory_path() /
+               ("thales_tick_store_" + std::to_string(::getpid()) + "_" +
+                ::testing::UnitTest::GetInstance()
+                    ->current_test_info()
+                    ->name());
+        std::filesystem::remove_all(root);
+    }
+
+    void TearDown() override { std::filesystem::remove_all(root); }
+
+    void add_bar(BarColumns& bars, std::string_view symbol,
+                 std::int64_t timestamp, double close) {
+        std::size_t row = bars.append();
+        bars.symbol[row] = SymbolTable::intern(symbol);
+        bars.timestamp_ns[row] = timestamp;
+        bars.open[row] = close - 1.0;
+        bars.high[row] = close + 1.0;
+        bars.low[row] = close - 2.0;
+        bars.close[row] = close;
+        bars.volume[row] = 1000.0;
+        bars.vwap[row] = close;
+        bars.trades[row] = 10;
+    }
+
+    std::filesystem::path root;
+};
+
+TEST_F(TickStoreTest, WritesBarsPerSymbolAndDay) {
+    TickStore store(root.string());
+    std::int32_t day = parse_date("2024-03-01");
+    std::int64_t start = day * kNanosPerDay;
+
+    BarColumns bars;
+    add_bar(bars, "AAPL", start + 2000, 102.0);
+    add_bar(bars, "AAPL", start + 1000, 101.0);
+    add_bar(bars, "MSFT", start + 1000, 401.0);
+    add_bar(bars, "AAPL", start + kNanosPerDay, 103.0);
+    EXPECT_EQ(store.write_bars(bars), 3u);
+
+    BarFile aapl = store.read_bars("AAPL", day);
+    ASSERT_EQ(aapl.size(), 2u);
+    EXPECT_EQ(aapl.symbol(), "AAPL");
+    EXPECT_EQ(aapl.day(), day);
+    EXPECT_EQ(aapl.timestamp_ns()[0], start + 1000);
+    EXPECT_EQ(aapl.close()[0], 101.0);
+    EXPECT_EQ(aapl.high()[1], 103.0);
+    EXPECT_EQ(aapl.trades()[1], 10u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(aapl.close()) %
+                  TICK_FILE_ALIGNMENT,
+              0u);
+
+    EXPECT_EQ(store.read_bars("MSFT", day).size(), 1u);
+    EXPECT_EQ(store.bar_days("AAPL"),
+              (std::vector<std::int32_t>{day, day + 1}));
+    EXPECT_TRUE(store.bar_days("TSLA").empty());
+    EXPECT_THROW(store.read_bars("TSLA", day), std::runtime_error);
+}
+
+TEST_F(TickStoreTest, MergesWithStoredDays) {
+    TickStore store(root.string());
+    std::int64_t start = parse_date("2024-03-01") * kNanosPerDay;
+
+    BarColumns bars;
+    add_bar(bars, "AAPL", start + 1000, 101.0);
+    add_bar(bars, "AAPL", start + 3000, 103.0);
+    store.write_bars(bars);
+
+    // Mapped files stay valid while their day is rewritten
+    BarFile before = store.read_bars("AAPL", parse_date("2024-03-01"));
+
+    bars.clear();
+    add_bar(bars, "AAPL", start + 2000, 102.0);
+    add_bar(bars, "AAPL", start + 3000, 113.0);
+    store.write_bars(bars);
+
+    BarFile after = store.read_bars("AAPL", parse_date("2024-03-01"));
+    ASSERT_EQ(after.size(), 3u);
+    EXPECT_EQ(after.close()[0], 101.0);
+    EXPECT_EQ(after.close()[1], 102.0);
+    EXPECT_EQ(after.close()[2], 113.0);
+    ASSERT_EQ(before.size(), 2u);
+    EXPECT_EQ(before.close()[1], 103.0);
+}
+
+TEST_F(TickStoreTest, RejectsBadInput) {
+    TickStore store(root.string());
+    BarColumns bars;
+    bars.append();
+    EXPECT_THROW(store.write_bars(bars), std::invalid_argument);
+
+    bars.clear();
+    add_bar(bars, "../escape", 0, 1.0);
+    EXPECT_THROW(store.write_bars(bars), std::invalid_argument);
+
+    std::filesystem::create_directories(root / "bars" / "AAPL");
+    std::ofstream(root / "bars" / "AAPL" / "2024-03-01.tick") << "garbage";
+    EXPECT_THROW(store.read_bars("AAPL", parse_date("2024-03-01")),
+                 std::runtime_error);
+    EXPECT_THROW(store.read_option_quotes("AAPL", parse_date("2024-03-01")),
+                 std::runtime_error);
+}
+
+TEST_F(TickStoreTest, ImportsPolygonResponses) {
+    TickStore store(root.string());
+    PolygonImporter importer(store, SimdBackend::SCALAR);
+
+    // 2023-01-09 and 2023-01-10, 05:00 UTC
+    std::string aggregates =
+        R"({"ticker":"AAPL","results":[{"v":70790813,"vw":131.6292,)"
+        R"("o":130.465,"c":131.86,"h":133.41,"l":129.89,"t":1673240400000,)"
+        R"("n":645365},{"v":63896155,"vw":130.3005,"o":131.25,"c":130.73,)"
+        R"("h":131.2636,"l":128.12,"t":1673326800000,"n":554940}],)"
+        R"("status":"OK"})";
+    EXPECT_EQ(importer.import_aggregates(aggregates), 2u);
+    EXPECT_EQ(store.bar_days("AAPL").size(), 2u);
+    BarFile bars = store.read_bars("AAPL", parse_date("2023-01-10"));
+    ASSERT_EQ(bars.size(), 1u);
+    EXPECT_EQ(bars.close()[0], 130.73);
+    EXPECT_EQ(bars.trades()[0], 554940u);
+
+    std::string chain =
+        R"({"results":[{"details":{"contract_type":"put",)"
+        R"("expiration_date":"2024-12-20","strike_price":170,)"
+        R"("ticker":"O:AAPL241220P00170000"},"implied_volatility":0.25,)"
+        R"("last_quote":{"ask":6.4,"ask_size":12,"bid":6.3,"bid_size":8,)"
+        R"("last_updated":1700000000000000000},"open_interest":1500,)"
+        R"("underlying_asset":{"price":171.5,"ticker":"AAPL"}},)"
+        R"({"details":{"contract_type":"call","expiration_date":"2024-12-20",)"
+        R"("strike_price":170,"ticker":"O:AAPL241220C00170000"},)"
+        R"("underlying_asset":{"ticker":"AAPL"}}],"status":"OK"})";
+    EXPECT_EQ(importer.import_option_chain(chain), 1u);
+    std::int32_t day = static_cast<std::int32_t>(
+        std::int64_t{1700000000000000000} / kNanosPerDay);
+    EXPECT_EQ(store.option_quote_days("AAPL"),
+              std::vector<std::int32_t>{day});
+    OptionQuoteFile quotes = store.read_option_quotes("AAPL", day);
+    ASSERT_EQ(quotes.size(), 1u);
+    EXPECT_EQ(quotes.type()[0], PUT);
+    EXPECT_EQ(quotes.strike()[0], 170.0);
+    EXPECT_EQ(quotes.expiration()[0], parse_date("2024-12-20"));
+    EXPECT_EQ(quotes.bid()[0], 6.3);
+    EXPECT_EQ(quotes.ask_size()[0], 12u);
+    EXPECT_EQ(quotes.implied_volatility()[0], 0.25);
+    EXPECT_EQ(quotes.underlying_price()[0], 171.5);
+}
+
+}  // namespace
+
+}  // namespace thales
@@ -0,0 +1,204 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Cody Michael Jones
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "data/market_data.h"
+#include "gtest/gtest.h"
+#include "trading/black_scholes.h"
+#include "trading/option_chain.h"
+#include "trading/portfolio.h"
+#include "trading/symbol_table.h"
+#include "trading/vol_surface.h"
+
+namespace thales {
+
+namespace {
+
+const SviParameters SMILE = {0.02, 0.15, -0.4, 0.05, 0.2};
+
+/** @brief Quotes sampled from a known SVI smile at one expiry. */
+std::vector<SmileQuote> smile_quotes(double spot, double rate, double expiry,
+                                     const SviParameters& svi) {
+    std::vector<SmileQuote> quotes;
+    for (double k = -0.5; k <= 0.5001; k += 0.05) {
+        double forward = spot * std::exp(rate * expiry);
+        double vol = std::sqrt(svi.total_variance(k) / expiry);
+        quotes.push_back({forward * std::exp(k), vol, 1.0});
+    }
+    return quotes;
+}
+
+}  // namespace
+
+TEST(VolSurfaceTest, FitRecoversSviSmile) {
+    std::vector<double> k;
+    std::vector<double> w;
+    for (double x = -0.6; x <= 0.6001; x += 0.05) {
+        k.push_back(x);
+        w.push_back(SMILE.total_variance(x));
+    }
+    SviParameters fit = fit_svi(k.data(), w.data(), nullptr, k.size());
+
+    for (double x = -0.6; x <= 0.6001; x += 0.01) {
+        EXPECT_NEAR(fit.total_variance(x), SMILE.total_variance(x), 1e-5);
+    }
+    EXPECT_THROW(fit_svi(k.data(), w.data(), nullptr, 0),
+                 std::invalid_argument);
+}
+
+TEST(VolSurfaceTest, LookupMatchesSmileAtQuotedExpiries) {
+    for (SurfaceInterpolation interpolation :
+         {SurfaceInterpolation::BILINEAR, SurfaceInterpolation::CUBIC}) {
+        VolSurface surface(100.0, 0.03, interpolation);
+        EXPECT_THROW(surface.volatility(100.0, 0.5), std::runtime_error);
+        surface.set_quotes(0.5, smile_quotes(100.0, 0.03, 0.5, SMILE));
+        EXPECT_EQ(surface.refresh(), 1u);
+        EXPECT_EQ(surface.refresh(), 0u);
+
+        double tolerance =
+            interpolation == SurfaceInterpolation::CUBIC ? 1e-4 : 2e-3;
+        for (double strike = 70.0; strike <= 140.0; strike += 3.7) {
+            double k = std::log(strike / 100.0) - 0.03 * 0.5;
+            double expected = std::sqrt(SMILE.total_variance(k) / 0.5);
+            EXPECT_NEAR(surface.volatility(strike, 0.5), expected, tolerance)
+                << strike;
+        }
+    }
+}
+
+TEST(VolSurfaceTest, InterpolatesTotalVarianceAcrossExpiries) {
+    VolSurface surface(100.0, 0.0);
+    SviParameters front = {0.01, 0.1, -0.3, 0.0, 0.2};
+    SviParameters back = {0.04, 0.1, -0.3, 0.0, 0.2};
+    surface.set_quotes(0.25, smile_quotes(100.0, 0.0, 0.25, front));
+    surface.set_quotes(1.0, smile_quotes(100.0, 0.0, 1.0, back));
+    surface.refresh();
+    ASSERT_EQ(surface.size(), 2u);
+    EXPECT_DOUBLE_EQ(surface.expiry(0), 0.25);
+
+    double w0 = front.total_variance(0.0);
+    double w1 = back.total_variance(0.0);
+    double w = w0 + (w1 - w0) * (0.5 - 0.25) / 0.75;
+    EXPECT_NEAR(surface.volatility(100.0, 0.5), std::sqrt(w / 0.5), 1e-4);
+    // Flat volatility outside the quoted expiries
+    EXPECT_NEAR(surface.volatility(100.0, 0.1),
+                surface.volatility(100.0, 0.25), 1e-12);
+    EXPECT_NEAR(surface.volatility(100.0, 2.0),
+                surface.volatility(100.0, 1.0), 1e-12);
+}
+
+TEST(VolSurfaceTest, QuoteUpdateRefitsOnlyItsExpiry) {
+    VolSurface surface(100.0, 0.0);
+    surface.set_quotes(0.25, smile_quotes(100.0, 0.0, 0.25, SMILE));
+    surface.set_quotes(1.0, smile_quotes(100.0, 0.0, 1.0, SMILE));
+    EXPECT_EQ(surface.refresh(), 2u);
+    SviParameters back = surface.parameters(1);
+    double front_atm = surface.volatility(100.0, 0.25);
+
+    // Raise every quote on the front expiry
+    for (const SmileQuote& quote : smile_quotes(100.0, 0.0, 0.25, SMILE)) {
+        surface.update_quote(0.25, {quote.strike, quote.volatility + 0.05});
+    }
+    EXPECT_EQ(surface.refresh(), 1u);
+    EXPECT_NEAR(surface.volatility(100.0, 0.25), front_atm + 0.05, 1e-3);
+    EXPECT_EQ(surface.parameters(1).a, back.a);
+    EXPECT_EQ(surface.parameters(1).m, back.m);
+
+    EXPECT_THROW(surface.update_quote(-1.0, {100.0, 0.2}),
+                 std::invalid_argument);
+    EXPECT_THROW(surface.update_quote(0.25, {100.0, -0.2}),
+                 std::invalid_argument);
+}
+
+TEST(VolSurfaceTest, LoadsOptionChainAndPricesPortfolio) {
+    SymbolId underlying = SymbolTable::intern("AAPL");
+    std::int32_t today = 20000;
+    double spot = 100.0;
+    double rate = 0.02;
+    OptionChainColumns chain;
+    for (std::int32_t days : {30, 90}) {
+        double T = (days + 1) / 365.0;
+        for (double strike = 80.0; strike <= 120.0; strike += 5.0) {
+            for (OptionType type : {CALL, PUT}) {
+                double k = std::log(strike / spot) - rate * T;
+                double vol = std::sqrt(SMILE.total_variance(k) / T);
+                double price = BlackScholes::calculate_option_price(
+                    spot, strike, T, rate, vol, type);
+                chain.contract.push_back(SymbolTable::intern("O"));
+                chain.underlying.push_back(underlying);
+                chain.type.push_back(type);
+                chain.strike.push_back(strike);
+                chain.expiration.push_back(today + days);
+                chain.bid.push_back(price - 0.01);
+                chain.ask.push_back(price + 0.01);
+                chain.bid_size.push_back(10);
+                chain.ask_size.push_back(10);
+                chain.timestamp_ns.push_back(0);
+                chain.implied_volatility.push_back(vol);
+                chain.open_interest.push_back(0.0);
+                chain.underlying_price.push_back(spot);
+            }
+        }
+    }
+
+    VolSurface surface(spot, rate);
+    EXPECT_EQ(load_option_chain(surface, chain, underlying, today), 18u);
+    EXPECT_EQ(surface.refresh(), 2u);
+
+    double T = 31 / 365.0;
+    double k = std::log(110.0 / spot) - rate * T;
+    double expected = std::sqrt(SMILE.total_variance(k) / T);
+    EXPECT_NEAR(surface.volatility(110.0, T), expected, 1e-3);
+
+    // The indexed load visits only the out-of-the-money strike runs
+    OptionChainIndex index(chain);
+    VolSurface indexed(spot, rate);
+    EXPECT_EQ(load_option_chain(indexed, chain, index, underlying, today),
+              18u);
+    EXPECT_EQ(indexed.refresh(), 2u);
+    EXPECT_NEAR(indexed.volatility(110.0, T), surface.volatility(110.0, T),
+                1e-12);
+    EXPECT_NEAR(indexed.volatility(85.0, 0.2), surface.volatility(85.0, 0.2),
+                1e-12);
+
+    Portfolio portfolio(0.0);
+    portfolio.add_position(
+        Position(underlying, CALL, 110.0, today + 30, 1, 0.0));
+    MarketData market;
+    market.spot.assign(underlying + 1, spot);
+    market.volatility.assign(underlying + 1, 0.5);
+    market.rate = rate;
+    market.valuation_date = today;
+    market.surfaces.assign(underlying + 1, nullptr);
+    market.surfaces[underlying] = &surface;
+    double smile_price = BlackScholes::calculate_option_price(
+        spot, 110.0, T, rate, surface.volatility(110.0, T), CALL);
+    EXPECT_NEAR(portfolio.calculate_market_value(market),
+                smile_price * CONTRACT_MULTIPLIER, 1e-6);
+}
+
+}  // namespace thales